@@ -0,0 +1,163 @@
+#include "AtlasBuilder.h"
+#include "AtlasPacker.h"
+#include "MipGenerator.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// value 以上の最小の2のべき乗
+uint32_t NextPowerOfTwo(uint32_t value) {
+	uint32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+} // namespace
+
+bool AtlasBuilder::Add(const std::string& name, TextureData image) {
+	if (GetBytesPerPixel(image.format) != 4 || image.mips.empty()) {
+		return false;
+	}
+	auto it = imageIndices_.find(name);
+	if (it != imageIndices_.end()) {
+		images_[it->second].texture = std::move(image);
+		return true;
+	}
+	imageIndices_.emplace(name, images_.size());
+	images_.push_back({name, std::move(image)});
+	return true;
+}
+
+bool AtlasBuilder::Build(const Options& options) {
+	pages_.clear();
+	regions_.assign(images_.size(), {});
+
+	// ミップを作るなら、最小ミップの1画素にあたる境界へ位置と大きさをそろえる
+	const uint32_t mipCount = (std::max)(options.mipCount, 1u);
+	const uint32_t alignment = 1u << (mipCount - 1);
+	const uint32_t padding = mipCount == 1 ? options.padding : (std::max)(options.padding, alignment);
+	if (options.pageSize < alignment) {
+		regions_.clear();
+		return false;
+	}
+	const uint32_t gridSize = options.pageSize / alignment;
+
+	// 余白を含めた大きさ（境界の単位）
+	std::vector<AtlasPacker::Rect> cells(images_.size());
+	for (size_t i = 0; i < images_.size(); i++) {
+		const TextureData& texture = images_[i].texture;
+		cells[i].width = (texture.GetWidth() + padding * 2 + alignment - 1) / alignment;
+		cells[i].height = (texture.GetHeight() + padding * 2 + alignment - 1) / alignment;
+		if (gridSize < cells[i].width || gridSize < cells[i].height) {
+			regions_.clear();
+			return false;
+		}
+	}
+
+	// 大きいものから置くほうが隙間が少ない（同じなら追加順で、結果を毎回同じにする）
+	std::vector<size_t> order(images_.size());
+	std::iota(order.begin(), order.end(), size_t(0));
+	std::stable_sort(order.begin(), order.end(), [&cells](size_t a, size_t b) {
+		const uint32_t sideA = (std::max)(cells[a].width, cells[a].height);
+		const uint32_t sideB = (std::max)(cells[b].width, cells[b].height);
+		if (sideA != sideB) {
+			return sideB < sideA;
+		}
+		return uint64_t(cells[b].width) * cells[b].height <
+		       uint64_t(cells[a].width) * cells[a].height;
+	});
+
+	// 入るページを先頭から探し、どこにも入らなければページを増やす
+	std::vector<AtlasPacker> packers;
+	for (size_t i : order) {
+		AtlasPacker::Rect placed{};
+		uint32_t page = 0;
+		while (page < packers.size() &&
+		       !packers[page].Insert(cells[i].width, cells[i].height, placed)) {
+			page++;
+		}
+		if (page == packers.size()) {
+			packers.emplace_back(gridSize, gridSize);
+			packers.back().Insert(cells[i].width, cells[i].height, placed);
+		}
+		cells[i].x = placed.x;
+		cells[i].y = placed.y;
+		regions_[i] = {
+		    page, placed.x * alignment + padding, placed.y * alignment + padding,
+		    images_[i].texture.GetWidth(), images_[i].texture.GetHeight()};
+	}
+
+	// ページは使った範囲を含む2のべき乗まで小さくする
+	pages_.resize(packers.size());
+	for (size_t page = 0; page < packers.size(); page++) {
+		pages_[page].Allocate(
+		    TextureFormat::kR8G8B8A8Unorm, NextPowerOfTwo(packers[page].GetUsedWidth() * alignment),
+		    NextPowerOfTwo(packers[page].GetUsedHeight() * alignment));
+		std::memset(pages_[page].pixels.data(), 0, pages_[page].pixels.size());
+	}
+
+	// 余白と境界までの端数は、画像の端の画素を引き伸ばして埋める
+	for (size_t i = 0; i < images_.size(); i++) {
+		const TextureData& source = images_[i].texture;
+		const TextureMip& sourceMip = source.mips[0];
+		const bool isBgra = source.format == TextureFormat::kB8G8R8A8Unorm ||
+		                    source.format == TextureFormat::kB8G8R8A8UnormSrgb;
+		TextureData& page = pages_[regions_[i].page];
+		const uint32_t cellX = cells[i].x * alignment;
+		const uint32_t cellY = cells[i].y * alignment;
+		for (uint32_t y = 0; y < cells[i].height * alignment; y++) {
+			const uint32_t sourceY = uint32_t(std::clamp(
+			    int64_t(y) - int64_t(padding), int64_t(0), int64_t(sourceMip.height) - 1));
+			const uint8_t* sourceRow = source.GetMipPixels(0) + size_t(sourceY) * sourceMip.rowPitch;
+			uint8_t* pageRow = page.GetMipPixels(0) + size_t(cellY + y) * page.mips[0].rowPitch;
+			for (uint32_t x = 0; x < cells[i].width * alignment; x++) {
+				const uint32_t sourceX = uint32_t(std::clamp(
+				    int64_t(x) - int64_t(padding), int64_t(0), int64_t(sourceMip.width) - 1));
+				const uint8_t* src = sourceRow + size_t(sourceX) * 4;
+				uint8_t* dst = pageRow + size_t(cellX + x) * 4;
+				dst[0] = src[isBgra ? 2 : 0];
+				dst[1] = src[1];
+				dst[2] = src[isBgra ? 0 : 2];
+				dst[3] = src[3];
+			}
+		}
+	}
+
+	// 2x2 平均なら境界をまたがないので、隣の画像が混ざらない
+	if (1 < mipCount) {
+		MipGenerator::Options mipOptions;
+		mipOptions.filter = MipGenerator::Filter::kBox;
+		mipOptions.maxMipCount = mipCount;
+		for (TextureData& page : pages_) {
+			MipGenerator::Generate(page, mipOptions);
+		}
+	}
+	return true;
+}
+
+const AtlasBuilder::Region* AtlasBuilder::FindRegion(const std::string& name) const {
+	auto it = imageIndices_.find(name);
+	if (it == imageIndices_.end() || regions_.size() <= it->second) {
+		return nullptr;
+	}
+	return &regions_[it->second];
+}
+
+double AtlasBuilder::GetEfficiency() const {
+	uint64_t pageArea = 0;
+	for (const TextureData& page : pages_) {
+		pageArea += uint64_t(page.GetWidth()) * page.GetHeight();
+	}
+	if (pageArea == 0) {
+		return 0.0;
+	}
+	uint64_t imageArea = 0;
+	for (const Region& region : regions_) {
+		imageArea += uint64_t(region.width) * region.height;
+	}
+	return double(imageArea) / double(pageArea);
+}
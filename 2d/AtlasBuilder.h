@@ -0,0 +1,108 @@
+#pragma once
+
+#include "TextureData.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// テクスチャアトラスの組み立て
+/// 追加した画像を AtlasPacker で大きさの降順に詰め、入らなければページを増やす。
+/// 画像の周りには端の画素を引き伸ばした余白を付け、ミップを作るときは位置と大きさを
+/// 最小ミップの1画素分の境界にそろえて、縮小しても隣の画像が混ざらないようにする。
+/// GPUを使わないので、ビルド時にも実行時の読み込みにも使える
+/// </summary>
+class AtlasBuilder {
+public:
+	/// <summary>
+	/// 組み立ての設定
+	/// </summary>
+	struct Options {
+		// ページの幅と高さの上限（2のべき乗）
+		uint32_t pageSize = 2048;
+		// 画像の周りに付ける余白の画素数（ミップを作るときは最小ミップで1画素以上になるよう広げる）
+		uint32_t padding = 2;
+		// ページのミップ数（1ならミップを作らない）
+		uint32_t mipCount = 1;
+	};
+
+	/// <summary>
+	/// ページ内の画像の位置（余白を含まない）
+	/// </summary>
+	struct Region {
+		uint32_t page;
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	/// <summary>
+	/// 画像の追加（同じ名前なら置き換える）
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="image">RGBA8 / BGRA8 の画像（ミップレベル0だけ使う）</param>
+	/// <returns>追加できたか（非対応の形式なら false）</returns>
+	bool Add(const std::string& name, TextureData image);
+
+	/// <summary>
+	/// 詰め込んでページを作る（追加した画像は保持したままなので、設定を変えて作り直せる）
+	/// </summary>
+	/// <param name="options">設定</param>
+	/// <returns>全て置けたか（1ページに入らない大きさの画像があれば false）</returns>
+	bool Build(const Options& options);
+
+	/// <summary>
+	/// 画像の位置の検索
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <returns>位置（無ければ nullptr）</returns>
+	const Region* FindRegion(const std::string& name) const;
+
+	/// <summary>
+	/// 作ったページ（RGBA8。それぞれ使った範囲を含む2のべき乗の大きさ）
+	/// </summary>
+	const std::vector<TextureData>& GetPages() const { return pages_; }
+
+	/// <summary>
+	/// 詰め込み率（画像の面積の合計 / ページの面積の合計）
+	/// </summary>
+	double GetEfficiency() const;
+
+	/// <summary>
+	/// 追加した画像の数
+	/// </summary>
+	size_t GetImageCount() const { return images_.size(); }
+
+	/// <summary>
+	/// index 番目に追加した画像の名前
+	/// </summary>
+	const std::string& GetImageName(size_t index) const { return images_[index].name; }
+
+	/// <summary>
+	/// 作ったページに置いた画像の数（Build が失敗していれば0）
+	/// </summary>
+	size_t GetRegionCount() const { return regions_.size(); }
+
+	/// <summary>
+	/// index 番目に追加した画像の位置（index は GetRegionCount 未満）
+	/// </summary>
+	const Region& GetRegion(size_t index) const { return regions_[index]; }
+
+private:
+	// 追加した画像
+	struct Image {
+		std::string name;
+		TextureData texture;
+	};
+
+	// 追加した画像（追加順）
+	std::vector<Image> images_;
+	// 名前から images_ の番号への索引
+	std::unordered_map<std::string, size_t> imageIndices_;
+	// 画像の位置（images_ と同じ順）
+	std::vector<Region> regions_;
+	// ページ
+	std::vector<TextureData> pages_;
+};
@@ -0,0 +1,112 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+
+namespace {
+
+using Rect = AtlasPacker::Rect;
+
+bool Intersects(const Rect& a, const Rect& b) {
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+	       b.y < a.y + a.height;
+}
+
+bool Contains(const Rect& outer, const Rect& inner) {
+	return outer.x <= inner.x && outer.y <= inner.y &&
+	       inner.x + inner.width <= outer.x + outer.width &&
+	       inner.y + inner.height <= outer.y + outer.height;
+}
+
+} // namespace
+
+void AtlasPacker::Reset(uint32_t width, uint32_t height) {
+	width_ = width;
+	height_ = height;
+	freeRects_.assign(1, {0, 0, width, height});
+	usedArea_ = 0;
+	usedWidth_ = 0;
+	usedHeight_ = 0;
+}
+
+bool AtlasPacker::Insert(uint32_t width, uint32_t height, Rect& rect) {
+	if (width == 0 || height == 0) {
+		return false;
+	}
+
+	// 上端が最も上になる空き領域を選ぶ（同じなら左端で比べる）
+	const Rect* best = nullptr;
+	uint32_t bestTop = UINT32_MAX;
+	uint32_t bestLeft = UINT32_MAX;
+	for (const Rect& free : freeRects_) {
+		if (free.width < width || free.height < height) {
+			continue;
+		}
+		const uint32_t top = free.y + height;
+		if (top < bestTop || (top == bestTop && free.x < bestLeft)) {
+			best = &free;
+			bestTop = top;
+			bestLeft = free.x;
+		}
+	}
+	if (!best) {
+		return false;
+	}
+
+	rect = {best->x, best->y, width, height};
+	SplitFreeRects(rect);
+	PruneFreeRects();
+
+	usedArea_ += uint64_t(width) * height;
+	usedWidth_ = (std::max)(usedWidth_, rect.x + width);
+	usedHeight_ = (std::max)(usedHeight_, rect.y + height);
+	return true;
+}
+
+void AtlasPacker::SplitFreeRects(const Rect& used) {
+	// 重ならない空き領域は残し、重なるものは上下左右の残りを、それぞれ元の端まで伸ばして分ける
+	splitRects_.clear();
+	size_t keptCount = 0;
+	for (const Rect& free : freeRects_) {
+		if (!Intersects(free, used)) {
+			freeRects_[keptCount++] = free;
+			continue;
+		}
+		if (free.x < used.x) {
+			splitRects_.push_back({free.x, free.y, used.x - free.x, free.height});
+		}
+		if (used.x + used.width < free.x + free.width) {
+			splitRects_.push_back(
+			    {used.x + used.width, free.y, free.x + free.width - (used.x + used.width),
+			     free.height});
+		}
+		if (free.y < used.y) {
+			splitRects_.push_back({free.x, free.y, free.width, used.y - free.y});
+		}
+		if (used.y + used.height < free.y + free.height) {
+			splitRects_.push_back(
+			    {free.x, used.y + used.height, free.width,
+			     free.y + free.height - (used.y + used.height)});
+		}
+	}
+	freeRects_.resize(keptCount);
+}
+
+void AtlasPacker::PruneFreeRects() {
+	// 残した空き領域どうしは互いに含まないので、分けてできた領域だけを調べればよい
+	// （分けてできた領域は元の領域に含まれるので、残した領域を含むこともない）
+	const size_t keptCount = freeRects_.size();
+	for (size_t i = 0; i < splitRects_.size(); i++) {
+		const Rect& split = splitRects_[i];
+		bool isContained = false;
+		for (size_t j = 0; j < keptCount && !isContained; j++) {
+			isContained = Contains(freeRects_[j], split);
+		}
+		// 同じ大きさの領域が2つできたら、先のほうを残す
+		for (size_t j = 0; j < splitRects_.size() && !isContained; j++) {
+			isContained = j != i && Contains(splitRects_[j], split) &&
+			              (j < i || !Contains(split, splitRects_[j]));
+		}
+		if (!isContained) {
+			freeRects_.push_back(split);
+		}
+	}
+}
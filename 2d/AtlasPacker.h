@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 矩形の詰め込み（MaxRects）
+/// 空き領域を重なりを許した極大矩形の集合で持ち、下端が最も上になる位置（同じなら左）へ置く。
+/// 左上に詰まるので、使った範囲に合わせてページを小さくしやすい。
+/// 位置を決めるだけなので、画像を持たずに詰め込み率と処理時間を測れる
+/// </summary>
+class AtlasPacker {
+public:
+	/// <summary>
+	/// 矩形
+	/// </summary>
+	struct Rect {
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	AtlasPacker() = default;
+
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="width">詰め込み先の幅</param>
+	/// <param name="height">詰め込み先の高さ</param>
+	AtlasPacker(uint32_t width, uint32_t height) { Reset(width, height); }
+
+	/// <summary>
+	/// 全て空にして大きさを設定する
+	/// </summary>
+	/// <param name="width">詰め込み先の幅</param>
+	/// <param name="height">詰め込み先の高さ</param>
+	void Reset(uint32_t width, uint32_t height);
+
+	/// <summary>
+	/// 矩形を置く
+	/// </summary>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	/// <param name="rect">置いた位置</param>
+	/// <returns>置けたか</returns>
+	bool Insert(uint32_t width, uint32_t height, Rect& rect);
+
+	/// <summary>
+	/// 置いた矩形の面積の合計
+	/// </summary>
+	uint64_t GetUsedArea() const { return usedArea_; }
+
+	/// <summary>
+	/// 置いた矩形を全て含む幅（左上からの範囲）
+	/// </summary>
+	uint32_t GetUsedWidth() const { return usedWidth_; }
+
+	/// <summary>
+	/// 置いた矩形を全て含む高さ（左上からの範囲）
+	/// </summary>
+	uint32_t GetUsedHeight() const { return usedHeight_; }
+
+	uint32_t GetWidth() const { return width_; }
+	uint32_t GetHeight() const { return height_; }
+
+private:
+	/// <summary>
+	/// 置いた矩形と重なる空き領域を取り除き、重ならない部分の極大矩形を splitRects_ に作る
+	/// </summary>
+	void SplitFreeRects(const Rect& used);
+
+	/// <summary>
+	/// splitRects_ のうち他の空き領域に含まれないものを空き領域に加える
+	/// </summary>
+	void PruneFreeRects();
+
+	// 詰め込み先の幅
+	uint32_t width_ = 0;
+	// 詰め込み先の高さ
+	uint32_t height_ = 0;
+	// 空き領域（互いに重なることがある）
+	std::vector<Rect> freeRects_;
+	// 分けてできた空き領域（作業用）
+	std::vector<Rect> splitRects_;
+	// 置いた矩形の面積の合計
+	uint64_t usedArea_ = 0;
+	// 置いた矩形を全て含む範囲
+	uint32_t usedWidth_ = 0;
+	uint32_t usedHeight_ = 0;
+};
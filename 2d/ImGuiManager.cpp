@@ -30,8 +30,9 @@ void ImGuiManager::Initialize(WinApp* winApp, DirectXCommon* dxCommon) {
 	ImGui::StyleColorsDark();
 	// プラットフォームとレンダラーのバックエンドを設定する
 	ImGui_ImplWin32_Init(winApp->GetHwnd());
+	// 頂点バッファは同時に描画中にできるフレーム数だけ持たせる
 	ImGui_ImplDX12_Init(
-	    dxCommon_->GetDevice(), static_cast<int>(dxCommon_->GetBackBufferCount()),
+	    dxCommon_->GetDevice(), static_cast<int>(dxCommon_->GetFrameContextCount()),
 	    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, srvHeap_.Get(),
 	    srvHeap_->GetCPUDescriptorHandleForHeapStart(),
 	    srvHeap_->GetGPUDescriptorHandleForHeapStart());
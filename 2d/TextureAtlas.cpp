@@ -0,0 +1,57 @@
+#include "TextureAtlas.h"
+#include "Sprite.h"
+#include "TextureManager.h"
+
+bool TextureAtlas::Load(
+    const std::string& name, const std::vector<std::string>& fileNames,
+    const AtlasBuilder::Options& options) {
+	TextureManager* textureManager = TextureManager::GetInstance();
+	AtlasBuilder builder;
+	for (const std::string& fileName : fileNames) {
+		TextureData image;
+		if (!textureManager->DecodeImage(fileName, image) || !builder.Add(fileName, std::move(image))) {
+			return false;
+		}
+	}
+	if (!builder.Build(options)) {
+		return false;
+	}
+	Create(name, builder);
+	return true;
+}
+
+void TextureAtlas::Create(const std::string& name, const AtlasBuilder& builder) {
+	Release();
+
+	const std::vector<TextureData>& pages = builder.GetPages();
+	for (size_t page = 0; page < pages.size(); page++) {
+		pageHandles_.push_back(
+		    TextureManager::LoadFromData(name + "#" + std::to_string(page), pages[page]));
+	}
+	for (size_t i = 0; i < builder.GetRegionCount(); i++) {
+		const AtlasBuilder::Region& region = builder.GetRegion(i);
+		regions_[builder.GetImageName(i)] = {
+		    pageHandles_[region.page],
+		    {float(region.x), float(region.y)},
+		    {float(region.width), float(region.height)}};
+	}
+}
+
+void TextureAtlas::Release() {
+	for (uint32_t handle : pageHandles_) {
+		TextureManager::Unload(handle);
+	}
+	pageHandles_.clear();
+	regions_.clear();
+}
+
+const TextureAtlas::Region* TextureAtlas::FindRegion(const std::string& imageName) const {
+	auto it = regions_.find(imageName);
+	return it == regions_.end() ? nullptr : &it->second;
+}
+
+void TextureAtlas::Apply(Sprite* sprite, const Region& region) {
+	sprite->SetTextureHandle(region.textureHandle);
+	sprite->SetTextureRect(region.texBase, region.texSize);
+	sprite->SetSize(region.texSize);
+}
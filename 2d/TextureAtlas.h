@@ -0,0 +1,76 @@
+#pragma once
+
+#include "AtlasBuilder.h"
+#include "Vector2.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Sprite;
+
+/// <summary>
+/// テクスチャアトラス
+/// AtlasBuilder で作ったページを TextureManager に読み込み、画像ごとの範囲を
+/// Sprite::SetTextureRect にそのまま渡せる形で引けるようにする。
+/// 同じページの画像を使うスプライトは同じデスクリプタを参照するので、描画のたびに切り替えずに済む
+/// </summary>
+class TextureAtlas {
+public:
+	/// <summary>
+	/// 画像の範囲
+	/// </summary>
+	struct Region {
+		uint32_t textureHandle = 0; // ページのテクスチャハンドル
+		Vector2 texBase{};          // ページ内の左上座標（画素）
+		Vector2 texSize{};          // 幅、高さ（画素）
+	};
+
+	/// <summary>
+	/// 画像ファイルをデコードして詰め込み、ページを読み込む
+	/// </summary>
+	/// <param name="name">アトラスの名前（ページのテクスチャ名は "名前#ページ番号"）</param>
+	/// <param name="fileNames">画像のファイル名（TextureManager と同じディレクトリから探す）</param>
+	/// <param name="options">詰め込みの設定</param>
+	/// <returns>成否（デコードできないか、1ページに入らない画像があれば false）</returns>
+	bool Load(
+	    const std::string& name, const std::vector<std::string>& fileNames,
+	    const AtlasBuilder::Options& options = AtlasBuilder::Options());
+
+	/// <summary>
+	/// 組み立て済みのページを読み込む（ビルド時に作った画像を使う場合など）
+	/// </summary>
+	/// <param name="name">アトラスの名前</param>
+	/// <param name="builder">Build 済みの AtlasBuilder</param>
+	void Create(const std::string& name, const AtlasBuilder& builder);
+
+	/// <summary>
+	/// ページを解放する
+	/// </summary>
+	void Release();
+
+	/// <summary>
+	/// 画像の範囲の検索
+	/// </summary>
+	/// <param name="imageName">画像の名前（Load ならファイル名）</param>
+	/// <returns>範囲（無ければ nullptr）</returns>
+	const Region* FindRegion(const std::string& imageName) const;
+
+	/// <summary>
+	/// スプライトにページと範囲を設定し、大きさを範囲に合わせる
+	/// </summary>
+	/// <param name="sprite">スプライト</param>
+	/// <param name="region">範囲</param>
+	static void Apply(Sprite* sprite, const Region& region);
+
+	/// <summary>
+	/// ページのテクスチャハンドル
+	/// </summary>
+	const std::vector<uint32_t>& GetPageHandles() const { return pageHandles_; }
+
+private:
+	// ページのテクスチャハンドル
+	std::vector<uint32_t> pageHandles_;
+	// 画像の名前から範囲への索引
+	std::unordered_map<std::string, Region> regions_;
+};
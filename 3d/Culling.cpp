@@ -0,0 +1,34 @@
+#include "Culling.h"
+#include "MathUtility.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+ModelBounds ComputeModelBounds(Model* model) {
+	assert(model);
+
+	ModelBounds bounds{};
+	bool isFirst = true;
+	for (Mesh* mesh : model->GetMeshes()) {
+		const std::vector<Mesh::VertexPosNormalUv>& vertices = mesh->GetVertices();
+		AABB aabb = ComputeAABB(vertices.data(), vertices.size(), sizeof(Mesh::VertexPosNormalUv));
+		bounds.meshAABBs.push_back(aabb);
+		if (vertices.empty()) {
+			continue;
+		}
+		bounds.aabb = isFirst ? aabb : Merge(bounds.aabb, aabb);
+		isFirst = false;
+	}
+
+	// 全体の境界球は全メッシュの頂点から求める
+	Vector3 center = (bounds.aabb.min + bounds.aabb.max) * 0.5f;
+	float radiusSq = 0.0f;
+	for (Mesh* mesh : model->GetMeshes()) {
+		for (const Mesh::VertexPosNormalUv& vertex : mesh->GetVertices()) {
+			Vector3 d = vertex.pos - center;
+			radiusSq = (std::max)(radiusSq, Dot(d, d));
+		}
+	}
+	bounds.sphere = {center, std::sqrt(radiusSq)};
+	return bounds;
+}
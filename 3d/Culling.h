@@ -0,0 +1,35 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Frustum.h"
+#include "Model.h"
+#include "ViewProjection.h"
+#include <vector>
+
+/// <summary>
+/// モデルの境界ボリューム
+/// </summary>
+struct ModelBounds {
+	// メッシュごとのAABB（Model::GetMeshes() と同じ順番）
+	std::vector<AABB> meshAABBs;
+	// モデル全体のAABB
+	AABB aabb;
+	// モデル全体の境界球
+	Sphere sphere;
+};
+
+/// <summary>
+/// モデル読み込み後に境界ボリュームを計算する
+/// </summary>
+/// <param name="model">モデル</param>
+/// <returns>境界ボリューム（モデル座標系）</returns>
+ModelBounds ComputeModelBounds(Model* model);
+
+/// <summary>
+/// ビュープロジェクションから視錐台を作る
+/// </summary>
+/// <param name="viewProjection">ビュープロジェクション（UpdateMatrix済み）</param>
+/// <returns>ワールド空間の視錐台</returns>
+inline Frustum MakeFrustum(const ViewProjection& viewProjection) {
+	return Frustum::FromMatrices(viewProjection.matView, viewProjection.matProjection);
+}
@@ -0,0 +1,230 @@
+#include "Frustum.h"
+#include "MathUtility.h"
+#include "SimdConfig.h"
+#include <bit>
+#include <cmath>
+
+namespace {
+
+// 平面の正規化
+Vector4 NormalizePlane(const Vector4& plane) {
+	float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+	float invLength = length != 0.0f ? 1.0f / length : 0.0f;
+	return {plane.x * invLength, plane.y * invLength, plane.z * invLength, plane.w * invLength};
+}
+
+// 判定結果のビットマスクから番号を書き出す
+inline size_t EmitIndices(uint32_t mask, uint32_t base, uint32_t* visibleIndices) {
+	size_t count = 0;
+	while (mask != 0) {
+		visibleIndices[count++] = base + uint32_t(std::countr_zero(mask));
+		mask &= mask - 1;
+	}
+	return count;
+}
+
+} // namespace
+
+Frustum Frustum::FromMatrices(const Matrix4x4& view, const Matrix4x4& projection) {
+	return FromMatrix(view * projection);
+}
+
+Frustum Frustum::FromMatrix(const Matrix4x4& viewProjection) {
+	// 行ベクトル規約なのでクリップ座標の各成分は行列の列との内積になる
+	const Matrix4x4& m = viewProjection;
+	Vector4 column[4];
+	for (int i = 0; i < 4; i++) {
+		column[i] = {m.m[0][i], m.m[1][i], m.m[2][i], m.m[3][i]};
+	}
+	auto add = [](const Vector4& a, const Vector4& b) {
+		return Vector4{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+	};
+	auto subtract = [](const Vector4& a, const Vector4& b) {
+		return Vector4{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+	};
+
+	Frustum frustum;
+	frustum.planes[kLeft] = NormalizePlane(add(column[3], column[0]));
+	frustum.planes[kRight] = NormalizePlane(subtract(column[3], column[0]));
+	frustum.planes[kBottom] = NormalizePlane(add(column[3], column[1]));
+	frustum.planes[kTop] = NormalizePlane(subtract(column[3], column[1]));
+	// DirectXの深度範囲は 0 <= z <= w
+	frustum.planes[kNear] = NormalizePlane(column[2]);
+	frustum.planes[kFar] = NormalizePlane(subtract(column[3], column[2]));
+	return frustum;
+}
+
+bool Frustum::Intersects(const Sphere& sphere) const {
+	for (const Vector4& plane : planes) {
+		float distance = plane.x * sphere.center.x + plane.y * sphere.center.y +
+		                 plane.z * sphere.center.z + plane.w;
+		if (distance < -sphere.radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Frustum::Intersects(const AABB& aabb) const {
+	Vector3 center = (aabb.min + aabb.max) * 0.5f;
+	Vector3 extent = (aabb.max - aabb.min) * 0.5f;
+	for (const Vector4& plane : planes) {
+		float distance =
+		    plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y +
+		               std::abs(plane.z) * extent.z;
+		if (distance < -radius) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t Frustum::CullSpheres(const Sphere* spheres, size_t count, uint32_t* visibleIndices) const {
+	size_t visibleCount = 0;
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	for (; i + 8 <= count; i += 8) {
+		// 1レーンに4個ずつ並べて転置 (レーン0:0～3番, レーン1:4～7番)
+		const float* p = &spheres[i].center.x;
+		__m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 16), 1);
+		__m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 20), 1);
+		__m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 24), 1);
+		__m256 d = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 12)), _mm_loadu_ps(p + 28), 1);
+		__m256 t0 = _mm256_unpacklo_ps(a, b);
+		__m256 t1 = _mm256_unpacklo_ps(c, d);
+		__m256 t2 = _mm256_unpackhi_ps(a, b);
+		__m256 t3 = _mm256_unpackhi_ps(c, d);
+		__m256 x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)));
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const Vector4& plane : planes) {
+			__m256 distance = _mm256_add_ps(
+			    _mm256_add_ps(
+			        _mm256_mul_ps(x, _mm256_set1_ps(plane.x)),
+			        _mm256_mul_ps(y, _mm256_set1_ps(plane.y))),
+			    _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+		}
+		visibleCount += EmitIndices(
+		    uint32_t(_mm256_movemask_ps(inside)), uint32_t(i), visibleIndices + visibleCount);
+	}
+#endif
+#if MATH_SIMD_SSE
+	for (; i + 4 <= count; i += 4) {
+		// 4個の (x,y,z,r) を転置して成分ごとのレジスタにする
+		const float* p = &spheres[i].center.x;
+		__m128 x = _mm_loadu_ps(p);
+		__m128 y = _mm_loadu_ps(p + 4);
+		__m128 z = _mm_loadu_ps(p + 8);
+		__m128 r = _mm_loadu_ps(p + 12);
+		_MM_TRANSPOSE4_PS(x, y, z, r);
+		__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), r);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Vector4& plane : planes) {
+			__m128 distance = _mm_add_ps(
+			    _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+			    _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+		visibleCount +=
+		    EmitIndices(uint32_t(_mm_movemask_ps(inside)), uint32_t(i), visibleIndices + visibleCount);
+	}
+#endif
+	for (; i < count; i++) {
+		if (Intersects(spheres[i])) {
+			visibleIndices[visibleCount++] = uint32_t(i);
+		}
+	}
+	return visibleCount;
+}
+
+size_t Frustum::CullAABBs(const AABB* aabbs, size_t count, uint32_t* visibleIndices) const {
+	size_t visibleCount = 0;
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	const __m256 half8 = _mm256_set1_ps(0.5f);
+	const __m256 absMask8 = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+	for (; i + 8 <= count; i += 8) {
+		const AABB* a = aabbs + i;
+#define FRUSTUM_GATHER8(member)                                                                   \
+	_mm256_setr_ps(                                                                                \
+	    a[0].member, a[1].member, a[2].member, a[3].member, a[4].member, a[5].member, a[6].member, \
+	    a[7].member)
+		__m256 minX = FRUSTUM_GATHER8(min.x), maxX = FRUSTUM_GATHER8(max.x);
+		__m256 minY = FRUSTUM_GATHER8(min.y), maxY = FRUSTUM_GATHER8(max.y);
+		__m256 minZ = FRUSTUM_GATHER8(min.z), maxZ = FRUSTUM_GATHER8(max.z);
+#undef FRUSTUM_GATHER8
+		__m256 cx = _mm256_mul_ps(_mm256_add_ps(minX, maxX), half8);
+		__m256 cy = _mm256_mul_ps(_mm256_add_ps(minY, maxY), half8);
+		__m256 cz = _mm256_mul_ps(_mm256_add_ps(minZ, maxZ), half8);
+		__m256 ex = _mm256_mul_ps(_mm256_sub_ps(maxX, minX), half8);
+		__m256 ey = _mm256_mul_ps(_mm256_sub_ps(maxY, minY), half8);
+		__m256 ez = _mm256_mul_ps(_mm256_sub_ps(maxZ, minZ), half8);
+
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const Vector4& plane : planes) {
+			__m256 px = _mm256_set1_ps(plane.x);
+			__m256 py = _mm256_set1_ps(plane.y);
+			__m256 pz = _mm256_set1_ps(plane.z);
+			__m256 distance = _mm256_add_ps(
+			    _mm256_add_ps(_mm256_mul_ps(cx, px), _mm256_mul_ps(cy, py)),
+			    _mm256_add_ps(_mm256_mul_ps(cz, pz), _mm256_set1_ps(plane.w)));
+			__m256 radius = _mm256_add_ps(
+			    _mm256_add_ps(
+			        _mm256_mul_ps(ex, _mm256_and_ps(px, absMask8)),
+			        _mm256_mul_ps(ey, _mm256_and_ps(py, absMask8))),
+			    _mm256_mul_ps(ez, _mm256_and_ps(pz, absMask8)));
+			inside = _mm256_and_ps(
+			    inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+		}
+		visibleCount += EmitIndices(
+		    uint32_t(_mm256_movemask_ps(inside)), uint32_t(i), visibleIndices + visibleCount);
+	}
+#endif
+#if MATH_SIMD_SSE
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	for (; i + 4 <= count; i += 4) {
+		const AABB* a = aabbs + i;
+#define FRUSTUM_GATHER4(member) _mm_setr_ps(a[0].member, a[1].member, a[2].member, a[3].member)
+		__m128 minX = FRUSTUM_GATHER4(min.x), maxX = FRUSTUM_GATHER4(max.x);
+		__m128 minY = FRUSTUM_GATHER4(min.y), maxY = FRUSTUM_GATHER4(max.y);
+		__m128 minZ = FRUSTUM_GATHER4(min.z), maxZ = FRUSTUM_GATHER4(max.z);
+#undef FRUSTUM_GATHER4
+		__m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+		__m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+		__m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+		__m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+		__m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+		__m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Vector4& plane : planes) {
+			__m128 px = _mm_set1_ps(plane.x);
+			__m128 py = _mm_set1_ps(plane.y);
+			__m128 pz = _mm_set1_ps(plane.z);
+			__m128 distance = _mm_add_ps(
+			    _mm_add_ps(_mm_mul_ps(cx, px), _mm_mul_ps(cy, py)),
+			    _mm_add_ps(_mm_mul_ps(cz, pz), _mm_set1_ps(plane.w)));
+			__m128 radius = _mm_add_ps(
+			    _mm_add_ps(
+			        _mm_mul_ps(ex, _mm_and_ps(px, absMask)), _mm_mul_ps(ey, _mm_and_ps(py, absMask))),
+			    _mm_mul_ps(ez, _mm_and_ps(pz, absMask)));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+		}
+		visibleCount +=
+		    EmitIndices(uint32_t(_mm_movemask_ps(inside)), uint32_t(i), visibleIndices + visibleCount);
+	}
+#endif
+	for (; i < count; i++) {
+		if (Intersects(aabbs[i])) {
+			visibleIndices[visibleCount++] = uint32_t(i);
+		}
+	}
+	return visibleCount;
+}
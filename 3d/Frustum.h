@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Matrix4x4.h"
+#include "Vector4.h"
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 視錐台
+/// ViewProjection の matView / matProjection から平面を取り出し、境界ボリュームをまとめて判定する
+/// </summary>
+struct Frustum {
+	// 平面の番号
+	enum PlaneIndex {
+		kLeft,
+		kRight,
+		kBottom,
+		kTop,
+		kNear,
+		kFar,
+
+		kPlaneCount,
+	};
+
+	// 平面 (ax + by + cz + d >= 0 が内側、法線は正規化済み)
+	Vector4 planes[kPlaneCount];
+
+	/// <summary>
+	/// ビュー行列と射影行列から視錐台を作る
+	/// </summary>
+	/// <param name="view">ビュー行列 (ViewProjection::matView)</param>
+	/// <param name="projection">射影行列 (ViewProjection::matProjection)</param>
+	/// <returns>ワールド空間の視錐台</returns>
+	static Frustum FromMatrices(const Matrix4x4& view, const Matrix4x4& projection);
+
+	/// <summary>
+	/// ビュープロジェクション行列から視錐台を作る
+	/// </summary>
+	/// <param name="viewProjection">ビュー行列×射影行列</param>
+	/// <returns>行列の入力空間での視錐台</returns>
+	static Frustum FromMatrix(const Matrix4x4& viewProjection);
+
+	/// <summary>
+	/// 境界球の判定
+	/// </summary>
+	/// <returns>少しでも内側にあればtrue</returns>
+	bool Intersects(const Sphere& sphere) const;
+
+	/// <summary>
+	/// AABBの判定
+	/// </summary>
+	/// <returns>少しでも内側にあればtrue</returns>
+	bool Intersects(const AABB& aabb) const;
+
+	/// <summary>
+	/// 境界球の一括判定（SSEで4個、AVX2で8個ずつ）
+	/// </summary>
+	/// <param name="spheres">境界球配列</param>
+	/// <param name="count">要素数</param>
+	/// <param name="visibleIndices">見える要素の番号の出力先（count個分の領域が必要）</param>
+	/// <returns>見える要素の数</returns>
+	size_t CullSpheres(const Sphere* spheres, size_t count, uint32_t* visibleIndices) const;
+
+	/// <summary>
+	/// AABBの一括判定（SSEで4個、AVX2で8個ずつ）
+	/// </summary>
+	/// <param name="aabbs">AABB配列</param>
+	/// <param name="count">要素数</param>
+	/// <param name="visibleIndices">見える要素の番号の出力先（count個分の領域が必要）</param>
+	/// <returns>見える要素の数</returns>
+	size_t CullAABBs(const AABB* aabbs, size_t count, uint32_t* visibleIndices) const;
+};
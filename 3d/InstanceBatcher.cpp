@@ -0,0 +1,58 @@
+#include "InstanceBatcher.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+
+void InstanceBatcher::Clear() {
+	keys_.clear();
+	worlds_.clear();
+	batches_.clear();
+	instances_.clear();
+}
+
+void InstanceBatcher::Add(uint32_t key, const Matrix4x4& world) {
+	keys_.push_back(key);
+	worlds_.push_back(world);
+}
+
+void InstanceBatcher::Add(uint32_t key, std::span<const Matrix4x4> worlds) {
+	keys_.insert(keys_.end(), worlds.size(), key);
+	worlds_.insert(worlds_.end(), worlds.begin(), worlds.end());
+}
+
+void InstanceBatcher::Build() {
+	const size_t count = keys_.size();
+	assert(count <= UINT32_MAX);
+	batches_.clear();
+	instances_.resize(count);
+	if (count == 0) {
+		return;
+	}
+
+	// 番号と追加順を1つの整数にして並べ替えると、番号が同じ要求は追加順のまま並ぶ
+	order_.resize(count);
+	bool isSorted = true;
+	for (size_t i = 0; i < count; i++) {
+		order_[i] = (uint64_t(keys_[i]) << 32) | i;
+		isSorted = isSorted && (i == 0 || keys_[i - 1] <= keys_[i]);
+	}
+	// 番号順に追加されていることが多いので、その場合は並べ替えない
+	if (!isSorted) {
+		std::sort(order_.begin(), order_.end());
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const uint32_t key = uint32_t(order_[i] >> 32);
+		if (batches_.empty() || batches_.back().key != key) {
+			batches_.push_back({key, uint32_t(i), 0});
+		}
+		batches_.back().instanceCount++;
+	}
+
+	// 行列を並べ替えた順に詰める
+	ThreadPool::GetInstance()->ParallelFor(count, kPackGrainSize, [this](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			instances_[i].world = worlds_[uint32_t(order_[i])];
+		}
+	});
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// インスタンスごとのデータ（ObjInstancedVS の構造化バッファの要素）
+/// </summary>
+struct InstanceData {
+	Matrix4x4 world; // ワールド行列
+};
+
+/// <summary>
+/// インスタンス描画のまとめ
+/// 描画要求（描画対象の番号とワールド行列）を番号ごとにまとめ、行列を1本の配列に詰める。
+/// GPUには依存しないので、詰めた配列をそのまま構造化バッファへコピーして使う
+/// </summary>
+class InstanceBatcher {
+public:
+	/// <summary>
+	/// 同じ描画対象のインスタンスの範囲
+	/// </summary>
+	struct Batch {
+		uint32_t key;           // 描画対象の番号
+		uint32_t firstInstance; // GetInstances() 内の先頭
+		uint32_t instanceCount; // インスタンス数
+	};
+
+	/// <summary>
+	/// 描画要求を空にする（確保したメモリは再利用する）
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 描画要求の追加
+	/// </summary>
+	/// <param name="key">描画対象の番号（Model::DrawInstanced に渡すモデル配列の添字など）</param>
+	/// <param name="world">ワールド行列</param>
+	void Add(uint32_t key, const Matrix4x4& world);
+
+	/// <summary>
+	/// 描画要求の一括追加
+	/// </summary>
+	/// <param name="key">描画対象の番号</param>
+	/// <param name="worlds">ワールド行列</param>
+	void Add(uint32_t key, std::span<const Matrix4x4> worlds);
+
+	/// <summary>
+	/// 番号ごとにまとめて行列を詰める（同じ番号の中では追加した順を保つ）
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// 番号の昇順に並んだまとまり（Build後に有効）
+	/// </summary>
+	std::span<const Batch> GetBatches() const { return batches_; }
+
+	/// <summary>
+	/// まとまりの順に詰めたインスタンスデータ（Build後に有効）
+	/// </summary>
+	std::span<const InstanceData> GetInstances() const { return instances_; }
+
+	size_t GetRequestCount() const { return keys_.size(); }
+
+private:
+	// 並列に詰める単位（インスタンス数）
+	static const size_t kPackGrainSize = 4096;
+
+	// 追加された描画要求
+	std::vector<uint32_t> keys_;
+	std::vector<Matrix4x4> worlds_;
+	// 並べ替えの作業領域（上位32bitが番号、下位32bitが追加順）
+	std::vector<uint64_t> order_;
+	// 結果
+	std::vector<Batch> batches_;
+	std::vector<InstanceData> instances_;
+};
@@ -0,0 +1,39 @@
+#include "LodSelector.h"
+#include "MathUtility.h"
+#include <algorithm>
+
+namespace {
+
+// 視点が境界球の中にあるときの距離の下限
+const float kMinDistance = 1.0e-4f;
+
+} // namespace
+
+LodSelector LodSelector::FromMatrices(
+    const Matrix4x4& view, const Matrix4x4& projection, float screenHeight, float pixelThreshold) {
+	LodSelector selector;
+	// ビュー行列の逆行列の平行移動成分が視点の位置
+	const Matrix4x4 inverseView = InverseAffine(view);
+	selector.cameraPosition = {inverseView.m[3][0], inverseView.m[3][1], inverseView.m[3][2]};
+	// m[1][1] = 1 / tan(fovY / 2) なので、距離1での画面の高さは 2 / m[1][1]
+	selector.projectionScale = screenHeight * 0.5f * projection.m[1][1];
+	selector.pixelThreshold = pixelThreshold;
+	return selector;
+}
+
+float LodSelector::ComputeScreenError(float error, float distance) const {
+	return error * projectionScale / (std::max)(distance, kMinDistance);
+}
+
+uint32_t LodSelector::Select(
+    std::span<const float> lodErrors, const Sphere& sphere, float scale) const {
+	// 境界球の最も近い点で判定する（近づいても誤差が過小評価されない）
+	const float distance = Length(sphere.center - cameraPosition) - sphere.radius;
+	// 粗いLODから順に調べ、閾値に収まる最初のLODを使う
+	for (size_t lod = lodErrors.size(); 1 < lod; lod--) {
+		if (ComputeScreenError(lodErrors[lod - 1] * scale, distance) <= pixelThreshold) {
+			return uint32_t(lod - 1);
+		}
+	}
+	return 0;
+}
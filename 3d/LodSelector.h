@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include "ViewProjection.h"
+#include <cstdint>
+#include <span>
+
+/// <summary>
+/// 画面上の大きさによるLODの選択
+/// 簡略化の誤差（モデル座標系の距離）を視点からの距離で画素数に換算し、
+/// 閾値に収まる最も粗いLODを選ぶ。
+/// LODは MeshCache で作って MeshBuffer に持たせたものを選ぶ（Model の描画はLODを持たない）
+/// </summary>
+struct LodSelector {
+	Vector3 cameraPosition = {0.0f, 0.0f, 0.0f}; // 視点（ワールド座標）
+	float projectionScale = 1.0f;                // 距離1の位置で長さ1が何画素になるか
+	float pixelThreshold = 1.0f;                 // 許容する画面上の誤差（画素）
+
+	/// <summary>
+	/// ビュー行列と射影行列から作る
+	/// </summary>
+	/// <param name="view">ビュー行列 (ViewProjection::matView)</param>
+	/// <param name="projection">射影行列 (ViewProjection::matProjection)</param>
+	/// <param name="screenHeight">画面の高さ（画素）</param>
+	/// <param name="pixelThreshold">許容する画面上の誤差（画素）</param>
+	static LodSelector FromMatrices(
+	    const Matrix4x4& view, const Matrix4x4& projection, float screenHeight,
+	    float pixelThreshold = 1.0f);
+
+	/// <summary>
+	/// 誤差の画面上の大きさ
+	/// </summary>
+	/// <param name="error">誤差（ワールド座標系の距離）</param>
+	/// <param name="distance">視点からの距離</param>
+	/// <returns>画素数</returns>
+	float ComputeScreenError(float error, float distance) const;
+
+	/// <summary>
+	/// LODの選択
+	/// </summary>
+	/// <param name="lodErrors">LODごとの誤差（MeshBuffer::GetLodErrors）</param>
+	/// <param name="sphere">境界球（ワールド座標系）</param>
+	/// <param name="scale">ワールド行列の最大の拡大率（誤差に掛ける）</param>
+	/// <returns>LOD番号</returns>
+	uint32_t Select(std::span<const float> lodErrors, const Sphere& sphere, float scale = 1.0f) const;
+};
+
+/// <summary>
+/// ビュープロジェクションからLODの選択条件を作る
+/// </summary>
+/// <param name="viewProjection">ビュープロジェクション（UpdateMatrix済み）</param>
+/// <param name="screenHeight">画面の高さ（画素）</param>
+/// <param name="pixelThreshold">許容する画面上の誤差（画素）</param>
+inline LodSelector MakeLodSelector(
+    const ViewProjection& viewProjection, float screenHeight, float pixelThreshold = 1.0f) {
+	return LodSelector::FromMatrices(
+	    viewProjection.matView, viewProjection.matProjection, screenHeight, pixelThreshold);
+}
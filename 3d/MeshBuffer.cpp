@@ -0,0 +1,190 @@
+#include "MeshBuffer.h"
+#include "DirectXCommon.h"
+#include <cassert>
+#include <cstring>
+#include <d3dx12.h>
+
+namespace {
+
+// アップロードヒープにバッファを作ってマップする
+Microsoft::WRL::ComPtr<ID3D12Resource> CreateUploadBuffer(size_t size, void** mapped) {
+	HRESULT result;
+	ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&buffer));
+	assert(SUCCEEDED(result));
+
+	result = buffer->Map(0, nullptr, mapped);
+	assert(SUCCEEDED(result));
+	return buffer;
+}
+
+} // namespace
+
+void MeshBuffer::Create(const MeshData& mesh, VertexFormat format) {
+	std::vector<IndexSource> sources;
+	sources.reserve(mesh.lods.size() + 1);
+	sources.push_back({mesh.indices.data(), mesh.indices.size(), 0.0f});
+	for (const MeshLod& lod : mesh.lods) {
+		sources.push_back({lod.indices.data(), lod.indices.size(), lod.error});
+	}
+	CreateBuffers(mesh.vertices.data(), mesh.vertices.size(), sources, false, format);
+}
+
+void MeshBuffer::Create(const MeshCache::MeshView& mesh, VertexFormat format) {
+	std::vector<IndexSource> sources;
+	sources.reserve(mesh.lods.size() + 1);
+	sources.push_back({mesh.indices, mesh.indexCount, 0.0f});
+	for (const MeshCache::LodView& lod : mesh.lods) {
+		sources.push_back({lod.indices, lod.indexCount, lod.error});
+	}
+	CreateBuffers(
+	    mesh.vertices.data(), mesh.vertices.size(), sources,
+	    mesh.indexFormat == MeshCache::IndexFormat::kUInt16, format);
+}
+
+std::span<const D3D12_INPUT_ELEMENT_DESC> MeshBuffer::GetInputLayout(VertexFormat format) {
+	static const D3D12_INPUT_ELEMENT_DESC kFloat32Layout[] = {
+	    {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	static const D3D12_INPUT_ELEMENT_DESC kHalfLayout[] = {
+	    {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+	static const D3D12_INPUT_ELEMENT_DESC kUnorm16Layout[] = {
+	    {"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	    {"TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, D3D12_APPEND_ALIGNED_ELEMENT,
+	     D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+	};
+
+	switch (format) {
+	case VertexFormat::kHalf:
+		return kHalfLayout;
+	case VertexFormat::kUnorm16:
+		return kUnorm16Layout;
+	default:
+		return kFloat32Layout;
+	}
+}
+
+void MeshBuffer::Draw(ID3D12GraphicsCommandList* commandList, UINT instanceCount, UINT lod) const {
+	assert(lod < lods_.size());
+	// 頂点バッファ・インデックスバッファの設定
+	commandList->IASetVertexBuffers(0, 1, &vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+
+	// 描画コマンド
+	const LodRange& range = lods_[lod];
+	commandList->DrawIndexedInstanced(range.indexCount, instanceCount, range.startIndex, 0, 0);
+}
+
+void MeshBuffer::DrawRanges(
+    ID3D12GraphicsCommandList* commandList, std::span<const IndexRange> ranges,
+    UINT instanceCount) const {
+	if (ranges.empty()) {
+		return;
+	}
+	// 頂点バッファ・インデックスバッファの設定
+	commandList->IASetVertexBuffers(0, 1, &vbView_);
+	commandList->IASetIndexBuffer(&ibView_);
+
+	// 描画コマンド（LOD0はインデックスバッファの先頭にある）
+	for (const IndexRange& range : ranges) {
+		assert(range.firstIndex + range.indexCount <= indexCount_);
+		commandList->DrawIndexedInstanced(range.indexCount, instanceCount, range.firstIndex, 0, 0);
+	}
+}
+
+void MeshBuffer::CreateBuffers(
+    const MeshVertex* vertices, size_t vertexCount, std::span<const IndexSource> sources,
+    bool isSourceUInt16, VertexFormat format) {
+	assert(vertexCount != 0 && !sources.empty() && sources[0].indexCount != 0);
+	const bool isUInt16 = vertexCount <= kMaxUInt16IndexVertexCount;
+	// 16bitで表せない頂点数のメッシュが16bitで渡されることはない
+	assert(isUInt16 || !isSourceUInt16);
+
+	size_t indexCount = 0;
+	for (const IndexSource& source : sources) {
+		indexCount += source.indexCount;
+	}
+	const size_t indexSize = isUInt16 ? sizeof(uint16_t) : sizeof(uint32_t);
+	const size_t stride = GetVertexStride(format);
+	const size_t sizeVB = stride * vertexCount;
+	const size_t sizeIB = indexSize * indexCount;
+
+	// 頂点バッファ生成と転送
+	void* vertMap = nullptr;
+	vertBuff_ = CreateUploadBuffer(sizeVB, &vertMap);
+	quantizationParameters_ = ComputeQuantizationParameters(vertices, vertexCount, format);
+	if (format == VertexFormat::kFloat32) {
+		std::memcpy(vertMap, vertices, sizeVB);
+	} else {
+		QuantizeVertices(
+		    vertices, vertexCount, format, quantizationParameters_,
+		    static_cast<QuantizedVertex*>(vertMap));
+	}
+	vertBuff_->Unmap(0, nullptr);
+
+	// インデックスバッファ生成と転送（LODを順に詰め、必要なら幅を変換する）
+	void* indexMap = nullptr;
+	indexBuff_ = CreateUploadBuffer(sizeIB, &indexMap);
+	lods_.clear();
+	lodErrors_.clear();
+	size_t startIndex = 0;
+	for (const IndexSource& lod : sources) {
+		uint8_t* destination = static_cast<uint8_t*>(indexMap) + indexSize * startIndex;
+		if (isUInt16 == isSourceUInt16) {
+			std::memcpy(destination, lod.indices, indexSize * lod.indexCount);
+		} else if (isUInt16) {
+			const uint32_t* source = static_cast<const uint32_t*>(lod.indices);
+			uint16_t* destination16 = reinterpret_cast<uint16_t*>(destination);
+			for (size_t i = 0; i < lod.indexCount; i++) {
+				destination16[i] = uint16_t(source[i]);
+			}
+		} else {
+			const uint16_t* source = static_cast<const uint16_t*>(lod.indices);
+			uint32_t* destination32 = reinterpret_cast<uint32_t*>(destination);
+			for (size_t i = 0; i < lod.indexCount; i++) {
+				destination32[i] = source[i];
+			}
+		}
+		lods_.push_back({UINT(startIndex), UINT(lod.indexCount)});
+		lodErrors_.push_back(lod.error);
+		startIndex += lod.indexCount;
+	}
+	indexBuff_->Unmap(0, nullptr);
+
+	// 頂点バッファビューの作成
+	vbView_.BufferLocation = vertBuff_->GetGPUVirtualAddress();
+	vbView_.SizeInBytes = UINT(sizeVB);
+	vbView_.StrideInBytes = UINT(stride);
+
+	// インデックスバッファビューの作成
+	ibView_.BufferLocation = indexBuff_->GetGPUVirtualAddress();
+	ibView_.Format = isUInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	ibView_.SizeInBytes = UINT(sizeIB);
+
+	vertexFormat_ = format;
+	vertexCount_ = UINT(vertexCount);
+	indexCount_ = UINT(sources[0].indexCount);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "MeshCache.h"
+#include "MeshData.h"
+#include "VertexQuantization.h"
+#include <d3d12.h>
+#include <span>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// メッシュのGPUバッファ
+/// 頂点数が 65536 以下なら16bit、超えるなら32bitのインデックスバッファを作る。
+/// kFloat32 の頂点は Mesh::VertexPosNormalUv と同じ配置なので Obj 用パイプラインでそのまま描画できる。
+/// 圧縮形式は ObjQuantizedVS / TerrainQuantizedVS と GetInputLayout の入力レイアウトで描画し、
+/// GetQuantizationParameters を b4 の定数バッファに設定する。
+/// LODのインデックスはLOD0の後ろに続けて同じインデックスバッファに入れる
+/// </summary>
+class MeshBuffer {
+public:
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="mesh">メッシュデータ</param>
+	/// <param name="format">頂点形式</param>
+	void Create(const MeshData& mesh, VertexFormat format = VertexFormat::kFloat32);
+
+	/// <summary>
+	/// キャッシュ上のメッシュから生成（16bitインデックスはそのまま転送する）
+	/// </summary>
+	/// <param name="mesh">メッシュの参照</param>
+	/// <param name="format">頂点形式</param>
+	void Create(const MeshCache::MeshView& mesh, VertexFormat format = VertexFormat::kFloat32);
+
+	/// <summary>
+	/// 頂点バッファ・インデックスバッファを設定して描画する
+	/// マテリアルとテクスチャは呼び出し側で設定しておく
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	/// <param name="lod">LOD番号（0が元の形状）</param>
+	void Draw(ID3D12GraphicsCommandList* commandList, UINT instanceCount = 1, UINT lod = 0) const;
+
+	/// <summary>
+	/// LOD0のインデックスの一部だけを描画する（MeshletCuller::Cull の結果など）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	/// <param name="ranges">インデックス範囲</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	void DrawRanges(
+	    ID3D12GraphicsCommandList* commandList, std::span<const IndexRange> ranges,
+	    UINT instanceCount = 1) const;
+
+	const D3D12_VERTEX_BUFFER_VIEW& GetVBView() const { return vbView_; }
+
+	/// <summary>
+	/// インデックスバッファビュー（Format は DXGI_FORMAT_R16_UINT か DXGI_FORMAT_R32_UINT）
+	/// </summary>
+	const D3D12_INDEX_BUFFER_VIEW& GetIBView() const { return ibView_; }
+
+	/// <summary>
+	/// 頂点形式に対応する入力レイアウト
+	/// </summary>
+	static std::span<const D3D12_INPUT_ELEMENT_DESC> GetInputLayout(VertexFormat format);
+
+	VertexFormat GetVertexFormat() const { return vertexFormat_; }
+	const QuantizationParameters& GetQuantizationParameters() const {
+		return quantizationParameters_;
+	}
+	UINT GetVertexCount() const { return vertexCount_; }
+	UINT GetIndexCount() const { return indexCount_; }
+
+	/// <summary>
+	/// LODの数（LOD0を含む）
+	/// </summary>
+	UINT GetLodCount() const { return UINT(lods_.size()); }
+
+	/// <summary>
+	/// LODごとの元の形状からの誤差（LOD0は0。LodSelection の SelectLod に渡す）
+	/// </summary>
+	std::span<const float> GetLodErrors() const { return lodErrors_; }
+
+	UINT GetLodIndexCount(UINT lod) const { return lods_[lod].indexCount; }
+
+private:
+	// 転送元のインデックス列
+	struct IndexSource {
+		const void* indices;
+		size_t indexCount;
+		float error;
+	};
+
+	// インデックスバッファ内のLODの範囲
+	struct LodRange {
+		UINT startIndex;
+		UINT indexCount;
+	};
+
+	/// <summary>
+	/// バッファ生成
+	/// </summary>
+	/// <param name="vertices">頂点データ</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="sources">LODごとのインデックス（先頭がLOD0）</param>
+	/// <param name="isSourceUInt16">元のインデックスが16bitか</param>
+	/// <param name="format">頂点形式</param>
+	void CreateBuffers(
+	    const MeshVertex* vertices, size_t vertexCount, std::span<const IndexSource> sources,
+	    bool isSourceUInt16, VertexFormat format);
+
+	// 頂点バッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertBuff_;
+	// インデックスバッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexBuff_;
+	// 頂点バッファビュー
+	D3D12_VERTEX_BUFFER_VIEW vbView_ = {};
+	// インデックスバッファビュー
+	D3D12_INDEX_BUFFER_VIEW ibView_ = {};
+	// 頂点数
+	UINT vertexCount_ = 0;
+	// インデックス数（LOD0）
+	UINT indexCount_ = 0;
+	// LODごとの範囲と誤差
+	std::vector<LodRange> lods_;
+	std::vector<float> lodErrors_;
+	// 頂点形式
+	VertexFormat vertexFormat_ = VertexFormat::kFloat32;
+	// 圧縮頂点の復元用パラメータ
+	QuantizationParameters quantizationParameters_;
+};
@@ -0,0 +1,592 @@
+#include "MeshCache.h"
+#include "Hash.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ObjLoader.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace {
+
+// ファイル識別子
+const char kMagic[4] = {'M', 'S', 'H', 'C'};
+// 形式のバージョン（レイアウトか中身の作り方を変えたら上げる）
+const uint32_t kVersion = 8;
+// データブロックの境界
+const size_t kBlobAlignment = 16;
+
+// 文字列テーブル内の位置
+struct StringRef {
+	uint32_t offset;
+	uint32_t length;
+};
+
+// ファイルヘッダ
+struct Header {
+	char magic[4];
+	uint32_t version;
+	uint32_t smoothing;
+	uint32_t lodCount;
+	uint32_t sourceCount;
+	uint32_t materialCount;
+	uint32_t meshCount;
+	uint32_t lodRecordCount;
+	uint32_t meshlets;
+	uint32_t meshletRecordCount;
+	uint64_t stringTableOffset;
+	uint64_t stringTableSize;
+	uint64_t fileSize;
+};
+
+// 元ファイルの情報（パスは.objのディレクトリからの相対）
+struct SourceRecord {
+	StringRef path;
+	uint64_t size;
+	int64_t writeTime;
+	uint64_t hash;
+};
+
+// マテリアル
+struct MaterialRecord {
+	StringRef name;
+	StringRef textureFilename;
+	Vector3 ambient;
+	Vector3 diffuse;
+	Vector3 specular;
+	float alpha;
+};
+
+// メッシュ
+struct MeshRecord {
+	StringRef name;
+	StringRef materialName;
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t indexSize;
+	uint32_t lodCount;
+	uint32_t meshletCount;
+	uint32_t padding;
+	AABB bounds;
+};
+
+// LOD（メッシュの順に並べ、形式はメッシュと同じ）
+struct LodRecord {
+	uint64_t indexOffset;
+	uint32_t indexCount;
+	float error;
+};
+
+// メッシュレットは Meshlet をそのまま並べる（メッシュの順）
+
+size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// ディレクトリ部分（末尾の/を含む）
+std::string GetDirectory(const std::string& filePath) {
+	size_t pos = filePath.find_last_of("/\\");
+	return pos == std::string::npos ? std::string() : filePath.substr(0, pos + 1);
+}
+
+// ファイルのサイズと更新日時
+bool GetFileStatus(const std::string& filePath, uint64_t& size, int64_t& writeTime) {
+	std::error_code error;
+	auto fileSize = std::filesystem::file_size(filePath, error);
+	if (error) {
+		return false;
+	}
+	auto time = std::filesystem::last_write_time(filePath, error);
+	if (error) {
+		return false;
+	}
+	size = uint64_t(fileSize);
+	writeTime = int64_t(time.time_since_epoch().count());
+	return true;
+}
+
+// ファイル内容のハッシュ
+bool HashFile(const std::string& filePath, uint64_t& hash) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	hash = Hash64(file.GetData(), file.GetSize());
+	return true;
+}
+
+// 元ファイルの一覧（.obj と、参照している .mtl）
+std::vector<std::string> GetSourceNames(const std::string& objPath, const ModelData& modelData) {
+	size_t pos = objPath.find_last_of("/\\");
+	std::vector<std::string> names;
+	names.push_back(pos == std::string::npos ? objPath : objPath.substr(pos + 1));
+	names.insert(
+	    names.end(), modelData.materialLibraries.begin(), modelData.materialLibraries.end());
+	return names;
+}
+
+/// <summary>
+/// キャッシュの組み立て
+/// </summary>
+class Writer {
+public:
+	template<typename T> size_t Append(const T& value) {
+		return AppendBytes(&value, sizeof(T));
+	}
+
+	size_t AppendBytes(const void* data, size_t size) {
+		size_t offset = bytes_.size();
+		bytes_.resize(offset + size);
+		if (size != 0) {
+			std::memcpy(bytes_.data() + offset, data, size);
+		}
+		return offset;
+	}
+
+	void Align(size_t alignment) { bytes_.resize(AlignUp(bytes_.size(), alignment)); }
+
+	template<typename T> T& At(size_t offset) { return *reinterpret_cast<T*>(bytes_.data() + offset); }
+
+	size_t GetSize() const { return bytes_.size(); }
+
+	std::vector<uint8_t>& GetBytes() { return bytes_; }
+
+	// 文字列は後でまとめて書くため、先にテーブル上の位置を決めておく
+	StringRef AddString(const std::string& string) {
+		StringRef ref{uint32_t(strings_.size()), uint32_t(string.size())};
+		strings_ += string;
+		return ref;
+	}
+
+	const std::string& GetStrings() const { return strings_; }
+
+private:
+	std::vector<uint8_t> bytes_;
+	std::string strings_;
+};
+
+} // namespace
+
+bool MeshCache::LoadOrBuild(
+    const std::string& objPath, bool smoothing, uint32_t lodCount, bool buildMeshlets) {
+	Close();
+	wasRebuilt_ = false;
+
+	const std::string cachePath = GetCachePath(objPath, smoothing);
+	if (IsUpToDate(cachePath, objPath, smoothing, lodCount, buildMeshlets) && Load(cachePath)) {
+		return true;
+	}
+
+	ModelData modelData;
+	if (!ObjLoader::Load(objPath, smoothing, modelData)) {
+		return false;
+	}
+	for (MeshData& mesh : modelData.meshes) {
+		MeshSimplifier::GenerateLods(mesh, lodCount);
+		// LODは元の順のLOD0から作り、メッシュレットの並べ替えはその後にする
+		if (buildMeshlets) {
+			MeshletBuilder::Build(mesh);
+		}
+	}
+	std::vector<uint8_t> bytes;
+	if (!Serialize(objPath, smoothing, lodCount, buildMeshlets, modelData, bytes)) {
+		return false;
+	}
+	wasRebuilt_ = true;
+
+	// 一時ファイルに書いてから置き換え、書きかけのキャッシュを読まないようにする
+	const std::string temporaryPath = cachePath + ".tmp";
+	bool isWritten = false;
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (file) {
+			file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+			isWritten = bool(file);
+		}
+	}
+	std::error_code error;
+	if (isWritten) {
+		std::filesystem::rename(temporaryPath, cachePath, error);
+		isWritten = !error;
+	}
+	if (!isWritten) {
+		std::filesystem::remove(temporaryPath, error);
+	}
+
+	if (isWritten && Load(cachePath)) {
+		return true;
+	}
+	// 書き出せなくても今回はメモリ上の内容を使う
+	buffer_ = std::move(bytes);
+	return Parse(buffer_.data(), buffer_.size());
+}
+
+bool MeshCache::Load(const std::string& cachePath) {
+	Close();
+	if (!file_.Open(cachePath)) {
+		return false;
+	}
+	if (!Parse(file_.GetData(), file_.GetSize())) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool MeshCache::Write(
+    const std::string& cachePath, const std::string& objPath, bool smoothing, uint32_t lodCount,
+    bool buildMeshlets, const ModelData& modelData) {
+	std::vector<uint8_t> bytes;
+	if (!Serialize(objPath, smoothing, lodCount, buildMeshlets, modelData, bytes)) {
+		return false;
+	}
+	std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+	return bool(file);
+}
+
+bool MeshCache::IsUpToDate(
+    const std::string& cachePath, const std::string& objPath, bool smoothing, uint32_t lodCount,
+    bool buildMeshlets) {
+	MappedFile file;
+	if (!file.Open(cachePath) || file.GetSize() < sizeof(Header)) {
+		return false;
+	}
+	Header header;
+	std::memcpy(&header, file.GetData(), sizeof(Header));
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+	    header.fileSize != file.GetSize() || header.smoothing != uint32_t(smoothing) ||
+	    header.lodCount != lodCount || header.meshlets != uint32_t(buildMeshlets)) {
+		return false;
+	}
+	const size_t sourcesEnd = sizeof(Header) + sizeof(SourceRecord) * size_t(header.sourceCount);
+	if (file.GetSize() < sourcesEnd || header.sourceCount == 0 ||
+	    file.GetSize() < header.stringTableOffset + header.stringTableSize) {
+		return false;
+	}
+
+	const std::string directoryPath = GetDirectory(objPath);
+	const char* strings = reinterpret_cast<const char*>(file.GetData() + header.stringTableOffset);
+	for (uint32_t i = 0; i < header.sourceCount; i++) {
+		SourceRecord source;
+		std::memcpy(
+		    &source, file.GetData() + sizeof(Header) + sizeof(SourceRecord) * i,
+		    sizeof(SourceRecord));
+		if (header.stringTableSize < uint64_t(source.path.offset) + source.path.length) {
+			return false;
+		}
+		std::string sourcePath =
+		    directoryPath + std::string(strings + source.path.offset, source.path.length);
+
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+		if (!GetFileStatus(sourcePath, size, writeTime) || size != source.size) {
+			return false;
+		}
+		// 日時だけ違う場合（チェックアウトやコピー）は内容で判定する
+		if (writeTime != source.writeTime) {
+			uint64_t hash = 0;
+			if (!HashFile(sourcePath, hash) || hash != source.hash) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+std::string MeshCache::GetCachePath(const std::string& objPath, bool smoothing) {
+	return objPath + (smoothing ? ".smooth.meshcache" : ".meshcache");
+}
+
+void MeshCache::Close() {
+	meshes_.clear();
+	lods_.clear();
+	materials_.clear();
+	file_.Close();
+	buffer_.clear();
+}
+
+void MeshCache::ToModelData(ModelData& modelData) const {
+	modelData = ModelData{};
+	modelData.materials = materials_;
+	modelData.meshes.reserve(meshes_.size());
+	for (const MeshView& view : meshes_) {
+		MeshData& mesh = modelData.meshes.emplace_back();
+		mesh.name = view.name;
+		mesh.materialName = view.materialName;
+		mesh.vertices.assign(view.vertices.begin(), view.vertices.end());
+		mesh.indices.resize(view.indexCount);
+		for (uint32_t i = 0; i < view.indexCount; i++) {
+			mesh.indices[i] = view.GetIndex(i);
+		}
+		mesh.bounds = view.bounds;
+		mesh.lods.resize(view.lods.size());
+		for (size_t lod = 0; lod < view.lods.size(); lod++) {
+			const LodView& lodView = view.lods[lod];
+			MeshLod& meshLod = mesh.lods[lod];
+			meshLod.indices.resize(lodView.indexCount);
+			for (uint32_t i = 0; i < lodView.indexCount; i++) {
+				meshLod.indices[i] = view.indexFormat == IndexFormat::kUInt16
+				                         ? static_cast<const uint16_t*>(lodView.indices)[i]
+				                         : static_cast<const uint32_t*>(lodView.indices)[i];
+			}
+			meshLod.error = lodView.error;
+		}
+		mesh.meshlets.assign(view.meshlets.begin(), view.meshlets.end());
+	}
+}
+
+bool MeshCache::Serialize(
+    const std::string& objPath, bool smoothing, uint32_t lodCount, bool buildMeshlets,
+    const ModelData& modelData, std::vector<uint8_t>& bytes) {
+	Writer writer;
+
+	const size_t headerOffset = writer.Append(Header{});
+
+	// 元ファイル
+	const std::string directoryPath = GetDirectory(objPath);
+	const std::vector<std::string> sourceNames = GetSourceNames(objPath, modelData);
+	for (const std::string& name : sourceNames) {
+		SourceRecord source{};
+		source.path = writer.AddString(name);
+		if (!GetFileStatus(directoryPath + name, source.size, source.writeTime) ||
+		    !HashFile(directoryPath + name, source.hash)) {
+			// 読めない元ファイルは一致しない値にして次回も作り直させる
+			source.size = UINT64_MAX;
+		}
+		writer.Append(source);
+	}
+
+	// マテリアル
+	for (const MaterialData& material : modelData.materials) {
+		MaterialRecord record{};
+		record.name = writer.AddString(material.name);
+		record.textureFilename = writer.AddString(material.textureFilename);
+		record.ambient = material.ambient;
+		record.diffuse = material.diffuse;
+		record.specular = material.specular;
+		record.alpha = material.alpha;
+		writer.Append(record);
+	}
+
+	// メッシュ（データ位置は後で埋める）
+	const size_t meshRecordOffset = writer.GetSize();
+	for (const MeshData& mesh : modelData.meshes) {
+		if (UINT32_MAX < mesh.vertices.size() || UINT32_MAX < mesh.indices.size()) {
+			return false;
+		}
+		MeshRecord record{};
+		record.name = writer.AddString(mesh.name);
+		record.materialName = writer.AddString(mesh.materialName);
+		record.vertexCount = uint32_t(mesh.vertices.size());
+		record.indexCount = uint32_t(mesh.indices.size());
+		record.indexSize = uint32_t(
+		    mesh.vertices.size() <= kMaxUInt16IndexVertexCount ? IndexFormat::kUInt16
+		                                               : IndexFormat::kUInt32);
+		record.lodCount = uint32_t(mesh.lods.size());
+		record.meshletCount = uint32_t(mesh.meshlets.size());
+		record.bounds = mesh.bounds;
+		writer.Append(record);
+	}
+
+	// LOD（データ位置は後で埋める）
+	const size_t lodRecordOffset = writer.GetSize();
+	size_t lodRecordCount = 0;
+	for (const MeshData& mesh : modelData.meshes) {
+		for (const MeshLod& lod : mesh.lods) {
+			if (UINT32_MAX < lod.indices.size()) {
+				return false;
+			}
+			LodRecord record{};
+			record.indexCount = uint32_t(lod.indices.size());
+			record.error = lod.error;
+			writer.Append(record);
+			lodRecordCount++;
+		}
+	}
+
+	// メッシュレット
+	size_t meshletRecordCount = 0;
+	for (const MeshData& mesh : modelData.meshes) {
+		writer.AppendBytes(mesh.meshlets.data(), sizeof(Meshlet) * mesh.meshlets.size());
+		meshletRecordCount += mesh.meshlets.size();
+	}
+
+	// 文字列テーブル
+	const size_t stringTableOffset = writer.AppendBytes(
+	    writer.GetStrings().data(), writer.GetStrings().size());
+
+	// 頂点・インデックス
+	size_t lodIndex = 0;
+	for (size_t i = 0; i < modelData.meshes.size(); i++) {
+		const MeshData& mesh = modelData.meshes[i];
+		const size_t recordOffset = meshRecordOffset + sizeof(MeshRecord) * i;
+		const bool isUInt16 =
+		    writer.At<MeshRecord>(recordOffset).indexSize == uint32_t(IndexFormat::kUInt16);
+		auto appendIndices = [&writer, isUInt16](const std::vector<uint32_t>& indices) {
+			writer.Align(kBlobAlignment);
+			size_t offset = writer.GetSize();
+			if (isUInt16) {
+				for (uint32_t index : indices) {
+					writer.Append(uint16_t(index));
+				}
+			} else {
+				writer.AppendBytes(indices.data(), sizeof(uint32_t) * indices.size());
+			}
+			return offset;
+		};
+
+		writer.Align(kBlobAlignment);
+		const size_t vertexOffset =
+		    writer.AppendBytes(mesh.vertices.data(), sizeof(MeshVertex) * mesh.vertices.size());
+		const size_t indexOffset = appendIndices(mesh.indices);
+
+		MeshRecord& record = writer.At<MeshRecord>(recordOffset);
+		record.vertexOffset = vertexOffset;
+		record.indexOffset = indexOffset;
+
+		for (const MeshLod& lod : mesh.lods) {
+			const size_t lodOffset = appendIndices(lod.indices);
+			writer.At<LodRecord>(lodRecordOffset + sizeof(LodRecord) * lodIndex++).indexOffset =
+			    lodOffset;
+		}
+	}
+
+	Header& header = writer.At<Header>(headerOffset);
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.smoothing = uint32_t(smoothing);
+	header.lodCount = lodCount;
+	header.sourceCount = uint32_t(sourceNames.size());
+	header.materialCount = uint32_t(modelData.materials.size());
+	header.meshCount = uint32_t(modelData.meshes.size());
+	header.lodRecordCount = uint32_t(lodRecordCount);
+	header.meshlets = uint32_t(buildMeshlets);
+	header.meshletRecordCount = uint32_t(meshletRecordCount);
+	header.stringTableOffset = stringTableOffset;
+	header.stringTableSize = writer.GetStrings().size();
+	header.fileSize = writer.GetSize();
+
+	bytes = std::move(writer.GetBytes());
+	return true;
+}
+
+bool MeshCache::Parse(const uint8_t* data, size_t size) {
+	meshes_.clear();
+	lods_.clear();
+	materials_.clear();
+
+	if (size < sizeof(Header)) {
+		return false;
+	}
+	const Header& header = *reinterpret_cast<const Header*>(data);
+	if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+	    header.fileSize != size) {
+		return false;
+	}
+	const size_t materialsOffset =
+	    sizeof(Header) + sizeof(SourceRecord) * size_t(header.sourceCount);
+	const size_t meshesOffset =
+	    materialsOffset + sizeof(MaterialRecord) * size_t(header.materialCount);
+	const size_t lodsOffset = meshesOffset + sizeof(MeshRecord) * size_t(header.meshCount);
+	const size_t meshletsOffset = lodsOffset + sizeof(LodRecord) * size_t(header.lodRecordCount);
+	const size_t recordsEnd = meshletsOffset + sizeof(Meshlet) * size_t(header.meshletRecordCount);
+	if (size < recordsEnd || header.stringTableOffset < recordsEnd ||
+	    size < header.stringTableOffset + header.stringTableSize) {
+		return false;
+	}
+
+	const char* strings = reinterpret_cast<const char*>(data + header.stringTableOffset);
+	bool isValid = true;
+	auto getString = [&](const StringRef& ref) {
+		if (header.stringTableSize < uint64_t(ref.offset) + ref.length) {
+			isValid = false;
+			return std::string_view();
+		}
+		return std::string_view(strings + ref.offset, ref.length);
+	};
+
+	const MaterialRecord* materialRecords =
+	    reinterpret_cast<const MaterialRecord*>(data + materialsOffset);
+	materials_.resize(header.materialCount);
+	for (uint32_t i = 0; i < header.materialCount; i++) {
+		const MaterialRecord& record = materialRecords[i];
+		MaterialData& material = materials_[i];
+		material.name = getString(record.name);
+		material.textureFilename = getString(record.textureFilename);
+		material.ambient = record.ambient;
+		material.diffuse = record.diffuse;
+		material.specular = record.specular;
+		material.alpha = record.alpha;
+	}
+
+	const LodRecord* lodRecords = reinterpret_cast<const LodRecord*>(data + lodsOffset);
+	lods_.resize(header.lodRecordCount);
+	for (uint32_t i = 0; i < header.lodRecordCount; i++) {
+		const LodRecord& record = lodRecords[i];
+		if (record.indexOffset % kBlobAlignment != 0) {
+			return false;
+		}
+		lods_[i].indices = data + record.indexOffset;
+		lods_[i].indexCount = record.indexCount;
+		lods_[i].error = record.error;
+	}
+
+	const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(data + meshletsOffset);
+	const MeshRecord* meshRecords = reinterpret_cast<const MeshRecord*>(data + meshesOffset);
+	meshes_.resize(header.meshCount);
+	size_t lodBegin = 0;
+	size_t meshletBegin = 0;
+	for (uint32_t i = 0; i < header.meshCount; i++) {
+		const MeshRecord& record = meshRecords[i];
+		const uint64_t vertexEnd =
+		    record.vertexOffset + uint64_t(sizeof(MeshVertex)) * record.vertexCount;
+		const uint64_t indexEnd = record.indexOffset + uint64_t(record.indexSize) * record.indexCount;
+		if ((record.indexSize != uint32_t(IndexFormat::kUInt16) &&
+		     record.indexSize != uint32_t(IndexFormat::kUInt32)) ||
+		    record.vertexOffset % kBlobAlignment != 0 || record.indexOffset % kBlobAlignment != 0 ||
+		    size < vertexEnd || size < indexEnd || lods_.size() - lodBegin < record.lodCount ||
+		    header.meshletRecordCount - meshletBegin < record.meshletCount) {
+			return false;
+		}
+		for (uint32_t lod = 0; lod < record.lodCount; lod++) {
+			const LodRecord& lodRecord = lodRecords[lodBegin + lod];
+			if (size < lodRecord.indexOffset + uint64_t(record.indexSize) * lodRecord.indexCount) {
+				return false;
+			}
+		}
+		for (uint32_t j = 0; j < record.meshletCount; j++) {
+			const Meshlet& meshlet = meshlets[meshletBegin + j];
+			if (record.indexCount < uint64_t(meshlet.firstIndex) + uint64_t(meshlet.triangleCount) * 3) {
+				return false;
+			}
+		}
+
+		MeshView& view = meshes_[i];
+		view.name = getString(record.name);
+		view.materialName = getString(record.materialName);
+		view.vertices = std::span<const MeshVertex>(
+		    reinterpret_cast<const MeshVertex*>(data + record.vertexOffset), record.vertexCount);
+		view.indices = data + record.indexOffset;
+		view.indexCount = record.indexCount;
+		view.indexFormat = IndexFormat(record.indexSize);
+		view.bounds = record.bounds;
+		view.lods = std::span<const LodView>(lods_.data() + lodBegin, record.lodCount);
+		lodBegin += record.lodCount;
+		view.meshlets = std::span<const Meshlet>(meshlets + meshletBegin, record.meshletCount);
+		meshletBegin += record.meshletCount;
+	}
+
+	if (!isValid) {
+		meshes_.clear();
+		lods_.clear();
+		materials_.clear();
+	}
+	return isValid;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "MeshData.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// OBJモデルのバイナリキャッシュ
+/// 読み込み済みの頂点・インデックスをGPUにそのまま送れる形で .meshcache に書き出し、
+/// 次回以降はファイルをメモリマップしてテキスト解析なしで参照する。
+/// 元の .obj / .mtl のサイズ・更新日時（一致しなければ内容のハッシュ）で鮮度を判定する。
+/// LODを要求した場合は簡略化したインデックスも、メッシュレットを要求した場合はその境界も一緒に保存する。
+/// Model（エンジンのライブラリ）は自前で .obj を読むのでこのキャッシュを通らない。
+/// 描画には MeshBuffer::Create(MeshView) でバッファを作る
+/// </summary>
+class MeshCache {
+public:
+	// インデックス形式（1要素あたりのバイト数）
+	enum class IndexFormat : uint32_t {
+		kUInt16 = 2,
+		kUInt32 = 4,
+	};
+
+	/// <summary>
+	/// マップ済みLODの参照（頂点と形式はメッシュと共通）
+	/// </summary>
+	struct LodView {
+		const void* indices = nullptr; // インデックスデータ
+		uint32_t indexCount = 0;       // インデックス数
+		float error = 0.0f;            // 元の形状からの誤差
+	};
+
+	/// <summary>
+	/// マップ済みメッシュの参照
+	/// </summary>
+	struct MeshView {
+		std::string_view name;                          // 名前
+		std::string_view materialName;                  // マテリアル名
+		std::span<const MeshVertex> vertices;           // 頂点データ
+		const void* indices = nullptr;                  // インデックスデータ
+		uint32_t indexCount = 0;                        // インデックス数
+		IndexFormat indexFormat = IndexFormat::kUInt32; // インデックス形式
+		AABB bounds{};                                  // 境界ボックス
+		std::span<const LodView> lods;                  // LOD1以降（詳細な順）
+		std::span<const Meshlet> meshlets;              // メッシュレット（LOD0のインデックスを区切る）
+
+		/// <summary>
+		/// インデックスデータのバイト数
+		/// </summary>
+		size_t GetIndexDataSize() const { return size_t(indexCount) * size_t(indexFormat); }
+
+		/// <summary>
+		/// i番目のインデックス
+		/// </summary>
+		uint32_t GetIndex(uint32_t i) const {
+			return indexFormat == IndexFormat::kUInt16 ? static_cast<const uint16_t*>(indices)[i]
+			                                           : static_cast<const uint32_t*>(indices)[i];
+		}
+	};
+
+	/// <summary>
+	/// キャッシュが新しければマップし、古いか無ければ .obj から作り直して書き出す
+	/// </summary>
+	/// <param name="objPath">.objファイルのパス</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="lodCount">生成するLODの数（LOD0を含まない）</param>
+	/// <param name="buildMeshlets">メッシュレットに分割するか</param>
+	/// <returns>成否</returns>
+	bool LoadOrBuild(
+	    const std::string& objPath, bool smoothing, uint32_t lodCount = 0, bool buildMeshlets = false);
+
+	/// <summary>
+	/// キャッシュファイルを開く（鮮度は判定しない）
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルのパス</param>
+	/// <returns>成否</returns>
+	bool Load(const std::string& cachePath);
+
+	/// <summary>
+	/// キャッシュファイルの書き出し
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルのパス</param>
+	/// <param name="objPath">元の.objファイルのパス（鮮度判定用）</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="lodCount">要求したLODの数（鮮度判定用）</param>
+	/// <param name="buildMeshlets">メッシュレットを要求したか（鮮度判定用）</param>
+	/// <param name="modelData">モデルデータ（LODは mesh.lods、メッシュレットは mesh.meshlets から書き出す）</param>
+	/// <returns>成否</returns>
+	static bool Write(
+	    const std::string& cachePath, const std::string& objPath, bool smoothing,
+	    uint32_t lodCount, bool buildMeshlets, const ModelData& modelData);
+
+	/// <summary>
+	/// キャッシュファイルが元ファイルより新しいか
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルのパス</param>
+	/// <param name="objPath">.objファイルのパス</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="lodCount">要求するLODの数</param>
+	/// <param name="buildMeshlets">メッシュレットを要求するか</param>
+	/// <returns>そのまま使えるか</returns>
+	static bool IsUpToDate(
+	    const std::string& cachePath, const std::string& objPath, bool smoothing,
+	    uint32_t lodCount = 0, bool buildMeshlets = false);
+
+	/// <summary>
+	/// .objに対応するキャッシュファイルのパス
+	/// </summary>
+	static std::string GetCachePath(const std::string& objPath, bool smoothing);
+
+	/// <summary>
+	/// 閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// モデルデータへの展開（コピー）
+	/// </summary>
+	/// <param name="modelData">出力先</param>
+	void ToModelData(ModelData& modelData) const;
+
+	const std::vector<MeshView>& GetMeshes() const { return meshes_; }
+	const std::vector<MaterialData>& GetMaterials() const { return materials_; }
+
+	/// <summary>
+	/// 直前のLoadOrBuildで作り直したか
+	/// </summary>
+	bool WasRebuilt() const { return wasRebuilt_; }
+
+private:
+	/// <summary>
+	/// キャッシュ内容の生成
+	/// </summary>
+	static bool Serialize(
+	    const std::string& objPath, bool smoothing, uint32_t lodCount, bool buildMeshlets,
+	    const ModelData& modelData, std::vector<uint8_t>& bytes);
+
+	/// <summary>
+	/// キャッシュ内容の解釈
+	/// </summary>
+	/// <param name="data">先頭アドレス</param>
+	/// <param name="size">バイト数</param>
+	/// <returns>成否</returns>
+	bool Parse(const uint8_t* data, size_t size);
+
+	// マップしたキャッシュファイル
+	MappedFile file_;
+	// 書き出しに失敗した場合のメモリ上のキャッシュ
+	std::vector<uint8_t> buffer_;
+	// メッシュ
+	std::vector<MeshView> meshes_;
+	// 全メッシュのLOD（MeshView::lods はこの一部を指す）
+	std::vector<LodView> lods_;
+	// マテリアル
+	std::vector<MaterialData> materials_;
+	// 作り直したか
+	bool wasRebuilt_ = false;
+};
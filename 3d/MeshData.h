@@ -0,0 +1,86 @@
+#pragma once
+
+#include "BoundingVolume.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 16bitインデックスで表せる頂点数の上限（三角形リストはストリップカット値を使わない）
+const size_t kMaxUInt16IndexVertexCount = 0x10000;
+
+/// <summary>
+/// 頂点データ（Mesh::VertexPosNormalUv と同じメモリ配置）
+/// </summary>
+struct MeshVertex {
+	Vector3 pos;    // xyz座標
+	Vector3 normal; // 法線ベクトル
+	Vector2 uv;     // uv座標
+};
+
+/// <summary>
+/// マテリアルデータ（.mtl の内容）
+/// </summary>
+struct MaterialData {
+	std::string name;                      // マテリアル名
+	Vector3 ambient = {0.3f, 0.3f, 0.3f};  // アンビエント影響度
+	Vector3 diffuse = {0.0f, 0.0f, 0.0f};  // ディフューズ影響度
+	Vector3 specular = {0.0f, 0.0f, 0.0f}; // スペキュラー影響度
+	float alpha = 1.0f;                    // アルファ
+	std::string textureFilename;           // テクスチャファイル名
+};
+
+// メッシュレットの頂点数・三角形数の上限の既定値
+const uint32_t kMeshletMaxVertexCount = 64;
+const uint32_t kMeshletMaxTriangleCount = 124;
+
+/// <summary>
+/// メッシュレット（LOD0のインデックスの連続した範囲と、その境界）
+/// </summary>
+struct Meshlet {
+	uint32_t firstIndex;    // MeshData::indices 内の先頭
+	uint32_t triangleCount; // 三角形数
+	uint32_t vertexCount;   // 参照している頂点の数
+	Sphere bounds;          // 境界球
+	Vector3 coneAxis;       // 面の向きの平均（正規化済み）
+	float coneCutoff;       // 面の向きの広がり（最大の傾きのsin。1なら裏向き判定をしない）
+};
+
+/// <summary>
+/// インデックスバッファ上の描画範囲
+/// </summary>
+struct IndexRange {
+	uint32_t firstIndex; // 先頭
+	uint32_t indexCount; // インデックス数
+};
+
+/// <summary>
+/// 詳細度を下げた形状（頂点はLOD0と共有する）
+/// </summary>
+struct MeshLod {
+	std::vector<uint32_t> indices; // 頂点インデックス配列
+	float error = 0.0f;            // 元の形状からの誤差（モデル座標系の距離）
+};
+
+/// <summary>
+/// メッシュデータ（GPUに依存しない形状データ）
+/// </summary>
+struct MeshData {
+	std::string name;                 // 名前
+	std::string materialName;         // マテリアル名
+	std::vector<MeshVertex> vertices; // 頂点データ配列
+	std::vector<uint32_t> indices;    // 頂点インデックス配列
+	AABB bounds{};                    // 境界ボックス
+	std::vector<MeshLod> lods;        // LOD1以降（詳細な順）
+	std::vector<Meshlet> meshlets;    // メッシュレット（LOD0のインデックスを先頭から区切る）
+};
+
+/// <summary>
+/// モデルデータ（メッシュとマテリアルの集まり）
+/// </summary>
+struct ModelData {
+	std::vector<MeshData> meshes;               // メッシュ
+	std::vector<MaterialData> materials;        // マテリアル
+	std::vector<std::string> materialLibraries; // 参照している.mtlファイル名
+};
@@ -0,0 +1,351 @@
+#include "MeshOptimizer.h"
+#include "MathUtility.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// クラスタとして分ける最小の三角形数
+const size_t kMinClusterSize = 16;
+// オーバードロー向けの並べ替えを試す回数
+const int kOverdrawAttemptCount = 3;
+
+/// <summary>
+/// FIFO頂点キャッシュの模擬
+/// </summary>
+class CacheSimulator {
+public:
+	CacheSimulator(size_t vertexCount, uint32_t cacheSize)
+	    : timestamps_(vertexCount, 0), cacheSize_(cacheSize), time_(cacheSize + 1) {}
+
+	// 頂点を参照し、ミスならtrue
+	bool Access(uint32_t vertex) {
+		if (time_ - timestamps_[vertex] > cacheSize_) {
+			timestamps_[vertex] = time_++;
+			return true;
+		}
+		return false;
+	}
+
+	// キャッシュを空にする
+	void Reset() { time_ += cacheSize_ + 1; }
+
+private:
+	std::vector<uint32_t> timestamps_;
+	uint32_t cacheSize_;
+	uint32_t time_;
+};
+
+/// <summary>
+/// 頂点→三角形の隣接情報（CSR）
+/// </summary>
+struct TriangleAdjacency {
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> triangles;
+
+	TriangleAdjacency(const std::vector<uint32_t>& indices, size_t vertexCount)
+	    : offsets(vertexCount + 1, 0), triangles(indices.size()) {
+		for (uint32_t index : indices) {
+			offsets[index + 1]++;
+		}
+		for (size_t i = 0; i < vertexCount; i++) {
+			offsets[i + 1] += offsets[i];
+		}
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			triangles[cursors[indices[i]]++] = uint32_t(i / 3);
+		}
+	}
+};
+
+/// <summary>
+/// クラスタを細かく分け、外側を向いた順に並べたインデックスを作る
+/// </summary>
+std::vector<uint32_t> SortClustersOutward(
+    const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+    const std::vector<uint32_t>& clusterOffsets, uint32_t cacheSize, float threshold) {
+	const size_t triangleCount = indices.size() / 3;
+
+	// 行き止まりのクラスタを、キャッシュ効率が落ちすぎない範囲でさらに細かく分ける
+	CacheSimulator cache(vertices.size(), cacheSize);
+	auto countMisses = [&](size_t triangle) {
+		size_t misses = 0;
+		for (size_t corner = 0; corner < 3; corner++) {
+			misses += cache.Access(indices[triangle * 3 + corner]);
+		}
+		return misses;
+	};
+	std::vector<size_t> clusters;
+	for (size_t i = 0; i < clusterOffsets.size(); i++) {
+		const size_t begin = clusterOffsets[i];
+		const size_t end = i + 1 < clusterOffsets.size() ? clusterOffsets[i + 1] : triangleCount;
+
+		cache.Reset();
+		size_t clusterMisses = 0;
+		for (size_t triangle = begin; triangle < end; triangle++) {
+			clusterMisses += countMisses(triangle);
+		}
+		const float limit = threshold * float(clusterMisses) / float(end - begin);
+
+		cache.Reset();
+		clusters.push_back(begin);
+		size_t start = begin;
+		size_t misses = 0;
+		for (size_t triangle = begin; triangle < end; triangle++) {
+			misses += countMisses(triangle);
+			const size_t size = triangle + 1 - start;
+			if (kMinClusterSize <= size && triangle + 1 < end &&
+			    float(misses) <= limit * float(size)) {
+				start = triangle + 1;
+				misses = 0;
+				clusters.push_back(start);
+				cache.Reset();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// メッシュ全体の中心（面積重み）
+	Vector3 meshCenter = {0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+	std::vector<Vector3> clusterCenters(clusters.size() - 1);
+	std::vector<Vector3> clusterNormals(clusters.size() - 1);
+	for (size_t i = 0; i + 1 < clusters.size(); i++) {
+		Vector3 center = {0.0f, 0.0f, 0.0f};
+		Vector3 normal = {0.0f, 0.0f, 0.0f};
+		float area = 0.0f;
+		for (size_t triangle = clusters[i]; triangle < clusters[i + 1]; triangle++) {
+			const Vector3& p0 = vertices[indices[triangle * 3 + 0]].pos;
+			const Vector3& p1 = vertices[indices[triangle * 3 + 1]].pos;
+			const Vector3& p2 = vertices[indices[triangle * 3 + 2]].pos;
+			// 長さは面積の2倍
+			const Vector3 cross = Cross(p1 - p0, p2 - p0);
+			const float triangleArea = Length(cross);
+			center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+			normal += cross;
+			area += triangleArea;
+		}
+		meshCenter += center;
+		meshArea += area;
+		clusterCenters[i] = 0.0f < area ? center * (1.0f / area) : vertices[indices[clusters[i] * 3]].pos;
+		clusterNormals[i] = normal;
+	}
+	if (0.0f < meshArea) {
+		meshCenter = meshCenter * (1.0f / meshArea);
+	}
+
+	// 外側を向いたクラスタほど手前を覆いやすいので先に描く
+	std::vector<float> sortKeys(clusterCenters.size());
+	std::vector<uint32_t> order(clusterCenters.size());
+	for (size_t i = 0; i < clusterCenters.size(); i++) {
+		const float normalLength = Length(clusterNormals[i]);
+		sortKeys[i] = 0.0f < normalLength
+		                  ? Dot(clusterCenters[i] - meshCenter, clusterNormals[i]) / normalLength
+		                  : 0.0f;
+		order[i] = uint32_t(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t lhs, uint32_t rhs) {
+		return sortKeys[lhs] > sortKeys[rhs];
+	});
+
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	for (uint32_t cluster : order) {
+		result.insert(
+		    result.end(), indices.begin() + ptrdiff_t(clusters[cluster] * 3),
+		    indices.begin() + ptrdiff_t(clusters[cluster + 1] * 3));
+	}
+	return result;
+}
+
+} // namespace
+
+void MeshOptimizer::Optimize(MeshData& mesh, const Options& options, Report* report) {
+	if (report) {
+		report->before = AnalyzeVertexCache(
+		    mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), options.cacheSize);
+	}
+
+	std::vector<uint32_t> clusterOffsets;
+	OptimizeVertexCache(
+	    mesh.indices, mesh.vertices.size(), options.cacheSize,
+	    options.optimizeOverdraw ? &clusterOffsets : nullptr);
+	if (options.optimizeOverdraw) {
+		OptimizeOverdraw(
+		    mesh.indices, mesh.vertices, clusterOffsets, options.cacheSize,
+		    options.overdrawThreshold);
+	}
+	OptimizeVertexFetch(mesh);
+
+	if (report) {
+		report->after = AnalyzeVertexCache(
+		    mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), options.cacheSize);
+	}
+}
+
+void MeshOptimizer::OptimizeVertexCache(
+    std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize,
+    std::vector<uint32_t>* clusterOffsets) {
+	assert(indices.size() % 3 == 0);
+	const size_t triangleCount = indices.size() / 3;
+	if (clusterOffsets) {
+		clusterOffsets->clear();
+	}
+	if (triangleCount == 0) {
+		return;
+	}
+
+	const TriangleAdjacency adjacency(indices, vertexCount);
+	// 未出力の三角形の数
+	std::vector<uint32_t> liveCounts(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		liveCounts[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+	}
+	// キャッシュに入った時刻
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = cacheSize + 1;
+	std::vector<uint8_t> isEmitted(triangleCount, 0);
+	// 行き止まりで戻るための出力済み頂点
+	std::vector<uint32_t> deadEndStack;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> result;
+	result.reserve(indices.size());
+	size_t cursor = 0;
+
+	// 行き止まりのとき、最近出力した頂点か先頭から順に残りのある頂点を探す
+	auto skipDeadEnd = [&]() -> int64_t {
+		while (!deadEndStack.empty()) {
+			uint32_t vertex = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (liveCounts[vertex] != 0) {
+				return vertex;
+			}
+		}
+		for (; cursor < vertexCount; cursor++) {
+			if (liveCounts[cursor] != 0) {
+				return int64_t(cursor);
+			}
+		}
+		return -1;
+	};
+
+	int64_t fanning = skipDeadEnd();
+	while (0 <= fanning) {
+		// 扇の中心に隣接する三角形を全て出力する
+		candidates.clear();
+		const uint32_t vertex = uint32_t(fanning);
+		for (uint32_t i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1]; i++) {
+			const uint32_t triangle = adjacency.triangles[i];
+			if (isEmitted[triangle]) {
+				continue;
+			}
+			for (size_t corner = 0; corner < 3; corner++) {
+				const uint32_t index = indices[triangle * 3 + corner];
+				result.push_back(index);
+				deadEndStack.push_back(index);
+				candidates.push_back(index);
+				liveCounts[index]--;
+				if (cacheSize < time - timestamps[index]) {
+					timestamps[index] = time++;
+				}
+			}
+			isEmitted[triangle] = 1;
+		}
+
+		// 次の中心は、残りの三角形を出力し終えるまでキャッシュに残っている中で最も古い頂点
+		int64_t next = -1;
+		int64_t bestPriority = -1;
+		for (uint32_t candidate : candidates) {
+			if (liveCounts[candidate] == 0) {
+				continue;
+			}
+			int64_t priority = 0;
+			const int64_t age = int64_t(time) - int64_t(timestamps[candidate]);
+			if (age + 2 * int64_t(liveCounts[candidate]) <= int64_t(cacheSize)) {
+				priority = age;
+			}
+			if (bestPriority < priority) {
+				bestPriority = priority;
+				next = candidate;
+			}
+		}
+		if (next < 0) {
+			next = skipDeadEnd();
+			if (clusterOffsets && 0 <= next) {
+				clusterOffsets->push_back(uint32_t(result.size() / 3));
+			}
+		}
+		fanning = next;
+	}
+
+	if (clusterOffsets) {
+		clusterOffsets->insert(clusterOffsets->begin(), 0);
+	}
+	indices = std::move(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(
+    std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+    const std::vector<uint32_t>& clusterOffsets, uint32_t cacheSize, float threshold) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 分割は空のキャッシュで数えるので、末尾の端数や前後のクラスタとの共有の変化で全体の悪化率を超えることがある。
+	// 超えたら分割を粗くしてやり直し、それでも超えるなら元の順のままにする
+	const float limit =
+	    threshold *
+	    float(AnalyzeVertexCache(indices.data(), indices.size(), vertices.size(), cacheSize)
+	              .vertexTransformCount);
+	float splitThreshold = threshold;
+	for (int attempt = 0; attempt < kOverdrawAttemptCount; attempt++) {
+		std::vector<uint32_t> result =
+		    SortClustersOutward(indices, vertices, clusterOffsets, cacheSize, splitThreshold);
+		const size_t misses =
+		    AnalyzeVertexCache(result.data(), result.size(), vertices.size(), cacheSize)
+		        .vertexTransformCount;
+		if (float(misses) <= limit) {
+			indices = std::move(result);
+			return;
+		}
+		splitThreshold = 1.0f + (splitThreshold - 1.0f) * 0.5f;
+	}
+}
+
+void MeshOptimizer::OptimizeVertexFetch(MeshData& mesh) {
+	static const uint32_t kUnused = UINT32_MAX;
+	std::vector<uint32_t> remap(mesh.vertices.size(), kUnused);
+	std::vector<MeshVertex> vertices;
+	vertices.reserve(mesh.vertices.size());
+	for (uint32_t& index : mesh.indices) {
+		if (remap[index] == kUnused) {
+			remap[index] = uint32_t(vertices.size());
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+	mesh.vertices = std::move(vertices);
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(
+    const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	CacheStatistics statistics;
+	// 三角形が無いと三角形あたりの回数が求まらない
+	if (indexCount < 3 || vertexCount == 0) {
+		return statistics;
+	}
+
+	CacheSimulator cache(vertexCount, cacheSize);
+	std::vector<uint8_t> isUsed(vertexCount, 0);
+	size_t usedCount = 0;
+	for (size_t i = 0; i < indexCount; i++) {
+		statistics.vertexTransformCount += cache.Access(indices[i]);
+		usedCount += !isUsed[indices[i]];
+		isUsed[indices[i]] = 1;
+	}
+	statistics.acmr = float(statistics.vertexTransformCount) / float(indexCount / 3);
+	statistics.atvr = float(statistics.vertexTransformCount) / float(usedCount);
+	return statistics;
+}
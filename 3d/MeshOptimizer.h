@@ -0,0 +1,104 @@
+#pragma once
+
+#include "MeshData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// メッシュの描画順最適化
+/// 頂点キャッシュ（Tipsify）、オーバードロー（クラスタの外向き順ソート）、頂点フェッチ（初出順の並べ替え）の順に適用する
+/// </summary>
+class MeshOptimizer {
+public:
+	// 頂点キャッシュのエントリ数（FIFOとして評価する）
+	static const uint32_t kDefaultCacheSize = 16;
+
+	/// <summary>
+	/// 頂点キャッシュの評価結果
+	/// </summary>
+	struct CacheStatistics {
+		size_t vertexTransformCount = 0; // 頂点シェーダ実行回数（キャッシュミス数）
+		float acmr = 0.0f;               // 三角形あたりの実行回数（0.5〜3）
+		float atvr = 0.0f;               // 頂点あたりの実行回数（1が最良）
+	};
+
+	/// <summary>
+	/// 最適化の設定
+	/// </summary>
+	struct Options {
+		uint32_t cacheSize = kDefaultCacheSize; // 頂点キャッシュのエントリ数
+		bool optimizeOverdraw = true;           // オーバードロー向けの並べ替えをするか
+		float overdrawThreshold = 1.05f;        // 許容するACMRの悪化率
+	};
+
+	/// <summary>
+	/// 最適化の前後の評価
+	/// </summary>
+	struct Report {
+		CacheStatistics before; // 最適化前
+		CacheStatistics after;  // 最適化後
+	};
+
+	/// <summary>
+	/// メッシュに全ての最適化を適用する
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="options">設定</param>
+	/// <param name="report">前後の評価（nullptrなら評価しない）</param>
+	static void Optimize(MeshData& mesh, const Options& options, Report* report = nullptr);
+
+	/// <summary>
+	/// メッシュに既定の設定で全ての最適化を適用する
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="report">前後の評価（nullptrなら評価しない）</param>
+	static void Optimize(MeshData& mesh, Report* report = nullptr) {
+		Optimize(mesh, Options(), report);
+	}
+
+	/// <summary>
+	/// 頂点キャッシュ向けに三角形を並べ替える（Tipsify）
+	/// </summary>
+	/// <param name="indices">インデックス（三角形リスト）</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="cacheSize">頂点キャッシュのエントリ数</param>
+	/// <param name="clusterOffsets">行き止まりで区切ったクラスタの先頭三角形（nullptrなら出力しない）</param>
+	static void OptimizeVertexCache(
+	    std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize = kDefaultCacheSize,
+	    std::vector<uint32_t>* clusterOffsets = nullptr);
+
+	/// <summary>
+	/// オーバードローを減らすようにクラスタ単位で並べ替える
+	/// OptimizeVertexCache の出力に対して使い、全体のACMRの悪化を threshold 倍までに抑える
+	/// （分割を粗くしても収まらなければ並べ替えない）
+	/// </summary>
+	/// <param name="indices">インデックス（三角形リスト）</param>
+	/// <param name="vertices">頂点</param>
+	/// <param name="clusterOffsets">OptimizeVertexCache が出力したクラスタの先頭三角形</param>
+	/// <param name="cacheSize">頂点キャッシュのエントリ数</param>
+	/// <param name="threshold">許容するACMRの悪化率</param>
+	static void OptimizeOverdraw(
+	    std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+	    const std::vector<uint32_t>& clusterOffsets, uint32_t cacheSize = kDefaultCacheSize,
+	    float threshold = 1.05f);
+
+	/// <summary>
+	/// インデックスの初出順に頂点を並べ替え、使われていない頂点を取り除く
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	static void OptimizeVertexFetch(MeshData& mesh);
+
+	/// <summary>
+	/// 頂点キャッシュの評価（FIFO）
+	/// 三角形が1つも無ければ全て0を返す
+	/// </summary>
+	/// <param name="indices">インデックス</param>
+	/// <param name="indexCount">インデックス数</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="cacheSize">頂点キャッシュのエントリ数</param>
+	/// <returns>評価結果</returns>
+	static CacheStatistics AnalyzeVertexCache(
+	    const uint32_t* indices, size_t indexCount, size_t vertexCount,
+	    uint32_t cacheSize = kDefaultCacheSize);
+};
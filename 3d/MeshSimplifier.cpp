@@ -0,0 +1,540 @@
+#include "MeshSimplifier.h"
+#include "MathUtility.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+
+namespace {
+
+// 境界辺を保つための拘束の重み
+const double kBorderWeight = 10.0;
+// 頂点属性（法線・UV）の不連続に対する誤差の重み（形状の大きさの2乗に掛ける）
+const double kAttributeWeight = 0.01;
+// 面の向きがこれ以上変わる縮約は行わない（法線の内積）
+const double kFlipThreshold = 0.25;
+// LODとして採用する最小の削減率（これより減らなければ打ち切る）
+const float kMinLodReduction = 0.95f;
+// 縮約先がないことを示す値
+const uint32_t kNone = UINT32_MAX;
+// 縮約候補の評価を並列化する単位（座標数）
+const size_t kCandidateGrainSize = 4096;
+
+/// <summary>
+/// 二次誤差（平面からの距離の2乗和）
+/// </summary>
+struct Quadric {
+	double a2 = 0, b2 = 0, c2 = 0, ab = 0, ac = 0, bc = 0, ad = 0, bd = 0, cd = 0, d2 = 0;
+
+	// 平面 ax + by + cz + d = 0 を重み付きで加える
+	void AddPlane(double a, double b, double c, double d, double weight) {
+		a2 += weight * a * a;
+		b2 += weight * b * b;
+		c2 += weight * c * c;
+		ab += weight * a * b;
+		ac += weight * a * c;
+		bc += weight * b * c;
+		ad += weight * a * d;
+		bd += weight * b * d;
+		cd += weight * c * d;
+		d2 += weight * d * d;
+	}
+
+	void operator+=(const Quadric& other) {
+		a2 += other.a2;
+		b2 += other.b2;
+		c2 += other.c2;
+		ab += other.ab;
+		ac += other.ac;
+		bc += other.bc;
+		ad += other.ad;
+		bd += other.bd;
+		cd += other.cd;
+		d2 += other.d2;
+	}
+
+	double Evaluate(const Vector3& p) const {
+		const double x = p.x;
+		const double y = p.y;
+		const double z = p.z;
+		const double result = a2 * x * x + b2 * y * y + c2 * z * z + 2 * (ab * x * y + ac * x * z + bc * y * z) +
+		                      2 * (ad * x + bd * y + cd * z) + d2;
+		return (std::max)(result, 0.0);
+	}
+};
+
+uint64_t MakeEdgeKey(uint32_t a, uint32_t b) {
+	return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+// 頂点属性の差（0で同じ）
+double AttributeDistance(const MeshVertex& a, const MeshVertex& b) {
+	const double normal = 1.0 - double(Dot(a.normal, b.normal));
+	const double du = double(a.uv.x) - double(b.uv.x);
+	const double dv = double(a.uv.y) - double(b.uv.y);
+	return (std::max)(normal, 0.0) + du * du + dv * dv;
+}
+
+/// <summary>
+/// 簡略化の作業領域
+/// </summary>
+class Simplifier {
+public:
+	Simplifier(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices)
+	    : vertices_(vertices), indices_(indices) {
+		WeldPositions();
+		ClassifyEdges();
+		ComputeQuadrics();
+	}
+
+	/// <summary>
+	/// 目標のインデックス数まで縮約を進める
+	/// 続けて呼ぶと前回の結果からさらに簡略化する
+	/// </summary>
+	/// <returns>現在のインデックス</returns>
+	const std::vector<uint32_t>& Run(size_t targetIndexCount, double maxError) {
+		const double maxCostLimit = maxError * maxError;
+		while (targetIndexCount < indices_.size()) {
+			BuildAdjacency();
+			const size_t targetTriangleRemoval = (indices_.size() - targetIndexCount) / 3;
+			if (!CollapsePass(targetTriangleRemoval, maxCostLimit)) {
+				break;
+			}
+			ApplyCollapses();
+		}
+		return indices_;
+	}
+
+	/// <summary>
+	/// これまでの縮約での最大の誤差（距離）
+	/// </summary>
+	float GetError() const { return float(std::sqrt(maxCost_)); }
+
+private:
+	// 同じ座標の頂点に同じ番号を振る
+	void WeldPositions() {
+		const size_t vertexCount = vertices_.size();
+		positionIds_.resize(vertexCount);
+
+		// 座標のビット列で並べ替えて、等しい並びに同じ番号を振る
+		std::vector<std::array<uint32_t, 3>> keys(vertexCount);
+		std::vector<uint32_t> order(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++) {
+			std::memcpy(keys[i].data(), &vertices_[i].pos, sizeof(keys[i]));
+			// -0 と +0 は同じ座標として扱う
+			for (uint32_t& bits : keys[i]) {
+				bits = bits == 0x80000000u ? 0u : bits;
+			}
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&keys](uint32_t lhs, uint32_t rhs) {
+			return keys[lhs] < keys[rhs];
+		});
+		for (size_t i = 0; i < vertexCount; i++) {
+			if (i == 0 || keys[order[i - 1]] != keys[order[i]]) {
+				positions_.push_back(vertices_[order[i]].pos);
+			}
+			positionIds_[order[i]] = uint32_t(positions_.size() - 1);
+		}
+
+		// 座標ごとの頂点一覧（CSR）
+		const size_t positionCount = positions_.size();
+		wedgeOffsets_.assign(positionCount + 1, 0);
+		for (uint32_t id : positionIds_) {
+			wedgeOffsets_[id + 1]++;
+		}
+		for (size_t i = 0; i < positionCount; i++) {
+			wedgeOffsets_[i + 1] += wedgeOffsets_[i];
+		}
+		wedges_.resize(vertexCount);
+		std::vector<uint32_t> cursors(wedgeOffsets_.begin(), wedgeOffsets_.end() - 1);
+		for (uint32_t i = 0; i < vertexCount; i++) {
+			wedges_[cursors[positionIds_[i]]++] = i;
+		}
+
+		const AABB bounds = ComputeAABB(vertices_.data(), vertexCount, sizeof(MeshVertex));
+		const Vector3 extent = bounds.max - bounds.min;
+		attributeScale_ = kAttributeWeight * double(Dot(extent, extent));
+	}
+
+	// 辺を共有する三角形の数から境界と非多様体を調べる
+	void ClassifyEdges() {
+		std::vector<uint64_t> edges;
+		edges.reserve(indices_.size());
+		for (size_t i = 0; i < indices_.size(); i += 3) {
+			for (size_t corner = 0; corner < 3; corner++) {
+				uint32_t a = positionIds_[indices_[i + corner]];
+				uint32_t b = positionIds_[indices_[i + (corner + 1) % 3]];
+				if (a != b) {
+					edges.push_back(MakeEdgeKey(a, b));
+				}
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+
+		borderEdges_.reserve(edges.size() / 8);
+		kinds_.assign(positions_.size(), kManifold);
+		for (size_t i = 0; i < edges.size();) {
+			size_t j = i + 1;
+			while (j < edges.size() && edges[j] == edges[i]) {
+				j++;
+			}
+			const uint32_t a = uint32_t(edges[i] >> 32);
+			const uint32_t b = uint32_t(edges[i]);
+			if (j - i == 1) {
+				borderEdges_.insert(edges[i]);
+				kinds_[a] = (std::max)(kinds_[a], kBorder);
+				kinds_[b] = (std::max)(kinds_[b], kBorder);
+			} else if (2 < j - i) {
+				kinds_[a] = kLocked;
+				kinds_[b] = kLocked;
+			}
+			i = j;
+		}
+	}
+
+	bool IsBorderEdge(uint32_t a, uint32_t b) const {
+		return borderEdges_.contains(MakeEdgeKey(a, b));
+	}
+
+	// 面の平面と境界辺の拘束から二次誤差を求める
+	void ComputeQuadrics() {
+		quadrics_.assign(positions_.size(), Quadric{});
+		for (size_t i = 0; i < indices_.size(); i += 3) {
+			const uint32_t ids[3] = {
+			    positionIds_[indices_[i]], positionIds_[indices_[i + 1]],
+			    positionIds_[indices_[i + 2]]};
+			const Vector3& p0 = positions_[ids[0]];
+			const Vector3 normal = Cross(positions_[ids[1]] - p0, positions_[ids[2]] - p0);
+			const double length = double(Length(normal));
+			if (length == 0.0) {
+				continue;
+			}
+			// 面積で重み付けする
+			const double a = normal.x / length;
+			const double b = normal.y / length;
+			const double c = normal.z / length;
+			const double d = -(a * p0.x + b * p0.y + c * p0.z);
+			for (uint32_t id : ids) {
+				quadrics_[id].AddPlane(a, b, c, d, length * 0.5);
+			}
+
+			// 境界辺には面に垂直な平面を加えて輪郭が崩れないようにする
+			for (size_t corner = 0; corner < 3; corner++) {
+				const uint32_t e0 = ids[corner];
+				const uint32_t e1 = ids[(corner + 1) % 3];
+				if (kinds_[e0] == kManifold || kinds_[e1] == kManifold || !IsBorderEdge(e0, e1)) {
+					continue;
+				}
+				const Vector3 edge = positions_[e1] - positions_[e0];
+				const Vector3 perpendicular = Cross(edge, normal);
+				const double perpendicularLength = double(Length(perpendicular));
+				if (perpendicularLength == 0.0) {
+					continue;
+				}
+				const double pa = perpendicular.x / perpendicularLength;
+				const double pb = perpendicular.y / perpendicularLength;
+				const double pc = perpendicular.z / perpendicularLength;
+				const Vector3& q = positions_[e0];
+				const double pd = -(pa * q.x + pb * q.y + pc * q.z);
+				const double weight = kBorderWeight * double(Dot(edge, edge));
+				quadrics_[e0].AddPlane(pa, pb, pc, pd, weight);
+				quadrics_[e1].AddPlane(pa, pb, pc, pd, weight);
+			}
+		}
+	}
+
+	// 座標 → 三角形 の隣接情報（CSR）
+	void BuildAdjacency() {
+		const size_t positionCount = positions_.size();
+		triangleOffsets_.assign(positionCount + 1, 0);
+		for (uint32_t index : indices_) {
+			triangleOffsets_[positionIds_[index] + 1]++;
+		}
+		for (size_t i = 0; i < positionCount; i++) {
+			triangleOffsets_[i + 1] += triangleOffsets_[i];
+		}
+		triangles_.resize(indices_.size());
+		std::vector<uint32_t> cursors(triangleOffsets_.begin(), triangleOffsets_.end() - 1);
+		for (size_t i = 0; i < indices_.size(); i++) {
+			triangles_[cursors[positionIds_[indices_[i]]]++] = uint32_t(i / 3);
+		}
+	}
+
+	// 縮約 source → target の頂点ごとの付け替え先と属性の誤差
+	// remap が nullptr でなければ付け替え先を書き込む
+	double MapWedges(uint32_t source, uint32_t target, std::vector<uint32_t>* remap) const {
+		double cost = 0.0;
+		for (uint32_t i = wedgeOffsets_[source]; i < wedgeOffsets_[source + 1]; i++) {
+			const uint32_t wedge = wedges_[i];
+			double best = DBL_MAX;
+			uint32_t bestWedge = kNone;
+			for (uint32_t j = wedgeOffsets_[target]; j < wedgeOffsets_[target + 1]; j++) {
+				const double distance = AttributeDistance(vertices_[wedge], vertices_[wedges_[j]]);
+				if (distance < best) {
+					best = distance;
+					bestWedge = wedges_[j];
+				}
+			}
+			cost += best;
+			if (remap) {
+				(*remap)[wedge] = bestWedge;
+			}
+		}
+		return cost * attributeScale_;
+	}
+
+	// 縮約の可否（境界・固定の頂点の規則）
+	bool CanCollapse(uint32_t source, uint32_t target) const {
+		switch (kinds_[source]) {
+		case kManifold:
+			return true;
+		case kBorder:
+			// 境界の頂点は境界辺に沿ってのみ動かす
+			return kinds_[target] != kManifold && IsBorderEdge(source, target);
+		default:
+			return false;
+		}
+	}
+
+	// source を target の位置へ動かしたときに裏返る面があるか
+	bool HasFlip(uint32_t source, uint32_t target) const {
+		const Vector3& moved = positions_[target];
+		for (uint32_t i = triangleOffsets_[source]; i < triangleOffsets_[source + 1]; i++) {
+			const uint32_t triangle = triangles_[i];
+			uint32_t ids[3];
+			for (size_t corner = 0; corner < 3; corner++) {
+				ids[corner] = positionIds_[indices_[triangle * 3 + corner]];
+			}
+			// target を含む面は消える
+			if (ids[0] == target || ids[1] == target || ids[2] == target) {
+				continue;
+			}
+			const Vector3& p0 = positions_[ids[0]];
+			const Vector3& p1 = positions_[ids[1]];
+			const Vector3& p2 = positions_[ids[2]];
+			const Vector3 before = Cross(p1 - p0, p2 - p0);
+			const Vector3 q0 = ids[0] == source ? moved : p0;
+			const Vector3 q1 = ids[1] == source ? moved : p1;
+			const Vector3 q2 = ids[2] == source ? moved : p2;
+			const Vector3 after = Cross(q1 - q0, q2 - q0);
+			const double lengths = double(Length(before)) * double(Length(after));
+			if (double(Dot(before, after)) <= kFlipThreshold * lengths) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// source の境界辺を target に付け替える
+	void MoveBorderEdges(uint32_t source, uint32_t target) {
+		for (uint32_t i = triangleOffsets_[source]; i < triangleOffsets_[source + 1]; i++) {
+			const uint32_t triangle = triangles_[i];
+			for (size_t corner = 0; corner < 3; corner++) {
+				const uint32_t other = positionIds_[indices_[triangle * 3 + corner]];
+				if (other == source || other == target) {
+					continue;
+				}
+				if (borderEdges_.erase(MakeEdgeKey(source, other)) != 0) {
+					borderEdges_.insert(MakeEdgeKey(target, other));
+				}
+			}
+		}
+		borderEdges_.erase(MakeEdgeKey(source, target));
+	}
+
+	// 重ならない縮約をコストの低い順にまとめて選ぶ
+	bool CollapsePass(size_t targetTriangleRemoval, double maxCostLimit) {
+		const size_t positionCount = positions_.size();
+		if (costs_.empty()) {
+			costs_.assign(positionCount, DBL_MAX);
+			targets_.assign(positionCount, kNone);
+			isDirty_.assign(positionCount, 1);
+		}
+		// 座標ごとに周囲の辺から最もコストの低い縮約先を選ぶ（書き込みは自分の要素だけ）
+		// 前回のパスで周囲が変わらなかった座標は結果をそのまま使う
+		ThreadPool::GetInstance()->ParallelFor(
+		    positionCount, kCandidateGrainSize, [&](size_t begin, size_t end) {
+			    for (uint32_t source = uint32_t(begin); source < end; source++) {
+				    if (!isDirty_[source]) {
+					    continue;
+				    }
+				    double bestCost = DBL_MAX;
+				    uint32_t bestTarget = kNone;
+				    // 内部の頂点は各辺が次の頂点として一度ずつ現れる。境界では前の頂点も調べる
+				    const bool isBorder = kinds_[source] == kBorder;
+				    for (uint32_t i = triangleOffsets_[source]; i < triangleOffsets_[source + 1]; i++) {
+					    const uint32_t* triangle = &indices_[size_t(triangles_[i]) * 3];
+					    size_t corner = 0;
+					    while (positionIds_[triangle[corner]] != source) {
+						    corner++;
+					    }
+					    for (size_t offset = 1; offset < (isBorder ? 3u : 2u); offset++) {
+						    const uint32_t target = positionIds_[triangle[(corner + offset) % 3]];
+						    if (target == source || !CanCollapse(source, target)) {
+							    continue;
+						    }
+						    const double cost = quadrics_[source].Evaluate(positions_[target]) +
+						                        MapWedges(source, target, nullptr);
+						    if (cost < bestCost) {
+							    bestCost = cost;
+							    bestTarget = target;
+						    }
+					    }
+				    }
+				    costs_[source] = bestCost;
+				    targets_[source] = bestTarget;
+			    }
+		    });
+
+		// コストの昇順に並べる（非負の浮動小数点数はビット列の順序が値の順序と一致する）
+		std::vector<uint64_t> order;
+		for (uint32_t i = 0; i < positionCount; i++) {
+			if (targets_[i] != kNone && costs_[i] <= maxCostLimit) {
+				const float cost = float(costs_[i]);
+				uint32_t bits;
+				std::memcpy(&bits, &cost, sizeof(bits));
+				order.push_back((uint64_t(bits) << 32) | i);
+			}
+		}
+		std::sort(order.begin(), order.end());
+
+		// 動かした頂点の周囲は同じパスでは触らず、次のパスで評価し直す
+		std::fill(isDirty_.begin(), isDirty_.end(), uint8_t(0));
+		wedgeRemap_.resize(vertices_.size());
+		for (uint32_t i = 0; i < vertices_.size(); i++) {
+			wedgeRemap_[i] = i;
+		}
+		size_t removed = 0;
+		size_t collapseCount = 0;
+		for (uint64_t entry : order) {
+			const uint32_t source = uint32_t(entry);
+			const uint32_t target = targets_[source];
+			if (isDirty_[source] || isDirty_[target] || HasFlip(source, target)) {
+				continue;
+			}
+			quadrics_[target] += quadrics_[source];
+			if (kinds_[source] == kBorder) {
+				MoveBorderEdges(source, target);
+			}
+			MapWedges(source, target, &wedgeRemap_);
+			maxCost_ = (std::max)(maxCost_, costs_[source]);
+			collapseCount++;
+
+			for (uint32_t j = triangleOffsets_[source]; j < triangleOffsets_[source + 1]; j++) {
+				const uint32_t triangle = triangles_[j];
+				for (size_t corner = 0; corner < 3; corner++) {
+					isDirty_[positionIds_[indices_[triangle * 3 + corner]]] = 1;
+				}
+			}
+			// 内部の縮約で2枚、境界で1枚の三角形が消える
+			removed += kinds_[source] == kManifold ? 2 : 1;
+			if (targetTriangleRemoval <= removed) {
+				break;
+			}
+		}
+		return collapseCount != 0;
+	}
+
+	// 選んだ縮約をインデックスへ反映し、潰れた三角形を取り除く
+	void ApplyCollapses() {
+		size_t write = 0;
+		for (size_t i = 0; i < indices_.size(); i += 3) {
+			uint32_t triangle[3];
+			for (size_t corner = 0; corner < 3; corner++) {
+				triangle[corner] = wedgeRemap_[indices_[i + corner]];
+			}
+			const uint32_t id0 = positionIds_[triangle[0]];
+			const uint32_t id1 = positionIds_[triangle[1]];
+			const uint32_t id2 = positionIds_[triangle[2]];
+			if (id0 == id1 || id1 == id2 || id2 == id0) {
+				continue;
+			}
+			indices_[write++] = triangle[0];
+			indices_[write++] = triangle[1];
+			indices_[write++] = triangle[2];
+		}
+		indices_.resize(write);
+	}
+
+	// 頂点の種類（大きいほど動かしにくい）
+	enum Kind : uint8_t {
+		kManifold, // 内部
+		kBorder,   // 境界
+		kLocked,   // 非多様体（動かさない）
+	};
+
+	const std::vector<MeshVertex>& vertices_;
+	std::vector<uint32_t> indices_;
+	// 頂点 → 座標番号
+	std::vector<uint32_t> positionIds_;
+	// 座標番号 → 座標
+	std::vector<Vector3> positions_;
+	// 座標番号 → 頂点一覧（CSR）
+	std::vector<uint32_t> wedgeOffsets_;
+	std::vector<uint32_t> wedges_;
+	// 座標番号 → 三角形一覧（CSR）
+	std::vector<uint32_t> triangleOffsets_;
+	std::vector<uint32_t> triangles_;
+	std::vector<Kind> kinds_;
+	// 境界辺
+	std::unordered_set<uint64_t> borderEdges_;
+	std::vector<Quadric> quadrics_;
+	// 座標ごとの縮約のコストと縮約先、再評価が必要か
+	std::vector<double> costs_;
+	std::vector<uint32_t> targets_;
+	std::vector<uint8_t> isDirty_;
+	// 今回のパスの頂点の付け替え先
+	std::vector<uint32_t> wedgeRemap_;
+	// 属性の誤差を距離の2乗へ換算する係数
+	double attributeScale_ = 0.0;
+	// これまでに行った縮約の最大コスト
+	double maxCost_ = 0.0;
+};
+
+} // namespace
+
+std::vector<uint32_t> MeshSimplifier::Simplify(
+    const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+    size_t targetIndexCount, float maxError, float* resultError) {
+	if (indices.size() <= targetIndexCount || vertices.empty()) {
+		if (resultError) {
+			*resultError = 0.0f;
+		}
+		return indices;
+	}
+	Simplifier simplifier(vertices, indices);
+	std::vector<uint32_t> result = simplifier.Run(targetIndexCount, double(maxError));
+	if (resultError) {
+		*resultError = simplifier.GetError();
+	}
+	return result;
+}
+
+void MeshSimplifier::GenerateLods(MeshData& mesh, uint32_t lodCount, float reduction) {
+	mesh.lods.clear();
+	if (lodCount == 0 || mesh.indices.empty()) {
+		return;
+	}
+	// 二次誤差を引き継ぐため、同じ作業領域で段階的に簡略化する
+	Simplifier simplifier(mesh.vertices, mesh.indices);
+	size_t previousIndexCount = mesh.indices.size();
+	for (uint32_t lod = 0; lod < lodCount; lod++) {
+		const size_t target = size_t(float(previousIndexCount / 3) * reduction) * 3;
+		const std::vector<uint32_t>& indices = simplifier.Run(target, DBL_MAX);
+		// ほとんど減らなければそれ以上のLODは作らない
+		if (indices.empty() || float(previousIndexCount) * kMinLodReduction < float(indices.size())) {
+			break;
+		}
+		previousIndexCount = indices.size();
+
+		MeshLod& result = mesh.lods.emplace_back();
+		result.indices = indices;
+		result.error = simplifier.GetError();
+		MeshOptimizer::OptimizeVertexCache(result.indices, mesh.vertices.size());
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "MeshData.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// 二次誤差による辺の縮約でメッシュを簡略化する
+/// 頂点を隣の頂点へ寄せる縮約だけを行うので、簡略化後のインデックスは元の頂点配列をそのまま参照する
+/// </summary>
+class MeshSimplifier {
+public:
+	/// <summary>
+	/// 簡略化
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	/// <param name="indices">インデックス（三角形リスト）</param>
+	/// <param name="targetIndexCount">目標インデックス数</param>
+	/// <param name="maxError">許容する誤差（モデル座標系の距離）</param>
+	/// <param name="resultError">実際の誤差の出力先（nullptrなら出力しない）</param>
+	/// <returns>簡略化したインデックス</returns>
+	static std::vector<uint32_t> Simplify(
+	    const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices,
+	    size_t targetIndexCount, float maxError, float* resultError = nullptr);
+
+	/// <summary>
+	/// LODを生成して mesh.lods に設定する
+	/// 前のLODから三角形数を reduction 倍ずつ減らし、減らせなくなったら打ち切る
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="lodCount">生成するLODの数（LOD0を含まない）</param>
+	/// <param name="reduction">1段あたりの三角形数の比率</param>
+	static void GenerateLods(MeshData& mesh, uint32_t lodCount, float reduction = 0.5f);
+};
@@ -0,0 +1,382 @@
+#include "MeshletBuilder.h"
+#include "MathUtility.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 未使用を表す番号
+const uint32_t kInvalid = UINT32_MAX;
+
+/// <summary>
+/// 分割の作業状態
+/// </summary>
+class Partitioner {
+public:
+	Partitioner(const MeshData& mesh, const MeshletBuilder::Options& options)
+	    : vertices_(mesh.vertices), indices_(mesh.indices), options_(options) {
+		triangleCount_ = indices_.size() / 3;
+		WeldPositions();
+		BuildAdjacency();
+		ComputeTriangleShapes();
+	}
+
+	/// <summary>
+	/// 分割の実行
+	/// </summary>
+	/// <param name="indices">メッシュレット順に並べ替えたインデックスの出力先</param>
+	/// <param name="meshlets">メッシュレットの出力先</param>
+	void Run(std::vector<uint32_t>& indices, std::vector<Meshlet>& meshlets) {
+		indices.clear();
+		indices.reserve(triangleCount_ * 3);
+		meshlets.clear();
+
+		isEmitted_.assign(triangleCount_, 0);
+		candidateStamps_.assign(triangleCount_, kInvalid);
+		vertexStamps_.assign(vertices_.size(), kInvalid);
+
+		size_t scanCursor = 0;
+		size_t emittedCount = 0;
+		Vector3 previousCenter = {0.0f, 0.0f, 0.0f};
+		while (emittedCount < triangleCount_) {
+			const uint32_t meshletIndex = uint32_t(meshlets.size());
+			const uint32_t firstIndex = uint32_t(indices.size());
+
+			// 前のメッシュレットの縁に残った三角形から始めると、分割が飛び地にならない
+			uint32_t seed = FindSeedCandidate(previousCenter);
+			if (seed == kInvalid) {
+				while (isEmitted_[scanCursor]) {
+					scanCursor++;
+				}
+				seed = uint32_t(scanCursor);
+			}
+			candidates_.clear();
+			vertexCount_ = 0;
+			centerSum_ = {0.0f, 0.0f, 0.0f};
+			normalSum_ = {0.0f, 0.0f, 0.0f};
+
+			uint32_t triangle = seed;
+			uint32_t triangleCount = 0;
+			while (triangle != kInvalid) {
+				AddTriangle(triangle, meshletIndex, indices);
+				triangleCount++;
+				if (triangleCount == options_.maxTriangleCount) {
+					break;
+				}
+				triangle = FindNextTriangle(meshletIndex, triangleCount);
+			}
+			emittedCount += triangleCount;
+			previousCenter = centerSum_ * (1.0f / float(triangleCount));
+
+			meshlets.push_back(MeshletBuilder::ComputeBounds(
+			    vertices_, std::span<const uint32_t>(indices).subspan(firstIndex), firstIndex));
+		}
+	}
+
+private:
+	// 同じ座標の頂点に同じ番号を振る（UVや法線の継ぎ目で分かれた頂点も隣接として扱うため）
+	void WeldPositions() {
+		const size_t vertexCount = vertices_.size();
+		std::vector<std::array<uint32_t, 3>> keys(vertexCount);
+		std::vector<uint32_t> order(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; i++) {
+			std::memcpy(keys[i].data(), &vertices_[i].pos, sizeof(keys[i]));
+			// -0 と +0 は同じ座標として扱う
+			for (uint32_t& bits : keys[i]) {
+				bits = bits == 0x80000000u ? 0u : bits;
+			}
+			order[i] = i;
+		}
+		std::sort(order.begin(), order.end(), [&keys](uint32_t lhs, uint32_t rhs) {
+			return keys[lhs] < keys[rhs];
+		});
+		positionIds_.resize(vertexCount);
+		positionCount_ = 0;
+		for (size_t i = 0; i < vertexCount; i++) {
+			if (i != 0 && keys[order[i - 1]] != keys[order[i]]) {
+				positionCount_++;
+			}
+			positionIds_[order[i]] = positionCount_;
+		}
+		positionCount_ += vertexCount != 0 ? 1u : 0u;
+	}
+
+	// 座標ごとの三角形一覧（CSR）
+	void BuildAdjacency() {
+		adjacencyOffsets_.assign(size_t(positionCount_) + 1, 0);
+		for (uint32_t index : indices_) {
+			adjacencyOffsets_[positionIds_[index] + 1]++;
+		}
+		for (size_t i = 0; i < positionCount_; i++) {
+			adjacencyOffsets_[i + 1] += adjacencyOffsets_[i];
+		}
+		adjacency_.resize(triangleCount_ * 3);
+		std::vector<uint32_t> cursors(adjacencyOffsets_.begin(), adjacencyOffsets_.end() - 1);
+		for (size_t corner = 0; corner < triangleCount_ * 3; corner++) {
+			adjacency_[cursors[positionIds_[indices_[corner]]]++] = uint32_t(corner / 3);
+		}
+		liveCounts_.resize(positionCount_);
+		for (uint32_t position = 0; position < positionCount_; position++) {
+			liveCounts_[position] = adjacencyOffsets_[position + 1] - adjacencyOffsets_[position];
+		}
+	}
+
+	// 三角形の重心と向き
+	void ComputeTriangleShapes() {
+		centers_.resize(triangleCount_);
+		normals_.resize(triangleCount_);
+		for (size_t triangle = 0; triangle < triangleCount_; triangle++) {
+			const Vector3& p0 = vertices_[indices_[triangle * 3 + 0]].pos;
+			const Vector3& p1 = vertices_[indices_[triangle * 3 + 1]].pos;
+			const Vector3& p2 = vertices_[indices_[triangle * 3 + 2]].pos;
+			centers_[triangle] = (p0 + p1 + p2) * (1.0f / 3.0f);
+			normals_[triangle] = Normalize(Cross(p1 - p0, p2 - p0));
+		}
+	}
+
+	// 三角形を加えると増える頂点の数
+	uint32_t CountNewVertices(uint32_t triangle, uint32_t meshletIndex) const {
+		uint32_t count = 0;
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			count += vertexStamps_[indices_[triangle * 3 + corner]] != meshletIndex ? 1 : 0;
+		}
+		return count;
+	}
+
+	// 三角形の頂点の座標を共有する、まだ出力していない三角形の数の合計
+	uint32_t CountLiveNeighbors(uint32_t triangle) const {
+		uint32_t count = 0;
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			count += liveCounts_[positionIds_[indices_[triangle * 3 + corner]]];
+		}
+		return count;
+	}
+
+	// 三角形の頂点のどれかが、その座標を使う最後の三角形か
+	bool IsDangling(uint32_t triangle) const {
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			if (liveCounts_[positionIds_[indices_[triangle * 3 + corner]]] == 1) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// 三角形をメッシュレットに加え、隣接する三角形を候補にする
+	void AddTriangle(uint32_t triangle, uint32_t meshletIndex, std::vector<uint32_t>& indices) {
+		isEmitted_[triangle] = 1;
+		for (uint32_t corner = 0; corner < 3; corner++) {
+			const uint32_t vertex = indices_[triangle * 3 + corner];
+			indices.push_back(vertex);
+			liveCounts_[positionIds_[vertex]]--;
+			if (vertexStamps_[vertex] == meshletIndex) {
+				continue;
+			}
+			vertexStamps_[vertex] = meshletIndex;
+			vertexCount_++;
+
+			const uint32_t position = positionIds_[vertex];
+			for (uint32_t i = adjacencyOffsets_[position]; i < adjacencyOffsets_[position + 1]; i++) {
+				const uint32_t neighbor = adjacency_[i];
+				if (!isEmitted_[neighbor] && candidateStamps_[neighbor] != meshletIndex) {
+					candidateStamps_[neighbor] = meshletIndex;
+					candidates_.push_back(neighbor);
+				}
+			}
+		}
+		centerSum_ += centers_[triangle];
+		normalSum_ += normals_[triangle];
+	}
+
+	// 次に加える三角形（頂点を増やさない三角形と、取り残されそうな三角形を優先し、その中で近く向きの揃ったもの）
+	uint32_t FindNextTriangle(uint32_t meshletIndex, uint32_t triangleCount) {
+		const Vector3 center = centerSum_ * (1.0f / float(triangleCount));
+		const float normalLength = Length(normalSum_);
+		const Vector3 axis =
+		    normalLength != 0.0f ? normalSum_ * (1.0f / normalLength) : Vector3{0.0f, 0.0f, 0.0f};
+
+		uint32_t best = kInvalid;
+		uint32_t bestPriority = 0;
+		float bestScore = 0.0f;
+		for (size_t i = 0; i < candidates_.size();) {
+			const uint32_t triangle = candidates_[i];
+			if (isEmitted_[triangle]) {
+				candidates_[i] = candidates_.back();
+				candidates_.pop_back();
+				continue;
+			}
+			i++;
+			const uint32_t newVertexCount = CountNewVertices(triangle, meshletIndex);
+			if (options_.maxVertexCount < vertexCount_ + newVertexCount) {
+				continue;
+			}
+			// 頂点を増やさない三角形を先に使い、次に後のメッシュレットで孤立しそうな三角形を使う
+			const uint32_t priority =
+			    newVertexCount == 0 ? 0 : (IsDangling(triangle) ? 1 : 2);
+			const float distance = Length(centers_[triangle] - center);
+			const float spread = 1.0f - Dot(normals_[triangle], axis);
+			const float score = distance * (1.0f + options_.coneWeight * spread);
+			if (best == kInvalid || priority < bestPriority ||
+			    (priority == bestPriority && score < bestScore)) {
+				best = triangle;
+				bestPriority = priority;
+				bestScore = score;
+			}
+		}
+		return best;
+	}
+
+	// 前のメッシュレットの候補に残った三角形のうち、周りに残っている三角形が少なく近いもの
+	uint32_t FindSeedCandidate(const Vector3& center) const {
+		uint32_t best = kInvalid;
+		uint32_t bestLiveCount = 0;
+		float bestDistance = 0.0f;
+		for (uint32_t triangle : candidates_) {
+			if (isEmitted_[triangle]) {
+				continue;
+			}
+			const uint32_t liveCount = CountLiveNeighbors(triangle);
+			const Vector3 offset = centers_[triangle] - center;
+			const float distance = Dot(offset, offset);
+			if (best == kInvalid || liveCount < bestLiveCount ||
+			    (liveCount == bestLiveCount && distance < bestDistance)) {
+				best = triangle;
+				bestLiveCount = liveCount;
+				bestDistance = distance;
+			}
+		}
+		return best;
+	}
+
+	const std::vector<MeshVertex>& vertices_;
+	const std::vector<uint32_t>& indices_;
+	const MeshletBuilder::Options& options_;
+	size_t triangleCount_ = 0;
+
+	// 座標の番号（頂点ごと）
+	std::vector<uint32_t> positionIds_;
+	uint32_t positionCount_ = 0;
+	// 座標を共有する三角形（CSR）
+	std::vector<uint32_t> adjacencyOffsets_;
+	std::vector<uint32_t> adjacency_;
+	// 座標を共有する、まだ出力していない三角形の数
+	std::vector<uint32_t> liveCounts_;
+	// 三角形の重心と単位法線
+	std::vector<Vector3> centers_;
+	std::vector<Vector3> normals_;
+
+	// 出力済みの三角形
+	std::vector<uint8_t> isEmitted_;
+	// 候補に入れたメッシュレットの番号（三角形ごと）
+	std::vector<uint32_t> candidateStamps_;
+	// 含まれるメッシュレットの番号（頂点ごと）
+	std::vector<uint32_t> vertexStamps_;
+	// 作成中のメッシュレット
+	std::vector<uint32_t> candidates_;
+	uint32_t vertexCount_ = 0;
+	Vector3 centerSum_ = {0.0f, 0.0f, 0.0f};
+	Vector3 normalSum_ = {0.0f, 0.0f, 0.0f};
+};
+
+// メッシュレットごとに三角形を頂点キャッシュ向けに並べ直す
+// 分割は隣接順に三角形を集めるので、MeshOptimizer で整えた順がメッシュレットの中で崩れる。
+// 頂点をメッシュレット内の番号に振り直して最適化し、範囲と境界は変えずに中の順だけ戻す
+void OptimizeMeshletVertexCache(
+    std::vector<uint32_t>& indices, const std::vector<Meshlet>& meshlets, size_t vertexCount,
+    uint32_t cacheSize) {
+	std::vector<uint32_t> localIds(vertexCount, kInvalid);
+	std::vector<uint32_t> globalIds;
+	std::vector<uint32_t> localIndices;
+	for (const Meshlet& meshlet : meshlets) {
+		uint32_t* meshletIndices = indices.data() + meshlet.firstIndex;
+		const size_t indexCount = size_t(meshlet.triangleCount) * 3;
+		globalIds.clear();
+		localIndices.resize(indexCount);
+		for (size_t i = 0; i < indexCount; i++) {
+			const uint32_t vertex = meshletIndices[i];
+			if (localIds[vertex] == kInvalid) {
+				localIds[vertex] = uint32_t(globalIds.size());
+				globalIds.push_back(vertex);
+			}
+			localIndices[i] = localIds[vertex];
+		}
+		MeshOptimizer::OptimizeVertexCache(localIndices, globalIds.size(), cacheSize);
+		for (size_t i = 0; i < indexCount; i++) {
+			meshletIndices[i] = globalIds[localIndices[i]];
+		}
+		for (uint32_t vertex : globalIds) {
+			localIds[vertex] = kInvalid;
+		}
+	}
+}
+
+} // namespace
+
+void MeshletBuilder::Build(MeshData& mesh, const Options& options) {
+	assert(mesh.indices.size() % 3 == 0);
+	// 1つの三角形が入る大きさは必要
+	assert(3 <= options.maxVertexCount && 1 <= options.maxTriangleCount);
+	if (mesh.indices.empty()) {
+		mesh.meshlets.clear();
+		return;
+	}
+
+	std::vector<uint32_t> indices;
+	Partitioner(mesh, options).Run(indices, mesh.meshlets);
+	if (options.optimizeVertexCache) {
+		OptimizeMeshletVertexCache(
+		    indices, mesh.meshlets, mesh.vertices.size(), MeshOptimizer::kDefaultCacheSize);
+	}
+	mesh.indices = std::move(indices);
+}
+
+Meshlet MeshletBuilder::ComputeBounds(
+    const std::vector<MeshVertex>& vertices, std::span<const uint32_t> indices,
+    uint32_t firstIndex) {
+	assert(indices.size() % 3 == 0);
+	Meshlet meshlet{};
+	meshlet.firstIndex = firstIndex;
+	meshlet.triangleCount = uint32_t(indices.size() / 3);
+
+	// 参照している頂点
+	std::vector<uint32_t> uniqueIndices(indices.begin(), indices.end());
+	std::sort(uniqueIndices.begin(), uniqueIndices.end());
+	uniqueIndices.erase(std::unique(uniqueIndices.begin(), uniqueIndices.end()), uniqueIndices.end());
+	meshlet.vertexCount = uint32_t(uniqueIndices.size());
+	std::vector<Vector3> positions(uniqueIndices.size());
+	for (size_t i = 0; i < uniqueIndices.size(); i++) {
+		positions[i] = vertices[uniqueIndices[i]].pos;
+	}
+	meshlet.bounds = ComputeBoundingSphere(positions.data(), positions.size());
+
+	// 面の向きの平均と、そこから最も離れた面の傾き
+	std::vector<Vector3> normals;
+	normals.reserve(meshlet.triangleCount);
+	Vector3 normalSum = {0.0f, 0.0f, 0.0f};
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const Vector3& p0 = vertices[indices[i + 0]].pos;
+		const Vector3& p1 = vertices[indices[i + 1]].pos;
+		const Vector3& p2 = vertices[indices[i + 2]].pos;
+		const Vector3 normal = Cross(p1 - p0, p2 - p0);
+		if (Dot(normal, normal) == 0.0f) {
+			// 面積0の三角形は向きを持たない
+			continue;
+		}
+		normals.push_back(Normalize(normal));
+		normalSum += normals.back();
+	}
+	const float normalLength = Length(normalSum);
+	meshlet.coneAxis = normalLength != 0.0f ? normalSum * (1.0f / normalLength)
+	                                        : Vector3{0.0f, 0.0f, 0.0f};
+	float minDot = normals.empty() ? 0.0f : 1.0f;
+	for (const Vector3& normal : normals) {
+		minDot = (std::min)(minDot, Dot(normal, meshlet.coneAxis));
+	}
+	// 半球を超えて広がる場合は、どこから見ても表向きの面がある
+	meshlet.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt((std::max)(1.0f - minDot * minDot, 0.0f));
+	return meshlet;
+}
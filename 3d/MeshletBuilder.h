@@ -0,0 +1,51 @@
+#pragma once
+
+#include "MeshData.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// メッシュレットの分割
+/// LOD0の三角形を隣接する面から頂点数・三角形数の上限まで集め、メッシュレットの順にインデックスを並べ替える。
+/// 集めた順では頂点キャッシュの効率が落ちるので、各メッシュレットの中は頂点キャッシュ向けに並べ直す
+/// （メッシュレットの境界をまたぐ頂点の再利用は戻らないので、メッシュ全体で最適化した順よりは少し悪くなる）。
+/// 各メッシュレットには視錐台カリング用の境界球と、裏向き判定用の法線コーンを持たせる
+/// </summary>
+class MeshletBuilder {
+public:
+	/// <summary>
+	/// 分割の設定
+	/// </summary>
+	struct Options {
+		uint32_t maxVertexCount = kMeshletMaxVertexCount;     // 頂点数の上限
+		uint32_t maxTriangleCount = kMeshletMaxTriangleCount; // 三角形数の上限
+		float coneWeight = 0.5f; // 面の向きの揃い具合を距離よりどれだけ重視するか
+		bool optimizeVertexCache = true; // メッシュレット内の三角形を頂点キャッシュ向けに並べ直すか
+	};
+
+	/// <summary>
+	/// メッシュをメッシュレットに分割して mesh.meshlets に設定する（mesh.indices は並べ替わる）
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="options">設定</param>
+	static void Build(MeshData& mesh, const Options& options);
+
+	/// <summary>
+	/// メッシュを既定の設定でメッシュレットに分割する
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	static void Build(MeshData& mesh) { Build(mesh, Options()); }
+
+	/// <summary>
+	/// 三角形の範囲の境界球と法線コーンを求める
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	/// <param name="indices">範囲のインデックス（三角形リスト）</param>
+	/// <param name="firstIndex">範囲の先頭（Meshlet::firstIndex に設定する）</param>
+	/// <returns>メッシュレット</returns>
+	static Meshlet ComputeBounds(
+	    const std::vector<MeshVertex>& vertices, std::span<const uint32_t> indices,
+	    uint32_t firstIndex = 0);
+};
@@ -0,0 +1,73 @@
+#include "MeshletCuller.h"
+#include "MathUtility.h"
+#include <cassert>
+
+void MeshletCuller::Initialize(std::span<const Meshlet> meshlets) {
+	assert(meshlets.size() <= UINT32_MAX);
+	spheres_.resize(meshlets.size());
+	cones_.resize(meshlets.size());
+	ranges_.resize(meshlets.size());
+	indexCount_ = 0;
+	for (size_t i = 0; i < meshlets.size(); i++) {
+		const Meshlet& meshlet = meshlets[i];
+		spheres_[i] = meshlet.bounds;
+		cones_[i] = {meshlet.coneAxis, meshlet.coneCutoff};
+		ranges_[i] = {meshlet.firstIndex, meshlet.triangleCount * 3};
+		indexCount_ += ranges_[i].indexCount;
+	}
+	visibleIndices_.resize(meshlets.size());
+	statistics_ = Statistics();
+}
+
+const MeshletCuller::Statistics& MeshletCuller::Cull(
+    const Frustum& frustum, const Vector3& cameraPosition, std::vector<IndexRange>& ranges) {
+	statistics_ = Statistics();
+	statistics_.meshletCount = uint32_t(spheres_.size());
+	ranges.clear();
+
+	const size_t visibleCount =
+	    frustum.CullSpheres(spheres_.data(), spheres_.size(), visibleIndices_.data());
+
+	size_t visibleIndexCount = 0;
+	size_t backfaceIndexCount = 0;
+	for (size_t i = 0; i < visibleCount; i++) {
+		const uint32_t index = visibleIndices_[i];
+		const Sphere& sphere = spheres_[index];
+		const Cone& cone = cones_[index];
+		const IndexRange& range = ranges_[index];
+
+		// 全ての面の法線がコーン内にあるので、視線とのなす角で全ての面が裏向きか分かる
+		const Vector3 offset = sphere.center - cameraPosition;
+		if (cone.cutoff * Length(offset) + sphere.radius <= Dot(offset, cone.axis)) {
+			backfaceIndexCount += range.indexCount;
+			continue;
+		}
+
+		// インデックスが続いていれば1つの範囲にまとめる
+		if (!ranges.empty() &&
+		    ranges.back().firstIndex + ranges.back().indexCount == range.firstIndex) {
+			ranges.back().indexCount += range.indexCount;
+		} else {
+			ranges.push_back(range);
+		}
+		statistics_.visibleMeshletCount++;
+		visibleIndexCount += range.indexCount;
+	}
+
+	statistics_.rangeCount = uint32_t(ranges.size());
+	statistics_.triangleCount = indexCount_ / 3;
+	statistics_.backfaceCulledTriangleCount = backfaceIndexCount / 3;
+	statistics_.frustumCulledTriangleCount =
+	    (indexCount_ - visibleIndexCount - backfaceIndexCount) / 3;
+	return statistics_;
+}
+
+const MeshletCuller::Statistics& MeshletCuller::Cull(
+    const Matrix4x4& world, const Matrix4x4& view, const Matrix4x4& projection,
+    std::vector<IndexRange>& ranges) {
+	// 視錐台と視点をモデル座標系へ移す（面の表裏はアフィン変換で変わらない）
+	const Frustum frustum = Frustum::FromMatrix(world * view * projection);
+	const Vector3 cameraWorld = TransformPoint({0.0f, 0.0f, 0.0f}, InverseAffine(view));
+	const Vector3 cameraPosition = TransformPoint(cameraWorld, InverseAffine(world));
+	return Cull(frustum, cameraPosition, ranges);
+}
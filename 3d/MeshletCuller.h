@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Frustum.h"
+#include "Matrix4x4.h"
+#include "MeshData.h"
+#include "Vector3.h"
+#include "ViewProjection.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// <summary>
+/// メッシュレット単位のCPUカリング
+/// 境界球を視錐台で、法線コーンを視点の位置で判定し、残ったメッシュレットのインデックス範囲を
+/// 隣り合うものを繋げて出力する（MeshBuffer::DrawRanges で描画する）。
+/// 判定はモデル座標系で行うので、ワールド行列ごとに行列を変換して呼ぶ。視点は透視投影を前提とする。
+/// メッシュレットは MeshCache で作ったメッシュにだけあり、Model の描画には使われない
+/// </summary>
+class MeshletCuller {
+public:
+	/// <summary>
+	/// 直前のカリングの集計
+	/// </summary>
+	struct Statistics {
+		uint32_t meshletCount = 0;              // 判定したメッシュレット数
+		uint32_t visibleMeshletCount = 0;       // 残ったメッシュレット数
+		uint32_t rangeCount = 0;                // 出力した範囲の数
+		size_t triangleCount = 0;               // 判定した三角形数
+		size_t frustumCulledTriangleCount = 0;  // 視錐台の外で除いた三角形数
+		size_t backfaceCulledTriangleCount = 0; // 裏向きで除いた三角形数
+
+		/// <summary>
+		/// 除いた三角形数
+		/// </summary>
+		size_t GetCulledTriangleCount() const {
+			return frustumCulledTriangleCount + backfaceCulledTriangleCount;
+		}
+	};
+
+	/// <summary>
+	/// メッシュレットの設定（境界だけを判定しやすい並びでコピーする）
+	/// </summary>
+	/// <param name="meshlets">メッシュレット（MeshData::meshlets か MeshCache::MeshView::meshlets）</param>
+	void Initialize(std::span<const Meshlet> meshlets);
+
+	/// <summary>
+	/// カリング
+	/// </summary>
+	/// <param name="frustum">モデル座標系の視錐台</param>
+	/// <param name="cameraPosition">モデル座標系の視点</param>
+	/// <param name="ranges">残ったインデックス範囲の出力先（先頭から詰める）</param>
+	/// <returns>集計</returns>
+	const Statistics& Cull(
+	    const Frustum& frustum, const Vector3& cameraPosition, std::vector<IndexRange>& ranges);
+
+	/// <summary>
+	/// 行列を指定したカリング
+	/// </summary>
+	/// <param name="world">ワールド行列</param>
+	/// <param name="view">ビュー行列</param>
+	/// <param name="projection">射影行列</param>
+	/// <param name="ranges">残ったインデックス範囲の出力先</param>
+	/// <returns>集計</returns>
+	const Statistics& Cull(
+	    const Matrix4x4& world, const Matrix4x4& view, const Matrix4x4& projection,
+	    std::vector<IndexRange>& ranges);
+
+	/// <summary>
+	/// ビュープロジェクションを指定したカリング
+	/// </summary>
+	/// <param name="world">ワールド行列 (WorldTransform::matWorld_)</param>
+	/// <param name="viewProjection">ビュープロジェクション（UpdateMatrix済み）</param>
+	/// <param name="ranges">残ったインデックス範囲の出力先</param>
+	/// <returns>集計</returns>
+	const Statistics& Cull(
+	    const Matrix4x4& world, const ViewProjection& viewProjection,
+	    std::vector<IndexRange>& ranges) {
+		return Cull(world, viewProjection.matView, viewProjection.matProjection, ranges);
+	}
+
+	const Statistics& GetStatistics() const { return statistics_; }
+	size_t GetMeshletCount() const { return spheres_.size(); }
+
+private:
+	// 裏向き判定用の法線コーン
+	struct Cone {
+		Vector3 axis;
+		float cutoff;
+	};
+
+	// 境界球（Frustum::CullSpheres にそのまま渡す）
+	std::vector<Sphere> spheres_;
+	// 法線コーン
+	std::vector<Cone> cones_;
+	// インデックス範囲
+	std::vector<IndexRange> ranges_;
+	// 全メッシュレットのインデックス数
+	size_t indexCount_ = 0;
+	// 視錐台の判定結果の作業領域
+	std::vector<uint32_t> visibleIndices_;
+	// 集計
+	Statistics statistics_;
+};
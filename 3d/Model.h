@@ -5,10 +5,14 @@
 #include "TextureManager.h"
 #include "ViewProjection.h"
 #include "WorldTransform.h"
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+class InstanceBatcher;
+class StaticBatch;
+
 /// <summary>
 /// モデルデータ
 /// </summary>
@@ -81,6 +85,23 @@ public: // 静的メンバ関数
 	/// </summary>
 	static void PostDraw();
 
+	/// <summary>
+	/// まとめたインスタンスの描画（まとまりごとに各メッシュを1回の DrawIndexedInstanced で描く）
+	/// </summary>
+	/// <param name="batcher">Build済みのまとめ（番号は models の添字）</param>
+	/// <param name="models">モデル配列</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	static void DrawInstanced(
+	    const InstanceBatcher& batcher, std::span<Model* const> models,
+	    const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// 静的なまとめの描画（マテリアルが変わるときだけ設定し直す）
+	/// </summary>
+	/// <param name="batch">Build済みのまとめ</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	static void DrawStaticBatch(const StaticBatch& batch, const ViewProjection& viewProjection);
+
 public: // メンバ関数
 	/// <summary>
 	/// デストラクタ
@@ -111,6 +132,23 @@ public: // メンバ関数
 	    const WorldTransform& worldTransform, const ViewProjection& viewProjection,
 	    uint32_t textureHadle);
 
+	/// <summary>
+	/// インスタンス描画（行列を構造化バッファに詰め、メッシュごとに1回だけ描画コマンドを積む）
+	/// </summary>
+	/// <param name="worldTransforms">ワールドトランスフォーム（計算済みの matWorld_ を使う）</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void DrawInstanced(
+	    std::span<const WorldTransform* const> worldTransforms,
+	    const ViewProjection& viewProjection);
+
+	/// <summary>
+	/// インスタンス描画（ワールド行列版）
+	/// </summary>
+	/// <param name="worldMatrices">ワールド行列</param>
+	/// <param name="viewProjection">ビュープロジェクション</param>
+	void DrawInstanced(
+	    std::span<const Matrix4x4> worldMatrices, const ViewProjection& viewProjection);
+
 	/// <summary>
 	/// メッシュコンテナを取得
 	/// </summary>
@@ -149,4 +187,11 @@ private: // メンバ関数
 	/// テクスチャ読み込み
 	/// </summary>
 	void LoadTextures();
+
+	/// <summary>
+	/// 全メッシュのインスタンス描画コマンドを積む（インスタンス用パイプラインを設定済みであること）
+	/// </summary>
+	/// <param name="instances">インスタンスデータの先頭アドレス</param>
+	/// <param name="instanceCount">インスタンス数</param>
+	void DrawMeshesInstanced(D3D12_GPU_VIRTUAL_ADDRESS instances, UINT instanceCount);
 };
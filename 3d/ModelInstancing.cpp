@@ -0,0 +1,237 @@
+#include "DirectXCommon.h"
+#include "InstanceBatcher.h"
+#include "MeshBuffer.h"
+#include "Model.h"
+#include <cassert>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <d3dx12.h>
+
+#pragma comment(lib, "d3dcompiler.lib")
+
+namespace {
+
+// インスタンスデータは Model のワールド変換と同じルートパラメータ番号に置く
+const UINT kRootParameterInstances = UINT(Model::RoomParameter::kWorldTransform);
+
+// シェーダーのコンパイル
+Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(const wchar_t* filePath, const char* target) {
+#ifdef _DEBUG
+	const UINT flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	const UINT flags = 0;
+#endif
+	Microsoft::WRL::ComPtr<ID3DBlob> shaderBlob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+	HRESULT result = D3DCompileFromFile(
+	    filePath, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, "main", target, flags, 0,
+	    &shaderBlob, &errorBlob);
+	if (FAILED(result)) {
+		if (errorBlob) {
+			OutputDebugStringA(static_cast<const char*>(errorBlob->GetBufferPointer()));
+		}
+		assert(false);
+	}
+	return shaderBlob;
+}
+
+/// <summary>
+/// インスタンス描画用のパイプライン（Model のパイプラインのワールド変換を構造化バッファに替えたもの）
+/// </summary>
+struct InstancedPipeline {
+	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState;
+
+	void Initialize() {
+		HRESULT result;
+		ID3D12Device* device = DirectXCommon::GetInstance()->GetDevice();
+
+		Microsoft::WRL::ComPtr<ID3DBlob> vsBlob =
+		    CompileShader(L"Resources/shaders/ObjInstancedVS.hlsl", "vs_5_0");
+		Microsoft::WRL::ComPtr<ID3DBlob> psBlob =
+		    CompileShader(L"Resources/shaders/ObjPS.hlsl", "ps_5_0");
+
+		// ルートパラメータ
+		CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+		descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0); // t0 レジスタ
+		CD3DX12_ROOT_PARAMETER rootparams[5];
+		rootparams[kRootParameterInstances].InitAsShaderResourceView(
+		    1, 0, D3D12_SHADER_VISIBILITY_VERTEX); // t1 レジスタ
+		rootparams[UINT(Model::RoomParameter::kViewProjection)].InitAsConstantBufferView(1);
+		rootparams[UINT(Model::RoomParameter::kMaterial)].InitAsConstantBufferView(2);
+		rootparams[UINT(Model::RoomParameter::kTexture)].InitAsDescriptorTable(
+		    1, &descRangeSRV, D3D12_SHADER_VISIBILITY_ALL);
+		rootparams[UINT(Model::RoomParameter::kLight)].InitAsConstantBufferView(3);
+
+		// スタティックサンプラー
+		CD3DX12_STATIC_SAMPLER_DESC samplerDesc =
+		    CD3DX12_STATIC_SAMPLER_DESC(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR);
+
+		// ルートシグネチャの設定
+		CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+		rootSignatureDesc.Init_1_0(
+		    _countof(rootparams), rootparams, 1, &samplerDesc,
+		    D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+		Microsoft::WRL::ComPtr<ID3DBlob> rootSigBlob;
+		Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+		result = D3DX12SerializeVersionedRootSignature(
+		    &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+		assert(SUCCEEDED(result));
+		result = device->CreateRootSignature(
+		    0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(),
+		    IID_PPV_ARGS(&rootSignature));
+		assert(SUCCEEDED(result));
+
+		// グラフィックスパイプラインの設定（頂点は Mesh::VertexPosNormalUv）
+		std::span<const D3D12_INPUT_ELEMENT_DESC> inputLayout =
+		    MeshBuffer::GetInputLayout(VertexFormat::kFloat32);
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+		gpipeline.pRootSignature = rootSignature.Get();
+		gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob.Get());
+		gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob.Get());
+		gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+		gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+		gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+
+		// αブレンド
+		D3D12_RENDER_TARGET_BLEND_DESC& blenddesc = gpipeline.BlendState.RenderTarget[0];
+		blenddesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+		blenddesc.BlendEnable = true;
+		blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		blenddesc.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+		blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+		blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+		blenddesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+
+		gpipeline.InputLayout.pInputElementDescs = inputLayout.data();
+		gpipeline.InputLayout.NumElements = UINT(inputLayout.size());
+		gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+		gpipeline.NumRenderTargets = 1;
+		gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+		gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+		gpipeline.SampleDesc.Count = 1;
+
+		result = device->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelineState));
+		assert(SUCCEEDED(result));
+	}
+
+	static InstancedPipeline& Get() {
+		static InstancedPipeline pipeline;
+		if (!pipeline.pipelineState) {
+			pipeline.Initialize();
+		}
+		return pipeline;
+	}
+};
+
+/// <summary>
+/// フレーム内で使い捨てるインスタンスデータの領域
+/// </summary>
+struct InstanceAllocation {
+	InstanceData* data;
+	D3D12_GPU_VIRTUAL_ADDRESS address;
+};
+
+// フレームごとのアップロード領域から確保する（GPUがそのフレームを描画し終えるまで書き換えられない）
+InstanceAllocation AllocateInstances(size_t count) {
+	DirectXCommon::FrameAllocation allocation =
+	    DirectXCommon::GetInstance()->AllocateFrameMemory(sizeof(InstanceData) * count);
+	return {static_cast<InstanceData*>(allocation.data), allocation.address};
+}
+
+// インスタンス用パイプラインへの切り替えと共通の定数バッファの設定
+void SetInstancedPipeline(
+    ID3D12GraphicsCommandList* commandList, const ViewProjection& viewProjection,
+    LightGroup* lightGroup) {
+	InstancedPipeline& pipeline = InstancedPipeline::Get();
+	commandList->SetGraphicsRootSignature(pipeline.rootSignature.Get());
+	commandList->SetPipelineState(pipeline.pipelineState.Get());
+	commandList->SetGraphicsRootConstantBufferView(
+	    UINT(Model::RoomParameter::kViewProjection),
+	    viewProjection.constBuff_->GetGPUVirtualAddress());
+	lightGroup->Draw(commandList, UINT(Model::RoomParameter::kLight));
+}
+
+} // namespace
+
+void Model::DrawInstanced(
+    const InstanceBatcher& batcher, std::span<Model* const> models,
+    const ViewProjection& viewProjection) {
+	assert(sCommandList_);
+	std::span<const InstanceData> instances = batcher.GetInstances();
+	if (instances.empty()) {
+		return;
+	}
+	InstanceAllocation allocation = AllocateInstances(instances.size());
+	std::memcpy(allocation.data, instances.data(), instances.size_bytes());
+
+	SetInstancedPipeline(sCommandList_, viewProjection, lightGroup.get());
+
+	for (const InstanceBatcher::Batch& batch : batcher.GetBatches()) {
+		assert(batch.key < models.size() && models[batch.key]);
+		models[batch.key]->DrawMeshesInstanced(
+		    allocation.address + sizeof(InstanceData) * batch.firstInstance, batch.instanceCount);
+	}
+
+	// 通常の描画に戻す
+	sCommandList_->SetGraphicsRootSignature(sRootSignature_.Get());
+	sCommandList_->SetPipelineState(sPipelineState_.Get());
+}
+
+void Model::DrawInstanced(
+    std::span<const WorldTransform* const> worldTransforms, const ViewProjection& viewProjection) {
+	assert(sCommandList_);
+	if (worldTransforms.empty()) {
+		return;
+	}
+	InstanceAllocation allocation = AllocateInstances(worldTransforms.size());
+	for (size_t i = 0; i < worldTransforms.size(); i++) {
+		allocation.data[i].world = worldTransforms[i]->matWorld_;
+	}
+
+	SetInstancedPipeline(sCommandList_, viewProjection, lightGroup.get());
+
+	DrawMeshesInstanced(allocation.address, UINT(worldTransforms.size()));
+
+	sCommandList_->SetGraphicsRootSignature(sRootSignature_.Get());
+	sCommandList_->SetPipelineState(sPipelineState_.Get());
+}
+
+void Model::DrawInstanced(
+    std::span<const Matrix4x4> worldMatrices, const ViewProjection& viewProjection) {
+	assert(sCommandList_);
+	if (worldMatrices.empty()) {
+		return;
+	}
+	InstanceAllocation allocation = AllocateInstances(worldMatrices.size());
+	static_assert(sizeof(InstanceData) == sizeof(Matrix4x4));
+	std::memcpy(allocation.data, worldMatrices.data(), worldMatrices.size_bytes());
+
+	SetInstancedPipeline(sCommandList_, viewProjection, lightGroup.get());
+
+	DrawMeshesInstanced(allocation.address, UINT(worldMatrices.size()));
+
+	sCommandList_->SetGraphicsRootSignature(sRootSignature_.Get());
+	sCommandList_->SetPipelineState(sPipelineState_.Get());
+}
+
+void Model::DrawMeshesInstanced(D3D12_GPU_VIRTUAL_ADDRESS instances, UINT instanceCount) {
+	sCommandList_->SetGraphicsRootShaderResourceView(kRootParameterInstances, instances);
+	for (Mesh* mesh : meshes_) {
+		Material* material = mesh->GetMaterial();
+		if (mesh->GetIndices().empty() || !material) {
+			continue;
+		}
+		// 頂点バッファ・インデックスバッファとマテリアルの設定
+		sCommandList_->IASetVertexBuffers(0, 1, &mesh->GetVBView());
+		sCommandList_->IASetIndexBuffer(&mesh->GetIBView());
+		material->SetGraphicsCommand(
+		    sCommandList_, UINT(RoomParameter::kMaterial), UINT(RoomParameter::kTexture));
+
+		// 全インスタンスを1回で描画
+		sCommandList_->DrawIndexedInstanced(
+		    UINT(mesh->GetIndices().size()), instanceCount, 0, 0, 0);
+	}
+}
@@ -0,0 +1,173 @@
+#include "ModelRegistry.h"
+#include "DirectXCommon.h"
+#include <cassert>
+#include <unordered_set>
+
+ModelRegistry::Handle::Handle(uint32_t index, uint32_t generation)
+    : index_(index), generation_(generation) {
+	ModelRegistry::GetInstance()->AddRef(index_);
+}
+
+ModelRegistry::Handle::Handle(const Handle& other)
+    : index_(other.index_), generation_(other.generation_) {
+	if (index_ != kInvalidIndex) {
+		ModelRegistry::GetInstance()->AddRef(index_);
+	}
+}
+
+ModelRegistry::Handle::Handle(Handle&& other) noexcept
+    : index_(other.index_), generation_(other.generation_) {
+	other.index_ = kInvalidIndex;
+}
+
+ModelRegistry::Handle& ModelRegistry::Handle::operator=(const Handle& other) {
+	if (this != &other) {
+		// 同じモデルを指す場合に先に解放しないよう、増やしてから減らす
+		if (other.index_ != kInvalidIndex) {
+			ModelRegistry::GetInstance()->AddRef(other.index_);
+		}
+		Reset();
+		index_ = other.index_;
+		generation_ = other.generation_;
+	}
+	return *this;
+}
+
+ModelRegistry::Handle& ModelRegistry::Handle::operator=(Handle&& other) noexcept {
+	if (this != &other) {
+		Reset();
+		index_ = other.index_;
+		generation_ = other.generation_;
+		other.index_ = kInvalidIndex;
+	}
+	return *this;
+}
+
+ModelRegistry::Handle::~Handle() { Reset(); }
+
+Model* ModelRegistry::Handle::Get() const {
+	if (index_ == kInvalidIndex) {
+		return nullptr;
+	}
+	const Entry& entry = ModelRegistry::GetInstance()->entries_[index_];
+	// 参照がある間は解放されないので世代は一致する
+	assert(entry.generation == generation_);
+	return entry.model.get();
+}
+
+void ModelRegistry::Handle::Reset() {
+	if (index_ != kInvalidIndex) {
+		ModelRegistry::GetInstance()->Release(index_);
+		index_ = kInvalidIndex;
+	}
+}
+
+ModelRegistry* ModelRegistry::GetInstance() {
+	static ModelRegistry instance;
+	return &instance;
+}
+
+ModelRegistry::Handle ModelRegistry::Load(const std::string& modelName, bool smoothing) {
+	return ModelRegistry::GetInstance()->LoadInternal(modelName, smoothing);
+}
+
+size_t ModelRegistry::CollectGarbage() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	const uint64_t frame = dxCommon->GetFrameCount();
+	const uint64_t frameContextCount = dxCommon->GetFrameContextCount();
+	size_t count = 0;
+	for (uint32_t index = 0; index < entries_.size(); index++) {
+		Entry& entry = entries_[index];
+		if (!entry.model || entry.refCount != 0 ||
+		    frame < entry.releasedFrame + frameContextCount) {
+			continue;
+		}
+		indices_.erase(entry.key);
+		entry.model.reset();
+		entry.key.clear();
+		// 古いハンドルを検出できるよう世代を進める
+		entry.generation++;
+		freeIndices_.push_back(index);
+		count++;
+	}
+	return count;
+}
+
+ModelRegistry::Statistics ModelRegistry::GetStatistics() const {
+	Statistics statistics;
+	for (const Entry& entry : entries_) {
+		if (!entry.model) {
+			continue;
+		}
+		statistics.modelCount++;
+		if (entry.refCount == 0) {
+			statistics.unreferencedCount++;
+		}
+		statistics.handleCount += entry.refCount;
+		statistics.materialCount += entry.materialCount;
+		statistics.vertexBufferSize += entry.vertexBufferSize;
+		statistics.indexBufferSize += entry.indexBufferSize;
+	}
+	// 定数バッファは256バイト境界で確保される
+	const size_t constantBufferSize =
+	    (sizeof(Material::ConstBufferData) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) &
+	    ~size_t(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+	statistics.constantBufferSize = statistics.materialCount * constantBufferSize;
+	statistics.loadCount = loadCount_;
+	statistics.hitCount = hitCount_;
+	return statistics;
+}
+
+ModelRegistry::Handle ModelRegistry::LoadInternal(const std::string& modelName, bool smoothing) {
+	const std::string key = modelName + (smoothing ? "|smooth" : "|flat");
+
+	auto it = indices_.find(key);
+	if (it != indices_.end()) {
+		hitCount_++;
+		return Handle(it->second, entries_[it->second].generation);
+	}
+
+	uint32_t index;
+	if (!freeIndices_.empty()) {
+		index = freeIndices_.back();
+		freeIndices_.pop_back();
+	} else {
+		index = uint32_t(entries_.size());
+		entries_.emplace_back();
+	}
+	Entry& entry = entries_[index];
+	entry.model.reset(Model::CreateFromOBJ(modelName, smoothing));
+	entry.key = key;
+	entry.refCount = 0;
+	MeasureMemory(entry);
+	indices_.emplace(key, index);
+	loadCount_++;
+	return Handle(index, entry.generation);
+}
+
+void ModelRegistry::AddRef(uint32_t index) {
+	assert(index < entries_.size() && entries_[index].model);
+	entries_[index].refCount++;
+}
+
+void ModelRegistry::Release(uint32_t index) {
+	assert(index < entries_.size() && entries_[index].refCount != 0);
+	// 参照が無くなってもすぐには解放せず、CollectGarbage まで再利用できるよう残す
+	if (--entries_[index].refCount == 0) {
+		entries_[index].releasedFrame = DirectXCommon::GetInstance()->GetFrameCount();
+	}
+}
+
+void ModelRegistry::MeasureMemory(Entry& entry) {
+	entry.vertexBufferSize = 0;
+	entry.indexBufferSize = 0;
+	std::unordered_set<const Material*> materials;
+	for (Mesh* mesh : entry.model->GetMeshes()) {
+		entry.vertexBufferSize += sizeof(Mesh::VertexPosNormalUv) * mesh->GetVertices().size();
+		entry.indexBufferSize += sizeof(unsigned short) * mesh->GetIndices().size();
+		if (mesh->GetMaterial()) {
+			materials.insert(mesh->GetMaterial());
+		}
+	}
+	entry.materialCount = uint32_t(materials.size());
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Model.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// モデルの共有キャッシュ
+/// 名前と平滑化フラグが同じモデルは一度だけ読み込み、GPUバッファとマテリアルを全インスタンスで共有する。
+/// 参照はメインスレッドからのみ行う（参照カウントは非アトミック）
+/// </summary>
+class ModelRegistry {
+public:
+	/// <summary>
+	/// モデルへの参照（インスタンスごとに持つ）
+	/// コピーで参照カウントが増え、破棄で減る。8バイトでアトミック操作を伴わない
+	/// </summary>
+	class Handle {
+	public:
+		Handle() = default;
+		Handle(const Handle& other);
+		Handle(Handle&& other) noexcept;
+		Handle& operator=(const Handle& other);
+		Handle& operator=(Handle&& other) noexcept;
+		~Handle();
+
+		/// <summary>
+		/// モデルの取得（無効なら nullptr）
+		/// </summary>
+		Model* Get() const;
+		Model* operator->() const { return Get(); }
+		explicit operator bool() const { return index_ != kInvalidIndex; }
+
+		/// <summary>
+		/// 参照を手放す
+		/// </summary>
+		void Reset();
+
+	private:
+		friend class ModelRegistry;
+		Handle(uint32_t index, uint32_t generation);
+
+		uint32_t index_ = kInvalidIndex;
+		uint32_t generation_ = 0;
+	};
+
+	/// <summary>
+	/// 使用量の統計
+	/// </summary>
+	struct Statistics {
+		size_t modelCount = 0;         // 読み込み済みのモデル数
+		size_t unreferencedCount = 0;  // 参照が無く解放待ちのモデル数
+		size_t handleCount = 0;        // 有効なハンドルの総数
+		size_t loadCount = 0;          // ファイルから読み込んだ回数
+		size_t hitCount = 0;           // キャッシュから返した回数
+		size_t materialCount = 0;      // マテリアル数
+		size_t vertexBufferSize = 0;   // 頂点バッファのバイト数
+		size_t indexBufferSize = 0;    // インデックスバッファのバイト数
+		size_t constantBufferSize = 0; // マテリアルの定数バッファのバイト数
+
+		/// <summary>
+		/// GPUメモリの合計（テクスチャは TextureManager で共有されるので含めない）
+		/// </summary>
+		size_t GetTotalSize() const { return vertexBufferSize + indexBufferSize + constantBufferSize; }
+	};
+
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ModelRegistry* GetInstance();
+
+	/// <summary>
+	/// モデルの取得（未読み込みなら .obj から読み込む）
+	/// </summary>
+	/// <param name="modelName">モデル名</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <returns>ハンドル</returns>
+	static Handle Load(const std::string& modelName, bool smoothing = false);
+
+	/// <summary>
+	/// 参照が無くなったモデルを解放する
+	/// 描画中のフレームが使っているかもしれないので、参照が無くなってから同時に描画中にできるフレーム数が
+	/// 過ぎたものだけを解放する
+	/// </summary>
+	/// <returns>解放したモデル数</returns>
+	size_t CollectGarbage();
+
+	/// <summary>
+	/// 使用量の統計
+	/// </summary>
+	Statistics GetStatistics() const;
+
+private:
+	// 無効な番号
+	static const uint32_t kInvalidIndex = UINT32_MAX;
+
+	/// <summary>
+	/// 登録されたモデル
+	/// </summary>
+	struct Entry {
+		std::unique_ptr<Model> model;
+		std::string key;
+		uint32_t refCount = 0;
+		uint32_t generation = 0;
+		// 参照が無くなったフレーム
+		uint64_t releasedFrame = 0;
+		uint32_t materialCount = 0;
+		size_t vertexBufferSize = 0;
+		size_t indexBufferSize = 0;
+	};
+
+	ModelRegistry() = default;
+	~ModelRegistry() = default;
+	ModelRegistry(const ModelRegistry&) = delete;
+	ModelRegistry& operator=(const ModelRegistry&) = delete;
+
+	/// <summary>
+	/// モデルの取得
+	/// </summary>
+	Handle LoadInternal(const std::string& modelName, bool smoothing);
+
+	/// <summary>
+	/// 参照カウントの増減
+	/// </summary>
+	void AddRef(uint32_t index);
+	void Release(uint32_t index);
+
+	/// <summary>
+	/// モデルのメモリ使用量を調べる
+	/// </summary>
+	static void MeasureMemory(Entry& entry);
+
+	// 登録されたモデル（番号はハンドルが指す）
+	std::vector<Entry> entries_;
+	// 空いている番号
+	std::vector<uint32_t> freeIndices_;
+	// キー → 番号
+	std::unordered_map<std::string, uint32_t> indices_;
+	// 読み込み・キャッシュヒットの回数
+	size_t loadCount_ = 0;
+	size_t hitCount_ = 0;
+};
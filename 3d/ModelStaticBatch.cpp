@@ -0,0 +1,39 @@
+#include "DirectXCommon.h"
+#include "MathUtility.h"
+#include "Model.h"
+#include "StaticBatch.h"
+#include <cassert>
+
+void Model::DrawStaticBatch(const StaticBatch& batch, const ViewProjection& viewProjection) {
+	assert(sCommandList_);
+	std::span<const StaticBatch::DrawRange> ranges = batch.GetDrawRanges();
+	if (ranges.empty()) {
+		return;
+	}
+
+	// 頂点バッファ・インデックスバッファの設定
+	const MeshBuffer& meshBuffer = batch.GetMeshBuffer();
+	sCommandList_->IASetVertexBuffers(0, 1, &meshBuffer.GetVBView());
+	sCommandList_->IASetIndexBuffer(&meshBuffer.GetIBView());
+
+	// 頂点は変換済みなので、ワールド変換は単位行列を使い捨ての領域に書いて1回だけ設定する
+	DirectXCommon::FrameAllocation worldTransform =
+	    DirectXCommon::GetInstance()->AllocateFrameMemory(sizeof(ConstBufferDataWorldTransform));
+	static_cast<ConstBufferDataWorldTransform*>(worldTransform.data)->matWorld =
+	    MakeIdentityMatrix();
+	sCommandList_->SetGraphicsRootConstantBufferView(
+	    UINT(RoomParameter::kWorldTransform), worldTransform.address);
+	sCommandList_->SetGraphicsRootConstantBufferView(
+	    UINT(RoomParameter::kViewProjection), viewProjection.constBuff_->GetGPUVirtualAddress());
+	lightGroup->Draw(sCommandList_, UINT(RoomParameter::kLight));
+
+	Material* material = nullptr;
+	for (const StaticBatch::DrawRange& range : ranges) {
+		if (range.material != material) {
+			material = range.material;
+			material->SetGraphicsCommand(
+			    sCommandList_, UINT(RoomParameter::kMaterial), UINT(RoomParameter::kTexture));
+		}
+		sCommandList_->DrawIndexedInstanced(range.indexCount, 1, range.firstIndex, 0, 0);
+	}
+}
@@ -0,0 +1,736 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "MathUtility.h"
+#include "MeshOptimizer.h"
+#include "SimdConfig.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+namespace {
+
+// 1チャンクの最小バイト数
+const size_t kMinChunkSize = 256 * 1024;
+// スレッドあたりのチャンク数（行の偏りをならす）
+const size_t kChunksPerThread = 4;
+// 溶接用ハッシュテーブルの空きを示す値
+const uint32_t kEmptySlot = UINT32_MAX;
+// 法線平滑化の並列処理の最小単位（三角形・座標）
+const size_t kSmoothGrainSize = 8192;
+// 円周率
+const float kPi = 3.14159265f;
+// 溶接のハッシュ計算の並列処理の最小単位（頂点）
+const size_t kWeldGrainSize = 16384;
+// 溶接時に先読みする頂点数
+const size_t kWeldPrefetchDistance = 16;
+// 頂点を埋める並列処理の最小単位（面）
+const size_t kFaceGrainSize = 4096;
+// チャンク内で解決した相対インデックスを正のインデックスと区別するためのずらし量
+const int32_t kRelativeIndexBias = 1 << 30;
+
+// ディレクトリ部分（末尾の/を含む）
+std::string GetDirectory(const std::string& filePath) {
+	size_t pos = filePath.find_last_of("/\\");
+	return pos == std::string::npos ? std::string() : filePath.substr(0, pos + 1);
+}
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char* SkipSpaces(const char* cursor, const char* end) {
+	while (cursor < end && IsSpace(*cursor)) {
+		cursor++;
+	}
+	return cursor;
+}
+
+// 空白までの1語
+std::string_view ReadToken(const char*& cursor, const char* end) {
+	cursor = SkipSpaces(cursor, end);
+	const char* begin = cursor;
+	while (cursor < end && !IsSpace(*cursor)) {
+		cursor++;
+	}
+	return std::string_view(begin, size_t(cursor - begin));
+}
+
+float ReadFloat(const char*& cursor, const char* end) {
+	cursor = SkipSpaces(cursor, end);
+	// from_chars は先頭の + を受け付けない
+	if (cursor < end && *cursor == '+') {
+		cursor++;
+	}
+	float value = 0.0f;
+	cursor = std::from_chars(cursor, end, value).ptr;
+	return value;
+}
+
+// 頂点のビット列（-0 は 0 にそろえる）
+struct VertexKey {
+	uint32_t words[sizeof(MeshVertex) / sizeof(uint32_t)];
+
+	explicit VertexKey(const MeshVertex& vertex) {
+		const float values[] = {vertex.pos.x,    vertex.pos.y,    vertex.pos.z, vertex.normal.x,
+		                        vertex.normal.y, vertex.normal.z, vertex.uv.x,  vertex.uv.y};
+		static_assert(sizeof(values) == sizeof(words));
+		for (size_t i = 0; i < std::size(values); i++) {
+			std::memcpy(&words[i], &values[i], sizeof(uint32_t));
+			words[i] = words[i] == 0x80000000u ? 0 : words[i];
+		}
+	}
+
+	bool operator==(const VertexKey& other) const {
+		return std::memcmp(words, other.words, sizeof(words)) == 0;
+	}
+
+	uint64_t Hash() const {
+		uint64_t hash = 0;
+		for (uint32_t word : words) {
+			hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+			hash ^= hash >> 29;
+		}
+		return hash;
+	}
+};
+
+/// <summary>
+/// 面以外の区切り（メッシュ分割やマテリアル指定）
+/// </summary>
+struct ObjEvent {
+	enum class Type {
+		kGroup,           // g
+		kMaterial,        // usemtl
+		kMaterialLibrary, // mtllib
+	};
+	Type type;
+	std::string name;
+	// この区切りより前にあるチャンク内の面の数
+	size_t faceCount;
+};
+
+/// <summary>
+/// チャンク1つ分の解析結果
+/// 面の頂点番号は 0以上ならOBJの1始まりの通し番号、負ならチャンク内の番号 i を i - kRelativeIndexBias で持つ
+/// （負のOBJインデックスはチャンク内の数で解決し、チャンクの開始番号は結合時に足す。
+/// 前のチャンクを指す場合 i は負になる）
+/// </summary>
+struct ObjChunk {
+	std::vector<Vector3> positions;
+	std::vector<Vector2> texcoords;
+	std::vector<Vector3> normals;
+	// 面ごとの頂点数
+	std::vector<uint32_t> faceSizes;
+	// 面の各頂点の (座標, UV, 法線) 番号、0は省略
+	std::vector<int32_t> corners;
+	std::vector<ObjEvent> events;
+	// 結合時に決まる、全体での各配列の開始位置
+	size_t positionBase = 0;
+	size_t texcoordBase = 0;
+	size_t normalBase = 0;
+};
+
+// 面の頂点番号を読む
+int32_t ReadCornerIndex(const char*& cursor, const char* end, size_t localCount) {
+	int32_t index = 0;
+	cursor = std::from_chars(cursor, end, index).ptr;
+	if (index < 0) {
+		// 末尾からの相対をチャンク内の番号にして印を付ける
+		return int32_t(localCount) + index - kRelativeIndexBias;
+	}
+	return index;
+}
+
+// チャンク内の番号を全体の0始まりの番号にする（範囲外・省略は-1）
+int64_t ResolveIndex(int32_t index, size_t base, size_t count) {
+	int64_t resolved =
+	    index < 0 ? int64_t(base) + index + kRelativeIndexBias : int64_t(index) - 1;
+	return 0 <= resolved && resolved < int64_t(count) ? resolved : -1;
+}
+
+void ParseChunk(const char* cursor, const char* end, ObjChunk& chunk) {
+	while (cursor < end) {
+		const char* lineEnd =
+		    static_cast<const char*>(std::memchr(cursor, '\n', size_t(end - cursor)));
+		if (!lineEnd) {
+			lineEnd = end;
+		}
+		const char* line = cursor;
+		cursor = lineEnd + 1;
+
+		std::string_view key = ReadToken(line, lineEnd);
+		if (key == "v") {
+			Vector3& position = chunk.positions.emplace_back();
+			position.x = ReadFloat(line, lineEnd);
+			position.y = ReadFloat(line, lineEnd);
+			position.z = ReadFloat(line, lineEnd);
+		} else if (key == "vt") {
+			Vector2& texcoord = chunk.texcoords.emplace_back();
+			texcoord.x = ReadFloat(line, lineEnd);
+			// v方向反転
+			texcoord.y = 1.0f - ReadFloat(line, lineEnd);
+		} else if (key == "vn") {
+			Vector3& normal = chunk.normals.emplace_back();
+			normal.x = ReadFloat(line, lineEnd);
+			normal.y = ReadFloat(line, lineEnd);
+			normal.z = ReadFloat(line, lineEnd);
+		} else if (key == "f") {
+			// "p", "p/t", "p//n", "p/t/n"
+			uint32_t cornerCount = 0;
+			while (true) {
+				line = SkipSpaces(line, lineEnd);
+				if (line == lineEnd) {
+					break;
+				}
+				int32_t position = ReadCornerIndex(line, lineEnd, chunk.positions.size());
+				int32_t texcoord = 0;
+				int32_t normal = 0;
+				if (line < lineEnd && *line == '/') {
+					line++;
+					if (line < lineEnd && *line != '/') {
+						texcoord = ReadCornerIndex(line, lineEnd, chunk.texcoords.size());
+					}
+					if (line < lineEnd && *line == '/') {
+						line++;
+						normal = ReadCornerIndex(line, lineEnd, chunk.normals.size());
+					}
+				}
+				// 解釈できない文字は読み飛ばす
+				while (line < lineEnd && !IsSpace(*line)) {
+					line++;
+				}
+				chunk.corners.push_back(position);
+				chunk.corners.push_back(texcoord);
+				chunk.corners.push_back(normal);
+				cornerCount++;
+			}
+			if (cornerCount != 0) {
+				chunk.faceSizes.push_back(cornerCount);
+			}
+		} else if (key == "g" || key == "usemtl" || key == "mtllib") {
+			ObjEvent& event = chunk.events.emplace_back();
+			event.type = key == "g"        ? ObjEvent::Type::kGroup
+			             : key == "usemtl" ? ObjEvent::Type::kMaterial
+			                               : ObjEvent::Type::kMaterialLibrary;
+			event.name = ReadToken(line, lineEnd);
+			event.faceCount = chunk.faceSizes.size();
+		}
+	}
+}
+
+/// <summary>
+/// メッシュに詰める面の範囲
+/// </summary>
+struct ObjPiece {
+	size_t chunkIndex;
+	size_t meshIndex;
+	size_t faceBegin;
+	size_t faceEnd;
+	size_t cornerBegin;
+	size_t vertexOffset;
+	size_t indexOffset;
+};
+
+// 角度の近似 acos（誤差 7e-5 rad 程度）
+float FastAcos(float x) {
+	const float a = std::fabs(x);
+	const float r = std::sqrt((std::max)(1.0f - a, 0.0f)) *
+	                (1.5707288f + a * (-0.2121144f + a * (0.0742610f + a * -0.0187293f)));
+	return x < 0.0f ? kPi - r : r;
+}
+
+#if MATH_SIMD_SSE
+// 4要素まとめての FastAcos
+__m128 FastAcos4(__m128 x) {
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 a = _mm_andnot_ps(signMask, x);
+	__m128 polynomial = _mm_set1_ps(-0.0187293f);
+	polynomial = _mm_add_ps(_mm_mul_ps(polynomial, a), _mm_set1_ps(0.0742610f));
+	polynomial = _mm_add_ps(_mm_mul_ps(polynomial, a), _mm_set1_ps(-0.2121144f));
+	polynomial = _mm_add_ps(_mm_mul_ps(polynomial, a), _mm_set1_ps(1.5707288f));
+	const __m128 root = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a), _mm_setzero_ps()));
+	const __m128 r = _mm_mul_ps(root, polynomial);
+	const __m128 isNegative = _mm_cmplt_ps(x, _mm_setzero_ps());
+	return _mm_or_ps(
+	    _mm_and_ps(isNegative, _mm_sub_ps(_mm_set1_ps(kPi), r)), _mm_andnot_ps(isNegative, r));
+}
+
+// 3成分の単位化（長さ0はそのまま）
+void Normalize4(__m128& x, __m128& y, __m128& z) {
+	const __m128 lengthSquared =
+	    _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	const __m128 isZero = _mm_cmpeq_ps(lengthSquared, _mm_setzero_ps());
+	const __m128 inverse =
+	    _mm_andnot_ps(isZero, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared)));
+	x = _mm_mul_ps(x, inverse);
+	y = _mm_mul_ps(y, inverse);
+	z = _mm_mul_ps(z, inverse);
+}
+#endif
+
+/// <summary>
+/// 三角形 [begin, end) の単位面法線と、各頂点の内角を求める
+/// 4三角形ずつSoAに並べ替えてまとめて計算する
+/// </summary>
+void ComputeFaceWeights(
+    const MeshData& mesh, size_t begin, size_t end, Vector3* faceNormals, float* cornerAngles) {
+	const uint32_t* indices = mesh.indices.data();
+	const MeshVertex* vertices = mesh.vertices.data();
+	size_t triangle = begin;
+#if MATH_SIMD_SSE
+	for (; triangle + 4 <= end; triangle += 4) {
+		// 4三角形の頂点座標をSoAに集める
+		alignas(16) float px[3][4];
+		alignas(16) float py[3][4];
+		alignas(16) float pz[3][4];
+		for (size_t lane = 0; lane < 4; lane++) {
+			for (size_t corner = 0; corner < 3; corner++) {
+				const Vector3& position = vertices[indices[(triangle + lane) * 3 + corner]].pos;
+				px[corner][lane] = position.x;
+				py[corner][lane] = position.y;
+				pz[corner][lane] = position.z;
+			}
+		}
+		const __m128 x0 = _mm_load_ps(px[0]), y0 = _mm_load_ps(py[0]), z0 = _mm_load_ps(pz[0]);
+		const __m128 x1 = _mm_load_ps(px[1]), y1 = _mm_load_ps(py[1]), z1 = _mm_load_ps(pz[1]);
+		const __m128 x2 = _mm_load_ps(px[2]), y2 = _mm_load_ps(py[2]), z2 = _mm_load_ps(pz[2]);
+
+		// 辺ベクトル（単位化前に面法線を求める）
+		__m128 e01x = _mm_sub_ps(x1, x0), e01y = _mm_sub_ps(y1, y0), e01z = _mm_sub_ps(z1, z0);
+		__m128 e02x = _mm_sub_ps(x2, x0), e02y = _mm_sub_ps(y2, y0), e02z = _mm_sub_ps(z2, z0);
+		__m128 e12x = _mm_sub_ps(x2, x1), e12y = _mm_sub_ps(y2, y1), e12z = _mm_sub_ps(z2, z1);
+		__m128 nx = _mm_sub_ps(_mm_mul_ps(e01y, e02z), _mm_mul_ps(e01z, e02y));
+		__m128 ny = _mm_sub_ps(_mm_mul_ps(e01z, e02x), _mm_mul_ps(e01x, e02z));
+		__m128 nz = _mm_sub_ps(_mm_mul_ps(e01x, e02y), _mm_mul_ps(e01y, e02x));
+		Normalize4(nx, ny, nz);
+		Normalize4(e01x, e01y, e01z);
+		Normalize4(e02x, e02y, e02z);
+		Normalize4(e12x, e12y, e12z);
+
+		// 頂点0: e01とe02、頂点1: -e01とe12 のなす角。頂点2は残り
+		const __m128 dot0 = _mm_add_ps(
+		    _mm_add_ps(_mm_mul_ps(e01x, e02x), _mm_mul_ps(e01y, e02y)), _mm_mul_ps(e01z, e02z));
+		const __m128 dot1 = _mm_sub_ps(
+		    _mm_setzero_ps(), _mm_add_ps(
+		                          _mm_add_ps(_mm_mul_ps(e01x, e12x), _mm_mul_ps(e01y, e12y)),
+		                          _mm_mul_ps(e01z, e12z)));
+		const __m128 angle0 = FastAcos4(dot0);
+		const __m128 angle1 = FastAcos4(dot1);
+		const __m128 angle2 =
+		    _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(kPi), angle0), angle1), _mm_setzero_ps());
+
+		alignas(16) float normals[3][4];
+		alignas(16) float angles[3][4];
+		_mm_store_ps(normals[0], nx);
+		_mm_store_ps(normals[1], ny);
+		_mm_store_ps(normals[2], nz);
+		_mm_store_ps(angles[0], angle0);
+		_mm_store_ps(angles[1], angle1);
+		_mm_store_ps(angles[2], angle2);
+		for (size_t lane = 0; lane < 4; lane++) {
+			faceNormals[triangle + lane] = {normals[0][lane], normals[1][lane], normals[2][lane]};
+			for (size_t corner = 0; corner < 3; corner++) {
+				cornerAngles[(triangle + lane) * 3 + corner] = angles[corner][lane];
+			}
+		}
+	}
+#endif
+	for (; triangle < end; triangle++) {
+		const Vector3& p0 = vertices[indices[triangle * 3 + 0]].pos;
+		const Vector3& p1 = vertices[indices[triangle * 3 + 1]].pos;
+		const Vector3& p2 = vertices[indices[triangle * 3 + 2]].pos;
+		const Vector3 e01 = Normalize(p1 - p0);
+		const Vector3 e02 = Normalize(p2 - p0);
+		const Vector3 e12 = Normalize(p2 - p1);
+		faceNormals[triangle] = Normalize(Cross(p1 - p0, p2 - p0));
+		const float angle0 = FastAcos(Dot(e01, e02));
+		const float angle1 = FastAcos(-Dot(e01, e12));
+		cornerAngles[triangle * 3 + 0] = angle0;
+		cornerAngles[triangle * 3 + 1] = angle1;
+		cornerAngles[triangle * 3 + 2] = (std::max)(kPi - angle0 - angle1, 0.0f);
+	}
+}
+
+} // namespace
+
+bool ObjLoader::Load(const std::string& filePath, bool smoothing, ModelData& modelData) {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	const std::string directoryPath = GetDirectory(filePath);
+	const char* text = reinterpret_cast<const char*>(file.GetData());
+	const size_t size = file.GetSize();
+
+	// 行の途中で切らないようにチャンクへ分割する
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	const size_t threadCount = threadPool->GetWorkerCount() + 1;
+	const size_t chunkSize = (std::max)(kMinChunkSize, size / (threadCount * kChunksPerThread) + 1);
+	std::vector<size_t> chunkOffsets = {0};
+	while (chunkOffsets.back() < size) {
+		size_t offset = (std::min)(chunkOffsets.back() + chunkSize, size);
+		while (offset < size && text[offset - 1] != '\n') {
+			offset++;
+		}
+		chunkOffsets.push_back(offset);
+	}
+	const size_t chunkCount = chunkOffsets.size() - 1;
+
+	// 各チャンクを並列に解析
+	std::vector<ObjChunk> chunks(chunkCount);
+	threadPool->ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			ParseChunk(text + chunkOffsets[i], text + chunkOffsets[i + 1], chunks[i]);
+		}
+	});
+
+	// 頂点属性を結合（1回の確保で全体をまとめる）
+	size_t positionCount = 0;
+	size_t texcoordCount = 0;
+	size_t normalCount = 0;
+	for (ObjChunk& chunk : chunks) {
+		chunk.positionBase = positionCount;
+		chunk.texcoordBase = texcoordCount;
+		chunk.normalBase = normalCount;
+		positionCount += chunk.positions.size();
+		texcoordCount += chunk.texcoords.size();
+		normalCount += chunk.normals.size();
+	}
+	std::vector<Vector3> positions(positionCount);
+	std::vector<Vector2> texcoords(texcoordCount);
+	std::vector<Vector3> normals(normalCount);
+	threadPool->ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			ObjChunk& chunk = chunks[i];
+			std::copy(
+			    chunk.positions.begin(), chunk.positions.end(),
+			    positions.begin() + ptrdiff_t(chunk.positionBase));
+			std::copy(
+			    chunk.texcoords.begin(), chunk.texcoords.end(),
+			    texcoords.begin() + ptrdiff_t(chunk.texcoordBase));
+			std::copy(
+			    chunk.normals.begin(), chunk.normals.end(),
+			    normals.begin() + ptrdiff_t(chunk.normalBase));
+			chunk.positions = {};
+			chunk.texcoords = {};
+			chunk.normals = {};
+		}
+	});
+
+	// 区切りを順に辿ってメッシュへの割り当てを決める（Model::LoadModel と同じ規則）
+	modelData = ModelData{};
+	std::vector<ObjPiece> pieces;
+	std::vector<size_t> vertexCounts;
+	std::vector<size_t> indexCounts;
+	MeshData mesh;
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	auto finishMesh = [&]() {
+		if (vertexCount == 0) {
+			return;
+		}
+		modelData.meshes.push_back(std::move(mesh));
+		vertexCounts.push_back(vertexCount);
+		indexCounts.push_back(indexCount);
+		mesh = MeshData{};
+		vertexCount = 0;
+		indexCount = 0;
+	};
+	for (size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++) {
+		const ObjChunk& chunk = chunks[chunkIndex];
+		size_t faceBegin = 0;
+		size_t cornerBegin = 0;
+		auto addFaces = [&](size_t faceEnd) {
+			if (faceEnd == faceBegin) {
+				return;
+			}
+			ObjPiece piece{chunkIndex, modelData.meshes.size(), faceBegin, faceEnd, cornerBegin,
+			               vertexCount, indexCount};
+			for (size_t face = faceBegin; face < faceEnd; face++) {
+				vertexCount += chunk.faceSizes[face];
+				indexCount += (size_t((std::max)(chunk.faceSizes[face], 2u)) - 2) * 3;
+			}
+			cornerBegin += vertexCount - piece.vertexOffset;
+			faceBegin = faceEnd;
+			pieces.push_back(piece);
+		};
+		for (const ObjEvent& event : chunk.events) {
+			addFaces(event.faceCount);
+			switch (event.type) {
+			case ObjEvent::Type::kGroup:
+				// カレントメッシュの情報が揃っているなら確定して次のメッシュへ
+				finishMesh();
+				mesh.name = event.name;
+				break;
+			case ObjEvent::Type::kMaterial:
+				// 最初に指定されたマテリアルを使う
+				if (mesh.materialName.empty()) {
+					mesh.materialName = event.name;
+				}
+				break;
+			case ObjEvent::Type::kMaterialLibrary:
+				modelData.materialLibraries.push_back(event.name);
+				LoadMaterials(directoryPath + event.name, modelData.materials);
+				break;
+			}
+		}
+		addFaces(chunk.faceSizes.size());
+	}
+	finishMesh();
+
+	// メッシュごとに1回だけ確保する
+	std::vector<std::vector<uint32_t>> positionIndices(smoothing ? modelData.meshes.size() : 0);
+	for (size_t i = 0; i < modelData.meshes.size(); i++) {
+		modelData.meshes[i].vertices.resize(vertexCounts[i]);
+		modelData.meshes[i].indices.resize(indexCounts[i]);
+		if (smoothing) {
+			positionIndices[i].resize(vertexCounts[i]);
+		}
+	}
+
+	// 頂点とインデックスを並列に埋める（面は扇状に三角形分割）
+	for (const ObjPiece& piece : pieces) {
+		const ObjChunk& chunk = chunks[piece.chunkIndex];
+		MeshData& target = modelData.meshes[piece.meshIndex];
+		uint32_t* pieceIndices = smoothing ? positionIndices[piece.meshIndex].data() : nullptr;
+
+		// 面ごとの書き込み位置が分かるよう、先に区間の先頭を数えておく
+		const size_t faceCount = piece.faceEnd - piece.faceBegin;
+		const size_t blockCount = (faceCount + kFaceGrainSize - 1) / kFaceGrainSize;
+		std::vector<size_t> blockCorners(blockCount + 1, 0);
+		std::vector<size_t> blockIndices(blockCount + 1, 0);
+		for (size_t block = 0; block < blockCount; block++) {
+			size_t corners = 0;
+			size_t indices = 0;
+			size_t last = (std::min)(piece.faceBegin + (block + 1) * kFaceGrainSize, piece.faceEnd);
+			for (size_t face = piece.faceBegin + block * kFaceGrainSize; face < last; face++) {
+				corners += chunk.faceSizes[face];
+				indices += (size_t((std::max)(chunk.faceSizes[face], 2u)) - 2) * 3;
+			}
+			blockCorners[block + 1] = blockCorners[block] + corners;
+			blockIndices[block + 1] = blockIndices[block] + indices;
+		}
+
+		threadPool->ParallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+			for (size_t block = begin; block < end; block++) {
+				size_t corner = piece.cornerBegin + blockCorners[block];
+				size_t vertexIndex = piece.vertexOffset + blockCorners[block];
+				size_t indexIndex = piece.indexOffset + blockIndices[block];
+				size_t last = (std::min)(piece.faceBegin + (block + 1) * kFaceGrainSize, piece.faceEnd);
+				for (size_t face = piece.faceBegin + block * kFaceGrainSize; face < last; face++) {
+					const uint32_t firstVertex = uint32_t(vertexIndex);
+					for (uint32_t i = 0; i < chunk.faceSizes[face]; i++, corner++, vertexIndex++) {
+						const int32_t* indices = &chunk.corners[corner * 3];
+						MeshVertex& vertex = target.vertices[vertexIndex];
+						int64_t position = ResolveIndex(indices[0], chunk.positionBase, positionCount);
+						int64_t texcoord = ResolveIndex(indices[1], chunk.texcoordBase, texcoordCount);
+						int64_t normal = ResolveIndex(indices[2], chunk.normalBase, normalCount);
+						vertex.pos = 0 <= position ? positions[size_t(position)] : Vector3{};
+						vertex.uv = 0 <= texcoord ? texcoords[size_t(texcoord)] : Vector2{};
+						vertex.normal = 0 <= normal ? normals[size_t(normal)] : Vector3{};
+						if (pieceIndices) {
+							pieceIndices[vertexIndex] = uint32_t(position);
+						}
+						// 3頂点目以降は 先頭・直前・自身 で三角形を追加する
+						if (2 <= i) {
+							target.indices[indexIndex++] = firstVertex;
+							target.indices[indexIndex++] = uint32_t(vertexIndex - 1);
+							target.indices[indexIndex++] = uint32_t(vertexIndex);
+						}
+					}
+				}
+			}
+		});
+	}
+
+	for (size_t i = 0; i < modelData.meshes.size(); i++) {
+		MeshData& target = modelData.meshes[i];
+		if (smoothing) {
+			SmoothNormals(target, positionIndices[i]);
+		}
+		WeldVertices(target);
+		MeshOptimizer::Optimize(target);
+		target.bounds =
+		    ComputeAABB(target.vertices.data(), target.vertices.size(), sizeof(MeshVertex));
+	}
+	return true;
+}
+
+bool ObjLoader::LoadMaterials(const std::string& filePath, std::vector<MaterialData>& materials) {
+	std::ifstream file(filePath);
+	if (file.fail()) {
+		return false;
+	}
+
+	MaterialData* material = nullptr;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream lineStream(line);
+		std::string key;
+		lineStream >> key;
+
+		if (key == "newmtl") {
+			material = &materials.emplace_back();
+			lineStream >> material->name;
+		} else if (material == nullptr) {
+			continue;
+		} else if (key == "Ka") {
+			lineStream >> material->ambient.x >> material->ambient.y >> material->ambient.z;
+		} else if (key == "Kd") {
+			lineStream >> material->diffuse.x >> material->diffuse.y >> material->diffuse.z;
+		} else if (key == "Ks") {
+			lineStream >> material->specular.x >> material->specular.y >> material->specular.z;
+		} else if (key == "d") {
+			lineStream >> material->alpha;
+		} else if (key == "map_Kd") {
+			// テクスチャはファイル名だけ持ち、ディレクトリは読み込み側で付ける
+			std::string texturePath;
+			lineStream >> texturePath;
+			size_t pos = texturePath.find_last_of("/\\");
+			material->textureFilename =
+			    pos == std::string::npos ? texturePath : texturePath.substr(pos + 1);
+		}
+	}
+	return true;
+}
+
+void ObjLoader::SmoothNormals(MeshData& mesh, const std::vector<uint32_t>& positionIndices) {
+	const size_t triangleCount = mesh.indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+
+	// 三角形ごとの面法線と、各頂点の角度（重み）を求める
+	std::vector<Vector3> faceNormals(triangleCount);
+	std::vector<float> cornerAngles(triangleCount * 3);
+	threadPool->ParallelFor(triangleCount, kSmoothGrainSize, [&](size_t begin, size_t end) {
+		ComputeFaceWeights(mesh, begin, end, faceNormals.data(), cornerAngles.data());
+	});
+
+	// 座標番号 → 三角形の頂点 の隣接情報（CSR）を作る
+	uint32_t minPosition = UINT32_MAX;
+	uint32_t maxPosition = 0;
+	for (uint32_t position : positionIndices) {
+		if (position != UINT32_MAX) {
+			minPosition = (std::min)(minPosition, position);
+			maxPosition = (std::max)(maxPosition, position);
+		}
+	}
+	if (maxPosition < minPosition) {
+		return;
+	}
+	const size_t positionCount = size_t(maxPosition - minPosition) + 1;
+	std::vector<uint32_t> offsets(positionCount + 1, 0);
+	for (uint32_t index : mesh.indices) {
+		if (positionIndices[index] != UINT32_MAX) {
+			offsets[positionIndices[index] - minPosition + 1]++;
+		}
+	}
+	for (size_t i = 0; i < positionCount; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+	std::vector<uint32_t> corners(offsets.back());
+	{
+		std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+		for (size_t corner = 0; corner < mesh.indices.size(); corner++) {
+			uint32_t position = positionIndices[mesh.indices[corner]];
+			if (position != UINT32_MAX) {
+				corners[cursors[position - minPosition]++] = uint32_t(corner);
+			}
+		}
+	}
+
+	// 同じ座標を共有する頂点ごとに、角度で重み付けした面法線を合計する
+	// 面法線の向きは読み込んだ法線に合わせる（巻き順や座標系の違いで裏返らないように）
+	threadPool->ParallelFor(positionCount, kSmoothGrainSize, [&](size_t begin, size_t end) {
+		for (size_t position = begin; position < end; position++) {
+			const uint32_t first = offsets[position];
+			const uint32_t last = offsets[position + 1];
+			if (first == last) {
+				continue;
+			}
+			Vector3 normal = {0.0f, 0.0f, 0.0f};
+			for (uint32_t i = first; i < last; i++) {
+				const uint32_t corner = corners[i];
+				const Vector3& faceNormal = faceNormals[corner / 3];
+				const Vector3& vertexNormal = mesh.vertices[mesh.indices[corner]].normal;
+				const float weight = Dot(faceNormal, vertexNormal) < 0.0f ? -cornerAngles[corner]
+				                                                           : cornerAngles[corner];
+				normal += faceNormal * weight;
+			}
+			const float length = Length(normal);
+			if (length <= 0.0f) {
+				continue;
+			}
+			normal = normal * (1.0f / length);
+			for (uint32_t i = first; i < last; i++) {
+				mesh.vertices[mesh.indices[corners[i]]].normal = normal;
+			}
+		}
+	});
+}
+
+void ObjLoader::WeldVertices(MeshData& mesh) {
+	const size_t vertexCount = mesh.vertices.size();
+	if (vertexCount == 0) {
+		return;
+	}
+
+	// 開番地法のハッシュテーブル（埋まり具合は半分以下）
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2) {
+		tableSize <<= 1;
+	}
+	const size_t mask = tableSize - 1;
+	std::vector<uint32_t> table(tableSize, kEmptySlot);
+
+	// ハッシュは並列に先に求めておく
+	std::vector<uint64_t> hashes(vertexCount);
+	ThreadPool::GetInstance()->ParallelFor(vertexCount, kWeldGrainSize, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			hashes[i] = VertexKey(mesh.vertices[i]).Hash();
+		}
+	});
+
+	// 最初に現れた頂点を残し、前へ詰める（詰めた頂点のハッシュも前へ詰める）
+	std::vector<uint32_t> remap(vertexCount);
+	uint32_t uniqueCount = 0;
+	for (size_t i = 0; i < vertexCount; i++) {
+#if MATH_SIMD_SSE
+		// テーブルは大きくキャッシュに載らないので、少し先のスロットを読み込んでおく
+		if (i + kWeldPrefetchDistance < vertexCount) {
+			_mm_prefetch(
+			    reinterpret_cast<const char*>(
+			        &table[size_t(hashes[i + kWeldPrefetchDistance]) & mask]),
+			    _MM_HINT_T0);
+		}
+#endif
+		const uint64_t hash = hashes[i];
+		const VertexKey key(mesh.vertices[i]);
+		size_t slot = size_t(hash) & mask;
+		while (table[slot] != kEmptySlot) {
+			uint32_t entry = table[slot];
+			if (hashes[entry] == hash && VertexKey(mesh.vertices[entry]) == key) {
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+		if (table[slot] == kEmptySlot) {
+			table[slot] = uniqueCount;
+			hashes[uniqueCount] = hash;
+			mesh.vertices[uniqueCount++] = mesh.vertices[i];
+		}
+		remap[i] = table[slot];
+	}
+
+	mesh.vertices.resize(uniqueCount);
+	mesh.vertices.shrink_to_fit();
+	for (uint32_t& index : mesh.indices) {
+		index = remap[index];
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "MeshData.h"
+#include <string>
+
+/// <summary>
+/// OBJファイル読み込み
+/// Model::LoadModel と同じ解釈（g でメッシュ分割、usemtl でマテリアル割り当て、vt の v 反転）で
+/// GPUに依存しないモデルデータを作る。
+/// ファイルをメモリマップして行単位のチャンクに分け、ワーカースレッドで並列に解析してから結合する。
+/// 面の頂点ごとに作った頂点は、同じ値のものを溶接して共有し、描画順を MeshOptimizer で最適化する。
+/// Model::LoadModel はエンジンのライブラリの実装のままなので、溶接と16/32bitインデックスの選択は
+/// MeshCache と MeshBuffer を通して読み込んだメッシュにだけ効く
+/// </summary>
+class ObjLoader {
+public:
+	/// <summary>
+	/// 読み込み
+	/// </summary>
+	/// <param name="filePath">.objファイルのパス</param>
+	/// <param name="smoothing">エッジ平滑化フラグ</param>
+	/// <param name="modelData">出力先</param>
+	/// <returns>成否</returns>
+	static bool Load(const std::string& filePath, bool smoothing, ModelData& modelData);
+
+	/// <summary>
+	/// マテリアル読み込み
+	/// </summary>
+	/// <param name="filePath">.mtlファイルのパス</param>
+	/// <param name="materials">追加先</param>
+	/// <returns>成否</returns>
+	static bool LoadMaterials(const std::string& filePath, std::vector<MaterialData>& materials);
+
+	/// <summary>
+	/// 同じ座標を共有する頂点の法線を、内角で重み付けした面法線の和にする
+	/// （Mesh::CalculateSmoothedVertexNormals 相当。面法線の向きは読み込んだ法線に合わせる）
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	/// <param name="positionIndices">頂点ごとの元の座標番号</param>
+	static void SmoothNormals(MeshData& mesh, const std::vector<uint32_t>& positionIndices);
+
+	/// <summary>
+	/// 座標・法線・UVが全て一致する頂点を1つにまとめ、インデックスを付け替える
+	/// </summary>
+	/// <param name="mesh">メッシュ</param>
+	static void WeldVertices(MeshData& mesh);
+};
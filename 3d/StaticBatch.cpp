@@ -0,0 +1,175 @@
+#include "StaticBatch.h"
+#include "MathUtility.h"
+#include "Model.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+// 並列に変換する単位（メッシュ数）
+const size_t kBakeGrainSize = 16;
+
+// マテリアルを見分けるキー（同じキーのマテリアルは同じ描画結果になる）
+std::string MakeMaterialKey(Material* material, bool mergeEquivalentMaterials) {
+	std::string key;
+	auto append = [&key](const void* data, size_t size) {
+		key.append(static_cast<const char*>(data), size);
+	};
+	if (!mergeEquivalentMaterials) {
+		append(&material, sizeof(material));
+		return key;
+	}
+	const uint32_t textureHandle = material->GetTextureHadle();
+	append(&textureHandle, sizeof(textureHandle));
+	append(&material->ambient_, sizeof(Vector3));
+	append(&material->diffuse_, sizeof(Vector3));
+	append(&material->specular_, sizeof(Vector3));
+	append(&material->uvScale_, sizeof(Vector3));
+	append(&material->uvOffset_, sizeof(Vector3));
+	append(&material->alpha_, sizeof(float));
+	return key;
+}
+
+// 行列の3x3部分の行列式（負なら裏返る）
+float Determinant3x3(const Matrix4x4& m) {
+	return m.m[0][0] * (m.m[1][1] * m.m[2][2] - m.m[1][2] * m.m[2][1]) -
+	       m.m[0][1] * (m.m[1][0] * m.m[2][2] - m.m[1][2] * m.m[2][0]) +
+	       m.m[0][2] * (m.m[1][0] * m.m[2][1] - m.m[1][1] * m.m[2][0]);
+}
+
+} // namespace
+
+void StaticBatch::Add(Model* model, const Matrix4x4& world) {
+	assert(model);
+	placements_.push_back({model, world});
+}
+
+void StaticBatch::Build(const Options& options) {
+	ranges_.clear();
+	statistics_ = Statistics();
+	statistics_.placementCount = placements_.size();
+
+	// まとめる単位
+	struct Group {
+		Material* material;
+		uint32_t order;
+		size_t vertexCount = 0;
+		size_t indexCount = 0;
+		size_t vertexOffset = 0;
+		size_t indexOffset = 0;
+	};
+	// まとめる前のメッシュ
+	struct Source {
+		const Placement* placement;
+		Mesh* mesh;
+		uint32_t group;
+		size_t vertexOffset;
+		size_t indexOffset;
+	};
+	std::vector<Group> groups;
+	std::vector<Source> sources;
+	std::unordered_map<std::string, uint32_t> groupIndices;
+	for (const Placement& placement : placements_) {
+		for (Mesh* mesh : placement.model->GetMeshes()) {
+			Material* material = mesh->GetMaterial();
+			if (mesh->GetIndices().empty() || !material) {
+				continue;
+			}
+			auto [it, isInserted] = groupIndices.try_emplace(
+			    MakeMaterialKey(material, options.mergeEquivalentMaterials),
+			    uint32_t(groups.size()));
+			if (isInserted) {
+				groups.push_back({material, uint32_t(groups.size())});
+			}
+			Group& group = groups[it->second];
+			sources.push_back({&placement, mesh, it->second, group.vertexCount, group.indexCount});
+			group.vertexCount += mesh->GetVertices().size();
+			group.indexCount += mesh->GetIndices().size();
+		}
+	}
+	statistics_.sourceMeshCount = sources.size();
+	if (sources.empty()) {
+		return;
+	}
+
+	// テクスチャの切り替えが減るようにテクスチャ・追加順で並べ、その順にバッファへ詰める
+	std::vector<uint32_t> sortedGroups(groups.size());
+	for (uint32_t i = 0; i < groups.size(); i++) {
+		sortedGroups[i] = i;
+	}
+	std::sort(sortedGroups.begin(), sortedGroups.end(), [&groups](uint32_t lhs, uint32_t rhs) {
+		const uint32_t lhsTexture = groups[lhs].material->GetTextureHadle();
+		const uint32_t rhsTexture = groups[rhs].material->GetTextureHadle();
+		return lhsTexture != rhsTexture ? lhsTexture < rhsTexture
+		                                : groups[lhs].order < groups[rhs].order;
+	});
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (uint32_t index : sortedGroups) {
+		Group& group = groups[index];
+		group.vertexOffset = vertexCount;
+		group.indexOffset = indexCount;
+		vertexCount += group.vertexCount;
+		indexCount += group.indexCount;
+		assert(indexCount <= UINT32_MAX);
+		ranges_.push_back(
+		    {group.material, uint32_t(group.indexOffset), uint32_t(group.indexCount)});
+	}
+	assert(vertexCount <= UINT32_MAX);
+
+	// 頂点をワールド座標へ変換して詰める
+	MeshData merged;
+	merged.vertices.resize(vertexCount);
+	merged.indices.resize(indexCount);
+	ThreadPool::GetInstance()->ParallelFor(
+	    sources.size(), kBakeGrainSize, [&](size_t begin, size_t end) {
+		    for (size_t i = begin; i < end; i++) {
+			    const Source& source = sources[i];
+			    const Group& group = groups[source.group];
+			    const Matrix4x4& world = source.placement->world;
+			    // 法線は逆転置行列で変換する
+			    const Matrix4x4 normalMatrix = Transpose(Inverse(world));
+			    const bool isMirrored = Determinant3x3(world) < 0.0f;
+
+			    const std::vector<Mesh::VertexPosNormalUv>& vertices = source.mesh->GetVertices();
+			    MeshVertex* dstVertices =
+			        merged.vertices.data() + group.vertexOffset + source.vertexOffset;
+			    for (size_t v = 0; v < vertices.size(); v++) {
+				    dstVertices[v].pos = TransformPoint(vertices[v].pos, world);
+				    dstVertices[v].normal =
+				        Normalize(TransformNormal(vertices[v].normal, normalMatrix));
+				    dstVertices[v].uv = vertices[v].uv;
+			    }
+
+			    const std::vector<unsigned short>& indices = source.mesh->GetIndices();
+			    uint32_t* dstIndices = merged.indices.data() + group.indexOffset + source.indexOffset;
+			    const uint32_t baseVertex = uint32_t(group.vertexOffset + source.vertexOffset);
+			    for (size_t corner = 0; corner < indices.size(); corner++) {
+				    dstIndices[corner] = baseVertex + indices[corner];
+			    }
+			    // 鏡像の配置は表裏が逆になるので巻き順を戻す
+			    if (isMirrored) {
+				    for (size_t corner = 0; corner + 2 < indices.size(); corner += 3) {
+					    std::swap(dstIndices[corner + 1], dstIndices[corner + 2]);
+				    }
+			    }
+		    }
+	    });
+	merged.bounds = ComputeAABB(merged.vertices.data(), vertexCount, sizeof(MeshVertex));
+	meshBuffer_.Create(merged);
+
+	statistics_.drawCount = ranges_.size();
+	statistics_.vertexCount = vertexCount;
+	statistics_.indexCount = indexCount;
+}
+
+void StaticBatch::Clear() {
+	placements_.clear();
+	ranges_.clear();
+	meshBuffer_ = MeshBuffer();
+	statistics_ = Statistics();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "MeshBuffer.h"
+#include "WorldTransform.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class Material;
+class Model;
+
+/// <summary>
+/// 静的なモデルのまとめ描画
+/// 配置したモデルのメッシュをワールド行列で変換して1本の頂点・インデックスバッファにまとめ、
+/// 同じマテリアルのメッシュを1つの描画範囲にする。描画範囲はテクスチャ・マテリアルの順に並べる。
+/// Model::PreDraw の後に Model::DrawStaticBatch で描画する
+/// </summary>
+class StaticBatch {
+public:
+	/// <summary>
+	/// まとめ方の設定
+	/// </summary>
+	struct Options {
+		// 別のモデルのマテリアルでも、テクスチャと定数が同じなら1つにまとめる
+		bool mergeEquivalentMaterials = true;
+	};
+
+	/// <summary>
+	/// 同じマテリアルで描画するインデックスの範囲
+	/// </summary>
+	struct DrawRange {
+		Material* material;  // マテリアル
+		uint32_t firstIndex; // 先頭
+		uint32_t indexCount; // インデックス数
+	};
+
+	/// <summary>
+	/// まとめた結果の集計
+	/// </summary>
+	struct Statistics {
+		size_t placementCount = 0;  // 配置数
+		size_t sourceMeshCount = 0; // まとめたメッシュ数（まとめなければ描画回数）
+		size_t drawCount = 0;       // 描画範囲の数
+		size_t vertexCount = 0;     // 頂点数
+		size_t indexCount = 0;      // インデックス数
+	};
+
+	/// <summary>
+	/// モデルの配置の追加
+	/// </summary>
+	/// <param name="model">モデル（描画範囲がマテリアルを参照するので、描画する間は破棄しない）</param>
+	/// <param name="world">ワールド行列</param>
+	void Add(Model* model, const Matrix4x4& world);
+
+	/// <summary>
+	/// モデルの配置の追加（計算済みの matWorld_ を使う）
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="worldTransform">ワールドトランスフォーム</param>
+	void Add(Model* model, const WorldTransform& worldTransform) {
+		Add(model, worldTransform.matWorld_);
+	}
+
+	/// <summary>
+	/// 追加した配置をまとめてバッファを作る
+	/// </summary>
+	/// <param name="options">設定</param>
+	void Build(const Options& options);
+
+	/// <summary>
+	/// 追加した配置を既定の設定でまとめてバッファを作る
+	/// </summary>
+	void Build() { Build(Options()); }
+
+	/// <summary>
+	/// 配置とバッファを破棄する
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 描画範囲（Build後に有効）
+	/// </summary>
+	std::span<const DrawRange> GetDrawRanges() const { return ranges_; }
+
+	const MeshBuffer& GetMeshBuffer() const { return meshBuffer_; }
+
+	const Statistics& GetStatistics() const { return statistics_; }
+
+private:
+	// モデルの配置
+	struct Placement {
+		Model* model;
+		Matrix4x4 world;
+	};
+
+	// 配置
+	std::vector<Placement> placements_;
+	// 描画範囲
+	std::vector<DrawRange> ranges_;
+	// まとめたバッファ
+	MeshBuffer meshBuffer_;
+	// 集計
+	Statistics statistics_;
+};
@@ -0,0 +1,224 @@
+#include "TransformHierarchy.h"
+#include "MathUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+
+TransformHierarchy::Handle TransformHierarchy::Create(Handle parent) {
+	assert(parent == kInvalidHandle || (parent < parents_.size() && alive_[parent]));
+
+	Handle handle;
+	if (!freeList_.empty()) {
+		handle = freeList_.back();
+		freeList_.pop_back();
+	} else {
+		handle = Handle(parents_.size());
+		scales_.emplace_back();
+		rotations_.emplace_back();
+		translations_.emplace_back();
+		worldMatrices_.push_back(MakeIdentityMatrix());
+		parents_.push_back(kInvalidHandle);
+		dirty_.push_back(0);
+		updated_.push_back(0);
+		alive_.push_back(0);
+		pendingOutputs_.push_back(0);
+		childCounts_.push_back(0);
+	}
+
+	scales_[handle] = {1.0f, 1.0f, 1.0f};
+	rotations_[handle] = {0.0f, 0.0f, 0.0f};
+	translations_[handle] = {0.0f, 0.0f, 0.0f};
+	parents_[handle] = parent;
+	dirty_[handle] = 1;
+	alive_[handle] = 1;
+	childCounts_[handle] = 0;
+	if (parent != kInvalidHandle) {
+		childCounts_[parent]++;
+	}
+	isOrderDirty_ = true;
+	return handle;
+}
+
+void TransformHierarchy::Destroy(Handle handle) {
+	assert(handle < parents_.size() && alive_[handle]);
+	// 子が残っていると親が無効になるので禁止
+	assert(childCounts_[handle] == 0);
+
+	if (parents_[handle] != kInvalidHandle) {
+		childCounts_[parents_[handle]]--;
+	}
+	parents_[handle] = kInvalidHandle;
+	alive_[handle] = 0;
+	dirty_[handle] = 0;
+	updated_[handle] = 0;
+	pendingOutputs_[handle] = 0;
+	freeList_.push_back(handle);
+	isOrderDirty_ = true;
+}
+
+bool TransformHierarchy::SetParent(Handle handle, Handle parent) {
+	assert(handle < parents_.size() && alive_[handle]);
+	assert(parent == kInvalidHandle || (parent < parents_.size() && alive_[parent]));
+
+	if (parents_[handle] == parent) {
+		return true;
+	}
+	// 自身か子孫を親にすると循環するので断る（親から根まで辿って自身が現れるか）
+	for (Handle ancestor = parent; ancestor != kInvalidHandle; ancestor = parents_[ancestor]) {
+		if (ancestor == handle) {
+			return false;
+		}
+	}
+	if (parents_[handle] != kInvalidHandle) {
+		childCounts_[parents_[handle]]--;
+	}
+	if (parent != kInvalidHandle) {
+		childCounts_[parent]++;
+	}
+	parents_[handle] = parent;
+	dirty_[handle] = 1;
+	isOrderDirty_ = true;
+	return true;
+}
+
+void TransformHierarchy::SetScale(Handle handle, const Vector3& scale) {
+	scales_[handle] = scale;
+	dirty_[handle] = 1;
+}
+
+void TransformHierarchy::SetRotation(Handle handle, const Vector3& rotation) {
+	rotations_[handle] = rotation;
+	dirty_[handle] = 1;
+}
+
+void TransformHierarchy::SetTranslation(Handle handle, const Vector3& translation) {
+	translations_[handle] = translation;
+	dirty_[handle] = 1;
+}
+
+void TransformHierarchy::SetOutputBuffer(void* mappedAddress, size_t capacity, size_t stride) {
+	SetOutputBuffers(&mappedAddress, mappedAddress ? 1 : 0, capacity, stride);
+}
+
+void TransformHierarchy::SetOutputBuffers(
+    void* const* mappedAddresses, size_t bufferCount, size_t capacity, size_t stride) {
+	assert(sizeof(Matrix4x4) <= stride);
+	assert(bufferCount <= kMaxOutputBufferCount);
+	outputAddresses_.resize(bufferCount);
+	for (size_t i = 0; i < bufferCount; i++) {
+		outputAddresses_[i] = static_cast<uint8_t*>(mappedAddresses[i]);
+	}
+	outputIndex_ = 0;
+	outputCapacity_ = capacity;
+	outputStride_ = stride;
+
+	// 新しいバッファには何も書かれていないので、全ノードを全バッファへ書き直す
+	const uint8_t allOutputs = uint8_t((1u << bufferCount) - 1);
+	for (size_t i = 0; i < pendingOutputs_.size(); i++) {
+		pendingOutputs_[i] = alive_[i] ? allOutputs : 0;
+	}
+}
+
+void TransformHierarchy::SetOutputIndex(size_t index) {
+	assert(index < outputAddresses_.size());
+	outputIndex_ = index;
+}
+
+void TransformHierarchy::Update() {
+	if (isOrderDirty_) {
+		SortTopologically();
+	}
+
+	std::atomic<size_t> updatedCount = 0;
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	// 同じ階層のノード同士は依存しないので、階層ごとに並列処理する
+	for (size_t level = 0; level + 1 < levelOffsets_.size(); level++) {
+		const size_t begin = levelOffsets_[level];
+		const size_t count = levelOffsets_[level + 1] - begin;
+		threadPool->ParallelFor(count, kGrainSize, [&](size_t first, size_t last) {
+			size_t updated = 0;
+			for (size_t i = begin + first; i < begin + last; i++) {
+				Handle handle = sortedHandles_[i];
+				UpdateNode(handle);
+				updated += updated_[handle];
+			}
+			updatedCount += updated;
+		});
+	}
+	updatedCount_ = updatedCount;
+}
+
+void TransformHierarchy::SortTopologically() {
+	const size_t capacity = parents_.size();
+
+	// 各ノードの深さを求める（親を辿ってメモ化。SetParent で循環を断っているので根に着く）
+	static const uint32_t kUnknownDepth = UINT32_MAX;
+	std::vector<uint32_t> depths(capacity, kUnknownDepth);
+	std::vector<Handle> stack;
+	uint32_t maxDepth = 0;
+	for (Handle handle = 0; handle < capacity; handle++) {
+		if (!alive_[handle] || depths[handle] != kUnknownDepth) {
+			continue;
+		}
+		Handle current = handle;
+		while (current != kInvalidHandle && depths[current] == kUnknownDepth) {
+			stack.push_back(current);
+			current = parents_[current];
+		}
+		uint32_t depth = current == kInvalidHandle ? 0 : depths[current] + 1;
+		while (!stack.empty()) {
+			depths[stack.back()] = depth++;
+			stack.pop_back();
+		}
+		maxDepth = std::max(maxDepth, depth - 1);
+	}
+
+	// 深さごとの数え上げソート
+	levelOffsets_.assign(size_t(maxDepth) + 2, 0);
+	for (Handle handle = 0; handle < capacity; handle++) {
+		if (alive_[handle]) {
+			levelOffsets_[size_t(depths[handle]) + 1]++;
+		}
+	}
+	for (size_t level = 1; level < levelOffsets_.size(); level++) {
+		levelOffsets_[level] += levelOffsets_[level - 1];
+	}
+	std::vector<size_t> cursors(levelOffsets_.begin(), levelOffsets_.end() - 1);
+	sortedHandles_.resize(levelOffsets_.back());
+	for (Handle handle = 0; handle < capacity; handle++) {
+		if (alive_[handle]) {
+			sortedHandles_[cursors[depths[handle]]++] = handle;
+		}
+	}
+
+	isOrderDirty_ = false;
+}
+
+void TransformHierarchy::UpdateNode(Handle handle) {
+	const Handle parent = parents_[handle];
+	// 自身が変更されたか、親が今回再計算された場合のみ計算する
+	const bool isChanged = dirty_[handle] || (parent != kInvalidHandle && updated_[parent]);
+	if (isChanged) {
+		Matrix4x4 world =
+		    MakeAffineMatrix(scales_[handle], rotations_[handle], translations_[handle]);
+		if (parent != kInvalidHandle) {
+			world = world * worldMatrices_[parent];
+		}
+		worldMatrices_[handle] = world;
+		pendingOutputs_[handle] = uint8_t((1u << outputAddresses_.size()) - 1);
+	}
+
+	// 今のバッファが前に書いた後で変わっていれば書き込む（他のバッファはそれぞれの番で書く）
+	const uint8_t outputBit = uint8_t(1u << outputIndex_);
+	if ((pendingOutputs_[handle] & outputBit) && handle < outputCapacity_) {
+		std::memcpy(
+		    outputAddresses_[outputIndex_] + GetOffset(handle), &worldMatrices_[handle],
+		    sizeof(Matrix4x4));
+		pendingOutputs_[handle] &= uint8_t(~outputBit);
+	}
+
+	dirty_[handle] = 0;
+	updated_[handle] = isChanged;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// ワールド変換の一括管理
+/// スケール・回転・平行移動をSoA配列で持ち、親子順に並べて変更のあった部分木だけを並列に再計算する。
+/// 計算したワールド行列はマップ済みバッファへオブジェクトごとのオフセットで書き込む。
+/// 描画中のフレームが読んでいるバッファを書き換えないよう、フレームごとに複数のバッファを持てる
+/// </summary>
+class TransformHierarchy {
+public:
+	// ハンドル
+	using Handle = uint32_t;
+	// 無効なハンドル
+	static const Handle kInvalidHandle = UINT32_MAX;
+	// 書き込み先バッファ数の上限
+	static const size_t kMaxOutputBufferCount = 8;
+
+	/// <summary>
+	/// ノード生成
+	/// </summary>
+	/// <param name="parent">親ノード（省略時はルート）</param>
+	/// <returns>ハンドル</returns>
+	Handle Create(Handle parent = kInvalidHandle);
+
+	/// <summary>
+	/// ノード破棄（子を持つノードは破棄できない）
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	void Destroy(Handle handle);
+
+	/// <summary>
+	/// 親の設定（自身か子孫を親にすると循環するので、変えずに false を返す）
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	/// <param name="parent">親ノード（kInvalidHandleでルート）</param>
+	/// <returns>成否</returns>
+	bool SetParent(Handle handle, Handle parent);
+
+	/// <summary>
+	/// ローカルスケールの設定
+	/// </summary>
+	void SetScale(Handle handle, const Vector3& scale);
+
+	/// <summary>
+	/// ローカル回転角の設定
+	/// </summary>
+	void SetRotation(Handle handle, const Vector3& rotation);
+
+	/// <summary>
+	/// ローカル座標の設定
+	/// </summary>
+	void SetTranslation(Handle handle, const Vector3& translation);
+
+	const Vector3& GetScale(Handle handle) const { return scales_[handle]; }
+	const Vector3& GetRotation(Handle handle) const { return rotations_[handle]; }
+	const Vector3& GetTranslation(Handle handle) const { return translations_[handle]; }
+	Handle GetParent(Handle handle) const { return parents_[handle]; }
+
+	/// <summary>
+	/// ワールド行列の取得（Update後に有効）
+	/// </summary>
+	const Matrix4x4& GetWorldMatrix(Handle handle) const { return worldMatrices_[handle]; }
+
+	/// <summary>
+	/// 書き込み先バッファの設定。設定時に全ノードを書き込み対象にする
+	/// </summary>
+	/// <param name="mappedAddress">マップ済みアドレス（nullptrで書き込みなし）</param>
+	/// <param name="capacity">書き込める要素数</param>
+	/// <param name="stride">1要素あたりのバイト数（定数バッファなら256の倍数）</param>
+	void SetOutputBuffer(void* mappedAddress, size_t capacity, size_t stride);
+
+	/// <summary>
+	/// フレームごとの書き込み先バッファの設定。設定時に全ノードを全バッファの書き込み対象にする
+	/// 各バッファには、前にそのバッファへ書いてから変わったノードだけを書き込む
+	/// </summary>
+	/// <param name="mappedAddresses">マップ済みアドレスの配列</param>
+	/// <param name="bufferCount">バッファ数（kMaxOutputBufferCount 以下）</param>
+	/// <param name="capacity">1バッファに書き込める要素数</param>
+	/// <param name="stride">1要素あたりのバイト数（定数バッファなら256の倍数）</param>
+	void SetOutputBuffers(
+	    void* const* mappedAddresses, size_t bufferCount, size_t capacity, size_t stride);
+
+	/// <summary>
+	/// 次の Update で書き込むバッファの選択
+	/// </summary>
+	/// <param name="index">SetOutputBuffers で渡した配列の番号</param>
+	void SetOutputIndex(size_t index);
+
+	/// <summary>
+	/// 書き込み先バッファ先頭からのバイトオフセット
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	/// <returns>バイトオフセット</returns>
+	size_t GetOffset(Handle handle) const { return size_t(handle) * outputStride_; }
+
+	/// <summary>
+	/// 変更のあったノードとその子孫のワールド行列を再計算して書き込む
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 確保済みスロット数（ハンドルの上限）
+	/// </summary>
+	size_t GetCapacity() const { return parents_.size(); }
+
+	/// <summary>
+	/// 前回のUpdateで再計算したノード数
+	/// </summary>
+	size_t GetUpdatedCount() const { return updatedCount_; }
+
+private:
+	// 並列処理の最小単位
+	static const size_t kGrainSize = 256;
+
+	// ローカルスケール
+	std::vector<Vector3> scales_;
+	// X,Y,Z軸回りのローカル回転角
+	std::vector<Vector3> rotations_;
+	// ローカル座標
+	std::vector<Vector3> translations_;
+	// ローカル → ワールド変換行列
+	std::vector<Matrix4x4> worldMatrices_;
+	// 親ノード
+	std::vector<Handle> parents_;
+	// 変更フラグ（自身のローカル値が変わった）
+	std::vector<uint8_t> dirty_;
+	// 今回再計算したか（子の再計算判定用）
+	std::vector<uint8_t> updated_;
+	// 使用中か
+	std::vector<uint8_t> alive_;
+	// まだ今のワールド行列を書き込んでいないバッファ（ビットごと）
+	std::vector<uint8_t> pendingOutputs_;
+	// 子の数
+	std::vector<uint32_t> childCounts_;
+	// 空きスロット
+	std::vector<Handle> freeList_;
+	// 親→子の順に並べたハンドル
+	std::vector<Handle> sortedHandles_;
+	// 階層ごとの sortedHandles_ 上の開始位置
+	std::vector<size_t> levelOffsets_;
+	// 並べ直しが必要か
+	bool isOrderDirty_ = true;
+	// 書き込み先
+	std::vector<uint8_t*> outputAddresses_;
+	size_t outputIndex_ = 0;
+	size_t outputCapacity_ = 0;
+	size_t outputStride_ = sizeof(Matrix4x4);
+	// 前回の再計算数
+	size_t updatedCount_ = 0;
+
+	/// <summary>
+	/// 親子関係から階層順に並べ直す
+	/// </summary>
+	void SortTopologically();
+
+	/// <summary>
+	/// 1ノードの再計算
+	/// </summary>
+	void UpdateNode(Handle handle);
+};
@@ -0,0 +1,228 @@
+#include "VertexQuantization.h"
+#include "MathUtility.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 圧縮の並列処理の最小単位（頂点）
+const size_t kQuantizeGrainSize = 16384;
+// 16bit正規化整数の最大値
+const float kUnorm16Max = 65535.0f;
+const float kSnorm16Max = 32767.0f;
+
+uint16_t EncodeUnorm16(float value) {
+	value = std::clamp(value, 0.0f, 1.0f);
+	return uint16_t(std::lround(value * kUnorm16Max));
+}
+
+float DecodeUnorm16(uint16_t value) { return float(value) / kUnorm16Max; }
+
+float DecodeSnorm16(int16_t value) { return (std::max)(float(value) / kSnorm16Max, -1.0f); }
+
+// 範囲 [offset, offset + scale] の値を正規化する（範囲の幅が0なら0）
+float Normalize01(float value, float offset, float scale) {
+	return scale == 0.0f ? 0.0f : (value - offset) / scale;
+}
+
+float SignNotZero(float value) { return value < 0.0f ? -1.0f : 1.0f; }
+
+} // namespace
+
+size_t GetVertexStride(VertexFormat format) {
+	return format == VertexFormat::kFloat32 ? sizeof(MeshVertex) : sizeof(QuantizedVertex);
+}
+
+uint16_t FloatToHalf(float value) {
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000u;
+	const uint32_t exponent = (bits >> 23) & 0xffu;
+	uint32_t mantissa = bits & 0x7fffffu;
+
+	// 無限大・NaN
+	if (exponent == 0xffu) {
+		return uint16_t(sign | 0x7c00u | (mantissa ? 0x200u | (mantissa >> 13) : 0u));
+	}
+	const int32_t halfExponent = int32_t(exponent) - 127 + 15;
+	// 表せない大きさは無限大
+	if (31 <= halfExponent) {
+		return uint16_t(sign | 0x7c00u);
+	}
+	// 非正規化数（小さすぎる値は0）
+	if (halfExponent <= 0) {
+		if (halfExponent < -10) {
+			return uint16_t(sign);
+		}
+		mantissa |= 0x800000u;
+		const uint32_t shift = uint32_t(14 - halfExponent);
+		uint32_t half = mantissa >> shift;
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+		if (halfway < remainder || (remainder == halfway && (half & 1u))) {
+			half++;
+		}
+		return uint16_t(sign | half);
+	}
+	// 正規化数（繰り上がりで指数が増えても同じ式で正しくなる）
+	uint32_t half = (uint32_t(halfExponent) << 10) | (mantissa >> 13);
+	const uint32_t remainder = mantissa & 0x1fffu;
+	if (0x1000u < remainder || (remainder == 0x1000u && (half & 1u))) {
+		half++;
+	}
+	return uint16_t(sign | half);
+}
+
+float HalfToFloat(uint16_t value) {
+	const uint32_t sign = uint32_t(value & 0x8000u) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1fu;
+	const uint32_t mantissa = value & 0x3ffu;
+
+	float result;
+	if (exponent == 0) {
+		// 非正規化数
+		result = std::ldexp(float(mantissa), -24);
+	} else if (exponent == 31) {
+		uint32_t bits = 0x7f800000u | (mantissa << 13);
+		std::memcpy(&result, &bits, sizeof(result));
+	} else {
+		uint32_t bits = ((exponent + 127 - 15) << 23) | (mantissa << 13);
+		std::memcpy(&result, &bits, sizeof(result));
+	}
+	return sign ? -result : result;
+}
+
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]) {
+	// 八面体へ投影し、下半分は折り返す
+	const float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (sum == 0.0f) {
+		encoded[0] = 0;
+		encoded[1] = 0;
+		return;
+	}
+	float x = normal.x / sum;
+	float y = normal.y / sum;
+	if (normal.z < 0.0f) {
+		const float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		const float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	// 切り捨て・切り上げの組み合わせから最も誤差の小さいものを選ぶ
+	const Vector3 unitNormal = normal * (1.0f / Length(normal));
+	const float baseX = std::floor(std::clamp(x, -1.0f, 1.0f) * kSnorm16Max);
+	const float baseY = std::floor(std::clamp(y, -1.0f, 1.0f) * kSnorm16Max);
+	float bestDot = -2.0f;
+	for (int32_t i = 0; i < 4; i++) {
+		const int16_t candidate[2] = {
+		    int16_t(std::clamp(baseX + float(i & 1), -kSnorm16Max, kSnorm16Max)),
+		    int16_t(std::clamp(baseY + float(i >> 1), -kSnorm16Max, kSnorm16Max))};
+		const float dot = Dot(DecodeOctahedral(candidate), unitNormal);
+		if (bestDot < dot) {
+			bestDot = dot;
+			encoded[0] = candidate[0];
+			encoded[1] = candidate[1];
+		}
+	}
+}
+
+Vector3 DecodeOctahedral(const int16_t encoded[2]) {
+	const float x = DecodeSnorm16(encoded[0]);
+	const float y = DecodeSnorm16(encoded[1]);
+	Vector3 normal = {x, y, 1.0f - std::fabs(x) - std::fabs(y)};
+	// 下半分の折り返しを戻す
+	const float t = (std::max)(-normal.z, 0.0f);
+	normal.x += normal.x < 0.0f ? t : -t;
+	normal.y += normal.y < 0.0f ? t : -t;
+	return Normalize(normal);
+}
+
+QuantizationParameters ComputeQuantizationParameters(
+    const MeshVertex* vertices, size_t count, VertexFormat format) {
+	QuantizationParameters parameters;
+	if (format != VertexFormat::kUnorm16 || count == 0) {
+		return parameters;
+	}
+
+	const AABB bounds = ComputeAABB(vertices, count, sizeof(MeshVertex));
+	Vector2 uvMin = vertices[0].uv;
+	Vector2 uvMax = vertices[0].uv;
+	for (size_t i = 1; i < count; i++) {
+		uvMin.x = (std::min)(uvMin.x, vertices[i].uv.x);
+		uvMin.y = (std::min)(uvMin.y, vertices[i].uv.y);
+		uvMax.x = (std::max)(uvMax.x, vertices[i].uv.x);
+		uvMax.y = (std::max)(uvMax.y, vertices[i].uv.y);
+	}
+	parameters.positionOffset = bounds.min;
+	parameters.positionScale = bounds.max - bounds.min;
+	parameters.uvOffset = uvMin;
+	parameters.uvScale = {uvMax.x - uvMin.x, uvMax.y - uvMin.y};
+	return parameters;
+}
+
+void QuantizeVertices(
+    const MeshVertex* vertices, size_t count, VertexFormat format,
+    const QuantizationParameters& parameters, QuantizedVertex* quantized) {
+	assert(format != VertexFormat::kFloat32);
+	const bool isHalf = format == VertexFormat::kHalf;
+	const Vector3& offset = parameters.positionOffset;
+	const Vector3& scale = parameters.positionScale;
+
+	ThreadPool::GetInstance()->ParallelFor(count, kQuantizeGrainSize, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			const MeshVertex& vertex = vertices[i];
+			QuantizedVertex& result = quantized[i];
+			if (isHalf) {
+				result.position[0] = FloatToHalf(vertex.pos.x);
+				result.position[1] = FloatToHalf(vertex.pos.y);
+				result.position[2] = FloatToHalf(vertex.pos.z);
+				result.position[3] = FloatToHalf(1.0f);
+				result.uv[0] = FloatToHalf(vertex.uv.x);
+				result.uv[1] = FloatToHalf(vertex.uv.y);
+			} else {
+				result.position[0] = EncodeUnorm16(Normalize01(vertex.pos.x, offset.x, scale.x));
+				result.position[1] = EncodeUnorm16(Normalize01(vertex.pos.y, offset.y, scale.y));
+				result.position[2] = EncodeUnorm16(Normalize01(vertex.pos.z, offset.z, scale.z));
+				result.position[3] = UINT16_MAX;
+				result.uv[0] = EncodeUnorm16(
+				    Normalize01(vertex.uv.x, parameters.uvOffset.x, parameters.uvScale.x));
+				result.uv[1] = EncodeUnorm16(
+				    Normalize01(vertex.uv.y, parameters.uvOffset.y, parameters.uvScale.y));
+			}
+			EncodeOctahedral(vertex.normal, result.normal);
+		}
+	});
+}
+
+MeshVertex DequantizeVertex(
+    const QuantizedVertex& quantized, VertexFormat format, const QuantizationParameters& parameters) {
+	assert(format != VertexFormat::kFloat32);
+	Vector3 position;
+	Vector2 uv;
+	if (format == VertexFormat::kHalf) {
+		position = {
+		    HalfToFloat(quantized.position[0]), HalfToFloat(quantized.position[1]),
+		    HalfToFloat(quantized.position[2])};
+		uv = {HalfToFloat(quantized.uv[0]), HalfToFloat(quantized.uv[1])};
+	} else {
+		position = {
+		    DecodeUnorm16(quantized.position[0]), DecodeUnorm16(quantized.position[1]),
+		    DecodeUnorm16(quantized.position[2])};
+		uv = {DecodeUnorm16(quantized.uv[0]), DecodeUnorm16(quantized.uv[1])};
+	}
+
+	MeshVertex vertex;
+	vertex.pos = {
+	    parameters.positionOffset.x + position.x * parameters.positionScale.x,
+	    parameters.positionOffset.y + position.y * parameters.positionScale.y,
+	    parameters.positionOffset.z + position.z * parameters.positionScale.z};
+	vertex.normal = DecodeOctahedral(quantized.normal);
+	vertex.uv = {
+	    parameters.uvOffset.x + uv.x * parameters.uvScale.x,
+	    parameters.uvOffset.y + uv.y * parameters.uvScale.y};
+	return vertex;
+}
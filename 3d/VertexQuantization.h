@@ -0,0 +1,95 @@
+#pragma once
+
+#include "MeshData.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// 頂点形式
+/// </summary>
+enum class VertexFormat {
+	kFloat32, // 全要素float（32バイト、MeshVertex）
+	kHalf,    // 座標・UVが半精度浮動小数点（16バイト）
+	kUnorm16, // 座標・UVが範囲に対する16bit正規化整数（16バイト）
+};
+
+/// <summary>
+/// 圧縮頂点（16バイト）
+/// 法線はどちらの形式も八面体写像の16bit符号付き正規化整数
+/// </summary>
+struct QuantizedVertex {
+	uint16_t position[4]; // xyz座標（wは1）
+	int16_t normal[2];    // 八面体写像した法線
+	uint16_t uv[2];       // uv座標
+};
+
+/// <summary>
+/// 復元用パラメータ（シェーダの VertexQuantization 定数バッファと同じ配置）
+/// 座標 = positionOffset + 読み出し値 * positionScale、UV = uvOffset + 読み出し値 * uvScale
+/// </summary>
+struct QuantizationParameters {
+	Vector3 positionOffset = {0.0f, 0.0f, 0.0f}; // 座標オフセット
+	float padding0 = 0.0f;
+	Vector3 positionScale = {1.0f, 1.0f, 1.0f}; // 座標スケール
+	float padding1 = 0.0f;
+	Vector2 uvOffset = {0.0f, 0.0f}; // UVオフセット
+	Vector2 uvScale = {1.0f, 1.0f};  // UVスケール
+};
+
+/// <summary>
+/// 1頂点あたりのバイト数
+/// </summary>
+size_t GetVertexStride(VertexFormat format);
+
+/// <summary>
+/// floatを半精度浮動小数点にする（最近接偶数丸め）
+/// </summary>
+uint16_t FloatToHalf(float value);
+
+/// <summary>
+/// 半精度浮動小数点をfloatにする
+/// </summary>
+float HalfToFloat(uint16_t value);
+
+/// <summary>
+/// 単位ベクトルを八面体写像で2要素の16bit符号付き正規化整数にする
+/// 丸め方向の4通りから復元誤差が最小のものを選ぶ
+/// </summary>
+/// <param name="normal">単位ベクトル</param>
+/// <param name="encoded">出力先</param>
+void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+
+/// <summary>
+/// 八面体写像の復元（シェーダの DecodeOctahedral と同じ計算）
+/// </summary>
+Vector3 DecodeOctahedral(const int16_t encoded[2]);
+
+/// <summary>
+/// 頂点群の範囲から復元用パラメータを求める
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="count">頂点数</param>
+/// <param name="format">頂点形式（kUnorm16 以外はオフセット0、スケール1）</param>
+/// <returns>復元用パラメータ</returns>
+QuantizationParameters ComputeQuantizationParameters(
+    const MeshVertex* vertices, size_t count, VertexFormat format);
+
+/// <summary>
+/// 頂点の圧縮（Terrain::VertexPosNormalUv も同じ配置なのでそのまま渡せる）
+/// </summary>
+/// <param name="vertices">頂点</param>
+/// <param name="count">頂点数</param>
+/// <param name="format">頂点形式（kHalf か kUnorm16）</param>
+/// <param name="parameters">復元用パラメータ</param>
+/// <param name="quantized">出力先（count個）</param>
+void QuantizeVertices(
+    const MeshVertex* vertices, size_t count, VertexFormat format,
+    const QuantizationParameters& parameters, QuantizedVertex* quantized);
+
+/// <summary>
+/// 頂点の復元（シェーダの復元と同じ計算）
+/// </summary>
+MeshVertex DequantizeVertex(
+    const QuantizedVertex& quantized, VertexFormat format, const QuantizationParameters& parameters);
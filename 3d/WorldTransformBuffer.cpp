@@ -0,0 +1,66 @@
+#include "WorldTransformBuffer.h"
+#include "DirectXCommon.h"
+#include <algorithm>
+#include <cassert>
+#include <d3dx12.h>
+
+void WorldTransformBuffer::Initialize(TransformHierarchy* hierarchy, size_t capacity) {
+	assert(hierarchy);
+	hierarchy_ = hierarchy;
+	CreateConstBuffer((std::max)<size_t>(capacity, 1));
+}
+
+void WorldTransformBuffer::Update() {
+	// 足りなければ倍々で拡張する（旧バッファは描画中のフレームが終わってから解放される）
+	if (capacity_ < hierarchy_->GetCapacity()) {
+		CreateConstBuffer((std::max)(capacity_ * 2, hierarchy_->GetCapacity()));
+	}
+	// 今のフレームの領域へ、前にその領域へ書いてから変わった行列を書き込む
+	hierarchy_->SetOutputIndex(DirectXCommon::GetInstance()->GetFrameIndex());
+	hierarchy_->Update();
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS
+    WorldTransformBuffer::GetGPUVirtualAddress(TransformHierarchy::Handle handle) const {
+	assert(handle < capacity_);
+	const size_t regionOffset =
+	    DirectXCommon::GetInstance()->GetFrameIndex() * capacity_ * kElementStride;
+	return constBuff_->GetGPUVirtualAddress() + regionOffset + hierarchy_->GetOffset(handle);
+}
+
+void WorldTransformBuffer::CreateConstBuffer(size_t capacity) {
+	HRESULT result;
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	ID3D12Device* device = dxCommon->GetDevice();
+	const uint32_t regionCount = dxCommon->GetFrameContextCount();
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定（フレームのコンテキストごとに capacity 要素の領域を並べる）
+	CD3DX12_RESOURCE_DESC resourceDesc =
+	    CD3DX12_RESOURCE_DESC::Buffer(regionCount * capacity * kElementStride);
+
+	// 定数バッファの生成
+	Microsoft::WRL::ComPtr<ID3D12Resource> constBuff;
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&constBuff));
+	assert(SUCCEEDED(result));
+
+	// 定数バッファとのデータリンク（アンマップせずに使い続ける）
+	void* constMap = nullptr;
+	result = constBuff->Map(0, nullptr, &constMap);
+	assert(SUCCEEDED(result));
+
+	// 描画中のフレームが参照しているかもしれないので、旧バッファはフレームが終わってから解放する
+	dxCommon->DeferRelease(constBuff_);
+	constBuff_ = constBuff;
+	capacity_ = capacity;
+
+	void* regions[TransformHierarchy::kMaxOutputBufferCount];
+	assert(regionCount <= TransformHierarchy::kMaxOutputBufferCount);
+	for (uint32_t i = 0; i < regionCount; i++) {
+		regions[i] = static_cast<uint8_t*>(constMap) + i * capacity_ * kElementStride;
+	}
+	hierarchy_->SetOutputBuffers(regions, regionCount, capacity_, kElementStride);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "TransformHierarchy.h"
+#include "WorldTransform.h"
+#include <d3d12.h>
+#include <wrl.h>
+
+/// <summary>
+/// TransformHierarchy のワールド行列をまとめて置く定数バッファ
+/// 全オブジェクトで1つのアップロードバッファを共有し、オブジェクトごとに256バイト境界のオフセットで参照する。
+/// バッファはフレームのコンテキストごとの領域に分け、描画中のフレームが読んでいない領域へ書き込む
+/// </summary>
+class WorldTransformBuffer {
+public:
+	// 1要素あたりのバイト数（定数バッファの配置境界）
+	static const size_t kElementStride = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="hierarchy">書き込み元の階層</param>
+	/// <param name="capacity">初期要素数</param>
+	void Initialize(TransformHierarchy* hierarchy, size_t capacity);
+
+	/// <summary>
+	/// 階層のノード数に合わせてバッファを拡張し、ワールド行列を更新する
+	/// 今のフレームの領域だけを書き換えるので、変更が無くても毎フレーム描画の前に呼ぶ
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// ノードの定数バッファアドレスを取得（Update と同じフレームで使う）
+	/// SetGraphicsRootConstantBufferView にそのまま渡せる
+	/// </summary>
+	/// <param name="handle">ハンドル</param>
+	/// <returns>GPU仮想アドレス</returns>
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress(TransformHierarchy::Handle handle) const;
+
+private:
+	// 書き込み元の階層
+	TransformHierarchy* hierarchy_ = nullptr;
+	// 定数バッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> constBuff_;
+	// 1領域あたりの要素数
+	size_t capacity_ = 0;
+
+	/// <summary>
+	/// 定数バッファ生成
+	/// </summary>
+	/// <param name="capacity">1領域あたりの要素数</param>
+	void CreateConstBuffer(size_t capacity);
+};
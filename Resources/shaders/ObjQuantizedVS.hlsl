@@ -0,0 +1,21 @@
+#include "Obj.hlsli"
+#include "VertexQuantization.hlsli"
+
+VSOutput main(float4 quantizedPos : POSITION, float2 quantizedNormal : NORMAL, float2 quantizedUV : TEXCOORD) {
+	float4 pos = DecodePosition(quantizedPos);
+	float3 normal = DecodeOctahedral(quantizedNormal);
+
+	// 法線にワールド行列によるスケーリング・回転を適用
+	// ※スケーリングが一様な場合のみ正しい
+	float4 worldNormal = normalize(mul(float4(normal, 0), world));
+	float4 worldPos = mul(pos, world);
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(pos, mul(world, mul(view, projection)));
+
+	output.worldpos = worldPos;
+	output.normal = worldNormal.xyz;
+	output.uv = DecodeUV(quantizedUV);
+
+	return output;
+}
\ No newline at end of file
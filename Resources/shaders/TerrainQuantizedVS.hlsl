@@ -0,0 +1,14 @@
+#include "Terrain.hlsli"
+#include "VertexQuantization.hlsli"
+
+VSOutput main(float4 quantizedPos : POSITION, float2 quantizedNormal : NORMAL, float2 quantizedUV : TEXCOORD) {
+	float4 pos = DecodePosition(quantizedPos);
+
+	VSOutput output; // ピクセルシェーダーに渡す値
+	output.svpos = mul(pos, mul(world, mul(view, projection)));
+
+	output.normal = DecodeOctahedral(quantizedNormal);
+	output.uv = DecodeUV(quantizedUV);
+
+	return output;
+}
\ No newline at end of file
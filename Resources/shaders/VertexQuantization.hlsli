@@ -0,0 +1,26 @@
+// 圧縮頂点の復元
+// 座標は R16G16B16A16_UNORM か R16G16B16A16_FLOAT、法線は R16G16_SNORM、UVは R16G16_UNORM か R16G16_FLOAT で入力する
+
+cbuffer VertexQuantization : register(b4) {
+	float3 q_positionOffset : packoffset(c0); // 座標オフセット
+	float3 q_positionScale : packoffset(c1);  // 座標スケール
+	float2 q_uvOffset : packoffset(c2);       // UVオフセット
+	float2 q_uvScale : packoffset(c2.z);      // UVスケール
+}
+
+// 座標の復元
+float4 DecodePosition(float4 quantizedPos) {
+	return float4(q_positionOffset + quantizedPos.xyz * q_positionScale, 1.0f);
+}
+
+// 八面体写像した法線の復元
+float3 DecodeOctahedral(float2 encoded) {
+	float3 normal = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	// 下半分の折り返しを戻す
+	float t = saturate(-normal.z);
+	normal.xy += t * (1.0f - 2.0f * step(0.0f, normal.xy));
+	return normalize(normal);
+}
+
+// UVの復元
+float2 DecodeUV(float2 quantizedUV) { return q_uvOffset + quantizedUV * q_uvScale; }
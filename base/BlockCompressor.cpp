@@ -0,0 +1,642 @@
+#include "BlockCompressor.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 並列に処理する1タスクあたりのブロック数の目安
+const size_t kTaskBlockCount = 256;
+// 主成分を求めるべき乗法の回数
+const int kPowerIterationCount = 8;
+// BC7 の4bitインデックスの補間の重み（64分率）
+const int kBC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+// BC1 の4色モードの補間の重み（インデックス順。3分率）
+const float kBC1Weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+// 4x4 画素（RGBA を 0～255 の浮動小数で持つ）
+struct Block {
+	float pixels[16][4];
+};
+
+// ブロックの画素を集める（画像の外は端の画素を繰り返す）
+void GatherBlock(
+    const uint8_t* mipPixels, const TextureMip& mip, bool isBgra, uint32_t blockX,
+    uint32_t blockY, Block& block) {
+	for (uint32_t y = 0; y < 4; y++) {
+		const uint32_t sy = (std::min)(blockY * 4 + y, mip.height - 1);
+		for (uint32_t x = 0; x < 4; x++) {
+			const uint32_t sx = (std::min)(blockX * 4 + x, mip.width - 1);
+			const uint8_t* src = mipPixels + size_t(sy) * mip.rowPitch + size_t(sx) * 4;
+			float* dst = block.pixels[y * 4 + x];
+			dst[0] = float(src[isBgra ? 2 : 0]);
+			dst[1] = float(src[1]);
+			dst[2] = float(src[isBgra ? 0 : 2]);
+			dst[3] = float(src[3]);
+		}
+	}
+}
+
+// 先頭 channelCount 要素の二乗距離
+float SquaredDistance(const float* a, const float* b, int channelCount) {
+	float sum = 0.0f;
+	for (int c = 0; c < channelCount; c++) {
+		sum += (a[c] - b[c]) * (a[c] - b[c]);
+	}
+	return sum;
+}
+
+// 画素の主成分の方向の両端を端点の初期値にする
+void ComputeInitialEndpoints(
+    const Block& block, int channelCount, float endpoint0[4], float endpoint1[4]) {
+	float mean[4] = {};
+	for (const float* pixel : block.pixels) {
+		for (int c = 0; c < channelCount; c++) {
+			mean[c] += pixel[c] / 16.0f;
+		}
+	}
+	float covariance[4][4] = {};
+	for (const float* pixel : block.pixels) {
+		for (int i = 0; i < channelCount; i++) {
+			for (int j = 0; j < channelCount; j++) {
+				covariance[i][j] += (pixel[i] - mean[i]) * (pixel[j] - mean[j]);
+			}
+		}
+	}
+
+	// べき乗法で最大固有値の固有ベクトルを求める
+	float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+	for (int iteration = 0; iteration < kPowerIterationCount; iteration++) {
+		float next[4] = {};
+		float length = 0.0f;
+		for (int i = 0; i < channelCount; i++) {
+			for (int j = 0; j < channelCount; j++) {
+				next[i] += covariance[i][j] * axis[j];
+			}
+			length = (std::max)(length, std::abs(next[i]));
+		}
+		if (length < 1.0e-6f) {
+			break;
+		}
+		for (int i = 0; i < channelCount; i++) {
+			axis[i] = next[i] / length;
+		}
+	}
+	float axisLengthSquared = 0.0f;
+	for (int c = 0; c < channelCount; c++) {
+		axisLengthSquared += axis[c] * axis[c];
+	}
+
+	float minProjection = 0.0f;
+	float maxProjection = 0.0f;
+	for (const float* pixel : block.pixels) {
+		float projection = 0.0f;
+		for (int c = 0; c < channelCount; c++) {
+			projection += (pixel[c] - mean[c]) * axis[c];
+		}
+		minProjection = (std::min)(minProjection, projection);
+		maxProjection = (std::max)(maxProjection, projection);
+	}
+	const float scale = 1.0e-6f < axisLengthSquared ? 1.0f / axisLengthSquared : 0.0f;
+	for (int c = 0; c < channelCount; c++) {
+		endpoint0[c] = std::clamp(mean[c] + axis[c] * maxProjection * scale, 0.0f, 255.0f);
+		endpoint1[c] = std::clamp(mean[c] + axis[c] * minProjection * scale, 0.0f, 255.0f);
+	}
+}
+
+// インデックスごとの重みから、二乗誤差が最小になる端点を求め直す
+bool SolveEndpoints(
+    const Block& block, const float weights[16], int channelCount, float endpoint0[4],
+    float endpoint1[4]) {
+	// 画素 = (1 - w) * 端点0 + w * 端点1 の正規方程式
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float ap[4] = {};
+	float bp[4] = {};
+	for (int i = 0; i < 16; i++) {
+		const float a = 1.0f - weights[i];
+		const float b = weights[i];
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < channelCount; c++) {
+			ap[c] += a * block.pixels[i][c];
+			bp[c] += b * block.pixels[i][c];
+		}
+	}
+	const float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1.0e-6f) {
+		return false;
+	}
+	for (int c = 0; c < channelCount; c++) {
+		endpoint0[c] = std::clamp((ap[c] * bb - bp[c] * ab) / determinant, 0.0f, 255.0f);
+		endpoint1[c] = std::clamp((bp[c] * aa - ap[c] * ab) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+uint16_t ToRgb565(const float color[3]) {
+	const uint32_t r = uint32_t(color[0] * 31.0f / 255.0f + 0.5f);
+	const uint32_t g = uint32_t(color[1] * 63.0f / 255.0f + 0.5f);
+	const uint32_t b = uint32_t(color[2] * 31.0f / 255.0f + 0.5f);
+	return uint16_t((r << 11) | (g << 5) | b);
+}
+
+void FromRgb565(uint16_t value, float color[3]) {
+	const uint32_t r = (value >> 11) & 31;
+	const uint32_t g = (value >> 5) & 63;
+	const uint32_t b = value & 31;
+	color[0] = float((r << 3) | (r >> 2));
+	color[1] = float((g << 2) | (g >> 4));
+	color[2] = float((b << 3) | (b >> 2));
+}
+
+// BC1 の色の表（color0 > color1 なら4色、そうでなければ3色と黒）
+void MakeBC1Palette(uint16_t color0, uint16_t color1, float palette[4][3]) {
+	FromRgb565(color0, palette[0]);
+	FromRgb565(color1, palette[1]);
+	for (int c = 0; c < 3; c++) {
+		if (color1 < color0) {
+			palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+			palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) * 0.5f;
+			palette[3][c] = 0.0f;
+		}
+	}
+}
+
+// BC1 / BC3 の色ブロック（常に4色モードで作る）
+void EncodeColorBlock(const Block& block, uint32_t iterationCount, uint8_t* out) {
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeInitialEndpoints(block, 3, endpoint0, endpoint1);
+
+	uint16_t bestColor0 = 0;
+	uint16_t bestColor1 = 0;
+	uint32_t bestIndices = 0;
+	float bestError = FLT_MAX;
+	for (uint32_t iteration = 0; iteration <= iterationCount; iteration++) {
+		uint16_t color0 = ToRgb565(endpoint0);
+		uint16_t color1 = ToRgb565(endpoint1);
+		if (color0 < color1) {
+			std::swap(color0, color1);
+		}
+		float palette[4][3];
+		MakeBC1Palette(color0, color1, palette);
+
+		// 同じ端点なら4色モードにできないので、全てインデックス0（color0）にする
+		uint32_t indices = 0;
+		float error = 0.0f;
+		float weights[16];
+		for (int i = 0; i < 16; i++) {
+			uint32_t bestIndex = 0;
+			float bestDistance = FLT_MAX;
+			for (uint32_t index = 0; index < (color0 == color1 ? 1u : 4u); index++) {
+				float distance = SquaredDistance(block.pixels[i], palette[index], 3);
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					bestIndex = index;
+				}
+			}
+			indices |= bestIndex << (i * 2);
+			error += bestDistance;
+			weights[i] = kBC1Weights[bestIndex];
+		}
+		if (error < bestError) {
+			bestError = error;
+			bestColor0 = color0;
+			bestColor1 = color1;
+			bestIndices = indices;
+		}
+
+		// 量子化した端点の並びで重みを求め直す
+		FromRgb565(color0, endpoint0);
+		FromRgb565(color1, endpoint1);
+		if (iteration == iterationCount ||
+		    !SolveEndpoints(block, weights, 3, endpoint0, endpoint1)) {
+			break;
+		}
+	}
+
+	std::memcpy(out, &bestColor0, 2);
+	std::memcpy(out + 2, &bestColor1, 2);
+	std::memcpy(out + 4, &bestIndices, 4);
+}
+
+// BC4 の値の表（value0 > value1 なら8段階、そうでなければ6段階と 0, 255）
+void MakeBC4Palette(uint32_t value0, uint32_t value1, float palette[8]) {
+	palette[0] = float(value0);
+	palette[1] = float(value1);
+	if (value1 < value0) {
+		for (int i = 2; i < 8; i++) {
+			palette[i] = float((8 - i) * value0 + (i - 1) * value1) / 7.0f;
+		}
+	} else {
+		for (int i = 2; i < 6; i++) {
+			palette[i] = float((6 - i) * value0 + (i - 1) * value1) / 5.0f;
+		}
+		palette[6] = 0.0f;
+		palette[7] = 255.0f;
+	}
+}
+
+// BC4 のブロック（BC3 のアルファと BC5 の各成分にも使う。8段階モードで作る）
+void EncodeSingleChannelBlock(const Block& block, int channel, uint8_t* out) {
+	float minValue = 255.0f;
+	float maxValue = 0.0f;
+	for (const float* pixel : block.pixels) {
+		minValue = (std::min)(minValue, pixel[channel]);
+		maxValue = (std::max)(maxValue, pixel[channel]);
+	}
+	const uint32_t value0 = uint32_t(maxValue + 0.5f);
+	const uint32_t value1 = uint32_t(minValue + 0.5f);
+	float palette[8];
+	MakeBC4Palette(value0, value1, palette);
+
+	uint64_t indices = 0;
+	for (int i = 0; i < 16; i++) {
+		uint64_t bestIndex = 0;
+		float bestDistance = FLT_MAX;
+		for (uint64_t index = 0; index < (value0 == value1 ? 1u : 8u); index++) {
+			float distance = std::abs(block.pixels[i][channel] - palette[index]);
+			if (distance < bestDistance) {
+				bestDistance = distance;
+				bestIndex = index;
+			}
+		}
+		indices |= bestIndex << (i * 3);
+	}
+	out[0] = uint8_t(value0);
+	out[1] = uint8_t(value1);
+	for (int i = 0; i < 6; i++) {
+		out[2 + i] = uint8_t(indices >> (i * 8));
+	}
+}
+
+// 128bit ブロックへの書き込み（下位ビットから）
+class BitWriter {
+public:
+	explicit BitWriter(uint8_t* out) : out_(out) { std::memset(out_, 0, 16); }
+
+	void Write(uint32_t value, int bitCount) {
+		for (int i = 0; i < bitCount; i++, position_++) {
+			out_[position_ / 8] |= uint8_t(((value >> i) & 1) << (position_ % 8));
+		}
+	}
+
+private:
+	uint8_t* out_;
+	int position_ = 0;
+};
+
+// 128bit ブロックからの読み出し（下位ビットから）
+class BitReader {
+public:
+	explicit BitReader(const uint8_t* data) : data_(data) {}
+
+	uint32_t Read(int bitCount) {
+		uint32_t value = 0;
+		for (int i = 0; i < bitCount; i++, position_++) {
+			value |= uint32_t((data_[position_ / 8] >> (position_ % 8)) & 1) << i;
+		}
+		return value;
+	}
+
+private:
+	const uint8_t* data_;
+	int position_ = 0;
+};
+
+// BC7 モード6の端点の量子化（7bit と、全成分で共通の下位ビット）
+void QuantizeBC7Endpoint(const float endpoint[4], uint32_t quantized[4], uint32_t& pBit) {
+	float bestError = FLT_MAX;
+	for (uint32_t p = 0; p < 2; p++) {
+		uint32_t values[4];
+		float error = 0.0f;
+		for (int c = 0; c < 4; c++) {
+			values[c] = uint32_t(std::clamp((endpoint[c] - float(p)) * 0.5f + 0.5f, 0.0f, 127.0f));
+			float reconstructed = float(values[c] * 2 + p);
+			error += (reconstructed - endpoint[c]) * (reconstructed - endpoint[c]);
+		}
+		if (error < bestError) {
+			bestError = error;
+			pBit = p;
+			std::copy(values, values + 4, quantized);
+		}
+	}
+}
+
+// BC7 モード6の値の表
+void MakeBC7Palette(const uint32_t endpoint0[4], const uint32_t endpoint1[4], float palette[16][4]) {
+	for (int index = 0; index < 16; index++) {
+		for (int c = 0; c < 4; c++) {
+			const uint32_t weight = uint32_t(kBC7Weights[index]);
+			palette[index][c] = float(((64 - weight) * endpoint0[c] + weight * endpoint1[c] + 32) >> 6);
+		}
+	}
+}
+
+void EncodeBC7Block(const Block& block, uint32_t iterationCount, uint8_t* out) {
+	float endpoint0[4];
+	float endpoint1[4];
+	ComputeInitialEndpoints(block, 4, endpoint0, endpoint1);
+
+	uint32_t best[2][4] = {};
+	uint32_t bestPBits[2] = {};
+	uint32_t bestIndices[16] = {};
+	float bestError = FLT_MAX;
+	for (uint32_t iteration = 0; iteration <= iterationCount; iteration++) {
+		uint32_t quantized[2][4];
+		uint32_t pBits[2];
+		QuantizeBC7Endpoint(endpoint0, quantized[0], pBits[0]);
+		QuantizeBC7Endpoint(endpoint1, quantized[1], pBits[1]);
+		uint32_t expanded[2][4];
+		for (int e = 0; e < 2; e++) {
+			for (int c = 0; c < 4; c++) {
+				expanded[e][c] = quantized[e][c] * 2 + pBits[e];
+			}
+		}
+		float palette[16][4];
+		MakeBC7Palette(expanded[0], expanded[1], palette);
+
+		uint32_t indices[16];
+		float weights[16];
+		float error = 0.0f;
+		for (int i = 0; i < 16; i++) {
+			uint32_t bestIndex = 0;
+			float bestDistance = FLT_MAX;
+			for (uint32_t index = 0; index < 16; index++) {
+				float distance = SquaredDistance(block.pixels[i], palette[index], 4);
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					bestIndex = index;
+				}
+			}
+			indices[i] = bestIndex;
+			weights[i] = float(kBC7Weights[bestIndex]) / 64.0f;
+			error += bestDistance;
+		}
+		if (error < bestError) {
+			bestError = error;
+			std::memcpy(best, quantized, sizeof(best));
+			std::memcpy(bestPBits, pBits, sizeof(bestPBits));
+			std::memcpy(bestIndices, indices, sizeof(bestIndices));
+		}
+
+		for (int c = 0; c < 4; c++) {
+			endpoint0[c] = float(expanded[0][c]);
+			endpoint1[c] = float(expanded[1][c]);
+		}
+		if (iteration == iterationCount ||
+		    !SolveEndpoints(block, weights, 4, endpoint0, endpoint1)) {
+			break;
+		}
+	}
+
+	// 先頭の画素のインデックスは最上位ビットを省くので、0～7 になるよう端点を入れ替える
+	if (8 <= bestIndices[0]) {
+		std::swap(best[0], best[1]);
+		std::swap(bestPBits[0], bestPBits[1]);
+		for (uint32_t& index : bestIndices) {
+			index = 15 - index;
+		}
+	}
+
+	BitWriter writer(out);
+	writer.Write(1u << 6, 7);
+	for (int c = 0; c < 4; c++) {
+		writer.Write(best[0][c], 7);
+		writer.Write(best[1][c], 7);
+	}
+	writer.Write(bestPBits[0], 1);
+	writer.Write(bestPBits[1], 1);
+	for (int i = 0; i < 16; i++) {
+		writer.Write(bestIndices[i], i == 0 ? 3 : 4);
+	}
+}
+
+// BC4 ブロックを展開して、画素の channel 番目の成分に書き込む
+void DecodeSingleChannelBlock(const uint8_t* data, int channel, uint8_t pixels[16][4]) {
+	float palette[8];
+	MakeBC4Palette(data[0], data[1], palette);
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++) {
+		indices |= uint64_t(data[2 + i]) << (i * 8);
+	}
+	for (int i = 0; i < 16; i++) {
+		pixels[i][channel] = uint8_t(palette[(indices >> (i * 3)) & 7] + 0.5f);
+	}
+}
+
+// BC1 / BC3 の色ブロックを展開する（BC1 の3色モードの黒は透明にする）
+void DecodeColorBlock(const uint8_t* data, bool isBC1, uint8_t pixels[16][4]) {
+	uint16_t color0;
+	uint16_t color1;
+	uint32_t indices;
+	std::memcpy(&color0, data, 2);
+	std::memcpy(&color1, data + 2, 2);
+	std::memcpy(&indices, data + 4, 4);
+	float palette[4][3];
+	if (isBC1) {
+		MakeBC1Palette(color0, color1, palette);
+	} else {
+		// BC3 の色は常に4色モード
+		MakeBC1Palette(color0, color1, palette);
+		for (int c = 0; c < 3; c++) {
+			palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+			palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+		}
+	}
+	for (int i = 0; i < 16; i++) {
+		const uint32_t index = (indices >> (i * 2)) & 3;
+		for (int c = 0; c < 3; c++) {
+			pixels[i][c] = uint8_t(palette[index][c] + 0.5f);
+		}
+		pixels[i][3] = isBC1 && color0 <= color1 && index == 3 ? 0 : 255;
+	}
+}
+
+bool DecodeBC7Block(const uint8_t* data, uint8_t pixels[16][4]) {
+	BitReader reader(data);
+	if (reader.Read(7) != (1u << 6)) {
+		return false;
+	}
+	uint32_t endpoints[2][4];
+	for (int c = 0; c < 4; c++) {
+		endpoints[0][c] = reader.Read(7) << 1;
+		endpoints[1][c] = reader.Read(7) << 1;
+	}
+	const uint32_t pBit0 = reader.Read(1);
+	const uint32_t pBit1 = reader.Read(1);
+	for (int c = 0; c < 4; c++) {
+		endpoints[0][c] |= pBit0;
+		endpoints[1][c] |= pBit1;
+	}
+	float palette[16][4];
+	MakeBC7Palette(endpoints[0], endpoints[1], palette);
+	for (int i = 0; i < 16; i++) {
+		const uint32_t index = reader.Read(i == 0 ? 3 : 4);
+		for (int c = 0; c < 4; c++) {
+			pixels[i][c] = uint8_t(palette[index][c]);
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+TextureFormat BlockCompressor::GetTextureFormat(Format format) {
+	switch (format) {
+	case Format::kBC1:
+		return TextureFormat::kBC1Unorm;
+	case Format::kBC3:
+		return TextureFormat::kBC3Unorm;
+	case Format::kBC4:
+		return TextureFormat::kBC4Unorm;
+	case Format::kBC5:
+		return TextureFormat::kBC5Unorm;
+	default:
+		return TextureFormat::kBC7Unorm;
+	}
+}
+
+bool BlockCompressor::Compress(TextureData& texture, const Options& options) {
+	if (GetBytesPerPixel(texture.format) != 4 || texture.mips.empty() ||
+	    texture.GetWidth() % 4 != 0 || texture.GetHeight() % 4 != 0) {
+		return false;
+	}
+	const bool isBgra = texture.format == TextureFormat::kB8G8R8A8Unorm ||
+	                    texture.format == TextureFormat::kB8G8R8A8UnormSrgb;
+	const bool isSrgb = texture.format == TextureFormat::kR8G8B8A8UnormSrgb ||
+	                    texture.format == TextureFormat::kB8G8R8A8UnormSrgb;
+
+	TextureData compressed;
+	compressed.format = GetTextureFormat(options.format);
+	if (isSrgb) {
+		compressed.format = MakeSrgb(compressed.format);
+	}
+	const uint32_t blockSize = GetBlockSize(compressed.format);
+	size_t offset = 0;
+	for (const TextureMip& mip : texture.mips) {
+		const uint32_t rowPitch = (mip.width + 3) / 4 * blockSize;
+		const uint32_t slicePitch = rowPitch * ((mip.height + 3) / 4);
+		compressed.mips.push_back({offset, mip.width, mip.height, rowPitch, slicePitch});
+		offset += slicePitch;
+	}
+	compressed.pixels.resize(offset);
+
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	for (uint32_t level = 0; level < texture.GetMipCount(); level++) {
+		const TextureMip& mip = texture.mips[level];
+		const TextureMip& compressedMip = compressed.mips[level];
+		const uint8_t* src = texture.GetMipPixels(level);
+		uint8_t* dst = compressed.GetMipPixels(level);
+		const uint32_t blockCountX = (mip.width + 3) / 4;
+		const uint32_t blockCountY = (mip.height + 3) / 4;
+		const size_t grainSize = (std::max)(kTaskBlockCount / blockCountX, size_t(1));
+		threadPool->ParallelFor(blockCountY, grainSize, [&](size_t begin, size_t end) {
+			Block block;
+			for (size_t blockY = begin; blockY < end; blockY++) {
+				uint8_t* out = dst + blockY * compressedMip.rowPitch;
+				for (uint32_t blockX = 0; blockX < blockCountX; blockX++, out += blockSize) {
+					GatherBlock(src, mip, isBgra, blockX, uint32_t(blockY), block);
+					switch (options.format) {
+					case Format::kBC1:
+						EncodeColorBlock(block, options.refineIterationCount, out);
+						break;
+					case Format::kBC3:
+						EncodeSingleChannelBlock(block, 3, out);
+						EncodeColorBlock(block, options.refineIterationCount, out + 8);
+						break;
+					case Format::kBC4:
+						EncodeSingleChannelBlock(block, 0, out);
+						break;
+					case Format::kBC5:
+						EncodeSingleChannelBlock(block, 0, out);
+						EncodeSingleChannelBlock(block, 1, out + 8);
+						break;
+					default:
+						EncodeBC7Block(block, options.refineIterationCount, out);
+						break;
+					}
+				}
+			}
+		});
+	}
+	texture = std::move(compressed);
+	return true;
+}
+
+bool BlockCompressor::Decompress(const TextureData& compressed, TextureData& texture) {
+	const TextureFormat format = compressed.format;
+	const uint32_t blockSize = GetBlockSize(format);
+	if (blockSize == 0) {
+		return false;
+	}
+
+	TextureData decompressed;
+	decompressed.format = TextureFormat::kR8G8B8A8Unorm;
+	size_t offset = 0;
+	for (const TextureMip& mip : compressed.mips) {
+		decompressed.mips.push_back({offset, mip.width, mip.height, mip.width * 4, mip.width * 4 * mip.height});
+		offset += size_t(mip.width) * 4 * mip.height;
+	}
+	decompressed.pixels.resize(offset);
+
+	for (uint32_t level = 0; level < compressed.GetMipCount(); level++) {
+		const TextureMip& mip = compressed.mips[level];
+		const TextureMip& dstMip = decompressed.mips[level];
+		for (uint32_t blockY = 0; blockY < (mip.height + 3) / 4; blockY++) {
+			for (uint32_t blockX = 0; blockX < (mip.width + 3) / 4; blockX++) {
+				const uint8_t* data =
+				    compressed.GetMipPixels(level) + blockY * mip.rowPitch + blockX * blockSize;
+				uint8_t pixels[16][4] = {};
+				switch (format) {
+				case TextureFormat::kBC1Unorm:
+				case TextureFormat::kBC1UnormSrgb:
+					DecodeColorBlock(data, true, pixels);
+					break;
+				case TextureFormat::kBC3Unorm:
+				case TextureFormat::kBC3UnormSrgb:
+					DecodeColorBlock(data + 8, false, pixels);
+					DecodeSingleChannelBlock(data, 3, pixels);
+					break;
+				case TextureFormat::kBC4Unorm:
+					DecodeSingleChannelBlock(data, 0, pixels);
+					for (auto& pixel : pixels) {
+						pixel[3] = 255;
+					}
+					break;
+				case TextureFormat::kBC5Unorm:
+					DecodeSingleChannelBlock(data, 0, pixels);
+					DecodeSingleChannelBlock(data + 8, 1, pixels);
+					for (auto& pixel : pixels) {
+						pixel[3] = 255;
+					}
+					break;
+				default:
+					if (!DecodeBC7Block(data, pixels)) {
+						return false;
+					}
+					break;
+				}
+
+				// 画像の外にはみ出した画素は捨てる
+				for (uint32_t y = 0; y < 4 && blockY * 4 + y < mip.height; y++) {
+					for (uint32_t x = 0; x < 4 && blockX * 4 + x < mip.width; x++) {
+						std::memcpy(
+						    decompressed.GetMipPixels(level) +
+						        size_t(blockY * 4 + y) * dstMip.rowPitch + size_t(blockX * 4 + x) * 4,
+						    pixels[y * 4 + x], 4);
+					}
+				}
+			}
+		}
+	}
+	texture = std::move(decompressed);
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TextureData.h"
+#include <cstdint>
+
+/// <summary>
+/// ブロック圧縮（BC1/BC3/BC4/BC5/BC7）のエンコーダ
+/// RGBA8 / BGRA8 の画像を全ミップまとめて圧縮し、ブロック行ごとに ThreadPool で並列に処理する。
+/// 端点は主成分の方向の両端から始め、インデックスを決めて最小二乗で端点を求め直すことを繰り返す。
+/// BC7 はモード6（1サブセット、RGBA 各7bit + pビット、4bitインデックス）だけを使う
+/// </summary>
+class BlockCompressor {
+public:
+	// エンコーダのバージョン（出力が変わる修正をしたら上げて、キャッシュを作り直させる）
+	static const uint32_t kVersion = 1;
+
+	/// <summary>
+	/// 圧縮形式
+	/// </summary>
+	enum class Format : uint32_t {
+		kBC1, // RGB 4bpp（アルファ無し）
+		kBC3, // RGBA 8bpp（アルファは BC4 と同じ形式）
+		kBC4, // R 4bpp
+		kBC5, // RG 8bpp（法線マップなど）
+		kBC7, // RGBA 8bpp（高品質）
+	};
+
+	/// <summary>
+	/// 圧縮の設定
+	/// </summary>
+	struct Options {
+		Format format = Format::kBC7;
+		// 端点を求め直す回数（多いほど高品質で遅い）
+		uint32_t refineIterationCount = 2;
+	};
+
+	/// <summary>
+	/// 圧縮
+	/// D3D12 ではブロック圧縮のテクスチャのレベル0の大きさが4の倍数でなければならないので、
+	/// それ以外の大きさの画像は圧縮しない
+	/// </summary>
+	/// <param name="texture">RGBA8 / BGRA8 の画像（ミップを含む）</param>
+	/// <param name="options">設定</param>
+	/// <returns>圧縮できたか（できなければ画像を変えずに false）</returns>
+	static bool Compress(TextureData& texture, const Options& options);
+
+	/// <summary>
+	/// 既定の設定（BC7）で圧縮する
+	/// </summary>
+	static bool Compress(TextureData& texture) { return Compress(texture, Options()); }
+
+	/// <summary>
+	/// RGBA8 への展開（画質の確認用。BC7 はモード6のブロックだけ扱う）
+	/// </summary>
+	/// <param name="compressed">圧縮した画像</param>
+	/// <param name="texture">展開先</param>
+	/// <returns>展開できたか</returns>
+	static bool Decompress(const TextureData& compressed, TextureData& texture);
+
+	/// <summary>
+	/// 圧縮形式に対応するテクスチャの画素形式
+	/// </summary>
+	static TextureFormat GetTextureFormat(Format format);
+};
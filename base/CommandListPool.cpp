@@ -0,0 +1,64 @@
+#include "CommandListPool.h"
+#include "DirectXCommon.h"
+#include <cassert>
+
+void CommandListPool::Initialize(ID3D12Device* device) {
+	assert(device);
+	device_ = device;
+	framePools_.clear();
+	framePools_.resize(DirectXCommon::GetInstance()->GetFrameContextCount());
+}
+
+ID3D12GraphicsCommandList* CommandListPool::Acquire() {
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	FramePool& pool = framePools_[dxCommon->GetFrameIndex()];
+	// フレームが変わったら前から使い直す（同じ番号を前に使ったフレームは GPU が終えている）
+	if (pool.frame != dxCommon->GetFrameCount()) {
+		pool.frame = dxCommon->GetFrameCount();
+		pool.usedCount = 0;
+	}
+
+	HRESULT result;
+	if (pool.usedCount < pool.entries.size()) {
+		// 各記録先はフレームの中で1回しか渡さないので、前に使ったのは同じ番号の前のフレーム
+		Entry& entry = pool.entries[pool.usedCount];
+		result = entry.commandAllocator->Reset();
+		assert(SUCCEEDED(result));
+		result = entry.commandList->Reset(entry.commandAllocator.Get(), nullptr);
+		assert(SUCCEEDED(result));
+	} else {
+		Entry entry;
+		result = device_->CreateCommandAllocator(
+		    D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&entry.commandAllocator));
+		assert(SUCCEEDED(result));
+		// 作った直後は記録を始めた状態
+		result = device_->CreateCommandList(
+		    0, D3D12_COMMAND_LIST_TYPE_DIRECT, entry.commandAllocator.Get(), nullptr,
+		    IID_PPV_ARGS(&entry.commandList));
+		assert(SUCCEEDED(result));
+		pool.entries.push_back(std::move(entry));
+	}
+	ID3D12GraphicsCommandList* commandList = pool.entries[pool.usedCount++].commandList.Get();
+	dxCommon->PrepareCommandList(commandList);
+	return commandList;
+}
+
+void CommandListPool::Close(ID3D12GraphicsCommandList* commandList) {
+	HRESULT result = commandList->Close();
+	assert(SUCCEEDED(result));
+}
+
+void CommandListPool::Submit(ID3D12GraphicsCommandList* const* commandLists, size_t count) {
+	if (count == 0) {
+		return;
+	}
+	DirectXCommon::GetInstance()->ExecuteCommandLists(commandLists, count);
+}
+
+size_t CommandListPool::GetCommandListCount() const {
+	size_t count = 0;
+	for (const FramePool& pool : framePools_) {
+		count += pool.entries.size();
+	}
+	return count;
+}
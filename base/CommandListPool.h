@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ParallelCommandRecorder.h"
+#include <d3d12.h>
+#include <vector>
+#include <wrl.h>
+
+/// <summary>
+/// 並列記録用のコマンドリストとアロケータ
+/// フレームのコンテキストごとに持ち、同じフレームの中では前から順に使い回す。
+/// アロケータはそのコンテキストを次に使うフレームで最初に受け取るときにリセットする
+/// </summary>
+class CommandListPool : public CommandListBackend<ID3D12GraphicsCommandList> {
+public:
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	void Initialize(ID3D12Device* device);
+
+	/// <summary>
+	/// 記録を始めたコマンドリストの取得（レンダーターゲットとビューポートはセット済み）
+	/// </summary>
+	ID3D12GraphicsCommandList* Acquire() override;
+
+	/// <summary>
+	/// 記録を終える
+	/// </summary>
+	void Close(ID3D12GraphicsCommandList* commandList) override;
+
+	/// <summary>
+	/// 描画コマンドリストに記録済みの分に続けて実行する
+	/// </summary>
+	void Submit(ID3D12GraphicsCommandList* const* commandLists, size_t count) override;
+
+	/// <summary>
+	/// 作ったコマンドリストの数（全フレーム分）
+	/// </summary>
+	size_t GetCommandListCount() const;
+
+private:
+	/// <summary>
+	/// コマンドリストとその記録先
+	/// </summary>
+	struct Entry {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList;
+	};
+
+	/// <summary>
+	/// フレームのコンテキストごとの記録先
+	/// </summary>
+	struct FramePool {
+		std::vector<Entry> entries;
+		// このフレームで使った数
+		size_t usedCount = 0;
+		// 最後に使ったフレーム
+		uint64_t frame = UINT64_MAX;
+	};
+
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// フレームのコンテキストの番号順
+	std::vector<FramePool> framePools_;
+};
@@ -0,0 +1,185 @@
+#include "DdsDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+static_assert(sizeof(DdsDecoder::Header) == 124);
+static_assert(sizeof(DdsDecoder::HeaderDx10) == 20);
+
+// 4文字の FourCC
+constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+	return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) | (uint32_t(uint8_t(c)) << 16) |
+	       (uint32_t(uint8_t(d)) << 24);
+}
+
+// 旧形式のピクセルフォーマットから画素形式を決める（非対応なら kUnknown）
+TextureFormat GetLegacyFormat(const DdsDecoder::PixelFormat& pixelFormat, bool& isAlphaMissing) {
+	isAlphaMissing = false;
+	if (pixelFormat.flags & DdsDecoder::kDdpfFourCC) {
+		switch (pixelFormat.fourCC) {
+		case MakeFourCC('D', 'X', 'T', '1'):
+			return TextureFormat::kBC1Unorm;
+		case MakeFourCC('D', 'X', 'T', '5'):
+			return TextureFormat::kBC3Unorm;
+		case MakeFourCC('A', 'T', 'I', '1'):
+		case MakeFourCC('B', 'C', '4', 'U'):
+			return TextureFormat::kBC4Unorm;
+		case MakeFourCC('A', 'T', 'I', '2'):
+		case MakeFourCC('B', 'C', '5', 'U'):
+			return TextureFormat::kBC5Unorm;
+		default:
+			return TextureFormat::kUnknown;
+		}
+	}
+	if (!(pixelFormat.flags & DdsDecoder::kDdpfRgb) || pixelFormat.rgbBitCount != 32) {
+		return TextureFormat::kUnknown;
+	}
+	isAlphaMissing = !(pixelFormat.flags & DdsDecoder::kDdpfAlphaPixels) || pixelFormat.aBitMask == 0;
+	if (!isAlphaMissing && pixelFormat.aBitMask != 0xff000000) {
+		return TextureFormat::kUnknown;
+	}
+	if (pixelFormat.rBitMask == 0x000000ff && pixelFormat.gBitMask == 0x0000ff00 &&
+	    pixelFormat.bBitMask == 0x00ff0000) {
+		return TextureFormat::kR8G8B8A8Unorm;
+	}
+	if (pixelFormat.rBitMask == 0x00ff0000 && pixelFormat.gBitMask == 0x0000ff00 &&
+	    pixelFormat.bBitMask == 0x000000ff) {
+		return TextureFormat::kB8G8R8A8Unorm;
+	}
+	return TextureFormat::kUnknown;
+}
+
+// アルファの無い形式を不透明にする
+void FillAlpha(uint8_t* pixels, size_t pixelCount) {
+	for (size_t i = 0; i < pixelCount; i++) {
+		pixels[i * 4 + 3] = 0xff;
+	}
+}
+
+} // namespace
+
+bool DdsDecoder::ParseHeader(const uint8_t* data, size_t size, Layout& layout) {
+	if (size < sizeof(uint32_t) + sizeof(Header)) {
+		return false;
+	}
+	uint32_t magic;
+	std::memcpy(&magic, data, sizeof(magic));
+	std::memcpy(&layout.header, data + sizeof(magic), sizeof(Header));
+	const Header& header = layout.header;
+	if (magic != kMagic || header.size != sizeof(Header) || header.width == 0 ||
+	    header.height == 0) {
+		return false;
+	}
+
+	layout.dataOffset = sizeof(uint32_t) + sizeof(Header);
+	layout.isAlphaMissing = false;
+	if ((header.pixelFormat.flags & kDdpfFourCC) && header.pixelFormat.fourCC == kDx10FourCC) {
+		HeaderDx10 headerDx10;
+		if (size < layout.dataOffset + sizeof(HeaderDx10)) {
+			return false;
+		}
+		std::memcpy(&headerDx10, data + layout.dataOffset, sizeof(headerDx10));
+		layout.dataOffset += sizeof(HeaderDx10);
+		if (headerDx10.resourceDimension != kDimensionTexture2D || headerDx10.arraySize != 1) {
+			return false;
+		}
+		layout.format = TextureFormat(headerDx10.dxgiFormat);
+	} else {
+		// 旧形式はキューブマップとボリュームを扱わない
+		if (header.caps2 != 0) {
+			return false;
+		}
+		layout.format = GetLegacyFormat(header.pixelFormat, layout.isAlphaMissing);
+	}
+
+	layout.mipCount = (header.flags & kDdsdMipMapCount) ? (std::max)(header.mipMapCount, 1u) : 1;
+	TextureMip mip;
+	return layout.mipCount <= 32 && ComputeMip(layout.format, header.width, header.height, mip);
+}
+
+bool DdsDecoder::ComputeMip(TextureFormat format, uint32_t width, uint32_t height, TextureMip& mip) {
+	const uint32_t blockSize = GetBlockSize(format);
+	const uint32_t bytesPerPixel = GetBytesPerPixel(format);
+	if (blockSize == 0 && bytesPerPixel == 0) {
+		return false;
+	}
+	mip.width = width;
+	mip.height = height;
+	if (blockSize != 0) {
+		mip.rowPitch = (width + 3) / 4 * blockSize;
+		mip.slicePitch = mip.rowPitch * ((height + 3) / 4);
+	} else {
+		mip.rowPitch = width * bytesPerPixel;
+		mip.slicePitch = mip.rowPitch * height;
+	}
+	return true;
+}
+
+bool DdsDecoder::CanDecode(const uint8_t* data, size_t size) const {
+	uint32_t magic;
+	if (size < sizeof(magic)) {
+		return false;
+	}
+	std::memcpy(&magic, data, sizeof(magic));
+	return magic == kMagic;
+}
+
+bool DdsDecoder::ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const {
+	Layout layout;
+	if (!ParseHeader(data, size, layout)) {
+		return false;
+	}
+	info.format = layout.format;
+	info.width = layout.header.width;
+	info.height = layout.header.height;
+	return true;
+}
+
+bool DdsDecoder::DecodeInto(
+    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const {
+	Layout layout;
+	TextureMip mip;
+	if (!ParseHeader(data, size, layout) ||
+	    !ComputeMip(layout.format, layout.header.width, layout.header.height, mip) ||
+	    size - layout.dataOffset < mip.slicePitch || rowPitch < mip.rowPitch) {
+		return false;
+	}
+	const uint32_t rowCount = mip.slicePitch / mip.rowPitch;
+	for (uint32_t row = 0; row < rowCount; row++) {
+		uint8_t* out = destination + row * rowPitch;
+		std::memcpy(out, data + layout.dataOffset + size_t(row) * mip.rowPitch, mip.rowPitch);
+		if (layout.isAlphaMissing) {
+			FillAlpha(out, mip.width);
+		}
+	}
+	return true;
+}
+
+bool DdsDecoder::Decode(const uint8_t* data, size_t size, TextureData& texture) const {
+	Layout layout;
+	if (!ParseHeader(data, size, layout)) {
+		return false;
+	}
+	TextureData decoded;
+	decoded.format = layout.format;
+	size_t offset = 0;
+	for (uint32_t level = 0; level < layout.mipCount; level++) {
+		TextureMip mip;
+		ComputeMip(
+		    layout.format, (std::max)(layout.header.width >> level, 1u),
+		    (std::max)(layout.header.height >> level, 1u), mip);
+		mip.offset = offset;
+		offset += mip.slicePitch;
+		decoded.mips.push_back(mip);
+	}
+	if (size - layout.dataOffset < offset) {
+		return false;
+	}
+	decoded.pixels.assign(data + layout.dataOffset, data + layout.dataOffset + offset);
+	if (layout.isAlphaMissing) {
+		FillAlpha(decoded.pixels.data(), offset / 4);
+	}
+	texture = std::move(decoded);
+	return true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ImageDecoder.h"
+
+/// <summary>
+/// DDS のデコーダ
+/// DX10 拡張ヘッダ付きのものと、旧形式の FourCC（DXT1 / DXT5 / ATI1 / ATI2 / BC4U / BC5U）と
+/// 32bit の RGBA / BGRA に対応する。画素はそのまま写すだけで、ファイル内のミップも全て読む
+/// </summary>
+class DdsDecoder : public ImageDecoder {
+public:
+	// ファイル識別子 "DDS "
+	static const uint32_t kMagic = 0x20534444;
+	// DX10 拡張ヘッダを示す FourCC "DX10"
+	static const uint32_t kDx10FourCC = 0x30315844;
+
+	// DDS ヘッダのフラグ
+	static const uint32_t kDdsdCaps = 0x1;
+	static const uint32_t kDdsdHeight = 0x2;
+	static const uint32_t kDdsdWidth = 0x4;
+	static const uint32_t kDdsdPitch = 0x8;
+	static const uint32_t kDdsdPixelFormat = 0x1000;
+	static const uint32_t kDdsdMipMapCount = 0x20000;
+	static const uint32_t kDdsdLinearSize = 0x80000;
+	static const uint32_t kDdpfAlphaPixels = 0x1;
+	static const uint32_t kDdpfFourCC = 0x4;
+	static const uint32_t kDdpfRgb = 0x40;
+	static const uint32_t kDdsCapsComplex = 0x8;
+	static const uint32_t kDdsCapsTexture = 0x1000;
+	static const uint32_t kDdsCapsMipMap = 0x400000;
+	// D3D10_RESOURCE_DIMENSION_TEXTURE2D
+	static const uint32_t kDimensionTexture2D = 3;
+
+	/// <summary>
+	/// DDS_PIXELFORMAT
+	/// </summary>
+	struct PixelFormat {
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	/// <summary>
+	/// DDS_HEADER
+	/// </summary>
+	struct Header {
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		PixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	/// <summary>
+	/// DDS_HEADER_DXT10
+	/// </summary>
+	struct HeaderDx10 {
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	/// <summary>
+	/// ヘッダの解析結果
+	/// </summary>
+	struct Layout {
+		Header header;         // ヘッダ
+		TextureFormat format;  // 画素形式
+		uint32_t mipCount;     // ミップ数
+		size_t dataOffset;     // 画素の先頭
+		bool isAlphaMissing;   // アルファの無い 32bit 形式（読み込み時に不透明で埋める）
+	};
+
+	/// <summary>
+	/// ヘッダの解析（2Dテクスチャで、扱える画素形式のものだけ成功する）
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="layout">解析結果</param>
+	/// <returns>成否</returns>
+	static bool ParseHeader(const uint8_t* data, size_t size, Layout& layout);
+
+	/// <summary>
+	/// ミップレベル1枚を隙間なく詰めたときの配置（非対応の形式なら false）
+	/// </summary>
+	static bool ComputeMip(TextureFormat format, uint32_t width, uint32_t height, TextureMip& mip);
+
+	const char* GetName() const override { return "DDS"; }
+	bool CanDecode(const uint8_t* data, size_t size) const override;
+	bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const override;
+	bool DecodeInto(
+	    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const override;
+	bool Decode(const uint8_t* data, size_t size, TextureData& texture) const override;
+};
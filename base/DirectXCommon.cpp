@@ -13,16 +13,72 @@
 
 using namespace Microsoft::WRL;
 
+namespace {
+
+/// <summary>
+/// コマンドキューでシグナルする D3D12 のフェンス
+/// </summary>
+class D3D12FrameFence : public FrameFence {
+public:
+	D3D12FrameFence(ID3D12Device* device, ID3D12CommandQueue* commandQueue)
+	    : commandQueue_(commandQueue) {
+		HRESULT result = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+		assert(SUCCEEDED(result));
+		// 待つたびに作らず使い回す
+		event_ = CreateEvent(nullptr, false, false, nullptr);
+		assert(event_);
+	}
+	~D3D12FrameFence() override { CloseHandle(event_); }
+
+	void Signal(uint64_t value) override { commandQueue_->Signal(fence_.Get(), value); }
+	uint64_t GetCompletedValue() const override { return fence_->GetCompletedValue(); }
+	void Wait(uint64_t value) override {
+		fence_->SetEventOnCompletion(value, event_);
+		WaitForSingleObject(event_, INFINITE);
+	}
+
+private:
+	ID3D12CommandQueue* commandQueue_;
+	ComPtr<ID3D12Fence> fence_;
+	HANDLE event_;
+};
+
+// マップしたままのアップロードバッファを作る
+ComPtr<ID3D12Resource> CreateMappedUploadBuffer(ID3D12Device* device, size_t size, void** mapped) {
+	HRESULT result;
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+	ComPtr<ID3D12Resource> buffer;
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&buffer));
+	assert(SUCCEEDED(result));
+	result = buffer->Map(0, nullptr, mapped);
+	assert(SUCCEEDED(result));
+	return buffer;
+}
+
+// バッファの大きさをリソースの配置境界に切り上げる（輪を回っても確保の境界がずれない）
+size_t AlignFrameMemorySize(size_t size) {
+	const size_t alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	return (size + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
 DirectXCommon* DirectXCommon::GetInstance() {
 	static DirectXCommon instance;
 	return &instance;
 }
 
-void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t backBufferHeight) {
+void DirectXCommon::Initialize(
+    WinApp* winApp, int32_t backBufferWidth, int32_t backBufferHeight,
+    uint32_t frameContextCount) {
 	// nullptrチェック
 	assert(winApp);
 	assert(4 <= backBufferWidth && backBufferWidth <= 4096);
 	assert(4 <= backBufferHeight && backBufferHeight <= 4096);
+	assert(1 <= frameContextCount && frameContextCount <= FrameContextRing::kMaxContextCount);
 
 	// sleepの分解能をあげておく
 	timeBeginPeriod(1);
@@ -36,7 +92,7 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 	InitializeDXGIDevice();
 
 	// コマンド関連初期化
-	InitializeCommand();
+	InitializeCommand(frameContextCount);
 
 	// スワップチェーンの生成
 	CreateSwapChain();
@@ -49,6 +105,9 @@ void DirectXCommon::Initialize(WinApp* winApp, int32_t backBufferWidth, int32_t
 
 	// フェンス生成
 	CreateFence();
+	frameRing_.Initialize(frameFence_.get(), frameContextCount);
+	// 描画中のフレームの分も含めて1つの輪に収める
+	CreateFrameMemory(kFrameMemorySize * frameContextCount);
 }
 
 void DirectXCommon::PreDraw() {
@@ -61,6 +120,18 @@ void DirectXCommon::PreDraw() {
 	    D3D12_RESOURCE_STATE_RENDER_TARGET);
 	commandList_->ResourceBarrier(1, &barrier);
 
+	// レンダーターゲットとビューポートをセット
+	PrepareCommandList(commandList_.Get());
+
+	// 全画面クリア
+	ClearRenderTarget();
+	// 深度バッファクリア
+	ClearDepthBuffer();
+}
+
+void DirectXCommon::PrepareCommandList(ID3D12GraphicsCommandList* commandList) {
+	UINT bbIndex = swapChain_->GetCurrentBackBufferIndex();
+
 	// レンダーターゲットビュー用ディスクリプタヒープのハンドルを取得
 	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvH = CD3DX12_CPU_DESCRIPTOR_HANDLE(
 	    rtvHeap_->GetCPUDescriptorHandleForHeapStart(), bbIndex,
@@ -69,20 +140,31 @@ void DirectXCommon::PreDraw() {
 	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvH =
 	    CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap_->GetCPUDescriptorHandleForHeapStart());
 	// レンダーターゲットをセット
-	commandList_->OMSetRenderTargets(1, &rtvH, false, &dsvH);
-
-	// 全画面クリア
-	ClearRenderTarget();
-	// 深度バッファクリア
-	ClearDepthBuffer();
+	commandList->OMSetRenderTargets(1, &rtvH, false, &dsvH);
 
 	// ビューポートの設定
 	CD3DX12_VIEWPORT viewport =
 	    CD3DX12_VIEWPORT(0.0f, 0.0f, float(backBufferWidth_), float(backBufferHeight_));
-	commandList_->RSSetViewports(1, &viewport);
+	commandList->RSSetViewports(1, &viewport);
 	// シザリング矩形の設定
 	CD3DX12_RECT rect = CD3DX12_RECT(0, 0, backBufferWidth_, backBufferHeight_);
-	commandList_->RSSetScissorRects(1, &rect);
+	commandList->RSSetScissorRects(1, &rect);
+}
+
+void DirectXCommon::ExecuteCommandLists(
+    ID3D12GraphicsCommandList* const* commandLists, size_t count) {
+	// ここまでに描画コマンドリストへ記録した分を先に実行する
+	commandList_->Close();
+	std::vector<ID3D12CommandList*> cmdLists;
+	cmdLists.reserve(count + 1);
+	cmdLists.push_back(commandList_.Get());
+	cmdLists.insert(cmdLists.end(), commandLists, commandLists + count);
+	commandQueue_->ExecuteCommandLists(UINT(cmdLists.size()), cmdLists.data());
+
+	// 同じアロケータの後ろへ続けて記録する（アロケータのリセットは次にこのコンテキストを使うとき）
+	FrameContext& context = frameContexts_[frameRing_.GetContextIndex()];
+	commandList_->Reset(context.commandAllocator.Get(), nullptr);
+	PrepareCommandList(commandList_.Get());
 }
 
 void DirectXCommon::PostDraw() {
@@ -119,14 +201,8 @@ void DirectXCommon::PostDraw() {
 	}
 #endif
 
-	// コマンドリストの実行完了を待つ
-	commandQueue_->Signal(fence_.Get(), ++fenceVal_);
-	if (fence_->GetCompletedValue() != fenceVal_) {
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
-		fence_->SetEventOnCompletion(fenceVal_, event);
-		WaitForSingleObject(event, INFINITE);
-		CloseHandle(event);
-	}
+	// このフレームの完了でシグナルするだけで、ここでは待たない
+	frameMemory_.EndFrame(frameRing_.EndFrame());
 
 	// ウィンドウ閉じるとframeLatencyWaitableObject_をインクリメントする対象がいなくなって0のままになるからInfiniteにしない
 	// 初期化時にframeLatencyWaitableObject_のカウンタを無理やり0にしたのでこの対応がいる。
@@ -156,8 +232,50 @@ void DirectXCommon::PostDraw() {
 	    std::chrono::steady_clock::now() - reference_);
 	reference_ = std::chrono::steady_clock::now();
 
-	commandAllocator_->Reset();
-	commandList_->Reset(commandAllocator_.Get(), nullptr);
+	// 次のフレームのコンテキストを前に使ったフレームの完了だけを待って使い回す
+	BeginFrameContext();
+}
+
+DirectXCommon::FrameAllocation DirectXCommon::AllocateFrameMemory(size_t size, size_t alignment) {
+	assert(alignment <= D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+	// 輪から切り出すだけなので、ワーカースレッドから同時に呼んでもロックしない
+	size_t offset = frameMemory_.Allocate(size, alignment);
+	if (offset != FrameLinearAllocator::kInvalidOffset) {
+		return {frameMemoryMapped_ + offset, frameMemoryAddress_ + offset};
+	}
+
+	// 足りなければこのフレームの分だけ別に作り、次のフレームの始めに輪を大きくする
+	std::lock_guard<std::mutex> lock(frameContextMutex_);
+	frameMemoryOverflow_ += size;
+	void* mapped = nullptr;
+	ComPtr<ID3D12Resource> buffer = CreateMappedUploadBuffer(device_.Get(), size, &mapped);
+	D3D12_GPU_VIRTUAL_ADDRESS address = buffer->GetGPUVirtualAddress();
+	frameContexts_[frameRing_.GetContextIndex()].releaseQueue.push_back(std::move(buffer));
+	return {mapped, address};
+}
+
+void DirectXCommon::DeferRelease(ComPtr<ID3D12Pageable> object) {
+	if (object) {
+		std::lock_guard<std::mutex> lock(frameContextMutex_);
+		// 今のフレームまでのコマンドが参照しうるので、このコンテキストを次に使うときに解放する
+		frameContexts_[frameRing_.GetContextIndex()].releaseQueue.push_back(std::move(object));
+	}
+}
+
+void DirectXCommon::BeginFrameContext() {
+	FrameContext& context = frameContexts_[frameRing_.BeginFrame()];
+	context.releaseQueue.clear();
+
+	// 完了したフレームの領域を返す
+	frameMemory_.Reclaim(frameRing_.GetCompletedValue());
+	if (frameMemoryOverflow_ != 0) {
+		CreateFrameMemory((std::max)(
+		    frameMemory_.GetCapacity() * 2, frameMemory_.GetCapacity() + frameMemoryOverflow_));
+		frameMemoryOverflow_ = 0;
+	}
+
+	context.commandAllocator->Reset();
+	commandList_->Reset(context.commandAllocator.Get(), nullptr);
 }
 
 void DirectXCommon::ClearRenderTarget() {
@@ -173,12 +291,14 @@ void DirectXCommon::ClearRenderTarget() {
 	commandList_->ClearRenderTargetView(rtvH, clearColor, 0, nullptr);
 }
 
-void DirectXCommon::ClearDepthBuffer() {
+void DirectXCommon::ClearDepthBuffer() { ClearDepthBuffer(commandList_.Get()); }
+
+void DirectXCommon::ClearDepthBuffer(ID3D12GraphicsCommandList* commandList) {
 	// 深度ステンシルビュー用デスクリプタヒープのハンドルを取得
 	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvH =
 	    CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap_->GetCPUDescriptorHandleForHeapStart());
 	// 深度バッファのクリア
-	commandList_->ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+	commandList->ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 }
 
 int32_t DirectXCommon::GetBackBufferWidth() const { return backBufferWidth_; }
@@ -330,17 +450,20 @@ void DirectXCommon::CreateSwapChain() {
 	    winApp_->GetHwnd(), DXGI_MWA_NO_WINDOW_CHANGES | DXGI_MWA_NO_ALT_ENTER);
 }
 
-void DirectXCommon::InitializeCommand() {
+void DirectXCommon::InitializeCommand(uint32_t frameContextCount) {
 	HRESULT result = S_FALSE;
 
-	// コマンドアロケータを生成
-	result = device_->CreateCommandAllocator(
-	    D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-	assert(SUCCEEDED(result));
+	// コマンドアロケータをフレームごとに生成
+	frameContexts_.resize(frameContextCount);
+	for (FrameContext& context : frameContexts_) {
+		result = device_->CreateCommandAllocator(
+		    D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&context.commandAllocator));
+		assert(SUCCEEDED(result));
+	}
 
-	// コマンドリストを生成
+	// コマンドリストを生成（最初のフレームは0番のコンテキストで記録する）
 	result = device_->CreateCommandList(
-	    0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr,
+	    0, D3D12_COMMAND_LIST_TYPE_DIRECT, frameContexts_[0].commandAllocator.Get(), nullptr,
 	    IID_PPV_ARGS(&commandList_));
 	assert(SUCCEEDED(result));
 
@@ -417,10 +540,19 @@ void DirectXCommon::CreateDepthBuffer() {
 	    depthBuffer_.Get(), &dsvDesc, dsvHeap_->GetCPUDescriptorHandleForHeapStart());
 }
 
-void DirectXCommon::CreateFence() {
-	HRESULT result = S_FALSE;
+void DirectXCommon::CreateFrameMemory(size_t capacity) {
+	capacity = AlignFrameMemorySize(capacity);
+	// 描画中のフレームが参照しているので、古い輪は今のフレームが終わってから解放する
+	DeferRelease(std::move(frameMemoryBuffer_));
+
+	void* mapped = nullptr;
+	frameMemoryBuffer_ = CreateMappedUploadBuffer(device_.Get(), capacity, &mapped);
+	frameMemoryMapped_ = static_cast<uint8_t*>(mapped);
+	frameMemoryAddress_ = frameMemoryBuffer_->GetGPUVirtualAddress();
+	frameMemory_.Initialize(capacity);
+}
 
+void DirectXCommon::CreateFence() {
 	// フェンスの生成
-	result = device_->CreateFence(fenceVal_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
-	assert(SUCCEEDED(result));
+	frameFence_ = std::make_unique<D3D12FrameFence>(device_.Get(), commandQueue_.Get());
 }
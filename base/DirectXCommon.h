@@ -6,14 +6,41 @@
 #include <d3d12.h>
 #include <d3dx12.h>
 #include <dxgi1_6.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <wrl.h>
 
+#include "FrameContextRing.h"
+#include "FrameLinearAllocator.h"
 #include "WinApp.h"
 
 /// <summary>
 /// DirectX汎用
+/// コマンドアロケータをフレームごとのコンテキストに持ち、複数のフレームを同時に描画中にする。
+/// PostDraw では次に使うコンテキストを前に使ったフレームの完了だけを待つ。
+/// 使い捨てのアップロード領域は1つの輪から切り出し、フレームの完了ごとに返す
 /// </summary>
 class DirectXCommon {
+public: // 定数
+	// 同時に描画中にできるフレーム数の既定値（1なら毎フレーム GPU の完了を待つ）
+	// Sprite・WorldTransform・ViewProjection・Material・PrimitiveDrawer（ライブラリ側）は
+	// マップしたままの定数バッファを毎フレーム書き換えるので、2以上にすると描画中のフレームが読む値を上書きしてしまう。
+	// これらが AllocateFrameMemory から確保するようになるまでは1のままにし、2以上は Initialize で明示する
+	static const uint32_t kDefaultFrameContextCount = 1;
+	// 1フレームで使い捨てるアップロード領域の初期バイト数（輪はフレーム数分。足りなくなると倍に増やす）
+	static const size_t kFrameMemorySize = 1024 * 1024;
+
+	/// <summary>
+	/// フレームごとのアップロード領域から確保した領域
+	/// </summary>
+	struct FrameAllocation {
+		// 書き込み先（マップ済み）
+		void* data;
+		// GPU仮想アドレス
+		D3D12_GPU_VIRTUAL_ADDRESS address;
+	};
+
 public: // メンバ関数
 	/// <summary>
 	/// シングルトンインスタンスの取得
@@ -24,9 +51,11 @@ public: // メンバ関数
 	/// <summary>
 	/// 初期化
 	/// </summary>
+	/// <param name="frameContextCount">同時に描画中にできるフレーム数（1なら毎フレームGPUの完了を待つ）</param>
 	void Initialize(
 	    WinApp* win, int32_t backBufferWidth = WinApp::kWindowWidth,
-	    int32_t backBufferHeight = WinApp::kWindowHeight);
+	    int32_t backBufferHeight = WinApp::kWindowHeight,
+	    uint32_t frameContextCount = kDefaultFrameContextCount);
 
 	/// <summary>
 	/// 描画前処理
@@ -48,6 +77,28 @@ public: // メンバ関数
 	/// </summary>
 	void ClearDepthBuffer();
 
+	/// <summary>
+	/// 深度バッファのクリア（並列記録用のコマンドリストへ記録する）
+	/// </summary>
+	/// <param name="commandList">コマンドリスト</param>
+	void ClearDepthBuffer(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 描画コマンドリスト以外のコマンドリストへ、今のバックバッファのレンダーターゲットとビューポートをセットする
+	/// </summary>
+	/// <param name="commandList">記録中のコマンドリスト</param>
+	void PrepareCommandList(ID3D12GraphicsCommandList* commandList);
+
+	/// <summary>
+	/// 描画コマンドリストに記録済みの分に続けて、閉じたコマンドリストを並べた順に実行する
+	/// 描画コマンドリストは同じフレームのまま記録を再開するが、戻ったときにセット済みなのは
+	/// レンダーターゲット・ビューポート・シザー矩形だけで、ルートシグネチャ・パイプライン・
+	/// プリミティブトポロジ・デスクリプタヒープは残っていない。続けて描画するなら Model::PreDraw などでセットし直す
+	/// </summary>
+	/// <param name="commandLists">閉じたコマンドリスト（提出順）</param>
+	/// <param name="count">数</param>
+	void ExecuteCommandLists(ID3D12GraphicsCommandList* const* commandLists, size_t count);
+
 	/// <summary>
 	/// デバイスの取得
 	/// </summary>
@@ -60,6 +111,12 @@ public: // メンバ関数
 	/// <returns>描画コマンドリスト</returns>
 	ID3D12GraphicsCommandList* GetCommandList() const { return commandList_.Get(); }
 
+	/// <summary>
+	/// 描画コマンドキューの取得
+	/// </summary>
+	/// <returns>描画コマンドキュー</returns>
+	ID3D12CommandQueue* GetCommandQueue() const { return commandQueue_.Get(); }
+
 	/// <summary>
 	/// バックバッファの幅取得
 	/// </summary>
@@ -75,6 +132,56 @@ public: // メンバ関数
 	// バックバッファの数を取得
 	size_t GetBackBufferCount() const { return backBuffers_.size(); }
 
+	/// <summary>
+	/// 提出したフレーム数の取得（PostDrawのたびに増える。GPUはまだ描画中かもしれない）
+	/// </summary>
+	/// <returns>フレーム数</returns>
+	uint64_t GetFrameCount() const { return frameRing_.GetFrameCount(); }
+
+	/// <summary>
+	/// 今のフレームのコンテキストの番号（0 から GetFrameContextCount() - 1）
+	/// フレームごとに複数持つバッファの選択に使う。同じ番号のフレームは GPU の描画が終わってから始まる
+	/// </summary>
+	uint32_t GetFrameIndex() const { return frameRing_.GetContextIndex(); }
+
+	/// <summary>
+	/// 同時に描画中にできるフレーム数
+	/// </summary>
+	uint32_t GetFrameContextCount() const { return frameRing_.GetContextCount(); }
+
+	/// <summary>
+	/// 今のフレームで使い捨てるアップロード領域の確保
+	/// GPU がこのフレームを描画し終えるまで有効（定数バッファやインスタンスデータ向け）
+	/// 並列記録中のワーカースレッドから呼んでもよい（ロックせずに切り出す）
+	/// </summary>
+	/// <param name="size">バイト数</param>
+	/// <param name="alignment">アドレスの境界（2のべき乗）</param>
+	/// <returns>確保した領域</returns>
+	FrameAllocation AllocateFrameMemory(
+	    size_t size, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/// <summary>
+	/// 描画中のフレームが参照しているかもしれないオブジェクトを、そのフレームが終わってから解放する
+	/// </summary>
+	/// <param name="object">リソースやデスクリプタヒープ</param>
+	void DeferRelease(Microsoft::WRL::ComPtr<ID3D12Pageable> object);
+
+	/// <summary>
+	/// 提出した全てのフレームの GPU の完了を待つ（終了時やリソースの作り直しの前に呼ぶ）
+	/// </summary>
+	void WaitForGpu() { frameRing_.WaitIdle(); }
+
+private: // 型
+	/// <summary>
+	/// フレームごとのコンテキスト（GPU がそのフレームを描画し終えるまで書き換えない）
+	/// </summary>
+	struct FrameContext {
+		// コマンドアロケータ
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+		// このフレームの完了を待って解放するオブジェクト
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Pageable>> releaseQueue;
+	};
+
 private: // メンバ変数
 	// ウィンドウズアプリケーション管理
 	WinApp* winApp_;
@@ -83,15 +190,27 @@ private: // メンバ変数
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory_;
 	Microsoft::WRL::ComPtr<ID3D12Device> device_;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator_;
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue_;
 	Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain_;
 	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> backBuffers_;
 	Microsoft::WRL::ComPtr<ID3D12Resource> depthBuffer_;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtvHeap_;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> dsvHeap_;
-	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
-	UINT64 fenceVal_ = 0;
+	// フレームごとのコンテキスト
+	std::vector<FrameContext> frameContexts_;
+	// フレームの完了を知らせるフェンス
+	std::unique_ptr<FrameFence> frameFence_;
+	// 使うコンテキストの順番とフェンス値の管理
+	FrameContextRing frameRing_;
+	// 解放待ちの保護用（並列記録中のワーカースレッドからも積む）
+	std::mutex frameContextMutex_;
+	// 使い捨てのアップロード領域の輪（アンマップせずに使い続ける）
+	Microsoft::WRL::ComPtr<ID3D12Resource> frameMemoryBuffer_;
+	uint8_t* frameMemoryMapped_ = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS frameMemoryAddress_ = 0;
+	FrameLinearAllocator frameMemory_;
+	// 輪に収まらずに別に作った領域のバイト数（次のフレームの始めに輪を大きくする）
+	size_t frameMemoryOverflow_ = 0;
 	int32_t backBufferWidth_ = 0;
 	int32_t backBufferHeight_ = 0;
 	HANDLE frameLatencyWaitableObject_;
@@ -117,7 +236,8 @@ private: // メンバ関数
 	/// <summary>
 	/// コマンド関連初期化
 	/// </summary>
-	void InitializeCommand();
+	/// <param name="frameContextCount">フレームごとのコンテキスト数</param>
+	void InitializeCommand(uint32_t frameContextCount);
 
 	/// <summary>
 	/// レンダーターゲット生成
@@ -129,8 +249,19 @@ private: // メンバ関数
 	/// </summary>
 	void CreateDepthBuffer();
 
+	/// <summary>
+	/// 使い捨てのアップロード領域の輪の生成（古い輪は描画中のフレームが終わってから解放する）
+	/// </summary>
+	/// <param name="capacity">バイト数</param>
+	void CreateFrameMemory(size_t capacity);
+
 	/// <summary>
 	/// フェンス生成
 	/// </summary>
 	void CreateFence();
+
+	/// <summary>
+	/// 次のフレームのコンテキストを待ってリセットし、コマンドリストの記録を始める
+	/// </summary>
+	void BeginFrameContext();
 };
@@ -0,0 +1,40 @@
+#include "FrameContextRing.h"
+#include <cassert>
+
+void FrameContextRing::Initialize(FrameFence* fence, uint32_t contextCount) {
+	assert(fence);
+	assert(1 <= contextCount && contextCount <= kMaxContextCount);
+	fence_ = fence;
+	fenceValues_.assign(contextCount, 0);
+	contextIndex_ = 0;
+	frameCount_ = 0;
+	// フェンスの初期値より後ろからシグナルする
+	lastSignaledValue_ = fence_->GetCompletedValue();
+	waitCount_ = 0;
+}
+
+uint64_t FrameContextRing::EndFrame() {
+	const uint64_t value = ++lastSignaledValue_;
+	fence_->Signal(value);
+	fenceValues_[contextIndex_] = value;
+	contextIndex_ = (contextIndex_ + 1) % GetContextCount();
+	frameCount_++;
+	return value;
+}
+
+uint32_t FrameContextRing::BeginFrame() {
+	// この番号を前に使ったフレームだけを待てばよい
+	WaitFor(fenceValues_[contextIndex_]);
+	return contextIndex_;
+}
+
+void FrameContextRing::WaitIdle() { WaitFor(lastSignaledValue_); }
+
+void FrameContextRing::WaitFor(uint64_t value) {
+	if (value == 0 || value <= fence_->GetCompletedValue()) {
+		return;
+	}
+	fence_->Wait(value);
+	waitCount_++;
+	assert(value <= fence_->GetCompletedValue());
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// フレームの完了を知らせるフェンス
+/// FrameContextRing はこれを通してだけGPUとやり取りするので、偽物に差し替えてデバイス無しで確かめられる
+/// </summary>
+class FrameFence {
+public:
+	virtual ~FrameFence() = default;
+
+	/// <summary>
+	/// 提出したコマンドの後ろでシグナルする値を積む
+	/// </summary>
+	/// <param name="value">フェンス値</param>
+	virtual void Signal(uint64_t value) = 0;
+
+	/// <summary>
+	/// 完了済みのフェンス値
+	/// </summary>
+	virtual uint64_t GetCompletedValue() const = 0;
+
+	/// <summary>
+	/// フェンス値が完了するまで待つ
+	/// </summary>
+	/// <param name="value">フェンス値</param>
+	virtual void Wait(uint64_t value) = 0;
+};
+
+/// <summary>
+/// 同時に描画中にできるフレームの管理
+/// フレームごとのコンテキスト（コマンドアロケータやアップロード領域）を番号で順に使い回し、
+/// EndFrame でそのフレームのフェンス値を記録する。BeginFrame では使い回す番号のフレームだけを待つので、
+/// GPU が前のフレームを描画している間に CPU は次のフレームを記録できる
+/// </summary>
+class FrameContextRing {
+public:
+	// コンテキスト数の上限
+	static const uint32_t kMaxContextCount = 4;
+
+	/// <summary>
+	/// 初期化（番号0のフレームを開始した状態になる）
+	/// </summary>
+	/// <param name="fence">フェンス</param>
+	/// <param name="contextCount">コンテキスト数（1なら毎フレームGPUの完了を待つ）</param>
+	void Initialize(FrameFence* fence, uint32_t contextCount);
+
+	/// <summary>
+	/// 今のフレームの提出を記録し、次のフレームの番号へ進める
+	/// </summary>
+	/// <returns>今のフレームの完了でシグナルされるフェンス値</returns>
+	uint64_t EndFrame();
+
+	/// <summary>
+	/// 次のフレームを開始する（その番号を前に使ったフレームが終わっていなければ待つ）
+	/// 戻ったらその番号のコンテキストは GPU から参照されていないので、リセットしてよい
+	/// </summary>
+	/// <returns>コンテキストの番号</returns>
+	uint32_t BeginFrame();
+
+	/// <summary>
+	/// 提出した全てのフレームの完了を待つ
+	/// </summary>
+	void WaitIdle();
+
+	/// <summary>
+	/// 今のフレームのコンテキストの番号
+	/// </summary>
+	uint32_t GetContextIndex() const { return contextIndex_; }
+
+	uint32_t GetContextCount() const { return uint32_t(fenceValues_.size()); }
+
+	/// <summary>
+	/// 提出したフレーム数（今のフレームの番号）
+	/// </summary>
+	uint64_t GetFrameCount() const { return frameCount_; }
+
+	/// <summary>
+	/// 最後に提出したフレームのフェンス値
+	/// </summary>
+	uint64_t GetLastSignaledValue() const { return lastSignaledValue_; }
+
+	/// <summary>
+	/// 完了済みのフェンス値
+	/// </summary>
+	uint64_t GetCompletedValue() const { return fence_->GetCompletedValue(); }
+
+	/// <summary>
+	/// GPU の完了を実際に待った回数（完了済みで待たずに済んだ分は数えない）
+	/// </summary>
+	uint64_t GetWaitCount() const { return waitCount_; }
+
+private:
+	// フェンス
+	FrameFence* fence_ = nullptr;
+	// コンテキストごとの、最後に使ったフレームのフェンス値（0なら未使用）
+	std::vector<uint64_t> fenceValues_;
+	// 今のフレームのコンテキストの番号
+	uint32_t contextIndex_ = 0;
+	// 提出したフレーム数
+	uint64_t frameCount_ = 0;
+	// 最後にシグナルしたフェンス値
+	uint64_t lastSignaledValue_ = 0;
+	// 待った回数
+	uint64_t waitCount_ = 0;
+
+	/// <summary>
+	/// フェンス値が完了していなければ待つ
+	/// </summary>
+	void WaitFor(uint64_t value);
+};
@@ -0,0 +1,46 @@
+#include "FrameLinearAllocator.h"
+#include <cassert>
+
+void FrameLinearAllocator::Initialize(size_t capacity) {
+	capacity_ = capacity;
+	head_.store(0, std::memory_order_relaxed);
+	tail_ = 0;
+	frames_.clear();
+}
+
+size_t FrameLinearAllocator::Allocate(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	// 境界の倍数でなければ先頭へ回ったときにずれる
+	assert(capacity_ % alignment == 0);
+	if (capacity_ == 0 || capacity_ < size) {
+		return kInvalidOffset;
+	}
+
+	// 位置を増やすだけなので、ロックせずに取り合う
+	uint64_t current = head_.load(std::memory_order_relaxed);
+	for (;;) {
+		uint64_t start = (current + alignment - 1) & ~uint64_t(alignment - 1);
+		// 末尾に収まらなければ残りを捨てて先頭へ回る
+		if (capacity_ - start % capacity_ < size) {
+			start = (start / capacity_ + 1) * capacity_;
+		}
+		// 描画中のフレームの領域に追いつく
+		if (capacity_ < start + size - tail_) {
+			return kInvalidOffset;
+		}
+		if (head_.compare_exchange_weak(current, start + size, std::memory_order_relaxed)) {
+			return size_t(start % capacity_);
+		}
+	}
+}
+
+void FrameLinearAllocator::EndFrame(uint64_t fenceValue) {
+	frames_.push_back({fenceValue, head_.load(std::memory_order_relaxed)});
+}
+
+void FrameLinearAllocator::Reclaim(uint64_t completedValue) {
+	while (!frames_.empty() && frames_.front().fenceValue <= completedValue) {
+		tail_ = frames_.front().head;
+		frames_.pop_front();
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+/// <summary>
+/// フレームごとに使い捨てる領域の線形確保
+/// 1つの大きなバッファを輪として先頭から順に切り出し、フレームの終わりに位置とフェンス値を記録する。
+/// フェンス値が完了したフレームの分だけ後ろを解放するので、複数のフレームを同時に描画中にできる。
+/// 扱うのはバッファ内のオフセットだけで、GPU のリソースには触れない
+/// </summary>
+class FrameLinearAllocator {
+public:
+	// 確保に失敗したときのオフセット
+	static const size_t kInvalidOffset = SIZE_MAX;
+
+	/// <summary>
+	/// 初期化（全て空いた状態になる）
+	/// </summary>
+	/// <param name="capacity">バッファのバイト数（確保で使う境界の倍数）</param>
+	void Initialize(size_t capacity);
+
+	/// <summary>
+	/// 確保（どのスレッドからでも同時に呼べる）
+	/// 末尾に収まらなければ先頭へ回る
+	/// </summary>
+	/// <param name="size">バイト数</param>
+	/// <param name="alignment">オフセットの境界（2のべき乗）</param>
+	/// <returns>バッファ内のオフセット（空きが足りなければ kInvalidOffset）</returns>
+	size_t Allocate(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 今のフレームで確保した分を、フェンス値が完了するまで使用中として記録する（Allocate と同時に呼ばない）
+	/// </summary>
+	/// <param name="fenceValue">このフレームの完了でシグナルされるフェンス値</param>
+	void EndFrame(uint64_t fenceValue);
+
+	/// <summary>
+	/// 完了したフレームの分を解放する（Allocate と同時に呼ばない）
+	/// </summary>
+	/// <param name="completedValue">完了済みのフェンス値</param>
+	void Reclaim(uint64_t completedValue);
+
+	size_t GetCapacity() const { return capacity_; }
+
+	/// <summary>
+	/// 使用中のバイト数（先頭へ回るときに捨てた末尾を含む）
+	/// </summary>
+	size_t GetUsedSize() const { return size_t(head_.load(std::memory_order_relaxed) - tail_); }
+
+	/// <summary>
+	/// 完了を待っているフレーム数
+	/// </summary>
+	size_t GetPendingFrameCount() const { return frames_.size(); }
+
+private:
+	/// <summary>
+	/// 完了を待っているフレーム
+	/// </summary>
+	struct PendingFrame {
+		uint64_t fenceValue;
+		// このフレームの最後に確保した位置
+		uint64_t head;
+	};
+
+	// バッファのバイト数
+	size_t capacity_ = 0;
+	// 次に確保する位置（先頭へ回った回数も含めて増え続ける）
+	std::atomic<uint64_t> head_{0};
+	// 使用中の最も古い位置
+	uint64_t tail_ = 0;
+	// 完了を待っているフレーム（古い順）
+	std::deque<PendingFrame> frames_;
+};
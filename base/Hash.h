@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// FNV-1a (64bit) の初期値
+const uint64_t kHashOffsetBasis = 0xcbf29ce484222325ull;
+
+/// <summary>
+/// FNV-1a (64bit) ハッシュ
+/// </summary>
+/// <param name="data">データ</param>
+/// <param name="size">バイト数</param>
+/// <param name="seed">初期値（続けて計算する場合は前回の結果）</param>
+/// <returns>ハッシュ値</returns>
+inline uint64_t Hash64(const void* data, size_t size, uint64_t seed = kHashOffsetBasis) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
@@ -0,0 +1,59 @@
+#include "ImageDecoder.h"
+#include "DdsDecoder.h"
+#include "JpegDecoder.h"
+#include "MappedFile.h"
+#include "PngDecoder.h"
+#include "TgaDecoder.h"
+
+bool ImageDecoder::Decode(const uint8_t* data, size_t size, TextureData& texture) const {
+	ImageInfo info;
+	if (!ReadInfo(data, size, info)) {
+		return false;
+	}
+	TextureData decoded;
+	decoded.Allocate(info.format, info.width, info.height);
+	if (!DecodeInto(data, size, decoded.pixels.data(), decoded.mips[0].rowPitch)) {
+		return false;
+	}
+	texture = std::move(decoded);
+	return true;
+}
+
+ImageDecoderRegistry* ImageDecoderRegistry::GetInstance() {
+	static ImageDecoderRegistry instance;
+	return &instance;
+}
+
+ImageDecoderRegistry::ImageDecoderRegistry() {
+	// TGA は識別子が無くヘッダの妥当性でしか判定できないので最後に試す
+	decoders_.push_back(std::make_unique<PngDecoder>());
+	decoders_.push_back(std::make_unique<JpegDecoder>());
+	decoders_.push_back(std::make_unique<DdsDecoder>());
+	decoders_.push_back(std::make_unique<TgaDecoder>());
+}
+
+void ImageDecoderRegistry::Register(std::unique_ptr<ImageDecoder> decoder) {
+	decoders_.insert(decoders_.begin(), std::move(decoder));
+}
+
+const ImageDecoder* ImageDecoderRegistry::Find(const uint8_t* data, size_t size) const {
+	for (const std::unique_ptr<ImageDecoder>& decoder : decoders_) {
+		if (decoder->CanDecode(data, size)) {
+			return decoder.get();
+		}
+	}
+	return nullptr;
+}
+
+bool ImageDecoderRegistry::Decode(const uint8_t* data, size_t size, TextureData& texture) const {
+	const ImageDecoder* decoder = Find(data, size);
+	return decoder && decoder->Decode(data, size, texture);
+}
+
+bool ImageDecoderRegistry::DecodeFile(const std::string& filePath, TextureData& texture) const {
+	MappedFile file;
+	if (!file.Open(filePath)) {
+		return false;
+	}
+	return Decode(file.GetData(), file.GetSize(), texture);
+}
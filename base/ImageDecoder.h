@@ -0,0 +1,121 @@
+#pragma once
+
+#include "TextureData.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// 画像ファイルのデコーダ
+/// 状態を持たないので、1つのインスタンスを複数のワーカースレッドから同時に使える
+/// </summary>
+class ImageDecoder {
+public:
+	/// <summary>
+	/// ヘッダから分かる画像の情報
+	/// </summary>
+	struct ImageInfo {
+		TextureFormat format = TextureFormat::kUnknown; // デコード結果の画素形式
+		uint32_t width = 0;                             // 幅
+		uint32_t height = 0;                            // 高さ
+	};
+
+	virtual ~ImageDecoder() = default;
+
+	/// <summary>
+	/// 形式の名前
+	/// </summary>
+	virtual const char* GetName() const = 0;
+
+	/// <summary>
+	/// 先頭のバイト列から、扱える形式か判定する
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	virtual bool CanDecode(const uint8_t* data, size_t size) const = 0;
+
+	/// <summary>
+	/// ヘッダの読み込み
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="info">画像の情報</param>
+	/// <returns>デコードできる画像か</returns>
+	virtual bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const = 0;
+
+	/// <summary>
+	/// 呼び出し側が用意したバッファへミップレベル0をデコードする（アップロード用のバッファへ直接書ける）
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="destination">書き込み先（ReadInfo の大きさと形式で rowPitch * 行数 バイト）</param>
+	/// <param name="rowPitch">書き込み先の1ライン（ブロック圧縮なら1ブロック行）のバイト数</param>
+	/// <returns>成否（途中で失敗した場合、書き込み先の内容は不定）</returns>
+	virtual bool DecodeInto(
+	    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const = 0;
+
+	/// <summary>
+	/// 画像全体のデコード（既定ではミップレベル0だけを隙間なく詰める）
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="texture">画像</param>
+	/// <returns>成否</returns>
+	virtual bool Decode(const uint8_t* data, size_t size, TextureData& texture) const;
+};
+
+/// <summary>
+/// 画像デコーダの登録先
+/// 先頭のバイト列で形式を判定し、対応するデコーダを選ぶ。PNG / JPEG / TGA / DDS は最初から登録されている
+/// </summary>
+class ImageDecoderRegistry {
+public:
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ImageDecoderRegistry* GetInstance();
+
+	/// <summary>
+	/// デコーダの登録（後から登録したものを優先する）
+	/// 読み込み中のスレッドとは排他しないので、テクスチャの読み込みを始める前に呼ぶこと
+	/// </summary>
+	/// <param name="decoder">デコーダ</param>
+	void Register(std::unique_ptr<ImageDecoder> decoder);
+
+	/// <summary>
+	/// 扱えるデコーダの検索
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <returns>デコーダ（無ければ nullptr）</returns>
+	const ImageDecoder* Find(const uint8_t* data, size_t size) const;
+
+	/// <summary>
+	/// メモリ上の画像のデコード
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="texture">画像</param>
+	/// <returns>成否（扱えるデコーダが無い場合も false）</returns>
+	bool Decode(const uint8_t* data, size_t size, TextureData& texture) const;
+
+	/// <summary>
+	/// 画像ファイルのデコード（メモリマップして読む）
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="texture">画像</param>
+	/// <returns>成否</returns>
+	bool DecodeFile(const std::string& filePath, TextureData& texture) const;
+
+private:
+	ImageDecoderRegistry();
+	~ImageDecoderRegistry() = default;
+	ImageDecoderRegistry(const ImageDecoderRegistry&) = delete;
+	ImageDecoderRegistry& operator=(const ImageDecoderRegistry&) = delete;
+
+	// 登録されたデコーダ（先頭ほど優先）
+	std::vector<std::unique_ptr<ImageDecoder>> decoders_;
+};
@@ -0,0 +1,421 @@
+#include "Inflate.h"
+#include "SimdConfig.h"
+#include <cstring>
+
+namespace {
+
+// 1回の表引きで解く符号のビット数
+const int kFastBits = 10;
+// 符号の最大ビット数
+const int kMaxCodeLength = 15;
+
+// 長さ符号（257～285）の基本値と追加ビット数
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+// 距離符号（0～29）の基本値と追加ビット数
+const uint16_t kDistanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                    33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+// 符号長の符号の並び順
+const uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// 16ビットの並びを反転する
+uint32_t Reverse16(uint32_t value) {
+	value = ((value >> 1) & 0x5555) | ((value & 0x5555) << 1);
+	value = ((value >> 2) & 0x3333) | ((value & 0x3333) << 2);
+	value = ((value >> 4) & 0x0f0f) | ((value & 0x0f0f) << 4);
+	return ((value >> 8) & 0x00ff) | ((value & 0x00ff) << 8);
+}
+
+// 下位 bitCount ビットの並びを反転する
+uint32_t ReverseBits(uint32_t value, int bitCount) { return Reverse16(value) >> (16 - bitCount); }
+
+// 下位ビットから読むビット列
+class BitReader {
+public:
+	BitReader(const uint8_t* data, size_t size) : position_(data), end_(data + size) {}
+
+	// 少なくとも56ビットを溜める（データの終わりより先は0として読み、読みすぎを数える）
+	void Refill() {
+		if (8 <= end_ - position_) {
+			// 8バイトまとめて読み、入りきったバイト数だけ進める（リトルエンディアン前提）。
+			// 溜めたビットより上には次のバイトの下位ビットが入るが、次に読むときに同じ値を重ねるだけなので壊れない
+			uint64_t word;
+			std::memcpy(&word, position_, sizeof(word));
+			buffer_ |= word << bitCount_;
+			position_ += (63 - bitCount_) >> 3;
+			bitCount_ |= 56;
+			return;
+		}
+		while (bitCount_ <= 56) {
+			uint64_t byte = 0;
+			if (position_ < end_) {
+				byte = *position_++;
+			} else {
+				overrunBytes_++;
+			}
+			buffer_ |= byte << bitCount_;
+			bitCount_ += 8;
+		}
+	}
+
+	uint32_t Peek(int bitCount) const { return uint32_t(buffer_ & ((1ull << bitCount) - 1)); }
+
+	void Consume(int bitCount) {
+		buffer_ >>= bitCount;
+		bitCount_ -= bitCount;
+	}
+
+	uint32_t Read(int bitCount) {
+		if (bitCount_ < bitCount) {
+			Refill();
+		}
+		uint32_t value = Peek(bitCount);
+		Consume(bitCount);
+		return value;
+	}
+
+	// バイト境界まで読み飛ばす
+	void AlignToByte() { Consume(bitCount_ % 8); }
+
+	// 溜めたビットを含めて、バイト単位でそのまま読む
+	bool ReadBytes(uint8_t* destination, size_t size) {
+		while (size != 0 && 8 <= bitCount_) {
+			*destination++ = uint8_t(Read(8));
+			size--;
+		}
+		// 溜めたビットより上に残った先読みの分は、読み飛ばした後では合わなくなるので捨てる
+		if (bitCount_ == 0) {
+			buffer_ = 0;
+		}
+		// 溜めたビットには読みすぎた0が含まれることがある
+		if (IsOverrun() || size_t(end_ - position_) < size) {
+			return false;
+		}
+		std::memcpy(destination, position_, size);
+		position_ += size;
+		return true;
+	}
+
+	// データの終わりを越えて読んだか
+	bool IsOverrun() const { return size_t(bitCount_ / 8) < overrunBytes_; }
+
+private:
+	const uint8_t* position_;
+	const uint8_t* end_;
+	uint64_t buffer_ = 0;
+	int bitCount_ = 0;
+	size_t overrunBytes_ = 0;
+};
+
+// 正準ハフマン符号の復号表
+class Huffman {
+public:
+	// 符号長から表を作る（符号が多すぎれば false）
+	bool Build(const uint8_t* lengths, int count) {
+		int lengthCounts[kMaxCodeLength + 1] = {};
+		std::memset(fast_, 0, sizeof(fast_));
+		for (int i = 0; i < count; i++) {
+			lengthCounts[lengths[i]]++;
+		}
+		lengthCounts[0] = 0;
+
+		uint32_t nextCode[kMaxCodeLength + 1];
+		uint32_t code = 0;
+		int symbolIndex = 0;
+		for (int length = 1; length <= kMaxCodeLength; length++) {
+			nextCode[length] = code;
+			firstCode_[length] = uint16_t(code);
+			firstSymbol_[length] = uint16_t(symbolIndex);
+			code += uint32_t(lengthCounts[length]);
+			if (lengthCounts[length] != 0 && (1u << length) < code) {
+				return false;
+			}
+			// 左詰めにした値がこれ未満なら、この長さ以下の符号
+			maxCode_[length] = code << (16 - length);
+			code <<= 1;
+			symbolIndex += lengthCounts[length];
+		}
+		maxCode_[kMaxCodeLength + 1] = UINT32_MAX;
+
+		for (int symbol = 0; symbol < count; symbol++) {
+			const int length = lengths[symbol];
+			if (length == 0) {
+				continue;
+			}
+			const int index = int(nextCode[length] - firstCode_[length]) + firstSymbol_[length];
+			symbols_[index] = uint16_t(symbol);
+			if (length <= kFastBits) {
+				// 読む向きに合わせてビットを反転し、後ろに続く全ての並びへ書く
+				for (uint32_t j = ReverseBits(nextCode[length], length); j < (1u << kFastBits);
+				     j += 1u << length) {
+					fast_[j] = uint16_t((length << kFastBits) | symbol);
+				}
+			}
+			nextCode[length]++;
+		}
+		return true;
+	}
+
+	// 1記号読む（不正な符号なら -1）
+	int Decode(BitReader& reader) const {
+		reader.Refill();
+		const uint16_t entry = fast_[reader.Peek(kFastBits)];
+		if (entry != 0) {
+			reader.Consume(entry >> kFastBits);
+			return entry & ((1 << kFastBits) - 1);
+		}
+		// 長い符号は左詰めにして、長さごとの上限と比べる
+		const uint32_t code = Reverse16(reader.Peek(16));
+		int length = kFastBits + 1;
+		while (maxCode_[length] <= code) {
+			length++;
+		}
+		if (kMaxCodeLength < length) {
+			return -1;
+		}
+		const int index = int((code >> (16 - length)) - firstCode_[length]) + firstSymbol_[length];
+		reader.Consume(length);
+		return symbols_[index];
+	}
+
+private:
+	// 下位 kFastBits ビットから (符号長 << kFastBits) | 記号 を引く表（0なら長い符号）
+	uint16_t fast_[1 << kFastBits];
+	uint16_t firstCode_[kMaxCodeLength + 1];
+	uint16_t firstSymbol_[kMaxCodeLength + 1];
+	uint32_t maxCode_[kMaxCodeLength + 2];
+	uint16_t symbols_[288];
+};
+
+// 固定ハフマン符号の表
+struct FixedTables {
+	Huffman literal;
+	Huffman distance;
+
+	FixedTables() {
+		uint8_t lengths[288];
+		std::memset(lengths, 8, 144);
+		std::memset(lengths + 144, 9, 112);
+		std::memset(lengths + 256, 7, 24);
+		std::memset(lengths + 280, 8, 8);
+		literal.Build(lengths, 288);
+		std::memset(lengths, 5, 30);
+		distance.Build(lengths, 30);
+	}
+};
+
+// 動的ハフマン符号の表を読む
+bool ReadDynamicTables(BitReader& reader, Huffman& literal, Huffman& distance) {
+	const int literalCount = int(reader.Read(5)) + 257;
+	const int distanceCount = int(reader.Read(5)) + 1;
+	const int codeLengthCount = int(reader.Read(4)) + 4;
+
+	uint8_t codeLengthLengths[19] = {};
+	for (int i = 0; i < codeLengthCount; i++) {
+		codeLengthLengths[kCodeLengthOrder[i]] = uint8_t(reader.Read(3));
+	}
+	Huffman codeLength;
+	if (!codeLength.Build(codeLengthLengths, 19)) {
+		return false;
+	}
+
+	// 長さ符号と距離符号の符号長は続けて並んでいる
+	uint8_t lengths[286 + 30] = {};
+	int count = 0;
+	while (count < literalCount + distanceCount) {
+		int symbol = codeLength.Decode(reader);
+		if (symbol < 0) {
+			return false;
+		}
+		if (symbol < 16) {
+			lengths[count++] = uint8_t(symbol);
+			continue;
+		}
+		uint8_t value = 0;
+		int repeat = 0;
+		if (symbol == 16) {
+			if (count == 0) {
+				return false;
+			}
+			value = lengths[count - 1];
+			repeat = 3 + int(reader.Read(2));
+		} else if (symbol == 17) {
+			repeat = 3 + int(reader.Read(3));
+		} else {
+			repeat = 11 + int(reader.Read(7));
+		}
+		if (literalCount + distanceCount - count < repeat) {
+			return false;
+		}
+		std::memset(lengths + count, value, size_t(repeat));
+		count += repeat;
+	}
+	return literal.Build(lengths, literalCount) &&
+	       distance.Build(lengths + literalCount, distanceCount);
+}
+
+// ハフマン符号のブロックを展開する
+bool InflateBlock(
+    BitReader& reader, const Huffman& literal, const Huffman& distance, uint8_t* destination,
+    size_t destinationSize, size_t& written) {
+	while (true) {
+		int symbol = literal.Decode(reader);
+		if (symbol < 0) {
+			return false;
+		}
+		if (symbol < 256) {
+			if (written == destinationSize) {
+				return false;
+			}
+			destination[written++] = uint8_t(symbol);
+			continue;
+		}
+		if (symbol == 256) {
+			return !reader.IsOverrun();
+		}
+
+		symbol -= 257;
+		if (29 <= symbol) {
+			return false;
+		}
+		const size_t length = kLengthBase[symbol] + reader.Read(kLengthExtra[symbol]);
+		const int distanceSymbol = distance.Decode(reader);
+		if (distanceSymbol < 0 || 30 <= distanceSymbol) {
+			return false;
+		}
+		const size_t offset =
+		    kDistanceBase[distanceSymbol] + reader.Read(kDistanceExtra[distanceSymbol]);
+		if (written < offset || destinationSize - written < length) {
+			return false;
+		}
+		uint8_t* out = destination + written;
+		const uint8_t* from = out - offset;
+		if (length <= offset) {
+			std::memcpy(out, from, length);
+		} else {
+			// 重なる場合は繰り返しになるので1バイトずつ写す
+			for (size_t i = 0; i < length; i++) {
+				out[i] = from[i];
+			}
+		}
+		written += length;
+	}
+}
+
+// Adler-32
+uint32_t Adler32(const uint8_t* data, size_t size) {
+	// 5552 バイト（16の倍数）までなら 32bit で桁あふれしない
+	const size_t kBlockSize = 5552;
+	uint32_t a = 1;
+	uint32_t b = 0;
+	while (size != 0) {
+		const size_t blockSize = size < kBlockSize ? size : kBlockSize;
+		size_t i = 0;
+#if MATH_SIMD_SSE
+		// 16バイトごとに a は単純和、b は a の16倍と 16, 15, ..., 1 の重み付き和だけ増える
+		const size_t vectorSize = blockSize & ~size_t(15);
+		if (vectorSize != 0) {
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i weightLow = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+			const __m128i weightHigh = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+			__m128i sum = zero;         // バイトの和（64bit x 2）
+			__m128i previousSum = zero; // 各16バイトの手前までの和の合計（64bit x 2）
+			__m128i weighted = zero;    // 重み付き和（32bit x 4）
+			for (; i < vectorSize; i += 16) {
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+				previousSum = _mm_add_epi64(previousSum, sum);
+				sum = _mm_add_epi64(sum, _mm_sad_epu8(bytes, zero));
+				const __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), weightLow);
+				const __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), weightHigh);
+				weighted = _mm_add_epi32(weighted, _mm_add_epi32(low, high));
+			}
+			alignas(16) uint64_t sums[2];
+			alignas(16) uint64_t previousSums[2];
+			alignas(16) uint32_t weights[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(sums), sum);
+			_mm_store_si128(reinterpret_cast<__m128i*>(previousSums), previousSum);
+			_mm_store_si128(reinterpret_cast<__m128i*>(weights), weighted);
+			const uint64_t newB = b + uint64_t(a) * vectorSize +
+			                      (previousSums[0] + previousSums[1]) * 16 + weights[0] + weights[1] +
+			                      weights[2] + weights[3];
+			a = uint32_t((a + sums[0] + sums[1]) % 65521);
+			b = uint32_t(newB % 65521);
+		}
+#endif
+		for (; i < blockSize; i++) {
+			a += data[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		data += blockSize;
+		size -= blockSize;
+	}
+	return (b << 16) | a;
+}
+
+} // namespace
+
+bool Inflate::DecompressZlib(
+    const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize) {
+	// ヘッダ（圧縮方式 8、プリセット辞書なし）と末尾の Adler-32
+	if (sourceSize < 6 || (source[0] & 0x0f) != 8 || (source[1] & 0x20) != 0 ||
+	    ((uint32_t(source[0]) << 8) | source[1]) % 31 != 0) {
+		return false;
+	}
+	size_t written = 0;
+	if (!Decompress(source + 2, sourceSize - 6, destination, destinationSize, written) ||
+	    written != destinationSize) {
+		return false;
+	}
+	const uint8_t* trailer = source + sourceSize - 4;
+	const uint32_t checksum = (uint32_t(trailer[0]) << 24) | (uint32_t(trailer[1]) << 16) |
+	                          (uint32_t(trailer[2]) << 8) | trailer[3];
+	return checksum == Adler32(destination, destinationSize);
+}
+
+bool Inflate::Decompress(
+    const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize,
+    size_t& writtenSize) {
+	static const FixedTables fixedTables;
+
+	BitReader reader(source, sourceSize);
+	Huffman literal;
+	Huffman distance;
+	writtenSize = 0;
+	bool isFinal = false;
+	while (!isFinal) {
+		isFinal = reader.Read(1) != 0;
+		const uint32_t type = reader.Read(2);
+		if (type == 0) {
+			// 無圧縮ブロック
+			reader.AlignToByte();
+			const uint32_t length = reader.Read(16);
+			const uint32_t lengthComplement = reader.Read(16);
+			if ((length ^ 0xffff) != lengthComplement || destinationSize - writtenSize < length ||
+			    !reader.ReadBytes(destination + writtenSize, length)) {
+				return false;
+			}
+			writtenSize += length;
+		} else if (type == 1) {
+			if (!InflateBlock(
+			        reader, fixedTables.literal, fixedTables.distance, destination,
+			        destinationSize, writtenSize)) {
+				return false;
+			}
+		} else if (type == 2) {
+			if (!ReadDynamicTables(reader, literal, distance) ||
+			    !InflateBlock(reader, literal, distance, destination, destinationSize, writtenSize)) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+	return !reader.IsOverrun();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// <summary>
+/// Deflate（RFC 1951）の展開
+/// PNG の画像データのように展開後の大きさが分かっている場合に使い、呼び出し側のバッファへ直接書き込む
+/// </summary>
+class Inflate {
+public:
+	/// <summary>
+	/// zlib 形式（RFC 1950。2バイトのヘッダと末尾の Adler-32）の展開
+	/// </summary>
+	/// <param name="source">圧縮データ</param>
+	/// <param name="sourceSize">圧縮データのバイト数</param>
+	/// <param name="destination">展開先</param>
+	/// <param name="destinationSize">展開後のバイト数（ちょうど埋まらなければ失敗）</param>
+	/// <returns>成否</returns>
+	static bool DecompressZlib(
+	    const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+
+	/// <summary>
+	/// ヘッダの無い deflate データの展開
+	/// </summary>
+	/// <param name="source">圧縮データ</param>
+	/// <param name="sourceSize">圧縮データのバイト数</param>
+	/// <param name="destination">展開先</param>
+	/// <param name="destinationSize">展開先のバイト数</param>
+	/// <param name="writtenSize">展開したバイト数</param>
+	/// <returns>成否（展開先が足りなければ失敗）</returns>
+	static bool Decompress(
+	    const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize,
+	    size_t& writtenSize);
+};
@@ -0,0 +1,850 @@
+#include "JpegDecoder.h"
+#include "SimdConfig.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// マーカー
+const uint8_t kMarkerSof0 = 0xc0;
+const uint8_t kMarkerSof1 = 0xc1;
+const uint8_t kMarkerDht = 0xc4;
+const uint8_t kMarkerSoi = 0xd8;
+const uint8_t kMarkerEoi = 0xd9;
+const uint8_t kMarkerSos = 0xda;
+const uint8_t kMarkerDqt = 0xdb;
+const uint8_t kMarkerDri = 0xdd;
+const uint8_t kMarkerApp14 = 0xee;
+
+// 1回の表引きで解くハフマン符号のビット数
+const int kFastBits = 9;
+// 色変換を1タスクで処理する最小の行数
+const size_t kConvertGrainSize = 16;
+// 扱う成分数の上限
+const uint32_t kMaxComponentCount = 3;
+
+// ジグザグ順の番号から 8x8 ブロック内の位置（壊れたデータで 63 を越えても範囲内に収まるよう余分を置く）
+const uint8_t kZigZag[64 + 16] = {
+    0,  1,  8,  16, 9,  2,  3,  10, 17, 24, 32, 25, 18, 11, 4,  5,  12, 19, 26, 33,
+    40, 48, 41, 34, 27, 20, 13, 6,  7,  14, 21, 28, 35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54,
+    47, 55, 62, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63};
+
+uint16_t ReadU16(const uint8_t* data) { return uint16_t((data[0] << 8) | data[1]); }
+
+// 上位ビットから読むビット列（0xFF の後の 0x00 を取り除き、マーカーの手前で止まる）
+class BitReader {
+public:
+	BitReader(const uint8_t* data, const uint8_t* end) : position_(data), end_(end) {}
+
+	// 少なくとも57ビットを溜める（マーカーかデータの終わりより先は0として読む）
+	void Refill() {
+		while (bitCount_ <= 56) {
+			uint64_t byte = 0;
+			if (!isAtMarker_ && position_ < end_) {
+				if (*position_ != 0xff) {
+					byte = *position_++;
+				} else if (position_ + 1 < end_ && position_[1] == 0x00) {
+					byte = 0xff;
+					position_ += 2;
+				} else {
+					isAtMarker_ = true;
+				}
+			}
+			buffer_ |= byte << (56 - bitCount_);
+			bitCount_ += 8;
+		}
+	}
+
+	uint32_t Peek(int bitCount) const { return uint32_t(buffer_ >> (64 - bitCount)); }
+
+	void Consume(int bitCount) {
+		buffer_ <<= bitCount;
+		bitCount_ -= bitCount;
+	}
+
+	// 符号付きの値を読む（JPEG の Receive と Extend）
+	int ReadSigned(int bitCount) {
+		if (bitCount == 0) {
+			return 0;
+		}
+		if (bitCount_ < bitCount) {
+			Refill();
+		}
+		int value = int(Peek(bitCount));
+		Consume(bitCount);
+		if (value < (1 << (bitCount - 1))) {
+			value -= (1 << bitCount) - 1;
+		}
+		return value;
+	}
+
+	// リスタートマーカーを読み飛ばしてビット列を空にする
+	bool Restart() {
+		buffer_ = 0;
+		bitCount_ = 0;
+		isAtMarker_ = false;
+		while (position_ < end_ && *position_ == 0xff && position_ + 1 < end_ && position_[1] == 0xff) {
+			position_++;
+		}
+		if (end_ - position_ < 2 || position_[0] != 0xff || (position_[1] & 0xf8) != 0xd0) {
+			return false;
+		}
+		position_ += 2;
+		return true;
+	}
+
+	const uint8_t* GetPosition() const { return position_; }
+
+private:
+	const uint8_t* position_;
+	const uint8_t* end_;
+	// 上位ビットから詰める
+	uint64_t buffer_ = 0;
+	int bitCount_ = 0;
+	bool isAtMarker_ = false;
+};
+
+// ハフマン符号の復号表
+struct HuffmanTable {
+	// 上位 kFastBits ビットから (符号長 << 8) | 記号 を引く表（0なら長い符号）
+	uint16_t fast[1 << kFastBits];
+	// 長さごとの符号の上限（これ未満ならその長さ）と、記号の並びへのずれ
+	int32_t maxCode[18];
+	int32_t valueOffset[17];
+	uint8_t symbols[256];
+	bool isDefined = false;
+
+	// 長さごとの符号数と記号から表を作る
+	bool Build(const uint8_t* counts, const uint8_t* values, uint32_t valueCount) {
+		std::memset(fast, 0, sizeof(fast));
+		std::memcpy(symbols, values, valueCount);
+		int32_t code = 0;
+		int32_t index = 0;
+		for (int length = 1; length <= 16; length++) {
+			valueOffset[length] = index - code;
+			for (int i = 0; i < counts[length - 1]; i++, code++, index++) {
+				if (length <= kFastBits) {
+					const int32_t first = code << (kFastBits - length);
+					for (int32_t j = 0; j < (1 << (kFastBits - length)); j++) {
+						fast[first + j] = uint16_t((length << 8) | values[index]);
+					}
+				}
+			}
+			if ((1 << length) < code) {
+				return false;
+			}
+			maxCode[length] = code;
+			code <<= 1;
+		}
+		maxCode[17] = INT32_MAX;
+		isDefined = true;
+		return true;
+	}
+
+	// 1記号読む（不正な符号なら -1）
+	int Decode(BitReader& reader) const {
+		reader.Refill();
+		const uint16_t entry = fast[reader.Peek(kFastBits)];
+		if (entry != 0) {
+			reader.Consume(entry >> 8);
+			return entry & 0xff;
+		}
+		for (int length = kFastBits + 1; length <= 16; length++) {
+			const int32_t code = int32_t(reader.Peek(length));
+			if (code < maxCode[length]) {
+				reader.Consume(length);
+				return symbols[code + valueOffset[length]];
+			}
+		}
+		return -1;
+	}
+};
+
+// 画像の成分
+struct Component {
+	uint8_t id;
+	uint32_t samplingX;
+	uint32_t samplingY;
+	uint32_t quantizationIndex;
+	uint32_t dcTableIndex;
+	uint32_t acTableIndex;
+	int dcPrediction;
+	// 逆DCT結果の画素（MCU の境界まで広げた大きさ）
+	uint32_t planeWidth;
+	uint32_t planeHeight;
+	std::vector<uint8_t> plane;
+};
+
+// フレームとテーブルの状態
+struct JpegFrame {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t componentCount = 0;
+	Component components[kMaxComponentCount];
+	uint32_t maxSamplingX = 1;
+	uint32_t maxSamplingY = 1;
+	uint32_t mcuCountX = 0;
+	uint32_t mcuCountY = 0;
+	uint32_t restartInterval = 0;
+	// Adobe APP14 で RGB のまま符号化したと示されているか
+	bool isRgb = false;
+	// 量子化テーブル（ジグザグ順、逆DCTの倍率込み）
+	float quantization[4][64] = {};
+	HuffmanTable dcTables[4];
+	HuffmanTable acTables[4];
+};
+
+// AAN 法の逆DCTに合わせて量子化テーブルに掛けておく倍率（libjpeg と同じ値）
+const double kAanScaleFactors[8] = {1.0,         1.387039845, 1.306562965, 1.175875602,
+                                    1.0,         0.785694958, 0.541196100, 0.275899379};
+
+#if MATH_SIMD_SSE
+// 4列をまとめて逆DCTするための値
+struct Float4 {
+	__m128 value;
+
+	Float4 operator+(Float4 other) const { return {_mm_add_ps(value, other.value)}; }
+	Float4 operator-(Float4 other) const { return {_mm_sub_ps(value, other.value)}; }
+	Float4 operator*(float scale) const { return {_mm_mul_ps(value, _mm_set1_ps(scale))}; }
+};
+#endif
+
+// AAN 法の1次元逆DCT
+// libjpeg の浮動小数点版（jidctflt）と同じ順に計算するので、丸めまで同じ値になる
+template<class T> void InverseDct1D(const T (&in)[8], T (&out)[8]) {
+	// 偶数部
+	const T even10 = in[0] + in[4];
+	const T even11 = in[0] - in[4];
+	const T even13 = in[2] + in[6];
+	const T even12 = (in[2] - in[6]) * 1.414213562f - even13;
+	const T even0 = even10 + even13;
+	const T even3 = even10 - even13;
+	const T even1 = even11 + even12;
+	const T even2 = even11 - even12;
+
+	// 奇数部
+	const T z13 = in[5] + in[3];
+	const T z10 = in[5] - in[3];
+	const T z11 = in[1] + in[7];
+	const T z12 = in[1] - in[7];
+	const T odd7 = z11 + z13;
+	const T odd11 = (z11 - z13) * 1.414213562f;
+	const T z5 = (z10 + z12) * 1.847759065f;
+	const T odd10 = z5 - z12 * 1.082392200f;
+	const T odd12 = z5 - z10 * 2.613125930f;
+	const T odd6 = odd12 - odd7;
+	const T odd5 = odd11 - odd6;
+	const T odd4 = odd10 - odd5;
+
+	out[0] = even0 + odd7;
+	out[7] = even0 - odd7;
+	out[1] = even1 + odd6;
+	out[6] = even1 - odd6;
+	out[2] = even2 + odd5;
+	out[5] = even2 - odd5;
+	out[3] = even3 + odd4;
+	out[4] = even3 - odd4;
+}
+
+// 逆量子化済みの係数（自然順、AAN の倍率込み）から 8x8 画素を作る
+// 列ごと、行ごとの順に1次元逆DCTを掛け、0.5 を足して切り捨てる（libjpeg と同じ丸め）
+void InverseDct(const float* coefficients, uint8_t* out, size_t outStride) {
+#if MATH_SIMD_SSE
+	// 列方向は4列ずつまとめて計算する
+	Float4 work[2][8];
+	for (int half = 0; half < 2; half++) {
+		Float4 in[8];
+		for (int v = 0; v < 8; v++) {
+			in[v].value = _mm_load_ps(coefficients + v * 8 + half * 4);
+		}
+		InverseDct1D(in, work[half]);
+	}
+	// 行方向は転置して4行ずつまとめる
+	const __m128 center = _mm_set1_ps(128.5f);
+	const __m128 minimum = _mm_setzero_ps();
+	const __m128 maximum = _mm_set1_ps(255.0f);
+	for (int quarter = 0; quarter < 2; quarter++) {
+		Float4 in[8];
+		for (int half = 0; half < 2; half++) {
+			__m128 r0 = work[half][quarter * 4 + 0].value;
+			__m128 r1 = work[half][quarter * 4 + 1].value;
+			__m128 r2 = work[half][quarter * 4 + 2].value;
+			__m128 r3 = work[half][quarter * 4 + 3].value;
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			in[half * 4 + 0].value = r0;
+			in[half * 4 + 1].value = r1;
+			in[half * 4 + 2].value = r2;
+			in[half * 4 + 3].value = r3;
+		}
+		in[0].value = _mm_add_ps(in[0].value, center);
+		Float4 pixels[8];
+		InverseDct1D(in, pixels);
+
+		// 0～255 に収めて切り捨て、行の並びに戻す
+		__m128i columns[8];
+		for (int x = 0; x < 8; x++) {
+			columns[x] = _mm_cvttps_epi32(
+			    _mm_min_ps(_mm_max_ps(pixels[x].value, minimum), maximum));
+		}
+		for (int half = 0; half < 2; half++) {
+			__m128 c0 = _mm_castsi128_ps(columns[half * 4 + 0]);
+			__m128 c1 = _mm_castsi128_ps(columns[half * 4 + 1]);
+			__m128 c2 = _mm_castsi128_ps(columns[half * 4 + 2]);
+			__m128 c3 = _mm_castsi128_ps(columns[half * 4 + 3]);
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			columns[half * 4 + 0] = _mm_castps_si128(c0);
+			columns[half * 4 + 1] = _mm_castps_si128(c1);
+			columns[half * 4 + 2] = _mm_castps_si128(c2);
+			columns[half * 4 + 3] = _mm_castps_si128(c3);
+		}
+		for (int y = 0; y < 4; y++) {
+			const __m128i packed = _mm_packs_epi32(columns[y], columns[4 + y]);
+			_mm_storel_epi64(
+			    reinterpret_cast<__m128i*>(out + (quarter * 4 + y) * outStride),
+			    _mm_packus_epi16(packed, packed));
+		}
+	}
+#else
+	float work[8][8];
+	for (int x = 0; x < 8; x++) {
+		float in[8];
+		float column[8];
+		for (int v = 0; v < 8; v++) {
+			in[v] = coefficients[v * 8 + x];
+		}
+		InverseDct1D(in, column);
+		for (int y = 0; y < 8; y++) {
+			work[y][x] = column[y];
+		}
+	}
+	for (int y = 0; y < 8; y++) {
+		float in[8];
+		float pixels[8];
+		for (int u = 0; u < 8; u++) {
+			in[u] = work[y][u];
+		}
+		in[0] += 128.5f;
+		InverseDct1D(in, pixels);
+		for (int x = 0; x < 8; x++) {
+			out[y * outStride + x] = uint8_t(std::clamp(pixels[x], 0.0f, 255.0f));
+		}
+	}
+#endif
+}
+
+// 1ブロックを復号して成分の画素へ書き込む
+bool DecodeBlock(BitReader& reader, JpegFrame& frame, Component& component, uint8_t* out) {
+	const HuffmanTable& dcTable = frame.dcTables[component.dcTableIndex];
+	const HuffmanTable& acTable = frame.acTables[component.acTableIndex];
+	const float* quantization = frame.quantization[component.quantizationIndex];
+
+	const int dcLength = dcTable.Decode(reader);
+	if (dcLength < 0 || 11 < dcLength) {
+		return false;
+	}
+	component.dcPrediction += reader.ReadSigned(dcLength);
+
+	alignas(16) float coefficients[64] = {};
+	coefficients[0] = float(component.dcPrediction) * quantization[0];
+	bool hasAc = false;
+	for (int k = 1; k < 64;) {
+		const int symbol = acTable.Decode(reader);
+		if (symbol < 0) {
+			return false;
+		}
+		const int run = symbol >> 4;
+		const int length = symbol & 0x0f;
+		if (length == 0) {
+			// 0xF0 は0が16個、それ以外はブロックの終わり
+			if (run != 15) {
+				break;
+			}
+			k += 16;
+			continue;
+		}
+		k += run;
+		if (63 < k) {
+			return false;
+		}
+		const int position = kZigZag[k];
+		coefficients[position] = float(reader.ReadSigned(length)) * quantization[k];
+		hasAc |= coefficients[position] != 0.0f;
+		k++;
+	}
+
+	if (!hasAc) {
+		// 直流成分だけのブロックは一色で埋める（逆DCTしても全画素がこの値になる）
+		const uint8_t value = uint8_t(std::clamp(coefficients[0] + 128.5f, 0.0f, 255.0f));
+		for (int y = 0; y < 8; y++) {
+			std::memset(out + y * component.planeWidth, value, 8);
+		}
+		return true;
+	}
+	InverseDct(coefficients, out, component.planeWidth);
+	return true;
+}
+
+// マーカーセグメントを読む（SOS なら解析後に符号化データを復号する）
+bool ReadDqt(const uint8_t* segment, size_t length, JpegFrame& frame) {
+	while (length != 0) {
+		const uint32_t precision = segment[0] >> 4;
+		const uint32_t index = segment[0] & 0x0f;
+		const size_t tableSize = 1 + 64 * (precision + 1);
+		if (1 < precision || 3 < index || length < tableSize) {
+			return false;
+		}
+		for (int k = 0; k < 64; k++) {
+			const double value =
+			    precision == 0 ? double(segment[1 + k]) : double(ReadU16(segment + 1 + k * 2));
+			// 逆DCTの倍率と 1/8 を先に掛けておく
+			const int position = kZigZag[k];
+			frame.quantization[index][k] = float(
+			    value * kAanScaleFactors[position / 8] * kAanScaleFactors[position % 8] * 0.125);
+		}
+		segment += tableSize;
+		length -= tableSize;
+	}
+	return true;
+}
+
+bool ReadDht(const uint8_t* segment, size_t length, JpegFrame& frame) {
+	while (length != 0) {
+		if (length < 17) {
+			return false;
+		}
+		const uint32_t tableClass = segment[0] >> 4;
+		const uint32_t index = segment[0] & 0x0f;
+		uint32_t valueCount = 0;
+		for (int i = 0; i < 16; i++) {
+			valueCount += segment[1 + i];
+		}
+		if (1 < tableClass || 3 < index || 256 < valueCount || length < 17 + valueCount) {
+			return false;
+		}
+		HuffmanTable& table = tableClass == 0 ? frame.dcTables[index] : frame.acTables[index];
+		if (!table.Build(segment + 1, segment + 17, valueCount)) {
+			return false;
+		}
+		segment += 17 + valueCount;
+		length -= 17 + valueCount;
+	}
+	return true;
+}
+
+bool ReadSof(const uint8_t* segment, size_t length, JpegFrame& frame) {
+	if (length < 6) {
+		return false;
+	}
+	frame.height = ReadU16(segment + 1);
+	frame.width = ReadU16(segment + 3);
+	frame.componentCount = segment[5];
+	// 高さ0（DNL マーカーで後から決まる）は扱わない
+	if (segment[0] != 8 || frame.width == 0 || frame.height == 0 ||
+	    (frame.componentCount != 1 && frame.componentCount != 3) ||
+	    length < 6 + frame.componentCount * 3) {
+		return false;
+	}
+	for (uint32_t i = 0; i < frame.componentCount; i++) {
+		const uint8_t* source = segment + 6 + i * 3;
+		Component& component = frame.components[i];
+		component.id = source[0];
+		component.samplingX = source[1] >> 4;
+		component.samplingY = source[1] & 0x0f;
+		component.quantizationIndex = source[2];
+		if (component.samplingX == 0 || 4 < component.samplingX || component.samplingY == 0 ||
+		    4 < component.samplingY || 3 < component.quantizationIndex) {
+			return false;
+		}
+		frame.maxSamplingX = (std::max)(frame.maxSamplingX, component.samplingX);
+		frame.maxSamplingY = (std::max)(frame.maxSamplingY, component.samplingY);
+	}
+	// 拡大は整数倍だけ扱う
+	for (uint32_t i = 0; i < frame.componentCount; i++) {
+		const Component& component = frame.components[i];
+		if (frame.maxSamplingX % component.samplingX != 0 ||
+		    frame.maxSamplingY % component.samplingY != 0) {
+			return false;
+		}
+	}
+	frame.mcuCountX = (frame.width + frame.maxSamplingX * 8 - 1) / (frame.maxSamplingX * 8);
+	frame.mcuCountY = (frame.height + frame.maxSamplingY * 8 - 1) / (frame.maxSamplingY * 8);
+	return true;
+}
+
+// 符号化データの最小のバイト数（1ブロックは DC の符号だけでも1ビット以上）
+uint64_t GetMinScanSize(const JpegFrame& frame) {
+	uint64_t blockCount = 0;
+	for (uint32_t i = 0; i < frame.componentCount; i++) {
+		const Component& component = frame.components[i];
+		const uint64_t componentWidth =
+		    (frame.width * component.samplingX + frame.maxSamplingX - 1) / frame.maxSamplingX;
+		const uint64_t componentHeight =
+		    (frame.height * component.samplingY + frame.maxSamplingY - 1) / frame.maxSamplingY;
+		blockCount += ((componentWidth + 7) / 8) * ((componentHeight + 7) / 8);
+	}
+	return blockCount / 8;
+}
+
+// SOS の後ろの符号化データを復号する（戻り値は符号化データの終わり）
+const uint8_t* DecodeScan(
+    const uint8_t* segment, size_t length, const uint8_t* end, JpegFrame& frame) {
+	if (length < 1 || frame.componentCount == 0) {
+		return nullptr;
+	}
+	const uint32_t scanComponentCount = segment[0];
+	if (scanComponentCount == 0 || kMaxComponentCount < scanComponentCount ||
+	    length < 4 + scanComponentCount * 2) {
+		return nullptr;
+	}
+	Component* scanComponents[kMaxComponentCount];
+	for (uint32_t i = 0; i < scanComponentCount; i++) {
+		const uint8_t* source = segment + 1 + i * 2;
+		Component* found = nullptr;
+		for (uint32_t c = 0; c < frame.componentCount; c++) {
+			if (frame.components[c].id == source[0]) {
+				found = &frame.components[c];
+			}
+		}
+		if (!found) {
+			return nullptr;
+		}
+		found->dcTableIndex = source[1] >> 4;
+		found->acTableIndex = source[1] & 0x0f;
+		found->dcPrediction = 0;
+		if (3 < found->dcTableIndex || 3 < found->acTableIndex ||
+		    !frame.dcTables[found->dcTableIndex].isDefined ||
+		    !frame.acTables[found->acTableIndex].isDefined) {
+			return nullptr;
+		}
+		scanComponents[i] = found;
+	}
+
+	BitReader reader(segment + length, end);
+	uint32_t restartCountdown = frame.restartInterval;
+	// 複数成分なら MCU 単位、1成分ならその成分のブロック単位で並ぶ
+	uint32_t unitCountX = frame.mcuCountX;
+	uint32_t unitCountY = frame.mcuCountY;
+	if (scanComponentCount == 1) {
+		const Component& component = *scanComponents[0];
+		const uint32_t componentWidth =
+		    (frame.width * component.samplingX + frame.maxSamplingX - 1) / frame.maxSamplingX;
+		const uint32_t componentHeight =
+		    (frame.height * component.samplingY + frame.maxSamplingY - 1) / frame.maxSamplingY;
+		unitCountX = (componentWidth + 7) / 8;
+		unitCountY = (componentHeight + 7) / 8;
+	}
+	for (uint32_t unitY = 0; unitY < unitCountY; unitY++) {
+		for (uint32_t unitX = 0; unitX < unitCountX; unitX++) {
+			if (frame.restartInterval != 0) {
+				if (restartCountdown == 0) {
+					if (!reader.Restart()) {
+						return nullptr;
+					}
+					for (uint32_t i = 0; i < scanComponentCount; i++) {
+						scanComponents[i]->dcPrediction = 0;
+					}
+					restartCountdown = frame.restartInterval;
+				}
+				restartCountdown--;
+			}
+			for (uint32_t i = 0; i < scanComponentCount; i++) {
+				Component& component = *scanComponents[i];
+				const uint32_t blockCountX = scanComponentCount == 1 ? 1 : component.samplingX;
+				const uint32_t blockCountY = scanComponentCount == 1 ? 1 : component.samplingY;
+				for (uint32_t by = 0; by < blockCountY; by++) {
+					for (uint32_t bx = 0; bx < blockCountX; bx++) {
+						const size_t x = (size_t(unitX) * blockCountX + bx) * 8;
+						const size_t y = (size_t(unitY) * blockCountY + by) * 8;
+						uint8_t* out = component.plane.data() + y * component.planeWidth + x;
+						if (!DecodeBlock(reader, frame, component, out)) {
+							return nullptr;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// 次のマーカー（リスタートマーカーとバイト詰めを除く）まで進める
+	const uint8_t* position = reader.GetPosition();
+	while (position + 1 < end) {
+		if (position[0] == 0xff && position[1] != 0x00 && position[1] != 0xff &&
+		    (position[1] & 0xf8) != 0xd0) {
+			return position;
+		}
+		position++;
+	}
+	// マーカーが無ければ途中で切れている（足りない分を0として読んだ結果は使わない）
+	return nullptr;
+}
+
+// マーカーを順に読む（isHeaderOnly なら SOF まで）
+bool ParseJpeg(const uint8_t* data, size_t size, JpegFrame& frame, bool isHeaderOnly) {
+	if (size < 4 || data[0] != 0xff || data[1] != kMarkerSoi) {
+		return false;
+	}
+	const uint8_t* end = data + size;
+	const uint8_t* position = data + 2;
+	bool hasFrame = false;
+	bool hasScan = false;
+	while (2 <= end - position) {
+		if (position[0] != 0xff) {
+			return false;
+		}
+		const uint8_t marker = position[1];
+		position += 2;
+		if (marker == 0xff) {
+			// 詰め物
+			position--;
+			continue;
+		}
+		if (marker == kMarkerEoi) {
+			break;
+		}
+		if ((marker & 0xf8) == 0xd0 || marker == 0x01) {
+			continue;
+		}
+		if (end - position < 2) {
+			return false;
+		}
+		const size_t length = ReadU16(position);
+		if (length < 2 || size_t(end - position) < length) {
+			return false;
+		}
+		const uint8_t* segment = position + 2;
+		const size_t segmentLength = length - 2;
+		position += length;
+
+		switch (marker) {
+		case kMarkerSof0:
+		case kMarkerSof1:
+			// 残りのデータで足りない大きさは壊れている（出力を確保する前に弾く）
+			if (hasFrame || !ReadSof(segment, segmentLength, frame) ||
+			    uint64_t(end - position) < GetMinScanSize(frame)) {
+				return false;
+			}
+			hasFrame = true;
+			if (isHeaderOnly) {
+				return true;
+			}
+			for (uint32_t i = 0; i < frame.componentCount; i++) {
+				Component& component = frame.components[i];
+				component.planeWidth = frame.mcuCountX * component.samplingX * 8;
+				component.planeHeight = frame.mcuCountY * component.samplingY * 8;
+				component.plane.assign(size_t(component.planeWidth) * component.planeHeight, 0);
+			}
+			break;
+		case kMarkerDqt:
+			if (!ReadDqt(segment, segmentLength, frame)) {
+				return false;
+			}
+			break;
+		case kMarkerDht:
+			if (!ReadDht(segment, segmentLength, frame)) {
+				return false;
+			}
+			break;
+		case kMarkerDri:
+			if (segmentLength < 2) {
+				return false;
+			}
+			frame.restartInterval = ReadU16(segment);
+			break;
+		case kMarkerApp14:
+			// Adobe の変換フラグが0なら RGB のまま
+			if (12 <= segmentLength && std::memcmp(segment, "Adobe", 5) == 0) {
+				frame.isRgb = segment[11] == 0;
+			}
+			break;
+		case kMarkerSos:
+			if (!hasFrame) {
+				return false;
+			}
+			position = DecodeScan(segment, segmentLength, end, frame);
+			if (!position) {
+				return false;
+			}
+			hasScan = true;
+			break;
+		default:
+			// プログレッシブ・可逆・算術符号などの SOF は扱わない
+			if (0xc0 <= marker && marker <= 0xcf && marker != 0xc8) {
+				return false;
+			}
+			break;
+		}
+	}
+	return hasFrame && (isHeaderOnly || hasScan);
+}
+
+// YCbCr から RGB への変換表（libjpeg と同じ 16 ビット固定小数点で、同じ丸めにする）
+struct YCbCrTable {
+	int crToR[256];
+	int cbToB[256];
+	// 緑は2つを足してから丸める
+	int32_t crToG[256];
+	int32_t cbToG[256];
+
+	YCbCrTable() {
+		const int kScaleBits = 16;
+		const int32_t kHalf = int32_t(1) << (kScaleBits - 1);
+		auto fix = [](double value) { return int32_t(value * 65536.0 + 0.5); };
+		for (int i = 0; i < 256; i++) {
+			const int32_t x = i - 128;
+			crToR[i] = int((fix(1.40200) * x + kHalf) >> kScaleBits);
+			cbToB[i] = int((fix(1.77200) * x + kHalf) >> kScaleBits);
+			crToG[i] = -fix(0.71414) * x;
+			cbToG[i] = -fix(0.34414) * x + kHalf;
+		}
+	}
+};
+
+// YCbCr の1ラインを RGBA8 に変換する
+void ConvertYCbCrRow(
+    const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint32_t width, uint8_t* out) {
+	static const YCbCrTable table;
+	uint32_t x = 0;
+#if MATH_SIMD_SSE
+	// 係数を 65536 の倍数と 16 ビットに収まる残りに分け、残りを madd で掛けて表と同じ値にする
+	// R = Y + Cr' + ((26345 Cr' + 32768) >> 16)          （91881 = 65536 + 26345）
+	// G = Y - Cr' + ((-22554 Cb' + 18734 Cr' + 32768) >> 16)（-46802 = -65536 + 18734）
+	// B = Y + 2 Cb' + ((-14942 Cb' + 32768) >> 16)       （116130 = 131072 - 14942）
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i center = _mm_set1_epi16(128);
+	const __m128i two = _mm_set1_epi16(2);
+	const __m128i half = _mm_set1_epi32(32768);
+	auto pair = [](int16_t low, int16_t high) {
+		return _mm_set1_epi32(int32_t(uint32_t(uint16_t(high)) << 16 | uint16_t(low)));
+	};
+	const __m128i crToR = pair(26345, 16384);
+	const __m128i cbToB = pair(-14942, 16384);
+	const __m128i toG = pair(-22554, 18734);
+	const __m128i alpha = _mm_set1_epi16(255);
+	auto load8 = [zero](const uint8_t* source) {
+		return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)), zero);
+	};
+	// 16 ビット8個の組を madd し、16 ビット右シフトして16 ビット8個に戻す
+	auto multiply = [](__m128i a, __m128i b, __m128i coefficients, __m128i bias) {
+		const __m128i low = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a, b), coefficients), bias);
+		const __m128i high =
+		    _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a, b), coefficients), bias);
+		return _mm_packs_epi32(_mm_srai_epi32(low, 16), _mm_srai_epi32(high, 16));
+	};
+	for (; x + 8 <= width; x += 8) {
+		const __m128i luma = load8(y + x);
+		const __m128i blue = _mm_sub_epi16(load8(cb + x), center);
+		const __m128i red = _mm_sub_epi16(load8(cr + x), center);
+		const __m128i r =
+		    _mm_add_epi16(_mm_add_epi16(luma, red), multiply(red, two, crToR, zero));
+		const __m128i g =
+		    _mm_add_epi16(_mm_sub_epi16(luma, red), multiply(blue, red, toG, half));
+		const __m128i b = _mm_add_epi16(
+		    _mm_add_epi16(luma, _mm_add_epi16(blue, blue)), multiply(blue, two, cbToB, zero));
+		// r0..r7 g0..g7 / b0..b7 a0..a7 に飽和させて詰め、画素ごとの並びに組み替える
+		const __m128i redGreen = _mm_packus_epi16(r, g);
+		const __m128i blueAlpha = _mm_packus_epi16(b, alpha);
+		const __m128i rg = _mm_unpacklo_epi8(redGreen, _mm_srli_si128(redGreen, 8));
+		const __m128i ba = _mm_unpacklo_epi8(blueAlpha, _mm_srli_si128(blueAlpha, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+	}
+#endif
+	auto saturate = [](int value) { return uint8_t(std::clamp(value, 0, 255)); };
+	for (; x < width; x++) {
+		const int luma = y[x];
+		out[x * 4 + 0] = saturate(luma + table.crToR[cr[x]]);
+		out[x * 4 + 1] = saturate(luma + int((table.cbToG[cb[x]] + table.crToG[cr[x]]) >> 16));
+		out[x * 4 + 2] = saturate(luma + table.cbToB[cb[x]]);
+		out[x * 4 + 3] = 0xff;
+	}
+}
+
+// 成分の1ラインを画像の幅に拡大する（等倍ならそのまま返す。line は幅 + 4 バイト以上）
+const uint8_t* UpsampleRow(
+    const JpegFrame& frame, const Component& component, uint32_t y, uint8_t* line) {
+	const uint8_t* source =
+	    component.plane.data() +
+	    size_t(y * component.samplingY / frame.maxSamplingY) * component.planeWidth;
+	const uint32_t ratio = frame.maxSamplingX / component.samplingX;
+	if (ratio == 1) {
+		return source;
+	}
+	const uint32_t sourceWidth = (frame.width + ratio - 1) / ratio;
+	uint32_t x = 0;
+#if MATH_SIMD_SSE
+	if (ratio == 2) {
+		// 16画素を並べ替えて32画素にする
+		for (; x + 16 <= sourceWidth; x += 16) {
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+			_mm_storeu_si128(
+			    reinterpret_cast<__m128i*>(line + x * 2), _mm_unpacklo_epi8(pixels, pixels));
+			_mm_storeu_si128(
+			    reinterpret_cast<__m128i*>(line + x * 2 + 16), _mm_unpackhi_epi8(pixels, pixels));
+		}
+	}
+#endif
+	for (; x < sourceWidth; x++) {
+		std::memset(line + x * ratio, source[x], ratio);
+	}
+	return line;
+}
+
+} // namespace
+
+bool JpegDecoder::CanDecode(const uint8_t* data, size_t size) const {
+	return 3 <= size && data[0] == 0xff && data[1] == kMarkerSoi && data[2] == 0xff;
+}
+
+bool JpegDecoder::ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const {
+	JpegFrame frame;
+	if (!ParseJpeg(data, size, frame, true)) {
+		return false;
+	}
+	info.format = TextureFormat::kR8G8B8A8Unorm;
+	info.width = frame.width;
+	info.height = frame.height;
+	return true;
+}
+
+bool JpegDecoder::DecodeInto(
+    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const {
+	JpegFrame frame;
+	if (!ParseJpeg(data, size, frame, false) || rowPitch < size_t(frame.width) * 4) {
+		return false;
+	}
+
+	// 符号化データの復号は順にしかできないが、色変換は行ごとに独立している
+	const JpegFrame& decoded = frame;
+	ThreadPool::GetInstance()->ParallelFor(
+	    decoded.height, kConvertGrainSize, [&decoded, destination, rowPitch](size_t begin, size_t end) {
+		    const size_t lineSize = size_t(decoded.width) + 4;
+		    std::vector<uint8_t> lines(lineSize * kMaxComponentCount);
+		    for (size_t y = begin; y < end; y++) {
+			    uint8_t* out = destination + y * rowPitch;
+			    const uint8_t* rows[kMaxComponentCount];
+			    for (uint32_t i = 0; i < decoded.componentCount; i++) {
+				    rows[i] = UpsampleRow(
+				        decoded, decoded.components[i], uint32_t(y), lines.data() + i * lineSize);
+			    }
+			    if (decoded.componentCount == 1) {
+				    for (uint32_t x = 0; x < decoded.width; x++) {
+					    out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = rows[0][x];
+					    out[x * 4 + 3] = 0xff;
+				    }
+			    } else if (decoded.isRgb) {
+				    for (uint32_t x = 0; x < decoded.width; x++) {
+					    out[x * 4 + 0] = rows[0][x];
+					    out[x * 4 + 1] = rows[1][x];
+					    out[x * 4 + 2] = rows[2][x];
+					    out[x * 4 + 3] = 0xff;
+				    }
+			    } else {
+				    ConvertYCbCrRow(rows[0], rows[1], rows[2], decoded.width, out);
+			    }
+		    }
+	    });
+	return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "ImageDecoder.h"
+
+/// <summary>
+/// JPEG のデコーダ
+/// ベースライン（ハフマン符号、8bit 精度）のグレースケールと YCbCr に対応し、RGBA8 へ展開する。
+/// 逆DCTは AAN 法（4列ずつ SIMD）、色変換は 16 ビット固定小数点で8画素ずつ SIMD で計算し、色変換は行ごとに ThreadPool で並列に行う。
+/// 演算順と丸めを libjpeg の浮動小数点逆DCT（C 版）と固定小数点の色変換に揃えているので、
+/// libjpeg の JDCT_FLOAT、do_fancy_upsampling = FALSE と同じ値になる。
+/// 色差は最近傍で拡大するので、既定設定（補間拡大）の libjpeg とは輪郭で差が出る
+/// プログレッシブと算術符号は扱わない（ReadInfo が false を返す）
+/// </summary>
+class JpegDecoder : public ImageDecoder {
+public:
+	const char* GetName() const override { return "JPEG"; }
+	bool CanDecode(const uint8_t* data, size_t size) const override;
+	bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const override;
+	bool DecodeInto(
+	    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const override;
+};
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		Close();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+		isOpen_ = std::exchange(other.isOpen_, false);
+#ifdef _WIN32
+		fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+		mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#else
+		fileDescriptor_ = std::exchange(other.fileDescriptor_, -1);
+#endif
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& filePath) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(
+	    filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle_ = file;
+	size_ = size_t(fileSize.QuadPart);
+	isOpen_ = true;
+	// サイズ0はマップできないので開いただけにする
+	if (size_ == 0) {
+		return true;
+	}
+	mappingHandle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle_) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle_, FILE_MAP_READ, 0, 0, 0));
+	if (!data_) {
+		Close();
+		return false;
+	}
+#else
+	fileDescriptor_ = open(filePath.c_str(), O_RDONLY);
+	if (fileDescriptor_ < 0) {
+		return false;
+	}
+	struct stat status {};
+	if (fstat(fileDescriptor_, &status) != 0) {
+		Close();
+		return false;
+	}
+	size_ = size_t(status.st_size);
+	isOpen_ = true;
+	if (size_ == 0) {
+		return true;
+	}
+	void* address = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fileDescriptor_, 0);
+	if (address == MAP_FAILED) {
+		Close();
+		return false;
+	}
+	data_ = static_cast<const uint8_t*>(address);
+#endif
+	return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+	if (data_) {
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle_) {
+		CloseHandle(mappingHandle_);
+	}
+	if (fileHandle_) {
+		CloseHandle(fileHandle_);
+	}
+	mappingHandle_ = nullptr;
+	fileHandle_ = nullptr;
+#else
+	if (data_) {
+		munmap(const_cast<uint8_t*>(data_), size_);
+	}
+	if (0 <= fileDescriptor_) {
+		close(fileDescriptor_);
+	}
+	fileDescriptor_ = -1;
+#endif
+	data_ = nullptr;
+	size_ = 0;
+	isOpen_ = false;
+}
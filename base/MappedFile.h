@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// 読み取り専用のメモリマップドファイル
+/// </summary>
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	/// <summary>
+	/// ファイルを開いてマップする
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>成否（空ファイルも成功、サイズ0）</returns>
+	bool Open(const std::string& filePath);
+
+	/// <summary>
+	/// マップ解除して閉じる
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// 先頭アドレス
+	/// </summary>
+	const uint8_t* GetData() const { return data_; }
+
+	/// <summary>
+	/// ファイルサイズ
+	/// </summary>
+	size_t GetSize() const { return size_; }
+
+	/// <summary>
+	/// 開いているか
+	/// </summary>
+	bool IsOpen() const { return isOpen_; }
+
+private:
+	// マップ先頭
+	const uint8_t* data_ = nullptr;
+	// サイズ
+	size_t size_ = 0;
+	// 開いているか
+	bool isOpen_ = false;
+#ifdef _WIN32
+	// ファイルハンドル
+	void* fileHandle_ = nullptr;
+	// マッピングハンドル
+	void* mappingHandle_ = nullptr;
+#else
+	// ファイルディスクリプタ
+	int fileDescriptor_ = -1;
+#endif
+};
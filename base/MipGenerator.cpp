@@ -0,0 +1,536 @@
+#include "MipGenerator.h"
+#include "SimdConfig.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+namespace {
+
+using Options = MipGenerator::Options;
+
+// 並列に処理する1タスクあたりの画素数の目安
+const size_t kTilePixelCount = 16384;
+// 線形から sRGB へ戻す表の分解能（暗部でも誤差が 0.1 階調未満になる）
+const uint32_t kSrgbTableSize = 65536;
+// sinc 系フィルタの半径（縮小後の画素単位）
+const float kFilterRadius = 3.0f;
+// カイザー窓の形状パラメータ
+const float kKaiserAlpha = 4.0f;
+// アルファの通過率を合わせる倍率を、境目のアルファから離す割合（浮動小数の丸めで境目を越えないように）
+const float kCoverageScaleMargin = 1.0f / 1024.0f;
+// 円周率
+const float kPi = 3.14159265f;
+
+// sRGB と線形の変換表
+struct SrgbTables {
+	float toLinear[256];
+	float toUnorm[256];
+	std::vector<uint8_t> toSrgb;
+
+	SrgbTables() : toSrgb(kSrgbTableSize) {
+		for (int i = 0; i < 256; i++) {
+			float c = float(i) / 255.0f;
+			toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			toUnorm[i] = c;
+		}
+		for (uint32_t i = 0; i < kSrgbTableSize; i++) {
+			float l = float(i) / float(kSrgbTableSize - 1);
+			float s = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+			toSrgb[i] = uint8_t(s * 255.0f + 0.5f);
+		}
+	}
+};
+
+const SrgbTables& GetSrgbTables() {
+	static const SrgbTables tables;
+	return tables;
+}
+
+// 線形の浮動小数画像（1画素 RGBA の4要素）
+struct FloatImage {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<float> pixels;
+
+	float* Row(uint32_t y) { return pixels.data() + size_t(y) * width * 4; }
+	const float* Row(uint32_t y) const { return pixels.data() + size_t(y) * width * 4; }
+};
+
+// 8bit の行を線形の浮動小数へ変換する
+void DecodeRow(const uint8_t* src, uint32_t width, const Options& options, float* dst) {
+	const SrgbTables& tables = GetSrgbTables();
+	const float* colorTable = options.isSrgb ? tables.toLinear : tables.toUnorm;
+	for (uint32_t x = 0; x < width; x++) {
+		dst[x * 4 + 0] = colorTable[src[x * 4 + 0]];
+		dst[x * 4 + 1] = colorTable[src[x * 4 + 1]];
+		dst[x * 4 + 2] = colorTable[src[x * 4 + 2]];
+		dst[x * 4 + 3] = tables.toUnorm[src[x * 4 + 3]];
+	}
+	if (!options.premultipliedAlpha) {
+		return;
+	}
+	uint32_t x = 0;
+#if MATH_SIMD_SSE
+	// 色にアルファを掛ける（アルファの要素には1を掛ける）
+	const __m128 alphaLane = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	const __m128 colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	for (; x < width; x++) {
+		__m128 pixel = _mm_loadu_ps(dst + x * 4);
+		__m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(
+		    dst + x * 4, _mm_mul_ps(pixel, _mm_or_ps(_mm_and_ps(colorMask, alpha), alphaLane)));
+	}
+#endif
+	for (; x < width; x++) {
+		for (int c = 0; c < 3; c++) {
+			dst[x * 4 + c] *= dst[x * 4 + 3];
+		}
+	}
+}
+
+// 縮小元（レベル0は8bitのまま持ち、行ごとに線形へ変換して読む）
+struct Source {
+	const uint8_t* bytes = nullptr;
+	uint32_t rowPitch = 0;
+	const FloatImage* image = nullptr;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
+// 変換済みの行の保持（sinc 系フィルタは縦に隣り合う縮小先で同じ行を読むので使い回す）
+class RowCache {
+public:
+	RowCache(const Source& source, size_t slotCount)
+	    : source_(source), rowSize_(size_t(source.width) * 4),
+	      rows_(source.image ? 0 : rowSize_ * slotCount), keys_(slotCount, UINT32_MAX) {}
+
+	// 行の取得（8bit なら変換して保持する）
+	const float* GetRow(uint32_t y, const Options& options) {
+		if (source_.image) {
+			return source_.image->Row(y);
+		}
+		const size_t slot = y % keys_.size();
+		float* row = rows_.data() + slot * rowSize_;
+		if (keys_[slot] != y) {
+			DecodeRow(source_.bytes + size_t(y) * source_.rowPitch, source_.width, options, row);
+			keys_[slot] = y;
+		}
+		return row;
+	}
+
+private:
+	const Source& source_;
+	size_t rowSize_;
+	std::vector<float> rows_;
+	std::vector<uint32_t> keys_;
+};
+
+// 浮動小数の行を 8bit へ戻す
+void EncodeRow(
+    const float* src, uint32_t width, const Options& options, float alphaScale, uint8_t* dst) {
+	const SrgbTables& tables = GetSrgbTables();
+	const float colorScale = options.isSrgb ? float(kSrgbTableSize - 1) : 255.0f;
+	uint32_t x = 0;
+#if MATH_SIMD_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 colorMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 alphaLane = _mm_setr_ps(0.0f, 0.0f, 0.0f, alphaScale);
+	const __m128 outputScale = _mm_setr_ps(colorScale, colorScale, colorScale, 255.0f);
+	alignas(16) int32_t values[4];
+	for (; x < width; x++) {
+		__m128 pixel = _mm_loadu_ps(src + x * 4);
+		// 色はアルファで割ってストレートに戻し、アルファは通過率の補正を掛ける
+		__m128 multiplier = one;
+		if (options.premultipliedAlpha) {
+			__m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3));
+			multiplier = _mm_and_ps(_mm_div_ps(one, alpha), _mm_cmpgt_ps(alpha, zero));
+		}
+		multiplier = _mm_or_ps(_mm_and_ps(colorMask, multiplier), alphaLane);
+		pixel = _mm_min_ps(_mm_max_ps(_mm_mul_ps(pixel, multiplier), zero), one);
+		_mm_store_si128(
+		    reinterpret_cast<__m128i*>(values),
+		    _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(pixel, outputScale), half)));
+		uint8_t* out = dst + x * 4;
+		for (int c = 0; c < 3; c++) {
+			out[c] = options.isSrgb ? tables.toSrgb[values[c]] : uint8_t(values[c]);
+		}
+		out[3] = uint8_t(values[3]);
+	}
+#endif
+	for (; x < width; x++) {
+		const float* pixel = src + x * 4;
+		float alpha = pixel[3];
+		float inverseAlpha = 1.0f;
+		if (options.premultipliedAlpha) {
+			inverseAlpha = 0.0f < alpha ? 1.0f / alpha : 0.0f;
+		}
+		uint8_t* out = dst + x * 4;
+		for (int c = 0; c < 3; c++) {
+			float value = std::clamp(pixel[c] * inverseAlpha, 0.0f, 1.0f);
+			uint32_t index = uint32_t(value * colorScale + 0.5f);
+			out[c] = options.isSrgb ? tables.toSrgb[index] : uint8_t(index);
+		}
+		out[3] = uint8_t(std::clamp(alpha * alphaScale, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+}
+
+// 2x2 平均で1行縮小する（奇数の端は端の画素を繰り返す）
+void BoxFilterRow(
+    const float* row0, const float* row1, uint32_t srcWidth, uint32_t dstWidth, float* dst) {
+	uint32_t x = 0;
+#if MATH_SIMD_AVX2
+	// 2画素ずつ。レーン0に偶数番目、レーン1に奇数番目の画素を集めて足す
+	const __m256 quarter8 = _mm256_set1_ps(0.25f);
+	for (; x + 2 <= dstWidth && x * 2 + 4 <= srcWidth; x += 2) {
+		__m256 a0 = _mm256_loadu_ps(row0 + x * 8);
+		__m256 b0 = _mm256_loadu_ps(row0 + x * 8 + 8);
+		__m256 a1 = _mm256_loadu_ps(row1 + x * 8);
+		__m256 b1 = _mm256_loadu_ps(row1 + x * 8 + 8);
+		__m256 sum0 = _mm256_add_ps(
+		    _mm256_permute2f128_ps(a0, b0, 0x20), _mm256_permute2f128_ps(a0, b0, 0x31));
+		__m256 sum1 = _mm256_add_ps(
+		    _mm256_permute2f128_ps(a1, b1, 0x20), _mm256_permute2f128_ps(a1, b1, 0x31));
+		_mm256_storeu_ps(dst + x * 4, _mm256_mul_ps(_mm256_add_ps(sum0, sum1), quarter8));
+	}
+#endif
+#if MATH_SIMD_SSE
+	const __m128 quarter = _mm_set1_ps(0.25f);
+	for (; x < dstWidth; x++) {
+		uint32_t x0 = x * 2;
+		uint32_t x1 = (std::min)(x0 + 1, srcWidth - 1);
+		__m128 sum = _mm_add_ps(
+		    _mm_add_ps(_mm_loadu_ps(row0 + x0 * 4), _mm_loadu_ps(row0 + x1 * 4)),
+		    _mm_add_ps(_mm_loadu_ps(row1 + x0 * 4), _mm_loadu_ps(row1 + x1 * 4)));
+		_mm_storeu_ps(dst + x * 4, _mm_mul_ps(sum, quarter));
+	}
+#endif
+	for (; x < dstWidth; x++) {
+		uint32_t x0 = x * 2;
+		uint32_t x1 = (std::min)(x0 + 1, srcWidth - 1);
+		for (int c = 0; c < 4; c++) {
+			dst[x * 4 + c] =
+			    (row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c]) * 0.25f;
+		}
+	}
+}
+
+float Sinc(float x) {
+	if (std::abs(x) < 1.0e-5f) {
+		return 1.0f;
+	}
+	float px = kPi * x;
+	return std::sin(px) / px;
+}
+
+// 第1種変形ベッセル関数 I0（級数展開）
+float BesselI0(float x) {
+	float sum = 1.0f;
+	float term = 1.0f;
+	float halfX = x * 0.5f;
+	for (int k = 1; k < 32 && sum * 1.0e-8f < term; k++) {
+		term *= (halfX / float(k)) * (halfX / float(k));
+		sum += term;
+	}
+	return sum;
+}
+
+// フィルタの重み（x は縮小後の画素単位の距離）
+float FilterWeight(MipGenerator::Filter filter, float x) {
+	x = std::abs(x);
+	if (kFilterRadius <= x) {
+		return 0.0f;
+	}
+	if (filter == MipGenerator::Filter::kLanczos) {
+		return Sinc(x) * Sinc(x / kFilterRadius);
+	}
+	float t = x / kFilterRadius;
+	return Sinc(x) * BesselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / BesselI0(kKaiserAlpha);
+}
+
+// 1軸分のフィルタの参照先と重み（縮小後の i 番目は offsets[i] から offsets[i + 1] まで）
+struct FilterTaps {
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> indices;
+	std::vector<float> weights;
+};
+
+FilterTaps MakeFilterTaps(MipGenerator::Filter filter, uint32_t srcSize, uint32_t dstSize) {
+	FilterTaps taps;
+	const float scale = float(srcSize) / float(dstSize);
+	const float support = kFilterRadius * scale;
+	taps.offsets.push_back(0);
+	for (uint32_t i = 0; i < dstSize; i++) {
+		// 画素の中心どうしの距離で重みを決め、範囲外は端の画素を使う
+		const float center = (float(i) + 0.5f) * scale;
+		const int begin = int(std::floor(center - support));
+		const int end = int(std::ceil(center + support));
+		const size_t first = taps.weights.size();
+		float sum = 0.0f;
+		for (int j = begin; j <= end; j++) {
+			float weight = FilterWeight(filter, (float(j) + 0.5f - center) / scale);
+			if (weight == 0.0f) {
+				continue;
+			}
+			taps.indices.push_back(uint32_t(std::clamp(j, 0, int(srcSize) - 1)));
+			taps.weights.push_back(weight);
+			sum += weight;
+		}
+		for (size_t k = first; k < taps.weights.size(); k++) {
+			taps.weights[k] /= sum;
+		}
+		taps.offsets.push_back(uint32_t(taps.weights.size()));
+	}
+	return taps;
+}
+
+// dst += src * weight（要素数 count）
+void AccumulateRow(float* dst, const float* src, float weight, size_t count) {
+	size_t i = 0;
+#if MATH_SIMD_AVX2
+	const __m256 weight8 = _mm256_set1_ps(weight);
+	for (; i + 8 <= count; i += 8) {
+		_mm256_storeu_ps(
+		    dst + i, _mm256_add_ps(
+		                 _mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), weight8)));
+	}
+#endif
+#if MATH_SIMD_SSE
+	const __m128 weight4 = _mm_set1_ps(weight);
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(
+		    dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), weight4)));
+	}
+#endif
+	for (; i < count; i++) {
+		dst[i] += src[i] * weight;
+	}
+}
+
+// 縦に畳み込んだ行を横に畳み込んで1行縮小する（結果は 0～1 に収める）
+void FilterRowHorizontal(const float* row, const FilterTaps& taps, uint32_t dstWidth, float* dst) {
+	for (uint32_t x = 0; x < dstWidth; x++) {
+#if MATH_SIMD_SSE
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t k = taps.offsets[x]; k < taps.offsets[x + 1]; k++) {
+			sum = _mm_add_ps(
+			    sum, _mm_mul_ps(_mm_loadu_ps(row + taps.indices[k] * 4), _mm_set1_ps(taps.weights[k])));
+		}
+		sum = _mm_min_ps(_mm_max_ps(sum, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		_mm_storeu_ps(dst + x * 4, sum);
+#else
+		float sum[4] = {};
+		for (uint32_t k = taps.offsets[x]; k < taps.offsets[x + 1]; k++) {
+			for (int c = 0; c < 4; c++) {
+				sum[c] += row[taps.indices[k] * 4 + c] * taps.weights[k];
+			}
+		}
+		for (int c = 0; c < 4; c++) {
+			dst[x * 4 + c] = std::clamp(sum[c], 0.0f, 1.0f);
+		}
+#endif
+	}
+}
+
+// 通過率が target に最も近くなるアルファの倍率（レベル0と同じく 8bit に丸めた値で判定する）
+// 倍率を掛けて通る画素は大きい方から k 個なので、k 番目のアルファを境目にして倍率を決める。
+// 同じアルファが並んで k 個ちょうどにできなければ、近い方の個数にする。倍率の取れる範囲に1が入ればそのままにする
+float FindCoverageScale(const FloatImage& image, float reference, float target) {
+	// 通過する 8bit の値の最小
+	uint32_t minPassingByte = 0;
+	while (minPassingByte < 256 && !(reference < float(minPassingByte) * (1.0f / 255.0f))) {
+		minPassingByte++;
+	}
+	const size_t pixelCount = size_t(image.width) * image.height;
+	if (minPassingByte == 256 || pixelCount == 0) {
+		return 1.0f;
+	}
+	// アルファに倍率を掛けた値がこれ以上なら丸めた値が minPassingByte 以上になる
+	const float threshold = (float(minPassingByte) - 0.5f) * (1.0f / 255.0f);
+
+	std::vector<float> alphas(pixelCount);
+	for (size_t i = 0; i < pixelCount; i++) {
+		alphas[i] = image.pixels[i * 4 + 3];
+	}
+	const size_t targetCount = (std::min)(size_t(target * float(pixelCount) + 0.5f), pixelCount);
+
+	// 通す個数と、通す中で最小のアルファ・通さない中で最大のアルファ
+	size_t passCount = 0;
+	float lowestPassing = 0.0f;
+	float highestFailing = 0.0f;
+	if (targetCount == 0) {
+		highestFailing = *std::max_element(alphas.begin(), alphas.end());
+	} else {
+		std::nth_element(
+		    alphas.begin(), alphas.begin() + (targetCount - 1), alphas.end(), std::greater<float>());
+		const float border = alphas[targetCount - 1];
+		size_t aboveCount = 0;
+		size_t atLeastCount = 0;
+		float minAbove = 1.0f;
+		float maxBelow = 0.0f;
+		for (float alpha : alphas) {
+			if (border < alpha) {
+				aboveCount++;
+				minAbove = (std::min)(minAbove, alpha);
+			} else if (alpha < border) {
+				maxBelow = (std::max)(maxBelow, alpha);
+			}
+			atLeastCount += border <= alpha ? 1 : 0;
+		}
+		// アルファ0は倍率を掛けても通らない
+		if (0.0f < border && atLeastCount - targetCount <= targetCount - aboveCount) {
+			passCount = atLeastCount;
+			lowestPassing = border;
+			highestFailing = maxBelow;
+		} else {
+			passCount = aboveCount;
+			lowestPassing = minAbove;
+			highestFailing = border;
+		}
+	}
+
+	// 倍率の取れる範囲 [low, high)
+	const float low = passCount != 0 ? threshold / lowestPassing : 0.0f;
+	if (highestFailing <= 0.0f) {
+		return (std::max)(1.0f, low * (1.0f + kCoverageScaleMargin));
+	}
+	const float high = threshold / highestFailing;
+	const float middle = (low + high) * 0.5f;
+	if (1.0f < low) {
+		return (std::min)(low * (1.0f + kCoverageScaleMargin), middle);
+	}
+	if (high <= 1.0f) {
+		return (std::max)(high * (1.0f - kCoverageScaleMargin), middle);
+	}
+	return 1.0f;
+}
+
+} // namespace
+
+uint32_t MipGenerator::GetFullMipCount(uint32_t width, uint32_t height) {
+	uint32_t count = 1;
+	for (uint32_t size = (std::max)(width, height); 1 < size; size >>= 1) {
+		count++;
+	}
+	return count;
+}
+
+bool MipGenerator::Generate(TextureData& texture, const Options& options) {
+	// アルファが4バイト目にある8bit形式だけ扱う
+	if (GetBytesPerPixel(texture.format) != 4 || texture.GetMipCount() != 1) {
+		return false;
+	}
+	const uint32_t width = texture.GetWidth();
+	const uint32_t height = texture.GetHeight();
+	uint32_t mipCount = GetFullMipCount(width, height);
+	if (options.maxMipCount != 0) {
+		mipCount = (std::min)(mipCount, options.maxMipCount);
+	}
+
+	// レベル0の後ろに詰めて並べる
+	size_t offset = texture.pixels.size();
+	for (uint32_t level = 1; level < mipCount; level++) {
+		const uint32_t mipWidth = (std::max)(width >> level, 1u);
+		const uint32_t mipHeight = (std::max)(height >> level, 1u);
+		texture.mips.push_back(
+		    {offset, mipWidth, mipHeight, mipWidth * 4, mipWidth * 4 * mipHeight});
+		offset += size_t(mipWidth) * 4 * mipHeight;
+	}
+	texture.pixels.resize(offset);
+
+	// 通過率の目標はレベル0から数える
+	const bool preservesCoverage = 0.0f < options.alphaCoverageReference;
+	float targetCoverage = 0.0f;
+	if (preservesCoverage) {
+		const TextureMip& level0 = texture.mips[0];
+		size_t count = 0;
+		for (uint32_t y = 0; y < height; y++) {
+			const uint8_t* row = texture.GetMipPixels(0) + size_t(y) * level0.rowPitch;
+			for (uint32_t x = 0; x < width; x++) {
+				if (options.alphaCoverageReference < float(row[x * 4 + 3]) * (1.0f / 255.0f)) {
+					count++;
+				}
+			}
+		}
+		targetCoverage = float(count) / (float(width) * float(height));
+	}
+
+	ThreadPool* threadPool = ThreadPool::GetInstance();
+	FloatImage previous;
+	FloatImage current;
+	for (uint32_t level = 1; level < mipCount; level++) {
+		// 1つ前のレベルから縮小する
+		Source source;
+		if (level == 1) {
+			source.bytes = texture.GetMipPixels(0);
+			source.rowPitch = texture.mips[0].rowPitch;
+		} else {
+			source.image = &previous;
+		}
+		source.width = texture.mips[level - 1].width;
+		source.height = texture.mips[level - 1].height;
+
+		const TextureMip& mip = texture.mips[level];
+		current.width = mip.width;
+		current.height = mip.height;
+		current.pixels.resize(size_t(mip.width) * mip.height * 4);
+		const size_t grainSize = (std::max)(kTilePixelCount / mip.width, size_t(1));
+
+		if (options.filter == Filter::kBox) {
+			threadPool->ParallelFor(mip.height, grainSize, [&](size_t begin, size_t end) {
+				RowCache cache(source, 2);
+				for (size_t y = begin; y < end; y++) {
+					uint32_t y0 = uint32_t(y) * 2;
+					uint32_t y1 = (std::min)(y0 + 1, source.height - 1);
+					const float* row0 = cache.GetRow(y0, options);
+					const float* row1 = cache.GetRow(y1, options);
+					BoxFilterRow(row0, row1, source.width, mip.width, current.Row(uint32_t(y)));
+				}
+			});
+		} else {
+			const FilterTaps horizontal = MakeFilterTaps(options.filter, source.width, mip.width);
+			const FilterTaps vertical = MakeFilterTaps(options.filter, source.height, mip.height);
+			// 隣の縮小先へ進むと参照する行がずれるので、その分も含めて保持する
+			size_t maxTapCount = 0;
+			for (uint32_t y = 0; y < mip.height; y++) {
+				maxTapCount =
+				    (std::max)(maxTapCount, size_t(vertical.offsets[y + 1] - vertical.offsets[y]));
+			}
+			threadPool->ParallelFor(mip.height, grainSize, [&](size_t begin, size_t end) {
+				const size_t rowSize = size_t(source.width) * 4;
+				RowCache cache(source, maxTapCount + 2);
+				std::vector<float> accumulated(rowSize);
+				for (size_t y = begin; y < end; y++) {
+					std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+					for (uint32_t k = vertical.offsets[y]; k < vertical.offsets[y + 1]; k++) {
+						const float* row = cache.GetRow(vertical.indices[k], options);
+						AccumulateRow(accumulated.data(), row, vertical.weights[k], rowSize);
+					}
+					FilterRowHorizontal(
+					    accumulated.data(), horizontal, mip.width, current.Row(uint32_t(y)));
+				}
+			});
+		}
+
+		// 次のレベルの縮小元は補正前の値にして、補正が積み重ならないようにする
+		float alphaScale = 1.0f;
+		if (preservesCoverage) {
+			alphaScale =
+			    FindCoverageScale(current, options.alphaCoverageReference, targetCoverage);
+		}
+
+		uint8_t* dst = texture.GetMipPixels(level);
+		threadPool->ParallelFor(mip.height, grainSize, [&](size_t begin, size_t end) {
+			for (size_t y = begin; y < end; y++) {
+				EncodeRow(
+				    current.Row(uint32_t(y)), mip.width, options, alphaScale,
+				    dst + y * mip.rowPitch);
+			}
+		});
+		std::swap(previous, current);
+	}
+	return true;
+}
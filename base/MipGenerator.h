@@ -0,0 +1,55 @@
+#pragma once
+
+#include "TextureData.h"
+#include <cstdint>
+
+/// <summary>
+/// ミップ生成
+/// ミップレベル0だけの RGBA8 / BGRA8 画像に縮小画像を追加する。
+/// sRGB の色は線形空間に戻してからフィルタし、各レベルは行のまとまりごとに ThreadPool で並列に作る
+/// </summary>
+class MipGenerator {
+public:
+	/// <summary>
+	/// 縮小フィルタ
+	/// </summary>
+	enum class Filter {
+		kBox,     // 2x2 平均（速い）
+		kKaiser,  // カイザー窓付き sinc（半径3）
+		kLanczos, // Lanczos3
+	};
+
+	/// <summary>
+	/// 生成の設定
+	/// </summary>
+	struct Options {
+		Filter filter = Filter::kBox;
+		// 色を sRGB として扱う（false なら値のままフィルタする。法線マップなど）
+		bool isSrgb = true;
+		// 色にアルファを掛けてからフィルタする（透明部分の色がにじまない。結果はストレートアルファ）
+		bool premultipliedAlpha = false;
+		// 0より大きければ、このしきい値でのアルファテストの通過率がレベル0と同じになるようにアルファを補正する
+		// （同じアルファの画素が並んでちょうどにできないレベルは、取れる中で最も近い通過率にする）
+		float alphaCoverageReference = 0.0f;
+		// 作るミップ数の上限（レベル0を含む。0なら1x1まで）
+		uint32_t maxMipCount = 0;
+	};
+
+	/// <summary>
+	/// ミップの生成
+	/// </summary>
+	/// <param name="texture">ミップレベル0だけの画像</param>
+	/// <param name="options">設定</param>
+	/// <returns>生成できたか（非対応の形式なら画像を変えずに false）</returns>
+	static bool Generate(TextureData& texture, const Options& options);
+
+	/// <summary>
+	/// 既定の設定でミップを生成する（TextureLoader::MipFunction として渡せる）
+	/// </summary>
+	static bool Generate(TextureData& texture) { return Generate(texture, Options()); }
+
+	/// <summary>
+	/// 1x1 まで縮小したときのミップ数
+	/// </summary>
+	static uint32_t GetFullMipCount(uint32_t width, uint32_t height);
+};
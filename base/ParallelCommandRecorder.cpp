@@ -0,0 +1,69 @@
+#include "ParallelCommandRecorder.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <unordered_map>
+
+void CommandRecordSchedule::Clear() {
+	tasks_.clear();
+	passGroups_.clear();
+}
+
+uint32_t CommandRecordSchedule::AddPass(size_t itemCount, size_t grainSize, uint32_t group) {
+	const uint32_t pass = uint32_t(passGroups_.size());
+	passGroups_.push_back(group);
+
+	grainSize = (std::max)(grainSize, size_t(1));
+	size_t splitCount = (itemCount + grainSize - 1) / grainSize;
+	// 同じグループのタスクは順に実行されるので、分けてもコマンドリストが増えるだけ
+	if (group != kNoGroup) {
+		splitCount = 1;
+	}
+	splitCount = (std::max)(size_t(1), (std::min)(splitCount, GetMaxSplitCount()));
+
+	// 要素数の差が1以内になるように分ける
+	const size_t base = itemCount / splitCount;
+	const size_t remainder = itemCount % splitCount;
+	size_t begin = 0;
+	for (size_t i = 0; i < splitCount; i++) {
+		const size_t end = begin + base + (i < remainder ? 1 : 0);
+		tasks_.push_back({pass, begin, end});
+		begin = end;
+	}
+	return pass;
+}
+
+void CommandRecordSchedule::Run(const std::function<void(size_t taskIndex)>& function) const {
+	// ワーカーに渡す単位（グループごとに1つ、グループ無しのタスクは1つずつ）
+	// グループのタスクは1つのワーカーが順に実行するので、ロックで他のワーカーを待たせない
+	std::vector<std::vector<size_t>> jobs;
+	std::unordered_map<uint32_t, size_t> groupJobs;
+	for (size_t i = 0; i < tasks_.size(); i++) {
+		const uint32_t group = passGroups_[tasks_[i].pass];
+		if (group == kNoGroup) {
+			jobs.push_back({i});
+			continue;
+		}
+		auto it = groupJobs.find(group);
+		if (it == groupJobs.end()) {
+			it = groupJobs.emplace(group, jobs.size()).first;
+			jobs.emplace_back();
+		}
+		jobs[it->second].push_back(i);
+	}
+
+	ThreadPool::GetInstance()->ParallelFor(jobs.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			for (size_t taskIndex : jobs[i]) {
+				function(taskIndex);
+			}
+		}
+	});
+}
+
+size_t CommandRecordSchedule::GetMaxSplitCount() const {
+	if (maxSplitCount_ != 0) {
+		return maxSplitCount_;
+	}
+	// 呼び出し元スレッドも記録に参加する
+	return ThreadPool::GetInstance()->GetWorkerCount() + 1;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// <summary>
+/// コマンドリストの用意と提出
+/// D3D12 の実装（CommandListPool）のほか、命令を記録するだけのものに差し替えてデバイス無しで確かめられる
+/// </summary>
+template<class CommandList> class CommandListBackend {
+public:
+	virtual ~CommandListBackend() = default;
+
+	/// <summary>
+	/// 記録を始めた状態のコマンドリストを取得する（呼び出し元のスレッドから提出順に呼ばれる）
+	/// </summary>
+	virtual CommandList* Acquire() = 0;
+
+	/// <summary>
+	/// 記録を終える（記録したワーカースレッドから呼ばれる）
+	/// </summary>
+	virtual void Close(CommandList* commandList) = 0;
+
+	/// <summary>
+	/// 並べた順に実行する
+	/// </summary>
+	virtual void Submit(CommandList* const* commandLists, size_t count) = 0;
+};
+
+/// <summary>
+/// 並列記録の予定
+/// パスを記録単位（タスク）に分けて提出順に番号を振り、ThreadPool で実行する。
+/// 同じ排他グループのタスクは1つのワーカーが追加した順に実行するので、
+/// 記録先を静的に持つクラス（Model や Sprite）を使うパスはグループを分けて並列にできる
+/// </summary>
+class CommandRecordSchedule {
+public:
+	// 排他グループ無し（他のどのタスクとも同時に実行してよい）
+	static const uint32_t kNoGroup = UINT32_MAX;
+
+	/// <summary>
+	/// 記録単位（配列の添字が提出順）
+	/// </summary>
+	struct Task {
+		uint32_t pass; // パスの番号
+		size_t begin;  // 記録する要素の範囲 [begin, end)
+		size_t end;
+	};
+
+	/// <summary>
+	/// 予定を空にする
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// パスの追加（追加した順に提出する）
+	/// 要素を grainSize 以上ずつ、最大 GetMaxSplitCount 個のタスクに分ける。排他グループを持つパスは分けない
+	/// </summary>
+	/// <param name="itemCount">要素数（0でも1つのタスクを作る）</param>
+	/// <param name="grainSize">1タスクあたりの最小要素数</param>
+	/// <param name="group">排他グループ（kNoGroup なら無し）</param>
+	/// <returns>パスの番号</returns>
+	uint32_t AddPass(size_t itemCount, size_t grainSize, uint32_t group = kNoGroup);
+
+	/// <summary>
+	/// 全タスクを並列に実行し、終わるまで待つ
+	/// </summary>
+	/// <param name="function">タスクの番号を受け取る関数</param>
+	void Run(const std::function<void(size_t taskIndex)>& function) const;
+
+	const std::vector<Task>& GetTasks() const { return tasks_; }
+
+	/// <summary>
+	/// 1パスを分ける数の上限の設定（0ならワーカー数 + 1）
+	/// </summary>
+	void SetMaxSplitCount(size_t count) { maxSplitCount_ = count; }
+
+	size_t GetMaxSplitCount() const;
+
+private:
+	// タスク（提出順）
+	std::vector<Task> tasks_;
+	// パスごとの排他グループ
+	std::vector<uint32_t> passGroups_;
+	// 1パスを分ける数の上限
+	size_t maxSplitCount_ = 0;
+};
+
+/// <summary>
+/// コマンドリストの並列記録
+/// パスごとに別のコマンドリストをバックエンドから受け取ってワーカースレッドで記録し、
+/// どのスレッドが先に終わってもパスを追加した順（分けたパスは要素順）に提出する
+/// </summary>
+template<class CommandList> class ParallelCommandRecorder {
+public:
+	// 記録関数（[begin, end) の要素を commandList へ記録する）
+	using RecordFunction = std::function<void(CommandList* commandList, size_t begin, size_t end)>;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="backend">コマンドリストの用意と提出</param>
+	void Initialize(CommandListBackend<CommandList>* backend) { backend_ = backend; }
+
+	/// <summary>
+	/// 分けないパスの追加
+	/// </summary>
+	/// <param name="record">記録関数（範囲は [0, 1)）</param>
+	/// <param name="group">排他グループ</param>
+	void AddPass(RecordFunction record, uint32_t group = CommandRecordSchedule::kNoGroup) {
+		AddPass(1, 1, std::move(record), group);
+	}
+
+	/// <summary>
+	/// 要素ごとに分けて並列に記録するパスの追加
+	/// </summary>
+	/// <param name="itemCount">要素数</param>
+	/// <param name="grainSize">1コマンドリストあたりの最小要素数</param>
+	/// <param name="record">記録関数</param>
+	/// <param name="group">排他グループ（指定すると分けない）</param>
+	void AddPass(
+	    size_t itemCount, size_t grainSize, RecordFunction record,
+	    uint32_t group = CommandRecordSchedule::kNoGroup) {
+		schedule_.AddPass(itemCount, grainSize, group);
+		records_.push_back(std::move(record));
+	}
+
+	/// <summary>
+	/// 追加した全パスを記録して提出し、パスを空にする
+	/// </summary>
+	void Execute() {
+		const std::vector<CommandRecordSchedule::Task>& tasks = schedule_.GetTasks();
+		// 提出順を決めるため、コマンドリストはこのスレッドで順に受け取る
+		commandLists_.resize(tasks.size());
+		for (CommandList*& commandList : commandLists_) {
+			commandList = backend_->Acquire();
+		}
+		schedule_.Run([&](size_t taskIndex) {
+			const CommandRecordSchedule::Task& task = tasks[taskIndex];
+			records_[task.pass](commandLists_[taskIndex], task.begin, task.end);
+			backend_->Close(commandLists_[taskIndex]);
+		});
+		backend_->Submit(commandLists_.data(), commandLists_.size());
+
+		schedule_.Clear();
+		records_.clear();
+	}
+
+	CommandRecordSchedule& GetSchedule() { return schedule_; }
+
+private:
+	// コマンドリストの用意と提出
+	CommandListBackend<CommandList>* backend_ = nullptr;
+	// 記録の予定
+	CommandRecordSchedule schedule_;
+	// パスごとの記録関数
+	std::vector<RecordFunction> records_;
+	// タスクごとのコマンドリスト
+	std::vector<CommandList*> commandLists_;
+};
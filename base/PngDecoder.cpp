@@ -0,0 +1,486 @@
+#include "PngDecoder.h"
+#include "Inflate.h"
+#include "SimdConfig.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// ファイルの識別子
+const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a};
+
+// 色の種類
+const uint8_t kColorGray = 0;
+const uint8_t kColorRgb = 2;
+const uint8_t kColorPalette = 3;
+const uint8_t kColorGrayAlpha = 4;
+const uint8_t kColorRgba = 6;
+
+// フィルタの種類
+const uint8_t kFilterNone = 0;
+const uint8_t kFilterSub = 1;
+const uint8_t kFilterUp = 2;
+const uint8_t kFilterAverage = 3;
+const uint8_t kFilterPaeth = 4;
+
+// Adam7 の各パスの開始位置と間隔
+const uint32_t kAdam7StartX[7] = {0, 4, 0, 2, 0, 1, 0};
+const uint32_t kAdam7StartY[7] = {0, 0, 4, 0, 2, 0, 1};
+const uint32_t kAdam7StepX[7] = {8, 8, 4, 4, 2, 2, 1};
+const uint32_t kAdam7StepY[7] = {8, 8, 8, 4, 4, 2, 2};
+
+// 展開後の大きさの上限（壊れたヘッダで巨大な確保をしない）
+const uint64_t kMaxRawSize = uint64_t(1) << 32;
+// deflate で1バイトから展開できるバイト数の上限
+const uint64_t kMaxDeflateRatio = 1032;
+
+uint32_t ReadU32(const uint8_t* data) {
+	return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | data[3];
+}
+
+uint16_t ReadU16(const uint8_t* data) { return uint16_t((data[0] << 8) | data[1]); }
+
+// チャンクから集めた画像の情報
+struct PngImage {
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint8_t bitDepth = 0;
+	uint8_t colorType = 0;
+	uint8_t interlace = 0;
+	uint32_t channelCount = 0;
+	// パレット（RGBA。tRNS が無ければ不透明）
+	uint8_t palette[256][4] = {};
+	uint32_t paletteSize = 0;
+	// 透明色（グレースケールとトゥルーカラーの tRNS）
+	bool hasColorKey = false;
+	uint16_t colorKey[3] = {};
+	// IDAT チャンクの中身
+	std::vector<std::pair<const uint8_t*, size_t>> dataChunks;
+
+	// 1画素のビット数
+	uint32_t GetBitsPerPixel() const { return channelCount * bitDepth; }
+	// 幅 width の1ラインのバイト数（フィルタの種類を除く）
+	uint64_t GetRowSize(uint32_t rowWidth) const {
+		return (uint64_t(rowWidth) * GetBitsPerPixel() + 7) / 8;
+	}
+};
+
+// 色の種類とビット深度の組み合わせが正しいか
+bool IsValidFormat(uint8_t colorType, uint8_t bitDepth) {
+	switch (colorType) {
+	case kColorGray:
+		return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+	case kColorPalette:
+		return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+	case kColorRgb:
+	case kColorGrayAlpha:
+	case kColorRgba:
+		return bitDepth == 8 || bitDepth == 16;
+	default:
+		return false;
+	}
+}
+
+// チャンクを読む
+bool ParseChunks(const uint8_t* data, size_t size, PngImage& image) {
+	if (size < sizeof(kSignature) || std::memcmp(data, kSignature, sizeof(kSignature)) != 0) {
+		return false;
+	}
+	size_t position = sizeof(kSignature);
+	bool hasHeader = false;
+	while (12 <= size - position) {
+		const uint32_t length = ReadU32(data + position);
+		const uint8_t* type = data + position + 4;
+		const uint8_t* body = data + position + 8;
+		if (size - position - 12 < length) {
+			return false;
+		}
+		position += size_t(length) + 12;
+
+		if (std::memcmp(type, "IHDR", 4) == 0) {
+			if (length != 13) {
+				return false;
+			}
+			image.width = ReadU32(body);
+			image.height = ReadU32(body + 4);
+			image.bitDepth = body[8];
+			image.colorType = body[9];
+			image.interlace = body[12];
+			if (image.width == 0 || image.height == 0 || 0x7fffffff < image.width ||
+			    0x7fffffff < image.height || !IsValidFormat(image.colorType, image.bitDepth) ||
+			    body[10] != 0 || body[11] != 0 || 1 < image.interlace) {
+				return false;
+			}
+			const uint32_t channelCounts[7] = {1, 0, 3, 1, 2, 0, 4};
+			image.channelCount = channelCounts[image.colorType];
+			hasHeader = true;
+		} else if (!hasHeader) {
+			return false;
+		} else if (std::memcmp(type, "PLTE", 4) == 0) {
+			if (length % 3 != 0 || 256 * 3 < length) {
+				return false;
+			}
+			image.paletteSize = length / 3;
+			for (uint32_t i = 0; i < image.paletteSize; i++) {
+				std::memcpy(image.palette[i], body + i * 3, 3);
+				image.palette[i][3] = 0xff;
+			}
+		} else if (std::memcmp(type, "tRNS", 4) == 0) {
+			if (image.colorType == kColorPalette) {
+				for (uint32_t i = 0; i < length && i < 256; i++) {
+					image.palette[i][3] = body[i];
+				}
+			} else if (image.colorType == kColorGray && length == 2) {
+				image.hasColorKey = true;
+				image.colorKey[0] = ReadU16(body);
+			} else if (image.colorType == kColorRgb && length == 6) {
+				image.hasColorKey = true;
+				for (int i = 0; i < 3; i++) {
+					image.colorKey[i] = ReadU16(body + i * 2);
+				}
+			}
+		} else if (std::memcmp(type, "IDAT", 4) == 0) {
+			image.dataChunks.emplace_back(body, length);
+		} else if (std::memcmp(type, "IEND", 4) == 0) {
+			break;
+		}
+	}
+	if (!hasHeader || image.dataChunks.empty() ||
+	    (image.colorType == kColorPalette && image.paletteSize == 0)) {
+		return false;
+	}
+	// IDAT から展開しきれない大きさのヘッダは壊れている（出力を確保する前に弾く）
+	uint64_t compressedSize = 0;
+	for (const auto& chunk : image.dataChunks) {
+		compressedSize += chunk.second;
+	}
+	return (image.GetRowSize(image.width) + 1) * image.height <= compressedSize * kMaxDeflateRatio;
+}
+
+// Paeth 予測
+uint8_t PaethPredictor(int a, int b, int c) {
+	const int pa = std::abs(b - c);
+	const int pb = std::abs(a - c);
+	const int pc = std::abs(a + b - 2 * c);
+	if (pa <= pb && pa <= pc) {
+		return uint8_t(a);
+	}
+	return uint8_t(pb <= pc ? b : c);
+}
+
+#if MATH_SIMD_SSE
+// 1画素（3か4バイト）の読み書き
+// 3バイトを memcpy で一時変数に通すとストアフォワーディングが効かず遅いので、シフトで組み立てる
+template<size_t kBytesPerPixel>
+__m128i LoadPixel(const uint8_t* source) {
+	if constexpr (kBytesPerPixel == 3) {
+		return _mm_cvtsi32_si128(int32_t(source[0] | (source[1] << 8) | (source[2] << 16)));
+	} else {
+		int32_t value;
+		std::memcpy(&value, source, sizeof(value));
+		return _mm_cvtsi32_si128(value);
+	}
+}
+
+template<size_t kBytesPerPixel>
+void StorePixel(uint8_t* destination, __m128i value) {
+	const int32_t pixel = _mm_cvtsi128_si32(value);
+	if constexpr (kBytesPerPixel == 3) {
+		destination[0] = uint8_t(pixel);
+		destination[1] = uint8_t(pixel >> 8);
+		destination[2] = uint8_t(pixel >> 16);
+	} else {
+		std::memcpy(destination, &pixel, sizeof(pixel));
+	}
+}
+
+// 1画素の全チャンネルをまとめて復元する（左隣の画素に依存するので画素単位で進める）
+template<uint8_t kFilter, size_t kBytesPerPixel>
+void UnfilterPixels(uint8_t* row, const uint8_t* prior, size_t size) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i a = zero; // 左
+	__m128i c = zero; // 左上
+	for (size_t i = 0; i < size; i += kBytesPerPixel) {
+		const __m128i x = LoadPixel<kBytesPerPixel>(row + i);
+		const __m128i b = LoadPixel<kBytesPerPixel>(prior + i); // 上
+		if constexpr (kFilter == kFilterSub) {
+			a = _mm_add_epi8(x, a);
+		} else if constexpr (kFilter == kFilterAverage) {
+			// _mm_avg_epu8 は切り上げるので、奇数なら1引いて切り捨てにする
+			const __m128i average =
+			    _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+			a = _mm_add_epi8(x, average);
+		} else {
+			// 16bit に広げて |b - c|, |a - c|, |a + b - 2c| を比べる
+			const __m128i a16 = _mm_unpacklo_epi8(a, zero);
+			const __m128i b16 = _mm_unpacklo_epi8(b, zero);
+			const __m128i c16 = _mm_unpacklo_epi8(c, zero);
+			const __m128i p = _mm_sub_epi16(b16, c16);
+			const __m128i q = _mm_sub_epi16(a16, c16);
+			const __m128i r = _mm_add_epi16(p, q);
+			const __m128i pa = _mm_max_epi16(p, _mm_sub_epi16(zero, p));
+			const __m128i pb = _mm_max_epi16(q, _mm_sub_epi16(zero, q));
+			const __m128i pc = _mm_max_epi16(r, _mm_sub_epi16(zero, r));
+			const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+			const __m128i isB = _mm_cmpeq_epi16(pb, smallest);
+			const __m128i isA = _mm_cmpeq_epi16(pa, smallest);
+			__m128i predictor = _mm_or_si128(_mm_and_si128(isB, b16), _mm_andnot_si128(isB, c16));
+			predictor = _mm_or_si128(_mm_and_si128(isA, a16), _mm_andnot_si128(isA, predictor));
+			a = _mm_add_epi8(x, _mm_packus_epi16(predictor, predictor));
+			c = b;
+		}
+		StorePixel<kBytesPerPixel>(row + i, a);
+	}
+}
+
+template<size_t kBytesPerPixel>
+void UnfilterPixels(uint8_t filter, uint8_t* row, const uint8_t* prior, size_t size) {
+	if (filter == kFilterSub) {
+		UnfilterPixels<kFilterSub, kBytesPerPixel>(row, prior, size);
+	} else if (filter == kFilterAverage) {
+		UnfilterPixels<kFilterAverage, kBytesPerPixel>(row, prior, size);
+	} else {
+		UnfilterPixels<kFilterPaeth, kBytesPerPixel>(row, prior, size);
+	}
+}
+#endif
+
+// 1ラインのフィルタを復元する（prior は復元済みの前のライン。最初のラインなら0で埋めたもの）
+bool Unfilter(uint8_t filter, uint8_t* row, const uint8_t* prior, size_t size, size_t bytesPerPixel) {
+	switch (filter) {
+	case kFilterNone:
+		return true;
+	case kFilterUp: {
+		size_t i = 0;
+#if MATH_SIMD_SSE
+		for (; i + 16 <= size; i += 16) {
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+		}
+#endif
+		for (; i < size; i++) {
+			row[i] = uint8_t(row[i] + prior[i]);
+		}
+		return true;
+	}
+	case kFilterSub:
+	case kFilterAverage:
+	case kFilterPaeth:
+		break;
+	default:
+		return false;
+	}
+
+#if MATH_SIMD_SSE
+	if (bytesPerPixel == 4) {
+		UnfilterPixels<4>(filter, row, prior, size);
+		return true;
+	}
+	if (bytesPerPixel == 3) {
+		UnfilterPixels<3>(filter, row, prior, size);
+		return true;
+	}
+#endif
+	// 最初の画素は左が無いので0として扱う
+	for (size_t i = 0; i < size; i++) {
+		const int a = bytesPerPixel <= i ? row[i - bytesPerPixel] : 0;
+		const int b = prior[i];
+		const int c = bytesPerPixel <= i ? prior[i - bytesPerPixel] : 0;
+		if (filter == kFilterSub) {
+			row[i] = uint8_t(row[i] + a);
+		} else if (filter == kFilterAverage) {
+			row[i] = uint8_t(row[i] + ((a + b) >> 1));
+		} else {
+			row[i] = uint8_t(row[i] + PaethPredictor(a, b, c));
+		}
+	}
+	return true;
+}
+
+// ビット深度が8未満の画素の値
+uint32_t ReadPackedSample(const uint8_t* row, uint32_t index, uint32_t bitDepth) {
+	const uint32_t bit = index * bitDepth;
+	return (row[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1u << bitDepth) - 1);
+}
+
+// 復元済みの1ラインを RGBA8 に変換する
+void ConvertRow(const PngImage& image, const uint8_t* row, uint32_t width, uint8_t* out) {
+	const uint32_t bitDepth = image.bitDepth;
+	switch (image.colorType) {
+	case kColorRgba:
+		if (bitDepth == 8) {
+			std::memcpy(out, row, size_t(width) * 4);
+		} else {
+			for (uint32_t x = 0; x < width; x++) {
+				for (uint32_t i = 0; i < 4; i++) {
+					out[x * 4 + i] = row[x * 8 + i * 2];
+				}
+			}
+		}
+		break;
+	case kColorRgb: {
+		if (bitDepth == 8 && !image.hasColorKey) {
+			for (uint32_t x = 0; x < width; x++) {
+				out[x * 4 + 0] = row[x * 3 + 0];
+				out[x * 4 + 1] = row[x * 3 + 1];
+				out[x * 4 + 2] = row[x * 3 + 2];
+				out[x * 4 + 3] = 0xff;
+			}
+			break;
+		}
+		const uint32_t sampleSize = bitDepth / 8;
+		for (uint32_t x = 0; x < width; x++) {
+			const uint8_t* pixel = row + x * 3 * sampleSize;
+			bool isKey = image.hasColorKey;
+			for (uint32_t i = 0; i < 3; i++) {
+				const uint8_t* sample = pixel + i * sampleSize;
+				out[x * 4 + i] = sample[0];
+				const uint32_t value = sampleSize == 2 ? ReadU16(sample) : sample[0];
+				isKey = isKey && value == image.colorKey[i];
+			}
+			out[x * 4 + 3] = isKey ? 0 : 0xff;
+		}
+		break;
+	}
+	case kColorGrayAlpha: {
+		const uint32_t sampleSize = bitDepth / 8;
+		for (uint32_t x = 0; x < width; x++) {
+			const uint8_t* pixel = row + x * 2 * sampleSize;
+			out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = pixel[0];
+			out[x * 4 + 3] = pixel[sampleSize];
+		}
+		break;
+	}
+	case kColorGray: {
+		// 8bit 未満の値は 0～255 に広げる（1bit なら255倍、2bit なら85倍、4bit なら17倍）
+		const uint32_t scale = bitDepth < 8 ? 255 / ((1u << bitDepth) - 1) : 1;
+		for (uint32_t x = 0; x < width; x++) {
+			uint32_t value;
+			uint8_t gray;
+			if (bitDepth < 8) {
+				value = ReadPackedSample(row, x, bitDepth);
+				gray = uint8_t(value * scale);
+			} else if (bitDepth == 8) {
+				value = row[x];
+				gray = row[x];
+			} else {
+				value = ReadU16(row + x * 2);
+				gray = row[x * 2];
+			}
+			out[x * 4 + 0] = out[x * 4 + 1] = out[x * 4 + 2] = gray;
+			out[x * 4 + 3] = image.hasColorKey && value == image.colorKey[0] ? 0 : 0xff;
+		}
+		break;
+	}
+	default: {
+		// パレットに無い番号は不透明な黒にする
+		static const uint8_t kMissing[4] = {0, 0, 0, 0xff};
+		for (uint32_t x = 0; x < width; x++) {
+			const uint32_t index = bitDepth == 8 ? row[x] : ReadPackedSample(row, x, bitDepth);
+			std::memcpy(out + x * 4, index < image.paletteSize ? image.palette[index] : kMissing, 4);
+		}
+		break;
+	}
+	}
+}
+
+} // namespace
+
+bool PngDecoder::CanDecode(const uint8_t* data, size_t size) const {
+	return sizeof(kSignature) <= size && std::memcmp(data, kSignature, sizeof(kSignature)) == 0;
+}
+
+bool PngDecoder::ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const {
+	PngImage image;
+	if (!ParseChunks(data, size, image)) {
+		return false;
+	}
+	info.format = TextureFormat::kR8G8B8A8Unorm;
+	info.width = image.width;
+	info.height = image.height;
+	return true;
+}
+
+bool PngDecoder::DecodeInto(
+    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const {
+	PngImage image;
+	if (!ParseChunks(data, size, image) || rowPitch < size_t(image.width) * 4) {
+		return false;
+	}
+
+	// パスごとの大きさ（インターレースしていなければ1パス）
+	const uint32_t passCount = image.interlace ? 7 : 1;
+	uint32_t passWidths[7] = {};
+	uint32_t passHeights[7] = {};
+	uint64_t rawSize = 0;
+	uint64_t maxRowSize = 0;
+	for (uint32_t pass = 0; pass < passCount; pass++) {
+		const uint32_t startX = image.interlace ? kAdam7StartX[pass] : 0;
+		const uint32_t startY = image.interlace ? kAdam7StartY[pass] : 0;
+		const uint32_t stepX = image.interlace ? kAdam7StepX[pass] : 1;
+		const uint32_t stepY = image.interlace ? kAdam7StepY[pass] : 1;
+		if (image.width <= startX || image.height <= startY) {
+			continue;
+		}
+		passWidths[pass] = (image.width - startX + stepX - 1) / stepX;
+		passHeights[pass] = (image.height - startY + stepY - 1) / stepY;
+		const uint64_t rowSize = image.GetRowSize(passWidths[pass]);
+		rawSize += (rowSize + 1) * passHeights[pass];
+		if (maxRowSize < rowSize) {
+			maxRowSize = rowSize;
+		}
+	}
+	if (kMaxRawSize < rawSize) {
+		return false;
+	}
+
+	// IDAT が複数に分かれていればつなげてから展開する
+	const uint8_t* compressed = image.dataChunks[0].first;
+	size_t compressedSize = image.dataChunks[0].second;
+	std::vector<uint8_t> joined;
+	if (1 < image.dataChunks.size()) {
+		for (const auto& chunk : image.dataChunks) {
+			joined.insert(joined.end(), chunk.first, chunk.first + chunk.second);
+		}
+		compressed = joined.data();
+		compressedSize = joined.size();
+	}
+	std::vector<uint8_t> raw(static_cast<size_t>(rawSize));
+	if (!Inflate::DecompressZlib(compressed, compressedSize, raw.data(), raw.size())) {
+		return false;
+	}
+
+	const size_t bytesPerPixel = (std::max)(image.GetBitsPerPixel() / 8, 1u);
+	const std::vector<uint8_t> zeroRow(static_cast<size_t>(maxRowSize));
+	std::vector<uint8_t> passRow(image.interlace ? size_t(image.width) * 4 : 0);
+	uint8_t* row = raw.data();
+	for (uint32_t pass = 0; pass < passCount; pass++) {
+		const uint32_t width = passWidths[pass];
+		const size_t rowSize = size_t(image.GetRowSize(width));
+		const uint8_t* prior = zeroRow.data();
+		for (uint32_t y = 0; y < passHeights[pass]; y++) {
+			const uint8_t filter = row[0];
+			uint8_t* pixels = row + 1;
+			if (!Unfilter(filter, pixels, prior, rowSize, bytesPerPixel)) {
+				return false;
+			}
+			if (!image.interlace) {
+				ConvertRow(image, pixels, width, destination + y * rowPitch);
+			} else {
+				// パスの画素を画像内の位置へ散らす
+				ConvertRow(image, pixels, width, passRow.data());
+				uint8_t* out = destination + (kAdam7StartY[pass] + y * kAdam7StepY[pass]) * rowPitch;
+				for (uint32_t x = 0; x < width; x++) {
+					const uint32_t imageX = kAdam7StartX[pass] + x * kAdam7StepX[pass];
+					std::memcpy(out + imageX * 4, passRow.data() + x * 4, 4);
+				}
+			}
+			prior = pixels;
+			row += rowSize + 1;
+		}
+	}
+	return true;
+}
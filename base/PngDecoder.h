@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ImageDecoder.h"
+
+/// <summary>
+/// PNG のデコーダ
+/// 全ての色の種類とビット深度（16bit は上位8bit を使う）、パレットの透明度、インターレースに対応し、
+/// RGBA8 へ展開する。フィルタの復元は 3/4 バイトの画素を SIMD で1画素ずつまとめて処理する
+/// </summary>
+class PngDecoder : public ImageDecoder {
+public:
+	const char* GetName() const override { return "PNG"; }
+	bool CanDecode(const uint8_t* data, size_t size) const override;
+	bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const override;
+	bool DecodeInto(
+	    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const override;
+};
@@ -0,0 +1,123 @@
+#include "TextureCache.h"
+#include "DdsDecoder.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace {
+
+// 予約領域に入れるキャッシュの識別子 "TXCH"
+const uint32_t kCacheTag = 0x48435854;
+// キャッシュ形式のバージョン（レイアウトを変えたら上げる）
+const uint32_t kVersion = 1;
+
+} // namespace
+
+std::string TextureCache::GetCachePath(const std::string& sourcePath) { return sourcePath + ".dds"; }
+
+bool TextureCache::HashSource(const std::string& sourcePath, uint64_t& hash) {
+	MappedFile file;
+	if (!file.Open(sourcePath)) {
+		return false;
+	}
+	hash = Hash64(file.GetData(), file.GetSize());
+	return true;
+}
+
+bool TextureCache::Load(const std::string& cachePath, uint64_t key, TextureData& texture) {
+	MappedFile file;
+	if (!file.Open(cachePath)) {
+		return false;
+	}
+	uint64_t storedKey = 0;
+	TextureData loaded;
+	if (!ReadDds(file.GetData(), file.GetSize(), loaded, storedKey) || storedKey != key) {
+		return false;
+	}
+	texture = std::move(loaded);
+	return true;
+}
+
+bool TextureCache::Write(const std::string& cachePath, uint64_t key, const TextureData& texture) {
+	// 一時ファイルに書いてから置き換え、書きかけのキャッシュを読まないようにする
+	const std::string temporaryPath = cachePath + ".tmp";
+	bool isWritten = WriteDds(temporaryPath, key, texture);
+	std::error_code error;
+	if (isWritten) {
+		std::filesystem::rename(temporaryPath, cachePath, error);
+		isWritten = !error;
+	}
+	if (!isWritten) {
+		std::filesystem::remove(temporaryPath, error);
+	}
+	return isWritten;
+}
+
+bool TextureCache::ReadDds(const uint8_t* data, size_t size, TextureData& texture, uint64_t& key) {
+	DdsDecoder::Layout layout;
+	if (!DdsDecoder::ParseHeader(data, size, layout)) {
+		return false;
+	}
+	key = 0;
+	const DdsDecoder::Header& header = layout.header;
+	if (header.reserved1[0] == kCacheTag && header.reserved1[1] == kVersion) {
+		key = uint64_t(header.reserved1[2]) | (uint64_t(header.reserved1[3]) << 32);
+	}
+	return DdsDecoder().Decode(data, size, texture);
+}
+
+bool TextureCache::WriteDds(const std::string& filePath, uint64_t key, const TextureData& texture) {
+	// 読み込み側と同じ詰め方になっているか確かめる
+	size_t offset = 0;
+	for (const TextureMip& mip : texture.mips) {
+		TextureMip packed;
+		if (!DdsDecoder::ComputeMip(texture.format, mip.width, mip.height, packed) ||
+		    mip.offset != offset || mip.rowPitch != packed.rowPitch ||
+		    mip.slicePitch != packed.slicePitch) {
+			return false;
+		}
+		offset += mip.slicePitch;
+	}
+	if (texture.mips.empty() || texture.pixels.size() < offset) {
+		return false;
+	}
+
+	const bool isCompressed = GetBlockSize(texture.format) != 0;
+	DdsDecoder::Header header{};
+	header.size = sizeof(DdsDecoder::Header);
+	header.flags = DdsDecoder::kDdsdCaps | DdsDecoder::kDdsdHeight | DdsDecoder::kDdsdWidth |
+	               DdsDecoder::kDdsdPixelFormat | DdsDecoder::kDdsdMipMapCount |
+	               (isCompressed ? DdsDecoder::kDdsdLinearSize : DdsDecoder::kDdsdPitch);
+	header.height = texture.GetHeight();
+	header.width = texture.GetWidth();
+	header.pitchOrLinearSize = isCompressed ? texture.mips[0].slicePitch : texture.mips[0].rowPitch;
+	header.mipMapCount = texture.GetMipCount();
+	header.reserved1[0] = kCacheTag;
+	header.reserved1[1] = kVersion;
+	header.reserved1[2] = uint32_t(key);
+	header.reserved1[3] = uint32_t(key >> 32);
+	header.pixelFormat.size = sizeof(DdsDecoder::PixelFormat);
+	header.pixelFormat.flags = DdsDecoder::kDdpfFourCC;
+	header.pixelFormat.fourCC = DdsDecoder::kDx10FourCC;
+	header.caps = DdsDecoder::kDdsCapsTexture;
+	if (1 < texture.GetMipCount()) {
+		header.caps |= DdsDecoder::kDdsCapsComplex | DdsDecoder::kDdsCapsMipMap;
+	}
+	DdsDecoder::HeaderDx10 headerDx10{};
+	headerDx10.dxgiFormat = uint32_t(texture.format);
+	headerDx10.resourceDimension = DdsDecoder::kDimensionTexture2D;
+	headerDx10.arraySize = 1;
+
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	const uint32_t magic = DdsDecoder::kMagic;
+	file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(&headerDx10), sizeof(headerDx10));
+	file.write(reinterpret_cast<const char*>(texture.pixels.data()), std::streamsize(offset));
+	return bool(file);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "TextureData.h"
+#include <cstdint>
+#include <string>
+
+/// <summary>
+/// 圧縮済みテクスチャのキャッシュ
+/// 元画像の隣に DDS（DX10 拡張ヘッダ付き）で書き出し、次回以降はデコードと圧縮をせずに読み込む。
+/// 元画像の内容のハッシュと圧縮の設定から作ったキーを DDS ヘッダの予約領域に入れて鮮度を判定する
+/// </summary>
+class TextureCache {
+public:
+	/// <summary>
+	/// 元画像に対応するキャッシュファイルのパス
+	/// </summary>
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	/// <summary>
+	/// 元画像の内容のハッシュ
+	/// </summary>
+	/// <param name="sourcePath">元画像のパス</param>
+	/// <param name="hash">ハッシュ値</param>
+	/// <returns>読めたか</returns>
+	static bool HashSource(const std::string& sourcePath, uint64_t& hash);
+
+	/// <summary>
+	/// キーが一致すればキャッシュを読み込む
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルのパス</param>
+	/// <param name="key">鮮度判定のキー</param>
+	/// <param name="texture">画像</param>
+	/// <returns>読み込めたか（無いか古ければ false）</returns>
+	static bool Load(const std::string& cachePath, uint64_t key, TextureData& texture);
+
+	/// <summary>
+	/// キャッシュの書き出し（一時ファイルに書いてから置き換える）
+	/// </summary>
+	/// <param name="cachePath">キャッシュファイルのパス</param>
+	/// <param name="key">鮮度判定のキー</param>
+	/// <param name="texture">画像（ミップは隙間なく詰まっていること）</param>
+	/// <returns>成否</returns>
+	static bool Write(const std::string& cachePath, uint64_t key, const TextureData& texture);
+
+	/// <summary>
+	/// DDS の読み込み（画素は DdsDecoder で読み、キャッシュのキーを取り出す）
+	/// </summary>
+	/// <param name="data">ファイルの先頭</param>
+	/// <param name="size">バイト数</param>
+	/// <param name="texture">画像</param>
+	/// <param name="key">ヘッダに入っているキー（無ければ0）</param>
+	/// <returns>成否</returns>
+	static bool ReadDds(const uint8_t* data, size_t size, TextureData& texture, uint64_t& key);
+
+	/// <summary>
+	/// DDS の書き出し
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="key">ヘッダに入れるキー</param>
+	/// <param name="texture">画像</param>
+	/// <returns>成否</returns>
+	static bool WriteDds(const std::string& filePath, uint64_t key, const TextureData& texture);
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// テクスチャの画素形式（値は DXGI_FORMAT と同じなので、そのままキャストして使える）
+/// </summary>
+enum class TextureFormat : uint32_t {
+	kUnknown = 0,
+	kR8G8B8A8Unorm = 28,
+	kR8G8B8A8UnormSrgb = 29,
+	kBC1Unorm = 71,
+	kBC1UnormSrgb = 72,
+	kBC3Unorm = 77,
+	kBC3UnormSrgb = 78,
+	kBC4Unorm = 80,
+	kBC5Unorm = 83,
+	kB8G8R8A8Unorm = 87,
+	kB8G8R8A8UnormSrgb = 91,
+	kBC7Unorm = 98,
+	kBC7UnormSrgb = 99,
+};
+
+/// <summary>
+/// ブロック圧縮形式の 4x4 画素1ブロックのバイト数（ブロック圧縮でなければ0）
+/// </summary>
+inline uint32_t GetBlockSize(TextureFormat format) {
+	switch (format) {
+	case TextureFormat::kBC1Unorm:
+	case TextureFormat::kBC1UnormSrgb:
+	case TextureFormat::kBC4Unorm:
+		return 8;
+	case TextureFormat::kBC3Unorm:
+	case TextureFormat::kBC3UnormSrgb:
+	case TextureFormat::kBC5Unorm:
+	case TextureFormat::kBC7Unorm:
+	case TextureFormat::kBC7UnormSrgb:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+/// <summary>
+/// 1画素のバイト数（ブロック圧縮か非対応の形式なら0）
+/// </summary>
+inline uint32_t GetBytesPerPixel(TextureFormat format) {
+	switch (format) {
+	case TextureFormat::kR8G8B8A8Unorm:
+	case TextureFormat::kR8G8B8A8UnormSrgb:
+	case TextureFormat::kB8G8R8A8Unorm:
+	case TextureFormat::kB8G8R8A8UnormSrgb:
+		return 4;
+	default:
+		return 0;
+	}
+}
+
+/// <summary>
+/// sRGB として扱う形式へ変換する（対応する形式が無ければそのまま）
+/// </summary>
+inline TextureFormat MakeSrgb(TextureFormat format) {
+	switch (format) {
+	case TextureFormat::kR8G8B8A8Unorm:
+		return TextureFormat::kR8G8B8A8UnormSrgb;
+	case TextureFormat::kB8G8R8A8Unorm:
+		return TextureFormat::kB8G8R8A8UnormSrgb;
+	case TextureFormat::kBC1Unorm:
+		return TextureFormat::kBC1UnormSrgb;
+	case TextureFormat::kBC3Unorm:
+		return TextureFormat::kBC3UnormSrgb;
+	case TextureFormat::kBC7Unorm:
+		return TextureFormat::kBC7UnormSrgb;
+	default:
+		return format;
+	}
+}
+
+/// <summary>
+/// ミップレベル1枚の配置
+/// </summary>
+struct TextureMip {
+	size_t offset;       // pixels 内の先頭
+	uint32_t width;      // 幅
+	uint32_t height;     // 高さ
+	uint32_t rowPitch;   // 1ライン（ブロック圧縮なら1ブロック行）のバイト数
+	uint32_t slicePitch; // 1枚のバイト数
+};
+
+/// <summary>
+/// CPU側のテクスチャ画像（ミップレベルを先頭から順に pixels へ詰める）
+/// デコードとミップ生成の結果で、GPUへの転送は TextureManager が行う
+/// </summary>
+struct TextureData {
+	TextureFormat format = TextureFormat::kUnknown;
+	std::vector<TextureMip> mips;
+	std::vector<uint8_t> pixels;
+
+	/// <summary>
+	/// ミップレベル0だけの画像として領域を確保する（中身は未初期化）
+	/// </summary>
+	/// <param name="newFormat">画素形式</param>
+	/// <param name="width">幅</param>
+	/// <param name="height">高さ</param>
+	void Allocate(TextureFormat newFormat, uint32_t width, uint32_t height) {
+		format = newFormat;
+		const uint32_t rowPitch = width * GetBytesPerPixel(newFormat);
+		mips.assign(1, {0, width, height, rowPitch, rowPitch * height});
+		pixels.resize(size_t(rowPitch) * height);
+	}
+
+	uint32_t GetWidth() const { return mips.empty() ? 0 : mips[0].width; }
+	uint32_t GetHeight() const { return mips.empty() ? 0 : mips[0].height; }
+	uint32_t GetMipCount() const { return uint32_t(mips.size()); }
+
+	uint8_t* GetMipPixels(size_t mip) { return pixels.data() + mips[mip].offset; }
+	const uint8_t* GetMipPixels(size_t mip) const { return pixels.data() + mips[mip].offset; }
+};
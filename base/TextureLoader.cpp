@@ -0,0 +1,83 @@
+#include "TextureLoader.h"
+#include "Hash.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include <cassert>
+
+TextureLoader::TextureLoader(DecodeFunction decode, MipFunction generateMips)
+    : TextureLoader(Stages{std::move(decode), std::move(generateMips), nullptr, 0}) {}
+
+TextureLoader::TextureLoader(Stages stages) : state_(std::make_shared<State>()) {
+	assert(stages.decode);
+	state_->stages = std::move(stages);
+}
+
+uint64_t TextureLoader::Request(const std::string& filePath) {
+	const uint64_t ticket = nextTicket_++;
+	state_->pendingCount++;
+	ThreadPool::GetInstance()->Enqueue([state = state_, ticket, filePath]() {
+		Result result{ticket, filePath, false, {}};
+		result.isSucceeded = Process(*state, filePath, result.texture);
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->completed.push_back(std::move(result));
+		state->pendingCount--;
+		state->condition.notify_all();
+	});
+	return ticket;
+}
+
+bool TextureLoader::LoadNow(const std::string& filePath, TextureData& texture) const {
+	return Process(*state_, filePath, texture);
+}
+
+size_t TextureLoader::Collect(std::vector<Result>& results) {
+	std::lock_guard<std::mutex> lock(state_->mutex);
+	const size_t count = state_->completed.size();
+	for (Result& result : state_->completed) {
+		results.push_back(std::move(result));
+	}
+	state_->completed.clear();
+	return count;
+}
+
+void TextureLoader::Wait() {
+	std::unique_lock<std::mutex> lock(state_->mutex);
+	state_->condition.wait(lock, [this]() { return state_->pendingCount == 0; });
+}
+
+bool TextureLoader::Process(const State& state, const std::string& filePath, TextureData& texture) {
+	const Stages& stages = state.stages;
+	uint64_t sourceHash = 0;
+	if (!stages.compress || !TextureCache::HashSource(filePath, sourceHash)) {
+		return Decode(state, filePath, texture);
+	}
+
+	// 元画像の内容と圧縮の設定が同じなら、前回の結果をそのまま使う
+	const std::string cachePath = TextureCache::GetCachePath(filePath);
+	const uint64_t key = Hash64(&stages.compressionKey, sizeof(stages.compressionKey), sourceHash);
+	if (TextureCache::Load(cachePath, key, texture)) {
+		return true;
+	}
+	if (!Decode(state, filePath, texture)) {
+		return false;
+	}
+	// 圧縮できない画像（大きさが4の倍数でないなど）は非圧縮のまま使い、キャッシュもしない
+	if (stages.compress(texture)) {
+		TextureCache::Write(cachePath, key, texture);
+	}
+	return true;
+}
+
+bool TextureLoader::Decode(const State& state, const std::string& filePath, TextureData& texture) {
+	const Stages& stages = state.stages;
+	if (!stages.decode(filePath, texture) || texture.mips.empty()) {
+		texture = TextureData();
+		return false;
+	}
+	// ミップ生成に失敗してもレベル0だけで使える
+	if (stages.generateMips && texture.GetMipCount() == 1) {
+		stages.generateMips(texture);
+	}
+	return true;
+}
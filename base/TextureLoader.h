@@ -0,0 +1,116 @@
+#pragma once
+
+#include "TextureData.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// テクスチャの非同期読み込み
+/// デコードとミップ生成（と圧縮）を ThreadPool のワーカーで行い、終わったものを Collect で受け取る。
+/// 圧縮する場合は結果を TextureCache に書き出し、次回以降は元画像が変わっていなければそれを読む。
+/// GPUを使わないので、転送（TextureManager::Update）とは別に処理速度を測れる
+/// </summary>
+class TextureLoader {
+public:
+	// ファイルをミップレベル0の画像へデコードする（失敗したら false）
+	using DecodeFunction = std::function<bool(const std::string& filePath, TextureData& texture)>;
+	// ミップレベル0だけの画像にミップを追加する（失敗したら画像を変えずに false を返す）
+	using MipFunction = std::function<bool(TextureData& texture)>;
+	// ミップ生成済みの画像をブロック圧縮する（失敗したら画像を変えずに false を返す）
+	using CompressFunction = std::function<bool(TextureData& texture)>;
+
+	/// <summary>
+	/// 読み込みの各段階の処理
+	/// </summary>
+	struct Stages {
+		DecodeFunction decode;       // デコード（必須）
+		MipFunction generateMips;    // ミップ生成（nullptr ならミップを作らない）
+		CompressFunction compress;   // 圧縮（nullptr なら圧縮もキャッシュもしない）
+		uint64_t compressionKey = 0; // 圧縮の設定を表す値（変わればキャッシュを作り直す）
+	};
+
+	/// <summary>
+	/// 読み込み結果
+	/// </summary>
+	struct Result {
+		uint64_t ticket;      // Request が返した番号
+		std::string filePath; // ファイルパス
+		bool isSucceeded;     // デコードできたか
+		TextureData texture;  // 画像
+	};
+
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="decode">デコード処理</param>
+	/// <param name="generateMips">ミップ生成処理（nullptr ならミップを作らない）</param>
+	TextureLoader(DecodeFunction decode, MipFunction generateMips = nullptr);
+
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="stages">各段階の処理</param>
+	explicit TextureLoader(Stages stages);
+
+	/// <summary>
+	/// 読み込みの依頼（すぐに戻る）
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>結果と対応づける番号（0は使わない）</returns>
+	uint64_t Request(const std::string& filePath);
+
+	/// <summary>
+	/// 呼び出したスレッドでそのまま読み込む
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="texture">画像</param>
+	/// <returns>デコードできたか</returns>
+	bool LoadNow(const std::string& filePath, TextureData& texture) const;
+
+	/// <summary>
+	/// 終わった読み込みの結果を受け取る（終わった順）
+	/// </summary>
+	/// <param name="results">結果の追加先</param>
+	/// <returns>受け取った数</returns>
+	size_t Collect(std::vector<Result>& results);
+
+	/// <summary>
+	/// 依頼した読み込みが全て終わるまで待つ
+	/// </summary>
+	void Wait();
+
+	/// <summary>
+	/// 終わっていない読み込みの数
+	/// </summary>
+	size_t GetPendingCount() const { return state_->pendingCount; }
+
+private:
+	// ワーカーと共有する状態（ワーカーが処理中に破棄されても残るよう共有する）
+	struct State {
+		Stages stages;
+		std::vector<Result> completed;
+		std::atomic<size_t> pendingCount{0};
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+
+	/// <summary>
+	/// キャッシュの読み込み、またはデコードからキャッシュの書き出しまで
+	/// </summary>
+	static bool Process(const State& state, const std::string& filePath, TextureData& texture);
+
+	/// <summary>
+	/// デコードとミップ生成
+	/// </summary>
+	static bool Decode(const State& state, const std::string& filePath, TextureData& texture);
+
+	std::shared_ptr<State> state_;
+	// 次に発行する番号
+	uint64_t nextTicket_ = 1;
+};
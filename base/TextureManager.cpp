@@ -1,13 +1,138 @@
 #include "TextureManager.h"
+#include "BlockCompressor.h"
+#include "DirectXCommon.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
 #include <DirectXTex.h>
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 using namespace DirectX;
 
+namespace {
+
+// WICでミップレベル0の画像へデコードする
+bool DecodeWithWic(const std::string& filePath, TextureData& texture) {
+	// ワーカースレッドでもWICを使えるよう、スレッドごとに1回COMを初期化する
+	static thread_local HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	(void)comResult;
+
+	// ユニコード文字列に変換（長いパスでも切れないよう、必要な長さを先に求める）
+	const int length = MultiByteToWideChar(CP_ACP, 0, filePath.c_str(), -1, nullptr, 0);
+	if (length <= 0) {
+		return false;
+	}
+	std::wstring wfilePath(size_t(length), L'\0');
+	MultiByteToWideChar(CP_ACP, 0, filePath.c_str(), -1, wfilePath.data(), length);
+
+	TexMetadata metadata{};
+	ScratchImage scratchImg{};
+
+	// WICテクスチャのロード
+	HRESULT result = LoadFromWICFile(wfilePath.c_str(), WIC_FLAGS_NONE, &metadata, scratchImg);
+	if (FAILED(result)) {
+		return false;
+	}
+
+	const Image* img = scratchImg.GetImage(0, 0, 0);
+	texture.format = TextureFormat(metadata.format);
+	texture.mips.assign(
+	    1, {0, uint32_t(img->width), uint32_t(img->height), uint32_t(img->rowPitch),
+	        uint32_t(img->slicePitch)});
+	texture.pixels.assign(img->pixels, img->pixels + img->slicePitch);
+	return true;
+}
+
+// 組み込みのデコーダでデコードし、扱えない画像（プログレッシブ JPEG や BMP など）だけ WIC に任せる
+bool DecodeImageFile(const std::string& filePath, TextureData& texture) {
+	return ImageDecoderRegistry::GetInstance()->DecodeFile(filePath, texture) ||
+	       DecodeWithWic(filePath, texture);
+}
+
+// ミップを生成する（MipGenerator が扱えない形式は DirectXTex に任せる）
+bool GenerateMips(TextureData& texture) {
+	if (MipGenerator::Generate(texture)) {
+		return true;
+	}
+
+	const TextureMip& level0 = texture.mips[0];
+	Image baseImage{};
+	baseImage.width = level0.width;
+	baseImage.height = level0.height;
+	baseImage.format = DXGI_FORMAT(texture.format);
+	baseImage.rowPitch = level0.rowPitch;
+	baseImage.slicePitch = level0.slicePitch;
+	baseImage.pixels = texture.GetMipPixels(0);
+
+	// ミップマップ生成
+	ScratchImage mipChain{};
+	HRESULT result = GenerateMipMaps(baseImage, TEX_FILTER_DEFAULT, 0, mipChain);
+	if (FAILED(result)) {
+		return false;
+	}
+
+	TextureData generated;
+	generated.format = texture.format;
+	generated.pixels.resize(mipChain.GetPixelsSize());
+	size_t offset = 0;
+	for (size_t i = 0; i < mipChain.GetMetadata().mipLevels; i++) {
+		const Image* img = mipChain.GetImage(i, 0, 0);
+		generated.mips.push_back(
+		    {offset, uint32_t(img->width), uint32_t(img->height), uint32_t(img->rowPitch),
+		     uint32_t(img->slicePitch)});
+		std::memcpy(generated.pixels.data() + offset, img->pixels, img->slicePitch);
+		offset += img->slicePitch;
+	}
+	texture = std::move(generated);
+	return true;
+}
+
+// 画像に合わせたリソース設定（読み込んだディフューズテクスチャをSRGBとして扱う）
+CD3DX12_RESOURCE_DESC MakeResourceDesc(const TextureData& data) {
+	return CD3DX12_RESOURCE_DESC::Tex2D(
+	    DXGI_FORMAT(MakeSrgb(data.format)), data.GetWidth(), data.GetHeight(), 1,
+	    (UINT16)data.GetMipCount());
+}
+
+// 追い出したときの代替にする、幅と高さが kFallbackSize 以下のミップ（作れなければ空）
+TextureData ExtractFallback(const TextureData& data) {
+	const bool isCompressed = GetBlockSize(data.format) != 0;
+	for (uint32_t level = 1; level < data.GetMipCount(); level++) {
+		const TextureMip& mip = data.mips[level];
+		if (TextureManager::kFallbackSize < (std::max)(mip.width, mip.height)) {
+			continue;
+		}
+		// ブロック圧縮のテクスチャはレベル0の大きさが4の倍数でなければならない
+		if (isCompressed && (mip.width % 4 != 0 || mip.height % 4 != 0)) {
+			break;
+		}
+		TextureData fallback;
+		fallback.format = data.format;
+		fallback.mips.assign(data.mips.begin() + level, data.mips.end());
+		for (TextureMip& fallbackMip : fallback.mips) {
+			fallbackMip.offset -= mip.offset;
+		}
+		fallback.pixels.assign(data.pixels.begin() + mip.offset, data.pixels.end());
+		return fallback;
+	}
+	return TextureData();
+}
+
+} // namespace
+
 uint32_t TextureManager::Load(const std::string& fileName) {
 	return TextureManager::GetInstance()->LoadInternal(fileName);
 }
 
+uint32_t TextureManager::LoadAsync(const std::string& fileName, LoadCallback onLoaded) {
+	return TextureManager::GetInstance()->LoadAsyncInternal(fileName, std::move(onLoaded));
+}
+
+uint32_t TextureManager::LoadFromData(const std::string& name, const TextureData& data) {
+	return TextureManager::GetInstance()->LoadFromDataInternal(name, data);
+}
+
 bool TextureManager::Unload(uint32_t textureHandle) {
 	return TextureManager::GetInstance()->UnloadInternal(textureHandle);
 }
@@ -18,10 +143,33 @@ TextureManager* TextureManager::GetInstance() {
 }
 
 void TextureManager::Initialize(ID3D12Device* device, std::string directoryPath) {
+	Initialize(device, std::move(directoryPath), false);
+}
+
+void TextureManager::Initialize(
+    ID3D12Device* device, std::string directoryPath, bool compressTextures) {
 	assert(device);
 
 	device_ = device;
 	directoryPath_ = directoryPath;
+	if (!loader_) {
+		decode_ = DecodeImageFile;
+		TextureLoader::Stages stages{decode_, GenerateMips, nullptr, 0};
+		if (compressTextures) {
+			// 圧縮結果は元画像の隣の .dds にキャッシュし、エンコーダか設定が変われば作り直す
+			const BlockCompressor::Options options;
+			stages.compress = [options](TextureData& texture) {
+				return BlockCompressor::Compress(texture, options);
+			};
+			stages.compressionKey =
+			    (uint64_t(BlockCompressor::kVersion) << 32) |
+			    (uint64_t(options.format) << 8) | options.refineIterationCount;
+		}
+		loader_ = std::make_unique<TextureLoader>(std::move(stages));
+		uploader_.Initialize(device_);
+	}
+	// 描画中のフレームが使っているテクスチャは追い出さない
+	residency_.SetEvictionDelay(DirectXCommon::GetInstance()->GetFrameContextCount());
 
 	// デスクリプタサイズを取得
 	sDescriptorHandleIncrementSize_ =
@@ -32,210 +180,450 @@ void TextureManager::Initialize(ID3D12Device* device, std::string directoryPath)
 }
 
 void TextureManager::ResetAll() {
-	HRESULT result = S_FALSE;
+	// 全テクスチャを解放し、古いハンドルを検出できるよう世代を進める
+	for (Texture& texture : textures_) {
+		if (texture.resource) {
+			texture.generation = texture.generation == kMaxGeneration ? 1 : texture.generation + 1;
+		}
+		ReleaseResource(texture);
+		texture.name.clear();
+		texture.loadTicket = 0;
+		texture.refCount = 0;
+		texture.fallback = TextureData();
+	}
+	for (size_t i = 0; i < textures_.size(); i++) {
+		residency_.Unregister(uint32_t(i));
+	}
+	textureIndices_.clear();
 
 	// デスクリプタヒープを生成
-	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
-	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE; // シェーダから見えるように
-	descHeapDesc.NumDescriptors = kNumDescriptors; // シェーダーリソースビュー1つ
-	result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&descriptorHeap_)); // 生成
-	assert(SUCCEEDED(result));
+	if (frameHeaps_.empty()) {
+		CreateDescriptorHeaps(kNumDescriptors);
+	}
 
-	// 全テクスチャを初期化
-	for (size_t i = 0; i < kNumDescriptors; i++) {
-		textures_[i].resource.Reset();
-		textures_[i].cpuDescHandleSRV.ptr = 0;
-		textures_[i].gpuDescHandleSRV.ptr = 0;
-		textures_[i].name.clear();
+	// 予約済みの番号を除いて、小さい番号から使う
+	freeIndices_.clear();
+	for (size_t i = textures_.size(); kNumReservedDescriptors < i; i--) {
+		freeIndices_.push_back(uint32_t(i - 1));
 	}
-	useTable_.Reset();
 }
 
-const D3D12_RESOURCE_DESC TextureManager::GetResoureDesc(uint32_t textureHandle) {
+bool TextureManager::DecodeImage(const std::string& fileName, TextureData& texture) const {
+	return decode_(ResolvePath(fileName), texture) && !texture.mips.empty();
+}
 
-	assert(textureHandle < textures_.size());
-	Texture& texture = textures_.at(textureHandle);
-	return texture.resource->GetDesc();
+const D3D12_RESOURCE_DESC TextureManager::GetResoureDesc(uint32_t textureHandle) {
+	uint32_t index = ToIndex(textureHandle);
+	assert(index != UINT32_MAX);
+	Texture& texture = textures_.at(index);
+	return texture.desc;
 }
 
 void TextureManager::SetGraphicsRootDescriptorTable(
     ID3D12GraphicsCommandList* commandList, UINT rootParamIndex,
     uint32_t textureHandle) { // デスクリプタヒープの配列
-	assert(textureHandle < textures_.size());
-	ID3D12DescriptorHeap* ppHeaps[] = {descriptorHeap_.Get()};
+	uint32_t index = ToIndex(textureHandle);
+	assert(index != UINT32_MAX);
+	ID3D12DescriptorHeap* heap = nullptr;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuStart{};
+	{
+		// 並列記録中のワーカースレッドから同時に呼ばれる
+		std::lock_guard<std::mutex> lock(recordMutex_);
+		FrameHeap& frameHeap = GetFrameHeap();
+		heap = frameHeap.heap.Get();
+		gpuStart = frameHeap.gpuStart;
+
+		// 最近使った順を更新する（追い出し済みなら次の Update で読み込み直す）
+		residency_.Touch(index);
+	}
+	ID3D12DescriptorHeap* ppHeaps[] = {heap};
 	commandList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
 
 	// シェーダリソースビューをセット
 	commandList->SetGraphicsRootDescriptorTable(
-	    rootParamIndex, textures_[textureHandle].gpuDescHandleSRV);
+	    rootParamIndex,
+	    CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuStart, int(index), sDescriptorHandleIncrementSize_));
+}
+
+bool TextureManager::IsValid(uint32_t textureHandle) const {
+	return ToIndex(textureHandle) != UINT32_MAX;
+}
+
+bool TextureManager::IsEvicted(uint32_t textureHandle) const {
+	uint32_t index = ToIndex(textureHandle);
+	if (index == UINT32_MAX) {
+		return false;
+	}
+	TextureResidency::State state = residency_.GetState(index);
+	return state == TextureResidency::State::kEvicted ||
+	       state == TextureResidency::State::kStreaming;
+}
+
+void TextureManager::Update() {
+	ApplyResidency();
+	if (pendingLoads_.empty()) {
+		uploader_.Submit(DirectXCommon::GetInstance()->GetCommandQueue());
+		return;
+	}
+	std::vector<TextureLoader::Result> results;
+	loader_->Collect(results);
+
+	// 完了通知の中から読み込みを追加してもよいように、先に取り出しておく
+	std::vector<std::pair<PendingLoad, bool>> completed;
+	for (TextureLoader::Result& loaded : results) {
+		auto it = pendingLoads_.find(loaded.ticket);
+		if (it == pendingLoads_.end()) {
+			continue;
+		}
+		PendingLoad pending = std::move(it->second);
+		pendingLoads_.erase(it);
+
+		// 待っている間に解放されていれば捨てる
+		bool isSucceeded = false;
+		uint32_t index = ToIndex(pending.textureHandle);
+		if (pending.isRestream) {
+			// 読み込み直しに失敗したら小さいミップのまま
+			if (index != UINT32_MAX &&
+			    residency_.GetState(index) == TextureResidency::State::kStreaming) {
+				if (loaded.isSucceeded) {
+					CreateTexture(index, loaded.texture);
+				}
+				residency_.OnStreamed(index, loaded.isSucceeded);
+			}
+			continue;
+		}
+		if (index != UINT32_MAX && textures_[index].loadTicket == loaded.ticket) {
+			textures_[index].loadTicket = 0;
+			// デコードに失敗したらプレースホルダーのまま
+			if (loaded.isSucceeded) {
+				CreateResidentTexture(index, loaded.texture);
+				isSucceeded = true;
+			}
+		}
+		completed.emplace_back(std::move(pending), isSucceeded);
+	}
+
+	// このフレームの描画より前に転送が終わるよう、まとめて実行する
+	uploader_.Submit(DirectXCommon::GetInstance()->GetCommandQueue());
+
+	for (auto& [pending, isSucceeded] : completed) {
+		for (LoadCallback& callback : pending.callbacks) {
+			if (callback) {
+				callback(pending.textureHandle, isSucceeded);
+			}
+		}
+	}
+}
+
+void TextureManager::FlushAsyncLoads() {
+	while (!pendingLoads_.empty()) {
+		loader_->Wait();
+		Update();
+	}
+}
+
+bool TextureManager::IsLoading(uint32_t textureHandle) const {
+	uint32_t index = ToIndex(textureHandle);
+	return index != UINT32_MAX && textures_[index].loadTicket != 0;
 }
 
 uint32_t TextureManager::LoadInternal(const std::string& fileName) {
 
 	// 読み込み済みテクスチャを検索
-	auto it = std::find_if(textures_.begin(), textures_.end(), [&](const auto& texture) {
-		return texture.name == fileName;
-	});
-	if (it != textures_.end()) {
-		// 読み込み済みテクスチャの要素番号を取得
-		return static_cast<uint32_t>(std::distance(textures_.begin(), it));
+	auto it = textureIndices_.find(fileName);
+	if (it != textureIndices_.end()) {
+		uint32_t index = it->second;
+		textures_[index].refCount++;
+		// 非同期で読み込み中なら、終わるまで待って差し替える
+		if (textures_[index].loadTicket != 0) {
+			FlushAsyncLoads();
+		}
+		return ToHandle(index);
 	}
 
+	// デコードとミップ生成はこのスレッドで行う
+	TextureData data;
+	[[maybe_unused]] bool isLoaded = loader_->LoadNow(ResolvePath(fileName), data);
+	assert(isLoaded);
+
 	// 書き込むテクスチャの参照
-	uint32_t handle = uint32_t(useTable_.FindFirst());
-	assert(handle < kNumDescriptors);
+	uint32_t index = AllocateIndex();
+	textures_[index].name = fileName;
+	textures_[index].refCount = 1;
+	CreateResidentTexture(index, data);
+	uploader_.Submit(DirectXCommon::GetInstance()->GetCommandQueue());
+
+	textureIndices_.emplace(fileName, index);
+
+	return ToHandle(index);
+}
+
+uint32_t TextureManager::LoadAsyncInternal(const std::string& fileName, LoadCallback onLoaded) {
+	// 差し替えるまで参照させるテクスチャ（初めて使うときに読み込み、その参照は解放しない）
+	auto placeholder = textureIndices_.find(kPlaceholderFileName);
+	uint32_t placeholderIndex = placeholder != textureIndices_.end()
+	                                ? placeholder->second
+	                                : ToIndex(LoadInternal(kPlaceholderFileName));
+
+	// 読み込み済みか、読み込み中のテクスチャを検索
+	auto it = textureIndices_.find(fileName);
+	if (it != textureIndices_.end()) {
+		uint32_t index = it->second;
+		uint32_t handle = ToHandle(index);
+		textures_[index].refCount++;
+		if (textures_[index].loadTicket != 0) {
+			pendingLoads_[textures_[index].loadTicket].callbacks.push_back(std::move(onLoaded));
+		} else if (onLoaded) {
+			onLoaded(handle, true);
+		}
+		return handle;
+	}
 
-	Texture& texture = textures_.at(handle);
+	// 書き込むテクスチャの参照（ヒープを大きくすると配列が作り直されるので確保してから取る）
+	uint32_t index = AllocateIndex();
+	Texture& texture = textures_.at(index);
 	texture.name = fileName;
+	texture.refCount = 1;
+	texture.resource = textures_[placeholderIndex].resource;
+	texture.desc = textures_[placeholderIndex].desc;
+	texture.loadTicket = loader_->Request(ResolvePath(fileName));
+
+	// プレースホルダーのビューを複製する
+	device_->CopyDescriptorsSimple(
+	    1, GetStagingHandle(index), GetStagingHandle(placeholderIndex),
+	    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	CommitDescriptor(index);
+
+	textureIndices_.emplace(fileName, index);
+
+	uint32_t handle = ToHandle(index);
+	PendingLoad& pending = pendingLoads_[texture.loadTicket];
+	pending.textureHandle = handle;
+	pending.callbacks.push_back(std::move(onLoaded));
+	return handle;
+}
 
-	// ディレクトリパスとファイル名を連結してフルパスを得る
-	bool currentRelative = false;
-	if (2 < fileName.size()) {
-		currentRelative = (fileName[0] == '.') && (fileName[1] == '/');
+uint32_t TextureManager::LoadFromDataInternal(const std::string& name, const TextureData& data) {
+	auto it = textureIndices_.find(name);
+	if (it != textureIndices_.end()) {
+		textures_[it->second].refCount++;
+		return ToHandle(it->second);
 	}
-	std::string fullPath = currentRelative ? fileName : directoryPath_ + fileName;
 
-	// ユニコード文字列に変換
-	wchar_t wfilePath[256];
-	MultiByteToWideChar(CP_ACP, 0, fullPath.c_str(), -1, wfilePath, _countof(wfilePath));
+	uint32_t index = AllocateIndex();
+	textures_[index].name = name;
+	textures_[index].refCount = 1;
+	CreateResidentTexture(index, data, false);
+	uploader_.Submit(DirectXCommon::GetInstance()->GetCommandQueue());
 
-	HRESULT result;
+	textureIndices_.emplace(name, index);
 
-	TexMetadata metadata{};
-	ScratchImage scratchImg{};
+	return ToHandle(index);
+}
 
-	// WICテクスチャのロード
-	result = LoadFromWICFile(wfilePath, WIC_FLAGS_NONE, &metadata, scratchImg);
-	assert(SUCCEEDED(result));
+bool TextureManager::UnloadInternal(uint32_t textureHandle) {
+	// 範囲外か、解放済み
+	uint32_t index = ToIndex(textureHandle);
+	if (index == UINT32_MAX) {
+		return false;
+	}
 
-	ScratchImage mipChain{};
-	// ミップマップ生成
-	result = GenerateMipMaps(
-	    scratchImg.GetImages(), scratchImg.GetImageCount(), scratchImg.GetMetadata(),
-	    TEX_FILTER_DEFAULT, 0, mipChain);
-	if (SUCCEEDED(result)) {
-		scratchImg = std::move(mipChain);
-		metadata = scratchImg.GetMetadata();
+	// 他に参照が残っていれば解放しない
+	auto& texture = textures_[index];
+	if (0 < texture.refCount && 0 < --texture.refCount) {
+		return true;
 	}
 
-	// 読み込んだディフューズテクスチャをSRGBとして扱う
-	metadata.format = MakeSRGB(metadata.format);
+	// テクスチャ設定を解除
+	residency_.Unregister(index);
+	textureIndices_.erase(texture.name);
+	ReleaseResource(texture);
+	texture.name.clear();
+	texture.loadTicket = 0;
+	texture.fallback = TextureData();
+	// 古いハンドルを検出できるよう世代を進める（0は使わない）
+	texture.generation = texture.generation == kMaxGeneration ? 1 : texture.generation + 1;
+	freeIndices_.push_back(index);
+	return true;
+}
+
+void TextureManager::CreateTexture(uint32_t index, const TextureData& data) {
+	assert(!data.mips.empty());
+	Texture& texture = textures_.at(index);
+
+	HRESULT result;
 
 	// リソース設定
-	CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-	    metadata.format, metadata.width, (UINT)metadata.height, (UINT16)metadata.arraySize,
-	    (UINT16)metadata.mipLevels);
+	CD3DX12_RESOURCE_DESC texresDesc = MakeResourceDesc(data);
+	const DXGI_FORMAT format = texresDesc.Format;
 
 	// ヒーププロパティ
-	CD3DX12_HEAP_PROPERTIES heapProps =
-	    CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0);
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
 
-	// テクスチャ用バッファの生成
+	// テクスチャ用バッファの生成（コピーキューと描画キューの両方で使うので COMMON で作る）
+	ReleaseResource(texture);
 	result = device_->CreateCommittedResource(
-	    &heapProps, D3D12_HEAP_FLAG_NONE, &texresDesc,
-	    D3D12_RESOURCE_STATE_GENERIC_READ, // テクスチャ用指定
-	    nullptr, IID_PPV_ARGS(&texture.resource));
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &texresDesc, D3D12_RESOURCE_STATE_COMMON, nullptr,
+	    IID_PPV_ARGS(&texture.resource));
 	assert(SUCCEEDED(result));
 
-	// テクスチャバッファにデータ転送
-	for (size_t i = 0; i < metadata.mipLevels; i++) {
-		const Image* img = scratchImg.GetImage(i, 0, 0); // 生データ抽出
-		result = texture.resource->WriteToSubresource(
-		    (UINT)i,
-		    nullptr,              // 全領域へコピー
-		    img->pixels,          // 元データアドレス
-		    (UINT)img->rowPitch,  // 1ラインサイズ
-		    (UINT)img->slicePitch // 1枚サイズ
-		);
-		assert(SUCCEEDED(result));
-	}
+	// テクスチャバッファにデータ転送（実行は Submit で行う）
+	uploader_.Upload(texture.resource.Get(), data);
 
 	// シェーダリソースビュー作成
-	texture.cpuDescHandleSRV = CD3DX12_CPU_DESCRIPTOR_HANDLE(
-	    descriptorHeap_->GetCPUDescriptorHandleForHeapStart(), handle,
-	    sDescriptorHandleIncrementSize_);
-	texture.gpuDescHandleSRV = CD3DX12_GPU_DESCRIPTOR_HANDLE(
-	    descriptorHeap_->GetGPUDescriptorHandleForHeapStart(), handle,
-	    sDescriptorHandleIncrementSize_);
-
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{}; // 設定構造体
-	D3D12_RESOURCE_DESC resDesc = texture.resource->GetDesc();
-
-	srvDesc.Format = resDesc.Format;
+	srvDesc.Format = format;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D; // 2Dテクスチャ
-	srvDesc.Texture2D.MipLevels = (UINT)metadata.mipLevels;
+	srvDesc.Texture2D.MipLevels = data.GetMipCount();
 
+	// 見えないヒープに作ってから、シェーダーから見えるヒープへコピーする
 	device_->CreateShaderResourceView(
 	    texture.resource.Get(), //ビューと関連付けるバッファ
 	    &srvDesc,               //テクスチャ設定情報
-	    texture.cpuDescHandleSRV);
-
-	useTable_.Set(handle);
-
-	return handle;
+	    GetStagingHandle(index));
+	CommitDescriptor(index);
 }
 
-bool TextureManager::UnloadInternal(uint32_t textureHandle) {
-	// 範囲外
-	if (textures_.size() <= textureHandle) {
-		return false;
+void TextureManager::CreateResidentTexture(
+    uint32_t index, const TextureData& data, bool canRestream) {
+	CreateTexture(index, data);
+	Texture& texture = textures_[index];
+	texture.desc = texture.resource->GetDesc();
+	texture.fallback = canRestream ? ExtractFallback(data) : TextureData();
+
+	// 予算はドライバが実際に確保する大きさで数える（代替が無ければ同じ大きさにして追い出さない）
+	const uint64_t residentSize = device_->GetResourceAllocationInfo(0, 1, &texture.desc).SizeInBytes;
+	uint64_t fallbackSize = residentSize;
+	if (!texture.fallback.mips.empty()) {
+		CD3DX12_RESOURCE_DESC fallbackDesc = MakeResourceDesc(texture.fallback);
+		fallbackSize = device_->GetResourceAllocationInfo(0, 1, &fallbackDesc).SizeInBytes;
 	}
+	residency_.Register(index, residentSize, fallbackSize);
+}
 
-	auto& texture = textures_[textureHandle];
-	// 範囲内だけど読んでない場所
-	assert(!texture.name.empty());
+void TextureManager::ApplyResidency() {
+	TextureResidency::Decisions decisions =
+	    residency_.Update(DirectXCommon::GetInstance()->GetFrameCount());
 
-	// テクスチャ設定を解除
-	texture.resource.Reset();
-	texture.cpuDescHandleSRV.ptr = 0;
-	texture.gpuDescHandleSRV.ptr = 0;
-	texture.name.clear();
-	useTable_.Reset(textureHandle);
-	return true;
-}
+	// 小さいミップのリソースへ差し替える（元のリソースは描画中のフレームが終わってから解放される）
+	for (uint32_t index : decisions.evictions) {
+		CreateTexture(index, textures_[index].fallback);
+	}
 
-template<size_t kNumberOfBits> TextureManager::Bitset<kNumberOfBits>::Bitset() { Reset(); }
+	// 読み込み直しの間は小さいミップのまま描画する
+	for (uint32_t index : decisions.restreams) {
+		uint64_t ticket = loader_->Request(ResolvePath(textures_[index].name));
+		pendingLoads_[ticket] = {ToHandle(index), {}, true};
+	}
+}
 
-template<size_t kNumberOfBits> size_t TextureManager::Bitset<kNumberOfBits>::FindFirst() const {
-	for (size_t wordIndex = 0; wordIndex < kCountOfWord; ++wordIndex) {
-		int firstZero = std::countr_one(words_[wordIndex]);
-		if (firstZero != kBitsPerWord) {
-			return wordIndex * kBitsPerWord + firstZero;
+void TextureManager::CommitDescriptor(uint32_t index) {
+	// 今のフレームのヒープは前に使ったフレームが終わっているので、すぐに書き換えてよい
+	FrameHeap& current = GetFrameHeap();
+	device_->CopyDescriptorsSimple(
+	    1,
+	    CD3DX12_CPU_DESCRIPTOR_HANDLE(current.cpuStart, int(index), sDescriptorHandleIncrementSize_),
+	    GetStagingHandle(index), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	// 他のフレームのヒープは描画中かもしれないので、そのフレームで使うときまで遅らせる
+	for (FrameHeap& frameHeap : frameHeaps_) {
+		if (&frameHeap != &current) {
+			frameHeap.dirtyIndices.push_back(index);
 		}
 	}
-
-	return kCountOfWord * kBitsPerWord;
 }
 
-template<size_t kNumberOfBits>
-void TextureManager::Bitset<kNumberOfBits>::Set(size_t bitIndex, bool value) {
-	assert(bitIndex < kNumberOfBits);
-	uint64_t& word = GetWord(bitIndex);
-	if (value) {
-		word |= (uint64_t(1) << (bitIndex & kBitsPerWordMask));
-	} else {
-		word &= ~(uint64_t(1) << (bitIndex & kBitsPerWordMask));
+TextureManager::FrameHeap& TextureManager::GetFrameHeap() {
+	FrameHeap& frameHeap = frameHeaps_[DirectXCommon::GetInstance()->GetFrameIndex()];
+	for (uint32_t index : frameHeap.dirtyIndices) {
+		device_->CopyDescriptorsSimple(
+		    1,
+		    CD3DX12_CPU_DESCRIPTOR_HANDLE(
+		        frameHeap.cpuStart, int(index), sDescriptorHandleIncrementSize_),
+		    GetStagingHandle(index), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 	}
+	frameHeap.dirtyIndices.clear();
+	return frameHeap;
 }
 
-template<size_t kNumberOfBits> void TextureManager::Bitset<kNumberOfBits>::Reset() {
-	std::memset(words_, 0, sizeof(words_));
-	std::memset(words_, 0xff, sizeof(words_[0]) * 3);
+void TextureManager::ReleaseResource(Texture& texture) {
+	DirectXCommon::GetInstance()->DeferRelease(std::move(texture.resource));
+}
+
+std::string TextureManager::ResolvePath(const std::string& fileName) const {
+	// ディレクトリパスとファイル名を連結してフルパスを得る
+	bool currentRelative = false;
+	if (2 < fileName.size()) {
+		currentRelative = (fileName[0] == '.') && (fileName[1] == '/');
+	}
+	return currentRelative ? fileName : directoryPath_ + fileName;
 }
 
-template<size_t kNumberOfBits> void TextureManager::Bitset<kNumberOfBits>::Reset(size_t bitIndex) {
-	Set(bitIndex, false);
+void TextureManager::CreateDescriptorHeaps(size_t capacity) {
+	assert(capacity <= size_t(kHandleIndexMask) + 1);
+	HRESULT result = S_FALSE;
+
+	// ビューの作成先はシェーダーから見えないヒープ（コピー元にできるのはこちらだけ）
+	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc = {};
+	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	descHeapDesc.NumDescriptors = UINT(capacity);
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> stagingHeap;
+	result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&stagingHeap));
+	assert(SUCCEEDED(result));
+
+	// 作成済みのビューを移す
+	const size_t oldCapacity = textures_.size();
+	if (oldCapacity != 0) {
+		device_->CopyDescriptorsSimple(
+		    UINT(oldCapacity), stagingHeap->GetCPUDescriptorHandleForHeapStart(),
+		    stagingHeap_->GetCPUDescriptorHandleForHeapStart(),
+		    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	}
+	stagingHeap_ = stagingHeap;
+
+	// フレームごとにシェーダーから見えるヒープを作り、全てのビューをコピーする
+	DirectXCommon* dxCommon = DirectXCommon::GetInstance();
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE; // シェーダから見えるように
+	frameHeaps_.resize(dxCommon->GetFrameContextCount());
+	for (FrameHeap& frameHeap : frameHeaps_) {
+		// 古いヒープは描画中のフレームが参照しているかもしれないので、フレームが終わってから解放する
+		dxCommon->DeferRelease(std::move(frameHeap.heap));
+		result = device_->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&frameHeap.heap));
+		assert(SUCCEEDED(result));
+		frameHeap.cpuStart = frameHeap.heap->GetCPUDescriptorHandleForHeapStart();
+		frameHeap.gpuStart = frameHeap.heap->GetGPUDescriptorHandleForHeapStart();
+		frameHeap.dirtyIndices.clear();
+		if (oldCapacity != 0) {
+			device_->CopyDescriptorsSimple(
+			    UINT(oldCapacity), frameHeap.cpuStart,
+			    stagingHeap_->GetCPUDescriptorHandleForHeapStart(),
+			    D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		}
+	}
+
+	textures_.resize(capacity);
 }
 
-template<size_t kNumberOfBits>
-bool TextureManager::Bitset<kNumberOfBits>::Test(size_t bitIndex) const {
-	assert(bitIndex < kNumberOfBits);
-	return (GetWord(bitIndex) & (uint64_t(1) << (bitIndex & kBitsPerWordMask))) != 0;
+uint32_t TextureManager::AllocateIndex() {
+	if (freeIndices_.empty()) {
+		const size_t oldCapacity = textures_.size();
+		CreateDescriptorHeaps(oldCapacity * 2);
+		for (size_t i = textures_.size(); oldCapacity < i; i--) {
+			freeIndices_.push_back(uint32_t(i - 1));
+		}
+	}
+	uint32_t index = freeIndices_.back();
+	freeIndices_.pop_back();
+	return index;
 }
 
-template<size_t kNumberOfBits>
-uint64_t& TextureManager::Bitset<kNumberOfBits>::GetWord(size_t bitIndex) {
-	return words_[bitIndex >> kBitIndexToWordIndex];
-}
\ No newline at end of file
+uint32_t TextureManager::ToIndex(uint32_t textureHandle) const {
+	uint32_t index = textureHandle & kHandleIndexMask;
+	if (textures_.size() <= index || !textures_[index].resource ||
+	    textures_[index].generation != (textureHandle >> kHandleIndexBits)) {
+		return UINT32_MAX;
+	}
+	return index;
+}
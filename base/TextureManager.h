@@ -1,18 +1,45 @@
 #pragma once
 
-#include <array>
+#include "TextureLoader.h"
+#include "TextureResidency.h"
+#include "TextureUploader.h"
+#include <cstdint>
 #include <d3dx12.h>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <wrl.h>
 
 /// <summary>
 /// テクスチャマネージャ
+/// 名前からハンドルへはハッシュで引き、デスクリプタが足りなくなればヒープを倍の大きさで作り直す。
+/// ハンドルは下位にデスクリプタ番号、上位に世代を持ち、解放済みの番号を指す古いハンドルを検出する。
+/// LoadAsync はデコードとミップ生成をワーカーに任せ、終わるまではプレースホルダーを参照させる。
+/// テクスチャはデフォルトヒープに作り、コピーキューで転送する。
+/// Load / LoadAsync ごとに参照カウントを増やし、Unload で0になったら解放する。
+/// メモリ予算を超えたら SetGraphicsRootDescriptorTable で最近使っていないものから小さいミップだけに差し替え、
+/// また使われたら読み込み直す。
+/// 描画中のフレームが読んでいるデスクリプタを書き換えないよう、シェーダーから見えるヒープはフレームごとに持ち、
+/// 差し替えたビューはそのフレームのヒープを次に使うときに反映する。差し替えたリソースの解放もフレームの完了まで遅らせる
 /// </summary>
 class TextureManager {
 public:
-	// デスクリプターの数
+	// デスクリプターの初期数（足りなくなると倍に増やす）
 	static const size_t kNumDescriptors = 256;
+	// 先頭の予約済みデスクリプター数（テクスチャには使わない）
+	static const size_t kNumReservedDescriptors = 192;
+	// ハンドルのうちデスクリプタ番号のビット数（残りが世代）
+	static const uint32_t kHandleIndexBits = 20;
+	// 非同期読み込みが終わるまで代わりに参照させるテクスチャ
+	static constexpr char kPlaceholderFileName[] = "white1x1.png";
+	// 追い出したテクスチャの代わりに常駐させるミップの幅と高さの上限
+	static const uint32_t kFallbackSize = 64;
+
+	// 非同期読み込みの完了通知（失敗したらハンドルはプレースホルダーのまま）
+	using LoadCallback = std::function<void(uint32_t textureHandle, bool isSucceeded)>;
 
 	/// <summary>
 	/// テクスチャ
@@ -20,12 +47,18 @@ public:
 	struct Texture {
 		// テクスチャリソース
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
-		// シェーダリソースビューのハンドル(CPU)
-		CD3DX12_CPU_DESCRIPTOR_HANDLE cpuDescHandleSRV;
-		// シェーダリソースビューのハンドル(CPU)
-		CD3DX12_GPU_DESCRIPTOR_HANDLE gpuDescHandleSRV;
 		// 名前
 		std::string name;
+		// 世代（解放するたびに進める）
+		uint32_t generation = 1;
+		// 非同期読み込みの番号（0なら読み込み済み）
+		uint64_t loadTicket = 0;
+		// 参照カウント
+		uint32_t refCount = 0;
+		// 全ミップのリソース情報（追い出している間も元の大きさを返す）
+		D3D12_RESOURCE_DESC desc{};
+		// 追い出したときに使う小さいミップ（空なら追い出さない）
+		TextureData fallback;
 	};
 
 	/// <summary>
@@ -36,7 +69,25 @@ public:
 	static uint32_t Load(const std::string& fileName);
 
 	/// <summary>
-	/// 読み込み解除
+	/// 非同期読み込み（すぐにハンドルを返し、Update で転送するまではプレースホルダーを参照する）
+	/// 読み込み済みなら onLoaded はその場で呼ばれる
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="onLoaded">完了通知（Update を呼んだスレッドで呼ばれる）</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t LoadAsync(const std::string& fileName, LoadCallback onLoaded = nullptr);
+
+	/// <summary>
+	/// メモリ上の画像からの読み込み（アトラスなど。ファイルが無いので追い出さない）
+	/// 同じ名前が読み込み済みなら画像は使わずにそのハンドルを返す
+	/// </summary>
+	/// <param name="name">名前（ファイル名と重ならないようにする）</param>
+	/// <param name="data">画像</param>
+	/// <returns>テクスチャハンドル</returns>
+	static uint32_t LoadFromData(const std::string& name, const TextureData& data);
+
+	/// <summary>
+	/// 読み込み解除（参照カウントを減らし、0になったら解放する）
 	/// </summary>
 	/// <param name="textureHandle">テクスチャハンドル</param>
 	static bool Unload(uint32_t textureHandle);
@@ -48,25 +99,54 @@ public:
 	static TextureManager* GetInstance();
 
 	/// <summary>
-	/// システム初期化
+	/// システム初期化（圧縮無し）
 	/// </summary>
 	/// <param name="device">デバイス</param>
+	/// <param name="directoryPath">テクスチャのディレクトリ</param>
 	void Initialize(ID3D12Device* device, std::string directoryPath = "Resources/");
 
+	/// <summary>
+	/// システム初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	/// <param name="directoryPath">テクスチャのディレクトリ</param>
+	/// <param name="compressTextures">BC7 に圧縮して元画像の隣の .dds にキャッシュするか
+	/// （無効なら読み込み結果もディレクトリの中身も変えない。最初の読み込みで loader を作るときだけ効く）</param>
+	void Initialize(ID3D12Device* device, std::string directoryPath, bool compressTextures);
+
 	/// <summary>
 	/// 全テクスチャリセット
 	/// </summary>
 	void ResetAll();
 
 	/// <summary>
-	/// リソース情報取得
+	/// 画像ファイルをデコードする（テクスチャは作らない。DDS ならファイル内のミップも読む）
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="texture">画像</param>
+	/// <returns>デコードできたか</returns>
+	bool DecodeImage(const std::string& fileName, TextureData& texture) const;
+
+	/// <summary>
+	/// 毎フレーム処理（描画開始前に呼ぶ）
+	/// デコードの終わったテクスチャをGPUへ転送してハンドルを差し替え、完了通知を呼ぶ
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// 非同期読み込みを全て終わらせる
+	/// </summary>
+	void FlushAsyncLoads();
+
+	/// <summary>
+	/// リソース情報取得（読み込み中ならプレースホルダーの情報）
 	/// </summary>
 	/// <param name="textureHandle">テクスチャハンドル</param>
 	/// <returns>リソース情報</returns>
 	const D3D12_RESOURCE_DESC GetResoureDesc(uint32_t textureHandle);
 
 	/// <summary>
-	/// デスクリプタテーブルをセット
+	/// デスクリプタテーブルをセット（並列記録中のワーカースレッドから呼んでもよい）
 	/// </summary>
 	/// <param name="commandList">コマンドリスト</param>
 	/// <param name="rootParamIndex">ルートパラメータ番号</param>
@@ -74,34 +154,76 @@ public:
 	void SetGraphicsRootDescriptorTable(
 	    ID3D12GraphicsCommandList* commandList, UINT rootParamIndex, uint32_t textureHandle);
 
+	/// <summary>
+	/// ハンドルが読み込み済みのテクスチャを指しているか（解放済みなら false）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	bool IsValid(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// テクスチャのメモリ予算の設定（超えた分は次の Update から追い出す）
+	/// </summary>
+	/// <param name="budget">バイト数（TextureResidency::kUnlimitedBudget なら制限なし）</param>
+	void SetMemoryBudget(uint64_t budget) { residency_.SetBudget(budget); }
+
+	/// <summary>
+	/// 予算に数えているテクスチャのメモリ量
+	/// </summary>
+	uint64_t GetMemoryUsage() const { return residency_.GetUsage(); }
+
+	/// <summary>
+	/// 追い出して小さいミップだけになっているか（読み込み直し中を含む）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	bool IsEvicted(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// 読み込み済みのテクスチャ数
+	/// </summary>
+	size_t GetTextureCount() const { return textureIndices_.size(); }
+
+	/// <summary>
+	/// 現在のデスクリプタヒープの大きさ
+	/// </summary>
+	size_t GetDescriptorCapacity() const { return textures_.size(); }
+
+	/// <summary>
+	/// 非同期読み込み中か（まだプレースホルダーを参照している）
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	bool IsLoading(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// 非同期読み込み中のテクスチャ数（追い出したテクスチャの読み込み直しを含む）
+	/// </summary>
+	size_t GetLoadingCount() const { return pendingLoads_.size(); }
+
 private:
 	TextureManager() = default;
 	~TextureManager() = default;
 	TextureManager(const TextureManager&) = delete;
 	TextureManager& operator=(const TextureManager&) = delete;
 
-	// C++のbitsetが内部詳細にアクセスできないのでfindFirst用に自作
-	template<size_t kNumberOfBits> class Bitset {
-
-	public:
-		Bitset();
-		size_t FindFirst() const;
-		void Set(size_t bitIndex, bool value = true);
-		void Reset();
-		void Reset(size_t bitIndex);
-		bool Test(size_t bitIndex) const;
+	// ハンドルのデスクリプタ番号部分
+	static const uint32_t kHandleIndexMask = (1u << kHandleIndexBits) - 1;
+	// 世代の最大値
+	static const uint32_t kMaxGeneration = (1u << (32 - kHandleIndexBits)) - 1;
 
-	private:
-		uint64_t& GetWord(size_t bitIndex);
-
-	private:
-		static constexpr size_t kCountOfWord =
-		    (kNumberOfBits == 0 ? 1 : ((kNumberOfBits - 1) / (8 * sizeof(uint64_t)) + 1));
-		static constexpr size_t kBitsPerWord = 8 * sizeof(uint64_t);
-		static constexpr size_t kBitsPerWordMask = kBitsPerWord - 1;
-		static constexpr size_t kBitIndexToWordIndex = 6;
+	// フレームごとのシェーダーから見えるデスクリプタヒープ
+	struct FrameHeap {
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> heap;
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuStart;
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuStart;
+		// 見えないヒープからまだコピーしていないデスクリプタ番号
+		std::vector<uint32_t> dirtyIndices;
+	};
 
-		uint64_t words_[kCountOfWord];
+	// 転送待ちの非同期読み込み
+	struct PendingLoad {
+		uint32_t textureHandle;
+		std::vector<LoadCallback> callbacks;
+		// 追い出したテクスチャの読み込み直しか
+		bool isRestream = false;
 	};
 
 	// デバイス
@@ -110,11 +232,28 @@ private:
 	UINT sDescriptorHandleIncrementSize_ = 0u;
 	// ディレクトリパス
 	std::string directoryPath_;
-	// デスクリプタヒープ
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap_;
-	// テクスチャコンテナ
-	std::array<Texture, kNumDescriptors> textures_;
-	Bitset<kNumDescriptors> useTable_;
+	// シェーダーから見えるデスクリプタヒープ（フレームのコンテキストの番号順）
+	std::vector<FrameHeap> frameHeaps_;
+	// シェーダーから見えないデスクリプタヒープ（ビューの作成先。フレームごとのヒープへのコピー元にする）
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> stagingHeap_;
+	// テクスチャコンテナ（デスクリプタ番号順）
+	std::vector<Texture> textures_;
+	// 空いているデスクリプタ番号（末尾から使う）
+	std::vector<uint32_t> freeIndices_;
+	// 名前からデスクリプタ番号への索引
+	std::unordered_map<std::string, uint32_t> textureIndices_;
+	// デコード
+	TextureLoader::DecodeFunction decode_;
+	// デコードとミップ生成
+	std::unique_ptr<TextureLoader> loader_;
+	// GPUへの転送
+	TextureUploader uploader_;
+	// 非同期読み込みの番号から転送先への索引
+	std::unordered_map<uint64_t, PendingLoad> pendingLoads_;
+	// メモリ予算と追い出しの判断
+	TextureResidency residency_;
+	// 描画中に書き換える状態（フレームのヒープへのコピーと最近使った順）の保護用
+	std::mutex recordMutex_;
 
 	/// <summary>
 	/// 読み込み
@@ -122,9 +261,102 @@ private:
 	/// <param name="fileName">ファイル名</param>
 	uint32_t LoadInternal(const std::string& fileName);
 
+	/// <summary>
+	/// 非同期読み込み
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	/// <param name="onLoaded">完了通知</param>
+	uint32_t LoadAsyncInternal(const std::string& fileName, LoadCallback onLoaded);
+
+	/// <summary>
+	/// メモリ上の画像からの読み込み
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="data">画像</param>
+	uint32_t LoadFromDataInternal(const std::string& name, const TextureData& data);
+
 	/// <summary>
 	/// 読み込み解除
 	/// </summary>
 	/// <param name="textureHandle">テクスチャハンドル</param>
 	bool UnloadInternal(uint32_t textureHandle);
+
+	/// <summary>
+	/// 画像からテクスチャリソースとシェーダリソースビューを作る
+	/// </summary>
+	/// <param name="index">デスクリプタ番号</param>
+	/// <param name="data">画像</param>
+	void CreateTexture(uint32_t index, const TextureData& data);
+
+	/// <summary>
+	/// 読み込んだ画像で全ミップのテクスチャを作り、常駐管理に登録する
+	/// </summary>
+	/// <param name="index">デスクリプタ番号</param>
+	/// <param name="data">画像</param>
+	/// <param name="canRestream">ファイルから読み込み直せるか（false なら追い出さない）</param>
+	void CreateResidentTexture(uint32_t index, const TextureData& data, bool canRestream = true);
+
+	/// <summary>
+	/// 常駐管理の判断に従って、追い出しと読み込み直しの依頼を行う
+	/// </summary>
+	void ApplyResidency();
+
+	/// <summary>
+	/// 見えないヒープのビューをシェーダーから見えるヒープへコピーする
+	/// 今のフレームのヒープにはすぐに、他のフレームのヒープにはそのフレームで使うときにコピーする
+	/// </summary>
+	/// <param name="index">デスクリプタ番号</param>
+	void CommitDescriptor(uint32_t index);
+
+	/// <summary>
+	/// 今のフレームのヒープを取得する（前に使ってから差し替えたビューを反映する）
+	/// </summary>
+	FrameHeap& GetFrameHeap();
+
+	/// <summary>
+	/// テクスチャリソースを手放す（描画中のフレームが終わってから解放される）
+	/// </summary>
+	/// <param name="texture">テクスチャ</param>
+	static void ReleaseResource(Texture& texture);
+
+	/// <summary>
+	/// 見えないヒープのハンドル
+	/// </summary>
+	/// <param name="index">デスクリプタ番号</param>
+	CD3DX12_CPU_DESCRIPTOR_HANDLE GetStagingHandle(uint32_t index) const {
+		return CD3DX12_CPU_DESCRIPTOR_HANDLE(
+		    stagingHeap_->GetCPUDescriptorHandleForHeapStart(), int(index),
+		    sDescriptorHandleIncrementSize_);
+	}
+
+	/// <summary>
+	/// ファイル名からディレクトリを含むパスを得る
+	/// </summary>
+	/// <param name="fileName">ファイル名</param>
+	std::string ResolvePath(const std::string& fileName) const;
+
+	/// <summary>
+	/// デスクリプタヒープの生成（既存のビューは新しいヒープへコピーし、古いヒープはフレームの完了後に解放する）
+	/// </summary>
+	/// <param name="capacity">デスクリプタ数</param>
+	void CreateDescriptorHeaps(size_t capacity);
+
+	/// <summary>
+	/// 空いているデスクリプタ番号の確保（無ければヒープを大きくする）
+	/// </summary>
+	uint32_t AllocateIndex();
+
+	/// <summary>
+	/// ハンドルからデスクリプタ番号を得る
+	/// </summary>
+	/// <param name="textureHandle">テクスチャハンドル</param>
+	/// <returns>デスクリプタ番号（古いか範囲外のハンドルなら UINT32_MAX）</returns>
+	uint32_t ToIndex(uint32_t textureHandle) const;
+
+	/// <summary>
+	/// デスクリプタ番号からハンドルを作る
+	/// </summary>
+	uint32_t ToHandle(uint32_t index) const {
+		return (textures_[index].generation << kHandleIndexBits) | index;
+	}
 };
@@ -0,0 +1,127 @@
+#include "TextureResidency.h"
+#include <algorithm>
+
+void TextureResidency::Register(uint32_t id, uint64_t residentSize, uint64_t fallbackSize) {
+	if (entries_.size() <= id) {
+		entries_.resize(size_t(id) + 1);
+	}
+	Unregister(id);
+
+	Entry& entry = entries_[id];
+	entry.state = State::kResident;
+	entry.residentSize = residentSize;
+	entry.fallbackSize = fallbackSize;
+	entry.lastUsedFrame = frame_;
+	entry.isRequested = false;
+	if (entry.IsEvictable()) {
+		entry.lruPosition = lru_.insert(lru_.end(), id);
+	}
+	usage_ += residentSize;
+}
+
+void TextureResidency::Unregister(uint32_t id) {
+	if (entries_.size() <= id || entries_[id].state == State::kUnregistered) {
+		return;
+	}
+	Entry& entry = entries_[id];
+	if (entry.state == State::kResident && entry.IsEvictable()) {
+		lru_.erase(entry.lruPosition);
+	}
+	usage_ -= GetCurrentSize(entry);
+	entry.state = State::kUnregistered;
+	entry.isRequested = false;
+}
+
+void TextureResidency::Touch(uint32_t id) {
+	if (entries_.size() <= id) {
+		return;
+	}
+	Entry& entry = entries_[id];
+	switch (entry.state) {
+	case State::kResident:
+		// 同じフレームで何度使っても、並べ替えは最初の1回だけ
+		if (entry.lastUsedFrame != frame_) {
+			entry.lastUsedFrame = frame_;
+			if (entry.IsEvictable()) {
+				lru_.splice(lru_.end(), lru_, entry.lruPosition);
+			}
+		}
+		break;
+	case State::kEvicted:
+		entry.lastUsedFrame = frame_;
+		if (!entry.isRequested) {
+			entry.isRequested = true;
+			requests_.push_back(id);
+		}
+		break;
+	case State::kStreaming:
+		entry.lastUsedFrame = frame_;
+		break;
+	default:
+		break;
+	}
+}
+
+void TextureResidency::OnStreamed(uint32_t id, bool isSucceeded) {
+	if (entries_.size() <= id || entries_[id].state != State::kStreaming) {
+		return;
+	}
+	Entry& entry = entries_[id];
+	if (isSucceeded) {
+		// 読み込み直した直後に追い出さないよう、今のフレームで使ったものとして扱う
+		entry.state = State::kResident;
+		entry.lastUsedFrame = frame_;
+		entry.lruPosition = lru_.insert(lru_.end(), id);
+	} else {
+		entry.state = State::kEvicted;
+		usage_ -= entry.residentSize - entry.fallbackSize;
+	}
+}
+
+TextureResidency::Decisions TextureResidency::Update(uint64_t frame) {
+	frame_ = frame;
+	Decisions decisions;
+
+	// 使われた追い出し済みのテクスチャは、空きを作ってから読み込み直す
+	for (uint32_t id : requests_) {
+		Entry& entry = entries_[id];
+		if (entry.state != State::kEvicted || !entry.isRequested) {
+			continue;
+		}
+		entry.isRequested = false;
+		const uint64_t growth = entry.residentSize - entry.fallbackSize;
+		while (budget_ - (std::min)(budget_, usage_) < growth && EvictOldest(decisions)) {
+		}
+		if (budget_ - (std::min)(budget_, usage_) < growth) {
+			// 最近使ったものばかりで空きが作れなければ代替のまま使い、次に使われたときにやり直す
+			deferredRestreamCount_++;
+			continue;
+		}
+		entry.state = State::kStreaming;
+		usage_ += growth;
+		decisions.restreams.push_back(id);
+	}
+	requests_.clear();
+
+	// 新しく読み込んだ分や予算の変更で超えていれば、さらに追い出す
+	while (budget_ < usage_ && EvictOldest(decisions)) {
+	}
+	return decisions;
+}
+
+bool TextureResidency::EvictOldest(Decisions& decisions) {
+	if (lru_.empty()) {
+		return false;
+	}
+	// 先頭ほど古いので、先頭がまだ使われているかもしれなければ他も追い出せない
+	const uint32_t id = lru_.front();
+	Entry& entry = entries_[id];
+	if (frame_ < entry.lastUsedFrame + evictionDelay_) {
+		return false;
+	}
+	lru_.pop_front();
+	entry.state = State::kEvicted;
+	usage_ -= entry.residentSize - entry.fallbackSize;
+	decisions.evictions.push_back(id);
+	return true;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+/// <summary>
+/// テクスチャの常駐管理（メモリ予算と LRU による追い出しの判断）
+/// 使ったテクスチャを Touch で最近使った順の末尾へ移し、予算を超えたら先頭（最も使っていないもの）から
+/// 低解像度の代替へ差し替えるよう指示する。追い出したテクスチャが使われたら読み込み直しを指示する。
+/// 判断だけを行いGPUのリソースは持たないので、デバイス無しでアクセスの記録を再生して確かめられる
+/// </summary>
+class TextureResidency {
+public:
+	// 予算の既定値（制限なし）
+	static const uint64_t kUnlimitedBudget = UINT64_MAX;
+
+	/// <summary>
+	/// テクスチャの状態
+	/// </summary>
+	enum class State {
+		kUnregistered, // 管理していない
+		kResident,     // 全ミップが常駐している
+		kEvicted,      // 代替の低解像度だけ常駐している
+		kStreaming,    // 読み込み直し中（代替を使いながら、全ミップ分の予算を確保している）
+	};
+
+	/// <summary>
+	/// Update の判断結果
+	/// </summary>
+	struct Decisions {
+		std::vector<uint32_t> evictions; // 代替へ差し替えるテクスチャ
+		std::vector<uint32_t> restreams; // 読み込み直すテクスチャ
+	};
+
+	/// <summary>
+	/// メモリ予算の設定（次の Update から効く）
+	/// </summary>
+	/// <param name="budget">バイト数</param>
+	void SetBudget(uint64_t budget) { budget_ = budget; }
+
+	uint64_t GetBudget() const { return budget_; }
+
+	/// <summary>
+	/// 最後に使ってから追い出せるようになるまでのフレーム数の設定
+	/// 描画中のフレームが参照しているテクスチャを追い出さないよう、GPUが遅れうるフレーム数以上にする
+	/// </summary>
+	/// <param name="frameCount">フレーム数（1なら前のフレームまでに使ったものを追い出せる）</param>
+	void SetEvictionDelay(uint32_t frameCount) { evictionDelay_ = frameCount; }
+
+	/// <summary>
+	/// 常駐したテクスチャの登録（今のフレームで使ったものとして扱う）
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <param name="residentSize">全ミップのバイト数</param>
+	/// <param name="fallbackSize">代替のバイト数（residentSize 以上なら追い出さない）</param>
+	void Register(uint32_t id, uint64_t residentSize, uint64_t fallbackSize);
+
+	/// <summary>
+	/// 登録解除
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	void Unregister(uint32_t id);
+
+	/// <summary>
+	/// 今のフレームで使ったことを記録する（追い出し済みなら読み込み直しを要求する）
+	/// </summary>
+	/// <param name="id">テクスチャの番号（登録していなければ何もしない）</param>
+	void Touch(uint32_t id);
+
+	/// <summary>
+	/// 読み込み直しの完了
+	/// </summary>
+	/// <param name="id">テクスチャの番号</param>
+	/// <param name="isSucceeded">全ミップが常駐したか（失敗なら代替のまま）</param>
+	void OnStreamed(uint32_t id, bool isSucceeded);
+
+	/// <summary>
+	/// フレームの開始
+	/// 読み込み直しの要求を、予算に入るよう古いテクスチャを追い出しながら受け付け、
+	/// それでも予算を超えていれば追い出しを続ける
+	/// </summary>
+	/// <param name="frame">今のフレーム番号（増えていくこと）</param>
+	/// <returns>判断結果（結果の通りに差し替えと読み込みを行うこと）</returns>
+	Decisions Update(uint64_t frame);
+
+	/// <summary>
+	/// 状態
+	/// </summary>
+	State GetState(uint32_t id) const {
+		return id < entries_.size() ? entries_[id].state : State::kUnregistered;
+	}
+
+	/// <summary>
+	/// 予算に数えているバイト数（読み込み直し中は全ミップ分）
+	/// </summary>
+	uint64_t GetUsage() const { return usage_; }
+
+	/// <summary>
+	/// 追い出せるものを追い出しても空きが足りず、読み込み直しを見送った回数の累計
+	/// </summary>
+	size_t GetDeferredRestreamCount() const { return deferredRestreamCount_; }
+
+private:
+	// テクスチャごとの記録
+	struct Entry {
+		State state = State::kUnregistered;
+		uint64_t residentSize = 0;
+		uint64_t fallbackSize = 0;
+		uint64_t lastUsedFrame = 0;
+		// 読み込み直しを要求済みか
+		bool isRequested = false;
+		// lru_ 内の位置（追い出せるテクスチャが常駐しているときだけ有効）
+		std::list<uint32_t>::iterator lruPosition;
+
+		/// <summary>
+		/// 代替へ差し替えるとメモリが減るか
+		/// </summary>
+		bool IsEvictable() const { return fallbackSize < residentSize; }
+	};
+
+	/// <summary>
+	/// 今のサイズ（予算に数えている分）
+	/// </summary>
+	uint64_t GetCurrentSize(const Entry& entry) const {
+		return entry.state == State::kEvicted ? entry.fallbackSize : entry.residentSize;
+	}
+
+	/// <summary>
+	/// 最も使っていない追い出せるテクスチャを1つ追い出す
+	/// </summary>
+	/// <param name="decisions">追い出しの追加先</param>
+	/// <returns>追い出せたか</returns>
+	bool EvictOldest(Decisions& decisions);
+
+	// テクスチャごとの記録（番号順）
+	std::vector<Entry> entries_;
+	// 常駐している追い出せるテクスチャ（最近使った順の逆。先頭が最も使っていない）
+	std::list<uint32_t> lru_;
+	// 読み込み直しの要求（Touch した順）
+	std::vector<uint32_t> requests_;
+	// メモリ予算
+	uint64_t budget_ = kUnlimitedBudget;
+	// 予算に数えているバイト数
+	uint64_t usage_ = 0;
+	// 今のフレーム番号
+	uint64_t frame_ = 0;
+	// 最後に使ってから追い出せるようになるまでのフレーム数
+	uint32_t evictionDelay_ = 1;
+	// 読み込み直しを見送った回数
+	size_t deferredRestreamCount_ = 0;
+};
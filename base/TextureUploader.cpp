@@ -0,0 +1,202 @@
+#include "TextureUploader.h"
+#include <cassert>
+#include <cstring>
+#include <d3dx12.h>
+#include <vector>
+
+using namespace Microsoft::WRL;
+
+namespace {
+
+// アップロードヒープにバッファを作ってマップする
+ComPtr<ID3D12Resource> CreateUploadBuffer(ID3D12Device* device, size_t size, uint8_t** mapped) {
+	HRESULT result;
+
+	// ヒーププロパティ
+	CD3DX12_HEAP_PROPERTIES heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	// リソース設定
+	CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+
+	ComPtr<ID3D12Resource> buffer;
+	result = device->CreateCommittedResource(
+	    &heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
+	    IID_PPV_ARGS(&buffer));
+	assert(SUCCEEDED(result));
+
+	result = buffer->Map(0, nullptr, reinterpret_cast<void**>(mapped));
+	assert(SUCCEEDED(result));
+	return buffer;
+}
+
+} // namespace
+
+void TextureUploader::Initialize(ID3D12Device* device, size_t ringSize) {
+	assert(device);
+	device_ = device;
+	HRESULT result = S_FALSE;
+
+	// コピーキューを生成
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	result = device_->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&copyQueue_));
+	assert(SUCCEEDED(result));
+
+	// コマンドリストを生成（記録を始めるまで閉じておく）
+	result = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator_));
+	assert(SUCCEEDED(result));
+	result = device_->CreateCommandList(
+	    0, D3D12_COMMAND_LIST_TYPE_COPY, allocator_.Get(), nullptr, IID_PPV_ARGS(&commandList_));
+	assert(SUCCEEDED(result));
+	commandList_->Close();
+
+	// フェンスを生成
+	result = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+	assert(SUCCEEDED(result));
+
+	// アップロードバッファを生成して、マップしたままにする
+	ringBuffer_ = CreateUploadBuffer(device_, ringSize, &ringMapped_);
+	ring_.Reset(ringSize);
+}
+
+void TextureUploader::Upload(ID3D12Resource* texture, const TextureData& data) {
+	assert(texture && !data.mips.empty());
+	D3D12_RESOURCE_DESC desc = texture->GetDesc();
+	const UINT mipCount = data.GetMipCount();
+	assert(desc.MipLevels == mipCount);
+
+	// 転送元のバッファ上の配置
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(mipCount);
+	std::vector<UINT> rowCounts(mipCount);
+	std::vector<UINT64> rowSizes(mipCount);
+	UINT64 totalSize = 0;
+	device_->GetCopyableFootprints(
+	    &desc, 0, mipCount, 0, footprints.data(), rowCounts.data(), rowSizes.data(), &totalSize);
+
+	// 転送元の確保（リングより大きければ一時バッファを作る）
+	ID3D12Resource* source = ringBuffer_.Get();
+	uint8_t* mapped = nullptr;
+	size_t baseOffset = AllocateRing(size_t(totalSize));
+	if (baseOffset != UploadRing::kInvalidOffset) {
+		mapped = ringMapped_ + baseOffset;
+	} else {
+		ComPtr<ID3D12Resource> buffer = CreateUploadBuffer(device_, size_t(totalSize), &mapped);
+		source = buffer.Get();
+		baseOffset = 0;
+		inFlightResources_.push_back({buffer, fenceValue_ + 1});
+	}
+
+	BeginRecording();
+	for (UINT i = 0; i < mipCount; i++) {
+		// 行ごとのピッチを合わせて書き込む
+		const TextureMip& mip = data.mips[i];
+		const uint8_t* src = data.GetMipPixels(i);
+		uint8_t* dst = mapped + footprints[i].Offset;
+		for (UINT row = 0; row < rowCounts[i]; row++) {
+			std::memcpy(
+			    dst + size_t(row) * footprints[i].Footprint.RowPitch,
+			    src + size_t(row) * mip.rowPitch, size_t(rowSizes[i]));
+		}
+
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = footprints[i];
+		footprint.Offset += baseOffset;
+		CD3DX12_TEXTURE_COPY_LOCATION dstLocation(texture, i);
+		CD3DX12_TEXTURE_COPY_LOCATION srcLocation(source, footprint);
+		commandList_->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+	}
+
+	// 転送が終わるまで転送先を残す
+	inFlightResources_.push_back({texture, fenceValue_ + 1});
+}
+
+uint64_t TextureUploader::Submit(ID3D12CommandQueue* waitingQueue) {
+	if (isRecording_) {
+		Execute();
+		// 描画キューはGPU上で転送の完了を待つ
+		if (waitingQueue) {
+			waitingQueue->Wait(fence_.Get(), fenceValue_);
+		}
+	}
+	Reclaim();
+	return fenceValue_;
+}
+
+void TextureUploader::WaitIdle() {
+	Execute();
+	WaitForFence(fenceValue_);
+	Reclaim();
+}
+
+void TextureUploader::BeginRecording() {
+	if (isRecording_) {
+		return;
+	}
+	Reclaim();
+
+	// 完了したアロケータを使い回し、無ければ作る
+	HRESULT result = S_FALSE;
+	if (!submittedAllocators_.empty() &&
+	    submittedAllocators_.front().fenceValue <= fence_->GetCompletedValue()) {
+		allocator_ = submittedAllocators_.front().allocator;
+		submittedAllocators_.pop_front();
+		result = allocator_->Reset();
+		assert(SUCCEEDED(result));
+	} else if (!allocator_) {
+		result = device_->CreateCommandAllocator(
+		    D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator_));
+		assert(SUCCEEDED(result));
+	}
+	result = commandList_->Reset(allocator_.Get(), nullptr);
+	assert(SUCCEEDED(result));
+	isRecording_ = true;
+}
+
+void TextureUploader::Execute() {
+	if (!isRecording_) {
+		return;
+	}
+	HRESULT result = commandList_->Close();
+	assert(SUCCEEDED(result));
+
+	// コマンドリストの実行
+	ID3D12CommandList* cmdLists[] = {commandList_.Get()};
+	copyQueue_->ExecuteCommandLists(1, cmdLists);
+	copyQueue_->Signal(fence_.Get(), ++fenceValue_);
+
+	// 記録に使った領域とアロケータは、このフェンス値に達するまで使わない
+	ring_.Close(fenceValue_);
+	submittedAllocators_.push_back({allocator_, fenceValue_});
+	allocator_.Reset();
+	isRecording_ = false;
+}
+
+void TextureUploader::Reclaim() {
+	const uint64_t completed = fence_->GetCompletedValue();
+	ring_.Reclaim(completed);
+	while (!inFlightResources_.empty() && inFlightResources_.front().fenceValue <= completed) {
+		inFlightResources_.pop_front();
+	}
+}
+
+void TextureUploader::WaitForFence(uint64_t fenceValue) {
+	if (fence_->GetCompletedValue() < fenceValue) {
+		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
+		fence_->SetEventOnCompletion(fenceValue, event);
+		WaitForSingleObject(event, INFINITE);
+		CloseHandle(event);
+	}
+}
+
+size_t TextureUploader::AllocateRing(size_t size) {
+	if (ring_.GetCapacity() < size) {
+		return UploadRing::kInvalidOffset;
+	}
+	size_t offset = ring_.Allocate(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	while (offset == UploadRing::kInvalidOffset) {
+		// 空きが足りなければ、記録中の転送を実行して古い転送の完了を待つ
+		Execute();
+		WaitForFence(ring_.GetOldestFenceValue());
+		Reclaim();
+		offset = ring_.Allocate(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	}
+	return offset;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "TextureData.h"
+#include "UploadRing.h"
+#include <cstdint>
+#include <d3d12.h>
+#include <deque>
+#include <wrl.h>
+
+/// <summary>
+/// コピーキューによるテクスチャ転送
+/// 常にマップしたアップロードバッファを UploadRing で切り分けて画像を書き込み、
+/// デフォルトヒープのテクスチャへコピーする。リングより大きい画像は一時バッファを作って転送する
+/// </summary>
+class TextureUploader {
+public:
+	// リングバッファの既定のバイト数
+	static const size_t kDefaultRingSize = 64 * 1024 * 1024;
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="device">デバイス</param>
+	/// <param name="ringSize">リングバッファのバイト数</param>
+	void Initialize(ID3D12Device* device, size_t ringSize = kDefaultRingSize);
+
+	/// <summary>
+	/// 転送の記録（Submit まで実行しない）
+	/// </summary>
+	/// <param name="texture">転送先（デフォルトヒープに D3D12_RESOURCE_STATE_COMMON で作ったもの）</param>
+	/// <param name="data">画像（ミップ数と大きさは転送先と同じ）</param>
+	void Upload(ID3D12Resource* texture, const TextureData& data);
+
+	/// <summary>
+	/// 記録した転送を実行し、描画キューに完了を待たせる
+	/// </summary>
+	/// <param name="waitingQueue">転送したテクスチャを使うキュー</param>
+	/// <returns>転送の完了でシグナルされるフェンス値</returns>
+	uint64_t Submit(ID3D12CommandQueue* waitingQueue);
+
+	/// <summary>
+	/// 実行した転送が全て終わるまでCPUで待つ
+	/// </summary>
+	void WaitIdle();
+
+	const UploadRing& GetRing() const { return ring_; }
+
+private:
+	// コマンドアロケータと、それで記録したコマンドの完了を示すフェンス値
+	struct AllocatorEntry {
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+		uint64_t fenceValue;
+	};
+
+	// 転送が終わるまで解放しないリソース
+	struct InFlightResource {
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		uint64_t fenceValue;
+	};
+
+	/// <summary>
+	/// 記録を始める（記録中なら何もしない）
+	/// </summary>
+	void BeginRecording();
+
+	/// <summary>
+	/// 記録したコマンドを実行してフェンスをシグナルする
+	/// </summary>
+	void Execute();
+
+	/// <summary>
+	/// GPUが完了した転送の領域とリソースを解放する
+	/// </summary>
+	void Reclaim();
+
+	/// <summary>
+	/// フェンス値に達するまでCPUで待つ
+	/// </summary>
+	void WaitForFence(uint64_t fenceValue);
+
+	/// <summary>
+	/// リングバッファの確保（空きが足りなければ古い転送の完了を待つ）
+	/// </summary>
+	/// <param name="size">バイト数</param>
+	/// <returns>オフセット（リングより大きければ UploadRing::kInvalidOffset）</returns>
+	size_t AllocateRing(size_t size);
+
+	// デバイス
+	ID3D12Device* device_ = nullptr;
+	// コピーキュー
+	Microsoft::WRL::ComPtr<ID3D12CommandQueue> copyQueue_;
+	// コマンドリスト
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList_;
+	// 記録中のコマンドアロケータ
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator_;
+	// 実行したコマンドのアロケータ（古い順）
+	std::deque<AllocatorEntry> submittedAllocators_;
+	// フェンス
+	Microsoft::WRL::ComPtr<ID3D12Fence> fence_;
+	// 最後にシグナルしたフェンス値
+	uint64_t fenceValue_ = 0;
+	// アップロードバッファ
+	Microsoft::WRL::ComPtr<ID3D12Resource> ringBuffer_;
+	// アップロードバッファの書き込み先
+	uint8_t* ringMapped_ = nullptr;
+	// アップロードバッファの領域管理
+	UploadRing ring_;
+	// 転送中のリソース（古い順）
+	std::deque<InFlightResource> inFlightResources_;
+	// 記録中か
+	bool isRecording_ = false;
+};
@@ -0,0 +1,261 @@
+#include "TgaDecoder.h"
+#include <cstring>
+
+namespace {
+
+// ヘッダのバイト数
+const size_t kHeaderSize = 18;
+
+// 画像の種類
+const uint8_t kTypeColorMapped = 1;
+const uint8_t kTypeTrueColor = 2;
+const uint8_t kTypeGrayscale = 3;
+// RLE 圧縮の種類はこのビットが立つ
+const uint8_t kTypeRleBit = 8;
+
+// 記述子のビット
+const uint8_t kDescriptorAlphaBits = 0x0f;
+const uint8_t kDescriptorRightToLeft = 0x10;
+const uint8_t kDescriptorTopToBottom = 0x20;
+
+// TGA のヘッダ
+struct TgaHeader {
+	uint8_t idLength;
+	uint8_t colorMapType;
+	uint8_t imageType;
+	uint16_t colorMapFirst;
+	uint16_t colorMapLength;
+	uint8_t colorMapEntrySize;
+	uint16_t width;
+	uint16_t height;
+	uint8_t pixelDepth;
+	uint8_t descriptor;
+	size_t colorMapOffset; // カラーマップの先頭
+	size_t dataOffset;     // 画素の先頭
+};
+
+uint16_t ReadU16(const uint8_t* data) { return uint16_t(data[0] | (data[1] << 8)); }
+
+// 1画素のバイト数が扱えるものか
+bool IsColorDepth(uint8_t depth) { return depth == 15 || depth == 16 || depth == 24 || depth == 32; }
+
+bool ParseHeader(const uint8_t* data, size_t size, TgaHeader& header) {
+	if (size < kHeaderSize) {
+		return false;
+	}
+	header.idLength = data[0];
+	header.colorMapType = data[1];
+	header.imageType = data[2];
+	header.colorMapFirst = ReadU16(data + 3);
+	header.colorMapLength = ReadU16(data + 5);
+	header.colorMapEntrySize = data[7];
+	header.width = ReadU16(data + 12);
+	header.height = ReadU16(data + 14);
+	header.pixelDepth = data[16];
+	header.descriptor = data[17];
+
+	// 識別子が無いので、値の組み合わせが正しいかで判定する
+	const uint8_t baseType = header.imageType & ~kTypeRleBit;
+	if (1 < header.colorMapType || header.width == 0 || header.height == 0 ||
+	    (header.descriptor & 0xc0) != 0 || (header.imageType & ~(kTypeRleBit | 3)) != 0) {
+		return false;
+	}
+	if (baseType == kTypeColorMapped) {
+		if (header.colorMapType != 1 || header.pixelDepth != 8 ||
+		    !IsColorDepth(header.colorMapEntrySize) ||
+		    256 < uint32_t(header.colorMapFirst) + header.colorMapLength) {
+			return false;
+		}
+	} else if (baseType == kTypeTrueColor) {
+		if (!IsColorDepth(header.pixelDepth)) {
+			return false;
+		}
+	} else if (baseType == kTypeGrayscale) {
+		if (header.pixelDepth != 8) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	if (header.colorMapType == 1 && !IsColorDepth(header.colorMapEntrySize)) {
+		return false;
+	}
+
+	header.colorMapOffset = kHeaderSize + header.idLength;
+	header.dataOffset = header.colorMapOffset;
+	if (header.colorMapType == 1) {
+		header.dataOffset += size_t(header.colorMapLength) * ((header.colorMapEntrySize + 7) / 8);
+	}
+	return header.dataOffset <= size;
+}
+
+// 画素1つを BGRA8 に変換する
+void ConvertPixel(const uint8_t* source, uint8_t depth, bool hasAlphaBit, uint8_t* out) {
+	switch (depth) {
+	case 8:
+		out[0] = out[1] = out[2] = source[0];
+		out[3] = 0xff;
+		break;
+	case 15:
+	case 16: {
+		// 各5bit を8bit に広げる（上位ビットを下位に繰り返す）
+		const uint32_t value = ReadU16(source);
+		const uint32_t b = value & 0x1f;
+		const uint32_t g = (value >> 5) & 0x1f;
+		const uint32_t r = (value >> 10) & 0x1f;
+		out[0] = uint8_t((b << 3) | (b >> 2));
+		out[1] = uint8_t((g << 3) | (g >> 2));
+		out[2] = uint8_t((r << 3) | (r >> 2));
+		out[3] = (!hasAlphaBit || (value & 0x8000)) ? 0xff : 0;
+		break;
+	}
+	case 24:
+		out[0] = source[0];
+		out[1] = source[1];
+		out[2] = source[2];
+		out[3] = 0xff;
+		break;
+	default:
+		std::memcpy(out, source, 4);
+		break;
+	}
+}
+
+// ファイル内の順に並ぶ画素を書き込み先の位置へ置く
+class PixelWriter {
+public:
+	PixelWriter(const TgaHeader& header, uint8_t* destination, size_t rowPitch)
+	    : destination_(destination), rowPitch_(rowPitch), width_(header.width),
+	      height_(header.height),
+	      isTopToBottom_((header.descriptor & kDescriptorTopToBottom) != 0),
+	      isRightToLeft_((header.descriptor & kDescriptorRightToLeft) != 0) {}
+
+	// 次の画素の書き込み先（全て書き終えていれば nullptr）
+	uint8_t* Next() {
+		if (uint32_t(height_) * width_ <= index_) {
+			return nullptr;
+		}
+		const uint32_t row = index_ / width_;
+		const uint32_t column = index_ % width_;
+		index_++;
+		const uint32_t y = isTopToBottom_ ? row : height_ - 1 - row;
+		const uint32_t x = isRightToLeft_ ? width_ - 1 - column : column;
+		return destination_ + y * rowPitch_ + x * 4;
+	}
+
+	// 書き込み先の1ライン（左から右へ並ぶ場合だけ使える）
+	uint8_t* GetRow(uint32_t row) const {
+		return destination_ + (isTopToBottom_ ? row : height_ - 1 - row) * rowPitch_;
+	}
+
+	bool IsRightToLeft() const { return isRightToLeft_; }
+
+private:
+	uint8_t* destination_;
+	size_t rowPitch_;
+	uint32_t width_;
+	uint32_t height_;
+	bool isTopToBottom_;
+	bool isRightToLeft_;
+	uint32_t index_ = 0;
+};
+
+} // namespace
+
+bool TgaDecoder::CanDecode(const uint8_t* data, size_t size) const {
+	TgaHeader header;
+	return ParseHeader(data, size, header);
+}
+
+bool TgaDecoder::ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const {
+	TgaHeader header;
+	if (!ParseHeader(data, size, header)) {
+		return false;
+	}
+	info.format = TextureFormat::kB8G8R8A8Unorm;
+	info.width = header.width;
+	info.height = header.height;
+	return true;
+}
+
+bool TgaDecoder::DecodeInto(
+    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const {
+	TgaHeader header;
+	if (!ParseHeader(data, size, header) || rowPitch < size_t(header.width) * 4) {
+		return false;
+	}
+	const bool hasAlphaBit = (header.descriptor & kDescriptorAlphaBits) != 0;
+	const bool isColorMapped = (header.imageType & ~kTypeRleBit) == kTypeColorMapped;
+
+	// カラーマップは先に BGRA8 へ変換しておく
+	uint8_t palette[256][4] = {};
+	if (isColorMapped) {
+		const size_t entrySize = (header.colorMapEntrySize + 7) / 8;
+		for (uint32_t i = 0; i < header.colorMapLength; i++) {
+			ConvertPixel(
+			    data + header.colorMapOffset + i * entrySize, header.colorMapEntrySize, hasAlphaBit,
+			    palette[header.colorMapFirst + i]);
+		}
+	}
+	const uint8_t depth = header.pixelDepth;
+	const size_t bytesPerPixel = (depth + 7) / 8;
+	auto convert = [&](const uint8_t* source, uint8_t* out) {
+		if (isColorMapped) {
+			std::memcpy(out, palette[source[0]], 4);
+		} else {
+			ConvertPixel(source, depth, hasAlphaBit, out);
+		}
+	};
+
+	PixelWriter writer(header, destination, rowPitch);
+	const uint8_t* source = data + header.dataOffset;
+	const uint8_t* end = data + size;
+	const size_t pixelCount = size_t(header.width) * header.height;
+
+	if (!(header.imageType & kTypeRleBit)) {
+		if (size_t(end - source) / bytesPerPixel < pixelCount) {
+			return false;
+		}
+		const size_t sourceRowSize = header.width * bytesPerPixel;
+		for (uint32_t row = 0; row < header.height; row++, source += sourceRowSize) {
+			// 32bit で左から右へ並ぶ場合はそのまま写せる
+			if (depth == 32 && !writer.IsRightToLeft()) {
+				std::memcpy(writer.GetRow(row), source, sourceRowSize);
+				continue;
+			}
+			for (uint32_t x = 0; x < header.width; x++) {
+				convert(source + x * bytesPerPixel, writer.Next());
+			}
+		}
+		return true;
+	}
+
+	// RLE はパケットが行をまたぐことがあるので画素単位で置く
+	size_t written = 0;
+	while (written < pixelCount) {
+		if (source == end) {
+			return false;
+		}
+		const uint8_t packet = *source++;
+		const size_t count = (packet & 0x7f) + 1u;
+		const bool isRepeat = (packet & 0x80) != 0;
+		const size_t sourceSize = isRepeat ? bytesPerPixel : bytesPerPixel * count;
+		if (pixelCount - written < count || size_t(end - source) < sourceSize) {
+			return false;
+		}
+		if (isRepeat) {
+			uint8_t pixel[4];
+			convert(source, pixel);
+			for (size_t i = 0; i < count; i++) {
+				std::memcpy(writer.Next(), pixel, 4);
+			}
+		} else {
+			for (size_t i = 0; i < count; i++) {
+				convert(source + i * bytesPerPixel, writer.Next());
+			}
+		}
+		source += sourceSize;
+		written += count;
+	}
+	return true;
+}
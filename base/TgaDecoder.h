@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ImageDecoder.h"
+
+/// <summary>
+/// TGA のデコーダ
+/// カラーマップ・トゥルーカラー・グレースケール（それぞれ RLE 圧縮あり）の 8/15/16/24/32bit に対応し、
+/// ファイルの並びに近い BGRA8 へ展開する
+/// </summary>
+class TgaDecoder : public ImageDecoder {
+public:
+	const char* GetName() const override { return "TGA"; }
+	bool CanDecode(const uint8_t* data, size_t size) const override;
+	bool ReadInfo(const uint8_t* data, size_t size, ImageInfo& info) const override;
+	bool DecodeInto(
+	    const uint8_t* data, size_t size, uint8_t* destination, size_t rowPitch) const override;
+};
@@ -0,0 +1,100 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool* ThreadPool::GetInstance() {
+	static ThreadPool instance;
+	return &instance;
+}
+
+ThreadPool::ThreadPool() {
+	// メインスレッドの分を1つ減らす
+	size_t workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+	workerCount = std::max<size_t>(workerCount, 1);
+	workers_.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; i++) {
+		workers_.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isTerminated_ = true;
+	}
+	condition_.notify_all();
+	for (std::thread& worker : workers_) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks_.push(std::move(task));
+	}
+	condition_.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grainSize, const RangeFunction& function) {
+	if (count == 0) {
+		return;
+	}
+	grainSize = std::max<size_t>(grainSize, 1);
+	const size_t chunkCount = (count + grainSize - 1) / grainSize;
+	// 1チャンクしかないなら分割しない
+	if (chunkCount == 1) {
+		function(0, count);
+		return;
+	}
+
+	// 先に終わった側が破棄しないよう共有状態にしておく
+	struct Job {
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> finished{0};
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	auto job = std::make_shared<Job>();
+
+	// チャンクを取り出せる限り処理する
+	auto run = [job, chunkCount, count, grainSize, &function]() {
+		size_t processed = 0;
+		for (size_t chunk = job->next++; chunk < chunkCount; chunk = job->next++) {
+			size_t begin = chunk * grainSize;
+			function(begin, std::min(begin + grainSize, count));
+			processed++;
+		}
+		if (processed != 0 && job->finished.fetch_add(processed) + processed == chunkCount) {
+			std::lock_guard<std::mutex> lock(job->mutex);
+			job->condition.notify_all();
+		}
+	};
+
+	size_t helperCount = std::min(workers_.size(), chunkCount - 1);
+	for (size_t i = 0; i < helperCount; i++) {
+		Enqueue(run);
+	}
+	run();
+
+	// 他スレッドが処理中のチャンクの完了を待つ
+	std::unique_lock<std::mutex> lock(job->mutex);
+	job->condition.wait(lock, [&job, chunkCount]() { return job->finished == chunkCount; });
+}
+
+void ThreadPool::WorkerMain() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return isTerminated_ || !tasks_.empty(); });
+			if (isTerminated_ && tasks_.empty()) {
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop();
+		}
+		task();
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// ワーカースレッドプール
+/// </summary>
+class ThreadPool {
+public:
+	// 範囲処理関数 [begin, end)
+	using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static ThreadPool* GetInstance();
+
+	/// <summary>
+	/// タスクの追加（完了を待たない）
+	/// </summary>
+	/// <param name="task">タスク</param>
+	void Enqueue(std::function<void()> task);
+
+	/// <summary>
+	/// 範囲を分割して並列実行し、全て終わるまで待つ
+	/// 呼び出し元スレッドも処理に参加するので、ワーカー内から呼んでもデッドロックしない
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="grainSize">1タスクあたりの最小要素数</param>
+	/// <param name="function">範囲処理関数</param>
+	void ParallelFor(size_t count, size_t grainSize, const RangeFunction& function);
+
+	/// <summary>
+	/// ワーカースレッド数の取得
+	/// </summary>
+	/// <returns>ワーカースレッド数</returns>
+	size_t GetWorkerCount() const { return workers_.size(); }
+
+private:
+	ThreadPool();
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// <summary>
+	/// ワーカースレッドのメインループ
+	/// </summary>
+	void WorkerMain();
+
+	// ワーカースレッド
+	std::vector<std::thread> workers_;
+	// タスクキュー
+	std::queue<std::function<void()>> tasks_;
+	// キュー保護用
+	std::mutex mutex_;
+	// タスク追加通知
+	std::condition_variable condition_;
+	// 終了フラグ
+	bool isTerminated_ = false;
+};
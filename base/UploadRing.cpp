@@ -0,0 +1,61 @@
+#include "UploadRing.h"
+#include <cassert>
+
+void UploadRing::Reset(size_t capacity) {
+	capacity_ = capacity;
+	head_ = 0;
+	tail_ = 0;
+	usedSize_ = 0;
+	openSize_ = 0;
+	regions_.clear();
+}
+
+size_t UploadRing::Allocate(size_t size, size_t alignment) {
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	if (size == 0 || capacity_ < size || usedSize_ == capacity_) {
+		return kInvalidOffset;
+	}
+	// 全て空いていれば先頭から使う
+	if (usedSize_ == 0) {
+		head_ = 0;
+		tail_ = 0;
+	}
+
+	size_t offset = (head_ + alignment - 1) & ~(alignment - 1);
+	size_t padding = offset - head_;
+	if (tail_ <= head_) {
+		// 使用中の領域より後ろ。末尾に入らなければ先頭へ折り返す
+		if (capacity_ < offset || capacity_ - offset < size) {
+			if (tail_ < size) {
+				return kInvalidOffset;
+			}
+			offset = 0;
+			padding = capacity_ - head_;
+		}
+	} else if (tail_ < offset || tail_ - offset < size) {
+		// 折り返した後は使用中の領域の手前まで
+		return kInvalidOffset;
+	}
+
+	head_ = offset + size;
+	usedSize_ += padding + size;
+	openSize_ += padding + size;
+	return offset;
+}
+
+void UploadRing::Close(uint64_t fenceValue) {
+	if (openSize_ == 0) {
+		return;
+	}
+	assert(regions_.empty() || regions_.back().fenceValue <= fenceValue);
+	regions_.push_back({fenceValue, head_, openSize_});
+	openSize_ = 0;
+}
+
+void UploadRing::Reclaim(uint64_t completedFenceValue) {
+	while (!regions_.empty() && regions_.front().fenceValue <= completedFenceValue) {
+		tail_ = regions_.front().end;
+		usedSize_ -= regions_.front().size;
+		regions_.pop_front();
+	}
+}
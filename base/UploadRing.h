@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+/// <summary>
+/// アップロード用リングバッファの領域管理
+/// 確保した領域は Close で渡したフェンス値に結び付け、Reclaim でGPUが完了した分から先頭を空ける。
+/// オフセットを配るだけでGPUのバッファは持たないので、デバイス無しで動作を確認できる
+/// </summary>
+class UploadRing {
+public:
+	// 確保できなかったときのオフセット
+	static const size_t kInvalidOffset = SIZE_MAX;
+
+	UploadRing() = default;
+
+	/// <summary>
+	/// 生成
+	/// </summary>
+	/// <param name="capacity">バッファのバイト数</param>
+	explicit UploadRing(size_t capacity) { Reset(capacity); }
+
+	/// <summary>
+	/// 全領域を空にして大きさを設定する
+	/// </summary>
+	/// <param name="capacity">バッファのバイト数</param>
+	void Reset(size_t capacity);
+
+	/// <summary>
+	/// 領域の確保（末尾に入らなければ先頭へ折り返す）
+	/// </summary>
+	/// <param name="size">バイト数</param>
+	/// <param name="alignment">オフセットの境界（2のべき乗）</param>
+	/// <returns>オフセット（空きが足りなければ kInvalidOffset）</returns>
+	size_t Allocate(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 前回の Close 以降に確保した領域を、フェンス値まで使用中にする
+	/// </summary>
+	/// <param name="fenceValue">領域を使うコマンドの完了時にシグナルされるフェンス値</param>
+	void Close(uint64_t fenceValue);
+
+	/// <summary>
+	/// GPUが完了した領域を空ける
+	/// </summary>
+	/// <param name="completedFenceValue">完了済みのフェンス値</param>
+	void Reclaim(uint64_t completedFenceValue);
+
+	/// <summary>
+	/// 空ければ確保できるようになる最も古いフェンス値（使用中の領域が無ければ0）
+	/// </summary>
+	uint64_t GetOldestFenceValue() const {
+		return regions_.empty() ? 0 : regions_.front().fenceValue;
+	}
+
+	size_t GetCapacity() const { return capacity_; }
+
+	/// <summary>
+	/// 使用中のバイト数（折り返しで使えなくなった末尾を含む）
+	/// </summary>
+	size_t GetUsedSize() const { return usedSize_; }
+
+	/// <summary>
+	/// Close していない領域があるか
+	/// </summary>
+	bool HasOpenAllocations() const { return openSize_ != 0; }
+
+private:
+	// Close でまとめた使用中の領域
+	struct Region {
+		uint64_t fenceValue; // 完了を待つフェンス値
+		size_t end;          // 領域の終わり（空けると先頭がここまで進む）
+		size_t size;         // 折り返しで使えなくなった分を含むバイト数
+	};
+
+	// バッファのバイト数
+	size_t capacity_ = 0;
+	// 次に確保する位置
+	size_t head_ = 0;
+	// 使用中の領域の先頭
+	size_t tail_ = 0;
+	// 使用中のバイト数
+	size_t usedSize_ = 0;
+	// Close していないバイト数
+	size_t openSize_ = 0;
+	// 使用中の領域（古い順）
+	std::deque<Region> regions_;
+};
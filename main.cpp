@@ -68,6 +68,8 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 			break;
 		}
 
+		// 読み込み終わったテクスチャの転送
+		TextureManager::GetInstance()->Update();
 		// ImGui受付開始
 		imguiManager->Begin();
 		// 入力関連の毎フレーム処理
@@ -93,6 +95,9 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		dxCommon->PostDraw();
 	}
 
+	// 描画中のフレームが使っているリソースを解放しないよう、GPUの完了を待つ
+	dxCommon->WaitForGpu();
+
 	// 各種解放
 	SafeDelete(gameScene);
 	audio->Finalize();
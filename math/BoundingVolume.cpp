@@ -0,0 +1,70 @@
+#include "BoundingVolume.h"
+#include "MathUtility.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// ストライド付き座標の読み出し
+inline const Vector3& PositionAt(const void* positions, size_t index, size_t stride) {
+	return *reinterpret_cast<const Vector3*>(
+	    static_cast<const uint8_t*>(positions) + index * stride);
+}
+
+} // namespace
+
+AABB ComputeAABB(const void* positions, size_t count, size_t stride) {
+	if (count == 0) {
+		return AABB{};
+	}
+	AABB result = {PositionAt(positions, 0, stride), PositionAt(positions, 0, stride)};
+	for (size_t i = 1; i < count; i++) {
+		const Vector3& p = PositionAt(positions, i, stride);
+		result.min = {
+		    std::min(result.min.x, p.x), std::min(result.min.y, p.y), std::min(result.min.z, p.z)};
+		result.max = {
+		    std::max(result.max.x, p.x), std::max(result.max.y, p.y), std::max(result.max.z, p.z)};
+	}
+	return result;
+}
+
+Sphere ComputeBoundingSphere(const void* positions, size_t count, size_t stride) {
+	AABB aabb = ComputeAABB(positions, count, stride);
+	Vector3 center = (aabb.min + aabb.max) * 0.5f;
+	float radiusSq = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		Vector3 d = PositionAt(positions, i, stride) - center;
+		radiusSq = std::max(radiusSq, Dot(d, d));
+	}
+	return {center, std::sqrt(radiusSq)};
+}
+
+AABB Merge(const AABB& a, const AABB& b) {
+	return {
+	    {std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)},
+	    {std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)}
+    };
+}
+
+AABB TransformAABB(const AABB& aabb, const Matrix4x4& m) {
+	// 中心は普通に変換し、半径は行列要素の絶対値で広げる
+	Vector3 center = TransformPoint((aabb.min + aabb.max) * 0.5f, m);
+	Vector3 extent = (aabb.max - aabb.min) * 0.5f;
+	Vector3 newExtent = {
+	    std::abs(m.m[0][0]) * extent.x + std::abs(m.m[1][0]) * extent.y +
+	        std::abs(m.m[2][0]) * extent.z,
+	    std::abs(m.m[0][1]) * extent.x + std::abs(m.m[1][1]) * extent.y +
+	        std::abs(m.m[2][1]) * extent.z,
+	    std::abs(m.m[0][2]) * extent.x + std::abs(m.m[1][2]) * extent.y +
+	        std::abs(m.m[2][2]) * extent.z};
+	return {center - newExtent, center + newExtent};
+}
+
+Sphere TransformSphere(const Sphere& sphere, const Matrix4x4& m) {
+	float scaleSq = std::max(
+	    {Dot({m.m[0][0], m.m[0][1], m.m[0][2]}, {m.m[0][0], m.m[0][1], m.m[0][2]}),
+	     Dot({m.m[1][0], m.m[1][1], m.m[1][2]}, {m.m[1][0], m.m[1][1], m.m[1][2]}),
+	     Dot({m.m[2][0], m.m[2][1], m.m[2][2]}, {m.m[2][0], m.m[2][1], m.m[2][2]})});
+	return {TransformPoint(sphere.center, m), sphere.radius * std::sqrt(scaleSq)};
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include <cstddef>
+
+/// <summary>
+/// 軸平行境界ボックス
+/// </summary>
+struct AABB {
+	Vector3 min; // 最小点
+	Vector3 max; // 最大点
+};
+
+/// <summary>
+/// 境界球
+/// </summary>
+struct Sphere {
+	Vector3 center; // 中心
+	float radius;   // 半径
+};
+
+/// <summary>
+/// 座標列を囲むAABBを求める
+/// </summary>
+/// <param name="positions">先頭要素の座標へのポインタ</param>
+/// <param name="count">要素数</param>
+/// <param name="stride">要素間のバイト数（頂点構造体の先頭が座標ならsizeof(頂点)）</param>
+/// <returns>AABB（要素数0なら中心0大きさ0）</returns>
+AABB ComputeAABB(const void* positions, size_t count, size_t stride = sizeof(Vector3));
+
+/// <summary>
+/// 座標列を囲む境界球を求める（AABB中心から最も遠い点まで）
+/// </summary>
+/// <param name="positions">先頭要素の座標へのポインタ</param>
+/// <param name="count">要素数</param>
+/// <param name="stride">要素間のバイト数</param>
+/// <returns>境界球</returns>
+Sphere ComputeBoundingSphere(const void* positions, size_t count, size_t stride = sizeof(Vector3));
+
+/// <summary>
+/// 2つのAABBを囲むAABB
+/// </summary>
+AABB Merge(const AABB& a, const AABB& b);
+
+/// <summary>
+/// AABBを変換して、変換後の形を囲むAABBを求める
+/// </summary>
+/// <param name="aabb">AABB</param>
+/// <param name="m">アフィン変換行列</param>
+/// <returns>変換後のAABB</returns>
+AABB TransformAABB(const AABB& aabb, const Matrix4x4& m);
+
+/// <summary>
+/// 境界球を変換する（半径は最大スケールで拡大）
+/// </summary>
+/// <param name="sphere">境界球</param>
+/// <param name="m">アフィン変換行列</param>
+/// <returns>変換後の境界球</returns>
+Sphere TransformSphere(const Sphere& sphere, const Matrix4x4& m);
@@ -0,0 +1,550 @@
+#include "MathUtility.h"
+#include "SimdConfig.h"
+#include <cmath>
+
+namespace {
+
+#if MATH_SIMD_SSE
+// 行列の行をレジスタに読み込む
+inline __m128 LoadRow(const Matrix4x4& m, int row) { return _mm_loadu_ps(m.m[row]); }
+
+// 要素のブロードキャスト
+#define MATH_SPLAT(v, i) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(i, i, i, i))
+
+// v * M (行ベクトル×行列)
+inline __m128 MultiplyRow(__m128 v, __m128 r0, __m128 r1, __m128 r2, __m128 r3) {
+	__m128 result = _mm_mul_ps(MATH_SPLAT(v, 0), r0);
+	result = _mm_add_ps(result, _mm_mul_ps(MATH_SPLAT(v, 1), r1));
+	result = _mm_add_ps(result, _mm_mul_ps(MATH_SPLAT(v, 2), r2));
+	result = _mm_add_ps(result, _mm_mul_ps(MATH_SPLAT(v, 3), r3));
+	return result;
+}
+
+// 2x2行列の積 A * B (要素順は 00,01,10,11)
+inline __m128 Mat2Mul(__m128 a, __m128 b) {
+	return _mm_add_ps(
+	    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+	    _mm_mul_ps(
+	        _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)),
+	        _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// 2x2行列の積 adj(A) * B
+inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+	    _mm_mul_ps(
+	        _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)),
+	        _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+// 2x2行列の積 A * adj(B)
+inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+	return _mm_sub_ps(
+	    _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+	    _mm_mul_ps(
+	        _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)),
+	        _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+// 3要素の外積 (w成分は0になる)
+inline __m128 Cross3(__m128 a, __m128 b) {
+	__m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+	return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// AoSの3要素×4個 を SoA に並べ替える
+inline void LoadPoints4(const Vector3* src, __m128& x, __m128& y, __m128& z) {
+	const float* p = &src->x;
+	__m128 v0 = _mm_loadu_ps(p);     // x0 y0 z0 x1
+	__m128 v1 = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+	__m128 v2 = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+	x = _mm_shuffle_ps(
+	    v0, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+	y = _mm_shuffle_ps(
+	    _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+	    _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+	z = _mm_shuffle_ps(
+	    _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)),
+	    _mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+// SoA の4個を AoS の3要素×4個 に戻して書き込む
+inline void StorePoints4(Vector3* dst, __m128 x, __m128 y, __m128 z) {
+	float* p = &dst->x;
+	_mm_storeu_ps(
+	    p, _mm_shuffle_ps(
+	           _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)),
+	           _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(
+	    p + 4, _mm_shuffle_ps(
+	               _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)),
+	               _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm_storeu_ps(
+	    p + 8, _mm_shuffle_ps(
+	               _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)),
+	               _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+#endif
+
+// 4個ずつ一括変換する共通処理 (translate=falseで平行移動を無視)
+void TransformArray(
+    const Vector3* src, Vector3* dst, size_t count, const Matrix4x4& m, bool translate) {
+	const float tx = translate ? m.m[3][0] : 0.0f;
+	const float ty = translate ? m.m[3][1] : 0.0f;
+	const float tz = translate ? m.m[3][2] : 0.0f;
+	size_t i = 0;
+#if MATH_SIMD_SSE
+	const __m128 m00 = _mm_set1_ps(m.m[0][0]), m01 = _mm_set1_ps(m.m[0][1]),
+	             m02 = _mm_set1_ps(m.m[0][2]);
+	const __m128 m10 = _mm_set1_ps(m.m[1][0]), m11 = _mm_set1_ps(m.m[1][1]),
+	             m12 = _mm_set1_ps(m.m[1][2]);
+	const __m128 m20 = _mm_set1_ps(m.m[2][0]), m21 = _mm_set1_ps(m.m[2][1]),
+	             m22 = _mm_set1_ps(m.m[2][2]);
+	const __m128 t0 = _mm_set1_ps(tx), t1 = _mm_set1_ps(ty), t2 = _mm_set1_ps(tz);
+	for (; i + 4 <= count; i += 4) {
+		__m128 x, y, z;
+		LoadPoints4(src + i, x, y, z);
+		__m128 ox = _mm_add_ps(
+		    _mm_add_ps(_mm_mul_ps(x, m00), _mm_mul_ps(y, m10)), _mm_add_ps(_mm_mul_ps(z, m20), t0));
+		__m128 oy = _mm_add_ps(
+		    _mm_add_ps(_mm_mul_ps(x, m01), _mm_mul_ps(y, m11)), _mm_add_ps(_mm_mul_ps(z, m21), t1));
+		__m128 oz = _mm_add_ps(
+		    _mm_add_ps(_mm_mul_ps(x, m02), _mm_mul_ps(y, m12)), _mm_add_ps(_mm_mul_ps(z, m22), t2));
+		StorePoints4(dst + i, ox, oy, oz);
+	}
+#endif
+	for (; i < count; i++) {
+		const Vector3 v = src[i];
+		dst[i] = {
+		    v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + tx,
+		    v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + ty,
+		    v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + tz};
+	}
+}
+
+} // namespace
+
+float Length(const Vector3& v) { return std::sqrt(Dot(v, v)); }
+
+Vector3 Normalize(const Vector3& v) {
+	float length = Length(v);
+	if (length == 0.0f) {
+		return v;
+	}
+	return v * (1.0f / length);
+}
+
+Matrix4x4 MakeIdentityMatrix() {
+	return {
+	    {{1.0f, 0.0f, 0.0f, 0.0f},
+	     {0.0f, 1.0f, 0.0f, 0.0f},
+	     {0.0f, 0.0f, 1.0f, 0.0f},
+	     {0.0f, 0.0f, 0.0f, 1.0f}}
+    };
+}
+
+Matrix4x4 MakeScaleMatrix(const Vector3& scale) {
+	Matrix4x4 result = MakeIdentityMatrix();
+	result.m[0][0] = scale.x;
+	result.m[1][1] = scale.y;
+	result.m[2][2] = scale.z;
+	return result;
+}
+
+Matrix4x4 MakeRotationXMatrix(float radian) {
+	float s = std::sin(radian);
+	float c = std::cos(radian);
+	Matrix4x4 result = MakeIdentityMatrix();
+	result.m[1][1] = c;
+	result.m[1][2] = s;
+	result.m[2][1] = -s;
+	result.m[2][2] = c;
+	return result;
+}
+
+Matrix4x4 MakeRotationYMatrix(float radian) {
+	float s = std::sin(radian);
+	float c = std::cos(radian);
+	Matrix4x4 result = MakeIdentityMatrix();
+	result.m[0][0] = c;
+	result.m[0][2] = -s;
+	result.m[2][0] = s;
+	result.m[2][2] = c;
+	return result;
+}
+
+Matrix4x4 MakeRotationZMatrix(float radian) {
+	float s = std::sin(radian);
+	float c = std::cos(radian);
+	Matrix4x4 result = MakeIdentityMatrix();
+	result.m[0][0] = c;
+	result.m[0][1] = s;
+	result.m[1][0] = -s;
+	result.m[1][1] = c;
+	return result;
+}
+
+Matrix4x4 MakeRotationMatrix(const Vector3& rotation) {
+	// Z * X * Y を展開した形で直接求める
+	float sx = std::sin(rotation.x), cx = std::cos(rotation.x);
+	float sy = std::sin(rotation.y), cy = std::cos(rotation.y);
+	float sz = std::sin(rotation.z), cz = std::cos(rotation.z);
+	return {
+	    {{cz * cy + sz * sx * sy, sz * cx, sz * sx * cy - cz * sy, 0.0f},
+	     {cz * sx * sy - sz * cy, cz * cx, sz * sy + cz * sx * cy, 0.0f},
+	     {cx * sy, -sx, cx * cy, 0.0f},
+	     {0.0f, 0.0f, 0.0f, 1.0f}}
+    };
+}
+
+Matrix4x4 MakeTranslationMatrix(const Vector3& translation) {
+	Matrix4x4 result = MakeIdentityMatrix();
+	result.m[3][0] = translation.x;
+	result.m[3][1] = translation.y;
+	result.m[3][2] = translation.z;
+	return result;
+}
+
+Matrix4x4
+    MakeAffineMatrix(const Vector3& scale, const Vector3& rotation, const Vector3& translation) {
+	// スケールは行ごとの乗算、平行移動は4行目の代入で済むので行列積は回転の分だけ
+	Matrix4x4 result = MakeRotationMatrix(rotation);
+	for (int i = 0; i < 3; i++) {
+		result.m[0][i] *= scale.x;
+		result.m[1][i] *= scale.y;
+		result.m[2][i] *= scale.z;
+	}
+	result.m[3][0] = translation.x;
+	result.m[3][1] = translation.y;
+	result.m[3][2] = translation.z;
+	return result;
+}
+
+Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up) {
+	Vector3 axisZ = Normalize(target - eye);
+	Vector3 axisX = Normalize(Cross(up, axisZ));
+	Vector3 axisY = Cross(axisZ, axisX);
+	return {
+	    {{axisX.x, axisY.x, axisZ.x, 0.0f},
+	     {axisX.y, axisY.y, axisZ.y, 0.0f},
+	     {axisX.z, axisY.z, axisZ.z, 0.0f},
+	     {-Dot(axisX, eye), -Dot(axisY, eye), -Dot(axisZ, eye), 1.0f}}
+    };
+}
+
+Matrix4x4 MakePerspectiveFovMatrix(float fovAngleY, float aspectRatio, float nearZ, float farZ) {
+	float scaleY = 1.0f / std::tan(fovAngleY * 0.5f);
+	float scaleX = scaleY / aspectRatio;
+	float range = farZ / (farZ - nearZ);
+	return {
+	    {{scaleX, 0.0f, 0.0f, 0.0f},
+	     {0.0f, scaleY, 0.0f, 0.0f},
+	     {0.0f, 0.0f, range, 1.0f},
+	     {0.0f, 0.0f, -range * nearZ, 0.0f}}
+    };
+}
+
+Matrix4x4 MakeOrthographicMatrix(
+    float left, float top, float right, float bottom, float nearZ, float farZ) {
+	return {
+	    {{2.0f / (right - left), 0.0f, 0.0f, 0.0f},
+	     {0.0f, 2.0f / (top - bottom), 0.0f, 0.0f},
+	     {0.0f, 0.0f, 1.0f / (farZ - nearZ), 0.0f},
+	     {(left + right) / (left - right), (top + bottom) / (bottom - top),
+	      nearZ / (nearZ - farZ), 1.0f}}
+    };
+}
+
+Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result;
+#if MATH_SIMD_AVX2
+	// 2行ずつ256bitで処理する
+	const __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[0]));
+	const __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[1]));
+	const __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[2]));
+	const __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m2.m[3]));
+	for (int i = 0; i < 4; i += 2) {
+		__m256 a = _mm256_loadu_ps(m1.m[i]);
+		__m256 c = _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+		c = _mm256_add_ps(c, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+		c = _mm256_add_ps(c, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+		c = _mm256_add_ps(c, _mm256_mul_ps(_mm256_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+		_mm256_storeu_ps(result.m[i], c);
+	}
+#elif MATH_SIMD_SSE
+	const __m128 r0 = LoadRow(m2, 0);
+	const __m128 r1 = LoadRow(m2, 1);
+	const __m128 r2 = LoadRow(m2, 2);
+	const __m128 r3 = LoadRow(m2, 3);
+	for (int i = 0; i < 4; i++) {
+		_mm_storeu_ps(result.m[i], MultiplyRow(LoadRow(m1, i), r0, r1, r2, r3));
+	}
+#else
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.m[i][j] = m1.m[i][0] * m2.m[0][j] + m1.m[i][1] * m2.m[1][j] +
+			                 m1.m[i][2] * m2.m[2][j] + m1.m[i][3] * m2.m[3][j];
+		}
+	}
+#endif
+	return result;
+}
+
+Matrix4x4 Transpose(const Matrix4x4& m) {
+	Matrix4x4 result;
+#if MATH_SIMD_SSE
+	__m128 r0 = LoadRow(m, 0);
+	__m128 r1 = LoadRow(m, 1);
+	__m128 r2 = LoadRow(m, 2);
+	__m128 r3 = LoadRow(m, 3);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(result.m[0], r0);
+	_mm_storeu_ps(result.m[1], r1);
+	_mm_storeu_ps(result.m[2], r2);
+	_mm_storeu_ps(result.m[3], r3);
+#else
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			result.m[i][j] = m.m[j][i];
+		}
+	}
+#endif
+	return result;
+}
+
+Matrix4x4 Inverse(const Matrix4x4& m) {
+	Matrix4x4 result;
+#if MATH_SIMD_SSE
+	// 2x2ブロックに分割して逆行列を求める
+	// M = | A B |  のとき、各ブロックの余因子から逆行列を組み立てる
+	//     | C D |
+	const __m128 r0 = LoadRow(m, 0);
+	const __m128 r1 = LoadRow(m, 1);
+	const __m128 r2 = LoadRow(m, 2);
+	const __m128 r3 = LoadRow(m, 3);
+	const __m128 a = _mm_movelh_ps(r0, r1);
+	const __m128 b = _mm_movehl_ps(r1, r0);
+	const __m128 c = _mm_movelh_ps(r2, r3);
+	const __m128 d = _mm_movehl_ps(r3, r2);
+
+	// (|A| |B| |C| |D|)
+	const __m128 detSub = _mm_sub_ps(
+	    _mm_mul_ps(
+	        _mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)),
+	        _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+	    _mm_mul_ps(
+	        _mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)),
+	        _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+	const __m128 detA = MATH_SPLAT(detSub, 0);
+	const __m128 detB = MATH_SPLAT(detSub, 1);
+	const __m128 detC = MATH_SPLAT(detSub, 2);
+	const __m128 detD = MATH_SPLAT(detSub, 3);
+
+	const __m128 adjDC = Mat2AdjMul(d, c);
+	const __m128 adjAB = Mat2AdjMul(a, b);
+	__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, adjDC));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, adjAB));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, adjAB));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, adjDC));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 trace = _mm_mul_ps(adjAB, _mm_shuffle_ps(adjDC, adjDC, _MM_SHUFFLE(3, 1, 2, 0)));
+	trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+	trace = _mm_add_ps(trace, MATH_SPLAT(trace, 1));
+	trace = MATH_SPLAT(trace, 0);
+	__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+	detM = _mm_sub_ps(detM, trace);
+
+	const __m128 rcpDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+	x = _mm_mul_ps(x, rcpDetM);
+	y = _mm_mul_ps(y, rcpDetM);
+	z = _mm_mul_ps(z, rcpDetM);
+	w = _mm_mul_ps(w, rcpDetM);
+
+	_mm_storeu_ps(result.m[0], _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(result.m[1], _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+	_mm_storeu_ps(result.m[2], _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+	_mm_storeu_ps(result.m[3], _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+#else
+	// 余因子展開
+	const float(&a)[4][4] = m.m;
+	float s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+	float s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+	float s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+	float s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+	float s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+	float s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+	float c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+	float c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+	float c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+	float c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+	float c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+	float c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+	float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	float invDet = 1.0f / det;
+	result.m[0][0] = (a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * invDet;
+	result.m[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * invDet;
+	result.m[0][2] = (a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * invDet;
+	result.m[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * invDet;
+	result.m[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * invDet;
+	result.m[1][1] = (a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * invDet;
+	result.m[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * invDet;
+	result.m[1][3] = (a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * invDet;
+	result.m[2][0] = (a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * invDet;
+	result.m[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * invDet;
+	result.m[2][2] = (a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * invDet;
+	result.m[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * invDet;
+	result.m[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * invDet;
+	result.m[3][1] = (a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * invDet;
+	result.m[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * invDet;
+	result.m[3][3] = (a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * invDet;
+#endif
+	return result;
+}
+
+Matrix4x4 InverseAffine(const Matrix4x4& m) {
+	Matrix4x4 result;
+#if MATH_SIMD_SSE
+	// 上3x3の逆行列は各行の外積を転置して行列式で割ったもの
+	const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 r0 = _mm_and_ps(LoadRow(m, 0), mask);
+	const __m128 r1 = _mm_and_ps(LoadRow(m, 1), mask);
+	const __m128 r2 = _mm_and_ps(LoadRow(m, 2), mask);
+	__m128 c0 = Cross3(r1, r2);
+	__m128 c1 = Cross3(r2, r0);
+	__m128 c2 = Cross3(r0, r1);
+	__m128 det = _mm_mul_ps(r0, c0);
+	det = _mm_add_ps(_mm_add_ps(MATH_SPLAT(det, 0), MATH_SPLAT(det, 1)), MATH_SPLAT(det, 2));
+	const __m128 rcpDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+	c0 = _mm_mul_ps(c0, rcpDet);
+	c1 = _mm_mul_ps(c1, rcpDet);
+	c2 = _mm_mul_ps(c2, rcpDet);
+	__m128 c3 = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	// 平行移動 = -t * L^-1
+	const __m128 t = LoadRow(m, 3);
+	__m128 translation = _mm_mul_ps(MATH_SPLAT(t, 0), c0);
+	translation = _mm_add_ps(translation, _mm_mul_ps(MATH_SPLAT(t, 1), c1));
+	translation = _mm_add_ps(translation, _mm_mul_ps(MATH_SPLAT(t, 2), c2));
+	translation = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation);
+
+	_mm_storeu_ps(result.m[0], c0);
+	_mm_storeu_ps(result.m[1], c1);
+	_mm_storeu_ps(result.m[2], c2);
+	_mm_storeu_ps(result.m[3], translation);
+#else
+	Vector3 r0 = {m.m[0][0], m.m[0][1], m.m[0][2]};
+	Vector3 r1 = {m.m[1][0], m.m[1][1], m.m[1][2]};
+	Vector3 r2 = {m.m[2][0], m.m[2][1], m.m[2][2]};
+	Vector3 c0 = Cross(r1, r2);
+	Vector3 c1 = Cross(r2, r0);
+	Vector3 c2 = Cross(r0, r1);
+	float invDet = 1.0f / Dot(r0, c0);
+	c0 *= invDet;
+	c1 *= invDet;
+	c2 *= invDet;
+	result = {
+	    {{c0.x, c1.x, c2.x, 0.0f},
+	     {c0.y, c1.y, c2.y, 0.0f},
+	     {c0.z, c1.z, c2.z, 0.0f},
+	     {0.0f, 0.0f, 0.0f, 1.0f}}
+    };
+	Vector3 translation =
+	    TransformNormal({m.m[3][0], m.m[3][1], m.m[3][2]}, result);
+	result.m[3][0] = -translation.x;
+	result.m[3][1] = -translation.y;
+	result.m[3][2] = -translation.z;
+#endif
+	return result;
+}
+
+Vector3 Transform(const Vector3& v, const Matrix4x4& m) {
+	Vector4 result = Transform(Vector4{v.x, v.y, v.z, 1.0f}, m);
+	float invW = result.w != 0.0f ? 1.0f / result.w : 1.0f;
+	return {result.x * invW, result.y * invW, result.z * invW};
+}
+
+Vector3 TransformPoint(const Vector3& v, const Matrix4x4& m) {
+	return {
+	    v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + m.m[3][0],
+	    v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + m.m[3][1],
+	    v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + m.m[3][2]};
+}
+
+Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m) {
+	return {
+	    v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0],
+	    v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1],
+	    v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2]};
+}
+
+Vector4 Transform(const Vector4& v, const Matrix4x4& m) {
+	Vector4 result;
+#if MATH_SIMD_SSE
+	_mm_storeu_ps(
+	    &result.x, MultiplyRow(
+	                   _mm_loadu_ps(&v.x), LoadRow(m, 0), LoadRow(m, 1), LoadRow(m, 2),
+	                   LoadRow(m, 3)));
+#else
+	result.x = v.x * m.m[0][0] + v.y * m.m[1][0] + v.z * m.m[2][0] + v.w * m.m[3][0];
+	result.y = v.x * m.m[0][1] + v.y * m.m[1][1] + v.z * m.m[2][1] + v.w * m.m[3][1];
+	result.z = v.x * m.m[0][2] + v.y * m.m[1][2] + v.z * m.m[2][2] + v.w * m.m[3][2];
+	result.w = v.x * m.m[0][3] + v.y * m.m[1][3] + v.z * m.m[2][3] + v.w * m.m[3][3];
+#endif
+	return result;
+}
+
+void MultiplyArray(const Matrix4x4* lhs, const Matrix4x4& rhs, Matrix4x4* dst, size_t count) {
+#if MATH_SIMD_AVX2
+	const __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs.m[0]));
+	const __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs.m[1]));
+	const __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs.m[2]));
+	const __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs.m[3]));
+	for (size_t n = 0; n < count; n++) {
+		// 出力先が入力と同じでもよいように2行分ずつ読んでから書く
+		__m256 a01 = _mm256_loadu_ps(lhs[n].m[0]);
+		__m256 a23 = _mm256_loadu_ps(lhs[n].m[2]);
+		__m256 c01 = _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+		__m256 c23 = _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+		c01 = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+		c23 = _mm256_add_ps(c23, _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+		c01 = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+		c23 = _mm256_add_ps(c23, _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+		c01 = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_permute_ps(a01, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+		c23 = _mm256_add_ps(c23, _mm256_mul_ps(_mm256_permute_ps(a23, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+		_mm256_storeu_ps(dst[n].m[0], c01);
+		_mm256_storeu_ps(dst[n].m[2], c23);
+	}
+#elif MATH_SIMD_SSE
+	const __m128 r0 = LoadRow(rhs, 0);
+	const __m128 r1 = LoadRow(rhs, 1);
+	const __m128 r2 = LoadRow(rhs, 2);
+	const __m128 r3 = LoadRow(rhs, 3);
+	for (size_t n = 0; n < count; n++) {
+		__m128 a0 = LoadRow(lhs[n], 0);
+		__m128 a1 = LoadRow(lhs[n], 1);
+		__m128 a2 = LoadRow(lhs[n], 2);
+		__m128 a3 = LoadRow(lhs[n], 3);
+		_mm_storeu_ps(dst[n].m[0], MultiplyRow(a0, r0, r1, r2, r3));
+		_mm_storeu_ps(dst[n].m[1], MultiplyRow(a1, r0, r1, r2, r3));
+		_mm_storeu_ps(dst[n].m[2], MultiplyRow(a2, r0, r1, r2, r3));
+		_mm_storeu_ps(dst[n].m[3], MultiplyRow(a3, r0, r1, r2, r3));
+	}
+#else
+	for (size_t n = 0; n < count; n++) {
+		dst[n] = Multiply(lhs[n], rhs);
+	}
+#endif
+}
+
+void TransformPoints(const Vector3* src, Vector3* dst, size_t count, const Matrix4x4& m) {
+	TransformArray(src, dst, count, m, true);
+}
+
+void TransformVectors(const Vector3* src, Vector3* dst, size_t count, const Matrix4x4& m) {
+	TransformArray(src, dst, count, m, false);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "Matrix4x4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include <cstddef>
+
+// 行列は行優先・行ベクトル (v * M) 、左手座標系 (DirectXMath と同じ規約)
+// SSE/AVX2 が使える環境ではSIMD実装、それ以外ではスカラー実装に切り替わる
+
+#pragma region ベクトル演算
+inline Vector3 operator+(const Vector3& v1, const Vector3& v2) {
+	return {v1.x + v2.x, v1.y + v2.y, v1.z + v2.z};
+}
+inline Vector3 operator-(const Vector3& v1, const Vector3& v2) {
+	return {v1.x - v2.x, v1.y - v2.y, v1.z - v2.z};
+}
+inline Vector3 operator-(const Vector3& v) { return {-v.x, -v.y, -v.z}; }
+inline Vector3 operator*(const Vector3& v, float s) { return {v.x * s, v.y * s, v.z * s}; }
+inline Vector3 operator*(float s, const Vector3& v) { return v * s; }
+inline Vector3& operator+=(Vector3& v1, const Vector3& v2) { return v1 = v1 + v2; }
+inline Vector3& operator-=(Vector3& v1, const Vector3& v2) { return v1 = v1 - v2; }
+inline Vector3& operator*=(Vector3& v, float s) { return v = v * s; }
+
+/// <summary>
+/// 内積
+/// </summary>
+inline float Dot(const Vector3& v1, const Vector3& v2) {
+	return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+/// <summary>
+/// 外積
+/// </summary>
+inline Vector3 Cross(const Vector3& v1, const Vector3& v2) {
+	return {v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x};
+}
+
+/// <summary>
+/// 長さ
+/// </summary>
+float Length(const Vector3& v);
+
+/// <summary>
+/// 正規化（長さ0の場合はそのまま返す）
+/// </summary>
+Vector3 Normalize(const Vector3& v);
+#pragma endregion
+
+#pragma region 行列生成
+/// <summary>
+/// 単位行列
+/// </summary>
+Matrix4x4 MakeIdentityMatrix();
+
+/// <summary>
+/// 拡大縮小行列
+/// </summary>
+Matrix4x4 MakeScaleMatrix(const Vector3& scale);
+
+/// <summary>
+/// X軸回転行列
+/// </summary>
+/// <param name="radian">回転角（ラジアン）</param>
+Matrix4x4 MakeRotationXMatrix(float radian);
+
+/// <summary>
+/// Y軸回転行列
+/// </summary>
+/// <param name="radian">回転角（ラジアン）</param>
+Matrix4x4 MakeRotationYMatrix(float radian);
+
+/// <summary>
+/// Z軸回転行列
+/// </summary>
+/// <param name="radian">回転角（ラジアン）</param>
+Matrix4x4 MakeRotationZMatrix(float radian);
+
+/// <summary>
+/// 回転行列（Z→X→Yの順で回転。WorldTransformと同じ）
+/// </summary>
+/// <param name="rotation">X,Y,Z軸回りの回転角</param>
+Matrix4x4 MakeRotationMatrix(const Vector3& rotation);
+
+/// <summary>
+/// 平行移動行列
+/// </summary>
+Matrix4x4 MakeTranslationMatrix(const Vector3& translation);
+
+/// <summary>
+/// アフィン変換行列（スケール→回転→平行移動）
+/// </summary>
+Matrix4x4
+    MakeAffineMatrix(const Vector3& scale, const Vector3& rotation, const Vector3& translation);
+
+/// <summary>
+/// ビュー行列（左手系）
+/// </summary>
+/// <param name="eye">視点座標</param>
+/// <param name="target">注視点座標</param>
+/// <param name="up">上方向ベクトル</param>
+Matrix4x4 MakeLookAtMatrix(const Vector3& eye, const Vector3& target, const Vector3& up);
+
+/// <summary>
+/// 透視投影行列（左手系、深度0～1）
+/// </summary>
+/// <param name="fovAngleY">垂直方向視野角</param>
+/// <param name="aspectRatio">アスペクト比</param>
+/// <param name="nearZ">深度限界（手前側）</param>
+/// <param name="farZ">深度限界（奥側）</param>
+Matrix4x4 MakePerspectiveFovMatrix(float fovAngleY, float aspectRatio, float nearZ, float farZ);
+
+/// <summary>
+/// 平行投影行列（左手系、深度0～1）
+/// </summary>
+Matrix4x4 MakeOrthographicMatrix(
+    float left, float top, float right, float bottom, float nearZ, float farZ);
+#pragma endregion
+
+#pragma region 行列演算
+/// <summary>
+/// 行列の積 (m1 * m2)
+/// </summary>
+Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+
+inline Matrix4x4 operator*(const Matrix4x4& m1, const Matrix4x4& m2) { return Multiply(m1, m2); }
+inline Matrix4x4& operator*=(Matrix4x4& m1, const Matrix4x4& m2) { return m1 = Multiply(m1, m2); }
+
+/// <summary>
+/// 転置行列
+/// </summary>
+Matrix4x4 Transpose(const Matrix4x4& m);
+
+/// <summary>
+/// 逆行列（一般の4x4行列）
+/// </summary>
+Matrix4x4 Inverse(const Matrix4x4& m);
+
+/// <summary>
+/// 逆行列（4列目が(0,0,0,1)のアフィン行列専用。Inverseより高速）
+/// </summary>
+Matrix4x4 InverseAffine(const Matrix4x4& m);
+
+/// <summary>
+/// 座標変換（w除算あり）
+/// </summary>
+Vector3 Transform(const Vector3& v, const Matrix4x4& m);
+
+/// <summary>
+/// 座標変換（w=1として扱い、w除算なし）
+/// </summary>
+Vector3 TransformPoint(const Vector3& v, const Matrix4x4& m);
+
+/// <summary>
+/// 方向ベクトル変換（平行移動を無視）
+/// </summary>
+Vector3 TransformNormal(const Vector3& v, const Matrix4x4& m);
+
+/// <summary>
+/// 4次元ベクトル変換
+/// </summary>
+Vector4 Transform(const Vector4& v, const Matrix4x4& m);
+#pragma endregion
+
+#pragma region 一括演算
+/// <summary>
+/// 行列の一括乗算 (dst[i] = lhs[i] * rhs)
+/// </summary>
+/// <param name="lhs">左辺行列配列</param>
+/// <param name="rhs">右辺行列</param>
+/// <param name="dst">出力先（lhsと同じでもよい）</param>
+/// <param name="count">要素数</param>
+void MultiplyArray(const Matrix4x4* lhs, const Matrix4x4& rhs, Matrix4x4* dst, size_t count);
+
+/// <summary>
+/// 座標の一括変換（w=1、w除算なし）
+/// </summary>
+/// <param name="src">入力座標配列</param>
+/// <param name="dst">出力先（srcと同じでもよい）</param>
+/// <param name="count">要素数</param>
+/// <param name="m">変換行列</param>
+void TransformPoints(const Vector3* src, Vector3* dst, size_t count, const Matrix4x4& m);
+
+/// <summary>
+/// 方向ベクトルの一括変換（平行移動を無視）
+/// </summary>
+/// <param name="src">入力ベクトル配列</param>
+/// <param name="dst">出力先（srcと同じでもよい）</param>
+/// <param name="count">要素数</param>
+/// <param name="m">変換行列</param>
+void TransformVectors(const Vector3* src, Vector3* dst, size_t count, const Matrix4x4& m);
+#pragma endregion
@@ -0,0 +1,24 @@
+#pragma once
+
+// SIMD命令セットの選択
+// MATH_NO_SIMD を定義するとスカラー実装に固定される
+// x64 では SSE2 まで常に使えるので SSE 経路は既定で有効、
+// AVX2 経路は /arch:AVX2 (-mavx2) を指定したときのみ有効になる
+#if !defined(MATH_NO_SIMD)
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define MATH_SIMD_SSE 1
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+#if defined(MATH_SIMD_SSE) && defined(__AVX2__)
+#define MATH_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#ifndef MATH_SIMD_SSE
+#define MATH_SIMD_SSE 0
+#endif
+#ifndef MATH_SIMD_AVX2
+#define MATH_SIMD_AVX2 0
+#endif
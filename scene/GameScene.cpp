@@ -1,7 +1,27 @@
 #include "GameScene.h"
+#include "MathUtility.h"
 #include "TextureManager.h"
 #include <cassert>
 
+namespace {
+
+// 排他グループ（Sprite と Model は記録先のコマンドリストを静的に持つので、同じクラスを使うパスは同時に記録しない）
+enum RecordGroup : uint32_t {
+	kSpriteGroup,
+	kModelGroup,
+};
+
+// 並べるモデルの名前
+const char kGridModelName[] = "cube";
+// 格子の1辺の個数
+const int kGridSize = 32;
+// 格子の間隔
+const float kGridSpacing = 5.0f;
+// カメラの旋回速度（ラジアン/フレーム）
+const float kCameraTurnSpeed = 0.005f;
+
+} // namespace
+
 GameScene::GameScene() {}
 
 GameScene::~GameScene() {}
@@ -11,51 +31,107 @@ void GameScene::Initialize() {
 	dxCommon_ = DirectXCommon::GetInstance();
 	input_ = Input::GetInstance();
 	audio_ = Audio::GetInstance();
+
+	commandListPool_.Initialize(dxCommon_->GetDevice());
+	recorder_.Initialize(&commandListPool_);
+
+	// 格子の中心から見回す
+	viewProjection_.translation_ = {0.0f, 8.0f, 0.0f};
+	viewProjection_.rotation_ = {0.2f, 0.0f, 0.0f};
+	viewProjection_.Initialize();
+
+	// 同じモデルを並べ、読み込みとバッファは1つを共有する
+	model_ = ModelRegistry::Load(kGridModelName);
+	const Sphere modelSphere = ComputeModelBounds(model_.Get()).sphere;
+	worldMatrices_.reserve(size_t(kGridSize) * kGridSize);
+	worldSpheres_.reserve(size_t(kGridSize) * kGridSize);
+	const float origin = -kGridSpacing * float(kGridSize - 1) * 0.5f;
+	for (int z = 0; z < kGridSize; z++) {
+		for (int x = 0; x < kGridSize; x++) {
+			const Vector3 position = {
+			    origin + kGridSpacing * float(x), 0.0f, origin + kGridSpacing * float(z)};
+			worldMatrices_.push_back(MakeTranslationMatrix(position));
+			worldSpheres_.push_back({modelSphere.center + position, modelSphere.radius});
+		}
+	}
+	visibleIndices_.resize(worldSpheres_.size());
+	visibleMatrices_.reserve(worldMatrices_.size());
 }
 
-void GameScene::Update() {}
+void GameScene::Update() {
+	viewProjection_.rotation_.y += kCameraTurnSpeed;
+	viewProjection_.UpdateMatrix();
+}
 
 void GameScene::Draw() {
 
-	// コマンドリストの取得
-	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
-
-#pragma region 背景スプライト描画
-	// 背景スプライト描画前処理
-	Sprite::PreDraw(commandList);
+	// パスごとに別のコマンドリストへワーカースレッドで記録し、追加した順に提出する。
+	// コマンドリストを受け取る描画は AddPass(要素数, 最小要素数, ...) で分けて並列に記録できる。
+	// Model::PreDraw の状態を使う描画（Terrain など）は 3D オブジェクトのパスで PreDraw と PostDraw の間に記録する。
+	// Execute の後の描画コマンドリストにはパイプラインの状態が残っていないので、使うなら PreDraw からやり直す
 
-	/// <summary>
-	/// ここに背景スプライトの描画処理を追加できる
-	/// </summary>
+	// 視錐台の外のモデルを除く（記録を始める前にこのスレッドで済ませる）
+	const Frustum frustum = MakeFrustum(viewProjection_);
+	const size_t visibleCount =
+	    frustum.CullSpheres(worldSpheres_.data(), worldSpheres_.size(), visibleIndices_.data());
+	visibleMatrices_.clear();
+	for (size_t i = 0; i < visibleCount; i++) {
+		visibleMatrices_.push_back(worldMatrices_[visibleIndices_[i]]);
+	}
 
-	// スプライト描画後処理
-	Sprite::PostDraw();
-	// 深度バッファクリア
-	dxCommon_->ClearDepthBuffer();
+#pragma region 背景スプライト描画
+	recorder_.AddPass(
+	    [](ID3D12GraphicsCommandList* commandList, size_t, size_t) {
+		    // 背景スプライト描画前処理
+		    Sprite::PreDraw(commandList);
+
+		    /// <summary>
+		    /// ここに背景スプライトの描画処理を追加できる
+		    /// </summary>
+
+		    // スプライト描画後処理
+		    Sprite::PostDraw();
+	    },
+	    kSpriteGroup);
 #pragma endregion
 
 #pragma region 3Dオブジェクト描画
-	// 3Dオブジェクト描画前処理
-	Model::PreDraw(commandList);
-
-	/// <summary>
-	/// ここに3Dオブジェクトの描画処理を追加できる
-	/// </summary>
+	recorder_.AddPass(
+	    [this](ID3D12GraphicsCommandList* commandList, size_t, size_t) {
+		    // 深度バッファクリア（背景スプライトの後に実行される）
+		    dxCommon_->ClearDepthBuffer(commandList);
 
-	// 3Dオブジェクト描画後処理
-	Model::PostDraw();
-#pragma endregion
+		    // 3Dオブジェクト描画前処理
+		    Model::PreDraw(commandList);
 
-#pragma region 前景スプライト描画
-	// 前景スプライト描画前処理
-	Sprite::PreDraw(commandList);
+		    /// <summary>
+		    /// ここに3Dオブジェクト（Terrain を含む）の描画処理を追加できる
+		    /// </summary>
 
-	/// <summary>
-	/// ここに前景スプライトの描画処理を追加できる
-	/// </summary>
+		    model_->DrawInstanced(visibleMatrices_, viewProjection_);
 
-	// スプライト描画後処理
-	Sprite::PostDraw();
+		    // 3Dオブジェクト描画後処理
+		    Model::PostDraw();
+	    },
+	    kModelGroup);
+#pragma endregion
 
+#pragma region 前景スプライト描画
+	recorder_.AddPass(
+	    [](ID3D12GraphicsCommandList* commandList, size_t, size_t) {
+		    // 前景スプライト描画前処理
+		    Sprite::PreDraw(commandList);
+
+		    /// <summary>
+		    /// ここに前景スプライトの描画処理を追加できる
+		    /// </summary>
+
+		    // スプライト描画後処理
+		    Sprite::PostDraw();
+	    },
+	    kSpriteGroup);
 #pragma endregion
+
+	// 記録して提出する
+	recorder_.Execute();
 }
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "Audio.h"
+#include "CommandListPool.h"
+#include "Culling.h"
 #include "DirectXCommon.h"
 #include "Input.h"
 #include "Model.h"
+#include "ModelRegistry.h"
+#include "ParallelCommandRecorder.h"
 #include "SafeDelete.h"
 #include "Sprite.h"
 #include "ViewProjection.h"
 #include "WorldTransform.h"
+#include <vector>
 
 /// <summary>
 /// ゲームシーン
@@ -44,8 +49,24 @@ private: // メンバ変数
 	DirectXCommon* dxCommon_ = nullptr;
 	Input* input_ = nullptr;
 	Audio* audio_ = nullptr;
+	// 並列記録用のコマンドリスト
+	CommandListPool commandListPool_;
+	// 描画パスの並列記録
+	ParallelCommandRecorder<ID3D12GraphicsCommandList> recorder_;
 
 	/// <summary>
 	/// ゲームシーン用
 	/// </summary>
+
+	// ビュープロジェクション
+	ViewProjection viewProjection_;
+	// 格子状に並べるモデル（ModelRegistry で共有する）
+	ModelRegistry::Handle model_;
+	// 並べたモデルのワールド行列
+	std::vector<Matrix4x4> worldMatrices_;
+	// 並べたモデルのワールド座標の境界球（worldMatrices_ と同じ順番）
+	std::vector<Sphere> worldSpheres_;
+	// 視錐台カリングの作業領域と、残ったモデルのワールド行列
+	std::vector<uint32_t> visibleIndices_;
+	std::vector<Matrix4x4> visibleMatrices_;
 };
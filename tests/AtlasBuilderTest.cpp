@@ -0,0 +1,176 @@
+#include "AtlasBuilder.h"
+#include "TestFramework.h"
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 画素ごとに違う値で塗った画像（端の画素の引き伸ばしを見分けられるようにする）
+TextureData MakeImage(uint32_t width, uint32_t height, uint32_t seed) {
+	TextureData image;
+	image.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	std::mt19937 random(seed);
+	for (uint8_t& value : image.pixels) {
+		value = uint8_t(random());
+	}
+	return image;
+}
+
+// 1色で塗った画像
+TextureData MakeSolidImage(uint32_t width, uint32_t height, uint32_t color) {
+	TextureData image;
+	image.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	for (size_t i = 0; i < image.pixels.size(); i++) {
+		image.pixels[i] = uint8_t(color >> ((i % 4) * 8));
+	}
+	return image;
+}
+
+const uint8_t* GetPixel(const TextureData& texture, uint32_t level, uint32_t x, uint32_t y) {
+	const TextureMip& mip = texture.mips[level];
+	return texture.GetMipPixels(level) + size_t(y) * mip.rowPitch + size_t(x) * 4;
+}
+
+bool IsPowerOfTwo(uint32_t value) { return value != 0 && (value & (value - 1)) == 0; }
+
+} // namespace
+
+TEST(RegionsHoldImagesAndPadding) {
+	AtlasBuilder builder;
+	std::vector<TextureData> images;
+	std::mt19937 random(1);
+	for (uint32_t i = 0; i < 80; i++) {
+		images.push_back(MakeImage(1 + random() % 60, 1 + random() % 60, i));
+		CHECK(builder.Add("image" + std::to_string(i), images.back()));
+	}
+	AtlasBuilder::Options options;
+	options.pageSize = 256;
+	options.padding = 2;
+	CHECK(builder.Build(options));
+	CHECK(builder.GetRegionCount() == images.size());
+
+	bool isInPage = true;
+	bool isCopied = true;
+	bool isPadded = true;
+	bool isSeparate = true;
+	for (uint32_t i = 0; i < images.size(); i++) {
+		const AtlasBuilder::Region* region = builder.FindRegion("image" + std::to_string(i));
+		const TextureData& page = builder.GetPages()[region->page];
+		const TextureData& image = images[i];
+		isInPage &= 2 <= region->x && 2 <= region->y;
+		isInPage &= region->x + region->width + 2 <= page.GetWidth();
+		isInPage &= region->y + region->height + 2 <= page.GetHeight();
+		isInPage &= region->width == image.GetWidth() && region->height == image.GetHeight();
+		for (uint32_t y = 0; y < image.GetHeight(); y++) {
+			for (uint32_t x = 0; x < image.GetWidth(); x++) {
+				isCopied &= std::memcmp(
+				                GetPixel(page, 0, region->x + x, region->y + y),
+				                GetPixel(image, 0, x, y), 4) == 0;
+			}
+		}
+		// 余白の角は画像の角の画素
+		const uint32_t right = image.GetWidth() - 1;
+		const uint32_t bottom = image.GetHeight() - 1;
+		isPadded &= std::memcmp(
+		                GetPixel(page, 0, region->x - 2, region->y - 2), GetPixel(image, 0, 0, 0),
+		                4) == 0;
+		isPadded &= std::memcmp(
+		                GetPixel(page, 0, region->x + right + 2, region->y + bottom + 2),
+		                GetPixel(image, 0, right, bottom), 4) == 0;
+		// 余白を含めても重ならない
+		for (uint32_t j = 0; j < i; j++) {
+			const AtlasBuilder::Region& other = builder.GetRegion(j);
+			if (other.page == region->page) {
+				isSeparate &= other.x + other.width + 4 <= region->x ||
+				              region->x + region->width + 4 <= other.x ||
+				              other.y + other.height + 4 <= region->y ||
+				              region->y + region->height + 4 <= other.y;
+			}
+		}
+	}
+	CHECK(isInPage);
+	CHECK(isCopied);
+	CHECK(isPadded);
+	CHECK(isSeparate);
+
+	// 入りきらない分はページを増やし、ページは2のべき乗
+	CHECK(1 < builder.GetPages().size());
+	bool isPowerOfTwo = true;
+	for (const TextureData& page : builder.GetPages()) {
+		isPowerOfTwo &= IsPowerOfTwo(page.GetWidth()) && IsPowerOfTwo(page.GetHeight());
+		isPowerOfTwo &= page.GetWidth() <= 256 && page.GetHeight() <= 256;
+	}
+	CHECK(isPowerOfTwo);
+	CHECK(0.0 < builder.GetEfficiency() && builder.GetEfficiency() <= 1.0);
+}
+
+TEST(MipsDoNotBleedAcrossImages) {
+	AtlasBuilder builder;
+	const uint32_t colors[] = {0xFF0000FF, 0xFF00FF00, 0xFFFF0000, 0x80FFFFFF};
+	for (uint32_t i = 0; i < 4; i++) {
+		const TextureData image = MakeSolidImage(13 + i * 7, 21 - i * 3, colors[i]);
+		builder.Add("solid" + std::to_string(i), image);
+	}
+	AtlasBuilder::Options options;
+	options.mipCount = 4;
+	options.padding = 1;
+	CHECK(builder.Build(options));
+	const TextureData& page = builder.GetPages()[0];
+	CHECK(page.GetMipCount() == 4);
+
+	// 最小ミップでも、各画像の範囲の画素は元の色のまま（sRGB の往復で ±1）
+	bool isUnmixed = true;
+	for (uint32_t i = 0; i < 4; i++) {
+		const AtlasBuilder::Region& region = builder.GetRegion(i);
+		// 余白は最小ミップの1画素（8画素）まで広がる
+		isUnmixed &= (region.x - 8) % 8 == 0 && (region.y - 8) % 8 == 0;
+		for (uint32_t y = region.y / 8; y < (region.y + region.height + 7) / 8; y++) {
+			for (uint32_t x = region.x / 8; x < (region.x + region.width + 7) / 8; x++) {
+				const uint8_t* pixel = GetPixel(page, 3, x, y);
+				for (int c = 0; c < 4; c++) {
+					const int expected = int((colors[i] >> (c * 8)) & 0xFF);
+					isUnmixed &= std::abs(int(pixel[c]) - expected) <= 1;
+				}
+			}
+		}
+	}
+	CHECK(isUnmixed);
+}
+
+TEST(BuildRejectsWhatCannotFit) {
+	AtlasBuilder builder;
+	TextureData compressed;
+	compressed.format = TextureFormat::kBC7Unorm;
+	compressed.mips.push_back({0, 4, 4, 16, 16});
+	compressed.pixels.resize(16);
+	CHECK(!builder.Add("compressed", compressed));
+
+	// 同じ名前は置き換える
+	CHECK(builder.Add("image", MakeImage(8, 8, 1)));
+	CHECK(builder.Add("image", MakeImage(16, 8, 2)));
+	CHECK(builder.GetImageCount() == 1);
+	AtlasBuilder::Options options;
+	CHECK(builder.Build(options));
+	CHECK(builder.FindRegion("image")->width == 16);
+	CHECK(!builder.FindRegion("missing"));
+
+	// 余白を含めて1ページに入らない
+	CHECK(builder.Add("large", MakeImage(62, 8, 3)));
+	options.pageSize = 64;
+	options.padding = 2;
+	CHECK(!builder.Build(options));
+	CHECK(builder.GetRegionCount() == 0 && !builder.FindRegion("image"));
+
+	// BGRA は RGBA に並べ替える
+	TextureData bgra = MakeSolidImage(4, 4, 0xFF332211);
+	bgra.format = TextureFormat::kB8G8R8A8Unorm;
+	AtlasBuilder swizzled;
+	swizzled.Add("bgra", bgra);
+	CHECK(swizzled.Build(AtlasBuilder::Options()));
+	const AtlasBuilder::Region* region = swizzled.FindRegion("bgra");
+	const uint8_t* pixel = GetPixel(swizzled.GetPages()[0], 0, region->x, region->y);
+	CHECK(pixel[0] == 0x33 && pixel[1] == 0x22 && pixel[2] == 0x11);
+}
@@ -0,0 +1,158 @@
+#include "AtlasPacker.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Rect = AtlasPacker::Rect;
+
+bool Intersects(const Rect& a, const Rect& b) {
+	return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+	       b.y < a.y + a.height;
+}
+
+// 画素ごとの使用の有無で置ける位置を総当たりで探す基準
+class OccupancyGrid {
+public:
+	OccupancyGrid(uint32_t width, uint32_t height)
+	    : width_(width), height_(height), cells_(size_t(width) * height, 0) {}
+
+	// 上端が最も上になる位置（同じなら左）。無ければ false
+	bool Find(uint32_t width, uint32_t height, Rect& rect) const {
+		if (width_ < width || height_ < height) {
+			return false;
+		}
+		// 使用済みの数の累積和で、矩形の中に使用済みがあるかを O(1) で調べる
+		std::vector<uint32_t> sums(size_t(width_ + 1) * (height_ + 1), 0);
+		for (uint32_t y = 0; y < height_; y++) {
+			for (uint32_t x = 0; x < width_; x++) {
+				sums[size_t(y + 1) * (width_ + 1) + x + 1] =
+				    cells_[size_t(y) * width_ + x] + sums[size_t(y) * (width_ + 1) + x + 1] +
+				    sums[size_t(y + 1) * (width_ + 1) + x] - sums[size_t(y) * (width_ + 1) + x];
+			}
+		}
+		auto sum = [&](uint32_t x, uint32_t y) { return sums[size_t(y) * (width_ + 1) + x]; };
+		for (uint32_t y = 0; y + height <= height_; y++) {
+			for (uint32_t x = 0; x + width <= width_; x++) {
+				const uint32_t usedCount =
+				    sum(x + width, y + height) - sum(x, y + height) - sum(x + width, y) + sum(x, y);
+				if (usedCount == 0) {
+					rect = {x, y, width, height};
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void Fill(const Rect& rect) {
+		for (uint32_t y = rect.y; y < rect.y + rect.height; y++) {
+			for (uint32_t x = rect.x; x < rect.x + rect.width; x++) {
+				cells_[size_t(y) * width_ + x]++;
+			}
+		}
+	}
+
+	// 2回以上使われた画素の有無
+	bool HasOverlap() const {
+		for (uint8_t cell : cells_) {
+			if (1 < cell) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+private:
+	uint32_t width_;
+	uint32_t height_;
+	std::vector<uint8_t> cells_;
+};
+
+} // namespace
+
+TEST(FillsExactly) {
+	AtlasPacker packer(1024, 512);
+	Rect rect;
+	bool isPlaced = true;
+	for (int i = 0; i < 8; i++) {
+		isPlaced &= packer.Insert(256, 256, rect);
+		// 上の段から左詰めで並ぶ
+		isPlaced &= rect.x == uint32_t(i % 4) * 256 && rect.y == uint32_t(i / 4) * 256;
+	}
+	CHECK(isPlaced);
+	CHECK(!packer.Insert(1, 1, rect));
+	CHECK(packer.GetUsedArea() == 1024 * 512);
+	CHECK(packer.GetUsedWidth() == 1024 && packer.GetUsedHeight() == 512);
+
+	CHECK(!packer.Insert(0, 4, rect));
+	CHECK(!AtlasPacker(16, 16).Insert(17, 1, rect));
+	packer.Reset(64, 64);
+	CHECK(packer.GetUsedArea() == 0 && packer.GetUsedWidth() == 0);
+	CHECK(packer.Insert(64, 64, rect) && rect.x == 0 && rect.y == 0);
+}
+
+TEST(MatchesBruteForcePlacement) {
+	// 置ける場所があれば必ず置き、その位置は総当たりで見つかる最も上（同じなら左）と一致する
+	std::mt19937 random(1);
+	for (int trial = 0; trial < 40; trial++) {
+		const uint32_t width = 32 + random() % 48;
+		const uint32_t height = 32 + random() % 48;
+		AtlasPacker packer(width, height);
+		OccupancyGrid grid(width, height);
+		const uint32_t maxSide = 2 + random() % 20;
+		bool isSame = true;
+		for (int i = 0; i < 300; i++) {
+			const uint32_t rectWidth = 1 + random() % maxSide;
+			const uint32_t rectHeight = 1 + random() % maxSide;
+			Rect expected;
+			Rect placed;
+			const bool isFound = grid.Find(rectWidth, rectHeight, expected);
+			const bool isInserted = packer.Insert(rectWidth, rectHeight, placed);
+			isSame &= isFound == isInserted;
+			if (isFound && isInserted) {
+				isSame &= placed.x == expected.x && placed.y == expected.y;
+				isSame &= placed.width == rectWidth && placed.height == rectHeight;
+				grid.Fill(placed);
+			}
+		}
+		CHECK(isSame);
+		CHECK(!grid.HasOverlap());
+	}
+}
+
+TEST(RandomRectsStayInBoundsWithoutOverlap) {
+	std::mt19937 random(2);
+	AtlasPacker packer(2048, 2048);
+	std::vector<Rect> placed;
+	uint64_t area = 0;
+	uint32_t usedWidth = 0;
+	uint32_t usedHeight = 0;
+	for (int i = 0; i < 2000; i++) {
+		Rect rect;
+		if (packer.Insert(4 + random() % 120, 4 + random() % 120, rect)) {
+			placed.push_back(rect);
+			area += uint64_t(rect.width) * rect.height;
+			usedWidth = (std::max)(usedWidth, rect.x + rect.width);
+			usedHeight = (std::max)(usedHeight, rect.y + rect.height);
+		}
+	}
+	bool isInBounds = true;
+	bool isSeparate = true;
+	for (size_t i = 0; i < placed.size(); i++) {
+		isInBounds &= placed[i].x + placed[i].width <= 2048;
+		isInBounds &= placed[i].y + placed[i].height <= 2048;
+		for (size_t j = i + 1; j < placed.size(); j++) {
+			isSeparate &= !Intersects(placed[i], placed[j]);
+		}
+	}
+	CHECK(isInBounds);
+	CHECK(isSeparate);
+	CHECK(packer.GetUsedArea() == area);
+	CHECK(packer.GetUsedWidth() == usedWidth && packer.GetUsedHeight() == usedHeight);
+	// 入りきらなくなるまで詰めれば、ページの大半が埋まる
+	CHECK(placed.size() < 2000);
+	CHECK(0.8 < double(area) / (2048.0 * 2048.0));
+}
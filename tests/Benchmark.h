@@ -0,0 +1,46 @@
+#pragma once
+
+#include "TestFramework.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// 計測の定義と登録（EngineBenchmark で TEST と同じ仕組みで実行する）
+#define BENCHMARK(name) TEST(name)
+
+/// <summary>
+/// 処理時間の計測（repeatCount 回実行した中央値をミリ秒で返す）
+/// </summary>
+/// <param name="function">計測する処理</param>
+/// <param name="repeatCount">実行回数</param>
+/// <returns>中央値（ミリ秒）</returns>
+template<class Function> double MeasureMilliseconds(Function&& function, int repeatCount = 5) {
+	std::vector<double> times;
+	for (int i = 0; i < repeatCount; i++) {
+		const auto start = std::chrono::steady_clock::now();
+		function();
+		const auto end = std::chrono::steady_clock::now();
+		times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	std::sort(times.begin(), times.end());
+	return times[times.size() / 2];
+}
+
+/// <summary>
+/// 計測結果の表示
+/// </summary>
+/// <param name="label">項目名</param>
+/// <param name="milliseconds">処理時間（ミリ秒）</param>
+/// <param name="itemCount">処理した要素数（0なら速度を表示しない）</param>
+/// <param name="unit">要素の単位</param>
+inline void Report(const char* label, double milliseconds, double itemCount = 0.0, const char* unit = "") {
+	if (itemCount <= 0.0) {
+		std::printf("  %-44s %10.3f ms\n", label, milliseconds);
+	} else {
+		std::printf(
+		    "  %-44s %10.3f ms  %10.2f M%s/s\n", label, milliseconds,
+		    itemCount / milliseconds / 1000.0, unit);
+	}
+	std::fflush(stdout);
+}
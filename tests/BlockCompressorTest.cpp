@@ -0,0 +1,353 @@
+#include "BlockCompressor.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Format = BlockCompressor::Format;
+
+// 全形式
+const Format kFormats[] = {Format::kBC1, Format::kBC3, Format::kBC4, Format::kBC5, Format::kBC7};
+
+// 1色で塗った RGBA8 の画像
+TextureData MakeSolidTexture(uint32_t width, uint32_t height, const uint8_t color[4]) {
+	TextureData texture;
+	texture.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	for (size_t i = 0; i < texture.pixels.size(); i++) {
+		texture.pixels[i] = color[i % 4];
+	}
+	return texture;
+}
+
+// 滑らかな色の変化に細かい模様と縁を重ねた写真風の画像
+TextureData MakePhotoTexture(uint32_t width, uint32_t height) {
+	TextureData texture;
+	texture.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> noise(-6, 6);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			const float u = float(x) / float(width);
+			const float v = float(y) / float(height);
+			const float ring = std::sin(std::sqrt(u * u + v * v) * 40.0f) * 0.5f + 0.5f;
+			const float values[4] = {
+			    u * 255.0f, v * 255.0f, ring * 200.0f + 30.0f, (u + v < 1.0f ? 255.0f : 96.0f)};
+			uint8_t* pixel = texture.pixels.data() + (size_t(y) * width + x) * 4;
+			for (int c = 0; c < 4; c++) {
+				const int value = int(values[c]) + (c < 3 ? noise(random) : 0);
+				pixel[c] = uint8_t(std::clamp(value, 0, 255));
+			}
+		}
+	}
+	return texture;
+}
+
+// 仕様どおりの素朴な展開（BC1 と BC4 の補間の丸めは実装ごとに ±1 違ってよい）
+void DecodeBC1Reference(const uint8_t* data, bool isBC1, uint8_t pixels[16][4]) {
+	const uint32_t color0 = data[0] | (data[1] << 8);
+	const uint32_t color1 = data[2] | (data[3] << 8);
+	int palette[4][4];
+	const uint32_t colors[2] = {color0, color1};
+	for (int e = 0; e < 2; e++) {
+		const uint32_t r = colors[e] >> 11;
+		const uint32_t g = (colors[e] >> 5) & 63;
+		const uint32_t b = colors[e] & 31;
+		palette[e][0] = int((r << 3) | (r >> 2));
+		palette[e][1] = int((g << 2) | (g >> 4));
+		palette[e][2] = int((b << 3) | (b >> 2));
+		palette[e][3] = 255;
+	}
+	const bool isFourColor = !isBC1 || color1 < color0;
+	for (int c = 0; c < 3; c++) {
+		if (isFourColor) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = isFourColor ? 255 : 0;
+	for (int i = 0; i < 16; i++) {
+		const int index = (data[4 + i / 4] >> ((i % 4) * 2)) & 3;
+		for (int c = 0; c < 4; c++) {
+			pixels[i][c] = uint8_t(palette[index][c]);
+		}
+	}
+}
+
+void DecodeBC4Reference(const uint8_t* data, int channel, uint8_t pixels[16][4]) {
+	const int value0 = data[0];
+	const int value1 = data[1];
+	int palette[8] = {value0, value1};
+	if (value1 < value0) {
+		for (int i = 2; i < 8; i++) {
+			palette[i] = ((8 - i) * value0 + (i - 1) * value1 + 3) / 7;
+		}
+	} else {
+		for (int i = 2; i < 6; i++) {
+			palette[i] = ((6 - i) * value0 + (i - 1) * value1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	uint64_t bits = 0;
+	for (int i = 0; i < 6; i++) {
+		bits |= uint64_t(data[2 + i]) << (i * 8);
+	}
+	for (int i = 0; i < 16; i++) {
+		pixels[i][channel] = uint8_t(palette[(bits >> (i * 3)) & 7]);
+	}
+}
+
+// BC7 はモード6だけを読む（補間は仕様どおりの整数演算なので実装によらず一致する）
+bool DecodeBC7Reference(const uint8_t* data, uint8_t pixels[16][4]) {
+	uint64_t low;
+	uint64_t high;
+	std::memcpy(&low, data, 8);
+	std::memcpy(&high, data + 8, 8);
+	auto read = [&](int first, int count) {
+		uint64_t value = 0;
+		for (int i = 0; i < count; i++) {
+			const int bit = first + i;
+			value |= ((bit < 64 ? low >> bit : high >> (bit - 64)) & 1) << i;
+		}
+		return uint32_t(value);
+	};
+	if (read(0, 7) != 64) {
+		return false;
+	}
+	static const int kWeights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+	const uint32_t pBits[2] = {read(63, 1), read(64, 1)};
+	uint32_t endpoints[2][4];
+	for (int c = 0; c < 4; c++) {
+		for (int e = 0; e < 2; e++) {
+			endpoints[e][c] = (read(7 + c * 14 + e * 7, 7) << 1) | pBits[e];
+		}
+	}
+	int position = 65;
+	for (int i = 0; i < 16; i++) {
+		const int bitCount = i == 0 ? 3 : 4;
+		const uint32_t weight = kWeights[read(position, bitCount)];
+		position += bitCount;
+		for (int c = 0; c < 4; c++) {
+			pixels[i][c] =
+			    uint8_t(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+		}
+	}
+	return true;
+}
+
+// 参照の展開でレベル0を RGBA8 に戻す
+std::vector<uint8_t> DecodeReference(const TextureData& compressed) {
+	const TextureMip& mip = compressed.mips[0];
+	const uint32_t blockSize = GetBlockSize(compressed.format);
+	std::vector<uint8_t> result(size_t(mip.width) * mip.height * 4);
+	for (uint32_t blockY = 0; blockY < mip.height / 4; blockY++) {
+		for (uint32_t blockX = 0; blockX < mip.width / 4; blockX++) {
+			const uint8_t* data =
+			    compressed.GetMipPixels(0) + blockY * mip.rowPitch + blockX * blockSize;
+			uint8_t pixels[16][4] = {};
+			switch (compressed.format) {
+			case TextureFormat::kBC1Unorm:
+			case TextureFormat::kBC1UnormSrgb:
+				DecodeBC1Reference(data, true, pixels);
+				break;
+			case TextureFormat::kBC3Unorm:
+			case TextureFormat::kBC3UnormSrgb:
+				DecodeBC1Reference(data + 8, false, pixels);
+				DecodeBC4Reference(data, 3, pixels);
+				break;
+			case TextureFormat::kBC4Unorm:
+				DecodeBC4Reference(data, 0, pixels);
+				break;
+			case TextureFormat::kBC5Unorm:
+				DecodeBC4Reference(data, 0, pixels);
+				DecodeBC4Reference(data + 8, 1, pixels);
+				break;
+			default:
+				if (!DecodeBC7Reference(data, pixels)) {
+					return {};
+				}
+				break;
+			}
+			for (uint32_t i = 0; i < 16; i++) {
+				const size_t x = blockX * 4 + i % 4;
+				const size_t y = blockY * 4 + i / 4;
+				std::memcpy(result.data() + (y * mip.width + x) * 4, pixels[i], 4);
+			}
+		}
+	}
+	return result;
+}
+
+// 形式が持つ成分の数（BC4 は R、BC5 は RG、BC1 は RGB だけを比べる）
+int GetChannelCount(Format format) {
+	switch (format) {
+	case Format::kBC4:
+		return 1;
+	case Format::kBC5:
+		return 2;
+	case Format::kBC1:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+// 成分ごとの差の最大
+int MaxDifference(
+    const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int channelCount) {
+	if (a.size() != b.size()) {
+		return 256;
+	}
+	int difference = 0;
+	for (size_t i = 0; i < a.size(); i++) {
+		if (int(i % 4) < channelCount) {
+			difference = (std::max)(difference, std::abs(int(a[i]) - int(b[i])));
+		}
+	}
+	return difference;
+}
+
+// 圧縮して展開した画像の PSNR（dB）
+double GetPsnr(const TextureData& source, Format format) {
+	TextureData compressed = source;
+	BlockCompressor::Options options;
+	options.format = format;
+	BlockCompressor::Compress(compressed, options);
+	TextureData decompressed;
+	BlockCompressor::Decompress(compressed, decompressed);
+	const int channelCount = GetChannelCount(format);
+	double squaredError = 0.0;
+	for (size_t i = 0; i < source.pixels.size(); i++) {
+		if (int(i % 4) < channelCount) {
+			const double difference = double(source.pixels[i]) - double(decompressed.pixels[i]);
+			squaredError += difference * difference;
+		}
+	}
+	const double meanSquaredError =
+	    squaredError / (double(source.pixels.size() / 4) * double(channelCount));
+	return 10.0 * std::log10(255.0 * 255.0 / (std::max)(meanSquaredError, 1e-6));
+}
+
+} // namespace
+
+TEST(CompressedLayout) {
+	TextureData texture = MakePhotoTexture(64, 32);
+	// 16x8 と 4x4 のミップを足す（中身は問わない）
+	texture.mips.push_back({texture.pixels.size(), 16, 8, 64, 512});
+	texture.mips.push_back({texture.pixels.size() + 512, 4, 4, 16, 64});
+	texture.pixels.resize(texture.pixels.size() + 576);
+	CHECK(BlockCompressor::Compress(texture));
+	CHECK(texture.format == TextureFormat::kBC7Unorm);
+	CHECK(texture.GetMipCount() == 3);
+	CHECK(texture.mips[0].rowPitch == 16 * 16 && texture.mips[0].slicePitch == 16 * 16 * 8);
+	CHECK(texture.mips[1].offset == 16 * 16 * 8 && texture.mips[1].slicePitch == 16 * 4 * 2);
+	CHECK(texture.mips[2].width == 4 && texture.mips[2].slicePitch == 16);
+	CHECK(texture.pixels.size() == 16 * (128 + 8 + 1));
+
+	// sRGB は sRGB の圧縮形式になる
+	TextureData srgb = MakePhotoTexture(8, 8);
+	srgb.format = TextureFormat::kR8G8B8A8UnormSrgb;
+	BlockCompressor::Options options;
+	options.format = Format::kBC1;
+	CHECK(BlockCompressor::Compress(srgb, options));
+	CHECK(srgb.format == TextureFormat::kBC1UnormSrgb && srgb.pixels.size() == 32);
+}
+
+TEST(UnsupportedTexturesAreLeftAlone) {
+	// レベル0が4の倍数でない
+	TextureData odd = MakePhotoTexture(10, 8);
+	const std::vector<uint8_t> pixels = odd.pixels;
+	CHECK(!BlockCompressor::Compress(odd));
+	CHECK(odd.format == TextureFormat::kR8G8B8A8Unorm && odd.pixels == pixels);
+	// 圧縮済み
+	TextureData compressed = MakePhotoTexture(8, 8);
+	CHECK(BlockCompressor::Compress(compressed));
+	CHECK(!BlockCompressor::Compress(compressed));
+	TextureData decompressed;
+	CHECK(!BlockCompressor::Decompress(odd, decompressed));
+}
+
+TEST(SolidBlocksRoundTripExactly) {
+	std::mt19937 random(2);
+	for (int i = 0; i < 200; i++) {
+		uint8_t color[4];
+		for (uint8_t& value : color) {
+			value = uint8_t(random());
+		}
+		// 565 と BC7 の端点（7bit + 共通の pビット）でちょうど表せる色にそろえる
+		uint8_t exact[4];
+		exact[0] = uint8_t((color[0] & 0xF8) | (color[0] >> 5));
+		exact[1] = uint8_t((color[1] & 0xFC) | (color[1] >> 6));
+		exact[2] = uint8_t((color[2] & 0xF8) | (color[2] >> 5));
+		exact[3] = color[3];
+		const bool isSameParity = (exact[0] & 1) == (exact[1] & 1) &&
+		                          (exact[0] & 1) == (exact[2] & 1) &&
+		                          (exact[0] & 1) == (exact[3] & 1);
+		for (Format format : kFormats) {
+			const int channelCount = GetChannelCount(format);
+			TextureData compressed = MakeSolidTexture(8, 4, exact);
+			const std::vector<uint8_t> source = compressed.pixels;
+			BlockCompressor::Options options;
+			options.format = format;
+			CHECK(BlockCompressor::Compress(compressed, options));
+			const int difference = MaxDifference(DecodeReference(compressed), source, channelCount);
+			// BC7 のモード6は成分の偶奇がそろわない色をちょうどには表せない
+			CHECK(difference == 0 || (format == Format::kBC7 && !isSameParity && difference <= 1));
+		}
+		// 任意の値でも BC4 / BC5 の1成分はちょうどになる
+		TextureData single = MakeSolidTexture(4, 4, color);
+		BlockCompressor::Options options;
+		options.format = Format::kBC5;
+		BlockCompressor::Compress(single, options);
+		const std::vector<uint8_t> expected = MakeSolidTexture(4, 4, color).pixels;
+		CHECK(MaxDifference(DecodeReference(single), expected, 2) == 0);
+	}
+}
+
+TEST(DecompressMatchesReferenceDecoder) {
+	const TextureData source = MakePhotoTexture(64, 64);
+	for (Format format : kFormats) {
+		TextureData compressed = source;
+		BlockCompressor::Options options;
+		options.format = format;
+		CHECK(BlockCompressor::Compress(compressed, options));
+		TextureData decompressed;
+		CHECK(BlockCompressor::Decompress(compressed, decompressed));
+		const std::vector<uint8_t> expected = DecodeReference(compressed);
+		const int channelCount = GetChannelCount(format);
+		const int difference = MaxDifference(decompressed.pixels, expected, channelCount);
+		// BC7 の補間は整数で決まる
+		CHECK(format == Format::kBC7 ? difference == 0 : difference <= 1);
+	}
+}
+
+TEST(BgraIsSwizzled) {
+	const uint8_t bgra[4] = {10, 128, 250, 255};
+	TextureData texture = MakeSolidTexture(4, 4, bgra);
+	texture.format = TextureFormat::kB8G8R8A8Unorm;
+	CHECK(BlockCompressor::Compress(texture));
+	TextureData decompressed;
+	BlockCompressor::Decompress(texture, decompressed);
+	CHECK(std::abs(int(decompressed.pixels[0]) - 250) <= 1);
+	CHECK(std::abs(int(decompressed.pixels[2]) - 10) <= 1);
+}
+
+TEST(QualityStaysAboveThresholds) {
+	const TextureData source = MakePhotoTexture(256, 256);
+	CHECK(38.0 < GetPsnr(source, Format::kBC7));
+	CHECK(34.0 < GetPsnr(source, Format::kBC1));
+	CHECK(35.0 < GetPsnr(source, Format::kBC3));
+	CHECK(48.0 < GetPsnr(source, Format::kBC4));
+	CHECK(48.0 < GetPsnr(source, Format::kBC5));
+	// BC7 は BC1 より高画質
+	CHECK(GetPsnr(source, Format::kBC1) + 2.0 < GetPsnr(source, Format::kBC7));
+}
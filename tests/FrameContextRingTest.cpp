@@ -0,0 +1,165 @@
+#include "FrameContextRing.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+// シグナルされた値を順に積み、GpuFinishOne か Wait で1つずつ完了させる偽物の GPU
+class FakeFence : public FrameFence {
+public:
+	explicit FakeFence(uint64_t initialValue = 0) : completedValue_(initialValue) {}
+
+	void Signal(uint64_t value) override {
+		isIncreasing_ &= pending_.empty() ? completedValue_ < value : pending_.back() < value;
+		pending_.push_back(value);
+	}
+
+	uint64_t GetCompletedValue() const override { return completedValue_; }
+
+	void Wait(uint64_t value) override {
+		waits_.push_back(value);
+		while (completedValue_ < value && !pending_.empty()) {
+			GpuFinishOne();
+		}
+	}
+
+	// 一番古い提出を完了させる（無ければ何もしない）
+	void GpuFinishOne() {
+		if (pending_.empty()) {
+			return;
+		}
+		completedValue_ = pending_.front();
+		pending_.pop_front();
+		if (onComplete_) {
+			onComplete_(completedValue_);
+		}
+	}
+
+	size_t GetPendingCount() const { return pending_.size(); }
+	const std::vector<uint64_t>& GetWaits() const { return waits_; }
+	bool IsIncreasing() const { return isIncreasing_; }
+	void SetOnComplete(std::function<void(uint64_t)> onComplete) { onComplete_ = onComplete; }
+
+private:
+	uint64_t completedValue_;
+	std::deque<uint64_t> pending_;
+	std::vector<uint64_t> waits_;
+	bool isIncreasing_ = true;
+	std::function<void(uint64_t)> onComplete_;
+};
+
+} // namespace
+
+TEST(SlowGpuKeepsOneFrameLessThanContextCountInFlight) {
+	for (uint32_t contextCount = 1; contextCount <= FrameContextRing::kMaxContextCount;
+	     contextCount++) {
+		// GPU は待たれるまで何も終えないので、フレーム k は k - contextCount の完了を待つ
+		FakeFence fence;
+		FrameContextRing ring;
+		ring.Initialize(&fence, contextCount);
+		CHECK(ring.GetContextIndex() == 0 && ring.GetContextCount() == contextCount);
+		std::vector<uint64_t> lastValues(contextCount, 0);
+		bool isRotated = true;
+		bool isReusedAfterCompletion = true;
+		bool isPipelined = true;
+		for (uint64_t frame = 0; frame < 50; frame++) {
+			const uint32_t index = ring.GetContextIndex();
+			isRotated &= index == frame % contextCount;
+			const uint64_t value = ring.EndFrame();
+			isRotated &= value == frame + 1;
+			lastValues[index] = value;
+			const uint32_t next = ring.BeginFrame();
+			isRotated &= next == (frame + 1) % contextCount;
+			// 使い回すコンテキストの前のフレームは終わっている
+			isReusedAfterCompletion &= lastValues[next] <= fence.GetCompletedValue();
+			// 描画中のフレームはちょうど contextCount - 1 枚（それより少なくなるまで待たない）
+			const uint64_t inFlightCount = ring.GetLastSignaledValue() - fence.GetCompletedValue();
+			isPipelined &= inFlightCount == (std::min)(frame + 1, uint64_t(contextCount - 1));
+		}
+		CHECK(isRotated);
+		CHECK(isReusedAfterCompletion);
+		CHECK(isPipelined);
+		CHECK(ring.GetFrameCount() == 50);
+		CHECK(ring.GetWaitCount() == 50 - (contextCount - 1));
+		CHECK(fence.IsIncreasing());
+
+		ring.WaitIdle();
+		CHECK(fence.GetCompletedValue() == 50 && fence.GetPendingCount() == 0);
+	}
+}
+
+TEST(FastGpuNeverWaits) {
+	FakeFence fence;
+	FrameContextRing ring;
+	ring.Initialize(&fence, 3);
+	for (int i = 0; i < 20; i++) {
+		ring.EndFrame();
+		fence.GpuFinishOne();
+		ring.BeginFrame();
+	}
+	CHECK(ring.GetWaitCount() == 0 && fence.GetWaits().empty());
+	// 完了済みなら WaitIdle も待たない
+	ring.WaitIdle();
+	CHECK(fence.GetWaits().empty());
+}
+
+TEST(ContinuesFromExistingFenceValue) {
+	// デバイスを作り直したときなど、フェンスが0から始まらなくてもよい
+	FakeFence fence(100);
+	FrameContextRing ring;
+	ring.Initialize(&fence, 2);
+	CHECK(ring.EndFrame() == 101);
+	CHECK(ring.BeginFrame() == 1 && ring.GetWaitCount() == 0);
+	CHECK(ring.EndFrame() == 102);
+	CHECK(ring.BeginFrame() == 0);
+	CHECK(fence.GetWaits() == std::vector<uint64_t>({101}));
+	CHECK(fence.IsIncreasing());
+}
+
+TEST(PerFrameDataIsNotOverwrittenWhileInFlight) {
+	// コンテキストごとのデータ（アップロード領域の代わり）にフレーム番号を書き、
+	// GPU がそのフレームを完了したときに、まだ同じ値が残っているかを確かめる
+	std::mt19937 random(1);
+	for (uint32_t contextCount = 1; contextCount <= FrameContextRing::kMaxContextCount;
+	     contextCount++) {
+		FakeFence fence;
+		FrameContextRing ring;
+		ring.Initialize(&fence, contextCount);
+		std::vector<uint64_t> contextData(contextCount, 0);
+		// フェンス値ごとの、書いたコンテキストと値
+		std::vector<std::pair<uint32_t, uint64_t>> submitted(1);
+		bool isIntact = true;
+		fence.SetOnComplete([&](uint64_t value) {
+			isIntact &= contextData[submitted[value].first] == submitted[value].second;
+		});
+
+		uint64_t expectedWaitCount = 0;
+		for (uint64_t frame = 1; frame <= 2000; frame++) {
+			const uint32_t index = ring.GetContextIndex();
+			contextData[index] = frame;
+			submitted.push_back({index, frame});
+			ring.EndFrame();
+			// GPU の速さはフレームごとにばらつく（0～2フレーム分進む）
+			for (uint32_t count = random() % 3; 0 < count; count--) {
+				fence.GpuFinishOne();
+			}
+			// 使い回す番号の前のフレームが終わっていなければ待つはず
+			const uint64_t reusedValue = contextCount <= frame ? frame + 1 - contextCount : 0;
+			if (reusedValue != 0 && fence.GetCompletedValue() < reusedValue) {
+				expectedWaitCount++;
+			}
+			ring.BeginFrame();
+		}
+		if (fence.GetCompletedValue() < ring.GetLastSignaledValue()) {
+			expectedWaitCount++;
+		}
+		ring.WaitIdle();
+		CHECK(isIntact);
+		CHECK(ring.GetWaitCount() == expectedWaitCount);
+		CHECK(fence.GetCompletedValue() == 2000);
+	}
+}
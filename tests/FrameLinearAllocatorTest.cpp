@@ -0,0 +1,176 @@
+#include "FrameLinearAllocator.h"
+#include "TestFramework.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+const size_t kInvalidOffset = FrameLinearAllocator::kInvalidOffset;
+
+// 定数バッファの境界
+const size_t kAlignment = 256;
+
+// 16バイト単位で、どのフレーム（フェンス値）が使っているかを記録する基準
+class OccupancyMap {
+public:
+	explicit OccupancyMap(size_t capacity) : owners_(capacity / kUnitSize, 0) {}
+
+	// 完了していないフレームの領域と重ならなければ記録する
+	bool Mark(size_t offset, size_t size, uint64_t fenceValue, uint64_t completedValue) {
+		bool isFree = true;
+		for (size_t unit = offset / kUnitSize; unit < (offset + size + kUnitSize - 1) / kUnitSize;
+		     unit++) {
+			isFree &= owners_[unit] <= completedValue;
+			owners_[unit] = fenceValue;
+		}
+		return isFree;
+	}
+
+private:
+	static const size_t kUnitSize = 16;
+	// 0 は未使用
+	std::vector<uint64_t> owners_;
+};
+
+} // namespace
+
+TEST(WrapsAndReclaimsInFenceOrder) {
+	FrameLinearAllocator allocator;
+	allocator.Initialize(4096);
+	CHECK(allocator.Allocate(1, kAlignment) == 0);
+	CHECK(allocator.Allocate(10, kAlignment) == 256);
+	CHECK(allocator.Allocate(256, kAlignment) == 512);
+	allocator.EndFrame(1);
+	CHECK(allocator.Allocate(3000, kAlignment) == 768);
+	allocator.EndFrame(2);
+	CHECK(allocator.GetUsedSize() == 3768 && allocator.GetPendingFrameCount() == 2);
+
+	// 末尾の 256 バイトには入らず、先頭へ回るとフレーム1の領域に重なる
+	CHECK(allocator.Allocate(512, kAlignment) == kInvalidOffset);
+	allocator.Reclaim(1);
+	CHECK(allocator.GetPendingFrameCount() == 1);
+	CHECK(allocator.Allocate(512, kAlignment) == 0);
+	// フレーム2の先頭（768）までしか使えない
+	CHECK(allocator.Allocate(512, kAlignment) == kInvalidOffset);
+	CHECK(allocator.Allocate(256, kAlignment) == 512);
+	allocator.EndFrame(3);
+
+	// 完了していないフェンス値では解放しない
+	allocator.Reclaim(0);
+	CHECK(allocator.GetPendingFrameCount() == 2);
+	allocator.Reclaim(3);
+	CHECK(allocator.GetUsedSize() == 0 && allocator.GetPendingFrameCount() == 0);
+	// 空いても位置は戻らず、続きから確保する
+	CHECK(allocator.Allocate(3328, kAlignment) == 768);
+
+	// 全体より大きいものと、初期化前
+	FrameLinearAllocator full;
+	full.Initialize(4096);
+	CHECK(full.Allocate(4096, kAlignment) == 0);
+	CHECK(full.Allocate(1, kAlignment) == kInvalidOffset);
+	CHECK(full.Allocate(4097, kAlignment) == kInvalidOffset);
+	CHECK(FrameLinearAllocator().Allocate(16, kAlignment) == kInvalidOffset);
+}
+
+TEST(SimulatedFramesNeverTouchMemoryInFlight) {
+	// 最大3フレームを描画中にし、GPU の進み具合はフレームごとにばらつかせる
+	const size_t capacity = size_t(1) << 20;
+	FrameLinearAllocator allocator;
+	allocator.Initialize(capacity);
+	OccupancyMap occupancy(capacity);
+	std::mt19937 random(1);
+	uint64_t fenceValue = 0;
+	uint64_t completedValue = 0;
+	bool isAligned = true;
+	bool isInBounds = true;
+	bool isSeparate = true;
+	bool isFailureJustified = true;
+	size_t allocationCount = 0;
+	size_t failureCount = 0;
+	size_t wrapCount = 0;
+	size_t previousOffset = 0;
+	for (int frame = 0; frame < 5000; frame++) {
+		// 時々たくさん使うフレームを混ぜて、空きが足りなくなる場面を作る
+		const int count = int(random() % (frame % 50 == 49 ? 800 : 200));
+		for (int i = 0; i < count; i++) {
+			const size_t size = 1 + random() % 2000;
+			const size_t alignment = random() % 4 == 0 ? 16 : kAlignment;
+			const size_t offset = allocator.Allocate(size, alignment);
+			if (offset == kInvalidOffset) {
+				// 先頭へ回って捨てる分と境界合わせの分を除いても足りないときだけ失敗する
+				isFailureJustified &= capacity < allocator.GetUsedSize() + size * 2 + alignment;
+				failureCount++;
+				continue;
+			}
+			isAligned &= offset % alignment == 0;
+			isInBounds &= offset + size <= capacity;
+			isSeparate &= occupancy.Mark(offset, size, fenceValue + 1, completedValue);
+			wrapCount += offset < previousOffset ? 1 : 0;
+			previousOffset = offset;
+			allocationCount++;
+		}
+		allocator.EndFrame(++fenceValue);
+		const uint64_t lag = random() % 3;
+		completedValue = (std::max)(completedValue, fenceValue < lag ? 0 : fenceValue - lag);
+		allocator.Reclaim(completedValue);
+		isInBounds &= allocator.GetUsedSize() <= capacity;
+	}
+	CHECK(isAligned);
+	CHECK(isInBounds);
+	CHECK(isSeparate);
+	CHECK(isFailureJustified);
+	// 何周もして、空きが足りない場面もあった
+	CHECK(100 < wrapCount);
+	CHECK(0 < failureCount && failureCount < allocationCount / 100);
+
+	allocator.Reclaim(fenceValue);
+	CHECK(allocator.GetUsedSize() == 0 && allocator.GetPendingFrameCount() == 0);
+}
+
+TEST(ConcurrentAllocationsAreDisjoint) {
+	const size_t count = 100000;
+	FrameLinearAllocator allocator;
+	allocator.Initialize(count * kAlignment);
+	std::vector<size_t> offsets(count);
+	ThreadPool::GetInstance()->ParallelFor(count, 64, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			offsets[i] = allocator.Allocate(100, kAlignment);
+		}
+	});
+	// ちょうど埋まり、どれも別の 256 バイト
+	std::sort(offsets.begin(), offsets.end());
+	bool isDisjoint = true;
+	for (size_t i = 0; i < count; i++) {
+		isDisjoint &= offsets[i] == i * kAlignment;
+	}
+	CHECK(isDisjoint);
+	CHECK(allocator.Allocate(1, kAlignment) == kInvalidOffset);
+
+	// 取り合いの途中で空きが尽きても、成功した分は重ならない
+	allocator.EndFrame(1);
+	allocator.Reclaim(1);
+	std::vector<size_t> sizes(count);
+	for (size_t i = 0; i < count; i++) {
+		sizes[i] = 1 + (i * 7919) % 600;
+	}
+	ThreadPool::GetInstance()->ParallelFor(count, 64, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			offsets[i] = allocator.Allocate(sizes[i], kAlignment);
+		}
+	});
+	std::vector<std::pair<size_t, size_t>> ranges;
+	for (size_t i = 0; i < count; i++) {
+		if (offsets[i] != kInvalidOffset) {
+			ranges.push_back({offsets[i], offsets[i] + sizes[i]});
+		}
+	}
+	std::sort(ranges.begin(), ranges.end());
+	CHECK(!ranges.empty() && ranges.size() < count);
+	bool isSeparate = ranges.back().second <= count * kAlignment;
+	for (size_t i = 1; i < ranges.size(); i++) {
+		isSeparate &= ranges[i - 1].second <= ranges[i].first;
+	}
+	CHECK(isSeparate);
+}
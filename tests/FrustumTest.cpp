@@ -0,0 +1,111 @@
+#include "Frustum.h"
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 原点から +Z を向き、上下左右 90 度、近クリップ 1、遠クリップ 100 のカメラ
+Frustum MakeTestFrustum(const Vector3& eye = {0.0f, 0.0f, 0.0f}) {
+	const Matrix4x4 view =
+	    MakeLookAtMatrix(eye, {eye.x, eye.y, eye.z + 1.0f}, {0.0f, 1.0f, 0.0f});
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(1.5707964f, 1.0f, 1.0f, 100.0f);
+	return Frustum::FromMatrices(view, projection);
+}
+
+// 乱数の境界球の配列（判定の境目を跨ぐ範囲に散らす）
+std::vector<Sphere> MakeRandomSpheres(size_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+	std::uniform_real_distribution<float> radius(0.0f, 8.0f);
+	std::vector<Sphere> spheres(count);
+	for (Sphere& sphere : spheres) {
+		sphere = {{position(random), position(random), position(random)}, radius(random)};
+	}
+	return spheres;
+}
+
+} // namespace
+
+TEST(SpheresAgainstKnownCamera) {
+	const Frustum frustum = MakeTestFrustum();
+	CHECK(frustum.Intersects(Sphere{{0.0f, 0.0f, 50.0f}, 1.0f}));
+	// 背後・近クリップ面の手前・遠クリップ面の奥
+	CHECK(!frustum.Intersects(Sphere{{0.0f, 0.0f, -5.0f}, 1.0f}));
+	CHECK(!frustum.Intersects(Sphere{{0.0f, 0.0f, 0.5f}, 0.1f}));
+	CHECK(!frustum.Intersects(Sphere{{0.0f, 0.0f, 150.0f}, 1.0f}));
+	// 遠クリップ面に掛かっている
+	CHECK(frustum.Intersects(Sphere{{0.0f, 0.0f, 100.5f}, 1.0f}));
+	// 右の平面 x = z からの距離は (50 - x) / √2
+	CHECK(!frustum.Intersects(Sphere{{60.0f, 0.0f, 50.0f}, 1.0f}));
+	CHECK(frustum.Intersects(Sphere{{50.5f, 0.0f, 50.0f}, 1.0f}));
+	CHECK(!frustum.Intersects(Sphere{{0.0f, -60.0f, 50.0f}, 1.0f}));
+	CHECK(frustum.Intersects(Sphere{{0.0f, -50.5f, 50.0f}, 1.0f}));
+}
+
+TEST(AABBsAgainstKnownCamera) {
+	const Frustum frustum = MakeTestFrustum();
+	CHECK(frustum.Intersects(AABB{{-1.0f, -1.0f, 10.0f}, {1.0f, 1.0f, 12.0f}}));
+	CHECK(!frustum.Intersects(AABB{{-1.0f, -1.0f, -12.0f}, {1.0f, 1.0f, -10.0f}}));
+	// 視錐台を丸ごと含む箱
+	CHECK(frustum.Intersects(AABB{{-500.0f, -500.0f, -500.0f}, {500.0f, 500.0f, 500.0f}}));
+	// 右の平面の外側と、角が少しだけ入る箱
+	CHECK(!frustum.Intersects(AABB{{52.0f, -1.0f, 49.0f}, {54.0f, 1.0f, 51.0f}}));
+	CHECK(frustum.Intersects(AABB{{48.0f, -1.0f, 49.0f}, {54.0f, 1.0f, 51.0f}}));
+}
+
+TEST(FrustumFollowsCameraPosition) {
+	const Frustum frustum = MakeTestFrustum({200.0f, 0.0f, 0.0f});
+	CHECK(!frustum.Intersects(Sphere{{0.0f, 0.0f, 50.0f}, 1.0f}));
+	CHECK(frustum.Intersects(Sphere{{200.0f, 0.0f, 50.0f}, 1.0f}));
+
+	// FromMatrix にビュー×射影を渡しても同じ平面になる
+	const Matrix4x4 view =
+	    MakeLookAtMatrix({200.0f, 0.0f, 0.0f}, {200.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f});
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(1.5707964f, 1.0f, 1.0f, 100.0f);
+	const Frustum combined = Frustum::FromMatrix(Multiply(view, projection));
+	bool isSame = true;
+	for (int i = 0; i < Frustum::kPlaneCount; i++) {
+		isSame &= std::abs(combined.planes[i].w - frustum.planes[i].w) < 1e-3f;
+	}
+	CHECK(isSame);
+}
+
+TEST(BatchedCullingMatchesSingle) {
+	const Frustum frustum = MakeTestFrustum({3.0f, -2.0f, -10.0f});
+	// SIMD の端数処理も通るよう 4 と 8 の倍数にしない
+	const size_t count = 4099;
+	const std::vector<Sphere> spheres = MakeRandomSpheres(count, 1);
+	std::vector<AABB> aabbs(count);
+	for (size_t i = 0; i < count; i++) {
+		const Vector3& c = spheres[i].center;
+		const float r = spheres[i].radius;
+		aabbs[i] = {{c.x - r, c.y - r, c.z - r}, {c.x + r * 0.5f, c.y + r, c.z + r * 2.0f}};
+	}
+
+	std::vector<uint32_t> expected;
+	std::vector<uint32_t> visible(count);
+	for (size_t i = 0; i < count; i++) {
+		if (frustum.Intersects(spheres[i])) {
+			expected.push_back(uint32_t(i));
+		}
+	}
+	size_t visibleCount = frustum.CullSpheres(spheres.data(), count, visible.data());
+	CHECK(0 < expected.size() && expected.size() < count);
+	CHECK(std::vector<uint32_t>(visible.begin(), visible.begin() + visibleCount) == expected);
+
+	expected.clear();
+	for (size_t i = 0; i < count; i++) {
+		if (frustum.Intersects(aabbs[i])) {
+			expected.push_back(uint32_t(i));
+		}
+	}
+	visibleCount = frustum.CullAABBs(aabbs.data(), count, visible.data());
+	CHECK(0 < expected.size() && expected.size() < count);
+	CHECK(std::vector<uint32_t>(visible.begin(), visible.begin() + visibleCount) == expected);
+
+	// 要素数0
+	CHECK(frustum.CullSpheres(spheres.data(), 0, visible.data()) == 0);
+}
@@ -0,0 +1,448 @@
+#include "DdsDecoder.h"
+#include "ImageDecoder.h"
+#include "Inflate.h"
+#include "JpegDecoder.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+#include "TextureCache.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// tests/tools/MakeDecoderFixtures.cpp が libpng / libjpeg / zlib で作った画像
+const std::string kFixtureDirectory = TEST_DATA_DIRECTORY "decoders/";
+
+std::vector<uint8_t> ReadBinaryFile(const std::string& filePath) {
+	std::ifstream file(filePath, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+std::vector<uint8_t> ReadFixture(const std::string& fileName) {
+	return ReadBinaryFile(kFixtureDirectory + fileName);
+}
+
+// manifest.txt の1行（種類, ファイル名, 残りの項目）
+struct ManifestEntry {
+	std::string kind;
+	std::string fileName;
+	std::vector<std::string> fields;
+};
+
+std::vector<ManifestEntry> ReadManifest(const std::string& kind) {
+	std::ifstream file(kFixtureDirectory + "manifest.txt");
+	std::vector<ManifestEntry> entries;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream stream(line);
+		ManifestEntry entry;
+		stream >> entry.kind >> entry.fileName;
+		for (std::string field; stream >> field;) {
+			entry.fields.push_back(field);
+		}
+		if (entry.kind == kind) {
+			entries.push_back(entry);
+		}
+	}
+	return entries;
+}
+
+// 生成側と同じ FNV-1a (64bit)
+std::string HashBytes(const uint8_t* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ data[i]) * 0x100000001b3ull;
+	}
+	char text[17];
+	std::snprintf(text, sizeof(text), "%016" PRIx64, hash);
+	return text;
+}
+
+uint32_t ToUInt32(const std::string& text) {
+	return uint32_t(std::strtoul(text.c_str(), nullptr, 10));
+}
+
+// DecodeInto で行の間を空けて書き込み、Decode と同じ画素になるか
+bool IsSameWithPaddedPitch(const std::vector<uint8_t>& file, const TextureData& texture) {
+	const ImageDecoder* decoder =
+	    ImageDecoderRegistry::GetInstance()->Find(file.data(), file.size());
+	ImageDecoder::ImageInfo info;
+	if (!decoder || !decoder->ReadInfo(file.data(), file.size(), info)) {
+		return false;
+	}
+	const size_t rowSize = size_t(info.width) * 4;
+	const size_t rowPitch = (rowSize + 255) & ~size_t(255);
+	std::vector<uint8_t> staging(rowPitch * info.height, 0xCD);
+	if (!decoder->DecodeInto(file.data(), file.size(), staging.data(), rowPitch)) {
+		return false;
+	}
+	bool isSame = info.format == texture.format;
+	for (uint32_t y = 0; y < info.height; y++) {
+		isSame &= std::memcmp(&staging[y * rowPitch], &texture.pixels[y * rowSize], rowSize) == 0;
+		// 行の後ろの隙間には書き込まない
+		for (size_t x = rowSize; x < rowPitch; x++) {
+			isSame &= staging[y * rowPitch + x] == 0xCD;
+		}
+	}
+	return isSame;
+}
+
+// TGA の組み立て（RLE は同じ画素が続く所を繰り返しのパケットにする）
+std::vector<uint8_t> MakeTga(
+    uint8_t imageType, uint8_t depth, bool isTopToBottom, uint32_t width, uint32_t height,
+    const std::vector<std::vector<uint8_t>>& pixels, const std::vector<uint8_t>& palette) {
+	std::vector<uint8_t> file(18, 0);
+	file[1] = palette.empty() ? 0 : 1;
+	file[2] = imageType;
+	file[6] = uint8_t(palette.size() / 3 >> 8);
+	file[5] = uint8_t(palette.size() / 3);
+	file[7] = palette.empty() ? 0 : 24;
+	file[12] = uint8_t(width);
+	file[14] = uint8_t(height);
+	file[16] = depth;
+	file[17] = uint8_t((isTopToBottom ? 0x20 : 0) | (depth == 32 ? 8 : depth == 16 ? 1 : 0));
+	file.insert(file.end(), palette.begin(), palette.end());
+	if ((imageType & 8) == 0) {
+		for (const std::vector<uint8_t>& pixel : pixels) {
+			file.insert(file.end(), pixel.begin(), pixel.end());
+		}
+		return file;
+	}
+	size_t i = 0;
+	while (i < pixels.size()) {
+		size_t run = 1;
+		while (i + run < pixels.size() && run < 128 && pixels[i + run] == pixels[i]) {
+			run++;
+		}
+		if (1 < run) {
+			file.push_back(uint8_t(0x80 | (run - 1)));
+			file.insert(file.end(), pixels[i].begin(), pixels[i].end());
+			i += run;
+			continue;
+		}
+		size_t count = 1;
+		while (i + count < pixels.size() && count < 128 &&
+		       !(i + count + 1 < pixels.size() && pixels[i + count] == pixels[i + count + 1])) {
+			count++;
+		}
+		file.push_back(uint8_t(count - 1));
+		for (size_t k = 0; k < count; k++) {
+			file.insert(file.end(), pixels[i + k].begin(), pixels[i + k].end());
+		}
+		i += count;
+	}
+	return file;
+}
+
+uint8_t Expand5(uint32_t value) { return uint8_t((value << 3) | (value >> 2)); }
+
+std::vector<uint8_t> MakeDds(const DdsDecoder::Header& header, size_t pixelSize, uint8_t fill) {
+	std::vector<uint8_t> file(4 + sizeof(header), 0);
+	const uint32_t magic = DdsDecoder::kMagic;
+	std::memcpy(file.data(), &magic, 4);
+	std::memcpy(file.data() + 4, &header, sizeof(header));
+	for (size_t i = 0; i < pixelSize; i++) {
+		file.push_back(uint8_t(fill + i));
+	}
+	return file;
+}
+
+} // namespace
+
+TEST(PngMatchesLibpngExactly) {
+	const std::vector<ManifestEntry> entries = ReadManifest("png");
+	CHECK(entries.size() == 31);
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	bool isDecoded = true;
+	bool isSame = true;
+	bool isSameInto = true;
+	for (const ManifestEntry& entry : entries) {
+		const std::vector<uint8_t> file = ReadFixture(entry.fileName);
+		TextureData texture;
+		if (!registry->Decode(file.data(), file.size(), texture)) {
+			isDecoded = false;
+			continue;
+		}
+		isSame &= texture.format == TextureFormat::kR8G8B8A8Unorm;
+		isSame &= texture.GetWidth() == ToUInt32(entry.fields[0]);
+		isSame &= texture.GetHeight() == ToUInt32(entry.fields[1]);
+		isSame &= HashBytes(texture.pixels.data(), texture.pixels.size()) == entry.fields[2];
+		isSameInto &= IsSameWithPaddedPitch(file, texture);
+	}
+	CHECK(isDecoded);
+	CHECK(isSame);
+	CHECK(isSameInto);
+
+	// ファイルから直接
+	TextureData texture;
+	CHECK(registry->DecodeFile(kFixtureDirectory + "rgba8_paeth.png", texture));
+	CHECK(texture.GetWidth() == 33 && texture.GetHeight() == 17);
+	CHECK(!registry->DecodeFile(kFixtureDirectory + "missing.png", texture));
+}
+
+TEST(JpegMatchesLibjpegWithinOne) {
+	// libjpeg の浮動小数点 IDCT（補間なしの色差の拡大）との差は各チャンネル ±1 まで
+	const std::vector<ManifestEntry> entries = ReadManifest("jpeg");
+	CHECK(entries.size() == 7);
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	bool isDecoded = true;
+	bool isClose = true;
+	bool isSameInto = true;
+	for (const ManifestEntry& entry : entries) {
+		const std::vector<uint8_t> file = ReadFixture(entry.fileName);
+		const std::vector<uint8_t> expected = ReadFixture(entry.fields[2]);
+		TextureData texture;
+		if (!registry->Decode(file.data(), file.size(), texture)) {
+			isDecoded = false;
+			continue;
+		}
+		isClose &= texture.format == TextureFormat::kR8G8B8A8Unorm;
+		isClose &= texture.GetWidth() == ToUInt32(entry.fields[0]);
+		isClose &= texture.GetHeight() == ToUInt32(entry.fields[1]);
+		isClose &= texture.pixels.size() == expected.size();
+		for (size_t i = 0; i < expected.size() && i < texture.pixels.size(); i++) {
+			isClose &= std::abs(int(texture.pixels[i]) - int(expected[i])) <= 1;
+		}
+		isSameInto &= IsSameWithPaddedPitch(file, texture);
+	}
+	CHECK(isDecoded);
+	CHECK(isClose);
+	CHECK(isSameInto);
+
+	// プログレッシブは JPEG とは認めるが、読めないので他の手段に任せる
+	for (const ManifestEntry& entry : ReadManifest("reject")) {
+		const std::vector<uint8_t> file = ReadFixture(entry.fileName);
+		JpegDecoder decoder;
+		ImageDecoder::ImageInfo info;
+		TextureData texture;
+		CHECK(decoder.CanDecode(file.data(), file.size()));
+		CHECK(!decoder.ReadInfo(file.data(), file.size(), info));
+		CHECK(!registry->Decode(file.data(), file.size(), texture));
+	}
+}
+
+TEST(InflateMatchesZlib) {
+	const std::vector<ManifestEntry> entries = ReadManifest("zlib");
+	CHECK(entries.size() == 5);
+	bool isSame = true;
+	bool isRejected = true;
+	for (const ManifestEntry& entry : entries) {
+		const std::vector<uint8_t> file = ReadFixture(entry.fileName);
+		const size_t size = std::strtoul(entry.fields[0].c_str(), nullptr, 10);
+		std::vector<uint8_t> output(size);
+		isSame &= Inflate::DecompressZlib(file.data(), file.size(), output.data(), size);
+		isSame &= HashBytes(output.data(), size) == entry.fields[1];
+		// 展開先が足りない、途中で切れている
+		isRejected &= !Inflate::DecompressZlib(file.data(), file.size(), output.data(), size - 1);
+		isRejected &= !Inflate::DecompressZlib(file.data(), file.size() - 1, output.data(), size);
+	}
+	CHECK(isSame);
+	CHECK(isRejected);
+
+	// 非圧縮ブロックを3つ並べた生の deflate（1ブロックは 65535 バイトまで）
+	std::vector<uint8_t> expected(65535 * 2 + 100);
+	for (size_t i = 0; i < expected.size(); i++) {
+		expected[i] = uint8_t(i * 131 >> 3);
+	}
+	std::vector<uint8_t> stream;
+	for (size_t offset = 0; offset < expected.size(); offset += 65535) {
+		const size_t length = (std::min)(expected.size() - offset, size_t(65535));
+		stream.push_back(offset + length == expected.size() ? 1 : 0);
+		const uint16_t lengths[2] = {uint16_t(length), uint16_t(~length)};
+		for (uint16_t value : lengths) {
+			stream.push_back(uint8_t(value));
+			stream.push_back(uint8_t(value >> 8));
+		}
+		stream.insert(stream.end(), expected.begin() + offset, expected.begin() + offset + length);
+	}
+	std::vector<uint8_t> output(expected.size() + 10);
+	size_t writtenSize = 0;
+	CHECK(Inflate::Decompress(stream.data(), stream.size(), output.data(), output.size(),
+	                          writtenSize));
+	CHECK(writtenSize == expected.size());
+	CHECK(std::equal(expected.begin(), expected.end(), output.begin()));
+	// 長さの補数が合わない
+	stream[3] ^= 1;
+	CHECK(!Inflate::Decompress(stream.data(), stream.size(), output.data(), output.size(),
+	                           writtenSize));
+}
+
+TEST(TgaVariantsDecode) {
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	const uint32_t width = 13;
+	const uint32_t height = 7;
+	bool isSame = true;
+	bool isTruncationRejected = true;
+	int caseCount = 0;
+	for (uint8_t imageType : {1, 2, 3, 9, 10, 11}) {
+		for (uint8_t depth : {8, 16, 24, 32}) {
+			const bool isColorMapped = (imageType & 7) == 1;
+			const bool isGrayscale = (imageType & 7) == 3;
+			if ((isColorMapped || isGrayscale) != (depth == 8)) {
+				continue;
+			}
+			std::vector<uint8_t> palette;
+			if (isColorMapped) {
+				for (int i = 0; i < 256; i++) {
+					const uint8_t entry[3] = {uint8_t(i), uint8_t(255 - i), uint8_t(i * 3)};
+					palette.insert(palette.end(), entry, entry + 3);
+				}
+			}
+			for (bool isTopToBottom : {false, true}) {
+				// 4画素ごとに、同じ画素の並びとばらばらの画素を交互に置く
+				std::mt19937 random(depth + imageType);
+				std::vector<std::vector<uint8_t>> pixels;
+				std::vector<uint8_t> expected(width * height * 4);
+				for (uint32_t i = 0; i < width * height; i++) {
+					std::vector<uint8_t> pixel(depth / 8);
+					for (size_t k = 0; k < pixel.size(); k++) {
+						pixel[k] = (i / 4) % 2 == 0 ? uint8_t(i / 4 * 29 + k) : uint8_t(random());
+					}
+					pixels.push_back(pixel);
+					const uint32_t y = isTopToBottom ? i / width : height - 1 - i / width;
+					uint8_t* bgra = &expected[(y * width + i % width) * 4];
+					if (isColorMapped) {
+						std::memcpy(bgra, &palette[pixel[0] * 3], 3);
+						bgra[3] = 255;
+					} else if (isGrayscale) {
+						bgra[0] = bgra[1] = bgra[2] = pixel[0];
+						bgra[3] = 255;
+					} else if (depth == 16) {
+						const uint32_t value = pixel[0] | (pixel[1] << 8);
+						bgra[0] = Expand5(value & 31);
+						bgra[1] = Expand5((value >> 5) & 31);
+						bgra[2] = Expand5((value >> 10) & 31);
+						bgra[3] = (value & 0x8000) ? 255 : 0;
+					} else {
+						std::memcpy(bgra, pixel.data(), 3);
+						bgra[3] = depth == 32 ? pixel[3] : 255;
+					}
+				}
+				const std::vector<uint8_t> file =
+				    MakeTga(imageType, depth, isTopToBottom, width, height, pixels, palette);
+				TextureData texture;
+				isSame &= registry->Decode(file.data(), file.size(), texture);
+				isSame &= texture.format == TextureFormat::kB8G8R8A8Unorm;
+				isSame &= texture.pixels == expected;
+				isTruncationRejected &= !registry->Decode(file.data(), file.size() - 1, texture);
+				caseCount++;
+			}
+		}
+	}
+	CHECK(caseCount == 20);
+	CHECK(isSame);
+	CHECK(isTruncationRejected);
+}
+
+TEST(DdsLayoutsDecode) {
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+
+	// DX10 ヘッダの BC7 とミップは、キャッシュの書き出しを読み戻す
+	TextureData source;
+	source.format = TextureFormat::kBC7Unorm;
+	size_t offset = 0;
+	for (uint32_t level = 0; level < 7; level++) {
+		TextureMip mip;
+		CHECK(DdsDecoder::ComputeMip(
+		    source.format, (std::max)(64u >> level, 1u), (std::max)(32u >> level, 1u), mip));
+		mip.offset = offset;
+		offset += mip.slicePitch;
+		source.mips.push_back(mip);
+	}
+	source.pixels.resize(offset);
+	for (size_t i = 0; i < offset; i++) {
+		source.pixels[i] = uint8_t(i * 7);
+	}
+	const std::filesystem::path directory = MakeTemporaryDirectory("ImageDecoderTest");
+	const std::string path = (directory / "bc7.dds").string();
+	CHECK(TextureCache::WriteDds(path, 0x1122334455667788ull, source));
+	std::vector<uint8_t> file = ReadBinaryFile(path);
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	TextureData texture;
+	CHECK(registry->Decode(file.data(), file.size(), texture));
+	CHECK(texture.format == source.format && texture.GetMipCount() == 7);
+	CHECK(texture.pixels == source.pixels);
+	uint64_t key = 0;
+	CHECK(TextureCache::ReadDds(file.data(), file.size(), texture, key));
+	CHECK(key == 0x1122334455667788ull && texture.pixels == source.pixels);
+	file.pop_back();
+	CHECK(!registry->Decode(file.data(), file.size(), texture));
+
+	// 旧形式の DXT1
+	DdsDecoder::Header header = {};
+	header.size = sizeof(header);
+	header.flags = DdsDecoder::kDdsdCaps | DdsDecoder::kDdsdWidth | DdsDecoder::kDdsdHeight |
+	               DdsDecoder::kDdsdPixelFormat;
+	header.width = 8;
+	header.height = 8;
+	header.pixelFormat.size = sizeof(header.pixelFormat);
+	header.pixelFormat.flags = DdsDecoder::kDdpfFourCC;
+	header.pixelFormat.fourCC = 0x31545844; // "DXT1"
+	file = MakeDds(header, 32, 0);
+	CHECK(registry->Decode(file.data(), file.size(), texture));
+	CHECK(texture.format == TextureFormat::kBC1Unorm && texture.pixels.size() == 32);
+	CHECK(texture.pixels[31] == 31);
+
+	// アルファの無い BGRX は不透明で埋める
+	header.width = 2;
+	header.height = 2;
+	header.pixelFormat.flags = DdsDecoder::kDdpfRgb;
+	header.pixelFormat.fourCC = 0;
+	header.pixelFormat.rgbBitCount = 32;
+	header.pixelFormat.rBitMask = 0xff0000;
+	header.pixelFormat.gBitMask = 0xff00;
+	header.pixelFormat.bBitMask = 0xff;
+	file = MakeDds(header, 16, 0x10);
+	CHECK(registry->Decode(file.data(), file.size(), texture));
+	CHECK(texture.format == TextureFormat::kB8G8R8A8Unorm);
+	CHECK(texture.pixels[0] == 0x10 && texture.pixels[2] == 0x12 && texture.pixels[3] == 255);
+}
+
+TEST(CorruptInputIsRejectedSafely) {
+	// 壊れたデータでも範囲外を読まずに失敗を返す（結果は問わない）
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	std::mt19937 random(1);
+	const uint8_t pngSignature[8] = {0x89, 'P', 'N', 'G', 13, 10, 26, 10};
+	const uint8_t jpegSignature[3] = {0xFF, 0xD8, 0xFF};
+	for (int i = 0; i < 2000; i++) {
+		std::vector<uint8_t> file(random() % 300);
+		for (uint8_t& value : file) {
+			value = uint8_t(random());
+		}
+		if (i % 3 == 0 && 8 <= file.size()) {
+			std::memcpy(file.data(), pngSignature, 8);
+		} else if (i % 3 == 1 && 3 <= file.size()) {
+			std::memcpy(file.data(), jpegSignature, 3);
+		}
+		TextureData texture;
+		registry->Decode(file.data(), file.size(), texture);
+	}
+
+	int truncatedCount = 0;
+	const char* fileNames[] = {"rgba8_adam7.png", "rgb16.png", "ycc420.jpg", "ycc422_restart.jpg"};
+	for (const char* fileName : fileNames) {
+		const std::vector<uint8_t> original = ReadFixture(fileName);
+		for (int i = 0; i < 50; i++) {
+			std::vector<uint8_t> file = original;
+			for (int k = 0; k < 5; k++) {
+				file[random() % file.size()] ^= uint8_t(1 << (random() % 8));
+			}
+			TextureData texture;
+			registry->Decode(file.data(), file.size(), texture);
+			// 途中で切れたものは必ず失敗する
+			file = original;
+			file.resize(random() % file.size());
+			truncatedCount += registry->Decode(file.data(), file.size(), texture) ? 0 : 1;
+		}
+	}
+	CHECK(truncatedCount == 200);
+}
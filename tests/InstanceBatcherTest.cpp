@@ -0,0 +1,81 @@
+#include "InstanceBatcher.h"
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include <random>
+
+namespace {
+
+// 何番目の要求かを平行移動の x に入れた行列
+Matrix4x4 MakeTaggedMatrix(uint32_t tag) {
+	return MakeTranslationMatrix({float(tag), 0.0f, 0.0f});
+}
+
+uint32_t GetTag(const InstanceData& instance) { return uint32_t(instance.world.m[3][0]); }
+
+} // namespace
+
+TEST(BatchesAreSortedAndStable) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint32_t> keyDistribution(0, 20);
+	InstanceBatcher batcher;
+	// 並列に詰める単位より多くする
+	const uint32_t requestCount = 10007;
+	std::vector<uint32_t> keys(requestCount);
+	for (uint32_t i = 0; i < requestCount; i++) {
+		keys[i] = keyDistribution(random) * 3;
+		batcher.Add(keys[i], MakeTaggedMatrix(i));
+	}
+	CHECK(batcher.GetRequestCount() == requestCount);
+	batcher.Build();
+
+	const auto batches = batcher.GetBatches();
+	const auto instances = batcher.GetInstances();
+	CHECK(instances.size() == requestCount);
+	uint32_t nextInstance = 0;
+	bool isValid = true;
+	for (size_t i = 0; i < batches.size(); i++) {
+		const InstanceBatcher::Batch& batch = batches[i];
+		// 番号の昇順、重複なし、隙間なく並ぶ
+		isValid &= i == 0 || batches[i - 1].key < batch.key;
+		isValid &= batch.firstInstance == nextInstance && batch.instanceCount != 0;
+		nextInstance += batch.instanceCount;
+		// 同じ番号の中では追加した順
+		uint32_t previousTag = 0;
+		for (uint32_t j = batch.firstInstance; j < batch.firstInstance + batch.instanceCount; j++) {
+			const uint32_t tag = GetTag(instances[j]);
+			isValid &= keys[tag] == batch.key;
+			isValid &= j == batch.firstInstance || previousTag < tag;
+			previousTag = tag;
+		}
+	}
+	CHECK(isValid);
+	CHECK(nextInstance == requestCount);
+	CHECK(batches.size() == 21);
+}
+
+TEST(SpanAddAndClear) {
+	InstanceBatcher batcher;
+	std::vector<Matrix4x4> worlds;
+	for (uint32_t i = 0; i < 5; i++) {
+		worlds.push_back(MakeTaggedMatrix(i));
+	}
+	batcher.Add(7, worlds);
+	batcher.Add(2, MakeTaggedMatrix(100));
+	batcher.Add(7, std::span<const Matrix4x4>(worlds).subspan(0, 2));
+	batcher.Build();
+	CHECK(batcher.GetBatches().size() == 2);
+	CHECK(batcher.GetBatches()[0].key == 2 && batcher.GetBatches()[0].instanceCount == 1);
+	CHECK(batcher.GetBatches()[1].key == 7 && batcher.GetBatches()[1].instanceCount == 7);
+	CHECK(GetTag(batcher.GetInstances()[0]) == 100);
+	CHECK(GetTag(batcher.GetInstances()[6]) == 0);
+
+	// 空にしてから使い直す
+	batcher.Clear();
+	CHECK(batcher.GetRequestCount() == 0);
+	batcher.Build();
+	CHECK(batcher.GetBatches().empty());
+	CHECK(batcher.GetInstances().empty());
+	batcher.Add(1, MakeTaggedMatrix(3));
+	batcher.Build();
+	CHECK(batcher.GetBatches().size() == 1 && GetTag(batcher.GetInstances()[0]) == 3);
+}
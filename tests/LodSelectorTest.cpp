@@ -0,0 +1,58 @@
+#include "LodSelector.h"
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include <cmath>
+
+namespace {
+
+// LODごとの誤差（MeshSimplifier::GenerateLods の結果と同じく粗いほど大きい）
+const float kLodErrors[] = {0.0f, 0.01f, 0.05f, 0.2f};
+
+// 原点から +Z を向き、上下 90 度、高さ 1000 画素の画面
+LodSelector MakeTestSelector(float pixelThreshold) {
+	const Matrix4x4 view =
+	    MakeLookAtMatrix({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f});
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(1.5707964f, 1.0f, 0.1f, 1000.0f);
+	return LodSelector::FromMatrices(view, projection, 1000.0f, pixelThreshold);
+}
+
+} // namespace
+
+TEST(FromMatricesRecoversCamera) {
+	const Matrix4x4 view =
+	    MakeLookAtMatrix({3.0f, -4.0f, 5.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(1.5707964f, 1.0f, 0.1f, 1000.0f);
+	const LodSelector selector = LodSelector::FromMatrices(view, projection, 1000.0f);
+	CHECK(std::abs(selector.cameraPosition.x - 3.0f) < 1e-4f);
+	CHECK(std::abs(selector.cameraPosition.y + 4.0f) < 1e-4f);
+	CHECK(std::abs(selector.cameraPosition.z - 5.0f) < 1e-4f);
+	// 視野角90度では距離1の位置で画面の高さが長さ2
+	CHECK(std::abs(selector.projectionScale - 500.0f) < 1e-2f);
+	CHECK(std::abs(selector.ComputeScreenError(0.1f, 10.0f) - 5.0f) < 1e-3f);
+}
+
+TEST(SelectGetsCoarserWithDistance) {
+	const LodSelector selector = MakeTestSelector(1.0f);
+	uint32_t previousLod = 0;
+	bool isMonotonic = true;
+	for (float distance = 1.0f; distance < 1000.0f; distance *= 1.1f) {
+		const uint32_t lod = selector.Select(kLodErrors, Sphere{{0.0f, 0.0f, distance}, 0.5f});
+		isMonotonic &= previousLod <= lod;
+		previousLod = lod;
+		// 選んだLODの画面上の誤差は閾値以内
+		isMonotonic &= selector.ComputeScreenError(kLodErrors[lod], distance - 0.5f) <= 1.0f;
+	}
+	CHECK(isMonotonic);
+	CHECK(previousLod == 3);
+	CHECK(selector.Select(kLodErrors, Sphere{{0.0f, 0.0f, 2.0f}, 0.5f}) == 0);
+
+	// 境界球の中に視点があっても最も詳細なLOD
+	CHECK(selector.Select(kLodErrors, Sphere{{0.0f, 0.0f, 0.0f}, 50.0f}) == 0);
+	// 拡大したモデルは誤差も大きい
+	const Sphere sphere = {{0.0f, 0.0f, 60.0f}, 0.5f};
+	CHECK(selector.Select(kLodErrors, sphere, 4.0f) < selector.Select(kLodErrors, sphere));
+	// LODが1つなら常に0
+	CHECK(selector.Select(std::span<const float>(kLodErrors, 1), sphere) == 0);
+	// 閾値を緩めると粗くなる
+	CHECK(selector.Select(kLodErrors, sphere) <= MakeTestSelector(8.0f).Select(kLodErrors, sphere));
+}
@@ -0,0 +1,167 @@
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 素朴な行列の積（SIMD経路と比べる基準）
+Matrix4x4 MultiplyReference(const Matrix4x4& m1, const Matrix4x4& m2) {
+	Matrix4x4 result{};
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			double sum = 0.0;
+			for (int k = 0; k < 4; k++) {
+				sum += double(m1.m[i][k]) * double(m2.m[k][j]);
+			}
+			result.m[i][j] = float(sum);
+		}
+	}
+	return result;
+}
+
+// 要素ごとの差の最大
+float MaxDifference(const Matrix4x4& m1, const Matrix4x4& m2) {
+	float difference = 0.0f;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			difference = (std::max)(difference, std::abs(m1.m[i][j] - m2.m[i][j]));
+		}
+	}
+	return difference;
+}
+
+float MaxDifference(const Vector3& v1, const Vector3& v2) {
+	return (std::max)(
+	    {std::abs(v1.x - v2.x), std::abs(v1.y - v2.y), std::abs(v1.z - v2.z)});
+}
+
+// 乱数のアフィン行列
+Matrix4x4 MakeRandomAffine(std::mt19937& random) {
+	std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+	std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+	std::uniform_real_distribution<float> offset(-10.0f, 10.0f);
+	return MakeAffineMatrix(
+	    {scale(random), scale(random), scale(random)},
+	    {angle(random), angle(random), angle(random)},
+	    {offset(random), offset(random), offset(random)});
+}
+
+// 乱数の一般の行列
+Matrix4x4 MakeRandomMatrix(std::mt19937& random) {
+	std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+	Matrix4x4 m;
+	for (auto& row : m.m) {
+		for (float& element : row) {
+			element = value(random);
+		}
+	}
+	return m;
+}
+
+} // namespace
+
+TEST(MultiplyMatchesReference) {
+	std::mt19937 random(1);
+	for (int i = 0; i < 1000; i++) {
+		const Matrix4x4 m1 = MakeRandomMatrix(random);
+		const Matrix4x4 m2 = MakeRandomMatrix(random);
+		CHECK(MaxDifference(Multiply(m1, m2), MultiplyReference(m1, m2)) < 1e-5f);
+	}
+}
+
+TEST(TransposeSwapsRowsAndColumns) {
+	std::mt19937 random(2);
+	const Matrix4x4 m = MakeRandomMatrix(random);
+	const Matrix4x4 t = Transpose(m);
+	bool isSwapped = true;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			isSwapped &= t.m[i][j] == m.m[j][i];
+		}
+	}
+	CHECK(isSwapped);
+}
+
+TEST(InverseGivesIdentity) {
+	std::mt19937 random(3);
+	const Matrix4x4 identity = MakeIdentityMatrix();
+	for (int i = 0; i < 1000; i++) {
+		const Matrix4x4 m = MakeRandomAffine(random);
+		CHECK(MaxDifference(Multiply(m, Inverse(m)), identity) < 1e-4f);
+		CHECK(MaxDifference(Multiply(m, InverseAffine(m)), identity) < 1e-4f);
+		CHECK(MaxDifference(Inverse(m), InverseAffine(m)) < 1e-4f);
+	}
+	// 射影を含む一般の行列
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 100.0f);
+	CHECK(MaxDifference(Multiply(projection, Inverse(projection)), identity) < 1e-4f);
+}
+
+TEST(BatchedTransformsMatchSingle) {
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> value(-5.0f, 5.0f);
+	const Matrix4x4 m = MakeRandomAffine(random);
+	// SIMD の端数処理も通るよう 4 と 8 の倍数にしない
+	const size_t count = 1003;
+	std::vector<Vector3> points(count);
+	for (Vector3& point : points) {
+		point = {value(random), value(random), value(random)};
+	}
+	std::vector<Vector3> transformed(count);
+	std::vector<Vector3> vectors(count);
+	TransformPoints(points.data(), transformed.data(), count, m);
+	TransformVectors(points.data(), vectors.data(), count, m);
+	float pointDifference = 0.0f;
+	float vectorDifference = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		pointDifference =
+		    (std::max)(pointDifference, MaxDifference(transformed[i], TransformPoint(points[i], m)));
+		vectorDifference =
+		    (std::max)(vectorDifference, MaxDifference(vectors[i], TransformNormal(points[i], m)));
+	}
+	CHECK(pointDifference < 1e-4f);
+	CHECK(vectorDifference < 1e-4f);
+
+	// 入力と出力が同じ配列でもよい
+	std::vector<Vector3> inPlace = points;
+	TransformPoints(inPlace.data(), inPlace.data(), count, m);
+	CHECK(MaxDifference(inPlace[count - 1], transformed[count - 1]) == 0.0f);
+
+	std::vector<Matrix4x4> matrices(count);
+	for (Matrix4x4& matrix : matrices) {
+		matrix = MakeRandomAffine(random);
+	}
+	std::vector<Matrix4x4> products(count);
+	MultiplyArray(matrices.data(), m, products.data(), count);
+	float matrixDifference = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		matrixDifference = (std::max)(
+		    matrixDifference, MaxDifference(products[i], MultiplyReference(matrices[i], m)));
+	}
+	CHECK(matrixDifference < 1e-4f);
+}
+
+TEST(LookAtAndPerspectiveFollowD3DConventions) {
+	const Vector3 eye = {3.0f, 4.0f, -10.0f};
+	const Vector3 target = {3.0f, 4.0f, 0.0f};
+	const Matrix4x4 view = MakeLookAtMatrix(eye, target, {0.0f, 1.0f, 0.0f});
+	// 視点は原点、注視点は +Z 方向（左手系）
+	CHECK(MaxDifference(TransformPoint(eye, view), {0.0f, 0.0f, 0.0f}) < 1e-5f);
+	CHECK(MaxDifference(TransformPoint(target, view), {0.0f, 0.0f, 10.0f}) < 1e-5f);
+
+	// 近クリップ面は深度0、遠クリップ面は深度1
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(0.8f, 1.5f, 0.5f, 200.0f);
+	CHECK(std::abs(Transform(Vector3{0.0f, 0.0f, 0.5f}, projection).z) < 1e-5f);
+	CHECK(std::abs(Transform(Vector3{0.0f, 0.0f, 200.0f}, projection).z - 1.0f) < 1e-5f);
+	// 視野角の端は NDC の上端
+	const float y = std::tan(0.4f) * 10.0f;
+	CHECK(std::abs(Transform(Vector3{0.0f, y, 10.0f}, projection).y - 1.0f) < 1e-5f);
+}
+
+TEST(VectorHelpers) {
+	CHECK(std::abs(Length({3.0f, 4.0f, 12.0f}) - 13.0f) < 1e-6f);
+	CHECK(MaxDifference(Normalize({0.0f, 0.0f, 5.0f}), {0.0f, 0.0f, 1.0f}) < 1e-6f);
+	CHECK(MaxDifference(Cross({1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}), {0.0f, 0.0f, 1.0f}) == 0.0f);
+}
@@ -0,0 +1,164 @@
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+const char kMaterialText[] = "newmtl gridMaterial\nKd 0.5 0.25 1\nmap_Kd textures/grid.png\n";
+
+// 2つのモデルデータが同じ形状か
+bool IsSameModel(const ModelData& a, const ModelData& b) {
+	if (a.meshes.size() != b.meshes.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.meshes.size(); i++) {
+		const MeshData& meshA = a.meshes[i];
+		const MeshData& meshB = b.meshes[i];
+		if (meshA.name != meshB.name || meshA.materialName != meshB.materialName ||
+		    meshA.indices != meshB.indices || meshA.vertices.size() != meshB.vertices.size() ||
+		    std::memcmp(
+		        meshA.vertices.data(), meshB.vertices.data(),
+		        sizeof(MeshVertex) * meshA.vertices.size()) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// キャッシュ1つ分の作業ディレクトリ
+struct CacheFixture {
+	std::filesystem::path directory;
+	std::string objPath;
+
+	explicit CacheFixture(const char* name) : directory(MakeTemporaryDirectory(name)) {
+		objPath = (directory / "grid.obj").string();
+		WriteTextFile(objPath, MakeGridObj(16, "grid.mtl"));
+		WriteTextFile(directory / "grid.mtl", kMaterialText);
+	}
+
+	~CacheFixture() {
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+};
+
+} // namespace
+
+TEST(ColdBuildMatchesObjLoader) {
+	CacheFixture fixture("MeshCacheTestCold");
+	MeshCache cache;
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	CHECK(cache.WasRebuilt());
+	CHECK(std::filesystem::exists(MeshCache::GetCachePath(fixture.objPath, false)));
+
+	ModelData expected;
+	CHECK(ObjLoader::Load(fixture.objPath, false, expected));
+	ModelData cached;
+	cache.ToModelData(cached);
+	CHECK(IsSameModel(cached, expected));
+	CHECK(cached.materials.size() == 1);
+	CHECK(cached.materials[0].diffuse.y == 0.25f);
+	CHECK(cached.materials[0].textureFilename == "grid.png");
+	// 格子の頂点は溶接されて共有される
+	CHECK(cache.GetMeshes().size() == 1);
+	CHECK(cache.GetMeshes()[0].vertices.size() == 17 * 17);
+	CHECK(cache.GetMeshes()[0].indexCount == 16 * 16 * 6);
+	CHECK(cache.GetMeshes()[0].indexFormat == MeshCache::IndexFormat::kUInt16);
+}
+
+TEST(WarmLoadSkipsRebuild) {
+	CacheFixture fixture("MeshCacheTestWarm");
+	MeshCache cold;
+	CHECK(cold.LoadOrBuild(fixture.objPath, false));
+	ModelData expected;
+	cold.ToModelData(expected);
+	cold.Close();
+
+	MeshCache warm;
+	CHECK(warm.LoadOrBuild(fixture.objPath, false));
+	CHECK(!warm.WasRebuilt());
+	ModelData cached;
+	warm.ToModelData(cached);
+	CHECK(IsSameModel(cached, expected));
+
+	// 平滑化の有無は別のキャッシュファイルになる
+	MeshCache smooth;
+	CHECK(smooth.LoadOrBuild(fixture.objPath, true));
+	CHECK(smooth.WasRebuilt());
+	CHECK(MeshCache::GetCachePath(fixture.objPath, true) != MeshCache::GetCachePath(fixture.objPath, false));
+}
+
+TEST(TouchedSourceWithSameContentIsReused) {
+	CacheFixture fixture("MeshCacheTestTouch");
+	MeshCache cache;
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	cache.Close();
+
+	// 日時だけ変わった場合は内容のハッシュで判定する
+	std::filesystem::last_write_time(
+	    fixture.objPath, std::filesystem::last_write_time(fixture.objPath) + std::chrono::hours(1));
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	CHECK(!cache.WasRebuilt());
+}
+
+TEST(ChangedSourceIsRebuilt) {
+	CacheFixture fixture("MeshCacheTestChange");
+	MeshCache cache;
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	cache.Close();
+
+	// 同じサイズで内容だけ変える
+	std::string text = MakeGridObj(16, "grid.mtl");
+	const size_t pos = text.find("v 0 ");
+	text[pos + 2] = '9';
+	WriteTextFile(fixture.objPath, text);
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	CHECK(cache.WasRebuilt());
+	CHECK(cache.GetMeshes()[0].bounds.max.x == 16.0f);
+	bool hasMovedVertex = false;
+	for (const MeshVertex& vertex : cache.GetMeshes()[0].vertices) {
+		hasMovedVertex |= vertex.pos.x == 9.0f && vertex.pos.z == 0.0f && vertex.uv.x == 0.0f;
+	}
+	CHECK(hasMovedVertex);
+	cache.Close();
+
+	// 参照している .mtl も元ファイルとして判定する
+	WriteTextFile(fixture.directory / "grid.mtl", "newmtl gridMaterial\nKd 1 1 1\n");
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	CHECK(cache.WasRebuilt());
+	CHECK(cache.GetMaterials()[0].diffuse.y == 1.0f);
+}
+
+TEST(OptionsAndDamageForceRebuild) {
+	CacheFixture fixture("MeshCacheTestOptions");
+	MeshCache cache;
+	CHECK(cache.LoadOrBuild(fixture.objPath, false));
+	CHECK(cache.GetMeshes()[0].lods.empty());
+	CHECK(cache.GetMeshes()[0].meshlets.empty());
+	cache.Close();
+
+	// LODとメッシュレットの要求が変わったら作り直す
+	CHECK(cache.LoadOrBuild(fixture.objPath, false, 2, true));
+	CHECK(cache.WasRebuilt());
+	CHECK(cache.GetMeshes()[0].lods.size() == 2);
+	CHECK(!cache.GetMeshes()[0].meshlets.empty());
+	cache.Close();
+	CHECK(cache.LoadOrBuild(fixture.objPath, false, 2, true));
+	CHECK(!cache.WasRebuilt());
+	CHECK(cache.GetMeshes()[0].lods.size() == 2);
+	cache.Close();
+
+	// 途中で切れたキャッシュは読まない
+	const std::string cachePath = MeshCache::GetCachePath(fixture.objPath, false);
+	std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) / 2);
+	CHECK(!MeshCache::IsUpToDate(cachePath, fixture.objPath, false, 2, true));
+	CHECK(cache.LoadOrBuild(fixture.objPath, false, 2, true));
+	CHECK(cache.WasRebuilt());
+
+	// 元ファイルが無い
+	MeshCache missing;
+	CHECK(!missing.LoadOrBuild((fixture.directory / "missing.obj").string(), false));
+}
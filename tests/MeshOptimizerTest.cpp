@@ -0,0 +1,95 @@
+#include "MeshOptimizer.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+
+namespace {
+
+// 三角形の順をばらばらにした格子
+MeshData MakeShuffledGrid(uint32_t n, uint32_t seed) {
+	MeshData mesh = MakeGridMesh(n);
+	ShuffleTriangles(mesh.indices, seed);
+	return mesh;
+}
+
+} // namespace
+
+TEST(OptimizeKeepsTriangles) {
+	for (bool optimizeOverdraw : {false, true}) {
+		MeshData mesh = MakeShuffledGrid(40, 1);
+		const auto expected = GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size());
+		MeshOptimizer::Options options;
+		options.optimizeOverdraw = optimizeOverdraw;
+		MeshOptimizer::Optimize(mesh, options);
+		CHECK(GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size()) == expected);
+	}
+}
+
+TEST(OptimizeDoesNotWorsenAcmr) {
+	MeshData mesh = MakeShuffledGrid(64, 2);
+	MeshOptimizer::Report report;
+	MeshOptimizer::Optimize(mesh, &report);
+	CHECK(report.after.acmr <= report.before.acmr);
+	CHECK(report.after.atvr <= report.before.atvr);
+	// 格子の理想は三角形あたり0.5、キャッシュ16なら1を切る程度まで下がる
+	CHECK(report.after.acmr < 1.0f);
+	const MeshOptimizer::CacheStatistics statistics = MeshOptimizer::AnalyzeVertexCache(
+	    mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+	CHECK(statistics.acmr == report.after.acmr);
+
+	// 最適化済みの入力をもう一度最適化しても悪化しない
+	MeshOptimizer::Report again;
+	MeshOptimizer::Optimize(mesh, &again);
+	CHECK(again.after.acmr <= again.before.acmr);
+}
+
+TEST(OverdrawOrderStaysWithinThreshold) {
+	MeshData mesh = MakeShuffledGrid(64, 3);
+	std::vector<uint32_t> clusterOffsets;
+	MeshOptimizer::OptimizeVertexCache(mesh.indices, mesh.vertices.size(), 16, &clusterOffsets);
+	CHECK(!clusterOffsets.empty() && clusterOffsets[0] == 0);
+	const size_t inputMisses = MeshOptimizer::AnalyzeVertexCache(
+	    mesh.indices.data(), mesh.indices.size(), mesh.vertices.size()).vertexTransformCount;
+	const auto expected = GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size());
+	MeshOptimizer::OptimizeOverdraw(mesh.indices, mesh.vertices, clusterOffsets, 16, 1.05f);
+	const size_t misses = MeshOptimizer::AnalyzeVertexCache(
+	    mesh.indices.data(), mesh.indices.size(), mesh.vertices.size()).vertexTransformCount;
+	CHECK(float(misses) <= float(inputMisses) * 1.05f);
+	CHECK(GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size()) == expected);
+}
+
+TEST(VertexFetchFollowsFirstUse) {
+	MeshData mesh = MakeShuffledGrid(8, 4);
+	// 使われない頂点を足しておく
+	mesh.vertices.push_back({{100.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}});
+	const auto expected = GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size());
+	MeshOptimizer::OptimizeVertexFetch(mesh);
+	CHECK(mesh.vertices.size() == 9 * 9);
+	uint32_t nextVertex = 0;
+	bool isFirstUseOrder = true;
+	for (uint32_t index : mesh.indices) {
+		isFirstUseOrder &= index <= nextVertex;
+		if (index == nextVertex) {
+			nextVertex++;
+		}
+	}
+	CHECK(isFirstUseOrder);
+	CHECK(GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size()) == expected);
+}
+
+TEST(AnalyzeHandlesDegenerateInput) {
+	const uint32_t indices[] = {0, 1, 2, 2, 1, 3};
+	const MeshOptimizer::CacheStatistics empty = MeshOptimizer::AnalyzeVertexCache(indices, 2, 4);
+	CHECK(empty.vertexTransformCount == 0 && empty.acmr == 0.0f && empty.atvr == 0.0f);
+	const MeshOptimizer::CacheStatistics quad = MeshOptimizer::AnalyzeVertexCache(indices, 6, 4);
+	CHECK(quad.vertexTransformCount == 4);
+	CHECK(quad.acmr == 2.0f);
+	CHECK(quad.atvr == 1.0f);
+
+	// 三角形の無いメッシュはそのまま
+	MeshData mesh;
+	mesh.vertices.resize(2);
+	mesh.indices = {0, 1};
+	MeshOptimizer::Report report;
+	MeshOptimizer::Optimize(mesh, &report);
+	CHECK(report.before.acmr == 0.0f && report.after.acmr == 0.0f);
+}
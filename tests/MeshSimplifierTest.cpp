@@ -0,0 +1,100 @@
+#include "MeshSimplifier.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+
+namespace {
+
+// インデックスが範囲内で、縮退した三角形が無いか
+bool IsValidTriangleList(const std::vector<uint32_t>& indices, size_t vertexCount) {
+	if (indices.size() % 3 != 0) {
+		return false;
+	}
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		const uint32_t a = indices[i];
+		const uint32_t b = indices[i + 1];
+		const uint32_t c = indices[i + 2];
+		if (vertexCount <= a || vertexCount <= b || vertexCount <= c || a == b || b == c || c == a) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 使っている頂点のAABB
+AABB ComputeUsedBounds(const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices) {
+	std::vector<Vector3> positions;
+	for (uint32_t index : indices) {
+		positions.push_back(vertices[index].pos);
+	}
+	return ComputeAABB(positions.data(), positions.size());
+}
+
+// 平らで属性が一様な格子（UVの違いも縮約の誤差に数えるのでそろえる）
+MeshData MakeFlatGrid(uint32_t n) {
+	MeshData mesh = MakeGridMesh(n);
+	for (MeshVertex& vertex : mesh.vertices) {
+		vertex.pos.y = 0.0f;
+		vertex.uv = {0.0f, 0.0f};
+	}
+	return mesh;
+}
+
+} // namespace
+
+TEST(SimplifyReachesTarget) {
+	const MeshData mesh = MakeGridMesh(32);
+	const size_t target = mesh.indices.size() / 4;
+	float error = -1.0f;
+	const std::vector<uint32_t> indices =
+	    MeshSimplifier::Simplify(mesh.vertices, mesh.indices, target, 1e9f, &error);
+	CHECK(!indices.empty());
+	CHECK(indices.size() <= target);
+	CHECK(IsValidTriangleList(indices, mesh.vertices.size()));
+	CHECK(0.0f < error);
+	// 境界は保たれるので外形は変わらない
+	const AABB bounds = ComputeUsedBounds(mesh.vertices, indices);
+	CHECK(bounds.min.x == 0.0f && bounds.max.x == 32.0f);
+	CHECK(bounds.min.z == 0.0f && bounds.max.z == 32.0f);
+}
+
+TEST(SimplifyRespectsMaxError) {
+	const MeshData mesh = MakeGridMesh(32);
+	for (float maxError : {1e-4f, 1e-2f, 1e-1f}) {
+		float error = -1.0f;
+		const std::vector<uint32_t> indices =
+		    MeshSimplifier::Simplify(mesh.vertices, mesh.indices, 0, maxError, &error);
+		CHECK(IsValidTriangleList(indices, mesh.vertices.size()));
+		CHECK(0.0f <= error && error <= maxError);
+		CHECK(indices.size() <= mesh.indices.size());
+	}
+	// 誤差0で縮約できる平面はまとめられる
+	const MeshData flat = MakeFlatGrid(16);
+	const std::vector<uint32_t> indices =
+	    MeshSimplifier::Simplify(flat.vertices, flat.indices, 0, 1e-6f);
+	CHECK(IsValidTriangleList(indices, flat.vertices.size()));
+	CHECK(indices.size() < flat.indices.size() / 4);
+}
+
+TEST(GeneratedLodsAreMonotonic) {
+	MeshData mesh = MakeGridMesh(48);
+	MeshSimplifier::GenerateLods(mesh, 4);
+	CHECK(mesh.lods.size() == 4);
+	size_t previousIndexCount = mesh.indices.size();
+	float previousError = 0.0f;
+	for (const MeshLod& lod : mesh.lods) {
+		CHECK(IsValidTriangleList(lod.indices, mesh.vertices.size()));
+		// 1段ごとに概ね半分（切り捨てと縮約の単位の分だけ余裕を持たせる）
+		CHECK(lod.indices.size() <= previousIndexCount / 2 + 3);
+		CHECK(previousError <= lod.error);
+		previousIndexCount = lod.indices.size();
+		previousError = lod.error;
+	}
+
+	// 減らせなくなったら打ち切る
+	MeshData single = MakeGridMesh(1);
+	MeshSimplifier::GenerateLods(single, 4);
+	CHECK(single.lods.size() < 4);
+	MeshData empty;
+	MeshSimplifier::GenerateLods(empty, 4);
+	CHECK(empty.lods.empty());
+}
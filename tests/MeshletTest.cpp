@@ -0,0 +1,180 @@
+#include "MathUtility.h"
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+#include <cmath>
+
+namespace {
+
+// 全てを内側とする視錐台（裏向き判定だけを調べる）
+Frustum MakeUnboundedFrustum() {
+	Frustum frustum;
+	const Vector3 normals[] = {
+	    {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f},
+	    {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+	for (int i = 0; i < Frustum::kPlaneCount; i++) {
+		frustum.planes[i] = {normals[i].x, normals[i].y, normals[i].z, 1e6f};
+	}
+	return frustum;
+}
+
+// 三角形が視点から裏向きか（面の向きは MeshletBuilder と同じく (p1-p0)×(p2-p0)）
+bool IsBackfacing(const MeshData& mesh, size_t firstIndex, const Vector3& cameraPosition) {
+	const Vector3& p0 = mesh.vertices[mesh.indices[firstIndex]].pos;
+	const Vector3& p1 = mesh.vertices[mesh.indices[firstIndex + 1]].pos;
+	const Vector3& p2 = mesh.vertices[mesh.indices[firstIndex + 2]].pos;
+	return 0.0f <= Dot(p0 - cameraPosition, Normalize(Cross(p1 - p0, p2 - p0)));
+}
+
+// 範囲に含まれるインデックスの印
+std::vector<bool> MarkRanges(const std::vector<IndexRange>& ranges, size_t indexCount) {
+	std::vector<bool> isDrawn(indexCount, false);
+	for (const IndexRange& range : ranges) {
+		for (uint32_t i = range.firstIndex; i < range.firstIndex + range.indexCount; i++) {
+			isDrawn[i] = true;
+		}
+	}
+	return isDrawn;
+}
+
+} // namespace
+
+TEST(MeshletsRespectLimitsAndKeepTriangles) {
+	for (const MeshData& source : {MakeGridMesh(40), MakeSphereMesh(32, 48, 1.0f)}) {
+		MeshData mesh = source;
+		MeshletBuilder::Options options;
+		options.maxVertexCount = 32;
+		options.maxTriangleCount = 40;
+		MeshletBuilder::Build(mesh, options);
+		CHECK(!mesh.meshlets.empty());
+		CHECK(mesh.vertices.size() == source.vertices.size());
+		CHECK(
+		    GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size()) ==
+		    GetCanonicalTriangles(source.vertices, source.indices.data(), source.indices.size()));
+
+		// 先頭から隙間なく区切り、上限を守る
+		uint32_t nextIndex = 0;
+		bool isValid = true;
+		for (const Meshlet& meshlet : mesh.meshlets) {
+			isValid &= meshlet.firstIndex == nextIndex;
+			isValid &= 0 < meshlet.triangleCount;
+			isValid &= meshlet.triangleCount <= options.maxTriangleCount;
+			isValid &= meshlet.vertexCount <= options.maxVertexCount;
+			nextIndex += meshlet.triangleCount * 3;
+		}
+		CHECK(isValid);
+		CHECK(nextIndex == mesh.indices.size());
+	}
+}
+
+TEST(MeshletBoundsAreConservative) {
+	MeshData mesh = MakeSphereMesh(32, 48, 2.0f);
+	MeshletBuilder::Build(mesh);
+	bool isContained = true;
+	for (const Meshlet& meshlet : mesh.meshlets) {
+		const std::span<const uint32_t> indices(
+		    mesh.indices.data() + meshlet.firstIndex, meshlet.triangleCount * 3);
+		// 境界は範囲から計算し直したものと一致する
+		const Meshlet recomputed =
+		    MeshletBuilder::ComputeBounds(mesh.vertices, indices, meshlet.firstIndex);
+		isContained &= recomputed.vertexCount == meshlet.vertexCount;
+		isContained &= recomputed.bounds.radius == meshlet.bounds.radius;
+		for (uint32_t index : indices) {
+			const float distance = Length(mesh.vertices[index].pos - meshlet.bounds.center);
+			isContained &= distance <= meshlet.bounds.radius * 1.0001f;
+		}
+		isContained &= std::abs(Length(meshlet.coneAxis) - 1.0f) < 1e-4f;
+		isContained &= 0.0f <= meshlet.coneCutoff && meshlet.coneCutoff <= 1.0f;
+	}
+	CHECK(isContained);
+}
+
+TEST(ConeCullingOnlyRemovesBackfaces) {
+	MeshData mesh = MakeSphereMesh(48, 64, 1.0f);
+	MeshletBuilder::Build(mesh);
+	MeshletCuller culler;
+	culler.Initialize(mesh.meshlets);
+	CHECK(culler.GetMeshletCount() == mesh.meshlets.size());
+
+	std::mt19937 random(1);
+	std::normal_distribution<float> direction;
+	std::vector<IndexRange> ranges;
+	size_t totalCulled = 0;
+	for (int i = 0; i < 64; i++) {
+		const Vector3 cameraPosition =
+		    Normalize(Vector3{direction(random), direction(random), direction(random)}) *
+		    (1.5f + float(i));
+		const MeshletCuller::Statistics& statistics =
+		    culler.Cull(MakeUnboundedFrustum(), cameraPosition, ranges);
+		CHECK(statistics.frustumCulledTriangleCount == 0);
+		totalCulled += statistics.backfaceCulledTriangleCount;
+
+		// 除いた三角形は全て裏向き
+		const std::vector<bool> isDrawn = MarkRanges(ranges, mesh.indices.size());
+		bool isConservative = true;
+		size_t drawnCount = 0;
+		for (size_t index = 0; index < mesh.indices.size(); index += 3) {
+			drawnCount += isDrawn[index];
+			isConservative &= isDrawn[index] || IsBackfacing(mesh, index, cameraPosition);
+		}
+		CHECK(isConservative);
+		CHECK(drawnCount + statistics.backfaceCulledTriangleCount == mesh.indices.size() / 3);
+	}
+	// 球の裏側のかなりの部分を除ける
+	CHECK(mesh.indices.size() / 3 * 64 / 5 < totalCulled);
+}
+
+TEST(FrustumCullingMatchesSpheres) {
+	MeshData mesh = MakeGridMesh(64);
+	MeshletBuilder::Build(mesh);
+	MeshletCuller culler;
+	culler.Initialize(mesh.meshlets);
+
+	// 格子の一角を上から見下ろす
+	const Matrix4x4 view =
+	    MakeLookAtMatrix({8.0f, 20.0f, 8.0f}, {8.0f, 0.0f, 8.1f}, {0.0f, 0.0f, 1.0f});
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(0.6f, 1.0f, 0.1f, 100.0f);
+	std::vector<IndexRange> ranges;
+	const MeshletCuller::Statistics& statistics =
+	    culler.Cull(MakeIdentityMatrix(), view, projection, ranges);
+	CHECK(0 < statistics.frustumCulledTriangleCount);
+	CHECK(statistics.visibleMeshletCount < statistics.meshletCount);
+	CHECK(statistics.rangeCount == ranges.size());
+	CHECK(statistics.rangeCount <= statistics.visibleMeshletCount);
+
+	// 範囲は昇順で重ならず、見える境界球のメッシュレットだけを含む
+	const Frustum frustum = Frustum::FromMatrices(view, projection);
+	const std::vector<bool> isDrawn = MarkRanges(ranges, mesh.indices.size());
+	bool isValid = true;
+	for (size_t i = 1; i < ranges.size(); i++) {
+		isValid &= ranges[i - 1].firstIndex + ranges[i - 1].indexCount < ranges[i].firstIndex;
+	}
+	for (const Meshlet& meshlet : mesh.meshlets) {
+		isValid &= !isDrawn[meshlet.firstIndex] || frustum.Intersects(meshlet.bounds);
+	}
+	CHECK(isValid);
+
+	// ワールド行列で動かすと判定もついてくる
+	culler.Cull(MakeTranslationMatrix({1000.0f, 0.0f, 0.0f}), view, projection, ranges);
+	CHECK(ranges.empty());
+}
+
+TEST(ReorderedMeshletsImproveAcmr) {
+	for (const MeshData& source : {MakeGridMesh(64), MakeSphereMesh(48, 64, 1.0f)}) {
+		MeshData raw = source;
+		MeshData reordered = source;
+		MeshletBuilder::Options options;
+		options.optimizeVertexCache = false;
+		MeshletBuilder::Build(raw, options);
+		MeshletBuilder::Build(reordered);
+		// 並べ直しても区切りは同じ
+		CHECK(raw.meshlets.size() == reordered.meshlets.size());
+		const float rawAcmr = MeshOptimizer::AnalyzeVertexCache(
+		    raw.indices.data(), raw.indices.size(), raw.vertices.size()).acmr;
+		const float reorderedAcmr = MeshOptimizer::AnalyzeVertexCache(
+		    reordered.indices.data(), reordered.indices.size(), reordered.vertices.size()).acmr;
+		CHECK(reorderedAcmr <= rawAcmr);
+	}
+}
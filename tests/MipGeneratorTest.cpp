@@ -0,0 +1,380 @@
+#include "MipGenerator.h"
+#include "TestFramework.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Filter = MipGenerator::Filter;
+
+// 乱数で塗った RGBA8 の画像
+TextureData MakeRandomTexture(uint32_t width, uint32_t height, uint32_t seed) {
+	TextureData texture;
+	texture.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	std::mt19937 random(seed);
+	for (uint8_t& value : texture.pixels) {
+		value = uint8_t(random());
+	}
+	return texture;
+}
+
+// アルファだけを決めた画像（色は灰色）
+template<class AlphaFunction>
+TextureData MakeAlphaTexture(uint32_t width, uint32_t height, AlphaFunction&& alphaFunction) {
+	TextureData texture;
+	texture.Allocate(TextureFormat::kR8G8B8A8Unorm, width, height);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			uint8_t* pixel = texture.pixels.data() + (size_t(y) * width + x) * 4;
+			pixel[0] = pixel[1] = pixel[2] = 128;
+			pixel[3] = alphaFunction(x, y);
+		}
+	}
+	return texture;
+}
+
+double SrgbToLinear(double c) {
+	return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+double LinearToSrgb(double l) {
+	return l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+}
+
+// 素朴な 2x2 平均のミップ（sRGB の色は線形に戻し、各レベルを1つ前の線形の値から作る）
+std::vector<std::vector<uint8_t>> MakeReferenceBoxMips(const TextureData& texture, bool isSrgb) {
+	uint32_t width = texture.GetWidth();
+	uint32_t height = texture.GetHeight();
+	std::vector<double> linear(size_t(width) * height * 4);
+	for (size_t i = 0; i < linear.size(); i++) {
+		const double value = texture.pixels[i] / 255.0;
+		linear[i] = isSrgb && i % 4 != 3 ? SrgbToLinear(value) : value;
+	}
+	std::vector<std::vector<uint8_t>> levels;
+	while (1 < width || 1 < height) {
+		const uint32_t mipWidth = (std::max)(width / 2, 1u);
+		const uint32_t mipHeight = (std::max)(height / 2, 1u);
+		std::vector<double> next(size_t(mipWidth) * mipHeight * 4);
+		std::vector<uint8_t> encoded(next.size());
+		for (uint32_t y = 0; y < mipHeight; y++) {
+			const uint32_t y0 = y * 2;
+			const uint32_t y1 = (std::min)(y0 + 1, height - 1);
+			for (uint32_t x = 0; x < mipWidth; x++) {
+				const uint32_t x0 = x * 2;
+				const uint32_t x1 = (std::min)(x0 + 1, width - 1);
+				for (uint32_t c = 0; c < 4; c++) {
+					const size_t i = (size_t(y) * mipWidth + x) * 4 + c;
+					next[i] = (linear[(size_t(y0) * width + x0) * 4 + c] +
+					           linear[(size_t(y0) * width + x1) * 4 + c] +
+					           linear[(size_t(y1) * width + x0) * 4 + c] +
+					           linear[(size_t(y1) * width + x1) * 4 + c]) *
+					          0.25;
+					const double value = isSrgb && c != 3 ? LinearToSrgb(next[i]) : next[i];
+					encoded[i] = uint8_t(std::clamp(value, 0.0, 1.0) * 255.0 + 0.5);
+				}
+			}
+		}
+		levels.push_back(std::move(encoded));
+		linear = std::move(next);
+		width = mipWidth;
+		height = mipHeight;
+	}
+	return levels;
+}
+
+// 窓付き sinc の重み（x は縮小後の画素単位の距離、半径3）
+double ReferenceFilterWeight(Filter filter, double x) {
+	const double radius = 3.0;
+	x = std::abs(x);
+	if (radius <= x) {
+		return 0.0;
+	}
+	auto sinc = [](double v) {
+		return v == 0.0 ? 1.0 : std::sin(3.14159265358979323846 * v) / (3.14159265358979323846 * v);
+	};
+	if (filter == Filter::kLanczos) {
+		return sinc(x) * sinc(x / radius);
+	}
+	// カイザー窓（α = 4）
+	const double t = x / radius;
+	return sinc(x) * std::cyl_bessel_i(0.0, 4.0 * std::sqrt(1.0 - t * t)) /
+	       std::cyl_bessel_i(0.0, 4.0);
+}
+
+// 1軸の縮小（画素の中心どうしの距離で重みを決め、範囲外は端の画素、重みの和で割る）
+// 縮小先の i 番目の画素の、縮小元の各画素への重み
+std::vector<std::vector<double>> MakeReferenceWeights(
+    Filter filter, uint32_t srcSize, uint32_t dstSize) {
+	const double scale = double(srcSize) / double(dstSize);
+	std::vector<std::vector<double>> weights(dstSize, std::vector<double>(srcSize, 0.0));
+	for (uint32_t i = 0; i < dstSize; i++) {
+		const double center = (i + 0.5) * scale;
+		const int first = int(std::floor(center - 3.0 * scale));
+		const int last = int(std::ceil(center + 3.0 * scale));
+		double sum = 0.0;
+		for (int j = first; j <= last; j++) {
+			const double weight = ReferenceFilterWeight(filter, (j + 0.5 - center) / scale);
+			weights[i][std::clamp(j, 0, int(srcSize) - 1)] += weight;
+			sum += weight;
+		}
+		for (double& weight : weights[i]) {
+			weight /= sum;
+		}
+	}
+	return weights;
+}
+
+// 素朴な窓付き sinc のミップ（2次元の畳み込みを 0～1 に収め、各レベルを1つ前の線形の値から作る）
+std::vector<std::vector<uint8_t>> MakeReferenceFilterMips(
+    const TextureData& texture, Filter filter, bool isSrgb) {
+	uint32_t width = texture.GetWidth();
+	uint32_t height = texture.GetHeight();
+	std::vector<double> linear(size_t(width) * height * 4);
+	for (size_t i = 0; i < linear.size(); i++) {
+		const double value = texture.pixels[i] / 255.0;
+		linear[i] = isSrgb && i % 4 != 3 ? SrgbToLinear(value) : value;
+	}
+	std::vector<std::vector<uint8_t>> levels;
+	while (1 < width || 1 < height) {
+		const uint32_t mipWidth = (std::max)(width / 2, 1u);
+		const uint32_t mipHeight = (std::max)(height / 2, 1u);
+		const std::vector<std::vector<double>> horizontal =
+		    MakeReferenceWeights(filter, width, mipWidth);
+		const std::vector<std::vector<double>> vertical =
+		    MakeReferenceWeights(filter, height, mipHeight);
+		std::vector<double> next(size_t(mipWidth) * mipHeight * 4);
+		std::vector<uint8_t> encoded(next.size());
+		for (uint32_t y = 0; y < mipHeight; y++) {
+			for (uint32_t x = 0; x < mipWidth; x++) {
+				for (uint32_t c = 0; c < 4; c++) {
+					double sum = 0.0;
+					for (uint32_t sy = 0; sy < height; sy++) {
+						for (uint32_t sx = 0; sx < width; sx++) {
+							sum += vertical[y][sy] * horizontal[x][sx] *
+							       linear[(size_t(sy) * width + sx) * 4 + c];
+						}
+					}
+					const size_t i = (size_t(y) * mipWidth + x) * 4 + c;
+					next[i] = std::clamp(sum, 0.0, 1.0);
+					const double value = isSrgb && c != 3 ? LinearToSrgb(next[i]) : next[i];
+					encoded[i] = uint8_t(value * 255.0 + 0.5);
+				}
+			}
+		}
+		levels.push_back(std::move(encoded));
+		linear = std::move(next);
+		width = mipWidth;
+		height = mipHeight;
+	}
+	return levels;
+}
+
+// 各レベルの基準との差の最大
+int MaxReferenceDifference(uint32_t width, uint32_t height, bool isSrgb, Filter filter) {
+	TextureData texture = MakeRandomTexture(width, height, width * 131 + height);
+	const std::vector<std::vector<uint8_t>> reference =
+	    filter == Filter::kBox ? MakeReferenceBoxMips(texture, isSrgb)
+	                           : MakeReferenceFilterMips(texture, filter, isSrgb);
+	MipGenerator::Options options;
+	options.filter = filter;
+	options.isSrgb = isSrgb;
+	if (!MipGenerator::Generate(texture, options) ||
+	    texture.GetMipCount() != reference.size() + 1) {
+		return 256;
+	}
+	int difference = 0;
+	for (uint32_t level = 1; level < texture.GetMipCount(); level++) {
+		const uint8_t* pixels = texture.GetMipPixels(level);
+		const std::vector<uint8_t>& expected = reference[level - 1];
+		for (size_t i = 0; i < expected.size(); i++) {
+			difference = (std::max)(difference, std::abs(int(pixels[i]) - int(expected[i])));
+		}
+	}
+	return difference;
+}
+
+// アルファテストの通過率
+float GetCoverage(const TextureData& texture, uint32_t level, float reference) {
+	const TextureMip& mip = texture.mips[level];
+	const uint8_t* pixels = texture.GetMipPixels(level);
+	size_t count = 0;
+	for (size_t i = 0; i < size_t(mip.width) * mip.height; i++) {
+		count += reference < float(pixels[i * 4 + 3]) * (1.0f / 255.0f) ? 1 : 0;
+	}
+	return float(count) / float(size_t(mip.width) * mip.height);
+}
+
+// 通過率がレベル0から、そのレベルの画素数で取れる刻み以上にずれたレベルの数
+int CountCoverageDrift(TextureData texture, Filter filter, float reference, bool preserves) {
+	MipGenerator::Options options;
+	options.filter = filter;
+	options.alphaCoverageReference = preserves ? reference : 0.0f;
+	MipGenerator::Generate(texture, options);
+	const float target = GetCoverage(texture, 0, reference);
+	int driftCount = 0;
+	// 1x1 のレベルは通すか通さないかしかないので除く
+	for (uint32_t level = 1; level + 1 < texture.GetMipCount(); level++) {
+		const TextureMip& mip = texture.mips[level];
+		const float step = 1.0f / float(size_t(mip.width) * mip.height);
+		if (step + 1e-3f < std::abs(GetCoverage(texture, level, reference) - target)) {
+			driftCount++;
+		}
+	}
+	return driftCount;
+}
+
+} // namespace
+
+TEST(MipChainLayout) {
+	CHECK(MipGenerator::GetFullMipCount(1, 1) == 1);
+	CHECK(MipGenerator::GetFullMipCount(256, 256) == 9);
+	CHECK(MipGenerator::GetFullMipCount(37, 300) == 9);
+
+	TextureData texture = MakeRandomTexture(37, 300, 1);
+	CHECK(MipGenerator::Generate(texture));
+	CHECK(texture.GetMipCount() == 9);
+	size_t offset = 0;
+	bool isPacked = true;
+	for (uint32_t level = 0; level < texture.GetMipCount(); level++) {
+		const TextureMip& mip = texture.mips[level];
+		isPacked &= mip.offset == offset;
+		isPacked &= mip.width == (std::max)(37u >> level, 1u);
+		isPacked &= mip.height == (std::max)(300u >> level, 1u);
+		isPacked &= mip.rowPitch == mip.width * 4 && mip.slicePitch == mip.rowPitch * mip.height;
+		offset += mip.slicePitch;
+	}
+	CHECK(isPacked);
+	CHECK(texture.pixels.size() == offset);
+
+	TextureData limited = MakeRandomTexture(64, 64, 2);
+	MipGenerator::Options options;
+	options.maxMipCount = 3;
+	CHECK(MipGenerator::Generate(limited, options));
+	CHECK(limited.GetMipCount() == 3);
+	CHECK(limited.mips[2].width == 16);
+}
+
+TEST(UnsupportedTexturesAreLeftAlone) {
+	// ブロック圧縮済み
+	TextureData compressed;
+	compressed.format = TextureFormat::kBC1Unorm;
+	compressed.mips.push_back({0, 8, 8, 16, 32});
+	compressed.pixels.resize(32);
+	CHECK(!MipGenerator::Generate(compressed));
+	CHECK(compressed.GetMipCount() == 1 && compressed.pixels.size() == 32);
+
+	// ミップを作り終えた画像
+	TextureData texture = MakeRandomTexture(16, 16, 3);
+	CHECK(MipGenerator::Generate(texture));
+	const std::vector<uint8_t> pixels = texture.pixels;
+	CHECK(!MipGenerator::Generate(texture));
+	CHECK(texture.pixels == pixels);
+}
+
+TEST(BoxMatchesReference) {
+	// 変換表と float の丸めの分だけ ±1 の差を許す（奇数の大きさと1画素幅も含める）
+	const uint32_t sizes[][2] = {{64, 64}, {37, 23}, {1, 9}, {13, 1}, {255, 128}};
+	for (const auto& size : sizes) {
+		CHECK(MaxReferenceDifference(size[0], size[1], true, Filter::kBox) <= 1);
+		CHECK(MaxReferenceDifference(size[0], size[1], false, Filter::kBox) <= 1);
+	}
+}
+
+TEST(WindowedSincMatchesReference) {
+	// 倍精度で2次元に畳み込んだ基準と ±1 で一致する（端の繰り返し・奇数の大きさ・1画素幅も含める）
+	const uint32_t sizes[][2] = {{64, 64}, {37, 23}, {1, 9}, {13, 1}, {2, 2}, {101, 50}};
+	for (Filter filter : {Filter::kKaiser, Filter::kLanczos}) {
+		for (const auto& size : sizes) {
+			CHECK(MaxReferenceDifference(size[0], size[1], true, filter) <= 1);
+			CHECK(MaxReferenceDifference(size[0], size[1], false, filter) <= 1);
+		}
+	}
+}
+
+TEST(SrgbAveragesInLinearSpace) {
+	// 黒と白の市松模様は線形の 0.5 になり、sRGB では 188 になる（値のまま平均すると 128）
+	TextureData texture = MakeAlphaTexture(8, 8, [](uint32_t, uint32_t) { return uint8_t(255); });
+	for (uint32_t y = 0; y < 8; y++) {
+		for (uint32_t x = 0; x < 8; x++) {
+			uint8_t* pixel = texture.pixels.data() + (size_t(y) * 8 + x) * 4;
+			pixel[0] = pixel[1] = pixel[2] = (x + y) % 2 == 0 ? 0 : 255;
+		}
+	}
+	TextureData linear = texture;
+	MipGenerator::Generate(texture);
+	CHECK(texture.GetMipPixels(1)[0] == 188);
+	MipGenerator::Options options;
+	options.isSrgb = false;
+	MipGenerator::Generate(linear, options);
+	CHECK(linear.GetMipPixels(1)[0] == 128);
+}
+
+TEST(PremultipliedAlphaDoesNotBleed) {
+	// 透明な赤と不透明な緑を平均しても赤が混ざらない
+	TextureData texture = MakeAlphaTexture(2, 2, [](uint32_t x, uint32_t) {
+		return uint8_t(x == 0 ? 0 : 255);
+	});
+	for (uint32_t y = 0; y < 2; y++) {
+		uint8_t* transparent = texture.pixels.data() + size_t(y) * 8;
+		transparent[0] = 255;
+		transparent[1] = transparent[2] = 0;
+		uint8_t* opaque = transparent + 4;
+		opaque[1] = 255;
+		opaque[0] = opaque[2] = 0;
+	}
+	TextureData straight = texture;
+	MipGenerator::Options options;
+	options.premultipliedAlpha = true;
+	MipGenerator::Generate(texture, options);
+	const uint8_t* pixel = texture.GetMipPixels(1);
+	CHECK(pixel[0] == 0 && pixel[1] == 255 && pixel[3] == 128);
+	MipGenerator::Generate(straight);
+	CHECK(0 < straight.GetMipPixels(1)[0]);
+}
+
+TEST(AlphaCoverageIsPreserved) {
+	std::mt19937 random(4);
+	const TextureData noise = MakeAlphaTexture(256, 256, [&](uint32_t, uint32_t) {
+		return uint8_t(random());
+	});
+	// 1割だけ不透明な葉のような画像
+	const TextureData sparse = MakeAlphaTexture(256, 256, [&](uint32_t, uint32_t) {
+		return uint8_t(random() % 10 == 0 ? 255 : 0);
+	});
+	const TextureData disc = MakeAlphaTexture(256, 256, [](uint32_t x, uint32_t y) {
+		const float dx = float(x) / 256.0f - 0.5f;
+		const float dy = float(y) / 256.0f - 0.5f;
+		const float alpha = 1.0f - std::sqrt(dx * dx + dy * dy) * 2.2f;
+		return uint8_t(std::clamp(alpha, 0.0f, 1.0f) * 255.0f);
+	});
+	for (Filter filter : {Filter::kKaiser, Filter::kLanczos}) {
+		CHECK(CountCoverageDrift(noise, filter, 0.5f, true) == 0);
+		CHECK(CountCoverageDrift(sparse, filter, 0.5f, true) == 0);
+		CHECK(CountCoverageDrift(disc, filter, 0.5f, true) == 0);
+		CHECK(CountCoverageDrift(disc, filter, 0.3f, true) == 0);
+		// 補正しなければ疎な葉は縮小するほど消えていく
+		CHECK(0 < CountCoverageDrift(sparse, filter, 0.5f, false));
+	}
+	CHECK(CountCoverageDrift(noise, Filter::kBox, 0.5f, true) == 0);
+}
+
+TEST(AlphaCoverageTakesNearestAchievable) {
+	// 2x2 平均ではアルファが 0, 0.25, 0.5, 0.75, 1 しか取れないので、通過率は飛び飛びになる
+	TextureData texture = MakeAlphaTexture(64, 64, [](uint32_t x, uint32_t y) {
+		return uint8_t((x % 2 == 0 && y % 2 == 0) ? 255 : 0);
+	});
+	MipGenerator::Options options;
+	options.alphaCoverageReference = 0.5f;
+	MipGenerator::Generate(texture, options);
+	// 全画素が同じ 0.25 になるので、0 と 1 のうち目標 0.25 に近い 0 を選ぶ
+	CHECK(GetCoverage(texture, 1, 0.5f) == 0.0f);
+
+	TextureData half = MakeAlphaTexture(64, 64, [](uint32_t x, uint32_t) {
+		return uint8_t(x < 24 ? 255 : 0);
+	});
+	MipGenerator::Generate(half, options);
+	CHECK(GetCoverage(half, 1, 0.5f) == GetCoverage(half, 0, 0.5f));
+}
@@ -0,0 +1,203 @@
+#include "ObjLoader.h"
+#include "ReferenceObjLoader.h"
+#include "TestFramework.h"
+#include "TestMeshes.h"
+#include <cstring>
+
+namespace {
+
+// テキストを一時ファイルに書いて読み込む
+bool LoadText(const std::string& text, bool smoothing, ModelData& modelData) {
+	const std::filesystem::path directory = MakeTemporaryDirectory("ObjLoaderTest");
+	const std::string objPath = (directory / "test.obj").string();
+	WriteTextFile(objPath, text);
+	const bool isLoaded = ObjLoader::Load(objPath, smoothing, modelData);
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	return isLoaded;
+}
+
+// 三角形の頂点座標の並び（インデックスの付け方に依らない比較用）
+std::vector<float> GetTrianglePositions(const MeshData& mesh) {
+	std::vector<float> positions;
+	for (uint32_t index : mesh.indices) {
+		const Vector3& pos = mesh.vertices[index].pos;
+		positions.insert(positions.end(), {pos.x, pos.y, pos.z});
+	}
+	return positions;
+}
+
+// 格子の面を負の（直前からの相対）番号で書いた OBJ
+std::string MakeRelativeGridObj(uint32_t n) {
+	std::string text = MakeGridObj(n);
+	text.erase(text.find("\nf ") + 1);
+	const uint32_t vertexCount = (n + 1) * (n + 1);
+	const uint32_t stride = n + 1;
+	char line[128];
+	for (uint32_t y = 0; y < n; y++) {
+		for (uint32_t x = 0; x < n; x++) {
+			const int a = int(y * stride + x) - int(vertexCount);
+			const int b = a + 1;
+			const int c = a + int(stride);
+			const int d = c + 1;
+			std::snprintf(line, sizeof(line), "f %d/%d/-1 %d/%d/-1 %d/%d/-1\n", a, a, c, c, b, b);
+			text += line;
+			std::snprintf(line, sizeof(line), "f %d/%d/-1 %d/%d/-1 %d/%d/-1\n", b, b, c, c, d, d);
+			text += line;
+		}
+	}
+	return text;
+}
+
+} // namespace
+
+TEST(ParsesGroupsMaterialsAndCornerFormats) {
+	const char text[] = "v 0 0 0\n"
+	                    "v 1 0 0\n"
+	                    "v 1 1 0\n"
+	                    "v 0 1 0\n"
+	                    "vt 0.25 0.25\n"
+	                    "vn 0 0 -1\n"
+	                    "g first\n"
+	                    "usemtl red\n"
+	                    "usemtl blue\n"
+	                    "f 1/1/1 2/1/1 3/1/1 4/1/1\n"
+	                    "g second\n"
+	                    "usemtl green\n"
+	                    "f 1 2 3\n"
+	                    "f 1//1 3//1 4//1\n"
+	                    "f 2/1 3/1 4/1\n";
+	ModelData modelData;
+	CHECK(LoadText(text, false, modelData));
+	CHECK(modelData.meshes.size() == 2);
+	const MeshData& first = modelData.meshes[0];
+	CHECK(first.name == "first");
+	// 最初に指定したマテリアルを使う
+	CHECK(first.materialName == "red");
+	// 四角形は扇状に2つの三角形になる
+	CHECK(first.indices.size() == 6);
+	CHECK(first.vertices.size() == 4);
+	CHECK(first.vertices[0].uv.x == 0.25f && first.vertices[0].uv.y == 0.75f);
+	CHECK(first.vertices[0].normal.z == -1.0f);
+	CHECK(first.bounds.max.x == 1.0f && first.bounds.max.y == 1.0f);
+
+	const MeshData& second = modelData.meshes[1];
+	CHECK(second.name == "second");
+	CHECK(second.materialName == "green");
+	CHECK(second.indices.size() == 9);
+}
+
+TEST(RelativeIndicesMatchAbsolute) {
+	// チャンクを跨いで前の頂点を指すよう、複数のチャンクに分かれる大きさにする
+	const uint32_t n = 200;
+	ModelData absolute;
+	ModelData relative;
+	CHECK(LoadText(MakeGridObj(n), false, absolute));
+	CHECK(LoadText(MakeRelativeGridObj(n), false, relative));
+	CHECK(absolute.meshes.size() == 1 && relative.meshes.size() == 1);
+	CHECK(absolute.meshes[0].indices.size() == size_t(n) * n * 6);
+	CHECK(absolute.meshes[0].vertices.size() == size_t(n + 1) * (n + 1));
+	CHECK(GetTrianglePositions(absolute.meshes[0]) == GetTrianglePositions(relative.meshes[0]));
+}
+
+TEST(MatchesSerialReferenceParser) {
+	// 多角形・複数のグループ・相対番号・範囲外の番号を含み、チャンクを跨ぐ大きさのもの
+	std::string text = MakeGridObj(150);
+	text += "g polygons\nusemtl second\n"
+	        "f 1/1/1 2/2/1 3/3/1 4/4/1 5/5/1\n"
+	        "f -1/-1/1 -2/-2/1 -3/-3/1 -4/-4/1\n"
+	        "f 1 2 99999999\n"
+	        "g\nf 7//1 8//1 9//1\n";
+	text += MakeRelativeGridObj(120).substr(MakeGridObj(120).find("\nf ") + 1);
+	const std::filesystem::path directory = MakeTemporaryDirectory("ObjLoaderTestReference");
+	const std::string objPath = (directory / "test.obj").string();
+	WriteTextFile(objPath, text);
+	ModelData modelData;
+	ModelData reference;
+	CHECK(ObjLoader::Load(objPath, false, modelData));
+	CHECK(LoadObjReference(objPath, false, reference));
+	CHECK(modelData.meshes.size() == 3 && reference.meshes.size() == 3);
+	bool isSame = modelData.meshes.size() == reference.meshes.size();
+	for (size_t i = 0; isSame && i < modelData.meshes.size(); i++) {
+		const MeshData& mesh = modelData.meshes[i];
+		const MeshData& expected = reference.meshes[i];
+		isSame &= mesh.name == expected.name && mesh.materialName == expected.materialName;
+		isSame &= GetCanonicalTriangles(mesh.vertices, mesh.indices.data(), mesh.indices.size()) ==
+		          GetCanonicalTriangles(
+		              expected.vertices, expected.indices.data(), expected.indices.size());
+	}
+	CHECK(isSame);
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
+
+TEST(InvalidIndicesFallBackToDefaults) {
+	// 範囲外の番号と、先頭より前を指す負の番号
+	const char text[] = "v 1 2 3\n"
+	                    "v 4 5 6\n"
+	                    "v 7 8 9\n"
+	                    "vn 0 1 0\n"
+	                    "f 1//1 2//1 9//1\n"
+	                    "f -5//1 -4//1 -3//1\n"
+	                    "f 0//1 1//2 2//1\n";
+	for (bool smoothing : {false, true}) {
+		ModelData modelData;
+		CHECK(LoadText(text, smoothing, modelData));
+		CHECK(modelData.meshes.size() == 1);
+		const MeshData& mesh = modelData.meshes[0];
+		CHECK(mesh.indices.size() == 9);
+		bool hasDefault = false;
+		bool isInRange = true;
+		for (uint32_t index : mesh.indices) {
+			isInRange &= index < mesh.vertices.size();
+			hasDefault |= isInRange && mesh.vertices[index].pos.x == 0.0f &&
+			              mesh.vertices[index].pos.y == 0.0f;
+		}
+		CHECK(isInRange);
+		CHECK(hasDefault);
+	}
+}
+
+TEST(SmoothingAveragesSharedPositions) {
+	// 直角に折れた2枚の面（折り目の頂点は法線が別々）
+	const char text[] = "v 0 0 0\n"
+	                    "v 0 1 0\n"
+	                    "v 1 0 0\n"
+	                    "v 0 0 1\n"
+	                    "vn 0 0 -1\n"
+	                    "vn -1 0 0\n"
+	                    "f 1//1 2//1 3//1\n"
+	                    "f 1//2 4//2 2//2\n";
+	ModelData flat;
+	ModelData smooth;
+	CHECK(LoadText(text, false, flat));
+	CHECK(LoadText(text, true, smooth));
+	// 平滑化すると折り目の頂点が1つに溶接される
+	CHECK(flat.meshes[0].vertices.size() == 6);
+	CHECK(smooth.meshes[0].vertices.size() == 4);
+	bool isAveraged = false;
+	for (const MeshVertex& vertex : smooth.meshes[0].vertices) {
+		if (vertex.pos.x == 0.0f && vertex.pos.z == 0.0f) {
+			isAveraged |= vertex.normal.x < -0.5f && vertex.normal.z < -0.5f;
+		}
+	}
+	CHECK(isAveraged);
+}
+
+TEST(LoadsMaterialLibrary) {
+	const std::filesystem::path directory = MakeTemporaryDirectory("ObjLoaderTestMaterial");
+	WriteTextFile(directory / "test.mtl", "newmtl a\nKa 1 0 0\nd 0.5\nmap_Kd ../textures/a.png\nnewmtl b\nKs 0 1 0\n");
+	WriteTextFile(directory / "test.obj", MakeGridObj(2, "test.mtl"));
+	ModelData modelData;
+	CHECK(ObjLoader::Load((directory / "test.obj").string(), false, modelData));
+	CHECK(modelData.materialLibraries == std::vector<std::string>{"test.mtl"});
+	CHECK(modelData.materials.size() == 2);
+	CHECK(modelData.materials[0].name == "a");
+	CHECK(modelData.materials[0].ambient.x == 1.0f);
+	CHECK(modelData.materials[0].alpha == 0.5f);
+	CHECK(modelData.materials[0].textureFilename == "a.png");
+	CHECK(modelData.materials[1].specular.y == 1.0f);
+	CHECK(!ObjLoader::Load((directory / "missing.obj").string(), false, modelData));
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
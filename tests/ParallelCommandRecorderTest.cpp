@@ -0,0 +1,193 @@
+#include "ParallelCommandRecorder.h"
+#include "TestFramework.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 命令を文字列で記録するだけのコマンドリスト
+struct FakeCommandList {
+	std::vector<std::string> commands;
+	bool isClosed = false;
+};
+
+// 受け取りと提出を記録するバックエンド
+class RecordingBackend : public CommandListBackend<FakeCommandList> {
+public:
+	RecordingBackend() : ownerThread_(std::this_thread::get_id()) {}
+
+	FakeCommandList* Acquire() override {
+		isOnOwnerThread_ &= std::this_thread::get_id() == ownerThread_;
+		lists_.push_back(std::make_unique<FakeCommandList>());
+		return lists_.back().get();
+	}
+
+	void Close(FakeCommandList* commandList) override {
+		std::lock_guard<std::mutex> lock(mutex_);
+		isClosedOnce_ &= !commandList->isClosed;
+		commandList->isClosed = true;
+	}
+
+	void Submit(FakeCommandList* const* commandLists, size_t count) override {
+		isOnOwnerThread_ &= std::this_thread::get_id() == ownerThread_;
+		submitCount_++;
+		submittedListCount_ += count;
+		for (size_t i = 0; i < count; i++) {
+			isClosedOnce_ &= commandLists[i]->isClosed;
+			submitted_.insert(
+			    submitted_.end(), commandLists[i]->commands.begin(),
+			    commandLists[i]->commands.end());
+		}
+	}
+
+	const std::vector<std::string>& GetSubmitted() const { return submitted_; }
+	size_t GetAcquireCount() const { return lists_.size(); }
+	size_t GetSubmitCount() const { return submitCount_; }
+	size_t GetSubmittedListCount() const { return submittedListCount_; }
+	bool IsOnOwnerThread() const { return isOnOwnerThread_; }
+	bool IsClosedOnce() const { return isClosedOnce_; }
+
+private:
+	std::thread::id ownerThread_;
+	std::vector<std::unique_ptr<FakeCommandList>> lists_;
+	std::vector<std::string> submitted_;
+	std::mutex mutex_;
+	size_t submitCount_ = 0;
+	size_t submittedListCount_ = 0;
+	bool isOnOwnerThread_ = true;
+	bool isClosedOnce_ = true;
+};
+
+// 記録にかかる時間の代わり（タスクごとに長さを変えて、終わる順をばらつかせる）
+uint32_t Busy(size_t iterationCount) {
+	volatile uint32_t value = 1;
+	for (size_t i = 0; i < iterationCount; i++) {
+		value = value * 1664525u + 1013904223u;
+	}
+	return value;
+}
+
+} // namespace
+
+TEST(ScheduleSplitsPassesEvenly) {
+	CommandRecordSchedule schedule;
+	schedule.SetMaxSplitCount(4);
+	CHECK(schedule.AddPass(10, 1) == 0);
+	CHECK(schedule.AddPass(3, 2) == 1);
+	// 排他グループを持つパスは分けない
+	CHECK(schedule.AddPass(100, 1, 5) == 2);
+	// 要素が無くても1つのタスクを作る
+	CHECK(schedule.AddPass(0, 8) == 3);
+
+	const std::vector<CommandRecordSchedule::Task>& tasks = schedule.GetTasks();
+	CHECK(tasks.size() == 4 + 2 + 1 + 1);
+	// 要素数の差は1以内で、範囲は隙間なく続く
+	const size_t expected[][3] = {{0, 0, 3},  {0, 3, 6}, {0, 6, 8},   {0, 8, 10},
+	                              {1, 0, 2},  {1, 2, 3}, {2, 0, 100}, {3, 0, 0}};
+	bool isSame = true;
+	for (size_t i = 0; i < tasks.size(); i++) {
+		isSame &= tasks[i].pass == expected[i][0];
+		isSame &= tasks[i].begin == expected[i][1] && tasks[i].end == expected[i][2];
+	}
+	CHECK(isSame);
+
+	schedule.Clear();
+	CHECK(schedule.GetTasks().empty());
+	CHECK(schedule.AddPass(1, 1) == 0);
+	// 上限を指定しなければ、呼び出し元も含めたスレッド数
+	schedule.SetMaxSplitCount(0);
+	CHECK(schedule.GetMaxSplitCount() == ThreadPool::GetInstance()->GetWorkerCount() + 1);
+}
+
+TEST(SubmitOrderIsDeterministic) {
+	// 背景のスプライト、分けて記録するモデル、地形、前景のスプライトの順に提出する
+	std::vector<std::string> expected = {"background"};
+	for (int i = 0; i < 1000; i++) {
+		expected.push_back("model" + std::to_string(i));
+	}
+	expected.insert(expected.end(), {"terrain", "foreground", "empty"});
+
+	const uint32_t kSpriteGroup = 0;
+	for (int round = 0; round < 50; round++) {
+		RecordingBackend backend;
+		ParallelCommandRecorder<FakeCommandList> recorder;
+		recorder.Initialize(&backend);
+		// 同じグループのパスは同時に実行されず、追加した順に実行される
+		std::atomic<int> activeSpriteCount{0};
+		std::atomic<int> spriteOrder{0};
+		std::atomic<bool> isExclusive{true};
+		std::atomic<bool> isInOrder{true};
+		auto recordSprite = [&](const char* name, int order) {
+			return [&, name, order](FakeCommandList* commandList, size_t, size_t) {
+				if (activeSpriteCount++ != 0) {
+					isExclusive = false;
+				}
+				if (spriteOrder++ != order) {
+					isInOrder = false;
+				}
+				Busy(size_t(round % 3) * 20000);
+				commandList->commands.push_back(name);
+				activeSpriteCount--;
+			};
+		};
+		recorder.AddPass(recordSprite("background", 0), kSpriteGroup);
+		recorder.AddPass(1000, 16, [&](FakeCommandList* commandList, size_t begin, size_t end) {
+			// 後ろの範囲ほど早く終わるようにして、終わった順と提出順を違えさせる
+			Busy((1000 - begin) * size_t(round % 4) * 50);
+			for (size_t i = begin; i < end; i++) {
+				commandList->commands.push_back("model" + std::to_string(i));
+			}
+		});
+		recorder.AddPass([](FakeCommandList* commandList, size_t, size_t) {
+			commandList->commands.push_back("terrain");
+		}, 1);
+		recorder.AddPass(recordSprite("foreground", 1), kSpriteGroup);
+		recorder.AddPass(0, 4, [](FakeCommandList* commandList, size_t begin, size_t end) {
+			commandList->commands.push_back(begin == 0 && end == 0 ? "empty" : "wrong range");
+		});
+		const size_t taskCount = recorder.GetSchedule().GetTasks().size();
+		recorder.Execute();
+
+		CHECK(backend.GetSubmitted() == expected);
+		CHECK(isExclusive && isInOrder);
+		// タスクごとに1つのコマンドリストを受け取り、1回の提出でまとめて渡す
+		CHECK(backend.GetAcquireCount() == taskCount);
+		CHECK(backend.GetSubmitCount() == 1 && backend.GetSubmittedListCount() == taskCount);
+		CHECK(backend.IsOnOwnerThread() && backend.IsClosedOnce());
+		// 提出したらパスは空になる
+		CHECK(recorder.GetSchedule().GetTasks().empty());
+	}
+}
+
+TEST(RecorderCanBeReusedEveryFrame) {
+	RecordingBackend backend;
+	ParallelCommandRecorder<FakeCommandList> recorder;
+	recorder.Initialize(&backend);
+	recorder.GetSchedule().SetMaxSplitCount(3);
+	std::vector<std::string> expected;
+	for (int frame = 0; frame < 10; frame++) {
+		const size_t itemCount = size_t(frame) * 7;
+		recorder.AddPass(itemCount, 2, [frame](FakeCommandList* list, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				list->commands.push_back(std::to_string(frame) + ":" + std::to_string(i));
+			}
+		});
+		for (size_t i = 0; i < itemCount; i++) {
+			expected.push_back(std::to_string(frame) + ":" + std::to_string(i));
+		}
+		recorder.Execute();
+	}
+	CHECK(backend.GetSubmitted() == expected);
+	CHECK(backend.GetSubmitCount() == 10);
+	// 1フレーム目は要素が無くても1つ、それ以降は最大3つに分ける
+	CHECK(backend.GetAcquireCount() == 1 + 9 * 3);
+
+	// パスが無ければ空の提出になる
+	recorder.Execute();
+	CHECK(backend.GetSubmitCount() == 11 && backend.GetAcquireCount() == 28);
+}
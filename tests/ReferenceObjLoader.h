@@ -0,0 +1,141 @@
+#pragma once
+
+#include "MathUtility.h"
+#include "MeshData.h"
+#include "ObjLoader.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// 並列化する前の ObjLoader::Load（1行ずつ istringstream で読む素朴な実装）
+// 今の ObjLoader と結果を比べる基準と、速さを比べる相手に使う
+
+/// <summary>
+/// OBJファイルを1スレッドで順に読み込む
+/// （溶接も描画順の最適化もせず、面の頂点ごとに頂点を作る）
+/// </summary>
+/// <param name="filePath">.objファイルのパス</param>
+/// <param name="smoothing">エッジ平滑化フラグ</param>
+/// <param name="modelData">出力先</param>
+/// <returns>成否</returns>
+inline bool LoadObjReference(const std::string& filePath, bool smoothing, ModelData& modelData) {
+	std::ifstream file(filePath);
+	if (file.fail()) {
+		return false;
+	}
+	const size_t slash = filePath.find_last_of("/\\");
+	const std::string directoryPath =
+	    slash == std::string::npos ? std::string() : filePath.substr(0, slash + 1);
+
+	// OBJのインデックス（1始まり、負数は末尾からの相対）を0始まりにする
+	auto resolveIndex = [](int32_t index, size_t count) {
+		return index < 0 ? int32_t(count) + index : index - 1;
+	};
+
+	modelData = ModelData{};
+	std::vector<Vector3> positions; // 頂点座標
+	std::vector<Vector3> normals;   // 法線ベクトル
+	std::vector<Vector2> texcoords; // テクスチャUV
+	MeshData mesh;
+	std::vector<uint32_t> positionIndices;
+
+	// 読み込み中のメッシュを確定する
+	auto finishMesh = [&]() {
+		if (mesh.vertices.empty()) {
+			return;
+		}
+		if (smoothing) {
+			ObjLoader::SmoothNormals(mesh, positionIndices);
+		}
+		mesh.bounds = ComputeAABB(mesh.vertices.data(), mesh.vertices.size(), sizeof(MeshVertex));
+		modelData.meshes.push_back(std::move(mesh));
+		mesh = MeshData{};
+		positionIndices.clear();
+	};
+
+	// 1行ずつ読み込む
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream lineStream(line);
+		std::string key;
+		lineStream >> key;
+
+		if (key == "g") {
+			// カレントメッシュの情報が揃っているなら確定して次のメッシュへ
+			finishMesh();
+			lineStream >> mesh.name;
+		} else if (key == "mtllib") {
+			std::string filename;
+			lineStream >> filename;
+			modelData.materialLibraries.push_back(filename);
+			ObjLoader::LoadMaterials(directoryPath + filename, modelData.materials);
+		} else if (key == "usemtl") {
+			// 最初に指定されたマテリアルを使う
+			if (mesh.materialName.empty()) {
+				lineStream >> mesh.materialName;
+			}
+		} else if (key == "v") {
+			Vector3 position{};
+			lineStream >> position.x >> position.y >> position.z;
+			positions.push_back(position);
+		} else if (key == "vt") {
+			Vector2 texcoord{};
+			lineStream >> texcoord.x >> texcoord.y;
+			// v方向反転
+			texcoord.y = 1.0f - texcoord.y;
+			texcoords.push_back(texcoord);
+		} else if (key == "vn") {
+			Vector3 normal{};
+			lineStream >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		} else if (key == "f") {
+			// 多角形は扇状に三角形分割する
+			const uint32_t firstVertex = uint32_t(mesh.vertices.size());
+			uint32_t cornerCount = 0;
+			std::string indexString;
+			while (lineStream >> indexString) {
+				// "p", "p/t", "p//n", "p/t/n"
+				int32_t indices[3] = {0, 0, 0};
+				const char* cursor = indexString.c_str();
+				for (int32_t& index : indices) {
+					char* end = nullptr;
+					index = int32_t(std::strtol(cursor, &end, 10));
+					cursor = end;
+					if (*cursor != '/') {
+						break;
+					}
+					cursor++;
+				}
+
+				MeshVertex vertex{};
+				const int32_t position = resolveIndex(indices[0], positions.size());
+				const int32_t texcoord = resolveIndex(indices[1], texcoords.size());
+				const int32_t normal = resolveIndex(indices[2], normals.size());
+				if (0 <= position && size_t(position) < positions.size()) {
+					vertex.pos = positions[position];
+				}
+				if (indices[1] != 0 && 0 <= texcoord && size_t(texcoord) < texcoords.size()) {
+					vertex.uv = texcoords[texcoord];
+				}
+				if (indices[2] != 0 && 0 <= normal && size_t(normal) < normals.size()) {
+					vertex.normal = normals[normal];
+				}
+				mesh.vertices.push_back(vertex);
+				positionIndices.push_back(uint32_t(position));
+
+				// 4頂点目以降は 先頭・直前・自身 で三角形を追加する
+				const uint32_t vertexIndex = uint32_t(mesh.vertices.size() - 1);
+				if (3 <= cornerCount) {
+					mesh.indices.push_back(firstVertex);
+					mesh.indices.push_back(vertexIndex - 1);
+				}
+				mesh.indices.push_back(vertexIndex);
+				cornerCount++;
+			}
+		}
+	}
+
+	finishMesh();
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// テストの登録と実行
+/// TEST で定義した関数を登録順に実行し、CHECK が失敗した箇所を表示して数える。
+/// 実行ファイルの引数に名前の一部を渡すと、それを含むテストだけを実行する
+/// </summary>
+class TestRegistry {
+public:
+	/// <summary>
+	/// シングルトンインスタンスの取得
+	/// </summary>
+	/// <returns>シングルトンインスタンス</returns>
+	static TestRegistry* GetInstance();
+
+	/// <summary>
+	/// テストの登録
+	/// </summary>
+	/// <param name="name">名前</param>
+	/// <param name="function">テスト関数</param>
+	/// <returns>常に true（静的変数の初期化で登録するため）</returns>
+	bool Add(const char* name, void (*function)());
+
+	/// <summary>
+	/// 失敗の記録
+	/// </summary>
+	/// <param name="file">ファイル名</param>
+	/// <param name="line">行番号</param>
+	/// <param name="expression">失敗した式</param>
+	void Fail(const char* file, int line, const char* expression);
+
+	/// <summary>
+	/// 登録したテストの実行
+	/// </summary>
+	/// <param name="filter">名前に含む文字列（nullptrなら全て）</param>
+	/// <returns>失敗した CHECK の数</returns>
+	size_t Run(const char* filter);
+
+private:
+	// 登録されたテスト
+	struct TestCase {
+		const char* name;
+		void (*function)();
+	};
+
+	std::vector<TestCase> tests_;
+	// 失敗した CHECK の数
+	size_t failureCount_ = 0;
+};
+
+// テスト関数の定義と登録
+#define TEST(name)                                                                                 \
+	static void name();                                                                            \
+	static const bool name##Registered = TestRegistry::GetInstance()->Add(#name, name);            \
+	static void name()
+
+// 条件の確認（失敗してもテストは続ける）
+#define CHECK(expression)                                                                          \
+	do {                                                                                           \
+		if (!(expression)) {                                                                       \
+			TestRegistry::GetInstance()->Fail(__FILE__, __LINE__, #expression);                    \
+		}                                                                                          \
+	} while (false)
@@ -0,0 +1,36 @@
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+
+TestRegistry* TestRegistry::GetInstance() {
+	static TestRegistry instance;
+	return &instance;
+}
+
+bool TestRegistry::Add(const char* name, void (*function)()) {
+	tests_.push_back({name, function});
+	return true;
+}
+
+void TestRegistry::Fail(const char* file, int line, const char* expression) {
+	std::printf("%s:%d: CHECK(%s) failed\n", file, line, expression);
+	failureCount_++;
+}
+
+size_t TestRegistry::Run(const char* filter) {
+	for (const TestCase& test : tests_) {
+		if (filter && !std::strstr(test.name, filter)) {
+			continue;
+		}
+		const size_t failureCount = failureCount_;
+		std::printf("[ RUN  ] %s\n", test.name);
+		test.function();
+		std::printf("[ %s ] %s\n", failureCount == failureCount_ ? " OK " : "FAIL", test.name);
+		std::fflush(stdout);
+	}
+	return failureCount_;
+}
+
+int main(int argc, char** argv) {
+	return TestRegistry::GetInstance()->Run(1 < argc ? argv[1] : nullptr) == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "MeshData.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+// テスト用の形状とファイル
+
+/// <summary>
+/// 起伏のある格子の高さ（簡略化で誤差が出るように）
+/// </summary>
+inline float GetGridHeight(uint32_t x, uint32_t y) {
+	return 0.25f * std::sin(float(x) * 0.7f) * std::cos(float(y) * 0.45f);
+}
+
+/// <summary>
+/// 格子のOBJテキスト（(n+1)^2 頂点、2n^2 三角形）
+/// </summary>
+/// <param name="n">一辺の区画数</param>
+/// <param name="materialLibrary">mtllib に書くファイル名（nullptrなら書かない）</param>
+inline std::string MakeGridObj(uint32_t n, const char* materialLibrary = nullptr) {
+	std::string text;
+	if (materialLibrary) {
+		text += std::string("mtllib ") + materialLibrary + "\n";
+	}
+	text += "g grid\nusemtl gridMaterial\n";
+	char line[128];
+	for (uint32_t y = 0; y <= n; y++) {
+		for (uint32_t x = 0; x <= n; x++) {
+			std::snprintf(line, sizeof(line), "v %u %.6f %u\n", x, GetGridHeight(x, y), y);
+			text += line;
+			std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", float(x) / float(n), float(y) / float(n));
+			text += line;
+		}
+	}
+	text += "vn 0 1 0\n";
+	const uint32_t stride = n + 1;
+	for (uint32_t y = 0; y < n; y++) {
+		for (uint32_t x = 0; x < n; x++) {
+			const uint32_t a = y * stride + x + 1;
+			const uint32_t b = a + 1;
+			const uint32_t c = a + stride;
+			const uint32_t d = c + 1;
+			std::snprintf(line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1\n", a, a, c, c, b, b);
+			text += line;
+			std::snprintf(line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1\n", b, b, c, c, d, d);
+			text += line;
+		}
+	}
+	return text;
+}
+
+/// <summary>
+/// 格子のメッシュ（行ごとに三角形を並べた素朴な順）
+/// </summary>
+/// <param name="n">一辺の区画数</param>
+inline MeshData MakeGridMesh(uint32_t n) {
+	MeshData mesh;
+	mesh.name = "grid";
+	const uint32_t stride = n + 1;
+	for (uint32_t y = 0; y <= n; y++) {
+		for (uint32_t x = 0; x <= n; x++) {
+			mesh.vertices.push_back(
+			    {{float(x), GetGridHeight(x, y), float(y)},
+			     {0.0f, 1.0f, 0.0f},
+			     {float(x) / float(n), float(y) / float(n)}});
+		}
+	}
+	for (uint32_t y = 0; y < n; y++) {
+		for (uint32_t x = 0; x < n; x++) {
+			const uint32_t a = y * stride + x;
+			mesh.indices.insert(mesh.indices.end(), {a, a + stride, a + 1, a + 1, a + stride, a + stride + 1});
+		}
+	}
+	mesh.bounds = {{0.0f, -0.25f, 0.0f}, {float(n), 0.25f, float(n)}};
+	return mesh;
+}
+
+/// <summary>
+/// 閉じた球（極は1頂点の扇）
+/// </summary>
+inline MeshData MakeSphereMesh(uint32_t rings, uint32_t segments, float radius) {
+	MeshData mesh;
+	auto addVertex = [&](float theta, float phi) {
+		const Vector3 normal = {
+		    std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+		mesh.vertices.push_back({{normal.x * radius, normal.y * radius, normal.z * radius}, normal, {phi, theta}});
+	};
+	addVertex(0.0f, 0.0f);
+	for (uint32_t ring = 1; ring < rings; ring++) {
+		for (uint32_t segment = 0; segment < segments; segment++) {
+			addVertex(
+			    3.1415927f * float(ring) / float(rings),
+			    6.2831853f * float(segment) / float(segments));
+		}
+	}
+	addVertex(3.1415927f, 0.0f);
+	const uint32_t bottom = uint32_t(mesh.vertices.size() - 1);
+	auto ringVertex = [&](uint32_t ring, uint32_t segment) {
+		return 1 + (ring - 1) * segments + segment % segments;
+	};
+	for (uint32_t segment = 0; segment < segments; segment++) {
+		mesh.indices.insert(
+		    mesh.indices.end(), {0, ringVertex(1, segment + 1), ringVertex(1, segment)});
+		for (uint32_t ring = 1; ring + 1 < rings; ring++) {
+			const uint32_t a = ringVertex(ring, segment);
+			const uint32_t b = ringVertex(ring, segment + 1);
+			const uint32_t c = ringVertex(ring + 1, segment);
+			const uint32_t d = ringVertex(ring + 1, segment + 1);
+			mesh.indices.insert(mesh.indices.end(), {a, b, c, c, b, d});
+		}
+		mesh.indices.insert(
+		    mesh.indices.end(),
+		    {bottom, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1)});
+	}
+	mesh.bounds = {{-radius, -radius, -radius}, {radius, radius, radius}};
+	return mesh;
+}
+
+/// <summary>
+/// 三角形の順をばらばらにする（最適化前の悪い入力として）
+/// </summary>
+inline void ShuffleTriangles(std::vector<uint32_t>& indices, uint32_t seed) {
+	std::vector<std::array<uint32_t, 3>> triangles(indices.size() / 3);
+	std::memcpy(triangles.data(), indices.data(), sizeof(uint32_t) * indices.size());
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(seed));
+	std::memcpy(indices.data(), triangles.data(), sizeof(uint32_t) * indices.size());
+}
+
+/// <summary>
+/// 三角形の頂点座標を、巻き順を保って正規化し並べたもの
+/// （頂点やインデックスの並べ替えで変わらないので、並べ替えの前後を比べられる）
+/// </summary>
+inline std::vector<std::array<float, 9>> GetCanonicalTriangles(
+    const std::vector<MeshVertex>& vertices, const uint32_t* indices, size_t indexCount) {
+	std::vector<std::array<float, 9>> triangles;
+	for (size_t i = 0; i + 2 < indexCount; i += 3) {
+		std::array<std::array<float, 3>, 3> corners;
+		for (size_t corner = 0; corner < 3; corner++) {
+			const Vector3& pos = vertices[indices[i + corner]].pos;
+			corners[corner] = {pos.x, pos.y, pos.z};
+		}
+		// 最小の頂点が先頭になるよう回転する
+		std::rotate(
+		    corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+		std::array<float, 9>& triangle = triangles.emplace_back();
+		std::memcpy(triangle.data(), corners.data(), sizeof(triangle));
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+/// <summary>
+/// テキストファイルの書き出し
+/// </summary>
+inline bool WriteTextFile(const std::filesystem::path& path, const std::string& text) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(text.data(), std::streamsize(text.size()));
+	return bool(file);
+}
+
+/// <summary>
+/// 空の一時ディレクトリを作る
+/// </summary>
+/// <param name="name">ディレクトリ名</param>
+inline std::filesystem::path MakeTemporaryDirectory(const char* name) {
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::error_code error;
+	std::filesystem::remove_all(path, error);
+	std::filesystem::create_directories(path, error);
+	return path;
+}
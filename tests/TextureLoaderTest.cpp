@@ -0,0 +1,175 @@
+#include "TestFramework.h"
+#include "TestMeshes.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// 各段階の呼び出し回数
+struct StageCounts {
+	std::atomic<int> decode{0};
+	std::atomic<int> generateMips{0};
+	std::atomic<int> compress{0};
+};
+
+// ファイル名の長さで塗った 4x4 の画像を作る（"missing" を含む名前は失敗する）
+TextureLoader::DecodeFunction MakeFakeDecode(StageCounts& counts) {
+	return [&counts](const std::string& filePath, TextureData& texture) {
+		counts.decode++;
+		if (filePath.find("missing") != std::string::npos) {
+			return false;
+		}
+		texture.Allocate(TextureFormat::kR8G8B8A8Unorm, 4, 4);
+		std::fill(texture.pixels.begin(), texture.pixels.end(), uint8_t(filePath.size()));
+		return true;
+	};
+}
+
+// 2x2 のミップを1枚足す
+TextureLoader::MipFunction MakeFakeMips(StageCounts& counts) {
+	return [&counts](TextureData& texture) {
+		counts.generateMips++;
+		const size_t offset = texture.pixels.size();
+		texture.mips.push_back({offset, 2, 2, 8, 16});
+		texture.pixels.resize(offset + 16, texture.pixels[0]);
+		return true;
+	};
+}
+
+// 画素をそのままに形式だけ BC 風に変える（大きさが4の倍数でなければ失敗）
+TextureLoader::CompressFunction MakeFakeCompress(StageCounts& counts) {
+	return [&counts](TextureData& texture) {
+		counts.compress++;
+		if (texture.GetWidth() % 4 != 0) {
+			return false;
+		}
+		texture.format = TextureFormat::kBC7Unorm;
+		for (TextureMip& mip : texture.mips) {
+			mip.rowPitch = 16 * ((mip.width + 3) / 4);
+			mip.slicePitch = mip.rowPitch * ((mip.height + 3) / 4);
+		}
+		texture.mips.resize(1);
+		texture.pixels.resize(texture.mips[0].slicePitch);
+		return true;
+	};
+}
+
+} // namespace
+
+TEST(RequestsCompleteWithTickets) {
+	StageCounts counts;
+	TextureLoader loader(MakeFakeDecode(counts), MakeFakeMips(counts));
+	std::vector<uint64_t> tickets;
+	std::vector<std::string> paths;
+	for (int i = 0; i < 32; i++) {
+		paths.push_back(
+		    (i % 8 == 7 ? "missing" : "texture") + std::string(size_t(i), 'x') + ".png");
+		tickets.push_back(loader.Request(paths.back()));
+	}
+	// 番号は0を使わず、依頼順に増える
+	CHECK(tickets[0] != 0);
+	CHECK(std::is_sorted(tickets.begin(), tickets.end()));
+	loader.Wait();
+	CHECK(loader.GetPendingCount() == 0);
+
+	std::vector<TextureLoader::Result> results;
+	CHECK(loader.Collect(results) == 32);
+	CHECK(loader.Collect(results) == 0);
+	CHECK(results.size() == 32);
+	bool isValid = true;
+	int succeededCount = 0;
+	for (const TextureLoader::Result& result : results) {
+		const size_t i =
+		    size_t(std::find(tickets.begin(), tickets.end(), result.ticket) - tickets.begin());
+		isValid &= i < tickets.size() && result.filePath == paths[i];
+		if (result.isSucceeded) {
+			succeededCount++;
+			isValid &= result.texture.GetMipCount() == 2;
+			isValid &= result.texture.pixels[0] == uint8_t(paths[i].size());
+		} else {
+			isValid &= result.texture.mips.empty() && result.texture.pixels.empty();
+		}
+	}
+	CHECK(isValid);
+	CHECK(succeededCount == 28);
+	CHECK(counts.decode == 32);
+	CHECK(counts.generateMips == 28);
+}
+
+TEST(FailedMipStageKeepsLevelZero) {
+	StageCounts counts;
+	TextureLoader loader(MakeFakeDecode(counts), [](TextureData&) { return false; });
+	TextureData texture;
+	CHECK(loader.LoadNow("texture.png", texture));
+	CHECK(texture.GetMipCount() == 1 && texture.GetWidth() == 4);
+	CHECK(!loader.LoadNow("missing.png", texture));
+	CHECK(texture.mips.empty());
+}
+
+TEST(CompressedResultsAreCached) {
+	const std::filesystem::path directory = MakeTemporaryDirectory("TextureLoaderTest");
+	const std::string sourcePath = (directory / "source.png").string();
+	WriteTextFile(sourcePath, "source image");
+
+	StageCounts counts;
+	TextureLoader::Stages stages{
+	    MakeFakeDecode(counts), MakeFakeMips(counts), MakeFakeCompress(counts), 1};
+	{
+		TextureLoader loader(stages);
+		TextureData texture;
+		CHECK(loader.LoadNow(sourcePath, texture));
+		CHECK(texture.format == TextureFormat::kBC7Unorm);
+		CHECK(counts.decode == 1 && counts.compress == 1);
+		CHECK(std::filesystem::exists(TextureCache::GetCachePath(sourcePath)));
+
+		// 2回目はキャッシュから読み、デコードも圧縮もしない
+		TextureData cached;
+		CHECK(loader.LoadNow(sourcePath, cached));
+		CHECK(counts.decode == 1 && counts.compress == 1);
+		CHECK(cached.format == texture.format && cached.pixels == texture.pixels);
+		CHECK(cached.GetWidth() == 4 && cached.GetHeight() == 4);
+	}
+	{
+		// 圧縮の設定が変われば作り直す
+		stages.compressionKey = 2;
+		TextureLoader loader(stages);
+		TextureData texture;
+		CHECK(loader.LoadNow(sourcePath, texture));
+		CHECK(counts.decode == 2 && counts.compress == 2);
+
+		// 元画像が変わっても作り直す
+		WriteTextFile(sourcePath, "edited image");
+		CHECK(loader.LoadNow(sourcePath, texture));
+		CHECK(counts.decode == 3 && counts.compress == 3);
+		CHECK(loader.LoadNow(sourcePath, texture));
+		CHECK(counts.decode == 3);
+	}
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
+
+TEST(LoaderCanBeDestroyedWhilePending) {
+	StageCounts counts;
+	std::atomic<int> finished{0};
+	{
+		TextureLoader loader(
+		    [&](const std::string& filePath, TextureData& texture) {
+			    const bool isDecoded = MakeFakeDecode(counts)(filePath, texture);
+			    finished++;
+			    return isDecoded;
+		    },
+		    nullptr);
+		for (int i = 0; i < 16; i++) {
+			loader.Request("texture.png");
+		}
+	}
+	// ワーカーは共有状態を持っているので、破棄後も最後まで処理できる
+	for (int i = 0; i < 1000 && finished < 16; i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CHECK(finished == 16);
+}
@@ -0,0 +1,305 @@
+#include "TestFramework.h"
+#include "TextureResidency.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+using State = TextureResidency::State;
+
+// 判断を素朴に求め直す基準（LRU の順は使った順の通し番号を毎回全て比べて決める）
+class ResidencyModel {
+public:
+	ResidencyModel(size_t textureCount, uint32_t evictionDelay)
+	    : entries_(textureCount), evictionDelay_(evictionDelay) {}
+
+	void SetBudget(uint64_t budget) { budget_ = budget; }
+
+	void Register(uint32_t id, uint64_t residentSize, uint64_t fallbackSize) {
+		Unregister(id);
+		Entry& entry = entries_[id];
+		entry = {State::kResident, residentSize, fallbackSize, frame_, false, ++sequence_};
+	}
+
+	void Unregister(uint32_t id) {
+		entries_[id].state = State::kUnregistered;
+		entries_[id].isRequested = false;
+	}
+
+	void Touch(uint32_t id) {
+		Entry& entry = entries_[id];
+		if (entry.state == State::kResident && entry.lastUsedFrame != frame_) {
+			entry.order = ++sequence_;
+		}
+		if (entry.state != State::kUnregistered) {
+			entry.lastUsedFrame = frame_;
+		}
+		if (entry.state == State::kEvicted && !entry.isRequested) {
+			entry.isRequested = true;
+			requests_.push_back(id);
+		}
+	}
+
+	void OnStreamed(uint32_t id, bool isSucceeded) {
+		Entry& entry = entries_[id];
+		if (entry.state != State::kStreaming) {
+			return;
+		}
+		entry.state = isSucceeded ? State::kResident : State::kEvicted;
+		if (isSucceeded) {
+			entry.lastUsedFrame = frame_;
+			entry.order = ++sequence_;
+		}
+	}
+
+	TextureResidency::Decisions Update(uint64_t frame) {
+		frame_ = frame;
+		TextureResidency::Decisions decisions;
+		for (uint32_t id : requests_) {
+			Entry& entry = entries_[id];
+			if (entry.state != State::kEvicted || !entry.isRequested) {
+				continue;
+			}
+			entry.isRequested = false;
+			const uint64_t growth = entry.residentSize - entry.fallbackSize;
+			while (GetUsage() + growth > budget_ && EvictOldest(decisions)) {
+			}
+			if (GetUsage() + growth <= budget_) {
+				entry.state = State::kStreaming;
+				decisions.restreams.push_back(id);
+			}
+		}
+		requests_.clear();
+		while (budget_ < GetUsage() && EvictOldest(decisions)) {
+		}
+		return decisions;
+	}
+
+	uint64_t GetUsage() const {
+		uint64_t usage = 0;
+		for (const Entry& entry : entries_) {
+			if (entry.state == State::kEvicted) {
+				usage += entry.fallbackSize;
+			} else if (entry.state != State::kUnregistered) {
+				usage += entry.residentSize;
+			}
+		}
+		return usage;
+	}
+
+	State GetState(uint32_t id) const { return entries_[id].state; }
+
+private:
+	struct Entry {
+		State state = State::kUnregistered;
+		uint64_t residentSize = 0;
+		uint64_t fallbackSize = 0;
+		uint64_t lastUsedFrame = 0;
+		bool isRequested = false;
+		// 最後に LRU の末尾へ移した通し番号
+		uint64_t order = 0;
+	};
+
+	bool EvictOldest(TextureResidency::Decisions& decisions) {
+		Entry* oldest = nullptr;
+		uint32_t oldestId = 0;
+		for (uint32_t id = 0; id < entries_.size(); id++) {
+			Entry& entry = entries_[id];
+			if (entry.state == State::kResident && entry.fallbackSize < entry.residentSize &&
+			    (!oldest || entry.order < oldest->order)) {
+				oldest = &entry;
+				oldestId = id;
+			}
+		}
+		if (!oldest || frame_ < oldest->lastUsedFrame + evictionDelay_) {
+			return false;
+		}
+		oldest->state = State::kEvicted;
+		decisions.evictions.push_back(oldestId);
+		return true;
+	}
+
+	std::vector<Entry> entries_;
+	std::vector<uint32_t> requests_;
+	uint64_t budget_ = TextureResidency::kUnlimitedBudget;
+	uint64_t frame_ = 0;
+	uint64_t sequence_ = 0;
+	uint32_t evictionDelay_;
+};
+
+// 読み込み直しの完了待ち
+struct PendingStream {
+	uint32_t id;
+	uint64_t completionFrame;
+};
+
+} // namespace
+
+TEST(EvictsLeastRecentlyUsedFirst) {
+	TextureResidency residency;
+	residency.SetEvictionDelay(2);
+	residency.Update(1);
+	residency.Register(0, 100, 10);
+	residency.Register(1, 100, 10);
+	residency.Register(2, 100, 10);
+	// 代替の方が大きくないものは追い出さない
+	residency.Register(3, 50, 50);
+	CHECK(residency.GetUsage() == 350);
+
+	residency.SetBudget(200);
+	TextureResidency::Decisions decisions = residency.Update(2);
+	// フレーム1に使ったものはまだ描画中かもしれない
+	CHECK(decisions.evictions.empty());
+
+	// フレーム2で 0 を使ったので、古い順は 1, 2, 0
+	residency.Touch(0);
+	decisions = residency.Update(3);
+	CHECK(decisions.evictions == std::vector<uint32_t>({1, 2}));
+	CHECK(residency.GetState(1) == State::kEvicted && residency.GetState(0) == State::kResident);
+	CHECK(residency.GetUsage() == 100 + 10 + 10 + 50);
+
+	// 追い出したものを使うと、次の Update で空きを作って読み込み直す
+	residency.Touch(2);
+	residency.Touch(2);
+	decisions = residency.Update(4);
+	CHECK(decisions.restreams == std::vector<uint32_t>({2}));
+	CHECK(decisions.evictions == std::vector<uint32_t>({0}));
+	CHECK(residency.GetState(2) == State::kStreaming);
+	CHECK(residency.GetUsage() == 10 + 10 + 100 + 50);
+
+	// 失敗すれば代替のまま
+	residency.OnStreamed(2, false);
+	CHECK(residency.GetState(2) == State::kEvicted && residency.GetUsage() == 80);
+	residency.Unregister(0);
+	residency.Unregister(2);
+	CHECK(residency.GetUsage() == 60);
+	CHECK(residency.GetState(2) == State::kUnregistered);
+}
+
+TEST(RestreamIsDeferredWhenNothingCanBeEvicted) {
+	TextureResidency residency;
+	residency.SetEvictionDelay(2);
+	residency.SetBudget(150);
+	residency.Register(0, 100, 10);
+	residency.Update(2);
+	residency.Register(1, 100, 10);
+	CHECK(residency.Update(3).evictions == std::vector<uint32_t>({0}));
+
+	// 1 は前のフレームで使ったばかりなので追い出せず、0 は代替のまま
+	residency.Touch(0);
+	residency.Touch(1);
+	TextureResidency::Decisions decisions = residency.Update(4);
+	CHECK(decisions.restreams.empty() && decisions.evictions.empty());
+	CHECK(residency.GetDeferredRestreamCount() == 1);
+	CHECK(residency.GetState(0) == State::kEvicted);
+
+	// 使い続ければ次のフレームで要求し直す
+	residency.Touch(0);
+	decisions = residency.Update(5);
+	CHECK(decisions.evictions == std::vector<uint32_t>({1}));
+	CHECK(decisions.restreams == std::vector<uint32_t>({0}));
+}
+
+TEST(TraceReplayMatchesModel) {
+	const uint32_t textureCount = 96;
+	const uint32_t evictionDelay = 2;
+	TextureResidency residency;
+	residency.SetEvictionDelay(evictionDelay);
+	ResidencyModel model(textureCount, evictionDelay);
+	std::mt19937 random(1);
+	std::vector<uint64_t> residentSizes(textureCount);
+	std::vector<uint64_t> fallbackSizes(textureCount);
+	uint64_t totalSize = 0;
+	for (uint32_t id = 0; id < textureCount; id++) {
+		residentSizes[id] = (1u << (random() % 8)) * 1024;
+		// 1割は代替の方が大きくないので追い出せない
+		fallbackSizes[id] = random() % 10 == 0 ? residentSizes[id] : residentSizes[id] / 16;
+		totalSize += residentSizes[id];
+		residency.Register(id, residentSizes[id], fallbackSizes[id]);
+		model.Register(id, residentSizes[id], fallbackSizes[id]);
+	}
+
+	std::deque<PendingStream> pending;
+	bool isSame = true;
+	bool isWithinBudget = true;
+	bool isDelayRespected = true;
+	size_t evictionCount = 0;
+	size_t restreamCount = 0;
+	std::vector<uint64_t> lastTouchedFrame(textureCount, 0);
+	for (uint64_t frame = 1; frame <= 3000; frame++) {
+		// 予算はときどき全体の 3～7 割の間で変える
+		if (frame % 250 == 1) {
+			const uint64_t budget = totalSize * (3 + random() % 5) / 10;
+			residency.SetBudget(budget);
+			model.SetBudget(budget);
+		}
+		const TextureResidency::Decisions decisions = residency.Update(frame);
+		const TextureResidency::Decisions expected = model.Update(frame);
+		isSame &= decisions.evictions == expected.evictions;
+		isSame &= decisions.restreams == expected.restreams;
+		isSame &= residency.GetUsage() == model.GetUsage();
+		evictionCount += decisions.evictions.size();
+		restreamCount += decisions.restreams.size();
+		for (uint32_t id : decisions.evictions) {
+			isDelayRespected &= lastTouchedFrame[id] + evictionDelay <= frame;
+		}
+		// 追い出せるものが残っている間は予算を超えない
+		if (residency.GetBudget() < residency.GetUsage()) {
+			for (uint32_t id = 0; id < textureCount; id++) {
+				if (residency.GetState(id) == State::kResident &&
+				    fallbackSizes[id] < residentSizes[id]) {
+					isWithinBudget &= frame < lastTouchedFrame[id] + evictionDelay;
+				}
+			}
+		}
+		for (uint32_t id : decisions.restreams) {
+			pending.push_back({id, frame + 1 + random() % 3});
+		}
+		while (!pending.empty() && pending.front().completionFrame <= frame) {
+			const bool isSucceeded = random() % 10 != 0;
+			const uint32_t id = pending.front().id;
+			residency.OnStreamed(id, isSucceeded);
+			model.OnStreamed(id, isSucceeded);
+			// 読み込み直したものは今のフレームで使ったものとして扱われる
+			if (isSucceeded) {
+				lastTouchedFrame[id] = frame;
+			}
+			pending.pop_front();
+		}
+
+		// 作業集合はゆっくり移り、ときどき遠くのものも使う
+		const uint32_t center = uint32_t(frame / 40) % textureCount;
+		for (int i = 0; i < 12; i++) {
+			const uint32_t id = random() % 8 == 0 ? uint32_t(random() % textureCount)
+			                                      : (center + random() % 16) % textureCount;
+			residency.Touch(id);
+			model.Touch(id);
+			lastTouchedFrame[id] = frame;
+		}
+		// ときどき登録し直す（読み込み中のものは完了の通知を捨てる）
+		if (frame % 97 == 0) {
+			const uint32_t id = random() % textureCount;
+			residency.Unregister(id);
+			model.Unregister(id);
+			pending.erase(
+			    std::remove_if(
+			        pending.begin(), pending.end(),
+			        [id](const PendingStream& stream) { return stream.id == id; }),
+			    pending.end());
+			residency.Register(id, residentSizes[id], fallbackSizes[id]);
+			model.Register(id, residentSizes[id], fallbackSizes[id]);
+			lastTouchedFrame[id] = frame;
+		}
+		for (uint32_t id = 0; id < textureCount; id++) {
+			isSame &= residency.GetState(id) == model.GetState(id);
+		}
+	}
+	CHECK(isSame);
+	CHECK(isWithinBudget);
+	CHECK(isDelayRespected);
+	CHECK(1000 < evictionCount && 1000 < restreamCount);
+	// 予算が足りないときは読み込み直しを見送ることがある
+	CHECK(0 < residency.GetDeferredRestreamCount());
+}
@@ -0,0 +1,177 @@
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include "TransformHierarchy.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Handle = TransformHierarchy::Handle;
+
+// 書き込み先の1要素のバイト数（定数バッファと同じ 256）
+const size_t kStride = 256;
+
+// ワールド行列を親から順に素朴に求め直す基準
+Matrix4x4 ComputeWorldMatrix(const TransformHierarchy& hierarchy, Handle handle) {
+	const Matrix4x4 local = MakeAffineMatrix(
+	    hierarchy.GetScale(handle), hierarchy.GetRotation(handle),
+	    hierarchy.GetTranslation(handle));
+	const Handle parent = hierarchy.GetParent(handle);
+	if (parent == TransformHierarchy::kInvalidHandle) {
+		return local;
+	}
+	return local * ComputeWorldMatrix(hierarchy, parent);
+}
+
+bool IsSameMatrix(const void* data, const Matrix4x4& matrix) {
+	return std::memcmp(data, &matrix, sizeof(Matrix4x4)) == 0;
+}
+
+// 親を持つノードの多い木（親は必ず先に作ったノード）
+std::vector<Handle> MakeRandomTree(TransformHierarchy& hierarchy, size_t nodeCount, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::vector<Handle> handles;
+	for (size_t i = 0; i < nodeCount; i++) {
+		if (i == 0 || random() % 3 == 0) {
+			handles.push_back(hierarchy.Create());
+		} else {
+			handles.push_back(hierarchy.Create(handles[random() % handles.size()]));
+		}
+	}
+	return handles;
+}
+
+void ChangeRandomNodes(
+    TransformHierarchy& hierarchy, const std::vector<Handle>& handles, int count,
+    std::mt19937& random) {
+	std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+	for (int i = 0; i < count; i++) {
+		const Handle handle = handles[random() % handles.size()];
+		hierarchy.SetTranslation(handle, {value(random), value(random), value(random)});
+		hierarchy.SetRotation(handle, {value(random), value(random), value(random)});
+		if (i % 4 == 0) {
+			hierarchy.SetScale(handle, {1.0f + value(random) * 0.5f, 1.0f, 1.0f});
+		}
+	}
+}
+
+} // namespace
+
+TEST(UpdateMatchesRecomputedWorldMatrices) {
+	TransformHierarchy hierarchy;
+	const std::vector<Handle> handles = MakeRandomTree(hierarchy, 3000, 1);
+	std::mt19937 random(2);
+	bool isSame = true;
+	for (int frame = 0; frame < 20; frame++) {
+		ChangeRandomNodes(hierarchy, handles, frame % 5 == 4 ? 0 : 60, random);
+		// 親の付け替え（先に作ったノードへ付けるので循環しない）
+		const Handle child = handles[1 + random() % (handles.size() - 1)];
+		hierarchy.SetParent(child, handles[random() % child]);
+		hierarchy.Update();
+		for (Handle handle : handles) {
+			isSame &= IsSameMatrix(
+			    &hierarchy.GetWorldMatrix(handle), ComputeWorldMatrix(hierarchy, handle));
+		}
+	}
+	CHECK(isSame);
+
+	// 変更が無ければ何も計算し直さない
+	hierarchy.Update();
+	CHECK(hierarchy.GetUpdatedCount() == 0);
+}
+
+TEST(EachFrameBufferCatchesUpOnChanges) {
+	// 3フレーム分のバッファを順に使い、選んだバッファだけに、前に書いてから変わった分を書く
+	const size_t nodeCount = 2000;
+	const size_t bufferCount = 3;
+	TransformHierarchy hierarchy;
+	const std::vector<Handle> handles = MakeRandomTree(hierarchy, nodeCount, 3);
+	std::vector<std::vector<uint8_t>> buffers(
+	    bufferCount, std::vector<uint8_t>(nodeCount * kStride, 0xCD));
+	void* addresses[bufferCount];
+	for (size_t i = 0; i < bufferCount; i++) {
+		addresses[i] = buffers[i].data();
+	}
+	hierarchy.SetOutputBuffers(addresses, bufferCount, nodeCount, kStride);
+
+	std::mt19937 random(4);
+	bool isWritten = true;
+	bool isOthersKept = true;
+	bool isPaddingKept = true;
+	for (size_t frame = 0; frame < 40; frame++) {
+		const size_t index = frame % bufferCount;
+		ChangeRandomNodes(hierarchy, handles, frame % 7 == 6 ? 0 : int(random() % 50), random);
+		// 描画中の他のフレームのバッファは書き換えない
+		std::vector<std::vector<uint8_t>> before = buffers;
+		hierarchy.SetOutputIndex(index);
+		hierarchy.Update();
+		for (size_t i = 0; i < bufferCount; i++) {
+			if (i != index) {
+				isOthersKept &= buffers[i] == before[i];
+			}
+		}
+		for (Handle handle : handles) {
+			const uint8_t* element = buffers[index].data() + hierarchy.GetOffset(handle);
+			isWritten &= IsSameMatrix(element, hierarchy.GetWorldMatrix(handle));
+			isPaddingKept &= element[sizeof(Matrix4x4)] == 0xCD && element[kStride - 1] == 0xCD;
+		}
+	}
+	CHECK(isWritten);
+	CHECK(isOthersKept);
+	CHECK(isPaddingKept);
+}
+
+TEST(SingleBufferIsWrittenEveryUpdate) {
+	TransformHierarchy hierarchy;
+	const Handle parent = hierarchy.Create();
+	const Handle child = hierarchy.Create(parent);
+	std::vector<uint8_t> buffer(2 * kStride);
+	hierarchy.SetOutputBuffer(buffer.data(), 2, kStride);
+	hierarchy.SetTranslation(parent, {1.0f, 2.0f, 3.0f});
+	hierarchy.Update();
+	CHECK(IsSameMatrix(&buffer[hierarchy.GetOffset(child)], hierarchy.GetWorldMatrix(child)));
+	CHECK(hierarchy.GetWorldMatrix(child).m[3][2] == 3.0f);
+
+	hierarchy.SetTranslation(parent, {4.0f, 5.0f, 6.0f});
+	hierarchy.Update();
+	CHECK(hierarchy.GetUpdatedCount() == 2);
+	CHECK(IsSameMatrix(&buffer[hierarchy.GetOffset(child)], hierarchy.GetWorldMatrix(child)));
+	CHECK(hierarchy.GetWorldMatrix(child).m[3][0] == 4.0f);
+	hierarchy.Update();
+	CHECK(hierarchy.GetUpdatedCount() == 0);
+}
+
+TEST(SetParentRejectsCycles) {
+	// root → a → b → c の鎖
+	TransformHierarchy hierarchy;
+	const Handle root = hierarchy.Create();
+	const Handle a = hierarchy.Create(root);
+	const Handle b = hierarchy.Create(a);
+	const Handle c = hierarchy.Create(b);
+	hierarchy.SetTranslation(root, {1.0f, 0.0f, 0.0f});
+	hierarchy.Update();
+
+	// 自身・子・孫を親にすると循環するので、何も変えない
+	CHECK(!hierarchy.SetParent(a, a));
+	CHECK(!hierarchy.SetParent(a, b));
+	CHECK(!hierarchy.SetParent(root, c));
+	CHECK(hierarchy.GetParent(a) == root && hierarchy.GetParent(c) == b);
+	CHECK(hierarchy.GetParent(root) == TransformHierarchy::kInvalidHandle);
+	hierarchy.Update();
+	CHECK(hierarchy.GetUpdatedCount() == 0);
+
+	// 祖先や別の枝へは付け替えられ、子を持つ子孫もルートにできる
+	CHECK(hierarchy.SetParent(c, root));
+	CHECK(hierarchy.SetParent(a, TransformHierarchy::kInvalidHandle));
+	CHECK(hierarchy.SetParent(a, c));
+	CHECK(hierarchy.SetParent(a, c));
+	hierarchy.Update();
+	bool isSame = true;
+	for (Handle handle : {root, a, b, c}) {
+		isSame &= IsSameMatrix(
+		    &hierarchy.GetWorldMatrix(handle), ComputeWorldMatrix(hierarchy, handle));
+	}
+	CHECK(isSame);
+	CHECK(hierarchy.GetWorldMatrix(b).m[3][0] == 1.0f);
+}
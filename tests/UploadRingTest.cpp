@@ -0,0 +1,108 @@
+#include "TestFramework.h"
+#include "UploadRing.h"
+#include <deque>
+#include <map>
+#include <random>
+
+namespace {
+
+// 使用中の区間（先頭 → 終わり）と重なるか
+bool Overlaps(const std::map<size_t, size_t>& live, size_t begin, size_t end) {
+	auto next = live.lower_bound(begin);
+	if (next != live.end() && next->first < end) {
+		return true;
+	}
+	return next != live.begin() && begin < std::prev(next)->second;
+}
+
+} // namespace
+
+TEST(AllocateWrapsAndReclaims) {
+	UploadRing ring(1024);
+	CHECK(ring.Allocate(400, 16) == 0);
+	CHECK(ring.Allocate(400, 256) == 512);
+	CHECK(ring.HasOpenAllocations());
+	ring.Close(1);
+	CHECK(!ring.HasOpenAllocations());
+	CHECK(ring.GetOldestFenceValue() == 1);
+	// 末尾の 112 バイトには入らず、先頭は使用中
+	CHECK(ring.Allocate(200, 16) == UploadRing::kInvalidOffset);
+	ring.Reclaim(0);
+	CHECK(ring.Allocate(200, 16) == UploadRing::kInvalidOffset);
+	ring.Reclaim(1);
+	CHECK(ring.GetUsedSize() == 0);
+	CHECK(ring.GetOldestFenceValue() == 0);
+	// 空になった後は全体を確保できる
+	CHECK(ring.Allocate(1024, 16) != UploadRing::kInvalidOffset);
+	ring.Close(2);
+	ring.Reclaim(2);
+	CHECK(ring.Allocate(1025, 16) == UploadRing::kInvalidOffset);
+}
+
+TEST(RandomTraceNeverOverlapsInFlightRegions) {
+	const size_t capacity = 1 << 16;
+	UploadRing ring(capacity);
+	std::mt19937 random(1);
+	std::uniform_int_distribution<size_t> sizeDistribution(1, capacity / 6);
+	std::uniform_int_distribution<int> alignmentShift(0, 9);
+	std::uniform_int_distribution<int> action(0, 9);
+
+	// 影のモデル: 使用中の区間と、その区間を使うフェンス値（Close 前は0）
+	std::map<size_t, size_t> live;
+	std::map<size_t, uint64_t> fences;
+	uint64_t nextFence = 1;
+	uint64_t completedFence = 0;
+	size_t allocationCount = 0;
+	size_t failureCount = 0;
+	bool isValid = true;
+	for (int step = 0; step < 200000; step++) {
+		const int choice = action(random);
+		if (choice < 6) {
+			const size_t size = sizeDistribution(random);
+			const size_t alignment = size_t(1) << alignmentShift(random);
+			const size_t offset = ring.Allocate(size, alignment);
+			if (offset == UploadRing::kInvalidOffset) {
+				failureCount++;
+				continue;
+			}
+			allocationCount++;
+			isValid &= offset % alignment == 0 && offset + size <= capacity;
+			isValid &= !Overlaps(live, offset, offset + size);
+			live[offset] = offset + size;
+			fences[offset] = 0;
+		} else if (choice < 8) {
+			ring.Close(nextFence);
+			for (auto& [offset, fence] : fences) {
+				fence = fence == 0 ? nextFence : fence;
+			}
+			nextFence++;
+		} else if (completedFence + 1 < nextFence) {
+			// GPUは遅れて進む
+			completedFence += 1 + size_t(choice == 9);
+			completedFence = (std::min)(completedFence, nextFence - 1);
+			ring.Reclaim(completedFence);
+			for (auto it = fences.begin(); it != fences.end();) {
+				if (it->second != 0 && it->second <= completedFence) {
+					live.erase(it->first);
+					it = fences.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+		// 使用量は生きている確保の合計以上、容量以下
+		size_t liveSize = 0;
+		for (const auto& [begin, end] : live) {
+			liveSize += end - begin;
+		}
+		isValid &= liveSize <= ring.GetUsedSize() && ring.GetUsedSize() <= capacity;
+	}
+	CHECK(isValid);
+	CHECK(1000 < allocationCount && 100 < failureCount);
+
+	// 全て完了すれば空になる
+	ring.Close(nextFence);
+	ring.Reclaim(nextFence);
+	CHECK(ring.GetUsedSize() == 0);
+	CHECK(!ring.HasOpenAllocations());
+}
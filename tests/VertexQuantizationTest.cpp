@@ -0,0 +1,148 @@
+#include "MathUtility.h"
+#include "TestFramework.h"
+#include "VertexQuantization.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// 乱数の頂点（座標は広めの範囲、UVは繰り返しを含む範囲）
+std::vector<MeshVertex> MakeRandomVertices(size_t count, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-37.0f, 120.0f);
+	std::uniform_real_distribution<float> texcoord(-2.0f, 3.0f);
+	std::normal_distribution<float> direction;
+	std::vector<MeshVertex> vertices(count);
+	for (MeshVertex& vertex : vertices) {
+		vertex.pos = {position(random), position(random) * 0.1f, position(random)};
+		vertex.normal = Normalize(Vector3{direction(random), direction(random), direction(random)});
+		vertex.uv = {texcoord(random), texcoord(random)};
+	}
+	return vertices;
+}
+
+} // namespace
+
+TEST(HalfConversionIsExact) {
+	CHECK(FloatToHalf(0.0f) == 0x0000);
+	CHECK(FloatToHalf(-0.0f) == 0x8000);
+	CHECK(FloatToHalf(1.0f) == 0x3C00);
+	CHECK(FloatToHalf(-2.0f) == 0xC000);
+	CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+	// 最小の非正規化数
+	CHECK(FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001);
+	// 最近接偶数丸め
+	CHECK(FloatToHalf(1.0f + std::ldexp(1.0f, -11)) == 0x3C00);
+	CHECK(FloatToHalf(1.0f + 3.0f * std::ldexp(1.0f, -11)) == 0x3C02);
+	// 範囲外は無限大
+	CHECK(FloatToHalf(1e6f) == 0x7C00);
+	CHECK(std::isinf(HalfToFloat(0x7C00)));
+	CHECK(std::isnan(HalfToFloat(FloatToHalf(std::nanf("")))));
+
+	// NaN 以外の全ての値が往復で一致する
+	bool isRoundTrip = true;
+	for (uint32_t bits = 0; bits < 0x10000; bits++) {
+		const uint16_t half = uint16_t(bits);
+		if ((half & 0x7C00) == 0x7C00 && (half & 0x03FF) != 0) {
+			continue;
+		}
+		isRoundTrip &= FloatToHalf(HalfToFloat(half)) == half;
+	}
+	CHECK(isRoundTrip);
+}
+
+TEST(OctahedralNormalsStayClose) {
+	// 軸方向は正確に戻る
+	const Vector3 axes[] = {
+	    {1.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}};
+	for (const Vector3& axis : axes) {
+		int16_t encoded[2];
+		EncodeOctahedral(axis, encoded);
+		const Vector3 decoded = DecodeOctahedral(encoded);
+		CHECK(Dot(decoded, axis) > 0.9999999f);
+	}
+	// 16bit の八面体写像は角度誤差がおよそ 1e-4 ラジアン以内
+	const std::vector<MeshVertex> vertices = MakeRandomVertices(100000, 1);
+	float maxAngle = 0.0f;
+	for (const MeshVertex& vertex : vertices) {
+		int16_t encoded[2];
+		EncodeOctahedral(vertex.normal, encoded);
+		const Vector3 decoded = DecodeOctahedral(encoded);
+		// acos は 1 付近で精度が足りないので外積の長さと内積から求める
+		maxAngle = (std::max)(
+		    maxAngle,
+		    std::atan2(Length(Cross(decoded, vertex.normal)), Dot(decoded, vertex.normal)));
+		CHECK(std::abs(Length(decoded) - 1.0f) < 1e-5f);
+	}
+	CHECK(maxAngle < 2e-4f);
+}
+
+TEST(Unorm16ErrorIsHalfAStep) {
+	const std::vector<MeshVertex> vertices = MakeRandomVertices(10000, 2);
+	const QuantizationParameters parameters =
+	    ComputeQuantizationParameters(vertices.data(), vertices.size(), VertexFormat::kUnorm16);
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	QuantizeVertices(vertices.data(), vertices.size(), VertexFormat::kUnorm16, parameters, quantized.data());
+
+	// 範囲を 65535 等分した刻みの半分（計算誤差の分だけ余裕を持たせる）
+	const Vector3 positionBound = parameters.positionScale * (0.5f / 65535.0f * 1.01f);
+	const Vector2 uvBound = {
+	    parameters.uvScale.x * (0.5f / 65535.0f * 1.01f), parameters.uvScale.y * (0.5f / 65535.0f * 1.01f)};
+	bool isWithinBound = true;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const MeshVertex decoded = DequantizeVertex(quantized[i], VertexFormat::kUnorm16, parameters);
+		const Vector3 difference = decoded.pos - vertices[i].pos;
+		isWithinBound &= std::abs(difference.x) <= positionBound.x + 1e-5f &&
+		                 std::abs(difference.y) <= positionBound.y + 1e-5f &&
+		                 std::abs(difference.z) <= positionBound.z + 1e-5f &&
+		                 std::abs(decoded.uv.x - vertices[i].uv.x) <= uvBound.x + 1e-6f &&
+		                 std::abs(decoded.uv.y - vertices[i].uv.y) <= uvBound.y + 1e-6f;
+		isWithinBound &= quantized[i].position[3] == 65535;
+	}
+	CHECK(isWithinBound);
+}
+
+TEST(HalfErrorIsRelative) {
+	const std::vector<MeshVertex> vertices = MakeRandomVertices(10000, 3);
+	const QuantizationParameters parameters =
+	    ComputeQuantizationParameters(vertices.data(), vertices.size(), VertexFormat::kHalf);
+	CHECK(parameters.positionScale.x == 1.0f && parameters.positionOffset.x == 0.0f);
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	QuantizeVertices(vertices.data(), vertices.size(), VertexFormat::kHalf, parameters, quantized.data());
+
+	// 半精度の仮数は10bitなので相対誤差は 2^-11 以内（非正規化数の範囲は絶対誤差 2^-25）
+	auto isClose = [](float decoded, float original) {
+		return std::abs(decoded - original) <=
+		       std::abs(original) * std::ldexp(1.0f, -11) + std::ldexp(1.0f, -25);
+	};
+	bool isWithinBound = true;
+	for (size_t i = 0; i < vertices.size(); i++) {
+		const MeshVertex decoded = DequantizeVertex(quantized[i], VertexFormat::kHalf, parameters);
+		isWithinBound &= isClose(decoded.pos.x, vertices[i].pos.x) &&
+		                 isClose(decoded.pos.y, vertices[i].pos.y) &&
+		                 isClose(decoded.pos.z, vertices[i].pos.z) &&
+		                 isClose(decoded.uv.x, vertices[i].uv.x) &&
+		                 isClose(decoded.uv.y, vertices[i].uv.y);
+	}
+	CHECK(isWithinBound);
+}
+
+TEST(FormatsAndDegenerateRanges) {
+	CHECK(GetVertexStride(VertexFormat::kFloat32) == sizeof(MeshVertex));
+	CHECK(GetVertexStride(VertexFormat::kHalf) == 16);
+	CHECK(GetVertexStride(VertexFormat::kUnorm16) == 16);
+	CHECK(sizeof(QuantizedVertex) == 16);
+
+	// 全頂点が同じ座標でも復元できる
+	std::vector<MeshVertex> vertices(
+	    3, MeshVertex{{5.0f, -1.0f, 2.0f}, {0.0f, 1.0f, 0.0f}, {0.5f, 0.5f}});
+	const QuantizationParameters parameters =
+	    ComputeQuantizationParameters(vertices.data(), vertices.size(), VertexFormat::kUnorm16);
+	std::vector<QuantizedVertex> quantized(vertices.size());
+	QuantizeVertices(vertices.data(), vertices.size(), VertexFormat::kUnorm16, parameters, quantized.data());
+	const MeshVertex decoded = DequantizeVertex(quantized[0], VertexFormat::kUnorm16, parameters);
+	CHECK(decoded.pos.x == 5.0f && decoded.pos.y == -1.0f && decoded.pos.z == 2.0f);
+	CHECK(decoded.uv.x == 0.5f && decoded.uv.y == 0.5f);
+	CHECK(std::abs(decoded.normal.y - 1.0f) < 1e-6f);
+}
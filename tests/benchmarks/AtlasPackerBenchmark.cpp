@@ -0,0 +1,57 @@
+#include "AtlasBuilder.h"
+#include "AtlasPacker.h"
+#include "Benchmark.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 詰める矩形の数
+const size_t kRectCount = 4000;
+// ページの一辺
+const uint32_t kPageSize = 4096;
+
+} // namespace
+
+BENCHMARK(AtlasPackerBenchmark) {
+	// スプライトらしく小さいものが多く、ときどき大きいものが混ざる
+	std::mt19937 random(1);
+	std::vector<AtlasPacker::Rect> sizes(kRectCount);
+	for (AtlasPacker::Rect& size : sizes) {
+		const uint32_t maxSide = random() % 8 == 0 ? 256 : 64;
+		size = {0, 0, 8 + uint32_t(random() % maxSide), 8 + uint32_t(random() % maxSide)};
+	}
+
+	AtlasPacker packer;
+	size_t placedCount = 0;
+	Report("AtlasPacker::Insert x4000 into 4096x4096", MeasureMilliseconds([&] {
+		       packer.Reset(kPageSize, kPageSize);
+		       placedCount = 0;
+		       for (const AtlasPacker::Rect& size : sizes) {
+			       AtlasPacker::Rect rect;
+			       placedCount += packer.Insert(size.width, size.height, rect) ? 1 : 0;
+		       }
+	       }));
+	std::printf(
+	    "  %-44s %10.2f %%  (%zu placed)\n", "occupancy of used range",
+	    100.0 * double(packer.GetUsedArea()) /
+	        (double(packer.GetUsedWidth()) * double(packer.GetUsedHeight())),
+	    placedCount);
+
+	// 画像を持たせて、大きさの降順に詰めてページを作る
+	AtlasBuilder builder;
+	for (size_t i = 0; i < 1000; i++) {
+		TextureData image;
+		image.Allocate(TextureFormat::kR8G8B8A8Unorm, sizes[i].width, sizes[i].height);
+		builder.Add("sprite" + std::to_string(i), std::move(image));
+	}
+	AtlasBuilder::Options options;
+	Report("AtlasBuilder::Build 1000 sprites", MeasureMilliseconds([&] {
+		       builder.Build(options);
+	       }));
+	std::printf(
+	    "  %-44s %10.2f %%  (%zu pages)\n", "AtlasBuilder efficiency",
+	    100.0 * builder.GetEfficiency(), builder.GetPages().size());
+}
@@ -0,0 +1,76 @@
+#include "Benchmark.h"
+#include "BlockCompressor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+// 計測する画像の一辺
+const uint32_t kTextureSize = 1024;
+
+// 滑らかな色の変化に細かい模様を重ねた写真風の画像
+TextureData MakePhotoTexture(uint32_t size) {
+	TextureData texture;
+	texture.Allocate(TextureFormat::kR8G8B8A8Unorm, size, size);
+	std::mt19937 random(1);
+	std::uniform_int_distribution<int> noise(-6, 6);
+	for (uint32_t y = 0; y < size; y++) {
+		for (uint32_t x = 0; x < size; x++) {
+			const float u = float(x) / float(size);
+			const float v = float(y) / float(size);
+			const float ring = std::sin(std::sqrt(u * u + v * v) * 40.0f) * 0.5f + 0.5f;
+			const int values[4] = {int(u * 255.0f), int(v * 255.0f), int(ring * 200.0f + 30.0f),
+			                       u + v < 1.0f ? 255 : 96};
+			uint8_t* pixel = texture.pixels.data() + (size_t(y) * size + x) * 4;
+			for (int c = 0; c < 4; c++) {
+				const int value = values[c] + (c < 3 ? noise(random) : 0);
+				pixel[c] = uint8_t(std::clamp(value, 0, 255));
+			}
+		}
+	}
+	return texture;
+}
+
+} // namespace
+
+BENCHMARK(BlockCompressorBenchmark) {
+	const TextureData source = MakePhotoTexture(kTextureSize);
+	const double pixelCount = double(kTextureSize) * kTextureSize;
+	const struct {
+		const char* name;
+		BlockCompressor::Format format;
+		int channelCount;
+	} cases[] = {
+	    {"BC1", BlockCompressor::Format::kBC1, 3}, {"BC3", BlockCompressor::Format::kBC3, 4},
+	    {"BC4", BlockCompressor::Format::kBC4, 1}, {"BC5", BlockCompressor::Format::kBC5, 2},
+	    {"BC7", BlockCompressor::Format::kBC7, 4},
+	};
+	for (const auto& benchmarkCase : cases) {
+		BlockCompressor::Options options;
+		options.format = benchmarkCase.format;
+		TextureData compressed;
+		const std::string label = std::string(benchmarkCase.name) + " 1024x1024";
+		Report(label.c_str(), MeasureMilliseconds([&] {
+			       compressed = source;
+			       BlockCompressor::Compress(compressed, options);
+		       }), pixelCount, "pix");
+
+		// 形式が持つ成分だけで画質を比べる
+		TextureData decompressed;
+		BlockCompressor::Decompress(compressed, decompressed);
+		double squaredError = 0.0;
+		for (size_t i = 0; i < source.pixels.size(); i++) {
+			if (int(i % 4) < benchmarkCase.channelCount) {
+				const double difference = double(source.pixels[i]) - double(decompressed.pixels[i]);
+				squaredError += difference * difference;
+			}
+		}
+		const double meanSquaredError = squaredError / (pixelCount * benchmarkCase.channelCount);
+		std::printf(
+		    "  %-44s %10.2f dB\n", (label + " PSNR").c_str(),
+		    10.0 * std::log10(255.0 * 255.0 / meanSquaredError));
+	}
+}
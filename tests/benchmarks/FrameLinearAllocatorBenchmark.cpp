@@ -0,0 +1,62 @@
+#include "Benchmark.h"
+#include "FrameLinearAllocator.h"
+#include "ThreadPool.h"
+#include <new>
+#include <vector>
+
+namespace {
+
+// 1フレームに確保する定数バッファの数と大きさ（ワールド行列1つ分を 256 バイト境界で）
+const size_t kObjectCount = 10000;
+const size_t kConstantSize = 64;
+const size_t kAlignment = 256;
+// 計測するフレーム数（描画中は最大3フレーム）
+const uint64_t kFrameCount = 100;
+
+} // namespace
+
+BENCHMARK(FrameLinearAllocatorBenchmark) {
+	const double allocationCount = double(kObjectCount) * kFrameCount;
+	std::vector<size_t> offsets(kObjectCount);
+
+	// 1スレッドから順に確保する
+	FrameLinearAllocator allocator;
+	allocator.Initialize(kObjectCount * kAlignment * 3);
+	uint64_t fenceValue = 0;
+	Report("ring, 1 thread", MeasureMilliseconds([&] {
+		       for (uint64_t frame = 0; frame < kFrameCount; frame++) {
+			       for (size_t i = 0; i < kObjectCount; i++) {
+				       offsets[i] = allocator.Allocate(kConstantSize, kAlignment);
+			       }
+			       allocator.EndFrame(++fenceValue);
+			       allocator.Reclaim(fenceValue < 2 ? 0 : fenceValue - 2);
+		       }
+	       }), allocationCount, "alloc");
+
+	// 全スレッドで取り合う
+	Report("ring, all threads", MeasureMilliseconds([&] {
+		       for (uint64_t frame = 0; frame < kFrameCount; frame++) {
+			       ThreadPool::GetInstance()->ParallelFor(
+			           kObjectCount, 256, [&](size_t begin, size_t end) {
+				           for (size_t i = begin; i < end; i++) {
+					           offsets[i] = allocator.Allocate(kConstantSize, kAlignment);
+				           }
+			           });
+			       allocator.EndFrame(++fenceValue);
+			       allocator.Reclaim(fenceValue < 2 ? 0 : fenceValue - 2);
+		       }
+	       }), allocationCount, "alloc");
+
+	// オブジェクトごとにヒープから確保して解放する比較
+	std::vector<void*> pointers(kObjectCount);
+	Report("aligned new/delete per object", MeasureMilliseconds([&] {
+		       for (uint64_t frame = 0; frame < kFrameCount; frame++) {
+			       for (void*& pointer : pointers) {
+				       pointer = ::operator new(kAlignment, std::align_val_t(kAlignment));
+			       }
+			       for (void* pointer : pointers) {
+				       ::operator delete(pointer, std::align_val_t(kAlignment));
+			       }
+		       }
+	       }), allocationCount, "alloc");
+}
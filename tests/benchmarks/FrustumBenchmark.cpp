@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+#include "Frustum.h"
+#include "MathUtility.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測する物体数
+const size_t kObjectCount = 1 << 16;
+
+} // namespace
+
+BENCHMARK(FrustumBenchmark) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+	std::uniform_real_distribution<float> radius(0.5f, 4.0f);
+	std::vector<Sphere> spheres(kObjectCount);
+	std::vector<AABB> aabbs(kObjectCount);
+	for (size_t i = 0; i < kObjectCount; i++) {
+		const Vector3 center = {position(random), position(random), position(random)};
+		const float r = radius(random);
+		spheres[i] = {center, r};
+		aabbs[i] = {{center.x - r, center.y - r, center.z - r}, {center.x + r, center.y + r, center.z + r}};
+	}
+	const Frustum frustum = Frustum::FromMatrices(
+	    MakeLookAtMatrix({0.0f, 10.0f, -50.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}),
+	    MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 300.0f));
+	std::vector<uint32_t> visible(kObjectCount);
+
+	size_t visibleCount = 0;
+	const double count = double(kObjectCount);
+	Report("Intersects(Sphere) x65536", MeasureMilliseconds([&] {
+		       visibleCount = 0;
+		       for (size_t i = 0; i < kObjectCount; i++) {
+			       if (frustum.Intersects(spheres[i])) {
+				       visible[visibleCount++] = uint32_t(i);
+			       }
+		       }
+	       }), count, "obj");
+	Report("CullSpheres x65536", MeasureMilliseconds([&] {
+		       visibleCount = frustum.CullSpheres(spheres.data(), kObjectCount, visible.data());
+	       }), count, "obj");
+	Report("Intersects(AABB) x65536", MeasureMilliseconds([&] {
+		       visibleCount = 0;
+		       for (size_t i = 0; i < kObjectCount; i++) {
+			       if (frustum.Intersects(aabbs[i])) {
+				       visible[visibleCount++] = uint32_t(i);
+			       }
+		       }
+	       }), count, "obj");
+	Report("CullAABBs x65536", MeasureMilliseconds([&] {
+		       visibleCount = frustum.CullAABBs(aabbs.data(), kObjectCount, visible.data());
+	       }), count, "obj");
+	std::printf("  visible %zu / %zu\n", visibleCount, kObjectCount);
+}
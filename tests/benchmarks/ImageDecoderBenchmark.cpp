@@ -0,0 +1,194 @@
+#include "Benchmark.h"
+#include "ImageDecoder.h"
+#include "Inflate.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// tests/tools/MakeDecoderFixtures.cpp が作った画像
+const std::string kFixtureDirectory = TEST_DATA_DIRECTORY "decoders/";
+
+// 大きな画像の一辺
+const uint32_t kImageSize = 1024;
+
+std::vector<uint8_t> ReadFixture(const std::string& fileName) {
+	std::ifstream file(kFixtureDirectory + fileName, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+// manifest.txt の指定した種類のファイル（zlib なら展開後の大きさも）
+struct Fixture {
+	std::vector<uint8_t> file;
+	size_t rawSize;
+};
+
+std::vector<Fixture> ReadFixtures(const std::string& kind) {
+	std::ifstream manifest(kFixtureDirectory + "manifest.txt");
+	std::vector<Fixture> fixtures;
+	std::string line;
+	while (std::getline(manifest, line)) {
+		std::istringstream stream(line);
+		std::string lineKind;
+		std::string fileName;
+		std::string size;
+		stream >> lineKind >> fileName >> size;
+		if (lineKind == kind) {
+			fixtures.push_back({ReadFixture(fileName), std::strtoul(size.c_str(), nullptr, 10)});
+		}
+	}
+	return fixtures;
+}
+
+void AppendU32(std::vector<uint8_t>& data, uint32_t value) {
+	for (int shift = 24; 0 <= shift; shift -= 8) {
+		data.push_back(uint8_t(value >> shift));
+	}
+}
+
+void AppendChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& body) {
+	AppendU32(png, uint32_t(body.size()));
+	png.insert(png.end(), type, type + 4);
+	png.insert(png.end(), body.begin(), body.end());
+	// CRC は読み込みで確かめないので0のまま
+	AppendU32(png, 0);
+}
+
+// 行ごとにフィルタを変えた PNG（展開ではなくフィルタの復元と変換を測るため非圧縮で格納する）
+std::vector<uint8_t> MakeStoredPng(uint32_t size, uint8_t colorType, uint32_t channelCount) {
+	std::mt19937 random(1);
+	const size_t rowSize = size_t(size) * channelCount;
+	std::vector<uint8_t> raw;
+	for (uint32_t y = 0; y < size; y++) {
+		raw.push_back(uint8_t(y % 5));
+		for (size_t x = 0; x < rowSize; x++) {
+			raw.push_back(uint8_t(random() % 8));
+		}
+	}
+	std::vector<uint8_t> zlib = {0x78, 0x01};
+	for (size_t offset = 0; offset < raw.size(); offset += 65535) {
+		const size_t length = (std::min)(raw.size() - offset, size_t(65535));
+		zlib.push_back(offset + length == raw.size() ? 1 : 0);
+		const uint16_t lengths[2] = {uint16_t(length), uint16_t(~length)};
+		for (uint16_t value : lengths) {
+			zlib.push_back(uint8_t(value));
+			zlib.push_back(uint8_t(value >> 8));
+		}
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+	}
+	uint32_t a = 1;
+	uint32_t b = 0;
+	for (uint8_t value : raw) {
+		a = (a + value) % 65521;
+		b = (b + a) % 65521;
+	}
+	AppendU32(zlib, (b << 16) | a);
+
+	std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', 13, 10, 26, 10};
+	std::vector<uint8_t> header;
+	AppendU32(header, size);
+	AppendU32(header, size);
+	header.insert(header.end(), {8, colorType, 0, 0, 0});
+	AppendChunk(png, "IHDR", header);
+	AppendChunk(png, "IDAT", zlib);
+	AppendChunk(png, "IEND", {});
+	return png;
+}
+
+// 同じ色の並びと細かい模様が混ざった RLE の 32bit TGA
+std::vector<uint8_t> MakeRleTga(uint32_t size) {
+	std::vector<uint8_t> tga(18, 0);
+	tga[2] = 10;
+	tga[12] = uint8_t(size);
+	tga[13] = uint8_t(size >> 8);
+	tga[14] = uint8_t(size);
+	tga[15] = uint8_t(size >> 8);
+	tga[16] = 32;
+	tga[17] = 0x28;
+	std::mt19937 random(2);
+	const size_t pixelCount = size_t(size) * size;
+	for (size_t i = 0; i < pixelCount;) {
+		const size_t count = (std::min)(pixelCount - i, size_t(1 + random() % 32));
+		if (random() % 2 == 0) {
+			tga.push_back(uint8_t(0x80 | (count - 1)));
+			for (int c = 0; c < 4; c++) {
+				tga.push_back(uint8_t(random()));
+			}
+		} else {
+			tga.push_back(uint8_t(count - 1));
+			for (size_t k = 0; k < count * 4; k++) {
+				tga.push_back(uint8_t(random()));
+			}
+		}
+		i += count;
+	}
+	return tga;
+}
+
+// 同じファイルを repeatCount 回デコードして、画素数を返す
+double DecodeAll(const std::vector<Fixture>& fixtures, int repeatCount) {
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	double pixelCount = 0.0;
+	for (int i = 0; i < repeatCount; i++) {
+		for (const Fixture& fixture : fixtures) {
+			TextureData texture;
+			if (registry->Decode(fixture.file.data(), fixture.file.size(), texture)) {
+				pixelCount += double(texture.GetWidth()) * texture.GetHeight();
+			}
+		}
+	}
+	return pixelCount;
+}
+
+} // namespace
+
+BENCHMARK(ImageDecoderBenchmark) {
+	ImageDecoderRegistry* registry = ImageDecoderRegistry::GetInstance();
+	const double pixelCount = double(kImageSize) * kImageSize;
+	const struct {
+		const char* label;
+		std::vector<uint8_t> file;
+	} images[] = {
+	    {"PNG RGBA8 1024x1024 (stored)", MakeStoredPng(kImageSize, 6, 4)},
+	    {"PNG RGB8 1024x1024 (stored)", MakeStoredPng(kImageSize, 2, 3)},
+	    {"TGA RLE 32bit 1024x1024", MakeRleTga(kImageSize)},
+	};
+	for (const auto& image : images) {
+		TextureData texture;
+		Report(image.label, MeasureMilliseconds([&] {
+			       registry->Decode(image.file.data(), image.file.size(), texture);
+		       }), pixelCount, "pix");
+	}
+
+	// 小さな画像はヘッダの解析と確保の分も含めた速さになる
+	const std::vector<Fixture> pngFixtures = ReadFixtures("png");
+	const std::vector<Fixture> jpegFixtures = ReadFixtures("jpeg");
+	double pngPixelCount = 0.0;
+	const double pngMilliseconds =
+	    MeasureMilliseconds([&] { pngPixelCount = DecodeAll(pngFixtures, 200); });
+	Report("PNG fixtures x200", pngMilliseconds, pngPixelCount, "pix");
+	double jpegPixelCount = 0.0;
+	const double jpegMilliseconds =
+	    MeasureMilliseconds([&] { jpegPixelCount = DecodeAll(jpegFixtures, 200); });
+	Report("JPEG fixtures x200", jpegMilliseconds, jpegPixelCount, "pix");
+
+	const std::vector<Fixture> zlibFixtures = ReadFixtures("zlib");
+	double inflatedSize = 0.0;
+	const double inflateMilliseconds = MeasureMilliseconds([&] {
+		inflatedSize = 0.0;
+		for (int i = 0; i < 200; i++) {
+			for (const Fixture& fixture : zlibFixtures) {
+				std::vector<uint8_t> output(fixture.rawSize);
+				Inflate::DecompressZlib(
+				    fixture.file.data(), fixture.file.size(), output.data(), output.size());
+				inflatedSize += double(output.size());
+			}
+		}
+	});
+	Report("Inflate zlib fixtures x200", inflateMilliseconds, inflatedSize, "B");
+}
@@ -0,0 +1,31 @@
+#include "Benchmark.h"
+#include "InstanceBatcher.h"
+#include "MathUtility.h"
+#include <random>
+
+namespace {
+
+// 計測する描画要求の数
+const uint32_t kRequestCount = 1 << 16;
+
+} // namespace
+
+BENCHMARK(InstanceBatcherBenchmark) {
+	std::mt19937 random(1);
+	std::uniform_int_distribution<uint32_t> keyDistribution(0, 63);
+	std::vector<uint32_t> keys(kRequestCount);
+	std::vector<Matrix4x4> worlds(kRequestCount);
+	for (uint32_t i = 0; i < kRequestCount; i++) {
+		keys[i] = keyDistribution(random);
+		worlds[i] = MakeTranslationMatrix({float(i), 0.0f, 0.0f});
+	}
+
+	InstanceBatcher batcher;
+	Report("Add + Build 65536 requests / 64 keys", MeasureMilliseconds([&] {
+		       batcher.Clear();
+		       for (uint32_t i = 0; i < kRequestCount; i++) {
+			       batcher.Add(keys[i], worlds[i]);
+		       }
+		       batcher.Build();
+	       }), double(kRequestCount), "req");
+}
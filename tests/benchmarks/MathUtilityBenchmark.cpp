@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include "MathUtility.h"
+#include <random>
+#include <vector>
+
+namespace {
+
+// 計測する要素数
+const size_t kTransformCount = 1 << 16;
+
+} // namespace
+
+BENCHMARK(MathUtilityBenchmark) {
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> value(-5.0f, 5.0f);
+	std::vector<Vector3> points(kTransformCount);
+	for (Vector3& point : points) {
+		point = {value(random), value(random), value(random)};
+	}
+	std::vector<Matrix4x4> matrices(kTransformCount);
+	for (Matrix4x4& matrix : matrices) {
+		matrix = MakeAffineMatrix(
+		    {1.0f, 1.0f, 1.0f}, {value(random), value(random), value(random)},
+		    {value(random), value(random), value(random)});
+	}
+	const Matrix4x4 viewProjection = Multiply(
+	    MakeLookAtMatrix({0.0f, 5.0f, -20.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}),
+	    MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 1000.0f));
+	std::vector<Vector3> transformed(kTransformCount);
+	std::vector<Matrix4x4> products(kTransformCount);
+
+	const double count = double(kTransformCount);
+	Report("Multiply x65536", MeasureMilliseconds([&] {
+		       for (size_t i = 0; i < kTransformCount; i++) {
+			       products[i] = Multiply(matrices[i], viewProjection);
+		       }
+	       }), count, "mat");
+	Report("MultiplyArray x65536", MeasureMilliseconds([&] {
+		       MultiplyArray(matrices.data(), viewProjection, products.data(), kTransformCount);
+	       }), count, "mat");
+	Report("Inverse x65536", MeasureMilliseconds([&] {
+		       for (size_t i = 0; i < kTransformCount; i++) {
+			       products[i] = Inverse(matrices[i]);
+		       }
+	       }), count, "mat");
+	Report("InverseAffine x65536", MeasureMilliseconds([&] {
+		       for (size_t i = 0; i < kTransformCount; i++) {
+			       products[i] = InverseAffine(matrices[i]);
+		       }
+	       }), count, "mat");
+	Report("TransformPoint x65536", MeasureMilliseconds([&] {
+		       for (size_t i = 0; i < kTransformCount; i++) {
+			       transformed[i] = TransformPoint(points[i], viewProjection);
+		       }
+	       }), count, "pt");
+	Report("TransformPoints x65536", MeasureMilliseconds([&] {
+		       TransformPoints(points.data(), transformed.data(), kTransformCount, viewProjection);
+	       }), count, "pt");
+}
@@ -0,0 +1,28 @@
+#include "Benchmark.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "TestMeshes.h"
+
+BENCHMARK(MeshCacheBenchmark) {
+	const std::filesystem::path directory = MakeTemporaryDirectory("MeshCacheBenchmark");
+	const std::string objPath = (directory / "grid.obj").string();
+	WriteTextFile(objPath, MakeGridObj(512));
+	const double fileSize = double(std::filesystem::file_size(objPath));
+
+	ModelData modelData;
+	Report("ObjLoader::Load 512x512 grid", MeasureMilliseconds([&] {
+		       ObjLoader::Load(objPath, false, modelData);
+	       }), fileSize, "B");
+	MeshCache cache;
+	Report("MeshCache cold build", MeasureMilliseconds([&] {
+		       std::filesystem::remove(MeshCache::GetCachePath(objPath, false));
+		       cache.LoadOrBuild(objPath, false);
+	       }), fileSize, "B");
+	Report("MeshCache warm load", MeasureMilliseconds([&] {
+		       cache.LoadOrBuild(objPath, false);
+	       }));
+	cache.Close();
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,30 @@
+#include "Benchmark.h"
+#include "MeshOptimizer.h"
+#include "TestMeshes.h"
+
+BENCHMARK(MeshOptimizerBenchmark) {
+	const uint32_t n = 256;
+	const MeshData source = [&] {
+		MeshData mesh = MakeGridMesh(n);
+		ShuffleTriangles(mesh.indices, 1);
+		return mesh;
+	}();
+	const double triangleCount = double(source.indices.size() / 3);
+
+	for (bool optimizeOverdraw : {false, true}) {
+		MeshOptimizer::Options options;
+		options.optimizeOverdraw = optimizeOverdraw;
+		MeshOptimizer::Report report;
+		MeshData mesh;
+		Report(
+		    optimizeOverdraw ? "Optimize 256x256 shuffled grid" : "Optimize 256x256 (no overdraw)",
+		    MeasureMilliseconds([&] {
+			    mesh = source;
+			    MeshOptimizer::Optimize(mesh, options, &report);
+		    }),
+		    triangleCount, "tri");
+		std::printf(
+		    "    ACMR %.3f -> %.3f  ATVR %.3f -> %.3f\n", report.before.acmr, report.after.acmr,
+		    report.before.atvr, report.after.atvr);
+	}
+}
@@ -0,0 +1,27 @@
+#include "Benchmark.h"
+#include "MeshSimplifier.h"
+#include "TestMeshes.h"
+
+BENCHMARK(MeshSimplifierBenchmark) {
+	const MeshData source = MakeGridMesh(256);
+	const double triangleCount = double(source.indices.size() / 3);
+	std::vector<uint32_t> indices;
+	float error = 0.0f;
+	Report("Simplify 256x256 grid to 25%", MeasureMilliseconds([&] {
+		       indices = MeshSimplifier::Simplify(
+		           source.vertices, source.indices, source.indices.size() / 4, 1e9f, &error);
+	       }), triangleCount, "tri");
+	std::printf(
+	    "    %zu -> %zu triangles, error %g\n", source.indices.size() / 3, indices.size() / 3, error);
+
+	MeshData mesh;
+	Report("GenerateLods 256x256 grid x4", MeasureMilliseconds([&] {
+		       mesh = source;
+		       MeshSimplifier::GenerateLods(mesh, 4);
+	       }), triangleCount, "tri");
+	for (size_t lod = 0; lod < mesh.lods.size(); lod++) {
+		std::printf(
+		    "    LOD%zu %zu triangles, error %g\n", lod + 1, mesh.lods[lod].indices.size() / 3,
+		    mesh.lods[lod].error);
+	}
+}
@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include "MathUtility.h"
+#include "MeshletBuilder.h"
+#include "MeshletCuller.h"
+#include "TestMeshes.h"
+
+namespace {
+
+// 計測するカメラ位置の数（球の周りを1周する）
+const int kFrameCount = 64;
+
+} // namespace
+
+BENCHMARK(MeshletBenchmark) {
+	const MeshData source = MakeSphereMesh(256, 512, 1.0f);
+	const double triangleCount = double(source.indices.size() / 3);
+	MeshData mesh;
+	Report("MeshletBuilder::Build 261k-triangle sphere", MeasureMilliseconds([&] {
+		       mesh = source;
+		       MeshletBuilder::Build(mesh);
+	       }), triangleCount, "tri");
+
+	MeshletCuller culler;
+	culler.Initialize(mesh.meshlets);
+	const Matrix4x4 projection = MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 100.0f);
+	std::vector<IndexRange> ranges;
+	size_t frustumCulled = 0;
+	size_t backfaceCulled = 0;
+	const double milliseconds = MeasureMilliseconds([&] {
+		frustumCulled = 0;
+		backfaceCulled = 0;
+		for (int frame = 0; frame < kFrameCount; frame++) {
+			// 近くから球の一部を見る
+			const float angle = 6.2831853f * float(frame) / float(kFrameCount);
+			const Vector3 eye = {std::cos(angle) * 1.6f, 0.3f, std::sin(angle) * 1.6f};
+			const Matrix4x4 view = MakeLookAtMatrix(eye, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+			const MeshletCuller::Statistics& statistics =
+			    culler.Cull(MakeIdentityMatrix(), view, projection, ranges);
+			frustumCulled += statistics.frustumCulledTriangleCount;
+			backfaceCulled += statistics.backfaceCulledTriangleCount;
+		}
+	});
+	Report("MeshletCuller::Cull per frame", milliseconds / kFrameCount);
+	std::printf(
+	    "    %zu meshlets, rejected per frame: %.0f frustum + %.0f backface of %.0f triangles\n",
+	    mesh.meshlets.size(), double(frustumCulled) / kFrameCount,
+	    double(backfaceCulled) / kFrameCount, triangleCount);
+}
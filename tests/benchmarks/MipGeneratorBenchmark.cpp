@@ -0,0 +1,41 @@
+#include "Benchmark.h"
+#include "MipGenerator.h"
+#include <random>
+
+namespace {
+
+// 計測する画像の一辺
+const uint32_t kTextureSize = 2048;
+
+} // namespace
+
+BENCHMARK(MipGeneratorBenchmark) {
+	TextureData source;
+	source.Allocate(TextureFormat::kR8G8B8A8UnormSrgb, kTextureSize, kTextureSize);
+	std::mt19937 random(1);
+	for (uint8_t& value : source.pixels) {
+		value = uint8_t(random());
+	}
+	// 速度はレベル0の画素数で数える
+	const double pixelCount = double(kTextureSize) * kTextureSize;
+	const struct {
+		const char* label;
+		MipGenerator::Filter filter;
+		float alphaCoverageReference;
+	} cases[] = {
+	    {"Box 2048x2048", MipGenerator::Filter::kBox, 0.0f},
+	    {"Kaiser 2048x2048", MipGenerator::Filter::kKaiser, 0.0f},
+	    {"Lanczos 2048x2048", MipGenerator::Filter::kLanczos, 0.0f},
+	    {"Kaiser 2048x2048 alpha coverage", MipGenerator::Filter::kKaiser, 0.5f},
+	};
+	for (const auto& benchmarkCase : cases) {
+		MipGenerator::Options options;
+		options.filter = benchmarkCase.filter;
+		options.alphaCoverageReference = benchmarkCase.alphaCoverageReference;
+		TextureData texture;
+		Report(benchmarkCase.label, MeasureMilliseconds([&] {
+			       texture = source;
+			       MipGenerator::Generate(texture, options);
+		       }), pixelCount, "pix");
+	}
+}
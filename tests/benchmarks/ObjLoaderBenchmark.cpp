@@ -0,0 +1,56 @@
+#include "Benchmark.h"
+#include "ObjLoader.h"
+#include "ReferenceObjLoader.h"
+#include "TestMeshes.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// 100万三角形を超える格子の一辺（2 * 708^2 = 1,002,528 三角形）
+const uint32_t kMillionTriangleGridSize = 708;
+
+} // namespace
+
+BENCHMARK(ObjLoaderBenchmark) {
+	const std::filesystem::path directory = MakeTemporaryDirectory("ObjLoaderBenchmark");
+	for (uint32_t n : {64u, 256u, 512u}) {
+		const std::string objPath = (directory / "grid.obj").string();
+		WriteTextFile(objPath, MakeGridObj(n));
+		const double fileSize = double(std::filesystem::file_size(objPath));
+		ModelData modelData;
+		char label[64];
+		std::snprintf(label, sizeof(label), "ObjLoader::Load %ux%u grid", n, n);
+		Report(label, MeasureMilliseconds([&] {
+			       ObjLoader::Load(objPath, false, modelData);
+		       }), fileSize, "B");
+		std::snprintf(label, sizeof(label), "ObjLoader::Load %ux%u grid (smoothing)", n, n);
+		Report(label, MeasureMilliseconds([&] {
+			       ObjLoader::Load(objPath, true, modelData);
+		       }), fileSize, "B");
+	}
+
+	// 100万三角形で、並列化する前の1行ずつ読む実装と比べる
+	// （今の実装は溶接と描画順の最適化も含む。結果が同じことは ObjLoaderTest で確かめる）
+	const uint32_t n = kMillionTriangleGridSize;
+	const std::string objPath = (directory / "million.obj").string();
+	WriteTextFile(objPath, MakeGridObj(n));
+	const double fileSize = double(std::filesystem::file_size(objPath));
+	ModelData modelData;
+	const double referenceMilliseconds = MeasureMilliseconds([&] {
+		LoadObjReference(objPath, false, modelData);
+	}, 3);
+	char label[64];
+	std::snprintf(label, sizeof(label), "reference stream parser %ux%u grid", n, n);
+	Report(label, referenceMilliseconds, fileSize, "B");
+	const double milliseconds = MeasureMilliseconds([&] {
+		ObjLoader::Load(objPath, false, modelData);
+	}, 3);
+	std::snprintf(label, sizeof(label), "ObjLoader::Load %ux%u grid", n, n);
+	Report(label, milliseconds, fileSize, "B");
+	std::printf(
+	    "  %-44s %10.2f x (%zu threads)\n", "speedup over reference",
+	    referenceMilliseconds / milliseconds, ThreadPool::GetInstance()->GetWorkerCount() + 1);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
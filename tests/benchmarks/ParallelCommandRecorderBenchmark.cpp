@@ -0,0 +1,91 @@
+#include "Benchmark.h"
+#include "ParallelCommandRecorder.h"
+#include "ThreadPool.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 1フレームに記録する描画の数
+const size_t kDrawCount = 20000;
+
+// 描画1回分の命令（定数バッファのアドレスとインデックス数の代わり）
+struct DrawCommand {
+	uint64_t constantAddress;
+	uint32_t indexCount;
+	uint32_t instanceCount;
+};
+
+struct FakeCommandList {
+	std::vector<DrawCommand> commands;
+};
+
+// コマンドリストを使い回し、提出では命令数を数えるだけのバックエンド
+class NullBackend : public CommandListBackend<FakeCommandList> {
+public:
+	FakeCommandList* Acquire() override {
+		if (lists_.size() <= usedCount_) {
+			lists_.push_back(std::make_unique<FakeCommandList>());
+		}
+		FakeCommandList* commandList = lists_[usedCount_++].get();
+		commandList->commands.clear();
+		return commandList;
+	}
+
+	void Close(FakeCommandList*) override {}
+
+	void Submit(FakeCommandList* const* commandLists, size_t count) override {
+		for (size_t i = 0; i < count; i++) {
+			submittedCount_ += commandLists[i]->commands.size();
+		}
+		usedCount_ = 0;
+	}
+
+	size_t GetSubmittedCount() const { return submittedCount_; }
+
+private:
+	std::vector<std::unique_ptr<FakeCommandList>> lists_;
+	size_t usedCount_ = 0;
+	size_t submittedCount_ = 0;
+};
+
+// 描画ごとに行列を少し計算してから命令を積む（記録の重さの代わり）
+void RecordDraws(FakeCommandList* commandList, size_t begin, size_t end) {
+	for (size_t i = begin; i < end; i++) {
+		float value = float(i);
+		for (int k = 0; k < 64; k++) {
+			value = value * 0.999f + 0.5f;
+		}
+		commandList->commands.push_back(
+		    {uint64_t(i) * 256, uint32_t(value) % 3000 + 36, uint32_t(i % 4) + 1});
+	}
+}
+
+} // namespace
+
+BENCHMARK(ParallelCommandRecorderBenchmark) {
+	const size_t threadCount = ThreadPool::GetInstance()->GetWorkerCount() + 1;
+	double serialMilliseconds = 0.0;
+	for (size_t splitCount : {size_t(1), threadCount}) {
+		NullBackend backend;
+		ParallelCommandRecorder<FakeCommandList> recorder;
+		recorder.Initialize(&backend);
+		recorder.GetSchedule().SetMaxSplitCount(splitCount);
+		const double milliseconds = MeasureMilliseconds([&] {
+			recorder.AddPass(kDrawCount, 256, RecordDraws);
+			recorder.Execute();
+		});
+		const std::string label = std::to_string(kDrawCount) + " draws, " +
+		                          std::to_string(splitCount) + " command lists";
+		Report(label.c_str(), milliseconds, double(kDrawCount), "draw");
+		if (splitCount == 1) {
+			serialMilliseconds = milliseconds;
+		} else {
+			std::printf(
+			    "  %-44s %10.2f x (%zu threads)\n", "speedup", serialMilliseconds / milliseconds,
+			    threadCount);
+		}
+	}
+}
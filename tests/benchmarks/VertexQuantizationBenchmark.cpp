@@ -0,0 +1,23 @@
+#include "Benchmark.h"
+#include "TestMeshes.h"
+#include "VertexQuantization.h"
+
+BENCHMARK(VertexQuantizationBenchmark) {
+	const MeshData mesh = MakeGridMesh(511);
+	const size_t count = mesh.vertices.size();
+	std::vector<QuantizedVertex> quantized(count);
+	for (VertexFormat format : {VertexFormat::kHalf, VertexFormat::kUnorm16}) {
+		const QuantizationParameters parameters =
+		    ComputeQuantizationParameters(mesh.vertices.data(), count, format);
+		Report(
+		    format == VertexFormat::kHalf ? "QuantizeVertices kHalf x262144"
+		                                  : "QuantizeVertices kUnorm16 x262144",
+		    MeasureMilliseconds([&] {
+			    QuantizeVertices(mesh.vertices.data(), count, format, parameters, quantized.data());
+		    }),
+		    double(count), "vtx");
+	}
+	std::printf(
+	    "  vertex data %zu KB -> %zu KB\n", GetVertexStride(VertexFormat::kFloat32) * count / 1024,
+	    GetVertexStride(VertexFormat::kUnorm16) * count / 1024);
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Windows 以外でテストを組むための代わり（ViewProjection などが型名だけを使う）
+struct ID3D12Resource;
@@ -0,0 +1,14 @@
+#pragma once
+
+// Windows 以外でテストを組むための代わり（メンバとして持つだけで、使わない）
+namespace Microsoft::WRL {
+
+template<class T> class ComPtr {
+public:
+	T* Get() const { return pointer_; }
+
+private:
+	T* pointer_ = nullptr;
+};
+
+} // namespace Microsoft::WRL
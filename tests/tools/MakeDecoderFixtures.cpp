@@ -0,0 +1,451 @@
+// デコーダのテストで読む画像（tests/data/decoders/）を libpng / libjpeg / zlib で作る
+//   cmake -S tests -B build -DENGINE_DECODER_FIXTURES=ON
+//   cmake --build build --target MakeDecoderFixtures
+//   build/MakeDecoderFixtures tests/data/decoders/
+// manifest.txt に、ファイルごとの期待する結果を1行ずつ書く
+//   png <ファイル> <幅> <高さ> <RGBA8 の FNV-1a>
+//   jpeg <ファイル> <幅> <高さ> <libjpeg で展開した RGBA8 のファイル>
+//   reject <ファイル>
+//   zlib <ファイル> <展開後のバイト数> <展開後の FNV-1a>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+// jpeglib.h は size_t と FILE を宣言してから読み込む
+#include <jpeglib.h>
+#include <png.h>
+#include <random>
+#include <zlib.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// 書き出し先のディレクトリ
+std::string gDirectory;
+// manifest.txt
+FILE* gManifest = nullptr;
+
+uint64_t HashFnv1a(const std::vector<uint8_t>& bytes) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (uint8_t value : bytes) {
+		hash = (hash ^ value) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+bool WriteFile(const std::string& name, const std::vector<uint8_t>& bytes) {
+	FILE* file = std::fopen((gDirectory + name).c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	std::fwrite(bytes.data(), 1, bytes.size(), file);
+	std::fclose(file);
+	return true;
+}
+
+// 横と縦のグラデーションに乱数の青とアルファを重ねた 16bit の RGBA
+std::vector<uint16_t> MakeSourceImage(uint32_t width, uint32_t height, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::vector<uint16_t> image(size_t(width) * height * 4);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			uint16_t* pixel = &image[(size_t(y) * width + x) * 4];
+			pixel[0] = uint16_t(x * 65535 / (1 < width ? width - 1 : 1));
+			pixel[1] = uint16_t(y * 65535 / (1 < height ? height - 1 : 1));
+			pixel[2] = uint16_t(random());
+			pixel[3] = uint16_t(random() % 3 == 0 ? random() : 65535);
+		}
+	}
+	return image;
+}
+
+// PNG の作成（期待する RGBA8 の FNV-1a を manifest に書く）
+struct PngCase {
+	const char* name;
+	int colorType;
+	int bitDepth;
+	bool isInterlaced;
+	bool hasTransparency;
+	int filters;
+	uint32_t width;
+	uint32_t height;
+};
+
+bool WritePng(const PngCase& pngCase) {
+	const uint32_t width = pngCase.width;
+	const uint32_t height = pngCase.height;
+	const int colorType = pngCase.colorType;
+	const int bitDepth = pngCase.bitDepth;
+	const std::vector<uint16_t> image =
+	    MakeSourceImage(width, height, width * height + uint32_t(colorType));
+
+	FILE* file = std::fopen((gDirectory + pngCase.name).c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_infop info = png_create_info_struct(png);
+	if (setjmp(png_jmpbuf(png))) {
+		std::fclose(file);
+		return false;
+	}
+	png_init_io(png, file);
+	const int interlace = pngCase.isInterlaced ? PNG_INTERLACE_ADAM7 : PNG_INTERLACE_NONE;
+	png_set_IHDR(
+	    png, info, width, height, bitDepth, colorType, interlace, PNG_COMPRESSION_TYPE_DEFAULT,
+	    PNG_FILTER_TYPE_DEFAULT);
+	png_set_filter(png, 0, pngCase.filters);
+
+	const int channelCount = colorType == PNG_COLOR_TYPE_GRAY      ? 1
+	                         : colorType == PNG_COLOR_TYPE_RGB     ? 3
+	                         : colorType == PNG_COLOR_TYPE_PALETTE ? 1
+	                         : colorType == PNG_COLOR_TYPE_GA      ? 2
+	                                                               : 4;
+	// パレットの後ろ半分は透明度を持たない
+	png_color palette[256];
+	png_byte paletteAlpha[256];
+	const int paletteSize = colorType == PNG_COLOR_TYPE_PALETTE ? 1 << bitDepth : 0;
+	for (int i = 0; i < paletteSize; i++) {
+		palette[i] = {png_byte(i * 37), png_byte(i * 91), png_byte(255 - i)};
+		paletteAlpha[i] = png_byte(i * 13);
+	}
+	png_color_16 key{};
+	if (colorType == PNG_COLOR_TYPE_PALETTE) {
+		png_set_PLTE(png, info, palette, paletteSize);
+		if (pngCase.hasTransparency) {
+			png_set_tRNS(png, info, paletteAlpha, paletteSize / 2, nullptr);
+		}
+	} else if (pngCase.hasTransparency && colorType == PNG_COLOR_TYPE_GRAY) {
+		key.gray = png_uint_16(bitDepth == 16 ? 0x1234 : 1);
+		png_set_tRNS(png, info, nullptr, 0, &key);
+	} else if (pngCase.hasTransparency && colorType == PNG_COLOR_TYPE_RGB) {
+		key.red = png_uint_16(bitDepth == 16 ? 0x8000 : 0x80);
+		png_set_tRNS(png, info, nullptr, 0, &key);
+	}
+	png_write_info(png, info);
+
+	const uint32_t maxValue = (1u << bitDepth) - 1;
+	const size_t rowSize = (size_t(width) * channelCount * bitDepth + 7) / 8;
+	std::vector<uint8_t> rows(rowSize * height, 0);
+	std::vector<uint8_t> expected(size_t(width) * height * 4);
+	auto toUnorm8 = [&](uint32_t value) {
+		return uint8_t(
+		    bitDepth == 16 ? value >> 8 : bitDepth == 8 ? value : value * (255 / maxValue));
+	};
+	for (uint32_t y = 0; y < height; y++) {
+		uint8_t* row = &rows[y * rowSize];
+		for (uint32_t x = 0; x < width; x++) {
+			const uint16_t* pixel = &image[(size_t(y) * width + x) * 4];
+			uint32_t samples[4] = {};
+			if (colorType == PNG_COLOR_TYPE_PALETTE) {
+				samples[0] = pixel[2] % uint32_t(paletteSize);
+			} else {
+				for (int c = 0; c < channelCount; c++) {
+					const int source = channelCount <= 2 ? (c == 0 ? 0 : 3) : c;
+					samples[c] = uint32_t(pixel[source]) * maxValue / 65535;
+				}
+			}
+			// 透明色とちょうど同じ画素も作る
+			if (pngCase.hasTransparency && colorType == PNG_COLOR_TYPE_GRAY && x % 5 == 0) {
+				samples[0] = key.gray;
+			}
+			if (pngCase.hasTransparency && colorType == PNG_COLOR_TYPE_RGB && x % 7 == 0) {
+				samples[0] = key.red;
+				samples[1] = 0;
+				samples[2] = 0;
+			}
+			for (int c = 0; c < channelCount; c++) {
+				if (bitDepth == 16) {
+					row[(x * channelCount + c) * 2] = uint8_t(samples[c] >> 8);
+					row[(x * channelCount + c) * 2 + 1] = uint8_t(samples[c]);
+				} else if (bitDepth == 8) {
+					row[x * channelCount + c] = uint8_t(samples[c]);
+				} else {
+					const size_t bit = size_t(x) * bitDepth;
+					row[bit / 8] |= uint8_t(samples[c] << (8 - bitDepth - bit % 8));
+				}
+			}
+
+			uint8_t* result = &expected[(size_t(y) * width + x) * 4];
+			if (colorType == PNG_COLOR_TYPE_PALETTE) {
+				const png_color& color = palette[samples[0]];
+				result[0] = color.red;
+				result[1] = color.green;
+				result[2] = color.blue;
+				result[3] = pngCase.hasTransparency && int(samples[0]) < paletteSize / 2
+				                ? paletteAlpha[samples[0]]
+				                : 255;
+			} else if (colorType == PNG_COLOR_TYPE_GRAY) {
+				result[0] = result[1] = result[2] = toUnorm8(samples[0]);
+				result[3] = pngCase.hasTransparency && samples[0] == key.gray ? 0 : 255;
+			} else if (colorType == PNG_COLOR_TYPE_GA) {
+				result[0] = result[1] = result[2] = toUnorm8(samples[0]);
+				result[3] = toUnorm8(samples[1]);
+			} else if (colorType == PNG_COLOR_TYPE_RGB) {
+				for (int c = 0; c < 3; c++) {
+					result[c] = toUnorm8(samples[c]);
+				}
+				result[3] = pngCase.hasTransparency && samples[0] == key.red && samples[1] == 0 &&
+				                    samples[2] == 0
+				                ? 0
+				                : 255;
+			} else {
+				for (int c = 0; c < 4; c++) {
+					result[c] = toUnorm8(samples[c]);
+				}
+			}
+		}
+	}
+	const int passCount = png_set_interlace_handling(png);
+	for (int pass = 0; pass < passCount; pass++) {
+		for (uint32_t y = 0; y < height; y++) {
+			png_write_row(png, &rows[y * rowSize]);
+		}
+	}
+	png_write_end(png, info);
+	png_destroy_write_struct(&png, &info);
+	std::fclose(file);
+	std::fprintf(
+	    gManifest, "png %s %u %u %016" PRIx64 "\n", pngCase.name, width, height,
+	    HashFnv1a(expected));
+	return true;
+}
+
+// JPEG の作成（浮動小数の IDCT と補間しないアップサンプリングで展開した結果も書く）
+struct JpegCase {
+	const char* name;
+	int componentCount;
+	int horizontalSampling;
+	int verticalSampling;
+	int quality;
+	unsigned int restartInterval;
+	bool isOptimized;
+	bool isProgressive;
+	uint32_t width;
+	uint32_t height;
+};
+
+std::vector<uint8_t> ReadFile(const std::string& name) {
+	std::vector<uint8_t> bytes;
+	FILE* file = std::fopen((gDirectory + name).c_str(), "rb");
+	if (!file) {
+		return bytes;
+	}
+	uint8_t buffer[4096];
+	size_t readSize;
+	while ((readSize = std::fread(buffer, 1, sizeof(buffer), file)) != 0) {
+		bytes.insert(bytes.end(), buffer, buffer + readSize);
+	}
+	std::fclose(file);
+	return bytes;
+}
+
+bool WriteJpeg(const JpegCase& jpegCase) {
+	const uint32_t width = jpegCase.width;
+	const uint32_t height = jpegCase.height;
+	const int componentCount = jpegCase.componentCount;
+	const std::vector<uint16_t> image = MakeSourceImage(width, height, 7);
+
+	FILE* file = std::fopen((gDirectory + jpegCase.name).c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	jpeg_compress_struct compress;
+	jpeg_error_mgr error;
+	compress.err = jpeg_std_error(&error);
+	jpeg_create_compress(&compress);
+	jpeg_stdio_dest(&compress, file);
+	compress.image_width = width;
+	compress.image_height = height;
+	compress.input_components = componentCount;
+	compress.in_color_space = componentCount == 1 ? JCS_GRAYSCALE : JCS_RGB;
+	jpeg_set_defaults(&compress);
+	jpeg_set_quality(&compress, jpegCase.quality, TRUE);
+	if (componentCount == 3) {
+		compress.comp_info[0].h_samp_factor = jpegCase.horizontalSampling;
+		compress.comp_info[0].v_samp_factor = jpegCase.verticalSampling;
+		for (int c = 1; c < 3; c++) {
+			compress.comp_info[c].h_samp_factor = 1;
+			compress.comp_info[c].v_samp_factor = 1;
+		}
+	}
+	compress.restart_interval = jpegCase.restartInterval;
+	compress.optimize_coding = jpegCase.isOptimized;
+	if (jpegCase.isProgressive) {
+		jpeg_simple_progression(&compress);
+	}
+	jpeg_start_compress(&compress, TRUE);
+	// 青は細かい模様にして、色差の間引きと量子化の誤差が出るようにする
+	std::vector<uint8_t> row(size_t(width) * componentCount);
+	while (compress.next_scanline < height) {
+		const uint32_t y = compress.next_scanline;
+		for (uint32_t x = 0; x < width; x++) {
+			const uint16_t* pixel = &image[(size_t(y) * width + x) * 4];
+			for (int c = 0; c < componentCount; c++) {
+				// 3番目の成分は細かい模様にして、色差の間引きが効くようにする
+				const uint32_t value = c == 2 ? ((x ^ y) & 0x3f) * 3 : pixel[c] >> 8u;
+				row[x * componentCount + c] = uint8_t(value);
+			}
+		}
+		JSAMPROW rowPointer = row.data();
+		jpeg_write_scanlines(&compress, &rowPointer, 1);
+	}
+	jpeg_finish_compress(&compress);
+	jpeg_destroy_compress(&compress);
+	std::fclose(file);
+
+	if (jpegCase.isProgressive) {
+		std::fprintf(gManifest, "reject %s\n", jpegCase.name);
+		return true;
+	}
+
+	const std::vector<uint8_t> bytes = ReadFile(jpegCase.name);
+	jpeg_decompress_struct decompress;
+	decompress.err = jpeg_std_error(&error);
+	jpeg_create_decompress(&decompress);
+	jpeg_mem_src(&decompress, bytes.data(), static_cast<unsigned long>(bytes.size()));
+	jpeg_read_header(&decompress, TRUE);
+	decompress.out_color_space = JCS_RGB;
+	decompress.do_fancy_upsampling = FALSE;
+	decompress.dct_method = JDCT_FLOAT;
+	jpeg_start_decompress(&decompress);
+	std::vector<uint8_t> reference(size_t(width) * height * 4, 255);
+	std::vector<uint8_t> decodedRow(size_t(width) * 3);
+	while (decompress.output_scanline < height) {
+		const uint32_t y = decompress.output_scanline;
+		JSAMPROW rowPointer = decodedRow.data();
+		jpeg_read_scanlines(&decompress, &rowPointer, 1);
+		for (uint32_t x = 0; x < width; x++) {
+			for (int c = 0; c < 3; c++) {
+				reference[(size_t(y) * width + x) * 4 + c] = decodedRow[x * 3 + c];
+			}
+		}
+	}
+	jpeg_finish_decompress(&decompress);
+	jpeg_destroy_decompress(&decompress);
+
+	const std::string referenceName = std::string(jpegCase.name) + ".rgba";
+	std::fprintf(
+	    gManifest, "jpeg %s %u %u %s\n", jpegCase.name, width, height, referenceName.c_str());
+	return WriteFile(referenceName, reference);
+}
+
+// zlib 形式の作成（圧縮の強さと方式ごとに、違う種類のブロックができる）
+bool WriteZlib(const char* name, int mode, int level, int strategy, size_t size) {
+	std::mt19937 random(static_cast<uint32_t>(size));
+	std::vector<uint8_t> source(size);
+	for (size_t i = 0; i < size; i++) {
+		switch (mode) {
+		case 0: // 乱数（圧縮できない）
+			source[i] = uint8_t(random());
+			break;
+		case 1: // 長い同じ値の並び
+			source[i] = uint8_t(i / 97);
+			break;
+		case 2: // 短い繰り返し
+			source[i] = uint8_t("abcabcabd"[i % 9]);
+			break;
+		default: // 少ない種類の値
+			source[i] = uint8_t(random() % 4);
+			break;
+		}
+	}
+	std::vector<uint8_t> compressed(compressBound(uLong(size)));
+	z_stream stream{};
+	deflateInit2(&stream, level, Z_DEFLATED, 15, 8, strategy);
+	stream.next_in = source.data();
+	stream.avail_in = uInt(size);
+	stream.next_out = compressed.data();
+	stream.avail_out = uInt(compressed.size());
+	deflate(&stream, Z_FINISH);
+	compressed.resize(stream.total_out);
+	deflateEnd(&stream);
+	std::fprintf(gManifest, "zlib %s %zu %016" PRIx64 "\n", name, size, HashFnv1a(source));
+	return WriteFile(name, compressed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::printf("usage: MakeDecoderFixtures <output directory>\n");
+		return 1;
+	}
+	gDirectory = argv[1];
+	if (!gDirectory.empty() && gDirectory.back() != '/') {
+		gDirectory += '/';
+	}
+	gManifest = std::fopen((gDirectory + "manifest.txt").c_str(), "w");
+	if (!gManifest) {
+		return 1;
+	}
+
+	// 全ての色の種類とビット深度（フィルタは libpng に行ごとに選ばせる）
+	const PngCase pngCases[] = {
+	    {"gray1.png", PNG_COLOR_TYPE_GRAY, 1, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"gray2.png", PNG_COLOR_TYPE_GRAY, 2, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"gray4.png", PNG_COLOR_TYPE_GRAY, 4, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"gray8.png", PNG_COLOR_TYPE_GRAY, 8, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"gray16.png", PNG_COLOR_TYPE_GRAY, 16, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"rgb8.png", PNG_COLOR_TYPE_RGB, 8, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"rgb16.png", PNG_COLOR_TYPE_RGB, 16, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"palette1.png", PNG_COLOR_TYPE_PALETTE, 1, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"palette2.png", PNG_COLOR_TYPE_PALETTE, 2, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"palette4.png", PNG_COLOR_TYPE_PALETTE, 4, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"palette8.png", PNG_COLOR_TYPE_PALETTE, 8, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"grayalpha8.png", PNG_COLOR_TYPE_GA, 8, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"grayalpha16.png", PNG_COLOR_TYPE_GA, 16, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"rgba8.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_ALL_FILTERS, 17, 9},
+	    {"rgba16.png", PNG_COLOR_TYPE_RGBA, 16, false, false, PNG_ALL_FILTERS, 17, 9},
+	    // tRNS
+	    {"gray2_trns.png", PNG_COLOR_TYPE_GRAY, 2, false, true, PNG_ALL_FILTERS, 17, 9},
+	    {"gray16_trns.png", PNG_COLOR_TYPE_GRAY, 16, false, true, PNG_ALL_FILTERS, 17, 9},
+	    {"rgb8_trns.png", PNG_COLOR_TYPE_RGB, 8, false, true, PNG_ALL_FILTERS, 17, 9},
+	    {"rgb16_trns.png", PNG_COLOR_TYPE_RGB, 16, false, true, PNG_ALL_FILTERS, 17, 9},
+	    {"palette4_trns.png", PNG_COLOR_TYPE_PALETTE, 4, false, true, PNG_ALL_FILTERS, 17, 9},
+	    // 1種類のフィルタだけ
+	    {"rgba8_none.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_FILTER_NONE, 33, 17},
+	    {"rgba8_sub.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_FILTER_SUB, 33, 17},
+	    {"rgba8_up.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_FILTER_UP, 33, 17},
+	    {"rgba8_average.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_FILTER_AVG, 33, 17},
+	    {"rgba8_paeth.png", PNG_COLOR_TYPE_RGBA, 8, false, false, PNG_FILTER_PAETH, 33, 17},
+	    {"rgb8_paeth.png", PNG_COLOR_TYPE_RGB, 8, false, false, PNG_FILTER_PAETH, 33, 17},
+	    // Adam7（空のパスができる小さい画像も含める）
+	    {"rgba8_adam7.png", PNG_COLOR_TYPE_RGBA, 8, true, false, PNG_ALL_FILTERS, 33, 17},
+	    {"rgb16_adam7.png", PNG_COLOR_TYPE_RGB, 16, true, false, PNG_ALL_FILTERS, 17, 9},
+	    {"palette2_adam7.png", PNG_COLOR_TYPE_PALETTE, 2, true, true, PNG_ALL_FILTERS, 17, 9},
+	    {"gray1_adam7.png", PNG_COLOR_TYPE_GRAY, 1, true, false, PNG_ALL_FILTERS, 3, 5},
+	    {"rgba8_adam7_1x1.png", PNG_COLOR_TYPE_RGBA, 8, true, false, PNG_ALL_FILTERS, 1, 1},
+	};
+	for (const PngCase& pngCase : pngCases) {
+		if (!WritePng(pngCase)) {
+			return 1;
+		}
+	}
+
+	// 色差の間引き方・リスタート・ハフマン表の最適化の組み合わせ
+	const JpegCase jpegCases[] = {
+	    {"gray.jpg", 1, 1, 1, 90, 0, false, false, 33, 17},
+	    {"gray_restart.jpg", 1, 1, 1, 60, 2, false, false, 5, 3},
+	    {"ycc444.jpg", 3, 1, 1, 90, 0, false, false, 32, 24},
+	    {"ycc420.jpg", 3, 2, 2, 85, 0, false, false, 67, 45},
+	    {"ycc422_restart.jpg", 3, 2, 1, 75, 3, true, false, 100, 31},
+	    {"ycc440_restart.jpg", 3, 1, 2, 95, 1, false, false, 9, 40},
+	    {"ycc420_1x1.jpg", 3, 2, 2, 50, 7, true, false, 1, 1},
+	    {"progressive.jpg", 3, 2, 2, 80, 0, false, true, 16, 16},
+	};
+	for (const JpegCase& jpegCase : jpegCases) {
+		if (!WriteJpeg(jpegCase)) {
+			return 1;
+		}
+	}
+
+	const bool isZlibWritten =
+	    WriteZlib("stored.zlib", 0, 0, Z_DEFAULT_STRATEGY, 3000) &&
+	    WriteZlib("fixed.zlib", 2, 6, Z_FIXED, 5000) &&
+	    WriteZlib("huffman.zlib", 3, 6, Z_HUFFMAN_ONLY, 8000) &&
+	    WriteZlib("rle.zlib", 1, 6, Z_RLE, 10000) &&
+	    WriteZlib("dynamic.zlib", 3, 9, Z_DEFAULT_STRATEGY, 12000);
+	std::fclose(gManifest);
+	return isZlibWritten ? 0 : 1;
+}